@@ -73,6 +73,14 @@ QgsBoundaryAlgorithm *QgsBoundaryAlgorithm::createInstance() const
   return new QgsBoundaryAlgorithm();
 }
 
+QgsProcessingAlgorithm::Flags QgsBoundaryAlgorithm::flags() const
+{
+  QgsProcessingAlgorithm::Flags f = QgsProcessingFeatureBasedAlgorithm::flags();
+  f |= QgsProcessingAlgorithm::FlagSupportsParallelFeatureProcessing;
+  f |= QgsProcessingAlgorithm::FlagSupportsStreamedInput;
+  return f;
+}
+
 QgsProcessingFeatureSource::Flag QgsBoundaryAlgorithm::sourceFlags() const
 {
   return QgsProcessingFeatureSource::FlagSkipGeometryValidityChecks;
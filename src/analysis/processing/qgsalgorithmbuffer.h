@@ -28,6 +28,9 @@
 
 /**
  * Native buffer algorithm.
+ *
+ * As the buffers may be dissolved, this is not a feature based algorithm, and its
+ * features are always processed serially.
  */
 class QgsBufferAlgorithm : public QgsProcessingAlgorithm
 {
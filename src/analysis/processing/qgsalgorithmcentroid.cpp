@@ -56,6 +56,13 @@ QString QgsCentroidAlgorithm::shortHelpString() const
                       "The attributes associated to each point in the output layer are the same ones associated to the original features." );
 }
 
+QgsProcessingAlgorithm::Flags QgsCentroidAlgorithm::flags() const
+{
+  QgsProcessingAlgorithm::Flags f = QgsProcessingFeatureBasedAlgorithm::flags();
+  f |= QgsProcessingAlgorithm::FlagSupportsParallelFeatureProcessing;
+  return f;
+}
+
 QgsCentroidAlgorithm *QgsCentroidAlgorithm::createInstance() const
 {
   return new QgsCentroidAlgorithm();
@@ -78,7 +85,7 @@ bool QgsCentroidAlgorithm::prepareAlgorithm( const QVariantMap &parameters, QgsP
   mAllParts = parameterAsBoolean( parameters, QStringLiteral( "ALL_PARTS" ), context );
   mDynamicAllParts = QgsProcessingParameters::isDynamic( parameters, QStringLiteral( "ALL_PARTS" ) );
   if ( mDynamicAllParts )
-    mAllPartsProperty = parameters.value( QStringLiteral( "ALL_PARTS" ) ).value< QgsProperty >();
+    mAllPartsProperty.setProperty( parameters.value( QStringLiteral( "ALL_PARTS" ) ).value< QgsProperty >() );
 
   return true;
 }
@@ -93,7 +100,7 @@ QgsFeatureList QgsCentroidAlgorithm::processFeature( const QgsFeature &f, QgsPro
 
     bool allParts = mAllParts;
     if ( mDynamicAllParts )
-      allParts = mAllPartsProperty.valueAsBool( context.expressionContext(), allParts );
+      allParts = mAllPartsProperty.property().valueAsBool( context.expressionContext(), allParts );
 
     if ( allParts && geom.isMultipart() )
     {
@@ -23,6 +23,7 @@
 #include "qgis_sip.h"
 #include "qgsprocessingalgorithm.h"
 #include "qgsapplication.h"
+#include "qgsthreadlocalproperty.h"
 
 ///@cond PRIVATE
 
@@ -43,6 +44,7 @@ class QgsCentroidAlgorithm : public QgsProcessingFeatureBasedAlgorithm
     QString group() const override;
     QString groupId() const override;
     QString shortHelpString() const override;
+    QgsProcessingAlgorithm::Flags flags() const override;
     QgsCentroidAlgorithm *createInstance() const override SIP_FACTORY;
     void initParameters( const QVariantMap &configuration = QVariantMap() ) override;
 
@@ -59,7 +61,7 @@ class QgsCentroidAlgorithm : public QgsProcessingFeatureBasedAlgorithm
 
     bool mAllParts = false;
     bool mDynamicAllParts = false;
-    QgsProperty mAllPartsProperty;
+    QgsThreadLocalProperty mAllPartsProperty;
 };
 
 ///@endcond PRIVATE
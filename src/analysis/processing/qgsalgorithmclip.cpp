@@ -18,6 +18,7 @@
 #include "qgsalgorithmclip.h"
 #include "qgsgeometryengine.h"
 #include "qgsoverlayutils.h"
+#include "qgsspatialjoinengine.h"
 #include "qgsvectorlayer.h"
 
 ///@cond PRIVATE
@@ -31,6 +32,7 @@ QgsProcessingAlgorithm::Flags QgsClipAlgorithm::flags() const
 {
   Flags f = QgsProcessingAlgorithm::flags();
   f |= QgsProcessingAlgorithm::FlagSupportsInPlaceEdits;
+  f |= QgsProcessingAlgorithm::FlagSupportsStreamedInput;
   return f;
 }
 
@@ -98,6 +100,8 @@ QVariantMap QgsClipAlgorithm::processAlgorithm( const QVariantMap &parameters, Q
 
   if ( featureSource->hasSpatialIndex() == QgsFeatureSource::SpatialIndexNotPresent )
     feedback->pushWarning( QObject::tr( "No spatial index exists for input layer, performance will be severely degraded" ) );
+  if ( maskSource->hasSpatialIndex() == QgsFeatureSource::SpatialIndexNotPresent )
+    feedback->reportError( QObject::tr( "No spatial index exists for join layer, performance will be severely degraded" ) );
 
   QString dest;
   QgsWkbTypes::GeometryType sinkType = QgsWkbTypes::geometryType( featureSource->wkbType() );
@@ -106,127 +110,102 @@ QVariantMap QgsClipAlgorithm::processAlgorithm( const QVariantMap &parameters, Q
   if ( !sink )
     throw QgsProcessingException( invalidSinkError( parameters, QStringLiteral( "OUTPUT" ) ) );
 
-  // first build up a list of clip geometries
-  QVector< QgsGeometry > clipGeoms;
-  QgsFeatureIterator it = maskSource->getFeatures( QgsFeatureRequest().setSubsetOfAttributes( QList< int >() ).setDestinationCrs( featureSource->sourceCrs(), context.transformContext() ) );
-  QgsFeature f;
-  while ( it.nextFeature( f ) )
-  {
-    if ( f.hasGeometry() )
-      clipGeoms << f.geometry();
-  }
+  // index the clip geometries for the spatial join
+  QgsSpatialJoinEngine joinEngine( *maskSource, QgsFeatureRequest().setSubsetOfAttributes( QList< int >() ).setDestinationCrs( featureSource->sourceCrs(), context.transformContext() ), context, feedback );
 
   QVariantMap outputs;
   outputs.insert( QStringLiteral( "OUTPUT" ), dest );
 
-  if ( clipGeoms.isEmpty() )
+  if ( joinEngine.featureCount() == 0 )
     return outputs;
 
-  // are we clipping against a single feature? if so, we can show finer progress reports
-  bool singleClipFeature = false;
-  QgsGeometry combinedClipGeom;
-  if ( clipGeoms.length() > 1 )
+  // each input feature is clipped by the union of the clip geometries intersecting it only,
+  // which gives the same result as clipping by the union of all clip geometries
+  const QgsRectangle clipExtent = joinEngine.extent();
+
+  // the progress is based on the features within the clip extent only, which are counted first
+  // without fetching their geometries nor attributes, unless the whole input is in the extent.
+  // Inputs without a spatial index, such as the features streamed by a model, are read once
+  // only, as both the extent and the count would need a full pass over them
+  long count = featureSource->featureCount();
+  if ( featureSource->hasSpatialIndex() != QgsFeatureSource::SpatialIndexNotPresent && !clipExtent.contains( featureSource->sourceExtent() ) )
   {
-    combinedClipGeom = QgsGeometry::unaryUnion( clipGeoms );
-    if ( combinedClipGeom.isEmpty() )
+    count = 0;
+    QgsFeatureIterator countIt = featureSource->getFeatures( QgsFeatureRequest().setFilterRect( clipExtent ).setFlags( QgsFeatureRequest::NoGeometry ).setNoAttributes() );
+    QgsFeature f;
+    while ( countIt.nextFeature( f ) )
     {
-      throw QgsProcessingException( QObject::tr( "Could not create the combined clip geometry: %1" ).arg( combinedClipGeom.lastError() ) );
+      if ( feedback->isCanceled() )
+        return outputs;
+      count++;
     }
-    singleClipFeature = false;
-  }
-  else
-  {
-    combinedClipGeom = clipGeoms.at( 0 );
-    singleClipFeature = true;
   }
 
-  // use prepared geometries for faster intersection tests
-  std::unique_ptr< QgsGeometryEngine > engine( QgsGeometry::createGeometryEngine( combinedClipGeom.constGet() ) );
-  engine->prepareGeometry();
+  QgsFeatureIterator inputIt = featureSource->getFeatures( QgsFeatureRequest().setFilterRect( clipExtent ) );
+  const double step = count > 0 ? 100.0 / count : 1;
+  long current = 0;
 
-  QgsFeatureIds testedFeatureIds;
-
-  int i = -1;
-  const auto constClipGeoms = clipGeoms;
-  for ( const QgsGeometry &clipGeom : constClipGeoms )
+  joinEngine.run( inputIt, []( QgsGeometryEngine * engine, const QgsFeature & clipFeature )
   {
-    i++;
-    if ( feedback->isCanceled() )
-    {
-      break;
-    }
-    QgsFeatureIterator inputIt = featureSource->getFeatures( QgsFeatureRequest().setFilterRect( clipGeom.boundingBox() ) );
-    QgsFeatureList inputFeatures;
-    QgsFeature f;
-    while ( inputIt.nextFeature( f ) )
-      inputFeatures << f;
-
-    if ( inputFeatures.isEmpty() )
-      continue;
-
-    double step = 0;
-    if ( singleClipFeature )
-      step = 100.0 / inputFeatures.length();
+    return engine->intersects( clipFeature.geometry().constGet() );
+  },
+  [sinkType]( const QgsFeature & inputFeature, const QVector< const QgsFeature * > &clipFeatures, QgsGeometryEngine * engine, QgsProcessingFeedback * ) -> QgsFeatureList
+  {
+    if ( clipFeatures.isEmpty() )
+      return QgsFeatureList();
 
-    int current = 0;
-    const auto constInputFeatures = inputFeatures;
-    for ( const QgsFeature &inputFeature : constInputFeatures )
+    QgsGeometry clipGeom;
+    if ( clipFeatures.size() > 1 )
     {
-      if ( feedback->isCanceled() )
-      {
-        break;
-      }
-
-      if ( !inputFeature.hasGeometry() )
-        continue;
+      QVector< QgsGeometry > clipGeoms;
+      clipGeoms.reserve( clipFeatures.size() );
+      for ( const QgsFeature *clipFeature : clipFeatures )
+        clipGeoms << clipFeature->geometry();
 
-      if ( testedFeatureIds.contains( inputFeature.id() ) )
+      clipGeom = QgsGeometry::unaryUnion( clipGeoms );
+      if ( clipGeom.isEmpty() )
       {
-        // don't retest a feature we have already checked
-        continue;
+        throw QgsProcessingException( QObject::tr( "Could not create the combined clip geometry: %1" ).arg( clipGeom.lastError() ) );
       }
-      testedFeatureIds.insert( inputFeature.id() );
-
-      if ( !engine->intersects( inputFeature.geometry().constGet() ) )
-        continue;
+    }
+    else
+    {
+      clipGeom = clipFeatures.at( 0 )->geometry();
+    }
 
-      QgsGeometry newGeometry;
-      if ( !engine->contains( inputFeature.geometry().constGet() ) )
-      {
-        QgsGeometry currentGeometry = inputFeature.geometry();
-        newGeometry = combinedClipGeom.intersection( currentGeometry );
-        if ( newGeometry.wkbType() == QgsWkbTypes::Unknown || QgsWkbTypes::flatType( newGeometry.wkbType() ) == QgsWkbTypes::GeometryCollection )
-        {
-          QgsGeometry intCom = inputFeature.geometry().combine( newGeometry );
-          QgsGeometry intSym = inputFeature.geometry().symDifference( newGeometry );
-          newGeometry = intCom.difference( intSym );
-        }
-      }
-      else
+    QgsGeometry newGeometry;
+    if ( !engine->within( clipGeom.constGet() ) )
+    {
+      QgsGeometry currentGeometry = inputFeature.geometry();
+      newGeometry = clipGeom.intersection( currentGeometry );
+      if ( newGeometry.wkbType() == QgsWkbTypes::Unknown || QgsWkbTypes::flatType( newGeometry.wkbType() ) == QgsWkbTypes::GeometryCollection )
       {
-        // clip geometry totally contains feature geometry, so no need to perform intersection
-        newGeometry = inputFeature.geometry();
+        QgsGeometry intCom = inputFeature.geometry().combine( newGeometry );
+        QgsGeometry intSym = inputFeature.geometry().symDifference( newGeometry );
+        newGeometry = intCom.difference( intSym );
       }
-
-      if ( !QgsOverlayUtils::sanitizeIntersectionResult( newGeometry, sinkType ) )
-        continue;
-
-      QgsFeature outputFeature;
-      outputFeature.setGeometry( newGeometry );
-      outputFeature.setAttributes( inputFeature.attributes() );
-      sink->addFeature( outputFeature, QgsFeatureSink::FastInsert );
-
-
-      if ( singleClipFeature )
-        feedback->setProgress( current * step );
     }
-
-    if ( !singleClipFeature )
+    else
     {
-      // coarse progress report for multiple clip geometries
-      feedback->setProgress( 100.0 * static_cast< double >( i ) / clipGeoms.length() );
+      // clip geometry totally contains feature geometry, so no need to perform intersection
+      newGeometry = inputFeature.geometry();
     }
-  }
+
+    if ( !QgsOverlayUtils::sanitizeIntersectionResult( newGeometry, sinkType ) )
+      return QgsFeatureList();
+
+    QgsFeature outputFeature;
+    outputFeature.setGeometry( newGeometry );
+    outputFeature.setAttributes( inputFeature.attributes() );
+    return QgsFeatureList() << outputFeature;
+  },
+  [ & ]( const QgsFeature &, QgsFeatureList & results )
+  {
+    sink->addFeatures( results, QgsFeatureSink::FastInsert );
+
+    current++;
+    feedback->setProgress( current * step );
+  } );
 
   return outputs;
 }
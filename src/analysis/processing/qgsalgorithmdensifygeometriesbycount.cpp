@@ -62,6 +62,13 @@ QString QgsDensifyGeometriesByCountAlgorithm::shortDescription() const
   return QObject::tr( "Creates a densified version of geometries." );
 }
 
+QgsProcessingAlgorithm::Flags QgsDensifyGeometriesByCountAlgorithm::flags() const
+{
+  QgsProcessingAlgorithm::Flags f = QgsProcessingFeatureBasedAlgorithm::flags();
+  f |= QgsProcessingAlgorithm::FlagSupportsParallelFeatureProcessing;
+  return f;
+}
+
 QgsDensifyGeometriesByCountAlgorithm *QgsDensifyGeometriesByCountAlgorithm::createInstance() const
 {
   return new QgsDensifyGeometriesByCountAlgorithm;
@@ -98,7 +105,7 @@ bool QgsDensifyGeometriesByCountAlgorithm::prepareAlgorithm( const QVariantMap &
 
   mDynamicVerticesCnt = QgsProcessingParameters::isDynamic( parameters, QStringLiteral( "VERTICES" ) );
   if ( mDynamicVerticesCnt )
-    mVerticesCntProperty = parameters.value( QStringLiteral( "VERTICES" ) ).value< QgsProperty >();
+    mVerticesCntProperty.setProperty( parameters.value( QStringLiteral( "VERTICES" ) ).value< QgsProperty >() );
 
   return true;
 }
@@ -114,7 +121,7 @@ QgsFeatureList QgsDensifyGeometriesByCountAlgorithm::processFeature( const QgsFe
   {
     int verticesCnt = mVerticesCnt;
     if ( mDynamicVerticesCnt )
-      verticesCnt = mVerticesCntProperty.valueAsInt( context.expressionContext(), verticesCnt );
+      verticesCnt = mVerticesCntProperty.property().valueAsInt( context.expressionContext(), verticesCnt );
 
     if ( verticesCnt > 0 )
       densifiedFeature.setGeometry( feature.geometry().densifyByCount( verticesCnt ) );
@@ -22,6 +22,7 @@
 
 #include "qgis_sip.h"
 #include "qgsprocessingalgorithm.h"
+#include "qgsthreadlocalproperty.h"
 
 ///@cond PRIVATE
 
@@ -38,6 +39,7 @@ class QgsDensifyGeometriesByCountAlgorithm : public QgsProcessingFeatureBasedAlg
     QString groupId() const override;
     QString shortHelpString() const override;
     QString shortDescription() const override;
+    QgsProcessingAlgorithm::Flags flags() const override;
     QgsDensifyGeometriesByCountAlgorithm *createInstance() const override SIP_FACTORY;
     QList<int> inputLayerTypes() const override;
 
@@ -50,7 +52,7 @@ class QgsDensifyGeometriesByCountAlgorithm : public QgsProcessingFeatureBasedAlg
   private:
     int mVerticesCnt = 0;
     bool mDynamicVerticesCnt = false;
-    QgsProperty mVerticesCntProperty;
+    QgsThreadLocalProperty mVerticesCntProperty;
 };
 
 ///@endcond PRIVATE
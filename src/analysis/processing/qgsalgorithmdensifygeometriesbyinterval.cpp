@@ -57,6 +57,13 @@ QString QgsDensifyGeometriesByIntervalAlgorithm::shortDescription() const
   return QObject::tr( "Creates a densified version of geometries." );
 }
 
+QgsProcessingAlgorithm::Flags QgsDensifyGeometriesByIntervalAlgorithm::flags() const
+{
+  QgsProcessingAlgorithm::Flags f = QgsProcessingFeatureBasedAlgorithm::flags();
+  f |= QgsProcessingAlgorithm::FlagSupportsParallelFeatureProcessing;
+  return f;
+}
+
 QgsDensifyGeometriesByIntervalAlgorithm *QgsDensifyGeometriesByIntervalAlgorithm::createInstance() const
 {
   return new QgsDensifyGeometriesByIntervalAlgorithm;
@@ -93,7 +100,7 @@ QgsFeatureList QgsDensifyGeometriesByIntervalAlgorithm::processFeature( const Qg
 
   double interval = mInterval;
   if ( mDynamicInterval )
-    interval = mIntervalProperty.valueAsDouble( context.expressionContext(), interval );
+    interval = mIntervalProperty.property().valueAsDouble( context.expressionContext(), interval );
 
   if ( feature.hasGeometry() )
     modifiedFeature.setGeometry( feature.geometry().densifyByDistance( interval ) );
@@ -108,7 +115,7 @@ bool QgsDensifyGeometriesByIntervalAlgorithm::prepareAlgorithm( const QVariantMa
 
   mDynamicInterval = QgsProcessingParameters::isDynamic( parameters, QStringLiteral( "INTERVAL" ) );
   if ( mDynamicInterval )
-    mIntervalProperty = parameters.value( QStringLiteral( "INTERVAL" ) ).value< QgsProperty >();
+    mIntervalProperty.setProperty( parameters.value( QStringLiteral( "INTERVAL" ) ).value< QgsProperty >() );
 
   return true;
 }
@@ -22,6 +22,7 @@
 
 #include "qgis_sip.h"
 #include "qgsprocessingalgorithm.h"
+#include "qgsthreadlocalproperty.h"
 
 ///@cond PRIVATE
 
@@ -38,6 +39,7 @@ class QgsDensifyGeometriesByIntervalAlgorithm : public QgsProcessingFeatureBased
     QString groupId() const override;
     QString shortHelpString() const override;
     QString shortDescription() const override;
+    QgsProcessingAlgorithm::Flags flags() const override;
     QgsDensifyGeometriesByIntervalAlgorithm *createInstance() const override SIP_FACTORY;
     QList<int> inputLayerTypes() const override;
 
@@ -50,7 +52,7 @@ class QgsDensifyGeometriesByIntervalAlgorithm : public QgsProcessingFeatureBased
   private:
     double mInterval = 0.0;
     bool mDynamicInterval = false;
-    QgsProperty mIntervalProperty;
+    QgsThreadLocalProperty mIntervalProperty;
 };
 
 ///@endcond PRIVATE
@@ -16,6 +16,11 @@
  ***************************************************************************/
 
 #include "qgsalgorithmdissolve.h"
+#include "qgsexception.h"
+#include "qgspackedspatialindex.h"
+
+#include <QThreadPool>
+#include <QtConcurrent>
 
 ///@cond PRIVATE
 
@@ -23,8 +28,195 @@
 // QgsCollectorAlgorithm
 //
 
+/**
+ * Returns \a geometries sorted along a Hilbert curve through the centers
+ * of their bounding boxes, so that consecutive geometries are close to each other.
+ */
+static QVector< QgsGeometry > sortedAlongHilbertCurve( const QVector< QgsGeometry > &geometries )
+{
+  if ( geometries.size() < 3 )
+    return geometries;
+
+  QVector< QgsPointXY > centers;
+  centers.reserve( geometries.size() );
+  QgsRectangle extent;
+  for ( const QgsGeometry &geometry : geometries )
+  {
+    const QgsPointXY center = geometry.boundingBox().center();
+    centers << center;
+    extent.combineExtentWith( center.x(), center.y() );
+  }
+
+  std::vector< std::pair< quint32, int > > keys;
+  keys.reserve( geometries.size() );
+  for ( int i = 0; i < centers.size(); ++i )
+    keys.emplace_back( QgsPackedSpatialIndex::hilbertIndex( centers.at( i ).x(), centers.at( i ).y(), extent ), i );
+  std::sort( keys.begin(), keys.end() );
+
+  QVector< QgsGeometry > sorted;
+  sorted.reserve( geometries.size() );
+  for ( const std::pair< quint32, int > &key : keys )
+    sorted << geometries.at( key.second );
+  return sorted;
+}
+
+/**
+ * A group of geometries of one collection, collected by a worker thread.
+ */
+struct QgsCollectorTask
+{
+  int collection = 0;
+  int position = 0;
+  QVector< QgsGeometry > parts;
+  QgsGeometry result;
+  QgsProcessingBufferedFeedback feedback;
+  QString error;
+};
+
+QVector< QgsGeometry > QgsCollectorAlgorithm::collectInParallel( const QVector< QVector< QgsGeometry > > &collections,
+    const std::function<QgsGeometry( const QVector<QgsGeometry>&, QgsProcessingFeedback * )> &collector,
+    int maxGroupSize, QgsProcessingContext &context, QgsProcessingFeedback *feedback, double progressStart, double progressEnd )
+{
+  // Neighbouring geometries are collected by groups first, and the results of
+  // neighbouring groups are then collected pairwise, level by level, so that
+  // each call to the collector deals with geometries which are spatially close
+  // and all groups of a level can be collected at the same time.
+  const int threads = std::max( 1, context.maximumThreads() );
+  const int minimumGroupSize = 16;
+
+  QVector< QVector< QgsGeometry > > current;
+  current.reserve( collections.size() );
+  QVector< int > firstGroupSizes;
+  firstGroupSizes.reserve( collections.size() );
+  int totalTasks = 0;
+  for ( const QVector< QgsGeometry > &collection : collections )
+  {
+    current << sortedAlongHilbertCurve( collection );
+
+    // small enough groups to keep all threads busy, large enough to be worth a task
+    int groupSize = std::max( minimumGroupSize, ( collection.size() + threads - 1 ) / threads );
+    if ( maxGroupSize > 0 )
+      groupSize = std::min( groupSize, maxGroupSize );
+    firstGroupSizes << groupSize;
+
+    int groups = std::max( 1, ( collection.size() + groupSize - 1 ) / groupSize );
+    totalTasks += groups;
+    while ( groups > 1 )
+    {
+      totalTasks += groups / 2;
+      groups = ( groups + 1 ) / 2;
+    }
+  }
+
+  // worker threads are only waited for from this thread, so use a dedicated pool
+  // to avoid competing with the thread running the algorithm for a slot
+  QThreadPool pool;
+  pool.setMaxThreadCount( threads );
+
+  int finishedTasks = 0;
+  bool firstLevel = true;
+  while ( !feedback->isCanceled() )
+  {
+    std::vector< std::unique_ptr< QgsCollectorTask > > tasks;
+    QVector< QVector< QgsGeometry > > next( current.size() );
+    for ( int i = 0; i < current.size(); ++i )
+    {
+      const QVector< QgsGeometry > &geometries = current.at( i );
+      const int groupSize = firstLevel ? firstGroupSizes.at( i ) : 2;
+      int start = 0;
+      do
+      {
+        const int length = std::min( groupSize, geometries.size() - start );
+        if ( !firstLevel && length == 1 )
+        {
+          // nothing to collect it with at this level
+          next[ i ] << geometries.at( start );
+        }
+        else
+        {
+          std::unique_ptr< QgsCollectorTask > task = qgis::make_unique< QgsCollectorTask >();
+          task->collection = i;
+          task->position = next.at( i ).size();
+          task->parts = geometries.mid( start, length );
+          QObject::connect( feedback, &QgsFeedback::canceled, &task->feedback, &QgsFeedback::cancel, Qt::DirectConnection );
+          next[ i ] << QgsGeometry();
+          tasks.emplace_back( std::move( task ) );
+        }
+        start += groupSize;
+      }
+      while ( start < geometries.size() );
+    }
+
+    if ( tasks.empty() )
+      break;
+
+    auto collectTask = [&collector]( QgsCollectorTask * task )
+    {
+      try
+      {
+        task->result = collector( task->parts, &task->feedback );
+      }
+      catch ( QgsProcessingException &e )
+      {
+        task->error = e.what();
+      }
+      catch ( QgsException &e )
+      {
+        task->error = e.what();
+      }
+      catch ( std::exception &e )
+      {
+        task->error = QString::fromLocal8Bit( e.what() );
+      }
+      task->parts.clear();
+    };
+
+    if ( tasks.size() == 1 || threads == 1 )
+    {
+      for ( const std::unique_ptr< QgsCollectorTask > &task : tasks )
+      {
+        collectTask( task.get() );
+        finishedTasks++;
+        feedback->setProgress( progressStart + finishedTasks * ( progressEnd - progressStart ) / totalTasks );
+        if ( feedback->isCanceled() )
+          break;
+      }
+    }
+    else
+    {
+      QList< QFuture< void > > futures;
+      for ( const std::unique_ptr< QgsCollectorTask > &task : tasks )
+        futures << QtConcurrent::run( &pool, collectTask, task.get() );
+      for ( QFuture< void > &future : futures )
+      {
+        future.waitForFinished();
+        finishedTasks++;
+        feedback->setProgress( progressStart + finishedTasks * ( progressEnd - progressStart ) / totalTasks );
+      }
+    }
+
+    for ( const std::unique_ptr< QgsCollectorTask > &task : tasks )
+    {
+      task->feedback.flush( feedback );
+      if ( !task->error.isEmpty() )
+        throw QgsProcessingException( task->error );
+      next[ task->collection ][ task->position ] = task->result;
+    }
+
+    current = next;
+    firstLevel = false;
+  }
+
+  QVector< QgsGeometry > results;
+  results.reserve( current.size() );
+  for ( const QVector< QgsGeometry > &geometries : qgis::as_const( current ) )
+    results << geometries.value( 0 );
+  return results;
+}
+
 QVariantMap QgsCollectorAlgorithm::processCollection( const QVariantMap &parameters, QgsProcessingContext &context, QgsProcessingFeedback *feedback,
-    const std::function<QgsGeometry( const QVector< QgsGeometry >& )> &collector, int maxQueueLength, QgsProcessingFeatureSource::Flags sourceFlags )
+    const std::function<QgsGeometry( const QVector< QgsGeometry >&, QgsProcessingFeedback * )> &collector, int maxQueueLength, QgsProcessingFeatureSource::Flags sourceFlags,
+    bool parallel )
 {
   std::unique_ptr< QgsProcessingFeatureSource > source( parameterAsSource( parameters, QStringLiteral( "INPUT" ), context ) );
   if ( !source )
@@ -45,11 +237,15 @@ QVariantMap QgsCollectorAlgorithm::processCollection( const QVariantMap &paramet
 
   double step = count > 0 ? 100.0 / count : 1;
   int current = 0;
+  // in parallel mode, the first half of the progress is used while reading the features
+  const double readingStep = parallel ? step / 2 : step;
 
   if ( fields.isEmpty() )
   {
     // dissolve all - not using fields
     bool firstFeature = true;
+    // in parallel mode, what was read is reduced once there are enough geometries to keep all threads busy
+    const int maxParallelQueueLength = maxQueueLength > 0 ? maxQueueLength * std::max( 1, context.maximumThreads() ) : 0;
     // we dissolve geometries in blocks using unaryUnion
     QVector< QgsGeometry > geomQueue;
     QgsFeature outputFeature;
@@ -70,20 +266,36 @@ QVariantMap QgsCollectorAlgorithm::processCollection( const QVariantMap &paramet
       if ( f.hasGeometry() && !f.geometry().isNull() )
       {
         geomQueue.append( f.geometry() );
-        if ( maxQueueLength > 0 && geomQueue.length() > maxQueueLength )
+        if ( !parallel && maxQueueLength > 0 && geomQueue.length() > maxQueueLength )
         {
           // queue too long, combine it
-          QgsGeometry tempOutputGeometry = collector( geomQueue );
+          QgsGeometry tempOutputGeometry = collector( geomQueue, feedback );
           geomQueue.clear();
           geomQueue << tempOutputGeometry;
         }
+        else if ( parallel && maxParallelQueueLength > 0 && geomQueue.length() > maxParallelQueueLength )
+        {
+          // queue too long, combine it in parallel without moving the progress
+          const QVector< QgsGeometry > results = collectInParallel( QVector< QVector< QgsGeometry > >() << geomQueue, collector, maxQueueLength, context, feedback,
+                                                 current * readingStep, current * readingStep );
+          geomQueue.clear();
+          geomQueue << results.value( 0 );
+        }
       }
 
-      feedback->setProgress( current * step );
+      feedback->setProgress( current * readingStep );
       current++;
     }
 
-    outputFeature.setGeometry( collector( geomQueue ) );
+    if ( parallel )
+    {
+      const QVector< QgsGeometry > results = collectInParallel( QVector< QVector< QgsGeometry > >() << geomQueue, collector, maxQueueLength, context, feedback, 50, 100 );
+      outputFeature.setGeometry( results.value( 0 ) );
+    }
+    else
+    {
+      outputFeature.setGeometry( collector( geomQueue, feedback ) );
+    }
     sink->addFeature( outputFeature, QgsFeatureSink::FastInsert );
   }
   else
@@ -124,8 +336,33 @@ QVariantMap QgsCollectorAlgorithm::processCollection( const QVariantMap &paramet
       {
         geometryHash[ indexAttributes ].append( f.geometry() );
       }
+
+      if ( parallel )
+        feedback->setProgress( current * readingStep );
+      current++;
+    }
+
+    // in parallel mode, all categories are collected first, and written afterwards
+    QHash< QVariant, QgsGeometry > collectedGeometries;
+    if ( parallel && !feedback->isCanceled() )
+    {
+      QVector< QVariant > keys;
+      QVector< QVector< QgsGeometry > > collections;
+      keys.reserve( geometryHash.size() );
+      collections.reserve( geometryHash.size() );
+      for ( auto geomIt = geometryHash.constBegin(); geomIt != geometryHash.constEnd(); ++geomIt )
+      {
+        keys << geomIt.key();
+        collections << geomIt.value();
+      }
+      geometryHash.clear();
+
+      const QVector< QgsGeometry > results = collectInParallel( collections, collector, maxQueueLength, context, feedback, 50, 100 );
+      for ( int i = 0; i < keys.size(); ++i )
+        collectedGeometries.insert( keys.at( i ), results.at( i ) );
     }
 
+    current = 0;
     int numberFeatures = attributeHash.count();
     QHash< QVariant, QgsAttributes >::const_iterator attrIt = attributeHash.constBegin();
     for ( ; attrIt != attributeHash.constEnd(); ++attrIt )
@@ -136,9 +373,9 @@ QVariantMap QgsCollectorAlgorithm::processCollection( const QVariantMap &paramet
       }
 
       QgsFeature outputFeature;
-      if ( geometryHash.contains( attrIt.key() ) )
+      if ( parallel ? collectedGeometries.contains( attrIt.key() ) : geometryHash.contains( attrIt.key() ) )
       {
-        QgsGeometry geom = collector( geometryHash.value( attrIt.key() ) );
+        QgsGeometry geom = parallel ? collectedGeometries.value( attrIt.key() ) : collector( geometryHash.value( attrIt.key() ), feedback );
         if ( !geom.isMultipart() )
         {
           geom.convertToMultiType();
@@ -148,7 +385,8 @@ QVariantMap QgsCollectorAlgorithm::processCollection( const QVariantMap &paramet
       outputFeature.setAttributes( attrIt.value() );
       sink->addFeature( outputFeature, QgsFeatureSink::FastInsert );
 
-      feedback->setProgress( current * 100.0 / numberFeatures );
+      if ( !parallel )
+        feedback->setProgress( current * 100.0 / numberFeatures );
       current++;
     }
   }
@@ -214,7 +452,8 @@ QgsDissolveAlgorithm *QgsDissolveAlgorithm::createInstance() const
 
 QVariantMap QgsDissolveAlgorithm::processAlgorithm( const QVariantMap &parameters, QgsProcessingContext &context, QgsProcessingFeedback *feedback )
 {
-  return processCollection( parameters, context, feedback, [ & ]( const QVector< QgsGeometry > &parts )->QgsGeometry
+  // the collector runs on worker threads, so it only reports to the feedback it is given
+  return processCollection( parameters, context, feedback, []( const QVector< QgsGeometry > &parts, QgsProcessingFeedback * feedback )->QgsGeometry
   {
     QgsGeometry result( QgsGeometry::unaryUnion( parts ) );
     if ( QgsWkbTypes::geometryType( result.wkbType() ) == QgsWkbTypes::LineGeometry )
@@ -244,7 +483,7 @@ QVariantMap QgsDissolveAlgorithm::processAlgorithm( const QVariantMap &parameter
         throw QgsProcessingException( QObject::tr( "The algorithm returned no output." ) );
     }
     return result;
-  }, 10000 );
+  }, 10000, QgsProcessingFeatureSource::Flags(), true );
 }
 
 //
@@ -278,7 +517,7 @@ QString QgsCollectAlgorithm::groupId() const
 
 QVariantMap QgsCollectAlgorithm::processAlgorithm( const QVariantMap &parameters, QgsProcessingContext &context, QgsProcessingFeedback *feedback )
 {
-  return processCollection( parameters, context, feedback, []( const QVector< QgsGeometry > &parts )->QgsGeometry
+  return processCollection( parameters, context, feedback, []( const QVector< QgsGeometry > &parts, QgsProcessingFeedback * )->QgsGeometry
   {
     return QgsGeometry::collectGeometry( parts );
   }, 0, QgsProcessingFeatureSource::FlagSkipGeometryValidityChecks );
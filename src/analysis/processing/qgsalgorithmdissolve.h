@@ -33,8 +33,33 @@ class QgsCollectorAlgorithm : public QgsProcessingAlgorithm
 {
   protected:
 
+    /**
+     * Collects the geometries of the features from the INPUT source using \a collector,
+     * either all together or by categories of the FIELD values.
+     *
+     * If \a parallel is TRUE, the geometries of each collection are spatially sorted and
+     * collected by groups of neighbouring geometries on worker threads, whose results are
+     * then collected pairwise until a single geometry is left. The \a collector must then be
+     * thread safe, report to the feedback it is given only, and give the same result when
+     * applied to the results of a partition of the geometries (as a union does). At most
+     * \a maxQueueLength geometries are given at once to the \a collector in this case, and
+     * when all the features are collected together, the geometries read so far are reduced
+     * whenever there are more than \a maxQueueLength of them per thread.
+     */
     QVariantMap processCollection( const QVariantMap &parameters, QgsProcessingContext &context, QgsProcessingFeedback *feedback,
-                                   const std::function<QgsGeometry( const QVector<QgsGeometry>& )> &collector, int maxQueueLength = 0, QgsProcessingFeatureSource::Flags sourceFlags = QgsProcessingFeatureSource::Flags() );
+                                   const std::function<QgsGeometry( const QVector<QgsGeometry>&, QgsProcessingFeedback * )> &collector, int maxQueueLength = 0, QgsProcessingFeatureSource::Flags sourceFlags = QgsProcessingFeatureSource::Flags(),
+                                   bool parallel = false );
+
+  private:
+
+    /**
+     * Collects each of the \a collections of geometries with \a collector, as a tree reduction
+     * of spatially sorted geometries running on worker threads. Returns one geometry per collection.
+     * The progress of \a feedback goes from \a progressStart to \a progressEnd.
+     */
+    static QVector< QgsGeometry > collectInParallel( const QVector< QVector< QgsGeometry > > &collections,
+        const std::function<QgsGeometry( const QVector<QgsGeometry>&, QgsProcessingFeedback * )> &collector,
+        int maxGroupSize, QgsProcessingContext &context, QgsProcessingFeedback *feedback, double progressStart, double progressEnd );
 };
 
 /**
@@ -81,6 +81,14 @@ QgsWkbTypes::Type QgsDropMZValuesAlgorithm::outputWkbType( QgsWkbTypes::Type inp
   return wkb;
 }
 
+QgsProcessingAlgorithm::Flags QgsDropMZValuesAlgorithm::flags() const
+{
+  QgsProcessingAlgorithm::Flags f = QgsProcessingFeatureBasedAlgorithm::flags();
+  f |= QgsProcessingAlgorithm::FlagSupportsParallelFeatureProcessing;
+  f |= QgsProcessingAlgorithm::FlagSupportsStreamedInput;
+  return f;
+}
+
 QgsProcessingFeatureSource::Flag QgsDropMZValuesAlgorithm::sourceFlags() const
 {
   return QgsProcessingFeatureSource::FlagSkipGeometryValidityChecks;
@@ -41,6 +41,7 @@ class QgsDropMZValuesAlgorithm : public QgsProcessingFeatureBasedAlgorithm
     QString groupId() const override;
     QString shortHelpString() const override;
     QgsDropMZValuesAlgorithm *createInstance() const override SIP_FACTORY;
+    QgsProcessingAlgorithm::Flags flags() const override;
     bool supportInPlaceEdit( const QgsMapLayer *layer ) const override;
 
   protected:
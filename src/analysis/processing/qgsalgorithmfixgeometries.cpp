@@ -45,6 +45,13 @@ QString QgsFixGeometriesAlgorithm::groupId() const
   return QStringLiteral( "vectorgeometry" );
 }
 
+QgsProcessingAlgorithm::Flags QgsFixGeometriesAlgorithm::flags() const
+{
+  QgsProcessingAlgorithm::Flags f = QgsProcessingFeatureBasedAlgorithm::flags();
+  f |= QgsProcessingAlgorithm::FlagSupportsParallelFeatureProcessing;
+  return f;
+}
+
 QgsProcessingFeatureSource::Flag QgsFixGeometriesAlgorithm::sourceFlags() const
 {
   return QgsProcessingFeatureSource::FlagSkipGeometryValidityChecks;
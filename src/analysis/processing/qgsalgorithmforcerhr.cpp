@@ -47,6 +47,14 @@ QString QgsForceRHRAlgorithm::groupId() const
   return QStringLiteral( "vectorgeometry" );
 }
 
+QgsProcessingAlgorithm::Flags QgsForceRHRAlgorithm::flags() const
+{
+  QgsProcessingAlgorithm::Flags f = QgsProcessingFeatureBasedAlgorithm::flags();
+  f |= QgsProcessingAlgorithm::FlagSupportsParallelFeatureProcessing;
+  f |= QgsProcessingAlgorithm::FlagSupportsStreamedInput;
+  return f;
+}
+
 QgsProcessingFeatureSource::Flag QgsForceRHRAlgorithm::sourceFlags() const
 {
   return QgsProcessingFeatureSource::FlagSkipGeometryValidityChecks;
@@ -43,6 +43,7 @@ class QgsForceRHRAlgorithm : public QgsProcessingFeatureBasedAlgorithm
     QString shortDescription() const override;
     QList<int> inputLayerTypes() const override;
     QgsForceRHRAlgorithm *createInstance() const override SIP_FACTORY;
+    QgsProcessingAlgorithm::Flags flags() const override;
 
   protected:
     QgsProcessingFeatureSource::Flag sourceFlags() const override;
@@ -22,6 +22,7 @@
 #include "qgsapplication.h"
 #include "qgsfeature.h"
 #include "qgsfeaturesource.h"
+#include "qgsspatialjoinengine.h"
 
 ///@cond PRIVATE
 
@@ -315,22 +316,59 @@ void QgsJoinByLocationAlgorithm::processAlgorithmByIteratingOverJoinedSource( Qg
   if ( mBaseSource->hasSpatialIndex() == QgsFeatureSource::SpatialIndexNotPresent )
     feedback->pushWarning( QObject::tr( "No spatial index exists for input layer, performance will be severely degraded" ) );
 
+  // the base features are indexed in memory, and matched against the prepared
+  // geometries of the join features
+  QgsSpatialJoinEngine joinEngine( *mBaseSource, QgsFeatureRequest(), context, feedback );
+
   QgsFeatureIterator joinIter = mJoinSource->getFeatures( QgsFeatureRequest().setDestinationCrs( mBaseSource->sourceCrs(), context.transformContext() ).setSubsetOfAttributes( mJoinedFieldIndices ) );
-  QgsFeature f;
 
   // Create output vector layer with additional attributes
   const double step = mJoinSource->featureCount() > 0 ? 100.0 / mJoinSource->featureCount() : 1;
   long i = 0;
-  while ( joinIter.nextFeature( f ) )
+  joinEngine.run( joinIter, [this]( QgsGeometryEngine * engine, const QgsFeature & baseFeature )
   {
-    if ( feedback->isCanceled() )
-      break;
+    return featureFilter( baseFeature, engine, false );
+  },
+  [this]( const QgsFeature & joinFeature, const QVector< const QgsFeature * > &baseFeatures, QgsGeometryEngine *, QgsProcessingFeedback * ) -> QgsFeatureList
+  {
+    QgsFeatureList outputFeatures;
+    if ( baseFeatures.isEmpty() )
+      return outputFeatures;
+
+    QgsAttributes joinAttributes;
+    for ( int ix : qgis::as_const( mJoinedFieldIndices ) )
+    {
+      joinAttributes.append( joinFeature.attribute( ix ) );
+    }
 
-    processFeatureFromJoinSource( f, feedback );
+    outputFeatures.reserve( baseFeatures.size() );
+    for ( const QgsFeature *baseFeature : baseFeatures )
+    {
+      QgsFeature outputFeature( *baseFeature );
+      outputFeature.setAttributes( baseFeature->attributes() + joinAttributes );
+      outputFeatures << outputFeature;
+    }
+    return outputFeatures;
+  },
+  [ & ]( const QgsFeature &, QgsFeatureList & outputFeatures )
+  {
+    for ( QgsFeature &outputFeature : outputFeatures )
+    {
+      if ( mJoinMethod == JoinToFirst && mAddedIds.contains( outputFeature.id() ) )
+      {
+        //  already added this feature, and user has opted to only output first match
+        continue;
+      }
+
+      mAddedIds.insert( outputFeature.id() );
+      mJoinedCount++;
+      if ( mJoinedFeatures )
+        mJoinedFeatures->addFeature( outputFeature, QgsFeatureSink::FastInsert );
+    }
 
     i++;
     feedback->setProgress( i * step );
-  }
+  } );
 
   if ( !mDiscardNonMatching || mUnjoinedFeatures )
   {
@@ -371,187 +409,50 @@ void QgsJoinByLocationAlgorithm::processAlgorithmByIteratingOverInputSource( Qgs
   if ( mJoinSource->hasSpatialIndex() == QgsFeatureSource::SpatialIndexNotPresent )
     feedback->reportError( QObject::tr( "No spatial index exists for join layer, performance will be severely degraded" ) );
 
+  // the join features are indexed in memory, and matched against the prepared
+  // geometries of the base features
+  QgsSpatialJoinEngine joinEngine( *mJoinSource, QgsFeatureRequest().setDestinationCrs( mBaseSource->sourceCrs(), context.transformContext() ).setSubsetOfAttributes( mJoinedFieldIndices ), context, feedback );
+
   QgsFeatureIterator it = mBaseSource->getFeatures();
-  QgsFeature f;
+
+  QgsAttributes emptyAttributes;
+  emptyAttributes.reserve( mJoinedFieldIndices.count() );
+  for ( int i = 0; i < mJoinedFieldIndices.count(); ++i )
+    emptyAttributes << QVariant();
 
   const double step = mBaseSource->featureCount() > 0 ? 100.0 / mBaseSource->featureCount() : 1;
   long i = 0;
-  while ( it .nextFeature( f ) )
+  joinEngine.run( it, [this]( QgsGeometryEngine * engine, const QgsFeature & joinFeature )
   {
-    if ( feedback->isCanceled() )
-      break;
-
-    processFeatureFromInputSource( f, context, feedback );
-
-    i++;
-    feedback->setProgress( i * step );
-  }
-}
-
-void QgsJoinByLocationAlgorithm::sortPredicates( QList<int> &predicates )
-{
-  // Sort predicate list so that faster predicates are earlier in the list
-  // Some predicates in GEOS do not have prepared geometry implementations, and are slow to calculate. So if users
-  // are testing multiple predicates, make sure the optimised ones are always tested first just in case we can shortcut
-  // these slower ones
-
-  std::sort( predicates.begin(), predicates.end(), []( int a, int b ) -> bool
+    return featureFilter( joinFeature, engine, true );
+  },
+  [this]( const QgsFeature & baseFeature, const QVector< const QgsFeature * > &joinFeatures, QgsGeometryEngine * engine, QgsProcessingFeedback * ) -> QgsFeatureList
   {
-    // return true if predicate a is faster than b
-
-    if ( a == 0 ) // intersects is fastest
-      return true;
-    else if ( b == 0 )
-      return false;
-
-    else if ( a == 5 ) // contains is fast for polygons
-      return true;
-    else if ( b == 5 )
-      return false;
-
-    // that's it, the rest don't have optimised prepared methods (as of GEOS 3.8)
-    return a < b;
-  } );
-}
-
-bool QgsJoinByLocationAlgorithm::processFeatureFromJoinSource( QgsFeature &joinFeature, QgsProcessingFeedback *feedback )
-{
-  if ( !joinFeature.hasGeometry() )
-    return false;
-
-  const QgsGeometry featGeom = joinFeature.geometry();
-  std::unique_ptr< QgsGeometryEngine > engine;
-  QgsFeatureRequest req = QgsFeatureRequest().setFilterRect( featGeom.boundingBox() );
-  QgsFeatureIterator it = mBaseSource->getFeatures( req );
-  QList<QgsFeature> filtered;
-  QgsFeature baseFeature;
-  bool ok = false;
-  QgsAttributes joinAttributes;
-
-  while ( it.nextFeature( baseFeature ) )
-  {
-    if ( feedback->isCanceled() )
-      break;
+    QgsFeatureList outputFeatures;
+    if ( joinFeatures.isEmpty() )
+      return outputFeatures;
 
+    QVector< const QgsFeature * > matches;
     switch ( mJoinMethod )
     {
-      case JoinToFirst:
-        if ( mAddedIds.contains( baseFeature.id() ) )
-        {
-          //  already added this feature, and user has opted to only output first match
-          continue;
-        }
+      case OneToMany:
+        matches = joinFeatures;
         break;
 
-      case OneToMany:
+      case JoinToFirst:
+        matches << joinFeatures.at( 0 );
         break;
 
       case JoinToLargestOverlap:
-        Q_ASSERT_X( false, "QgsJoinByLocationAlgorithm::processFeatureFromJoinSource", "processFeatureFromJoinSource should not be used with join to largest overlap method" );
-    }
-
-    if ( !engine )
-    {
-      engine.reset( QgsGeometry::createGeometryEngine( featGeom.constGet() ) );
-      engine->prepareGeometry();
-      for ( int ix : qgis::as_const( mJoinedFieldIndices ) )
-      {
-        joinAttributes.append( joinFeature.attribute( ix ) );
-      }
-    }
-    if ( featureFilter( baseFeature, engine.get(), false ) )
-    {
-      if ( mJoinedFeatures )
-      {
-        QgsFeature outputFeature( baseFeature );
-        outputFeature.setAttributes( baseFeature.attributes() + joinAttributes );
-        mJoinedFeatures->addFeature( outputFeature, QgsFeatureSink::FastInsert );
-      }
-      if ( !ok )
-        ok = true;
-
-      mAddedIds.insert( baseFeature.id() );
-      mJoinedCount++;
-    }
-  }
-  return ok;
-}
-
-bool QgsJoinByLocationAlgorithm::processFeatureFromInputSource( QgsFeature &baseFeature, QgsProcessingContext &context, QgsProcessingFeedback *feedback )
-{
-  if ( !baseFeature.hasGeometry() )
-  {
-    // no geometry, treat as if we didn't find a match...
-    if ( mJoinedFeatures && !mDiscardNonMatching )
-    {
-      QgsAttributes emptyAttributes;
-      emptyAttributes.reserve( mJoinedFieldIndices.count() );
-      for ( int i = 0; i < mJoinedFieldIndices.count(); ++i )
-        emptyAttributes << QVariant();
-
-      QgsAttributes attributes = baseFeature.attributes();
-      attributes.append( emptyAttributes );
-      QgsFeature outputFeature( baseFeature );
-      outputFeature.setAttributes( attributes );
-      mJoinedFeatures->addFeature( outputFeature, QgsFeatureSink::FastInsert );
-    }
-
-    if ( mUnjoinedFeatures )
-      mUnjoinedFeatures->addFeature( baseFeature, QgsFeatureSink::FastInsert );
-
-    return false;
-  }
-
-  const QgsGeometry featGeom = baseFeature.geometry();
-  std::unique_ptr< QgsGeometryEngine > engine;
-  QgsFeatureRequest req = QgsFeatureRequest().setDestinationCrs( mBaseSource->sourceCrs(), context.transformContext() ).setFilterRect( featGeom.boundingBox() ).setSubsetOfAttributes( mJoinedFieldIndices );
-
-  QgsFeatureIterator it = mJoinSource->getFeatures( req );
-  QList<QgsFeature> filtered;
-  QgsFeature joinFeature;
-  bool ok = false;
-
-  double largestOverlap  = std::numeric_limits< double >::lowest();
-  QgsFeature bestMatch;
-
-  while ( it.nextFeature( joinFeature ) )
-  {
-    if ( feedback->isCanceled() )
-      break;
-
-    if ( !engine )
-    {
-      engine.reset( QgsGeometry::createGeometryEngine( featGeom.constGet() ) );
-      engine->prepareGeometry();
-    }
-
-    if ( featureFilter( joinFeature, engine.get(), true ) )
-    {
-      switch ( mJoinMethod )
       {
-        case JoinToFirst:
-        case OneToMany:
-          if ( mJoinedFeatures )
-          {
-            QgsAttributes joinAttributes = baseFeature.attributes();
-            joinAttributes.reserve( joinAttributes.size() + mJoinedFieldIndices.size() );
-            for ( int ix : qgis::as_const( mJoinedFieldIndices ) )
-            {
-              joinAttributes.append( joinFeature.attribute( ix ) );
-            }
-
-            QgsFeature outputFeature( baseFeature );
-            outputFeature.setAttributes( joinAttributes );
-            mJoinedFeatures->addFeature( outputFeature, QgsFeatureSink::FastInsert );
-          }
-          break;
-
-        case JoinToLargestOverlap:
+        double largestOverlap  = std::numeric_limits< double >::lowest();
+        const QgsFeature *bestMatch = nullptr;
+        for ( const QgsFeature *joinFeature : joinFeatures )
         {
           // calculate area of overlap
-          std::unique_ptr< QgsAbstractGeometry > intersection( engine->intersection( joinFeature.geometry().constGet() ) );
+          std::unique_ptr< QgsAbstractGeometry > intersection( engine->intersection( joinFeature->geometry().constGet() ) );
           double overlap = 0;
-          switch ( QgsWkbTypes::geometryType( intersection->wkbType() ) )
+          switch ( intersection ? QgsWkbTypes::geometryType( intersection->wkbType() ) : QgsWkbTypes::UnknownGeometry )
           {
             case QgsWkbTypes::LineGeometry:
               overlap = intersection->length();
@@ -572,77 +473,83 @@ bool QgsJoinByLocationAlgorithm::processFeatureFromInputSource( QgsFeature &base
             largestOverlap  = overlap;
             bestMatch = joinFeature;
           }
-          break;
         }
-      }
-
-      ok = true;
-
-      if ( mJoinMethod == JoinToFirst )
+        matches << bestMatch;
         break;
+      }
     }
-  }
 
-  switch ( mJoinMethod )
-  {
-    case OneToMany:
-    case JoinToFirst:
-      break;
-
-    case JoinToLargestOverlap:
+    outputFeatures.reserve( matches.size() );
+    for ( const QgsFeature *joinFeature : qgis::as_const( matches ) )
     {
-      if ( bestMatch.isValid() )
+      QgsAttributes joinAttributes = baseFeature.attributes();
+      joinAttributes.reserve( joinAttributes.size() + mJoinedFieldIndices.size() );
+      for ( int ix : qgis::as_const( mJoinedFieldIndices ) )
       {
-        // grab attributes from feature with best match
-        if ( mJoinedFeatures )
-        {
-          QgsAttributes joinAttributes = baseFeature.attributes();
-          joinAttributes.reserve( joinAttributes.size() + mJoinedFieldIndices.size() );
-          for ( int ix : qgis::as_const( mJoinedFieldIndices ) )
-          {
-            joinAttributes.append( bestMatch.attribute( ix ) );
-          }
-
-          QgsFeature outputFeature( baseFeature );
-          outputFeature.setAttributes( joinAttributes );
-          mJoinedFeatures->addFeature( outputFeature, QgsFeatureSink::FastInsert );
-        }
+        joinAttributes.append( joinFeature->attribute( ix ) );
       }
-      else
+
+      QgsFeature outputFeature( baseFeature );
+      outputFeature.setAttributes( joinAttributes );
+      outputFeatures << outputFeature;
+    }
+    return outputFeatures;
+  },
+  [ & ]( const QgsFeature & baseFeature, QgsFeatureList & outputFeatures )
+  {
+    if ( !outputFeatures.isEmpty() )
+    {
+      if ( mJoinedFeatures )
+        mJoinedFeatures->addFeatures( outputFeatures, QgsFeatureSink::FastInsert );
+      mJoinedCount++;
+    }
+    else
+    {
+      // didn't find a match (or no geometry, which is treated the same way)...
+      if ( mJoinedFeatures && !mDiscardNonMatching )
       {
-        ok = false; // shouldn't happen...
+        QgsAttributes attributes = baseFeature.attributes();
+        attributes.append( emptyAttributes );
+        QgsFeature outputFeature( baseFeature );
+        outputFeature.setAttributes( attributes );
+        mJoinedFeatures->addFeature( outputFeature, QgsFeatureSink::FastInsert );
       }
-      break;
+
+      if ( mUnjoinedFeatures )
+        mUnjoinedFeatures->addFeature( baseFeature, QgsFeatureSink::FastInsert );
     }
-  }
 
-  if ( !ok )
+    i++;
+    feedback->setProgress( i * step );
+  } );
+}
+
+void QgsJoinByLocationAlgorithm::sortPredicates( QList<int> &predicates )
+{
+  // Sort predicate list so that faster predicates are earlier in the list
+  // Some predicates in GEOS do not have prepared geometry implementations, and are slow to calculate. So if users
+  // are testing multiple predicates, make sure the optimised ones are always tested first just in case we can shortcut
+  // these slower ones
+
+  std::sort( predicates.begin(), predicates.end(), []( int a, int b ) -> bool
   {
-    // didn't find a match...
-    if ( mJoinedFeatures && !mDiscardNonMatching )
-    {
-      QgsAttributes emptyAttributes;
-      emptyAttributes.reserve( mJoinedFieldIndices.count() );
-      for ( int i = 0; i < mJoinedFieldIndices.count(); ++i )
-        emptyAttributes << QVariant();
+    // return true if predicate a is faster than b
 
-      QgsAttributes attributes = baseFeature.attributes();
-      attributes.append( emptyAttributes );
-      QgsFeature outputFeature( baseFeature );
-      outputFeature.setAttributes( attributes );
-      mJoinedFeatures->addFeature( outputFeature, QgsFeatureSink::FastInsert );
-    }
+    if ( a == 0 ) // intersects is fastest
+      return true;
+    else if ( b == 0 )
+      return false;
 
-    if ( mUnjoinedFeatures )
-      mUnjoinedFeatures->addFeature( baseFeature, QgsFeatureSink::FastInsert );
-  }
-  else
-    mJoinedCount++;
+    else if ( a == 5 ) // contains is fast for polygons
+      return true;
+    else if ( b == 5 )
+      return false;
 
-  return ok;
+    // that's it, the rest don't have optimised prepared methods (as of GEOS 3.8)
+    return a < b;
+  } );
 }
 
-
 ///@endcond
 
 
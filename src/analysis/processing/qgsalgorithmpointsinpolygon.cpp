@@ -96,6 +96,13 @@ QgsPointsInPolygonAlgorithm *QgsPointsInPolygonAlgorithm::createInstance() const
   return new QgsPointsInPolygonAlgorithm();
 }
 
+QgsProcessingAlgorithm::Flags QgsPointsInPolygonAlgorithm::flags() const
+{
+  QgsProcessingAlgorithm::Flags f = QgsProcessingFeatureBasedAlgorithm::flags();
+  f |= QgsProcessingAlgorithm::FlagSupportsParallelFeatureProcessing;
+  return f;
+}
+
 QList<int> QgsPointsInPolygonAlgorithm::inputLayerTypes() const
 {
   return QList< int >() << QgsProcessing::TypeVectorPolygon;
@@ -152,13 +159,18 @@ bool QgsPointsInPolygonAlgorithm::prepareAlgorithm( const QVariantMap &parameter
     mPointAttributes.append( mClassFieldIndex );
   }
 
-  if ( mPointSource->hasSpatialIndex() == QgsFeatureSource::SpatialIndexNotPresent )
-    feedback->reportError( QObject::tr( "No spatial index exists for points layer, performance will be severely degraded" ) );
+  // the polygon source is kept to be iterated by processAlgorithm()
+  prepareSource( parameters, context );
+
+  // the points are indexed in memory, so that polygons can be processed in parallel
+  QgsFeatureRequest req = QgsFeatureRequest().setDestinationCrs( sourceCrs(), context.transformContext() );
+  req.setSubsetOfAttributes( mPointAttributes );
+  mPoints = qgis::make_unique< QgsSpatialJoinEngine >( *mPointSource, req, context, feedback );
 
   return true;
 }
 
-QgsFeatureList QgsPointsInPolygonAlgorithm::processFeature( const QgsFeature &feature, QgsProcessingContext &context, QgsProcessingFeedback *feedback )
+QgsFeatureList QgsPointsInPolygonAlgorithm::processFeature( const QgsFeature &feature, QgsProcessingContext &, QgsProcessingFeedback *feedback )
 {
   QgsFeature outputFeature = feature;
   if ( !feature.hasGeometry() )
@@ -180,13 +192,10 @@ QgsFeatureList QgsPointsInPolygonAlgorithm::processFeature( const QgsFeature &fe
     double count = 0;
     QSet< QVariant> classes;
 
-    QgsFeatureRequest req = QgsFeatureRequest().setFilterRect( polyGeom.boundingBox() ).setDestinationCrs( mCrs, context.transformContext() );
-    req.setSubsetOfAttributes( mPointAttributes );
-    QgsFeatureIterator it = mPointSource->getFeatures( req );
+    const QgsFeatureList pointFeatures = mPoints->candidates( polyGeom.boundingBox() );
 
     bool ok = false;
-    QgsFeature pointFeature;
-    while ( it.nextFeature( pointFeature ) )
+    for ( const QgsFeature &pointFeature : pointFeatures )
     {
       if ( feedback->isCanceled() )
         break;
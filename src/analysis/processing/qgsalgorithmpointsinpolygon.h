@@ -22,6 +22,7 @@
 
 #include "qgis.h"
 #include "qgsprocessingalgorithm.h"
+#include "qgsspatialjoinengine.h"
 
 ///@cond PRIVATE
 
@@ -45,6 +46,7 @@ class QgsPointsInPolygonAlgorithm : public QgsProcessingFeatureBasedAlgorithm
     QString shortHelpString() const override;
     QString shortDescription() const override;
     QgsPointsInPolygonAlgorithm *createInstance() const override SIP_FACTORY;
+    QgsProcessingAlgorithm::Flags flags() const override;
     QList<int> inputLayerTypes() const override;
     QgsProcessing::SourceType outputLayerType() const override;
     QgsCoordinateReferenceSystem outputCrs( const QgsCoordinateReferenceSystem &inputCrs ) const override;
@@ -70,6 +72,7 @@ class QgsPointsInPolygonAlgorithm : public QgsProcessingFeatureBasedAlgorithm
     mutable QgsCoordinateReferenceSystem mCrs;
     QgsAttributeList mPointAttributes;
     std::unique_ptr< QgsProcessingFeatureSource > mPointSource;
+    std::unique_ptr< QgsSpatialJoinEngine > mPoints;
 
 };
 
@@ -45,6 +45,7 @@ class QgsPromoteToMultipartAlgorithm : public QgsProcessingFeatureBasedAlgorithm
     QString groupId() const override;
     QString shortHelpString() const override;
     QgsPromoteToMultipartAlgorithm *createInstance() const override SIP_FACTORY;
+    QgsProcessingAlgorithm::Flags flags() const override;
     bool supportInPlaceEdit( const QgsMapLayer *layer ) const override;
 
   protected:
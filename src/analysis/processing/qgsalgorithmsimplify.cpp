@@ -57,6 +57,13 @@ QString QgsSimplifyAlgorithm::shortHelpString() const
                       "(the \"Douglas-Peucker\" algorithm), area based (\"Visvalingam\" algorithm) and snapping geometries to a grid." );
 }
 
+QgsProcessingAlgorithm::Flags QgsSimplifyAlgorithm::flags() const
+{
+  QgsProcessingAlgorithm::Flags f = QgsProcessingFeatureBasedAlgorithm::flags();
+  f |= QgsProcessingAlgorithm::FlagSupportsParallelFeatureProcessing;
+  return f;
+}
+
 QgsSimplifyAlgorithm *QgsSimplifyAlgorithm::createInstance() const
 {
   return new QgsSimplifyAlgorithm();
@@ -91,7 +98,7 @@ bool QgsSimplifyAlgorithm::prepareAlgorithm( const QVariantMap &parameters, QgsP
   mTolerance = parameterAsDouble( parameters, QStringLiteral( "TOLERANCE" ), context );
   mDynamicTolerance = QgsProcessingParameters::isDynamic( parameters, QStringLiteral( "TOLERANCE" ) );
   if ( mDynamicTolerance )
-    mToleranceProperty = parameters.value( QStringLiteral( "TOLERANCE" ) ).value< QgsProperty >();
+    mToleranceProperty.setProperty( parameters.value( QStringLiteral( "TOLERANCE" ) ).value< QgsProperty >() );
 
   mMethod = static_cast< QgsMapToPixelSimplifier::SimplifyAlgorithm >( parameterAsEnum( parameters, QStringLiteral( "METHOD" ), context ) );
   if ( mMethod != QgsMapToPixelSimplifier::Distance )
@@ -111,7 +118,7 @@ QgsFeatureList QgsSimplifyAlgorithm::processFeature( const QgsFeature &feature,
     {
       double tolerance = mTolerance;
       if ( mDynamicTolerance )
-        tolerance = mToleranceProperty.valueAsDouble( context.expressionContext(), tolerance );
+        tolerance = mToleranceProperty.property().valueAsDouble( context.expressionContext(), tolerance );
       outputGeometry = inputGeometry.simplify( tolerance );
     }
     else
@@ -122,7 +129,7 @@ QgsFeatureList QgsSimplifyAlgorithm::processFeature( const QgsFeature &feature,
       }
       else
       {
-        double tolerance = mToleranceProperty.valueAsDouble( context.expressionContext(), mTolerance );
+        double tolerance = mToleranceProperty.property().valueAsDouble( context.expressionContext(), mTolerance );
         QgsMapToPixelSimplifier simplifier( QgsMapToPixelSimplifier::SimplifyGeometry, tolerance, mMethod );
         outputGeometry = simplifier.simplify( inputGeometry );
       }
@@ -24,6 +24,7 @@
 #include "qgsprocessingalgorithm.h"
 #include "qgsmaptopixelgeometrysimplifier.h"
 #include "qgsapplication.h"
+#include "qgsthreadlocalproperty.h"
 
 ///@cond PRIVATE
 
@@ -44,6 +45,7 @@ class QgsSimplifyAlgorithm : public QgsProcessingFeatureBasedAlgorithm
     QString group() const override;
     QString groupId() const override;
     QString shortHelpString() const override;
+    QgsProcessingAlgorithm::Flags flags() const override;
     QgsSimplifyAlgorithm *createInstance() const override SIP_FACTORY;
     QList<int> inputLayerTypes() const override;
     void initParameters( const QVariantMap &configuration = QVariantMap() ) override;
@@ -57,7 +59,7 @@ class QgsSimplifyAlgorithm : public QgsProcessingFeatureBasedAlgorithm
 
     double mTolerance = 1.0;
     bool mDynamicTolerance = false;
-    QgsProperty mToleranceProperty;
+    QgsThreadLocalProperty mToleranceProperty;
     QgsMapToPixelSimplifier::SimplifyAlgorithm mMethod = QgsMapToPixelSimplifier::Distance;
     std::unique_ptr< QgsMapToPixelSimplifier > mSimplifier;
 
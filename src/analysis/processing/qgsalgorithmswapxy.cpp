@@ -73,6 +73,14 @@ bool QgsSwapXYAlgorithm::supportInPlaceEdit( const QgsMapLayer *l ) const
   return layer->isSpatial();
 }
 
+QgsProcessingAlgorithm::Flags QgsSwapXYAlgorithm::flags() const
+{
+  QgsProcessingAlgorithm::Flags f = QgsProcessingFeatureBasedAlgorithm::flags();
+  f |= QgsProcessingAlgorithm::FlagSupportsParallelFeatureProcessing;
+  f |= QgsProcessingAlgorithm::FlagSupportsStreamedInput;
+  return f;
+}
+
 QgsProcessingFeatureSource::Flag QgsSwapXYAlgorithm::sourceFlags() const
 {
   // this algorithm doesn't care about invalid geometries
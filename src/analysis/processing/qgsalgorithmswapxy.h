@@ -41,6 +41,7 @@ class QgsSwapXYAlgorithm : public QgsProcessingFeatureBasedAlgorithm
     QString groupId() const override;
     QString shortHelpString() const override;
     QgsSwapXYAlgorithm *createInstance() const override SIP_FACTORY;
+    QgsProcessingAlgorithm::Flags flags() const override;
     bool supportInPlaceEdit( const QgsMapLayer *layer ) const override;
 
   protected:
@@ -79,6 +79,14 @@ QString QgsTransformAlgorithm::shortHelpString() const
                       "Attributes are not modified by this algorithm." );
 }
 
+QgsProcessingAlgorithm::Flags QgsTransformAlgorithm::flags() const
+{
+  QgsProcessingAlgorithm::Flags f = QgsProcessingFeatureBasedAlgorithm::flags();
+  f |= QgsProcessingAlgorithm::FlagSupportsParallelFeatureProcessing;
+  f |= QgsProcessingAlgorithm::FlagSupportsStreamedInput;
+  return f;
+}
+
 QgsTransformAlgorithm *QgsTransformAlgorithm::createInstance() const
 {
   return new QgsTransformAlgorithm();
@@ -96,14 +104,22 @@ bool QgsTransformAlgorithm::prepareAlgorithm( const QVariantMap &parameters, Qgs
 QgsFeatureList QgsTransformAlgorithm::processFeature( const QgsFeature &f, QgsProcessingContext &, QgsProcessingFeedback *feedback )
 {
   QgsFeature feature = f;
-  if ( !mCreatedTransform )
+
+  // features may be processed by several threads, each one transforms with its own copy,
+  // which tracks whether a fallback operation occurred
+  QgsCoordinateTransform transform;
   {
-    mCreatedTransform = true;
-    if ( !mCoordOp.isEmpty() )
-      mTransformContext.addCoordinateOperation( sourceCrs(), mDestCrs, mCoordOp, false );
-    mTransform = QgsCoordinateTransform( sourceCrs(), mDestCrs, mTransformContext );
+    QMutexLocker locker( &mTransformMutex );
+    if ( !mCreatedTransform )
+    {
+      mCreatedTransform = true;
+      if ( !mCoordOp.isEmpty() )
+        mTransformContext.addCoordinateOperation( sourceCrs(), mDestCrs, mCoordOp, false );
+      mTransform = QgsCoordinateTransform( sourceCrs(), mDestCrs, mTransformContext );
 
-    mTransform.disableFallbackOperationHandler( true );
+      mTransform.disableFallbackOperationHandler( true );
+    }
+    transform = mTransform;
   }
 
   if ( feature.hasGeometry() )
@@ -111,7 +127,7 @@ QgsFeatureList QgsTransformAlgorithm::processFeature( const QgsFeature &f, QgsPr
     QgsGeometry g = feature.geometry();
     try
     {
-      if ( g.transform( mTransform ) == 0 )
+      if ( g.transform( transform ) == 0 )
       {
         feature.setGeometry( g );
       }
@@ -120,12 +136,12 @@ QgsFeatureList QgsTransformAlgorithm::processFeature( const QgsFeature &f, QgsPr
         feature.clearGeometry();
       }
 
-      if ( !mWarnedAboutFallbackTransform && mTransform.fallbackOperationOccurred() )
+      // only warn once to avoid flooding the log
+      if ( transform.fallbackOperationOccurred() && mWarnedAboutFallbackTransform.testAndSetOrdered( 0, 1 ) )
       {
         feedback->reportError( QObject::tr( "An alternative, ballpark-only transform was used when transforming coordinates for one or more features. "
                                             "(Possibly an incorrect choice of operation was made for transformations between these reference systems - check "
                                             "that the selected operation is valid for the full extent of the input layer.)" ) );
-        mWarnedAboutFallbackTransform = true; // only warn once to avoid flooding the log
       }
     }
     catch ( QgsCsException & )
@@ -23,6 +23,9 @@
 #include "qgis_sip.h"
 #include "qgsprocessingalgorithm.h"
 
+#include <QAtomicInt>
+#include <QMutex>
+
 ///@cond PRIVATE
 
 /**
@@ -40,6 +43,7 @@ class QgsTransformAlgorithm : public QgsProcessingFeatureBasedAlgorithm
     QString group() const override;
     QString groupId() const override;
     QString shortHelpString() const override;
+    QgsProcessingAlgorithm::Flags flags() const override;
     QgsTransformAlgorithm *createInstance() const override SIP_FACTORY;
 
   protected:
@@ -54,12 +58,13 @@ class QgsTransformAlgorithm : public QgsProcessingFeatureBasedAlgorithm
 
   private:
 
+    QMutex mTransformMutex;
     bool mCreatedTransform = false;
     QgsCoordinateReferenceSystem mDestCrs;
     QgsCoordinateTransform mTransform;
     QgsCoordinateTransformContext mTransformContext;
     QString mCoordOp;
-    bool mWarnedAboutFallbackTransform = false;
+    QAtomicInt mWarnedAboutFallbackTransform = 0;
 
 };
 
@@ -62,6 +62,13 @@ QgsTranslateAlgorithm *QgsTranslateAlgorithm::createInstance() const
   return new QgsTranslateAlgorithm();
 }
 
+QgsProcessingAlgorithm::Flags QgsTranslateAlgorithm::flags() const
+{
+  QgsProcessingAlgorithm::Flags f = QgsProcessingFeatureBasedAlgorithm::flags();
+  f |= QgsProcessingAlgorithm::FlagSupportsStreamedInput;
+  return f;
+}
+
 void QgsTranslateAlgorithm::initParameters( const QVariantMap & )
 {
   std::unique_ptr< QgsProcessingParameterDistance > xOffset = qgis::make_unique< QgsProcessingParameterDistance >( QStringLiteral( "DELTA_X" ),
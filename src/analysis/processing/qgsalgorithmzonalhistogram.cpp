@@ -16,7 +16,7 @@
  ***************************************************************************/
 
 #include "qgsalgorithmzonalhistogram.h"
-#include "qgsrasteranalysisutils.h"
+#include "qgszonalrasterengine.h"
 #include "qgslogger.h"
 
 ///@cond PRIVATE
@@ -81,12 +81,9 @@ bool QgsZonalHistogramAlgorithm::prepareAlgorithm( const QVariantMap &parameters
   mHasNoDataValue = layer->dataProvider()->sourceHasNoDataValue( mRasterBand );
   mNodataValue = layer->dataProvider()->sourceNoDataValue( mRasterBand );
   mRasterInterface.reset( layer->dataProvider()->clone() );
-  mRasterExtent = layer->extent();
   mCrs = layer->crs();
   mCellSizeX = std::abs( layer->rasterUnitsPerPixelX() );
   mCellSizeY = std::abs( layer->rasterUnitsPerPixelX() );
-  mNbCellsXProvider = mRasterInterface->xSize();
-  mNbCellsYProvider = mRasterInterface->ySize();
 
   return true;
 }
@@ -114,7 +111,13 @@ QVariantMap QgsZonalHistogramAlgorithm::processAlgorithm( const QVariantMap &par
   }
   QgsFeatureIterator it = zones->getFeatures( request );
   QgsFeature f;
-  while ( it.nextFeature( f ) )
+
+  // zones are read by chunks, whose histograms are computed in parallel from the raster blocks they share
+  const QgsZonalRasterEngine engine( mRasterInterface.get(), mRasterBand, mCellSizeX, mCellSizeY );
+  const int threads = std::max( 1, context.maximumThreads() );
+  const int chunkSize = 64 * threads;
+  bool sourceExhausted = false;
+  while ( !sourceExhausted )
   {
     if ( feedback->isCanceled() )
     {
@@ -122,46 +125,39 @@ QVariantMap QgsZonalHistogramAlgorithm::processAlgorithm( const QVariantMap &par
     }
     feedback->setProgress( current * step );
 
-    if ( !f.hasGeometry() )
-    {
-      current++;
-      continue;
-    }
-
-    QgsGeometry featureGeometry = f.geometry();
-    QgsRectangle featureRect = featureGeometry.boundingBox().intersect( mRasterExtent );
-    if ( featureRect.isEmpty() )
+    QVector< QgsFeature > chunk;
+    chunk.reserve( chunkSize );
+    while ( chunk.size() < chunkSize )
     {
+      if ( !it.nextFeature( f ) )
+      {
+        sourceExhausted = true;
+        break;
+      }
       current++;
-      continue;
+      if ( !f.hasGeometry() )
+        continue;
+      chunk << f;
     }
 
-    int nCellsX, nCellsY;
-    QgsRectangle rasterBlockExtent;
-    QgsRasterAnalysisUtils::cellInfoForBBox( mRasterExtent, featureRect, mCellSizeX, mCellSizeY, nCellsX, nCellsY, mNbCellsXProvider, mNbCellsYProvider, rasterBlockExtent );
-
-    QHash< double, qgssize > fUniqueValues;
-    QgsRasterAnalysisUtils::statisticsFromMiddlePointTest( mRasterInterface.get(), mRasterBand, featureGeometry, nCellsX, nCellsY, mCellSizeX, mCellSizeY,
-    rasterBlockExtent, [ &fUniqueValues]( double value ) { fUniqueValues[value]++; }, false );
-
-    if ( fUniqueValues.count() < 1 )
+    std::vector< QHash< double, qgssize > > chunkUniqueValues( chunk.size() );
+    QgsZonalRasterEngine::processInParallel( chunk.size(), threads, [&engine, &chunk, &chunkUniqueValues]( int index )
     {
-      // The cell resolution is probably larger than the polygon area. We switch to slower precise pixel - polygon intersection in this case
-      // TODO: eventually deal with weight if needed
-      QgsRasterAnalysisUtils::statisticsFromPreciseIntersection( mRasterInterface.get(), mRasterBand, featureGeometry, nCellsX, nCellsY, mCellSizeX, mCellSizeY,
-      rasterBlockExtent, [ &fUniqueValues]( double value, double ) { fUniqueValues[value]++; }, false );
-    }
+      chunkUniqueValues[ index ] = engine.histogram( chunk.at( index ).geometry() );
+    }, feedback );
 
-    for ( auto it = fUniqueValues.constBegin(); it != fUniqueValues.constEnd(); ++it )
+    for ( int i = 0; i < chunk.size(); ++i )
     {
-      if ( uniqueValues.indexOf( it.key() ) == -1 )
+      const QHash< double, qgssize > &fUniqueValues = chunkUniqueValues[ i ];
+      for ( auto it = fUniqueValues.constBegin(); it != fUniqueValues.constEnd(); ++it )
       {
-        uniqueValues << it.key();
+        if ( uniqueValues.indexOf( it.key() ) == -1 )
+        {
+          uniqueValues << it.key();
+        }
+        featuresUniqueValues[chunk.at( i ).id()][it.key()] += it.value();
       }
-      featuresUniqueValues[f.id()][it.key()] += it.value();
     }
-
-    current++;
   }
 
   std::sort( uniqueValues.begin(), uniqueValues.end() );
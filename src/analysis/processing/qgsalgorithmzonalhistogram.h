@@ -55,12 +55,9 @@ class QgsZonalHistogramAlgorithm : public QgsProcessingAlgorithm
     int mRasterBand;
     bool mHasNoDataValue = false;
     float mNodataValue = -1;
-    QgsRectangle mRasterExtent;
     QgsCoordinateReferenceSystem mCrs;
     double mCellSizeX;
     double mCellSizeY;
-    double mNbCellsXProvider;
-    double mNbCellsYProvider;
 
 };
 
@@ -72,6 +72,13 @@ QList<int> QgsZonalStatisticsFeatureBasedAlgorithm::inputLayerTypes() const
   return QList<int>() << QgsProcessing::TypeVectorPolygon;
 }
 
+QgsProcessingAlgorithm::Flags QgsZonalStatisticsFeatureBasedAlgorithm::flags() const
+{
+  QgsProcessingAlgorithm::Flags f = QgsProcessingFeatureBasedAlgorithm::flags();
+  f |= QgsProcessingAlgorithm::FlagSupportsParallelFeatureProcessing;
+  return f;
+}
+
 QgsZonalStatisticsFeatureBasedAlgorithm *QgsZonalStatisticsFeatureBasedAlgorithm::createInstance() const
 {
   return new QgsZonalStatisticsFeatureBasedAlgorithm();
@@ -135,6 +142,8 @@ bool QgsZonalStatisticsFeatureBasedAlgorithm::prepareAlgorithm( const QVariantMa
   mCrs = rasterLayer->crs();
   mPixelSizeX = rasterLayer->rasterUnitsPerPixelX();
   mPixelSizeY = rasterLayer->rasterUnitsPerPixelY();
+  // shared by all the features, so that the raster blocks covering neighbouring features are only read once
+  mEngine = qgis::make_unique< QgsZonalRasterEngine >( mRaster.get(), mBand, mPixelSizeX, mPixelSizeY );
   std::unique_ptr<QgsFeatureSource> source( parameterAsSource( parameters, inputParameterName(), context ) );
 
   mOutputFields = source->fields();
@@ -163,7 +172,7 @@ QgsFeatureList QgsZonalStatisticsFeatureBasedAlgorithm::processFeature( const Qg
   QgsAttributes attributes = feature.attributes();
   attributes.resize( mOutputFields.size() );
 
-  QMap<QgsZonalStatistics::Statistic, QVariant> results = QgsZonalStatistics::calculateStatistics( mRaster.get(), feature.geometry(), mPixelSizeX, mPixelSizeY, mBand, mStats );
+  QMap<QgsZonalStatistics::Statistic, QVariant> results = mEngine->statistics( feature.geometry(), mStats );
   for ( auto result = results.constBegin(); result != results.constEnd(); ++result )
   {
     attributes.replace( mStatFieldsMapping.value( result.key() ), result.value() );
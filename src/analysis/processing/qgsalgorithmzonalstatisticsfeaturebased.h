@@ -24,6 +24,7 @@
 #include "qgsprocessingalgorithm.h"
 #include "qgsvectorlayer.h"
 #include "vector/qgszonalstatistics.h"
+#include "qgszonalrasterengine.h"
 
 ///@cond PRIVATE
 
@@ -43,6 +44,7 @@ class QgsZonalStatisticsFeatureBasedAlgorithm : public QgsProcessingFeatureBased
     QString groupId() const override;
     QString shortHelpString() const override;
     QList<int> inputLayerTypes() const override;
+    QgsProcessingAlgorithm::Flags flags() const override;
 
     QgsZonalStatisticsFeatureBasedAlgorithm *createInstance() const override SIP_FACTORY;
 
@@ -58,6 +60,7 @@ class QgsZonalStatisticsFeatureBasedAlgorithm : public QgsProcessingFeatureBased
 
   private:
     std::unique_ptr< QgsRasterInterface > mRaster;
+    std::unique_ptr< QgsZonalRasterEngine > mEngine;
     int mBand;
     QString mPrefix;
     QgsZonalStatistics::Statistics mStats = QgsZonalStatistics::All;
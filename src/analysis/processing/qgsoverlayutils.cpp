@@ -17,6 +17,7 @@
 
 #include "qgsgeometryengine.h"
 #include "qgsprocessingalgorithm.h"
+#include "qgsspatialjoinengine.h"
 
 ///@cond PRIVATE
 
@@ -89,106 +90,86 @@ void QgsOverlayUtils::difference( const QgsFeatureSource &sourceA, const QgsFeat
   requestB.setNoAttributes();
   if ( outputAttrs != OutputBA )
     requestB.setDestinationCrs( sourceA.sourceCrs(), context.transformContext() );
-  QgsSpatialIndex indexB( sourceB.getFeatures( requestB ), feedback );
+  QgsSpatialJoinEngine joinEngine( sourceB, requestB, context, feedback );
 
   int fieldsCountA = sourceA.fields().count();
   int fieldsCountB = sourceB.fields().count();
-  QgsAttributes attrs;
-  attrs.resize( outputAttrs == OutputA ? fieldsCountA : ( fieldsCountA + fieldsCountB ) );
+  const int attrsCount = outputAttrs == OutputA ? fieldsCountA : ( fieldsCountA + fieldsCountB );
 
   if ( totalCount == 0 )
     totalCount = 1;  // avoid division by zero
 
-  QgsFeature featA;
   QgsFeatureRequest requestA;
   requestA.setInvalidGeometryCheck( context.invalidGeometryCheck() );
   if ( outputAttrs == OutputBA )
     requestA.setDestinationCrs( sourceB.sourceCrs(), context.transformContext() );
   QgsFeatureIterator fitA = sourceA.getFeatures( requestA );
-  while ( fitA.nextFeature( featA ) )
-  {
-    if ( feedback->isCanceled() )
-      break;
 
-    if ( featA.hasGeometry() )
+  joinEngine.run( fitA, []( QgsGeometryEngine * engine, const QgsFeature & featB )
+  {
+    return engine->intersects( featB.geometry().constGet() );
+  },
+  [ = ]( const QgsFeature & featA, const QVector< const QgsFeature * > &matchesB, QgsGeometryEngine *, QgsProcessingFeedback * ) -> QgsFeatureList
+  {
+    if ( !featA.hasGeometry() )
     {
-      QgsGeometry geom( featA.geometry() );
-      QgsFeatureIds intersects = qgis::listToSet( indexB.intersects( geom.boundingBox() ) );
-
-      QgsFeatureRequest request;
-      request.setFilterFids( intersects );
-      request.setNoAttributes();
-      if ( outputAttrs != OutputBA )
-        request.setDestinationCrs( sourceA.sourceCrs(), context.transformContext() );
-
-      std::unique_ptr< QgsGeometryEngine > engine;
-      if ( !intersects.isEmpty() )
-      {
-        // use prepared geometries for faster intersection tests
-        engine.reset( QgsGeometry::createGeometryEngine( geom.constGet() ) );
-        engine->prepareGeometry();
-      }
+      // TODO: should we write out features that do not have geometry?
+      return QgsFeatureList() << featA;
+    }
 
+    QgsGeometry geom( featA.geometry() );
+    if ( !matchesB.isEmpty() )
+    {
       QVector<QgsGeometry> geometriesB;
-      QgsFeature featB;
-      QgsFeatureIterator fitB = sourceB.getFeatures( request );
-      while ( fitB.nextFeature( featB ) )
-      {
-        if ( feedback->isCanceled() )
-          break;
-
-        if ( engine->intersects( featB.geometry().constGet() ) )
-          geometriesB << featB.geometry();
-      }
+      geometriesB.reserve( matchesB.size() );
+      for ( const QgsFeature *featB : matchesB )
+        geometriesB << featB->geometry();
 
-      if ( !geometriesB.isEmpty() )
+      QgsGeometry geomB = QgsGeometry::unaryUnion( geometriesB );
+      if ( !geomB.lastError().isEmpty() )
       {
-        QgsGeometry geomB = QgsGeometry::unaryUnion( geometriesB );
-        if ( !geomB.lastError().isEmpty() )
-        {
-          // This may happen if input geometries from a layer do not line up well (for example polygons
-          // that are nearly touching each other, but there is a very tiny overlap or gap at one of the edges).
-          // It is possible to get rid of this issue in two steps:
-          // 1. snap geometries with a small tolerance (e.g. 1cm) using QgsGeometrySnapperSingleSource
-          // 2. fix geometries (removes polygons collapsed to lines etc.) using MakeValid
-          throw QgsProcessingException( QStringLiteral( "%1\n\n%2" ).arg( QObject::tr( "GEOS geoprocessing error: unary union failed." ), geomB.lastError() ) );
-        }
-        geom = geom.difference( geomB );
+        // This may happen if input geometries from a layer do not line up well (for example polygons
+        // that are nearly touching each other, but there is a very tiny overlap or gap at one of the edges).
+        // It is possible to get rid of this issue in two steps:
+        // 1. snap geometries with a small tolerance (e.g. 1cm) using QgsGeometrySnapperSingleSource
+        // 2. fix geometries (removes polygons collapsed to lines etc.) using MakeValid
+        throw QgsProcessingException( QStringLiteral( "%1\n\n%2" ).arg( QObject::tr( "GEOS geoprocessing error: unary union failed." ), geomB.lastError() ) );
       }
+      geom = geom.difference( geomB );
+    }
 
-      if ( !sanitizeDifferenceResult( geom, geometryType ) )
-        continue;
-
-      const QgsAttributes attrsA( featA.attributes() );
-      switch ( outputAttrs )
-      {
-        case OutputA:
-          attrs = attrsA;
-          break;
-        case OutputAB:
-          for ( int i = 0; i < fieldsCountA; ++i )
-            attrs[i] = attrsA[i];
-          break;
-        case OutputBA:
-          for ( int i = 0; i < fieldsCountA; ++i )
-            attrs[i + fieldsCountB] = attrsA[i];
-          break;
-      }
+    if ( !sanitizeDifferenceResult( geom, geometryType ) )
+      return QgsFeatureList();
 
-      QgsFeature outFeat;
-      outFeat.setGeometry( geom );
-      outFeat.setAttributes( attrs );
-      sink.addFeature( outFeat, QgsFeatureSink::FastInsert );
-    }
-    else
+    QgsAttributes attrs( attrsCount );
+    const QgsAttributes attrsA( featA.attributes() );
+    switch ( outputAttrs )
     {
-      // TODO: should we write out features that do not have geometry?
-      sink.addFeature( featA, QgsFeatureSink::FastInsert );
+      case OutputA:
+        attrs = attrsA;
+        break;
+      case OutputAB:
+        for ( int i = 0; i < fieldsCountA; ++i )
+          attrs[i] = attrsA[i];
+        break;
+      case OutputBA:
+        for ( int i = 0; i < fieldsCountA; ++i )
+          attrs[i + fieldsCountB] = attrsA[i];
+        break;
     }
 
+    QgsFeature outFeat;
+    outFeat.setGeometry( geom );
+    outFeat.setAttributes( attrs );
+    return QgsFeatureList() << outFeat;
+  },
+  [ & ]( const QgsFeature &, QgsFeatureList & results )
+  {
+    sink.addFeatures( results, QgsFeatureSink::FastInsert );
+
     ++count;
     feedback->setProgress( count / ( double ) totalCount * 100. );
-  }
+  } );
 }
 
 
@@ -198,73 +179,56 @@ void QgsOverlayUtils::intersection( const QgsFeatureSource &sourceA, const QgsFe
   int attrCount = fieldIndicesA.count() + fieldIndicesB.count();
 
   QgsFeatureRequest request;
-  request.setNoAttributes();
+  request.setSubsetOfAttributes( fieldIndicesB );
   request.setDestinationCrs( sourceA.sourceCrs(), context.transformContext() );
-
-  QgsFeature outFeat;
-  QgsSpatialIndex indexB( sourceB.getFeatures( request ), feedback );
+  QgsSpatialJoinEngine joinEngine( sourceB, request, context, feedback );
 
   if ( totalCount == 0 )
     totalCount = 1;  // avoid division by zero
 
-  QgsFeature featA;
   QgsFeatureIterator fitA = sourceA.getFeatures( QgsFeatureRequest().setSubsetOfAttributes( fieldIndicesA ) );
-  while ( fitA.nextFeature( featA ) )
-  {
-    if ( feedback->isCanceled() )
-      break;
 
+  joinEngine.run( fitA, []( QgsGeometryEngine * engine, const QgsFeature & featB )
+  {
+    return engine->intersects( featB.geometry().constGet() );
+  },
+  [ = ]( const QgsFeature & featA, const QVector< const QgsFeature * > &matchesB, QgsGeometryEngine *, QgsProcessingFeedback * ) -> QgsFeatureList
+  {
+    QgsFeatureList outFeatures;
     if ( !featA.hasGeometry() )
-      continue;
+      return outFeatures;
 
-    QgsGeometry geom( featA.geometry() );
-    QgsFeatureIds intersects = qgis::listToSet( indexB.intersects( geom.boundingBox() ) );
-
-    QgsFeatureRequest request;
-    request.setFilterFids( intersects );
-    request.setDestinationCrs( sourceA.sourceCrs(), context.transformContext() );
-    request.setSubsetOfAttributes( fieldIndicesB );
-
-    std::unique_ptr< QgsGeometryEngine > engine;
-    if ( !intersects.isEmpty() )
-    {
-      // use prepared geometries for faster intersection tests
-      engine.reset( QgsGeometry::createGeometryEngine( geom.constGet() ) );
-      engine->prepareGeometry();
-    }
+    const QgsGeometry geom( featA.geometry() );
 
     QgsAttributes outAttributes( attrCount );
     const QgsAttributes attrsA( featA.attributes() );
     for ( int i = 0; i < fieldIndicesA.count(); ++i )
       outAttributes[i] = attrsA[fieldIndicesA[i]];
 
-    QgsFeature featB;
-    QgsFeatureIterator fitB = sourceB.getFeatures( request );
-    while ( fitB.nextFeature( featB ) )
+    for ( const QgsFeature *featB : matchesB )
     {
-      if ( feedback->isCanceled() )
-        break;
-
-      QgsGeometry tmpGeom( featB.geometry() );
-      if ( !engine->intersects( tmpGeom.constGet() ) )
-        continue;
-
-      QgsGeometry intGeom = geom.intersection( tmpGeom );
+      QgsGeometry intGeom = geom.intersection( featB->geometry() );
       if ( !sanitizeIntersectionResult( intGeom, geometryType ) )
         continue;
 
-      const QgsAttributes attrsB( featB.attributes() );
+      const QgsAttributes attrsB( featB->attributes() );
       for ( int i = 0; i < fieldIndicesB.count(); ++i )
         outAttributes[fieldIndicesA.count() + i] = attrsB[fieldIndicesB[i]];
 
+      QgsFeature outFeat;
       outFeat.setGeometry( intGeom );
       outFeat.setAttributes( outAttributes );
-      sink.addFeature( outFeat, QgsFeatureSink::FastInsert );
+      outFeatures << outFeat;
     }
+    return outFeatures;
+  },
+  [ & ]( const QgsFeature &, QgsFeatureList & results )
+  {
+    sink.addFeatures( results, QgsFeatureSink::FastInsert );
 
     ++count;
     feedback->setProgress( count / ( double ) totalCount * 100. );
-  }
+  } );
 }
 
 void QgsOverlayUtils::resolveOverlaps( const QgsFeatureSource &source, QgsFeatureSink &sink, QgsProcessingFeedback *feedback )
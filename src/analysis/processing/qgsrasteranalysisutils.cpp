@@ -18,7 +18,6 @@
 #include "qgsfeedback.h"
 #include "qgsrasterblock.h"
 #include "qgsrasteriterator.h"
-#include "qgsgeos.h"
 #include "qgsprocessingparameters.h"
 #include <map>
 #include <unordered_map>
@@ -59,112 +58,6 @@ void QgsRasterAnalysisUtils::cellInfoForBBox( const QgsRectangle &rasterBBox, co
                                     rasterBBox.yMaximum() - ( nCellsY + offsetY ) * cellSizeY );
 }
 
-void QgsRasterAnalysisUtils::statisticsFromMiddlePointTest( QgsRasterInterface *rasterInterface, int rasterBand, const QgsGeometry &poly, int nCellsX, int nCellsY, double cellSizeX, double cellSizeY, const QgsRectangle &rasterBBox,  const std::function<void( double )> &addValue, bool skipNodata )
-{
-  std::unique_ptr< QgsGeometryEngine > polyEngine( QgsGeometry::createGeometryEngine( poly.constGet( ) ) );
-  if ( !polyEngine )
-  {
-    return;
-  }
-  polyEngine->prepareGeometry();
-
-  QgsRasterIterator iter( rasterInterface );
-  iter.startRasterRead( rasterBand, nCellsX, nCellsY, rasterBBox );
-
-  std::unique_ptr< QgsRasterBlock > block;
-  int iterLeft = 0;
-  int iterTop = 0;
-  int iterCols = 0;
-  int iterRows = 0;
-  QgsRectangle blockExtent;
-  bool isNoData = false;
-  while ( iter.readNextRasterPart( rasterBand, iterCols, iterRows, block, iterLeft, iterTop, &blockExtent ) )
-  {
-    double cellCenterY = blockExtent.yMaximum() - 0.5 * cellSizeY;
-
-    for ( int row = 0; row < iterRows; ++row )
-    {
-      double cellCenterX = blockExtent.xMinimum() + 0.5 * cellSizeX;
-      for ( int col = 0; col < iterCols; ++col )
-      {
-        const double pixelValue = block->valueAndNoData( row, col, isNoData );
-        if ( validPixel( pixelValue ) && ( !skipNodata || !isNoData ) )
-        {
-          QgsPoint cellCenter( cellCenterX, cellCenterY );
-          if ( polyEngine->contains( &cellCenter ) )
-          {
-            addValue( pixelValue );
-          }
-        }
-        cellCenterX += cellSizeX;
-      }
-      cellCenterY -= cellSizeY;
-    }
-  }
-}
-
-void QgsRasterAnalysisUtils::statisticsFromPreciseIntersection( QgsRasterInterface *rasterInterface, int rasterBand, const QgsGeometry &poly, int nCellsX, int nCellsY, double cellSizeX, double cellSizeY, const QgsRectangle &rasterBBox,  const std::function<void( double, double )> &addValue, bool skipNodata )
-{
-  QgsGeometry pixelRectGeometry;
-
-  double hCellSizeX = cellSizeX / 2.0;
-  double hCellSizeY = cellSizeY / 2.0;
-  double pixelArea = cellSizeX * cellSizeY;
-  double weight = 0;
-
-  std::unique_ptr< QgsGeometryEngine > polyEngine( QgsGeometry::createGeometryEngine( poly.constGet( ) ) );
-  if ( !polyEngine )
-  {
-    return;
-  }
-  polyEngine->prepareGeometry();
-
-  QgsRasterIterator iter( rasterInterface );
-  iter.startRasterRead( rasterBand, nCellsX, nCellsY, rasterBBox );
-
-  std::unique_ptr< QgsRasterBlock > block;
-  int iterLeft = 0;
-  int iterTop = 0;
-  int iterCols = 0;
-  int iterRows = 0;
-  QgsRectangle blockExtent;
-  bool isNoData = false;
-  while ( iter.readNextRasterPart( rasterBand, iterCols, iterRows, block, iterLeft, iterTop, &blockExtent ) )
-  {
-    double currentY = blockExtent.yMaximum() - 0.5 * cellSizeY;
-    for ( int row = 0; row < iterRows; ++row )
-    {
-      double currentX = blockExtent.xMinimum() + 0.5 * cellSizeX;
-      for ( int col = 0; col < iterCols; ++col )
-      {
-        const double pixelValue = block->valueAndNoData( row, col, isNoData );
-        if ( validPixel( pixelValue ) && ( !skipNodata || !isNoData ) )
-        {
-          pixelRectGeometry = QgsGeometry::fromRect( QgsRectangle( currentX - hCellSizeX, currentY - hCellSizeY, currentX + hCellSizeX, currentY + hCellSizeY ) );
-          // GEOS intersects tests on prepared geometry is MAGNITUDES faster than calculating the intersection itself,
-          // so we first test to see if there IS an intersection before doing the actual calculation
-          if ( !pixelRectGeometry.isNull() && polyEngine->intersects( pixelRectGeometry.constGet() ) )
-          {
-            //intersection
-            QgsGeometry intersectGeometry = pixelRectGeometry.intersection( poly );
-            if ( !intersectGeometry.isEmpty() )
-            {
-              double intersectionArea = intersectGeometry.area();
-              if ( intersectionArea > 0.0 )
-              {
-                weight = intersectionArea / pixelArea;
-                addValue( pixelValue, weight );
-              }
-            }
-          }
-        }
-        currentX += cellSizeX;
-      }
-      currentY -= cellSizeY;
-    }
-  }
-}
-
 bool QgsRasterAnalysisUtils::validPixel( double value )
 {
   return !std::isnan( value );
@@ -28,7 +28,6 @@
 ///@cond PRIVATE
 
 class QgsRasterInterface;
-class QgsGeometry;
 class QgsRectangle;
 class QgsProcessingParameterDefinition;
 class QgsRasterProjector;
@@ -46,14 +45,6 @@ namespace QgsRasterAnalysisUtils
                         int rasterWidth, int rasterHeight,
                         QgsRectangle &rasterBlockExtent );
 
-  //! Returns statistics by considering the pixels where the center point is within the polygon (fast)
-  void statisticsFromMiddlePointTest( QgsRasterInterface *rasterInterface, int rasterBand, const QgsGeometry &poly, int nCellsX, int nCellsY,
-                                      double cellSizeX, double cellSizeY, const QgsRectangle &rasterBBox, const std::function<void( double )> &addValue, bool skipNodata = true );
-
-  //! Returns statistics with precise pixel - polygon intersection test (slow)
-  void statisticsFromPreciseIntersection( QgsRasterInterface *rasterInterface, int rasterBand, const QgsGeometry &poly, int nCellsX, int nCellsY,
-                                          double cellSizeX, double cellSizeY, const QgsRectangle &rasterBBox, const std::function<void( double, double )> &addValue, bool skipNodata = true );
-
   //! Tests whether a pixel's value should be included in the result
   bool validPixel( double value );
 
@@ -0,0 +1,241 @@
+/***************************************************************************
+  qgsspatialjoinengine.cpp
+  ------------------------
+  Date                 : October 2026
+  Copyright            : (C) 2026 by QGIS contributors
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qgsspatialjoinengine.h"
+#include "qgsexception.h"
+#include "qgsfeatureiterator.h"
+#include "qgsfeaturerequest.h"
+#include "qgsfeaturesource.h"
+#include "qgsgeometryengine.h"
+#include "qgsprocessingcontext.h"
+#include "qgsprocessingfeedback.h"
+
+#include <QCache>
+#include <QThreadPool>
+#include <QtConcurrent>
+
+#include <algorithm>
+
+///@cond PRIVATE
+
+/**
+ * A batch of consecutive features processed by one worker thread, with the IDs
+ * of the candidates of each feature.
+ */
+struct QgsSpatialJoinBatch
+{
+  QVector< QgsFeature > features;
+  QVector< QVector< QgsFeatureId > > candidates;
+  QVector< QgsFeatureList > results;
+  QgsProcessingBufferedFeedback feedback;
+  QString error;
+};
+
+QgsSpatialJoinEngine::QgsSpatialJoinEngine( const QgsFeatureSource &source, const QgsFeatureRequest &request, QgsProcessingContext &context, QgsProcessingFeedback *feedback )
+  : mFeedback( feedback )
+  , mThreads( std::max( 1, context.maximumThreads() ) )
+  , mSource( source )
+  , mRequest( request )
+{
+  // only the bounding boxes are needed to build the index
+  QgsFeatureIterator it = source.getFeatures( QgsFeatureRequest( request ).setNoAttributes() );
+  mIndex = QgsPackedSpatialIndex( it, feedback );
+}
+
+QVector< QgsFeatureId > QgsSpatialJoinEngine::candidateIds( const QgsRectangle &rectangle ) const
+{
+  QVector< QgsFeatureId > ids;
+  mIndex.intersects( rectangle, [&ids]( QgsFeatureId id ) -> bool
+  {
+    ids << id;
+    return true;
+  } );
+  std::sort( ids.begin(), ids.end() );
+  return ids;
+}
+
+QHash< QgsFeatureId, QgsFeature > QgsSpatialJoinEngine::fetch( const QgsFeatureIds &ids ) const
+{
+  QHash< QgsFeatureId, QgsFeature > features;
+  if ( ids.isEmpty() )
+    return features;
+
+  features.reserve( ids.size() );
+  QMutexLocker locker( &mSourceMutex );
+  QgsFeatureIterator it = mSource.getFeatures( QgsFeatureRequest( mRequest ).setFilterFids( ids ) );
+  QgsFeature f;
+  while ( it.nextFeature( f ) )
+  {
+    if ( f.hasGeometry() )
+      features.insert( f.id(), f );
+  }
+  return features;
+}
+
+QgsFeatureList QgsSpatialJoinEngine::candidates( const QgsRectangle &rectangle ) const
+{
+  const QVector< QgsFeatureId > ids = candidateIds( rectangle );
+  QgsFeatureIds idSet;
+  idSet.reserve( ids.size() );
+  for ( QgsFeatureId id : ids )
+    idSet.insert( id );
+  const QHash< QgsFeatureId, QgsFeature > features = fetch( idSet );
+
+  QgsFeatureList result;
+  result.reserve( features.size() );
+  for ( QgsFeatureId id : ids )
+  {
+    auto it = features.constFind( id );
+    if ( it != features.constEnd() )
+      result << it.value();
+  }
+  return result;
+}
+
+void QgsSpatialJoinEngine::run( QgsFeatureIterator &iterator, const Predicate &predicate, const Handler &handler, const Consumer &consumer )
+{
+  // Features are read by chunks from this thread. The batches of a chunk are
+  // matched by worker threads of a dedicated pool, and their results are then
+  // handed to the consumer in order, from this thread.
+  const int batchSize = 64;
+  const int chunkSize = 4 * batchSize * mThreads;
+
+  // the candidates of the current chunk, fetched from this thread and only read by the workers
+  QHash< QgsFeatureId, QgsFeature > joinedFeatures;
+
+  // consecutive features are usually close to each other, so the candidates recently
+  // fetched are kept for the next chunks, and only the least recently used are dropped
+  QCache< QgsFeatureId, QgsFeature > recentFeatures( 4 * chunkSize );
+
+  auto processBatch = [&joinedFeatures, &predicate, &handler]( QgsSpatialJoinBatch * batch )
+  {
+    batch->results.reserve( batch->features.size() );
+    try
+    {
+      for ( int i = 0; i < batch->features.size(); ++i )
+      {
+        if ( batch->feedback.isCanceled() )
+          break;
+
+        const QgsFeature &feature = batch->features.at( i );
+        QVector< const QgsFeature * > matches;
+        std::unique_ptr< QgsGeometryEngine > engine;
+        for ( QgsFeatureId id : batch->candidates.at( i ) )
+        {
+          auto candidate = joinedFeatures.constFind( id );
+          if ( candidate == joinedFeatures.constEnd() )
+            continue;
+
+          if ( !engine )
+          {
+            // use prepared geometries for faster tests
+            engine.reset( QgsGeometry::createGeometryEngine( feature.geometry().constGet() ) );
+            engine->prepareGeometry();
+          }
+          if ( !predicate || predicate( engine.get(), candidate.value() ) )
+            matches << &candidate.value();
+        }
+        batch->results << handler( feature, matches, engine.get(), &batch->feedback );
+      }
+    }
+    catch ( QgsException &e )
+    {
+      batch->error = e.what();
+    }
+    catch ( std::exception &e )
+    {
+      batch->error = QString::fromLocal8Bit( e.what() );
+    }
+  };
+
+  QThreadPool pool;
+  pool.setMaxThreadCount( mThreads );
+
+  bool sourceExhausted = false;
+  while ( !sourceExhausted && !mFeedback->isCanceled() )
+  {
+    std::vector< std::unique_ptr< QgsSpatialJoinBatch > > batches;
+    QgsFeatureIds chunkCandidates;
+    QgsFeature f;
+    for ( int read = 0; read < chunkSize; ++read )
+    {
+      if ( !iterator.nextFeature( f ) )
+      {
+        sourceExhausted = true;
+        break;
+      }
+
+      if ( batches.empty() || batches.back()->features.size() >= batchSize )
+      {
+        std::unique_ptr< QgsSpatialJoinBatch > batch = qgis::make_unique< QgsSpatialJoinBatch >();
+        batch->features.reserve( batchSize );
+        QObject::connect( mFeedback, &QgsFeedback::canceled, &batch->feedback, &QgsFeedback::cancel, Qt::DirectConnection );
+        batches.emplace_back( std::move( batch ) );
+      }
+      QVector< QgsFeatureId > ids;
+      if ( f.hasGeometry() )
+        ids = candidateIds( f.geometry().boundingBox() );
+      for ( QgsFeatureId id : qgis::as_const( ids ) )
+        chunkCandidates.insert( id );
+      batches.back()->features << f;
+      batches.back()->candidates << ids;
+    }
+
+    if ( batches.empty() )
+      break;
+
+    joinedFeatures.clear();
+    joinedFeatures.reserve( chunkCandidates.size() );
+    QgsFeatureIds missingCandidates;
+    for ( QgsFeatureId id : qgis::as_const( chunkCandidates ) )
+    {
+      if ( const QgsFeature *recent = recentFeatures.object( id ) )
+        joinedFeatures.insert( id, *recent );
+      else
+        missingCandidates.insert( id );
+    }
+    const QHash< QgsFeatureId, QgsFeature > fetched = fetch( missingCandidates );
+    for ( auto it = fetched.constBegin(); it != fetched.constEnd(); ++it )
+    {
+      joinedFeatures.insert( it.key(), it.value() );
+      recentFeatures.insert( it.key(), new QgsFeature( it.value() ) );
+    }
+
+    if ( batches.size() == 1 || mThreads == 1 )
+    {
+      for ( const std::unique_ptr< QgsSpatialJoinBatch > &batch : batches )
+        processBatch( batch.get() );
+    }
+    else
+    {
+      QList< QFuture< void > > futures;
+      for ( const std::unique_ptr< QgsSpatialJoinBatch > &batch : batches )
+        futures << QtConcurrent::run( &pool, processBatch, batch.get() );
+      for ( QFuture< void > &future : futures )
+        future.waitForFinished();
+    }
+
+    for ( const std::unique_ptr< QgsSpatialJoinBatch > &batch : batches )
+    {
+      batch->feedback.flush( mFeedback );
+      if ( !batch->error.isEmpty() )
+        throw QgsProcessingException( batch->error );
+
+      for ( int i = 0; i < batch->results.size(); ++i )
+        consumer( batch->features.at( i ), batch->results[ i ] );
+    }
+  }
+}
+
+///@endcond
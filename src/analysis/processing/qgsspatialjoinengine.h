@@ -0,0 +1,139 @@
+/***************************************************************************
+  qgsspatialjoinengine.h
+  ----------------------
+  Date                 : October 2026
+  Copyright            : (C) 2026 by QGIS contributors
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef QGSSPATIALJOINENGINE_H
+#define QGSSPATIALJOINENGINE_H
+
+#define SIP_NO_FILE
+
+#include "qgis_analysis.h"
+#include "qgsfeature.h"
+#include "qgsfeaturerequest.h"
+#include "qgspackedspatialindex.h"
+#include "qgsrectangle.h"
+
+#include <functional>
+#include <QHash>
+#include <QMutex>
+#include <QVector>
+
+class QgsFeatureIterator;
+class QgsFeatureSource;
+class QgsGeometryEngine;
+class QgsProcessingContext;
+class QgsProcessingFeedback;
+
+///@cond PRIVATE
+
+/**
+ * Matches the features of a source against the features of a second, joined source,
+ * using several threads.
+ *
+ * Only the bounding boxes and the IDs of the features of the joined source are kept in memory,
+ * in a QgsPackedSpatialIndex built when the engine is created. The features themselves are
+ * fetched by ID when they are candidates for a match, with the geometry and the attributes of
+ * the request given to the constructor. The joined source is only read by one thread at a time.
+ *
+ * run() reads the features of the other source by chunks, fetches the candidates of the whole
+ * chunk at once, and tests them with prepared geometries on worker threads, before handing the
+ * results back in the order of the source. The candidates most recently fetched are kept for
+ * the following chunks, which usually share many of them.
+ *
+ * \ingroup analysis
+ * \since QGIS 3.18
+ */
+class ANALYSIS_EXPORT QgsSpatialJoinEngine
+{
+  public:
+
+    /**
+     * Returns TRUE if a \a candidate feature of the joined source matches the feature
+     * whose prepared geometry is \a engine. Called from worker threads.
+     */
+    typedef std::function< bool( QgsGeometryEngine *engine, const QgsFeature &candidate ) > Predicate;
+
+    /**
+     * Returns the output features for a \a feature and the features of the joined source
+     * it \a matches, in the order of their feature IDs. \a engine is the prepared geometry
+     * of the feature, or NULLPTR if it has no candidate. Called from worker threads, so
+     * messages must only be pushed to the given \a feedback.
+     */
+    typedef std::function< QgsFeatureList( const QgsFeature &feature, const QVector< const QgsFeature * > &matches, QgsGeometryEngine *engine, QgsProcessingFeedback *feedback ) > Handler;
+
+    /**
+     * Called from the thread calling run() with the \a results of the handler for each
+     * \a feature, in the order of the iterated source.
+     */
+    typedef std::function< void( const QgsFeature &feature, QgsFeatureList &results ) > Consumer;
+
+    /**
+     * Constructor for QgsSpatialJoinEngine, which indexes the features of the joined \a source
+     * matching \a request. Features without geometry are ignored.
+     *
+     * The \a source must exist for the lifetime of the engine, and candidate features are
+     * fetched from it with the geometry and attributes requested by \a request.
+     *
+     * The number of threads used by run() is taken from the \a context.
+     */
+    QgsSpatialJoinEngine( const QgsFeatureSource &source, const QgsFeatureRequest &request, QgsProcessingContext &context, QgsProcessingFeedback *feedback );
+
+    /**
+     * Returns the number of features indexed from the joined source.
+     */
+    int featureCount() const { return static_cast< int >( mIndex.size() ); }
+
+    /**
+     * Returns the combined bounding box of the features indexed from the joined source.
+     */
+    QgsRectangle extent() const { return mIndex.extent(); }
+
+    /**
+     * Fetches the features of the joined source whose bounding boxes intersect \a rectangle,
+     * in the order of their feature IDs. Thread safe.
+     */
+    QgsFeatureList candidates( const QgsRectangle &rectangle ) const;
+
+    /**
+     * Processes the features returned by \a iterator: for each of them, the candidates
+     * passing the \a predicate are given to the \a handler on a worker thread, and the
+     * results are given to the \a consumer.
+     *
+     * Features without geometry are given to the handler without any match.
+     *
+     * \throws QgsProcessingException if the handler throws an exception.
+     */
+    void run( QgsFeatureIterator &iterator, const Predicate &predicate, const Handler &handler, const Consumer &consumer );
+
+  private:
+
+    //! Returns the sorted IDs of the features whose bounding boxes intersect \a rectangle
+    QVector< QgsFeatureId > candidateIds( const QgsRectangle &rectangle ) const;
+
+    //! Fetches the features with the given \a ids from the joined source
+    QHash< QgsFeatureId, QgsFeature > fetch( const QgsFeatureIds &ids ) const;
+
+    QgsProcessingFeedback *mFeedback = nullptr;
+    int mThreads = 1;
+
+    const QgsFeatureSource &mSource;
+    QgsFeatureRequest mRequest;
+    QgsPackedSpatialIndex mIndex;
+
+    //! Serializes the reads of the joined source
+    mutable QMutex mSourceMutex;
+};
+
+///@endcond PRIVATE
+
+#endif // QGSSPATIALJOINENGINE_H
@@ -0,0 +1,39 @@
+/***************************************************************************
+  qgsthreadlocalproperty.cpp
+  --------------------------
+  Date                 : October 2026
+  Copyright            : (C) 2026 by QGIS contributors
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qgsthreadlocalproperty.h"
+
+///@cond PRIVATE
+
+void QgsThreadLocalProperty::setProperty( const QgsProperty &property )
+{
+  QMutexLocker locker( &mMutex );
+  mDefinition = property.toVariant();
+  mCopies.clear();
+}
+
+const QgsProperty &QgsThreadLocalProperty::property() const
+{
+  QMutexLocker locker( &mMutex );
+  std::unique_ptr< QgsProperty > &copy = mCopies[ QThread::currentThreadId() ];
+  if ( !copy )
+  {
+    // copies of a QgsProperty share their expression, so the copy is made from its definition
+    copy = qgis::make_unique< QgsProperty >();
+    copy->loadVariant( mDefinition );
+  }
+  return *copy;
+}
+
+///@endcond
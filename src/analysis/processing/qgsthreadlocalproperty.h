@@ -0,0 +1,67 @@
+/***************************************************************************
+  qgsthreadlocalproperty.h
+  ------------------------
+  Date                 : October 2026
+  Copyright            : (C) 2026 by QGIS contributors
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef QGSTHREADLOCALPROPERTY_H
+#define QGSTHREADLOCALPROPERTY_H
+
+#define SIP_NO_FILE
+
+#include "qgis_analysis.h"
+#include "qgsproperty.h"
+
+#include <map>
+#include <memory>
+#include <QMutex>
+#include <QThread>
+#include <QVariant>
+
+///@cond PRIVATE
+
+/**
+ * A data defined property evaluated from several threads.
+ *
+ * The prepared expression of a QgsProperty can't be evaluated by several threads at
+ * the same time, so each thread evaluates its own copy of the property, created the
+ * first time the thread asks for it. This lets algorithms with the
+ * QgsProcessingAlgorithm::FlagSupportsParallelFeatureProcessing flag evaluate
+ * data defined parameters in processFeature().
+ *
+ * \ingroup analysis
+ * \since QGIS 3.18
+ */
+class ANALYSIS_EXPORT QgsThreadLocalProperty
+{
+  public:
+
+    QgsThreadLocalProperty() = default;
+
+    /**
+     * Sets the \a property evaluated by the threads, and drops the copies of the
+     * previous one. Must not be called while the property is being evaluated.
+     */
+    void setProperty( const QgsProperty &property );
+
+    //! Returns the copy of the property which belongs to the calling thread
+    const QgsProperty &property() const;
+
+  private:
+
+    QVariant mDefinition;
+    mutable QMutex mMutex;
+    mutable std::map< Qt::HANDLE, std::unique_ptr< QgsProperty > > mCopies;
+};
+
+///@endcond
+
+#endif // QGSTHREADLOCALPROPERTY_H
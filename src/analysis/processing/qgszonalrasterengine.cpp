@@ -0,0 +1,605 @@
+/***************************************************************************
+  qgszonalrasterengine.cpp
+  ------------------------
+  Date                 : October 2026
+  Copyright            : (C) 2026 by QGIS contributors
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qgszonalrasterengine.h"
+#include "qgsfeedback.h"
+#include "qgsgeometry.h"
+#include "qgsgeometrycollection.h"
+#include "qgslinestring.h"
+#include "qgspolygon.h"
+#include "qgsrasterblock.h"
+#include "qgsrasterinterface.h"
+#include "qgsrasteranalysisutils.h"
+
+#include <QThreadPool>
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+///@cond PRIVATE
+
+//! Size of the square tiles read from the raster, in cells
+static const int TILE_SIZE = 128;
+
+//! Maximum number of tiles kept in the cache
+static const int MAXIMUM_CACHED_TILES = 256;
+
+//! Coverages closer than this to 0 or 1 are considered as rounding errors
+static const double COVERAGE_EPSILON = 1e-9;
+
+/**
+ * A ring of a zone, with its vertices and the sign of its contribution to the zone's area.
+ */
+struct QgsZonalRing
+{
+  QVector< double > x;
+  QVector< double > y;
+  double factor = 1;
+};
+
+/**
+ * Accumulates the values of the cells of a zone.
+ *
+ * Cells partially covered by the zone only count for their coverage in the count and the sum.
+ */
+class QgsZonalFeatureStats
+{
+  public:
+    QgsZonalFeatureStats( bool storeValues = false, bool storeValueCounts = false )
+      : mStoreValues( storeValues )
+      , mStoreValueCounts( storeValueCounts )
+    {
+    }
+
+    void addValue( double value, double weight = 1.0 )
+    {
+      if ( weight < 1.0 )
+      {
+        sum += value * weight;
+        count += weight;
+      }
+      else
+      {
+        sum += value;
+        ++count;
+      }
+      min = std::min( min, value );
+      max = std::max( max, value );
+      if ( mStoreValueCounts )
+        valueCount.insert( value, valueCount.value( value, 0 ) + 1 );
+      if ( mStoreValues )
+        values.append( value );
+    }
+
+    double sum = 0.0;
+    double count = 0.0;
+    double max = std::numeric_limits<double>::lowest();
+    double min = std::numeric_limits<double>::max();
+    QMap< double, int > valueCount;
+    QList< double > values;
+
+  private:
+    bool mStoreValues = false;
+    bool mStoreValueCounts = false;
+};
+
+static void addPolygonRings( const QgsPolygon *polygon, QVector< QgsZonalRing > &rings )
+{
+  if ( !polygon )
+    return;
+
+  for ( int i = 0; i < polygon->numInteriorRings() + 1; ++i )
+  {
+    const QgsLineString *line = qgsgeometry_cast< const QgsLineString * >( i == 0 ? polygon->exteriorRing() : polygon->interiorRing( i - 1 ) );
+    if ( !line || line->numPoints() < 3 )
+      continue;
+
+    const int n = line->numPoints();
+    QgsZonalRing ring;
+    ring.x = QVector< double >( n );
+    ring.y = QVector< double >( n );
+    std::copy( line->xData(), line->xData() + n, ring.x.begin() );
+    std::copy( line->yData(), line->yData() + n, ring.y.begin() );
+
+    // shoelace formula, the orientation of the rings in the geometry can't be trusted
+    double signedArea = 0;
+    for ( int j = 0; j < n; ++j )
+    {
+      const int k = ( j + 1 ) % n;
+      signedArea += ring.x.at( j ) * ring.y.at( k ) - ring.x.at( k ) * ring.y.at( j );
+    }
+    if ( signedArea == 0 )
+      continue;
+
+    // exterior rings add their area, interior rings remove it
+    ring.factor = ( i == 0 ) == ( signedArea > 0 ) ? 1 : -1;
+    rings << ring;
+  }
+}
+
+static QVector< QgsZonalRing > zoneRings( const QgsGeometry &zone )
+{
+  QVector< QgsZonalRing > rings;
+
+  const QgsAbstractGeometry *geometry = zone.constGet();
+  std::unique_ptr< QgsAbstractGeometry > segmentized;
+  if ( QgsWkbTypes::isCurvedType( geometry->wkbType() ) )
+  {
+    segmentized.reset( geometry->segmentize() );
+    geometry = segmentized.get();
+  }
+
+  if ( const QgsGeometryCollection *collection = qgsgeometry_cast< const QgsGeometryCollection * >( geometry ) )
+  {
+    for ( int i = 0; i < collection->numGeometries(); ++i )
+      addPolygonRings( qgsgeometry_cast< const QgsPolygon * >( collection->geometryN( i ) ), rings );
+  }
+  else
+  {
+    addPolygonRings( qgsgeometry_cast< const QgsPolygon * >( geometry ), rings );
+  }
+  return rings;
+}
+
+/**
+ * Rasterizes zone rings on a grid of \a columns by \a rows cells, whose top left corner is at \a left, \a top.
+ *
+ * The area of a cell covered by the zone is the integral of the area to the right of the boundary of the
+ * zone (Green's theorem): each piece of edge contained in a cell contributes the area between the piece
+ * and the left side of the cell, plus the full width of the cell for all the cells to its left in the row.
+ *
+ * The center of a cell is inside the zone if a horizontal ray starting from it crosses the boundary an odd
+ * number of times. Centers lying on the boundary are considered outside, like GEOS contains() would.
+ */
+static void rasterizeRings( const QVector< QgsZonalRing > &rings, double left, double top, double cellSizeX, double cellSizeY,
+                            int columns, int rows, QVector< double > &coverage, QVector< bool > &centers )
+{
+  coverage.fill( 0, columns * rows );
+  centers.fill( false, columns * rows );
+
+  // contributions applying to the cell and all the cells to its left
+  QVector< double > fullCells( columns * rows, 0 );
+  QVector< QVector< double > > crossings( rows );
+  QVector< QVector< QPair< double, double > > > horizontalBoundaries( rows );
+
+  const double bottom = top - rows * cellSizeY;
+
+  auto addSubPiece = [&]( double *rowArea, double *rowFull, double u, double v, double dy )
+  {
+    const double mid = ( u + v ) / 2;
+    const int column = static_cast< int >( std::floor( ( mid - left ) / cellSizeX ) );
+    if ( column < 0 )
+      return;
+    if ( column >= columns )
+    {
+      rowFull[ columns - 1 ] += cellSizeX * dy;
+      return;
+    }
+    rowArea[ column ] += ( mid - ( left + column * cellSizeX ) ) * dy;
+    if ( column > 0 )
+      rowFull[ column - 1 ] += cellSizeX * dy;
+  };
+
+  // adds a piece of edge contained in a row, split at the boundaries of the columns it crosses
+  auto addPiece = [&]( int row, double xa, double xb, double dy )
+  {
+    double *rowArea = coverage.data() + row * columns;
+    double *rowFull = fullCells.data() + row * columns;
+    if ( xa == xb )
+    {
+      addSubPiece( rowArea, rowFull, xa, xb, dy );
+      return;
+    }
+
+    const double low = std::min( xa, xb );
+    const double high = std::max( xa, xb );
+    const int firstBoundary = std::max( 0, static_cast< int >( std::floor( ( low - left ) / cellSizeX ) ) + 1 );
+    const int lastBoundary = std::min( columns, static_cast< int >( std::ceil( ( high - left ) / cellSizeX ) ) - 1 );
+
+    const double dx = xb - xa;
+    double previous = xa;
+    if ( xb > xa )
+    {
+      for ( int boundary = firstBoundary; boundary <= lastBoundary; ++boundary )
+      {
+        const double x = left + boundary * cellSizeX;
+        addSubPiece( rowArea, rowFull, previous, x, dy * ( x - previous ) / dx );
+        previous = x;
+      }
+    }
+    else
+    {
+      for ( int boundary = lastBoundary; boundary >= firstBoundary; --boundary )
+      {
+        const double x = left + boundary * cellSizeX;
+        addSubPiece( rowArea, rowFull, previous, x, dy * ( x - previous ) / dx );
+        previous = x;
+      }
+    }
+    addSubPiece( rowArea, rowFull, previous, xb, dy * ( xb - previous ) / dx );
+  };
+
+  for ( const QgsZonalRing &ring : rings )
+  {
+    const int n = ring.x.size();
+    const double *x = ring.x.constData();
+    const double *y = ring.y.constData();
+    for ( int i = 0; i < n; ++i )
+    {
+      const int j = ( i + 1 ) % n;
+      const double x1 = x[ i ];
+      const double y1 = y[ i ];
+      const double x2 = x[ j ];
+      const double y2 = y[ j ];
+
+      if ( y1 == y2 )
+      {
+        // horizontal edges don't cover any area, but cell centers may lie on them
+        const int row = static_cast< int >( std::round( ( top - y1 ) / cellSizeY - 0.5 ) );
+        if ( row >= 0 && row < rows && top - ( row + 0.5 ) * cellSizeY == y1 )
+          horizontalBoundaries[ row ] << qMakePair( std::min( x1, x2 ), std::max( x1, x2 ) );
+        continue;
+      }
+
+      const double yMin = std::min( y1, y2 );
+      const double yMax = std::max( y1, y2 );
+      if ( yMax <= bottom || yMin >= top )
+        continue;
+
+      const int firstRow = std::max( 0, static_cast< int >( std::floor( ( top - yMax ) / cellSizeY ) ) );
+      const int lastRow = std::min( rows - 1, static_cast< int >( std::floor( ( top - yMin ) / cellSizeY ) ) );
+      const double dxdy = ( x2 - x1 ) / ( y2 - y1 );
+      for ( int row = firstRow; row <= lastRow; ++row )
+      {
+        const double rowTop = top - row * cellSizeY;
+        const double rowBottom = rowTop - cellSizeY;
+
+        // part of the edge within the row, in the direction of the edge
+        const double ya = qBound( rowBottom, y1, rowTop );
+        const double yb = qBound( rowBottom, y2, rowTop );
+        if ( ya != yb )
+          addPiece( row, x1 + ( ya - y1 ) * dxdy, x1 + ( yb - y1 ) * dxdy, ( yb - ya ) * ring.factor );
+
+        const double centerY = rowTop - 0.5 * cellSizeY;
+        if ( ( y1 > centerY ) != ( y2 > centerY ) )
+          crossings[ row ] << x1 + ( centerY - y1 ) * dxdy;
+      }
+    }
+  }
+
+  const double cellArea = cellSizeX * cellSizeY;
+  for ( int row = 0; row < rows; ++row )
+  {
+    double *rowArea = coverage.data() + row * columns;
+    const double *rowFull = fullCells.constData() + row * columns;
+    double full = 0;
+    for ( int column = columns - 1; column >= 0; --column )
+    {
+      full += rowFull[ column ];
+      double fraction = ( rowArea[ column ] + full ) / cellArea;
+      if ( fraction < COVERAGE_EPSILON )
+        fraction = 0;
+      else if ( fraction > 1 - COVERAGE_EPSILON )
+        fraction = 1;
+      rowArea[ column ] = fraction;
+    }
+
+    QVector< double > &rowCrossings = crossings[ row ];
+    if ( rowCrossings.isEmpty() )
+      continue;
+
+    std::sort( rowCrossings.begin(), rowCrossings.end() );
+    const QVector< QPair< double, double > > &rowBoundaries = horizontalBoundaries.at( row );
+    bool *rowCenters = centers.data() + row * columns;
+    int crossed = 0;
+    for ( int column = 0; column < columns; ++column )
+    {
+      const double centerX = left + ( column + 0.5 ) * cellSizeX;
+      while ( crossed < rowCrossings.size() && rowCrossings.at( crossed ) < centerX )
+        ++crossed;
+
+      if ( crossed % 2 == 0 )
+        continue;
+      if ( crossed < rowCrossings.size() && rowCrossings.at( crossed ) == centerX )
+        continue;
+
+      bool onBoundary = false;
+      for ( const QPair< double, double > &boundary : rowBoundaries )
+      {
+        if ( centerX >= boundary.first && centerX <= boundary.second )
+        {
+          onBoundary = true;
+          break;
+        }
+      }
+      rowCenters[ column ] = !onBoundary;
+    }
+  }
+}
+
+QgsZonalRasterEngine::QgsZonalRasterEngine( QgsRasterInterface *rasterInterface, int rasterBand, double cellSizeX, double cellSizeY )
+  : mRasterInterface( rasterInterface )
+  , mRasterBand( rasterBand )
+  , mCellSizeX( std::fabs( cellSizeX ) )
+  , mCellSizeY( std::fabs( cellSizeY ) )
+{
+  if ( mRasterInterface )
+  {
+    mExtent = mRasterInterface->extent();
+    mWidth = mRasterInterface->xSize();
+    mHeight = mRasterInterface->ySize();
+    mTileColumns = ( mWidth + TILE_SIZE - 1 ) / TILE_SIZE;
+  }
+}
+
+QgsZonalRasterEngine::~QgsZonalRasterEngine() = default;
+
+std::shared_ptr< const QgsRasterBlock > QgsZonalRasterEngine::tile( int tileColumn, int tileRow ) const
+{
+  QMutexLocker locker( &mMutex );
+
+  const qint64 key = static_cast< qint64 >( tileRow ) * mTileColumns + tileColumn;
+  auto it = mTiles.find( key );
+  if ( it != mTiles.end() )
+  {
+    it->lastUse = ++mUseCounter;
+    return it->block;
+  }
+
+  if ( mTiles.size() >= MAXIMUM_CACHED_TILES )
+  {
+    auto leastRecentlyUsed = mTiles.begin();
+    for ( auto candidate = mTiles.begin(); candidate != mTiles.end(); ++candidate )
+    {
+      if ( candidate->lastUse < leastRecentlyUsed->lastUse )
+        leastRecentlyUsed = candidate;
+    }
+    mTiles.erase( leastRecentlyUsed );
+  }
+
+  const int firstColumn = tileColumn * TILE_SIZE;
+  const int firstRow = tileRow * TILE_SIZE;
+  const int columns = std::min( TILE_SIZE, mWidth - firstColumn );
+  const int rows = std::min( TILE_SIZE, mHeight - firstRow );
+  const QgsRectangle extent( mExtent.xMinimum() + firstColumn * mCellSizeX,
+                             mExtent.yMaximum() - ( firstRow + rows ) * mCellSizeY,
+                             mExtent.xMinimum() + ( firstColumn + columns ) * mCellSizeX,
+                             mExtent.yMaximum() - firstRow * mCellSizeY );
+
+  CachedTile cached;
+  cached.block.reset( mRasterInterface->block( mRasterBand, extent, columns, rows ) );
+  cached.lastUse = ++mUseCounter;
+  mTiles.insert( key, cached );
+  return cached.block;
+}
+
+void QgsZonalRasterEngine::visitCells( const QgsGeometry &zone, const CellVisitor &visitor, bool skipNoData ) const
+{
+  if ( !mRasterInterface || zone.isEmpty() || mWidth <= 0 || mHeight <= 0 )
+    return;
+
+  int nCellsX = 0;
+  int nCellsY = 0;
+  QgsRectangle windowExtent;
+  QgsRasterAnalysisUtils::cellInfoForBBox( mExtent, zone.boundingBox(), mCellSizeX, mCellSizeY, nCellsX, nCellsY, mWidth, mHeight, windowExtent );
+  if ( nCellsX <= 0 || nCellsY <= 0 )
+    return;
+
+  const QVector< QgsZonalRing > rings = zoneRings( zone );
+  if ( rings.isEmpty() )
+    return;
+
+  const int firstColumn = static_cast< int >( std::round( ( windowExtent.xMinimum() - mExtent.xMinimum() ) / mCellSizeX ) );
+  const int firstRow = static_cast< int >( std::round( ( mExtent.yMaximum() - windowExtent.yMaximum() ) / mCellSizeY ) );
+  const int lastColumn = firstColumn + nCellsX - 1;
+  const int lastRow = firstRow + nCellsY - 1;
+  const double left = mExtent.xMinimum() + firstColumn * mCellSizeX;
+
+  // the zone is rasterized one row of tiles at a time, to bound memory use for large zones
+  QVector< double > coverage;
+  QVector< bool > centers;
+  for ( int tileRow = firstRow / TILE_SIZE; tileRow <= lastRow / TILE_SIZE; ++tileRow )
+  {
+    const int bandFirstRow = std::max( firstRow, tileRow * TILE_SIZE );
+    const int bandRows = std::min( lastRow + 1, ( tileRow + 1 ) * TILE_SIZE ) - bandFirstRow;
+    rasterizeRings( rings, left, mExtent.yMaximum() - bandFirstRow * mCellSizeY, mCellSizeX, mCellSizeY, nCellsX, bandRows, coverage, centers );
+
+    for ( int tileColumn = firstColumn / TILE_SIZE; tileColumn <= lastColumn / TILE_SIZE; ++tileColumn )
+    {
+      const int tileFirstColumn = std::max( firstColumn, tileColumn * TILE_SIZE );
+      const int tileLastColumn = std::min( lastColumn, ( tileColumn + 1 ) * TILE_SIZE - 1 );
+
+      std::shared_ptr< const QgsRasterBlock > block;
+      bool tileRead = false;
+      for ( int row = 0; row < bandRows; ++row )
+      {
+        for ( int column = tileFirstColumn; column <= tileLastColumn; ++column )
+        {
+          const int index = row * nCellsX + column - firstColumn;
+          const double cellCoverage = coverage.at( index );
+          const bool centerInside = centers.at( index );
+          if ( cellCoverage <= 0 && !centerInside )
+            continue;
+
+          // only read the tile if the zone covers some of its cells
+          if ( !tileRead )
+          {
+            block = tile( tileColumn, tileRow );
+            tileRead = true;
+          }
+          if ( !block || !block->isValid() )
+            continue;
+
+          bool isNoData = false;
+          const double value = block->valueAndNoData( bandFirstRow + row - tileRow * TILE_SIZE, column - tileColumn * TILE_SIZE, isNoData );
+          if ( QgsRasterAnalysisUtils::validPixel( value ) && ( !skipNoData || !isNoData ) )
+            visitor( value, cellCoverage, centerInside );
+        }
+      }
+    }
+  }
+}
+
+QMap<QgsZonalStatistics::Statistic, QVariant> QgsZonalRasterEngine::statistics( const QgsGeometry &zone, QgsZonalStatistics::Statistics statistics ) const
+{
+  QMap<QgsZonalStatistics::Statistic, QVariant> results;
+
+  if ( !mRasterInterface || zone.isEmpty() )
+    return results;
+
+  const QgsRectangle featureRect = zone.boundingBox().intersect( mExtent );
+  if ( featureRect.isEmpty() )
+    return results;
+
+  bool statsStoreValues = ( statistics & QgsZonalStatistics::Median ) ||
+                          ( statistics & QgsZonalStatistics::StDev ) ||
+                          ( statistics & QgsZonalStatistics::Variance );
+  bool statsStoreValueCount = ( statistics & QgsZonalStatistics::Minority ) ||
+                              ( statistics & QgsZonalStatistics::Majority );
+
+  // the statistics of the cells whose center is inside the zone are used, unless the cell resolution
+  // is probably larger than the zone area, in which case all the covered cells are weighted by their coverage
+  QgsZonalFeatureStats centerStats( statsStoreValues, statsStoreValueCount );
+  QgsZonalFeatureStats coverageStats( statsStoreValues, statsStoreValueCount );
+  visitCells( zone, [&centerStats, &coverageStats]( double value, double coverage, bool centerInside )
+  {
+    if ( centerInside )
+      centerStats.addValue( value );
+    if ( coverage > 0 )
+      coverageStats.addValue( value, coverage );
+  } );
+
+  QgsZonalFeatureStats &featureStats = centerStats.count <= 1 ? coverageStats : centerStats;
+
+  // calculate the statistics
+  if ( statistics & QgsZonalStatistics::Count )
+    results.insert( QgsZonalStatistics::Count, QVariant( featureStats.count ) );
+  if ( statistics & QgsZonalStatistics::Sum )
+    results.insert( QgsZonalStatistics::Sum, QVariant( featureStats.sum ) );
+  if ( featureStats.count > 0 )
+  {
+    double mean = featureStats.sum / featureStats.count;
+    if ( statistics & QgsZonalStatistics::Mean )
+      results.insert( QgsZonalStatistics::Mean, QVariant( mean ) );
+    if ( statistics & QgsZonalStatistics::Median )
+    {
+      std::sort( featureStats.values.begin(), featureStats.values.end() );
+      int size = featureStats.values.count();
+      bool even = ( size % 2 ) < 1;
+      double medianValue;
+      if ( even )
+      {
+        medianValue = ( featureStats.values.at( size / 2 - 1 ) + featureStats.values.at( size / 2 ) ) / 2;
+      }
+      else //odd
+      {
+        medianValue = featureStats.values.at( ( size + 1 ) / 2 - 1 );
+      }
+      results.insert( QgsZonalStatistics::Median, QVariant( medianValue ) );
+    }
+    if ( statistics & QgsZonalStatistics::StDev || statistics & QgsZonalStatistics::Variance )
+    {
+      double sumSquared = 0;
+      for ( int i = 0; i < featureStats.values.count(); ++i )
+      {
+        double diff = featureStats.values.at( i ) - mean;
+        sumSquared += diff * diff;
+      }
+      double variance = sumSquared / featureStats.values.count();
+      if ( statistics & QgsZonalStatistics::StDev )
+      {
+        double stdev = std::pow( variance, 0.5 );
+        results.insert( QgsZonalStatistics::StDev, QVariant( stdev ) );
+      }
+      if ( statistics & QgsZonalStatistics::Variance )
+        results.insert( QgsZonalStatistics::Variance, QVariant( variance ) );
+    }
+    if ( statistics & QgsZonalStatistics::Min )
+      results.insert( QgsZonalStatistics::Min, QVariant( featureStats.min ) );
+    if ( statistics & QgsZonalStatistics::Max )
+      results.insert( QgsZonalStatistics::Max, QVariant( featureStats.max ) );
+    if ( statistics & QgsZonalStatistics::Range )
+      results.insert( QgsZonalStatistics::Range, QVariant( featureStats.max - featureStats.min ) );
+    if ( statistics & QgsZonalStatistics::Minority || statistics & QgsZonalStatistics::Majority )
+    {
+      QList<int> vals = featureStats.valueCount.values();
+      std::sort( vals.begin(), vals.end() );
+      if ( statistics & QgsZonalStatistics::Minority )
+      {
+        double minorityKey = featureStats.valueCount.key( vals.first() );
+        results.insert( QgsZonalStatistics::Minority, QVariant( minorityKey ) );
+      }
+      if ( statistics & QgsZonalStatistics::Majority )
+      {
+        double majKey = featureStats.valueCount.key( vals.last() );
+        results.insert( QgsZonalStatistics::Majority, QVariant( majKey ) );
+      }
+    }
+    if ( statistics & QgsZonalStatistics::Variety )
+      results.insert( QgsZonalStatistics::Variety, QVariant( featureStats.valueCount.count() ) );
+  }
+
+  return results;
+}
+
+QHash< double, qgssize > QgsZonalRasterEngine::histogram( const QgsGeometry &zone ) const
+{
+  QHash< double, qgssize > centerValues;
+  QHash< double, qgssize > coveredValues;
+  visitCells( zone, [&centerValues, &coveredValues]( double value, double coverage, bool centerInside )
+  {
+    if ( centerInside )
+      centerValues[value]++;
+    if ( coverage > 0 )
+      coveredValues[value]++;
+  }, false );
+
+  // the cell resolution is probably larger than the zone area if no cell center is inside the zone
+  return centerValues.isEmpty() ? coveredValues : centerValues;
+}
+
+void QgsZonalRasterEngine::processInParallel( int count, int threads, const std::function< void( int ) > &function, QgsFeedback *feedback )
+{
+  auto processRange = [&function, feedback]( int start, int end )
+  {
+    for ( int i = start; i < end; ++i )
+    {
+      if ( feedback && feedback->isCanceled() )
+        return;
+      function( i );
+    }
+  };
+
+  if ( threads <= 1 || count < 2 )
+  {
+    processRange( 0, count );
+    return;
+  }
+
+  // a few ranges per thread, so that threads finishing early can pick up some more work
+  const int rangeSize = std::max( 1, count / ( 4 * threads ) );
+
+  QThreadPool pool;
+  pool.setMaxThreadCount( threads );
+
+  QList< QFuture< void > > futures;
+  for ( int start = 0; start < count; start += rangeSize )
+    futures << QtConcurrent::run( &pool, processRange, start, std::min( count, start + rangeSize ) );
+  for ( QFuture< void > &future : futures )
+    future.waitForFinished();
+}
+
+///@endcond
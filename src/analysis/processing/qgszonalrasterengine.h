@@ -0,0 +1,142 @@
+/***************************************************************************
+  qgszonalrasterengine.h
+  ----------------------
+  Date                 : October 2026
+  Copyright            : (C) 2026 by QGIS contributors
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef QGSZONALRASTERENGINE_H
+#define QGSZONALRASTERENGINE_H
+
+#define SIP_NO_FILE
+
+#include "qgis_analysis.h"
+#include "qgsrectangle.h"
+#include "vector/qgszonalstatistics.h"
+
+#include <QHash>
+#include <QMap>
+#include <QMutex>
+#include <QVariant>
+#include <functional>
+#include <memory>
+
+class QgsFeedback;
+class QgsGeometry;
+class QgsRasterBlock;
+class QgsRasterInterface;
+
+///@cond PRIVATE
+
+/**
+ * Computes statistics on the cells of a raster band covered by polygon zones.
+ *
+ * Zones are rasterized on the grid of the raster without GEOS, in the spirit of exactextract:
+ * the fraction of each cell covered by a zone is computed exactly from the edges of the zone,
+ * row by row, together with whether the center of the cell lies inside the zone.
+ *
+ * Raster values are read by tiles aligned on the raster grid. The tiles are kept in a cache
+ * shared by all the zones, so that neighbouring zones don't read the same blocks again. The
+ * raster interface is only used by one thread at a time, and all the other methods are thread
+ * safe, so that several zones can be processed at the same time.
+ *
+ * \ingroup analysis
+ * \since QGIS 3.18
+ */
+class ANALYSIS_EXPORT QgsZonalRasterEngine
+{
+  public:
+
+    /**
+     * Called for each cell of the raster covered by a zone, with the \a value of the cell, the
+     * \a coverage of the cell by the zone (between 0 and 1) and whether the center of the cell
+     * is inside the zone.
+     */
+    typedef std::function< void( double value, double coverage, bool centerInside ) > CellVisitor;
+
+    /**
+     * Constructor for QgsZonalRasterEngine, for the band \a rasterBand of \a rasterInterface
+     * whose cells have a size of \a cellSizeX by \a cellSizeY map units.
+     *
+     * The raster interface must exist for the lifetime of the engine.
+     */
+    QgsZonalRasterEngine( QgsRasterInterface *rasterInterface, int rasterBand, double cellSizeX, double cellSizeY );
+
+    ~QgsZonalRasterEngine();
+
+    /**
+     * Calls the \a visitor for each cell covered by \a zone, or whose center is inside \a zone.
+     *
+     * Cells with a NaN value are skipped, as well as no data cells if \a skipNoData is TRUE.
+     * Cells are visited row by row, from the top of the raster. Thread safe.
+     */
+    void visitCells( const QgsGeometry &zone, const CellVisitor &visitor, bool skipNoData = true ) const;
+
+    /**
+     * Calculates the specified \a statistics for the cells whose center is inside \a zone.
+     *
+     * If at most one cell center is inside the zone, the statistics are instead calculated from
+     * all the cells covered by the zone, weighted by their coverage.
+     *
+     * Returns an empty map if the zone is empty or doesn't intersect the raster. Thread safe.
+     */
+    QMap<QgsZonalStatistics::Statistic, QVariant> statistics( const QgsGeometry &zone, QgsZonalStatistics::Statistics statistics ) const;
+
+    /**
+     * Returns the number of cells for each value of the raster, for the cells whose center is
+     * inside \a zone, or for all the cells covered by \a zone when no cell center is inside it.
+     *
+     * Each cell counts once, whatever its coverage: unlike statistics(), the counts are not
+     * weighted by coverage, even for the cells covered by zones without any cell center inside.
+     *
+     * No data cells are counted. Thread safe.
+     */
+    QHash< double, qgssize > histogram( const QgsGeometry &zone ) const;
+
+    /**
+     * Calls \a function for each index from 0 to \a count - 1, using up to \a threads threads.
+     *
+     * Consecutive indices are given to the same thread, so that neighbouring zones share the tiles
+     * they read. Stops early if \a feedback is canceled.
+     */
+    static void processInParallel( int count, int threads, const std::function< void( int index ) > &function, QgsFeedback *feedback = nullptr );
+
+  private:
+
+    struct CachedTile
+    {
+      std::shared_ptr< const QgsRasterBlock > block;
+      quint64 lastUse = 0;
+    };
+
+    //! Returns the tile at \a tileColumn and \a tileRow, reading it if it's not cached
+    std::shared_ptr< const QgsRasterBlock > tile( int tileColumn, int tileRow ) const;
+
+    QgsRasterInterface *mRasterInterface = nullptr;
+    int mRasterBand = 1;
+    double mCellSizeX = 0;
+    double mCellSizeY = 0;
+
+    QgsRectangle mExtent;
+    int mWidth = 0;
+    int mHeight = 0;
+    int mTileColumns = 0;
+
+    //! Protects the raster interface and the tile cache
+    mutable QMutex mMutex;
+    mutable QHash< qint64, CachedTile > mTiles;
+    mutable quint64 mUseCounter = 0;
+
+    Q_DISABLE_COPY( QgsZonalRasterEngine )
+};
+
+///@endcond PRIVATE
+
+#endif // QGSZONALRASTERENGINE_H
@@ -22,13 +22,14 @@
 #include "qgsgeometry.h"
 #include "qgsvectordataprovider.h"
 #include "qgsvectorlayer.h"
-#include "processing/qgsrasteranalysisutils.h"
+#include "processing/qgszonalrasterengine.h"
 #include "qgsrasterdataprovider.h"
 #include "qgsrasterlayer.h"
 #include "qgslogger.h"
 #include "qgsproject.h"
 
 #include <QFile>
+#include <QThreadPool>
 
 QgsZonalStatistics::QgsZonalStatistics( QgsVectorLayer *polygonLayer, QgsRasterLayer *rasterLayer, const QString &attributePrefix, int rasterBand, QgsZonalStatistics::Statistics stats )
   : QgsZonalStatistics( polygonLayer,
@@ -78,6 +79,14 @@ QgsZonalStatistics::Result QgsZonalStatistics::calculateStatistics( QgsFeedback
     return LayerInvalid;
   }
 
+  // the raster blocks are read from the worker threads, so they come from a clone of the
+  // raster interface rather than from a data provider which the main thread may be using
+  const std::unique_ptr< QgsRasterInterface > rasterInterface( mRasterInterface->clone() );
+  if ( !rasterInterface )
+  {
+    return RasterInvalid;
+  }
+
   QMap<QgsZonalStatistics::Statistic, int> statFieldIndexes;
 
   //add the new fields to the provider
@@ -121,34 +130,58 @@ QgsZonalStatistics::Result QgsZonalStatistics::calculateStatistics( QgsFeedback
 
   int featureCounter = 0;
 
+  // features are read by chunks, whose statistics are calculated in parallel
+  const QgsZonalRasterEngine engine( rasterInterface.get(), mRasterBand, mCellSizeX, mCellSizeY );
+  const int threads = std::max( 1, QThreadPool::globalInstance()->maxThreadCount() );
+  const int chunkSize = 64 * threads;
+
   QgsChangedAttributesMap changeMap;
-  while ( fi.nextFeature( feature ) )
+  bool sourceExhausted = false;
+  while ( !sourceExhausted )
   {
-    ++featureCounter;
     if ( feedback && feedback->isCanceled() )
     {
       break;
     }
 
-    if ( feedback )
+    QVector< QgsFeature > features;
+    features.reserve( chunkSize );
+    while ( features.size() < chunkSize )
     {
-      feedback->setProgress( 100.0 * static_cast< double >( featureCounter ) / featureCount );
+      if ( !fi.nextFeature( feature ) )
+      {
+        sourceExhausted = true;
+        break;
+      }
+      features << feature;
     }
 
-    QgsGeometry featureGeometry = feature.geometry();
+    std::vector< QMap<QgsZonalStatistics::Statistic, QVariant> > featuresResults( features.size() );
+    QgsZonalRasterEngine::processInParallel( features.size(), threads, [&engine, &features, &featuresResults, this]( int index )
+    {
+      featuresResults[ index ] = engine.statistics( features.at( index ).geometry(), mStatistics );
+    }, feedback );
+
+    for ( int i = 0; i < features.size(); ++i )
+    {
+      const QMap<QgsZonalStatistics::Statistic, QVariant> &results = featuresResults[ i ];
+      if ( results.empty() )
+        continue;
 
-    QMap<QgsZonalStatistics::Statistic, QVariant> results = calculateStatistics( mRasterInterface, featureGeometry, mCellSizeX, mCellSizeY, mRasterBand, mStatistics );
+      QgsAttributeMap changeAttributeMap;
+      for ( const auto &result : results.toStdMap() )
+      {
+        changeAttributeMap.insert( statFieldIndexes.value( result.first ), result.second );
+      }
 
-    if ( results.empty() )
-      continue;
+      changeMap.insert( features.at( i ).id(), changeAttributeMap );
+    }
 
-    QgsAttributeMap changeAttributeMap;
-    for ( const auto &result : results.toStdMap() )
+    featureCounter += features.size();
+    if ( feedback )
     {
-      changeAttributeMap.insert( statFieldIndexes.value( result.first ), result.second );
+      feedback->setProgress( 100.0 * static_cast< double >( featureCounter ) / featureCount );
     }
-
-    changeMap.insert( feature.id(), changeAttributeMap );
   }
 
   vectorProvider->changeAttributeValues( changeMap );
@@ -289,111 +322,6 @@ QString QgsZonalStatistics::shortName( QgsZonalStatistics::Statistic statistic )
 
 QMap<QgsZonalStatistics::Statistic, QVariant> QgsZonalStatistics::calculateStatistics( QgsRasterInterface *rasterInterface, const QgsGeometry &geometry, double cellSizeX, double cellSizeY, int rasterBand, QgsZonalStatistics::Statistics statistics )
 {
-  QMap<QgsZonalStatistics::Statistic, QVariant> results;
-
-  if ( geometry.isEmpty() )
-    return results;
-
-  QgsRectangle rasterBBox = rasterInterface->extent();
-
-  QgsRectangle featureRect = geometry.boundingBox().intersect( rasterBBox );
-
-  if ( featureRect.isEmpty() )
-    return results;
-
-  bool statsStoreValues = ( statistics & QgsZonalStatistics::Median ) ||
-                          ( statistics & QgsZonalStatistics::StDev ) ||
-                          ( statistics & QgsZonalStatistics::Variance );
-  bool statsStoreValueCount = ( statistics & QgsZonalStatistics::Minority ) ||
-                              ( statistics & QgsZonalStatistics::Majority );
-
-  FeatureStats featureStats( statsStoreValues, statsStoreValueCount );
-
-  int nCellsXProvider = rasterInterface->xSize();
-  int nCellsYProvider = rasterInterface->ySize();
-
-  int nCellsX, nCellsY;
-  QgsRectangle rasterBlockExtent;
-  QgsRasterAnalysisUtils::cellInfoForBBox( rasterBBox, featureRect, cellSizeX, cellSizeY, nCellsX, nCellsY, nCellsXProvider, nCellsYProvider, rasterBlockExtent );
-
-  featureStats.reset();
-  QgsRasterAnalysisUtils::statisticsFromMiddlePointTest( rasterInterface, rasterBand, geometry, nCellsX, nCellsY, cellSizeX, cellSizeY, rasterBlockExtent, [ &featureStats ]( double value ) { featureStats.addValue( value ); } );
-
-  if ( featureStats.count <= 1 )
-  {
-    //the cell resolution is probably larger than the polygon area. We switch to precise pixel - polygon intersection in this case
-    featureStats.reset();
-    QgsRasterAnalysisUtils::statisticsFromPreciseIntersection( rasterInterface, rasterBand, geometry, nCellsX, nCellsY, cellSizeX, cellSizeY, rasterBlockExtent, [ &featureStats ]( double value, double weight ) { featureStats.addValue( value, weight ); } );
-  }
-
-  // calculate the statistics
-  QgsAttributeMap changeAttributeMap;
-  if ( statistics & QgsZonalStatistics::Count )
-    results.insert( QgsZonalStatistics::Count, QVariant( featureStats.count ) );
-  if ( statistics & QgsZonalStatistics::Sum )
-    results.insert( QgsZonalStatistics::Sum, QVariant( featureStats.sum ) );
-  if ( featureStats.count > 0 )
-  {
-    double mean = featureStats.sum / featureStats.count;
-    if ( statistics & QgsZonalStatistics::Mean )
-      results.insert( QgsZonalStatistics::Mean, QVariant( mean ) );
-    if ( statistics & QgsZonalStatistics::Median )
-    {
-      std::sort( featureStats.values.begin(), featureStats.values.end() );
-      int size = featureStats.values.count();
-      bool even = ( size % 2 ) < 1;
-      double medianValue;
-      if ( even )
-      {
-        medianValue = ( featureStats.values.at( size / 2 - 1 ) + featureStats.values.at( size / 2 ) ) / 2;
-      }
-      else //odd
-      {
-        medianValue = featureStats.values.at( ( size + 1 ) / 2 - 1 );
-      }
-      results.insert( QgsZonalStatistics::Median, QVariant( medianValue ) );
-    }
-    if ( statistics & QgsZonalStatistics::StDev || statistics & QgsZonalStatistics::Variance )
-    {
-      double sumSquared = 0;
-      for ( int i = 0; i < featureStats.values.count(); ++i )
-      {
-        double diff = featureStats.values.at( i ) - mean;
-        sumSquared += diff * diff;
-      }
-      double variance = sumSquared / featureStats.values.count();
-      if ( statistics & QgsZonalStatistics::StDev )
-      {
-        double stdev = std::pow( variance, 0.5 );
-        results.insert( QgsZonalStatistics::StDev, QVariant( stdev ) );
-      }
-      if ( statistics & QgsZonalStatistics::Variance )
-        results.insert( QgsZonalStatistics::Variance, QVariant( variance ) );
-    }
-    if ( statistics & QgsZonalStatistics::Min )
-      results.insert( QgsZonalStatistics::Min, QVariant( featureStats.min ) );
-    if ( statistics & QgsZonalStatistics::Max )
-      results.insert( QgsZonalStatistics::Max, QVariant( featureStats.max ) );
-    if ( statistics & QgsZonalStatistics::Range )
-      results.insert( QgsZonalStatistics::Range, QVariant( featureStats.max - featureStats.min ) );
-    if ( statistics & QgsZonalStatistics::Minority || statistics & QgsZonalStatistics::Majority )
-    {
-      QList<int> vals = featureStats.valueCount.values();
-      std::sort( vals.begin(), vals.end() );
-      if ( statistics & QgsZonalStatistics::Minority )
-      {
-        double minorityKey = featureStats.valueCount.key( vals.first() );
-        results.insert( QgsZonalStatistics::Minority, QVariant( minorityKey ) );
-      }
-      if ( statistics & QgsZonalStatistics::Majority )
-      {
-        double majKey = featureStats.valueCount.key( vals.last() );
-        results.insert( QgsZonalStatistics::Majority, QVariant( majKey ) );
-      }
-    }
-    if ( statistics & QgsZonalStatistics::Variety )
-      results.insert( QgsZonalStatistics::Variety, QVariant( featureStats.valueCount.count() ) );
-  }
-
-  return results;
+  const QgsZonalRasterEngine engine( rasterInterface, rasterBand, cellSizeX, cellSizeY );
+  return engine.statistics( geometry, statistics );
 }
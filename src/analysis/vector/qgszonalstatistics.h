@@ -160,56 +160,6 @@ class ANALYSIS_EXPORT QgsZonalStatistics
   private:
     QgsZonalStatistics() = default;
 
-    class FeatureStats
-    {
-      public:
-        FeatureStats( bool storeValues = false, bool storeValueCounts = false )
-          : mStoreValues( storeValues )
-          , mStoreValueCounts( storeValueCounts )
-        {
-        }
-
-        void reset()
-        {
-          sum = 0;
-          count = 0;
-          max = std::numeric_limits<double>::lowest();
-          min = std::numeric_limits<double>::max();
-          valueCount.clear();
-          values.clear();
-        }
-
-        void addValue( double value, double weight = 1.0 )
-        {
-          if ( weight < 1.0 )
-          {
-            sum += value * weight;
-            count += weight;
-          }
-          else
-          {
-            sum += value;
-            ++count;
-          }
-          min = std::min( min, value );
-          max = std::max( max, value );
-          if ( mStoreValueCounts )
-            valueCount.insert( value, valueCount.value( value, 0 ) + 1 );
-          if ( mStoreValues )
-            values.append( value );
-        }
-        double sum = 0.0;
-        double count = 0.0;
-        double max = std::numeric_limits<double>::lowest();
-        double min = std::numeric_limits<double>::max();
-        QMap< double, int > valueCount;
-        QList< double > values;
-
-      private:
-        bool mStoreValues = false;
-        bool mStoreValueCounts = false;
-    };
-
     QString getUniqueFieldName( const QString &fieldName, const QList<QgsField> &newFields );
 
     QgsRasterInterface *mRasterInterface = nullptr;
@@ -24,6 +24,8 @@
 #include "qgsproject.h"
 #include "qgsexpressioncontextutils.h"
 #include "qgsexpression_p.h"
+#include "qgsexpressionbytecode_p.h"
+#include "qgsfeaturebatch.h"
 
 // from parser
 extern QgsExpressionNode *parseExpression( const QString &str, QString &parserErrorMsg, QList<QgsExpression::ParserError> &parserErrors );
@@ -52,6 +54,7 @@ void QgsExpression::setExpression( const QString &expression )
   d->mEvalErrorString = QString();
   d->mExp = expression;
   d->mIsPrepared = false;
+  d->mBytecode.reset();
 }
 
 QString QgsExpression::expression() const
@@ -340,7 +343,13 @@ bool QgsExpression::prepare( const QgsExpressionContext *context )
 
   initGeomCalculator( context );
   d->mIsPrepared = true;
-  return d->mRootNode->prepare( this, context );
+  d->mBytecode.reset();
+  if ( !d->mRootNode->prepare( this, context ) )
+    return false;
+
+  // lower the prepared tree to bytecode where possible, static subtrees are folded into constants
+  d->mBytecode = QgsExpressionBytecode::compile( d->mRootNode, context );
+  return true;
 }
 
 QVariant QgsExpression::evaluate()
@@ -368,9 +377,71 @@ QVariant QgsExpression::evaluate( const QgsExpressionContext *context )
   {
     prepare( context );
   }
+
+  QVariant result;
+  if ( d->mBytecode && d->mBytecode->evaluate( context, result ) )
+    return result;
+
   return d->mRootNode->eval( this, context );
 }
 
+QVector<QVariant> QgsExpression::evaluate( const QgsFeatureBatch &batch, QgsExpressionContext *context )
+{
+  d->mEvalErrorString = QString();
+  QVector< QVariant > results;
+  if ( !d->mRootNode )
+  {
+    d->mEvalErrorString = tr( "No root node! Parsing failed?" );
+    results.resize( batch.size() );
+    return results;
+  }
+
+  if ( ! d->mIsPrepared )
+  {
+    prepare( context );
+  }
+
+  QVector< bool > failed;
+  if ( d->mBytecode )
+  {
+    d->mBytecode->evaluate( batch, results, failed );
+  }
+  else
+  {
+    results.resize( batch.size() );
+    failed.fill( true, batch.size() );
+  }
+
+  // rows the bytecode could not handle are evaluated one by one using the node tree
+  if ( failed.contains( true ) )
+  {
+    QgsExpressionContext localContext;
+    QgsExpressionContext &evalContext = context ? *context : localContext;
+    QgsExpressionContextScope *scope = new QgsExpressionContextScope();
+    QgsExpressionContextScopePopper popper( evalContext, scope );
+    QString firstError;
+    for ( int row = 0; row < batch.size(); ++row )
+    {
+      if ( !failed.at( row ) )
+        continue;
+
+      scope->setFeature( batch.feature( row ) );
+      d->mEvalErrorString = QString();
+      results[row] = d->mRootNode->eval( this, &evalContext );
+      if ( firstError.isNull() && hasEvalError() )
+        firstError = d->mEvalErrorString;
+    }
+    d->mEvalErrorString = firstError;
+  }
+
+  return results;
+}
+
+bool QgsExpression::hasBytecode() const
+{
+  return static_cast< bool >( d->mBytecode );
+}
+
 bool QgsExpression::hasEvalError() const
 {
   return !d->mEvalErrorString.isNull();
@@ -43,6 +43,7 @@ class QDomElement;
 class QgsExpressionContext;
 class QgsExpressionPrivate;
 class QgsExpressionFunction;
+class QgsFeatureBatch;
 
 /**
  * \ingroup core
@@ -318,6 +319,33 @@ class CORE_EXPORT QgsExpression
      */
     QVariant evaluate( const QgsExpressionContext *context );
 
+    /**
+     * Evaluates the expression for every feature of a \a batch and returns one result per row.
+     *
+     * If the expression could be compiled to bytecode during prepare(), it is evaluated
+     * column by column over the whole batch. Rows (or whole expressions) which cannot be
+     * handled by the bytecode are evaluated feature by feature, with the feature set on a
+     * temporary scope appended to \a context.
+     *
+     * If evaluating any row fails, evalErrorString() returns the first error.
+     *
+     * \note prepare() should be called before calling this method.
+     * \note Not available in Python bindings
+     * \since QGIS 3.18
+     */
+    QVector< QVariant > evaluate( const QgsFeatureBatch &batch, QgsExpressionContext *context ) SIP_SKIP;
+
+    /**
+     * Returns TRUE if prepare() was able to compile the expression to bytecode, which
+     * avoids walking the expression tree for every evaluated feature.
+     *
+     * Only expressions built from operators, literals, field references and basic numeric
+     * and string functions can be compiled.
+     *
+     * \since QGIS 3.18
+     */
+    bool hasBytecode() const;
+
     //! Returns TRUE if an error occurred when evaluating last input
     bool hasEvalError() const;
     //! Returns evaluation error
@@ -25,6 +25,8 @@
 #include "qgsunittypes.h"
 #include "qgsexpressionnode.h"
 
+class QgsExpressionBytecode;
+
 ///@cond
 
 /**
@@ -81,6 +83,9 @@ class QgsExpressionPrivate
     //! Whether prepare() has been called before evaluate()
     bool mIsPrepared = false;
 
+    //! Bytecode program compiled by prepare(), or NULLPTR if the expression could not be compiled
+    std::shared_ptr<QgsExpressionBytecode> mBytecode;
+
     QgsExpressionPrivate &operator= ( const QgsExpressionPrivate & ) = delete;
 };
 
@@ -0,0 +1,978 @@
+/***************************************************************************
+                             qgsexpressionbytecode.cpp
+                             -------------------------
+    begin                : October 2026
+    copyright            : (C) 2026 by QGIS contributors
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qgsexpressionbytecode_p.h"
+#include "qgsexpression.h"
+#include "qgsexpressionnodeimpl.h"
+#include "qgsexpressionfunction.h"
+#include "qgsexpressioncontext.h"
+#include "qgsfeaturebatch.h"
+#include "qgsfeature.h"
+#include "qgis.h"
+
+#include <QVarLengthArray>
+#include <cmath>
+
+///@cond PRIVATE
+
+typedef QgsExpressionBytecode::Value Value;
+
+// three valued logic, matching QgsExpressionUtils::TVL
+enum Tvl
+{
+  TvlFalse,
+  TvlTrue,
+  TvlUnknown,
+};
+
+static const Tvl TVL_AND[3][3] =
+{
+  // false     true        unknown
+  { TvlFalse, TvlFalse,   TvlFalse },   // false
+  { TvlFalse, TvlTrue,    TvlUnknown }, // true
+  { TvlFalse, TvlUnknown, TvlUnknown }, // unknown
+};
+
+static const Tvl TVL_OR[3][3] =
+{
+  // false       true      unknown
+  { TvlFalse,   TvlTrue, TvlUnknown }, // false
+  { TvlTrue,    TvlTrue, TvlTrue },    // true
+  { TvlUnknown, TvlTrue, TvlUnknown }, // unknown
+};
+
+static const Tvl TVL_NOT[3] = { TvlTrue, TvlFalse, TvlUnknown };
+
+static inline void setNull( Value &out )
+{
+  out.kind = Value::Null;
+  out.nullType = QVariant::Invalid;
+  out.s.clear();
+}
+
+static inline void setInt( Value &out, int value )
+{
+  out.kind = Value::Int;
+  out.i = value;
+}
+
+static inline void setLongLong( Value &out, qlonglong value )
+{
+  out.kind = Value::LongLong;
+  out.i = value;
+}
+
+static inline void setDouble( Value &out, double value )
+{
+  out.kind = Value::Double;
+  out.d = value;
+}
+
+static inline void setString( Value &out, const QString &value )
+{
+  // a null QString is a NULL value for the expression engine
+  if ( value.isNull() )
+  {
+    out.kind = Value::Null;
+    out.nullType = QVariant::String;
+    out.s.clear();
+  }
+  else
+  {
+    out.kind = Value::String;
+    out.s = value;
+  }
+}
+
+static inline void setTvl( Value &out, Tvl value )
+{
+  switch ( value )
+  {
+    case TvlFalse:
+      setInt( out, 0 );
+      break;
+    case TvlTrue:
+      setInt( out, 1 );
+      break;
+    case TvlUnknown:
+      setNull( out );
+      break;
+  }
+}
+
+static inline bool isInteger( const Value &v )
+{
+  return v.kind == Value::Int || v.kind == Value::LongLong;
+}
+
+static inline bool isNumeric( const Value &v )
+{
+  return v.kind == Value::Int || v.kind == Value::LongLong || v.kind == Value::Double;
+}
+
+static inline bool isStringTyped( const Value &v )
+{
+  return v.kind == Value::String || ( v.kind == Value::Null && v.nullType == QVariant::String );
+}
+
+// matches QgsExpressionUtils::getDoubleValue, which fails for non finite values
+static inline bool toFiniteDouble( const Value &v, double &out )
+{
+  switch ( v.kind )
+  {
+    case Value::Int:
+    case Value::LongLong:
+      out = static_cast< double >( v.i );
+      return true;
+    case Value::Double:
+      out = v.d;
+      return std::isfinite( v.d );
+    case Value::Null:
+    case Value::String:
+      break;
+  }
+  return false;
+}
+
+// matches QgsExpressionUtils::getStringValue for the value types we know how to convert
+static inline bool toStringValue( const Value &v, QString &out )
+{
+  switch ( v.kind )
+  {
+    case Value::String:
+      out = v.s;
+      return true;
+    case Value::Int:
+    case Value::LongLong:
+      out = QString::number( v.i );
+      return true;
+    case Value::Null:
+    case Value::Double:
+      break;
+  }
+  return false;
+}
+
+// matches QgsExpressionUtils::getTVLValue
+static inline bool toTvl( const Value &v, Tvl &out )
+{
+  switch ( v.kind )
+  {
+    case Value::Null:
+      out = TvlUnknown;
+      return true;
+    case Value::Int:
+      out = v.i != 0 ? TvlTrue : TvlFalse;
+      return true;
+    case Value::LongLong:
+      out = !qgsDoubleNear( static_cast< double >( v.i ), 0.0 ) ? TvlTrue : TvlFalse;
+      return true;
+    case Value::Double:
+      out = !qgsDoubleNear( v.d, 0.0 ) ? TvlTrue : TvlFalse;
+      return true;
+    case Value::String:
+      break;
+  }
+  return false;
+}
+
+static bool fromVariant( const QVariant &value, Value &out )
+{
+  if ( value.isNull() )
+  {
+    out.kind = Value::Null;
+    out.nullType = value.type();
+    out.s.clear();
+    return true;
+  }
+
+  switch ( value.type() )
+  {
+    case QVariant::Int:
+      setInt( out, value.toInt() );
+      return true;
+    case QVariant::LongLong:
+      setLongLong( out, value.toLongLong() );
+      return true;
+    case QVariant::Double:
+      setDouble( out, value.toDouble() );
+      return true;
+    case QVariant::String:
+      setString( out, value.toString() );
+      return true;
+    default:
+      return false;
+  }
+}
+
+static QVariant toVariant( const Value &value )
+{
+  switch ( value.kind )
+  {
+    case Value::Null:
+      return QVariant( value.nullType );
+    case Value::Int:
+      return QVariant( static_cast< int >( value.i ) );
+    case Value::LongLong:
+      return QVariant( value.i );
+    case Value::Double:
+      return QVariant( value.d );
+    case Value::String:
+      return QVariant( value.s );
+  }
+  return QVariant();
+}
+
+static inline bool compareDiff( QgsExpressionBytecode::OpCode op, double diff )
+{
+  switch ( op )
+  {
+    case QgsExpressionBytecode::Equal:
+      return qgsDoubleNear( diff, 0.0 );
+    case QgsExpressionBytecode::NotEqual:
+      return !qgsDoubleNear( diff, 0.0 );
+    case QgsExpressionBytecode::LessThan:
+      return diff < 0;
+    case QgsExpressionBytecode::GreaterThan:
+      return diff > 0;
+    case QgsExpressionBytecode::LessOrEqual:
+      return diff <= 0;
+    case QgsExpressionBytecode::GreaterOrEqual:
+      return diff >= 0;
+    default:
+      return false;
+  }
+}
+
+// Binary operators, mirroring QgsExpressionNodeBinaryOperator::evalNode(). Returns FALSE for
+// any case which is not handled here.
+static bool evalBinary( QgsExpressionBytecode::OpCode op, const Value &a, const Value &b, Value &out )
+{
+  switch ( op )
+  {
+    case QgsExpressionBytecode::Add:
+      if ( isStringTyped( a ) && isStringTyped( b ) )
+      {
+        setString( out, a.s + b.s );
+        return true;
+      }
+      FALLTHROUGH
+    case QgsExpressionBytecode::Subtract:
+    case QgsExpressionBytecode::Multiply:
+    case QgsExpressionBytecode::Divide:
+    case QgsExpressionBytecode::Modulo:
+    {
+      if ( a.kind == Value::Null || b.kind == Value::Null )
+      {
+        setNull( out );
+        return true;
+      }
+
+      if ( op != QgsExpressionBytecode::Divide && isInteger( a ) && isInteger( b ) )
+      {
+        switch ( op )
+        {
+          case QgsExpressionBytecode::Add:
+            setLongLong( out, a.i + b.i );
+            break;
+          case QgsExpressionBytecode::Subtract:
+            setLongLong( out, a.i - b.i );
+            break;
+          case QgsExpressionBytecode::Multiply:
+            setLongLong( out, a.i * b.i );
+            break;
+          default:
+            if ( b.i == 0 )
+              setNull( out );
+            else
+              setLongLong( out, a.i % b.i );
+            break;
+        }
+        return true;
+      }
+
+      double fL, fR;
+      if ( !toFiniteDouble( a, fL ) || !toFiniteDouble( b, fR ) )
+        return false;
+
+      switch ( op )
+      {
+        case QgsExpressionBytecode::Add:
+          setDouble( out, fL + fR );
+          break;
+        case QgsExpressionBytecode::Subtract:
+          setDouble( out, fL - fR );
+          break;
+        case QgsExpressionBytecode::Multiply:
+          setDouble( out, fL * fR );
+          break;
+        case QgsExpressionBytecode::Divide:
+          if ( fR == 0. )
+            setNull( out );
+          else
+            setDouble( out, fL / fR );
+          break;
+        default:
+          if ( fR == 0. )
+            setNull( out );
+          else
+            setDouble( out, std::fmod( fL, fR ) );
+          break;
+      }
+      return true;
+    }
+
+    case QgsExpressionBytecode::IntDivide:
+    {
+      double fL, fR;
+      if ( !toFiniteDouble( a, fL ) || !toFiniteDouble( b, fR ) )
+        return false;
+      if ( fR == 0. )
+        setNull( out );
+      else
+        setLongLong( out, static_cast< qlonglong >( std::floor( fL / fR ) ) );
+      return true;
+    }
+
+    case QgsExpressionBytecode::Power:
+    {
+      if ( a.kind == Value::Null || b.kind == Value::Null )
+      {
+        setNull( out );
+        return true;
+      }
+      double fL, fR;
+      if ( !toFiniteDouble( a, fL ) || !toFiniteDouble( b, fR ) )
+        return false;
+      setDouble( out, std::pow( fL, fR ) );
+      return true;
+    }
+
+    case QgsExpressionBytecode::Equal:
+    case QgsExpressionBytecode::NotEqual:
+    case QgsExpressionBytecode::LessThan:
+    case QgsExpressionBytecode::GreaterThan:
+    case QgsExpressionBytecode::LessOrEqual:
+    case QgsExpressionBytecode::GreaterOrEqual:
+    {
+      if ( a.kind == Value::Null || b.kind == Value::Null )
+      {
+        setNull( out );
+        return true;
+      }
+      if ( isNumeric( a ) && isNumeric( b ) )
+      {
+        double fL, fR;
+        if ( !toFiniteDouble( a, fL ) || !toFiniteDouble( b, fR ) )
+          return false;
+        setInt( out, compareDiff( op, fL - fR ) ? 1 : 0 );
+        return true;
+      }
+      if ( a.kind == Value::String && b.kind == Value::String )
+      {
+        setInt( out, compareDiff( op, QString::compare( a.s, b.s ) ) ? 1 : 0 );
+        return true;
+      }
+      // mixed strings and numbers need the string to number conversion rules
+      return false;
+    }
+
+    case QgsExpressionBytecode::Is:
+    case QgsExpressionBytecode::IsNot:
+    {
+      bool equal = false;
+      if ( a.kind == Value::Null && b.kind == Value::Null )
+        equal = true;
+      else if ( a.kind == Value::Null || b.kind == Value::Null )
+        equal = false;
+      else if ( isNumeric( a ) && isNumeric( b ) )
+      {
+        double fL, fR;
+        if ( !toFiniteDouble( a, fL ) || !toFiniteDouble( b, fR ) )
+          return false;
+        equal = qgsDoubleNear( fL, fR );
+      }
+      else if ( a.kind == Value::String && b.kind == Value::String )
+        equal = QString::compare( a.s, b.s ) == 0;
+      else
+        return false;
+
+      setInt( out, equal == ( op == QgsExpressionBytecode::Is ) ? 1 : 0 );
+      return true;
+    }
+
+    case QgsExpressionBytecode::And:
+    case QgsExpressionBytecode::Or:
+    {
+      Tvl tvlL, tvlR;
+      if ( !toTvl( a, tvlL ) || !toTvl( b, tvlR ) )
+        return false;
+      setTvl( out, op == QgsExpressionBytecode::And ? TVL_AND[tvlL][tvlR] : TVL_OR[tvlL][tvlR] );
+      return true;
+    }
+
+    case QgsExpressionBytecode::ConcatOperator:
+    {
+      if ( a.kind == Value::Null || b.kind == Value::Null )
+      {
+        setNull( out );
+        return true;
+      }
+      QString sL, sR;
+      if ( !toStringValue( a, sL ) || !toStringValue( b, sR ) )
+        return false;
+      setString( out, sL + sR );
+      return true;
+    }
+
+    default:
+      break;
+  }
+  return false;
+}
+
+// Unary operators and single argument functions
+static bool evalUnary( QgsExpressionBytecode::OpCode op, const Value &a, Value &out )
+{
+  switch ( op )
+  {
+    case QgsExpressionBytecode::Not:
+    {
+      Tvl tvl;
+      if ( !toTvl( a, tvl ) )
+        return false;
+      setTvl( out, TVL_NOT[tvl] );
+      return true;
+    }
+
+    case QgsExpressionBytecode::Negate:
+      if ( isInteger( a ) )
+      {
+        setLongLong( out, -a.i );
+        return true;
+      }
+      else if ( a.kind == Value::Double && std::isfinite( a.d ) )
+      {
+        setDouble( out, -a.d );
+        return true;
+      }
+      return false;
+
+    default:
+      break;
+  }
+
+  // functions return NULL for NULL arguments
+  if ( a.kind == Value::Null )
+  {
+    setNull( out );
+    return true;
+  }
+
+  switch ( op )
+  {
+    case QgsExpressionBytecode::Upper:
+    case QgsExpressionBytecode::Lower:
+    case QgsExpressionBytecode::Trim:
+    case QgsExpressionBytecode::Length:
+    {
+      QString str;
+      if ( !toStringValue( a, str ) )
+        return false;
+      if ( op == QgsExpressionBytecode::Upper )
+        setString( out, str.toUpper() );
+      else if ( op == QgsExpressionBytecode::Lower )
+        setString( out, str.toLower() );
+      else if ( op == QgsExpressionBytecode::Trim )
+        setString( out, str.trimmed() );
+      else
+        setInt( out, str.length() );
+      return true;
+    }
+
+    case QgsExpressionBytecode::Abs:
+    case QgsExpressionBytecode::Sqrt:
+    case QgsExpressionBytecode::Floor:
+    case QgsExpressionBytecode::Ceil:
+    {
+      double x;
+      if ( !toFiniteDouble( a, x ) )
+        return false;
+      if ( op == QgsExpressionBytecode::Abs )
+        setDouble( out, std::fabs( x ) );
+      else if ( op == QgsExpressionBytecode::Sqrt )
+        setDouble( out, std::sqrt( x ) );
+      else if ( op == QgsExpressionBytecode::Floor )
+        setDouble( out, std::floor( x ) );
+      else
+        setDouble( out, std::ceil( x ) );
+      return true;
+    }
+
+    default:
+      break;
+  }
+  return false;
+}
+
+// Functions with a variable number of arguments, which handle NULL arguments themselves
+static bool evalVariadic( QgsExpressionBytecode::OpCode op, const Value *const *args, int count, Value &out )
+{
+  switch ( op )
+  {
+    case QgsExpressionBytecode::ConcatFunction:
+    {
+      QString concat;
+      for ( int i = 0; i < count; ++i )
+      {
+        if ( args[i]->kind == Value::Null )
+          continue;
+        QString str;
+        if ( !toStringValue( *args[i], str ) )
+          return false;
+        concat += str;
+      }
+      setString( out, concat );
+      return true;
+    }
+
+    case QgsExpressionBytecode::Coalesce:
+      for ( int i = 0; i < count; ++i )
+      {
+        if ( args[i]->kind != Value::Null )
+        {
+          out = *args[i];
+          return true;
+        }
+      }
+      setNull( out );
+      return true;
+
+    default:
+      break;
+  }
+  return false;
+}
+
+static bool isVariadic( QgsExpressionBytecode::OpCode op )
+{
+  return op == QgsExpressionBytecode::ConcatFunction || op == QgsExpressionBytecode::Coalesce;
+}
+
+static bool isUnary( QgsExpressionBytecode::OpCode op )
+{
+  return op >= QgsExpressionBytecode::Not && op <= QgsExpressionBytecode::Ceil;
+}
+
+///@endcond
+
+std::unique_ptr<QgsExpressionBytecode> QgsExpressionBytecode::compile( const QgsExpressionNode *root, const QgsExpressionContext *context )
+{
+  if ( !root )
+    return nullptr;
+
+  std::unique_ptr< QgsExpressionBytecode > program( new QgsExpressionBytecode() );
+  if ( !program->compileNode( root, context, 0 ) )
+    return nullptr;
+
+  return program;
+}
+
+void QgsExpressionBytecode::addInstruction( OpCode op, int dest, int a, int b )
+{
+  Instruction instruction;
+  instruction.op = op;
+  instruction.dest = dest;
+  instruction.a = a;
+  instruction.b = b;
+  mInstructions << instruction;
+  mRegisterCount = std::max( mRegisterCount, dest + 1 );
+}
+
+bool QgsExpressionBytecode::emitConstant( const QVariant &value, int reg )
+{
+  Value constant;
+  if ( !fromVariant( value, constant ) )
+    return false;
+
+  mConstants << constant;
+  addInstruction( LoadConstant, reg, mConstants.size() - 1 );
+  return true;
+}
+
+bool QgsExpressionBytecode::compileNode( const QgsExpressionNode *node, const QgsExpressionContext *context, int reg )
+{
+  // constant folding: static subtrees have already been evaluated by QgsExpressionNode::prepare()
+  if ( node->hasCachedStaticValue() )
+    return emitConstant( node->cachedStaticValue(), reg );
+
+  switch ( node->nodeType() )
+  {
+    case QgsExpressionNode::ntLiteral:
+      return emitConstant( static_cast< const QgsExpressionNodeLiteral * >( node )->value(), reg );
+
+    case QgsExpressionNode::ntColumnRef:
+    {
+      // resolve the field index the same way QgsExpressionNodeColumnRef::prepareNode() does
+      const QString name = static_cast< const QgsExpressionNodeColumnRef * >( node )->name();
+      if ( !context || !context->hasVariable( QgsExpressionContext::EXPR_FIELDS ) )
+        return false;
+
+      const QgsFields fields = qvariant_cast<QgsFields>( context->variable( QgsExpressionContext::EXPR_FIELDS ) );
+      int index = fields.lookupField( name );
+      if ( index == -1 && context->hasFeature() )
+        index = context->feature().fieldNameIndex( name );
+      if ( index == -1 )
+        return false;
+
+      addInstruction( LoadAttribute, reg, index );
+      return true;
+    }
+
+    case QgsExpressionNode::ntUnaryOperator:
+    {
+      const QgsExpressionNodeUnaryOperator *unary = static_cast< const QgsExpressionNodeUnaryOperator * >( node );
+      if ( !compileNode( unary->operand(), context, reg ) )
+        return false;
+      addInstruction( unary->op() == QgsExpressionNodeUnaryOperator::uoNot ? Not : Negate, reg, reg );
+      return true;
+    }
+
+    case QgsExpressionNode::ntBinaryOperator:
+    {
+      const QgsExpressionNodeBinaryOperator *binary = static_cast< const QgsExpressionNodeBinaryOperator * >( node );
+      OpCode op;
+      switch ( binary->op() )
+      {
+        case QgsExpressionNodeBinaryOperator::boOr:
+          op = Or;
+          break;
+        case QgsExpressionNodeBinaryOperator::boAnd:
+          op = And;
+          break;
+        case QgsExpressionNodeBinaryOperator::boEQ:
+          op = Equal;
+          break;
+        case QgsExpressionNodeBinaryOperator::boNE:
+          op = NotEqual;
+          break;
+        case QgsExpressionNodeBinaryOperator::boLE:
+          op = LessOrEqual;
+          break;
+        case QgsExpressionNodeBinaryOperator::boGE:
+          op = GreaterOrEqual;
+          break;
+        case QgsExpressionNodeBinaryOperator::boLT:
+          op = LessThan;
+          break;
+        case QgsExpressionNodeBinaryOperator::boGT:
+          op = GreaterThan;
+          break;
+        case QgsExpressionNodeBinaryOperator::boIs:
+          op = Is;
+          break;
+        case QgsExpressionNodeBinaryOperator::boIsNot:
+          op = IsNot;
+          break;
+        case QgsExpressionNodeBinaryOperator::boPlus:
+          op = Add;
+          break;
+        case QgsExpressionNodeBinaryOperator::boMinus:
+          op = Subtract;
+          break;
+        case QgsExpressionNodeBinaryOperator::boMul:
+          op = Multiply;
+          break;
+        case QgsExpressionNodeBinaryOperator::boDiv:
+          op = Divide;
+          break;
+        case QgsExpressionNodeBinaryOperator::boIntDiv:
+          op = IntDivide;
+          break;
+        case QgsExpressionNodeBinaryOperator::boMod:
+          op = Modulo;
+          break;
+        case QgsExpressionNodeBinaryOperator::boPow:
+          op = Power;
+          break;
+        case QgsExpressionNodeBinaryOperator::boConcat:
+          op = ConcatOperator;
+          break;
+        default:
+          // LIKE, ILIKE and regular expressions
+          return false;
+      }
+
+      if ( !compileNode( binary->opLeft(), context, reg ) || !compileNode( binary->opRight(), context, reg + 1 ) )
+        return false;
+      addInstruction( op, reg, reg, reg + 1 );
+      return true;
+    }
+
+    case QgsExpressionNode::ntFunction:
+    {
+      const QgsExpressionNodeFunction *function = static_cast< const QgsExpressionNodeFunction * >( node );
+      const QString name = QgsExpression::Functions()[ function->fnIndex() ]->name();
+
+      // functions can be overridden by the context
+      if ( context && context->hasFunction( name ) )
+        return false;
+
+      OpCode op;
+      if ( name == QLatin1String( "upper" ) )
+        op = Upper;
+      else if ( name == QLatin1String( "lower" ) )
+        op = Lower;
+      else if ( name == QLatin1String( "trim" ) )
+        op = Trim;
+      else if ( name == QLatin1String( "length" ) )
+        op = Length;
+      else if ( name == QLatin1String( "abs" ) )
+        op = Abs;
+      else if ( name == QLatin1String( "sqrt" ) )
+        op = Sqrt;
+      else if ( name == QLatin1String( "floor" ) )
+        op = Floor;
+      else if ( name == QLatin1String( "ceil" ) )
+        op = Ceil;
+      else if ( name == QLatin1String( "concat" ) )
+        op = ConcatFunction;
+      else if ( name == QLatin1String( "coalesce" ) )
+        op = Coalesce;
+      else
+        return false;
+
+      const QList< QgsExpressionNode * > args = function->args() ? function->args()->list() : QList< QgsExpressionNode * >();
+      if ( !isVariadic( op ) && args.size() != 1 )
+        return false;
+
+      for ( int i = 0; i < args.size(); ++i )
+      {
+        if ( !compileNode( args.at( i ), context, reg + i ) )
+          return false;
+      }
+      addInstruction( op, reg, reg, args.size() );
+      return true;
+    }
+
+    case QgsExpressionNode::ntInOperator:
+    case QgsExpressionNode::ntCondition:
+    case QgsExpressionNode::ntIndexOperator:
+      break;
+  }
+
+  return false;
+}
+
+bool QgsExpressionBytecode::evaluate( const QgsExpressionContext *context, QVariant &result ) const
+{
+  QgsFeature feature;
+  bool hasFeature = false;
+
+  QVarLengthArray< Value, 16 > registers( mRegisterCount );
+  QVarLengthArray< const Value *, 8 > args;
+
+  for ( const Instruction &instruction : mInstructions )
+  {
+    Value &dest = registers[ instruction.dest ];
+    switch ( instruction.op )
+    {
+      case LoadConstant:
+        dest = mConstants.at( instruction.a );
+        break;
+
+      case LoadAttribute:
+        if ( !hasFeature )
+        {
+          if ( !context )
+            return false;
+          feature = context->feature();
+          if ( !feature.isValid() )
+            return false;
+          hasFeature = true;
+        }
+        if ( !fromVariant( feature.attribute( instruction.a ), dest ) )
+          return false;
+        break;
+
+      default:
+        if ( isVariadic( instruction.op ) )
+        {
+          args.resize( instruction.b );
+          for ( int i = 0; i < instruction.b; ++i )
+            args[i] = &registers[ instruction.a + i ];
+          if ( !evalVariadic( instruction.op, args.constData(), instruction.b, dest ) )
+            return false;
+        }
+        else if ( isUnary( instruction.op ) )
+        {
+          if ( !evalUnary( instruction.op, registers[ instruction.a ], dest ) )
+            return false;
+        }
+        else if ( !evalBinary( instruction.op, registers[ instruction.a ], registers[ instruction.b ], dest ) )
+        {
+          return false;
+        }
+        break;
+    }
+  }
+
+  result = toVariant( registers[ 0 ] );
+  return true;
+}
+
+void QgsExpressionBytecode::evaluate( const QgsFeatureBatch &batch, QVector<QVariant> &results, QVector<bool> &failed ) const
+{
+  const int rows = batch.size();
+  results.resize( rows );
+  failed.fill( false, rows );
+
+  // one column of values per register, each instruction is applied to the whole column
+  QVector< QVector< Value > > registers( mRegisterCount );
+  for ( QVector< Value > &reg : registers )
+    reg.resize( rows );
+
+  QVarLengthArray< const Value *, 8 > args;
+  const QgsFields fields = batch.fields();
+
+  for ( const Instruction &instruction : mInstructions )
+  {
+    Value *dest = registers[ instruction.dest ].data();
+    switch ( instruction.op )
+    {
+      case LoadConstant:
+      {
+        const Value &constant = mConstants.at( instruction.a );
+        for ( int row = 0; row < rows; ++row )
+          dest[row] = constant;
+        break;
+      }
+
+      case LoadAttribute:
+      {
+        const int column = batch.columnForAttribute( instruction.a );
+        if ( column < 0 )
+        {
+          // attributes which are not part of the batch are NULL
+          for ( int row = 0; row < rows; ++row )
+            setNull( dest[row] );
+          break;
+        }
+
+        const QVariant::Type fieldType = fields.at( instruction.a ).type();
+        switch ( batch.columnType( column ) )
+        {
+          case QgsFeatureBatch::Int64Column:
+          {
+            const qint64 *values = batch.int64Data( column );
+            const Value::Kind kind = fieldType == QVariant::Int ? Value::Int : Value::LongLong;
+            const bool supported = fieldType == QVariant::Int || fieldType == QVariant::LongLong;
+            for ( int row = 0; row < rows; ++row )
+            {
+              if ( batch.isNull( column, row ) )
+              {
+                dest[row].kind = Value::Null;
+                dest[row].nullType = fieldType;
+              }
+              else if ( supported )
+              {
+                dest[row].kind = kind;
+                dest[row].i = values[row];
+              }
+              else
+              {
+                failed[row] = true;
+              }
+            }
+            break;
+          }
+
+          case QgsFeatureBatch::DoubleColumn:
+          {
+            const double *values = batch.doubleData( column );
+            for ( int row = 0; row < rows; ++row )
+            {
+              if ( batch.isNull( column, row ) )
+              {
+                dest[row].kind = Value::Null;
+                dest[row].nullType = fieldType;
+              }
+              else
+              {
+                dest[row].kind = Value::Double;
+                dest[row].d = values[row];
+              }
+            }
+            break;
+          }
+
+          case QgsFeatureBatch::StringColumn:
+          case QgsFeatureBatch::VariantColumn:
+            for ( int row = 0; row < rows; ++row )
+            {
+              if ( !fromVariant( batch.value( column, row ), dest[row] ) )
+                failed[row] = true;
+            }
+            break;
+        }
+        break;
+      }
+
+      default:
+      {
+        const bool variadic = isVariadic( instruction.op );
+        const bool unary = isUnary( instruction.op );
+        const Value *a = registers.at( instruction.a ).constData();
+        const Value *b = !variadic && !unary ? registers.at( instruction.b ).constData() : nullptr;
+        if ( variadic )
+          args.resize( instruction.b );
+
+        for ( int row = 0; row < rows; ++row )
+        {
+          if ( failed.at( row ) )
+            continue;
+
+          bool ok;
+          if ( variadic )
+          {
+            for ( int i = 0; i < instruction.b; ++i )
+              args[i] = &registers.at( instruction.a + i ).at( row );
+            ok = evalVariadic( instruction.op, args.constData(), instruction.b, dest[row] );
+          }
+          else if ( unary )
+          {
+            ok = evalUnary( instruction.op, a[row], dest[row] );
+          }
+          else
+          {
+            ok = evalBinary( instruction.op, a[row], b[row], dest[row] );
+          }
+
+          if ( !ok )
+            failed[row] = true;
+        }
+        break;
+      }
+    }
+  }
+
+  const Value *result = registers.at( 0 ).constData();
+  for ( int row = 0; row < rows; ++row )
+  {
+    if ( !failed.at( row ) )
+      results[row] = toVariant( result[row] );
+  }
+}
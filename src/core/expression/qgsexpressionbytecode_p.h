@@ -0,0 +1,166 @@
+/***************************************************************************
+                             qgsexpressionbytecode_p.h
+                             -------------------------
+    begin                : October 2026
+    copyright            : (C) 2026 by QGIS contributors
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef QGSEXPRESSIONBYTECODE_PRIVATE_H
+#define QGSEXPRESSIONBYTECODE_PRIVATE_H
+
+#define SIP_NO_FILE
+
+/// @cond PRIVATE
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the QGIS API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+
+#include <QString>
+#include <QVariant>
+#include <QVector>
+#include <memory>
+
+class QgsExpressionNode;
+class QgsExpressionContext;
+class QgsFeature;
+class QgsFeatureBatch;
+
+/**
+ * A prepared expression tree lowered to a compact, register based bytecode program.
+ *
+ * Only the arithmetic, comparison and logical operators and a handful of numeric and string
+ * functions are supported, operating on NULL, integer, double and string values. Subtrees
+ * which were found to be static by QgsExpressionNode::prepare() are folded into constants.
+ *
+ * Whenever the program meets a value or a situation it cannot handle exactly like the
+ * expression nodes do (any other value type, an evaluation error, ...) it reports a failure
+ * and the caller falls back to evaluating the node tree, so results are always identical.
+ */
+class QgsExpressionBytecode
+{
+  public:
+
+    /**
+     * Compiles the prepared expression tree starting at \a root.
+     *
+     * Returns NULLPTR if the tree contains nodes which cannot be compiled.
+     */
+    static std::unique_ptr< QgsExpressionBytecode > compile( const QgsExpressionNode *root, const QgsExpressionContext *context );
+
+    /**
+     * Evaluates the program for the feature from \a context and stores the
+     * result in \a result.
+     *
+     * Returns FALSE if the feature could not be evaluated by the program.
+     */
+    bool evaluate( const QgsExpressionContext *context, QVariant &result ) const;
+
+    /**
+     * Evaluates the program column by column for all features from \a batch.
+     *
+     * The result for each row is stored in \a results. Rows which could not be evaluated by the
+     * program are flagged in \a failed.
+     */
+    void evaluate( const QgsFeatureBatch &batch, QVector< QVariant > &results, QVector< bool > &failed ) const;
+
+    //! Returns the number of instructions in the program
+    int instructionCount() const { return mInstructions.size(); }
+
+    //! Value held in a register
+    struct Value
+    {
+      enum Kind : char
+      {
+        Null,
+        Int,
+        LongLong,
+        Double,
+        String,
+      };
+
+      Kind kind = Null;
+      //! Variant type of NULL values, as some operators treat NULL strings differently
+      QVariant::Type nullType = QVariant::Invalid;
+      qlonglong i = 0;
+      double d = 0;
+      QString s;
+    };
+
+    enum OpCode
+    {
+      LoadConstant,
+      LoadAttribute,
+      Add,
+      Subtract,
+      Multiply,
+      Divide,
+      Modulo,
+      IntDivide,
+      Power,
+      Equal,
+      NotEqual,
+      LessThan,
+      GreaterThan,
+      LessOrEqual,
+      GreaterOrEqual,
+      Is,
+      IsNot,
+      And,
+      Or,
+      ConcatOperator,
+      Not,
+      Negate,
+      Upper,
+      Lower,
+      Trim,
+      Length,
+      Abs,
+      Sqrt,
+      Floor,
+      Ceil,
+      ConcatFunction,
+      Coalesce,
+    };
+
+  private:
+
+    struct Instruction
+    {
+      OpCode op;
+      //! Register receiving the result
+      int dest;
+      //! First operand register, constant index or attribute index
+      int a;
+      //! Second operand register, or number of argument registers for functions
+      int b;
+    };
+
+    QgsExpressionBytecode() = default;
+
+    bool compileNode( const QgsExpressionNode *node, const QgsExpressionContext *context, int reg );
+    bool emitConstant( const QVariant &value, int reg );
+    void addInstruction( OpCode op, int dest, int a, int b = 0 );
+
+    QVector< Instruction > mInstructions;
+    QVector< Value > mConstants;
+    int mRegisterCount = 0;
+};
+
+/// @endcond
+
+#endif // QGSEXPRESSIONBYTECODE_PRIVATE_H
@@ -310,7 +310,13 @@ QList<QgsExpressionContextScope *> QgsExpressionContextUtils::globalProjectLayer
   QList<QgsExpressionContextScope *> scopes;
   scopes << globalScope();
 
-  QgsProject *project = QgsProject::instance();  // TODO: use project associated with layer
+  // the project owning the layer through its layer store, which may not be the current
+  // project (e.g. in the worker threads of QGIS server)
+  QgsProject *project = nullptr;
+  if ( layer && layer->parent() )
+    project = qobject_cast< QgsProject * >( layer->parent()->parent() );
+  if ( !project )
+    project = QgsProject::instance();
   if ( project )
     scopes << projectScope( project );
 
@@ -271,6 +271,22 @@ class CORE_EXPORT QgsExpressionNode SIP_ABSTRACT
      */
     bool prepare( QgsExpression *parent, const QgsExpressionContext *context );
 
+    /**
+     * Returns TRUE if the node can be replaced by a static cached value.
+     *
+     * \see cachedStaticValue()
+     * \since QGIS 3.18
+     */
+    bool hasCachedStaticValue() const { return mHasCachedValue; }
+
+    /**
+     * Returns the node's static cached value. Only valid if hasCachedStaticValue() is TRUE.
+     *
+     * \see hasCachedStaticValue()
+     * \since QGIS 3.18
+     */
+    QVariant cachedStaticValue() const { return mCachedStaticValue; }
+
     /**
      * First line in the parser this node was found.
      * \note This might not be complete for all nodes. Currently
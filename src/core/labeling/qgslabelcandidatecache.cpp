@@ -0,0 +1,157 @@
+/***************************************************************************
+  qgslabelcandidatecache.cpp
+  --------------------------
+  Date                 : October 2026
+  Copyright            : (C) 2026 by QGIS contributors
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qgslabelcandidatecache.h"
+#include "feature.h"
+#include "labelposition.h"
+
+#include <algorithm>
+
+QgsLabelCandidateCache::QgsLabelCandidateCache( int maximumCandidates )
+  : mMaximumCandidates( std::max( 0, maximumCandidates ) )
+{
+}
+
+QgsLabelCandidateCache::~QgsLabelCandidateCache() = default;
+
+void QgsLabelCandidateCache::clear()
+{
+  QMutexLocker locker( &mMutex );
+  mEntries.clear();
+  mCandidateCount = 0;
+  mHits = 0;
+  mMisses = 0;
+  mHasContext = false;
+  mContextKey = 0;
+}
+
+int QgsLabelCandidateCache::maximumCandidates() const
+{
+  QMutexLocker locker( &mMutex );
+  return mMaximumCandidates;
+}
+
+void QgsLabelCandidateCache::setMaximumCandidates( int maximum )
+{
+  QMutexLocker locker( &mMutex );
+  mMaximumCandidates = std::max( 0, maximum );
+  trimInternal();
+}
+
+int QgsLabelCandidateCache::candidateCount() const
+{
+  QMutexLocker locker( &mMutex );
+  return mCandidateCount;
+}
+
+int QgsLabelCandidateCache::hits() const
+{
+  QMutexLocker locker( &mMutex );
+  return mHits;
+}
+
+int QgsLabelCandidateCache::misses() const
+{
+  QMutexLocker locker( &mMutex );
+  return mMisses;
+}
+
+void QgsLabelCandidateCache::beginRun( quint64 contextKey )
+{
+  QMutexLocker locker( &mMutex );
+  if ( !mHasContext || contextKey != mContextKey )
+  {
+    mEntries.clear();
+    mCandidateCount = 0;
+    mHasContext = true;
+    mContextKey = contextKey;
+  }
+  mRun++;
+}
+
+void QgsLabelCandidateCache::endRun()
+{
+  QMutexLocker locker( &mMutex );
+  trimInternal();
+}
+
+bool QgsLabelCandidateCache::candidates( quint64 key, pal::FeaturePart *part, std::vector<std::unique_ptr<pal::LabelPosition> > &candidates )
+{
+  QMutexLocker locker( &mMutex );
+  auto it = mEntries.find( key );
+  if ( it == mEntries.end() || it->second.featureId != part->featureId() )
+  {
+    mMisses++;
+    return false;
+  }
+
+  mHits++;
+  it->second.lastRun = mRun;
+  candidates.clear();
+  candidates.reserve( it->second.candidates.size() );
+  for ( const std::unique_ptr< pal::LabelPosition > &candidate : it->second.candidates )
+  {
+    std::unique_ptr< pal::LabelPosition > copy = qgis::make_unique< pal::LabelPosition >( *candidate );
+    copy->setFeaturePart( part );
+    candidates.emplace_back( std::move( copy ) );
+  }
+  return true;
+}
+
+void QgsLabelCandidateCache::insertCandidates( quint64 key, pal::FeaturePart *part, const std::vector<std::unique_ptr<pal::LabelPosition> > &candidates )
+{
+  Entry entry;
+  entry.featureId = part->featureId();
+  entry.candidates.reserve( candidates.size() );
+  for ( const std::unique_ptr< pal::LabelPosition > &candidate : candidates )
+  {
+    // the cached candidates must not refer to the feature part, which is destroyed with the labeling problem
+    std::unique_ptr< pal::LabelPosition > copy = qgis::make_unique< pal::LabelPosition >( *candidate );
+    copy->setFeaturePart( nullptr );
+    entry.candidates.emplace_back( std::move( copy ) );
+  }
+
+  QMutexLocker locker( &mMutex );
+  entry.lastRun = mRun;
+  auto it = mEntries.find( key );
+  if ( it != mEntries.end() )
+  {
+    mCandidateCount -= static_cast< int >( it->second.candidates.size() );
+    mEntries.erase( it );
+  }
+  mCandidateCount += static_cast< int >( entry.candidates.size() );
+  mEntries.emplace( key, std::move( entry ) );
+}
+
+void QgsLabelCandidateCache::trimInternal()
+{
+  if ( mCandidateCount <= mMaximumCandidates )
+    return;
+
+  std::vector< std::pair< int, quint64 > > entries;
+  entries.reserve( mEntries.size() );
+  for ( const auto &entry : mEntries )
+    entries.emplace_back( entry.second.lastRun, entry.first );
+  std::sort( entries.begin(), entries.end() );
+
+  for ( const std::pair< int, quint64 > &entry : entries )
+  {
+    if ( mCandidateCount <= mMaximumCandidates )
+      break;
+
+    auto it = mEntries.find( entry.second );
+    mCandidateCount -= static_cast< int >( it->second.candidates.size() );
+    mEntries.erase( it );
+  }
+}
@@ -0,0 +1,165 @@
+/***************************************************************************
+  qgslabelcandidatecache.h
+  --------------------------
+  Date                 : October 2026
+  Copyright            : (C) 2026 by QGIS contributors
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef QGSLABELCANDIDATECACHE_H
+#define QGSLABELCANDIDATECACHE_H
+
+#define SIP_NO_FILE
+
+#include "qgis_core.h"
+#include "qgsfeatureid.h"
+
+#include <QMutex>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace pal
+{
+  class FeaturePart;
+  class LabelPosition;
+}
+
+/**
+ * \ingroup core
+ * \brief A cache of the label candidates generated for features, which can be reused
+ * by successive labeling runs.
+ *
+ * Generating the label candidates of the features dominates the labeling time of
+ * dense layers. When a map is panned at the same scale, most of the features which
+ * were labeled for the previous extent are labeled again with exactly the same
+ * candidates: a cache attached to the labeling engine keeps these candidates, so
+ * that only the newly visible features (and the features which were clipped by the
+ * previous extent) need fresh candidates.
+ *
+ * The candidates of a feature part are keyed on the feature id, its geometry in map
+ * units, its label size and its label settings. The scale dependent parameters of the
+ * engine form a separate context key, and the cache is cleared when the context changes
+ * (e.g. when zooming the map).
+ *
+ * The number of cached candidates is limited, candidates which were not used for the
+ * longest time are discarded first.
+ *
+ * The cache is thread safe, it can be used by concurrent labeling runs.
+ *
+ * \note not available in Python bindings
+ * \since QGIS 3.18
+ */
+class CORE_EXPORT QgsLabelCandidateCache
+{
+  public:
+
+    //! Default maximum number of cached candidates
+    static const int DEFAULT_MAXIMUM_CANDIDATES = 250000;
+
+    /**
+     * Constructor for QgsLabelCandidateCache, which keeps at most \a maximumCandidates candidates.
+     */
+    explicit QgsLabelCandidateCache( int maximumCandidates = DEFAULT_MAXIMUM_CANDIDATES );
+    ~QgsLabelCandidateCache();
+
+    //! QgsLabelCandidateCache cannot be copied
+    QgsLabelCandidateCache( const QgsLabelCandidateCache &other ) = delete;
+    //! QgsLabelCandidateCache cannot be copied
+    QgsLabelCandidateCache &operator=( const QgsLabelCandidateCache &other ) = delete;
+
+    /**
+     * Removes all the candidates from the cache and resets its statistics.
+     */
+    void clear();
+
+    /**
+     * Returns the maximum number of candidates kept in the cache.
+     * \see setMaximumCandidates()
+     */
+    int maximumCandidates() const;
+
+    /**
+     * Sets the \a maximum number of candidates kept in the cache.
+     * \see maximumCandidates()
+     */
+    void setMaximumCandidates( int maximum );
+
+    /**
+     * Returns the number of candidates in the cache.
+     */
+    int candidateCount() const;
+
+    /**
+     * Returns the number of feature parts whose candidates were taken from the cache since the last clear().
+     * \see misses()
+     */
+    int hits() const;
+
+    /**
+     * Returns the number of feature parts whose candidates were not in the cache since the last clear().
+     * \see hits()
+     */
+    int misses() const;
+
+    /**
+     * Starts a labeling run with the specified \a contextKey, which identifies all the parameters
+     * of the labeling engine which affect the generated candidates. If it differs from the
+     * key of the previous run, the cache is cleared.
+     *
+     * \see endRun()
+     */
+    void beginRun( quint64 contextKey );
+
+    /**
+     * Ends a labeling run, discarding the least recently used candidates if the cache
+     * is larger than maximumCandidates().
+     *
+     * \see beginRun()
+     */
+    void endRun();
+
+    /**
+     * Retrieves the cached candidates for the feature \a part with the specified \a key,
+     * and stores copies of them owned by \a part in \a candidates. Returns FALSE if there
+     * are no candidates cached for the part.
+     */
+    bool candidates( quint64 key, pal::FeaturePart *part, std::vector< std::unique_ptr< pal::LabelPosition > > &candidates );
+
+    /**
+     * Stores copies of the \a candidates generated for the feature \a part with the specified \a key.
+     */
+    void insertCandidates( quint64 key, pal::FeaturePart *part, const std::vector< std::unique_ptr< pal::LabelPosition > > &candidates );
+
+  private:
+
+    struct Entry
+    {
+      QgsFeatureId featureId;
+      int lastRun = 0;
+      std::vector< std::unique_ptr< pal::LabelPosition > > candidates;
+    };
+
+    //! Discards the least recently used entries (without locking)
+    void trimInternal();
+
+    mutable QMutex mMutex;
+    int mMaximumCandidates = DEFAULT_MAXIMUM_CANDIDATES;
+    int mCandidateCount = 0;
+    int mHits = 0;
+    int mMisses = 0;
+
+    bool mHasContext = false;
+    quint64 mContextKey = 0;
+    int mRun = 0;
+
+    std::unordered_map< quint64, Entry > mEntries;
+};
+
+#endif // QGSLABELCANDIDATECACHE_H
@@ -275,6 +275,8 @@ void QgsLabelingEngine::registerLabels( QgsRenderContext &context )
 
   mPal->setShowPartialLabels( settings.testFlag( QgsLabelingEngineSettings::UsePartialCandidates ) );
   mPal->setPlacementVersion( settings.placementVersion() );
+  mPal->setSolveConflictsInParallel( settings.testFlag( QgsLabelingEngineSettings::SolveConflictsInParallel ) );
+  mPal->setCandidateCache( mCandidateCache );
 
   // for each provider: get labels and register them in PAL
   for ( QgsAbstractLabelProvider *provider : qgis::as_const( mProviders ) )
@@ -26,6 +26,7 @@
 #include "qgslabeling.h"
 
 class QgsLabelingEngine;
+class QgsLabelCandidateCache;
 
 namespace pal
 {
@@ -250,6 +251,25 @@ class CORE_EXPORT QgsLabelingEngine
     //! Remove provider if the provider's initialization failed. Provider instance is deleted.
     void removeProvider( QgsAbstractLabelProvider *provider );
 
+    /**
+     * Returns the cache used to reuse label candidates from previous labeling runs, or NULLPTR if
+     * candidates are not cached.
+     *
+     * \see setCandidateCache()
+     * \since QGIS 3.18
+     */
+    QgsLabelCandidateCache *candidateCache() const { return mCandidateCache; }
+
+    /**
+     * Sets the \a cache used to reuse label candidates from previous labeling runs (e.g. when
+     * panning a map canvas). Ownership is not transferred, and the cache must exist until the
+     * labeling job is finished.
+     *
+     * \see candidateCache()
+     * \since QGIS 3.18
+     */
+    void setCandidateCache( QgsLabelCandidateCache *cache ) { mCandidateCache = cache; }
+
     /**
      * Runs the labeling job.
      *
@@ -317,6 +337,9 @@ class CORE_EXPORT QgsLabelingEngine
     //! Resulting labeling layout
     std::unique_ptr< QgsLabelingResults > mResults;
 
+    //! Cache of label candidates, not owned
+    QgsLabelCandidateCache *mCandidateCache = nullptr;
+
     std::unique_ptr< pal::Pal > mPal;
     std::unique_ptr< pal::Problem > mProblem;
     QList<pal::LabelPosition *> mUnlabeled;
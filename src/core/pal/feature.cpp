@@ -45,6 +45,7 @@
 #include <QLinkedList>
 #include <cmath>
 #include <cfloat>
+#include <cstring>
 
 using namespace pal;
 
@@ -2165,6 +2166,102 @@ std::vector< std::unique_ptr< LabelPosition > > FeaturePart::createCandidates( P
   return lPos;
 }
 
+///@cond PRIVATE
+static void hashCombine( quint64 &seed, quint64 value )
+{
+  seed ^= value + 0x9e3779b97f4a7c15ULL + ( seed << 6 ) + ( seed >> 2 );
+}
+
+static void hashCombine( quint64 &seed, double value )
+{
+  // +0.0 and -0.0 must give the same key
+  if ( value == 0.0 )
+    value = 0.0;
+  quint64 bits;
+  std::memcpy( &bits, &value, sizeof( bits ) );
+  hashCombine( seed, bits );
+}
+
+static void hashCombine( quint64 &seed, const PointSet *shape )
+{
+  hashCombine( seed, static_cast< quint64 >( shape->getNumPoints() ) );
+  for ( int i = 0; i < shape->getNumPoints(); ++i )
+  {
+    hashCombine( seed, shape->x[i] );
+    hashCombine( seed, shape->y[i] );
+  }
+}
+///@endcond
+
+quint64 FeaturePart::candidatesCacheKey() const
+{
+  // candidates restricted to a permissible zone are not cached, the zone would have to be part of the key
+  if ( !mLF->permissibleZone().isNull() )
+    return 0;
+
+  quint64 key = static_cast< quint64 >( mLF->id() );
+
+  // layer settings
+  const Layer *layer = mLF->layer();
+  hashCombine( key, static_cast< quint64 >( layer->arrangement() ) );
+  hashCombine( key, static_cast< quint64 >( layer->centroidInside() ) );
+  hashCombine( key, static_cast< quint64 >( layer->upsidedownLabels() ) );
+  hashCombine( key, static_cast< quint64 >( layer->maximumPointLabelCandidates() ) );
+  hashCombine( key, static_cast< quint64 >( layer->maximumLineLabelCandidates() ) );
+  hashCombine( key, static_cast< quint64 >( layer->maximumPolygonLabelCandidates() ) );
+
+  // label feature properties
+  hashCombine( key, mLF->size().width() );
+  hashCombine( key, mLF->size().height() );
+  hashCombine( key, mLF->size( M_PI_2 ).width() );
+  hashCombine( key, mLF->size( M_PI_2 ).height() );
+  hashCombine( key, static_cast< quint64 >( mLF->hasFixedPosition() ) );
+  hashCombine( key, mLF->fixedPosition().x() );
+  hashCombine( key, mLF->fixedPosition().y() );
+  hashCombine( key, static_cast< quint64 >( mLF->hasFixedAngle() ) );
+  hashCombine( key, mLF->fixedAngle() );
+  hashCombine( key, static_cast< quint64 >( mLF->hasFixedQuadrant() ) );
+  hashCombine( key, mLF->quadOffset().x() );
+  hashCombine( key, mLF->quadOffset().y() );
+  hashCombine( key, mLF->positionOffset().x() );
+  hashCombine( key, mLF->positionOffset().y() );
+  hashCombine( key, static_cast< quint64 >( mLF->offsetType() ) );
+  hashCombine( key, mLF->distLabel() );
+  const QVector< QgsPalLayerSettings::PredefinedPointPosition > positions = mLF->predefinedPositionOrder();
+  for ( QgsPalLayerSettings::PredefinedPointPosition position : positions )
+    hashCombine( key, static_cast< quint64 >( position ) );
+  hashCombine( key, static_cast< quint64 >( mLF->arrangementFlags() ) );
+  hashCombine( key, static_cast< quint64 >( mLF->polygonPlacementFlags() ) );
+  hashCombine( key, mLF->overrunDistance() );
+  hashCombine( key, mLF->overrunSmoothDistance() );
+  hashCombine( key, mLF->lineAnchorPercent() );
+  hashCombine( key, static_cast< quint64 >( mLF->lineAnchorType() ) );
+  hashCombine( key, mLF->visualMargin().left() );
+  hashCombine( key, mLF->visualMargin().top() );
+  hashCombine( key, mLF->visualMargin().right() );
+  hashCombine( key, mLF->visualMargin().bottom() );
+  hashCombine( key, mLF->symbolSize().width() );
+  hashCombine( key, mLF->symbolSize().height() );
+  hashCombine( key, static_cast< quint64 >( qHash( mLF->labelText() ) ) );
+  if ( const LabelInfo *info = mLF->curvedLabelInfo() )
+  {
+    hashCombine( key, info->max_char_angle_inside );
+    hashCombine( key, info->max_char_angle_outside );
+    hashCombine( key, info->label_height );
+    hashCombine( key, static_cast< quint64 >( info->char_num ) );
+    for ( int i = 0; i < info->char_num; ++i )
+      hashCombine( key, info->char_info[i].width );
+  }
+
+  // part geometry, with its holes
+  hashCombine( key, static_cast< quint64 >( type ) );
+  hashCombine( key, this );
+  for ( const FeaturePart *hole : mHoles )
+    hashCombine( key, hole );
+
+  return key != 0 ? key : 1;
+}
+
 void FeaturePart::addSizePenalty( std::vector< std::unique_ptr< LabelPosition > > &lPos, double bbx[4], double bby[4] )
 {
   if ( !mGeos )
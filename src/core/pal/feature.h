@@ -146,6 +146,15 @@ namespace pal
        */
       std::vector<std::unique_ptr<LabelPosition> > createCandidates( Pal *pal );
 
+      /**
+       * Returns a key identifying the candidates generated by createCandidates() for this feature,
+       * computed from the feature ID, the geometry of the part and the label properties used
+       * to generate the candidates. Returns 0 if the candidates cannot be cached.
+       *
+       * \since QGIS 3.18
+       */
+      quint64 candidatesCacheKey() const;
+
       /**
        * Generate candidates for point feature, located around a specified point.
        * \param x x coordinate of the point
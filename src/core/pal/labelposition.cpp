@@ -376,6 +376,13 @@ FeaturePart *LabelPosition::getFeaturePart() const
   return feature;
 }
 
+void LabelPosition::setFeaturePart( FeaturePart *part )
+{
+  feature = part;
+  if ( mNextPart )
+    mNextPart->setFeaturePart( part );
+}
+
 void LabelPosition::getBoundingBox( double amin[2], double amax[2] ) const
 {
   if ( mNextPart )
@@ -173,6 +173,13 @@ namespace pal
        */
       FeaturePart *getFeaturePart() const;
 
+      /**
+       * Sets the feature \a part corresponding to this labelposition and to all its next parts.
+       *
+       * \since QGIS 3.18
+       */
+      void setFeaturePart( FeaturePart *part );
+
       int getNumOverlaps() const { return nbOverlap; }
       void resetNumOverlaps() { nbOverlap = 0; } // called from problem.cpp, pal.cpp
 
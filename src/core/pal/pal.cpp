@@ -42,8 +42,13 @@
 #include "util.h"
 #include "palrtree.h"
 #include "qgssettings.h"
+#include "qgslabelcandidatecache.h"
 #include <cfloat>
+#include <cstring>
 #include <list>
+#include <QHash>
+#include <QThreadPool>
+#include <QtConcurrentMap>
 
 using namespace pal;
 
@@ -127,6 +132,9 @@ std::unique_ptr<Problem> Pal::extract( const QgsRectangle &extent, const QgsGeom
 
   QStringList layersWithFeaturesInBBox;
 
+  if ( mCandidateCache )
+    mCandidateCache->beginRun( candidateCacheContextKey() );
+
   QMutexLocker palLocker( &mMutex );
   for ( const auto &it : mLayers )
   {
@@ -156,6 +164,12 @@ std::unique_ptr<Problem> Pal::extract( const QgsRectangle &extent, const QgsGeom
     QMutexLocker locker( &layer->mMutex );
 
     // generate candidates for all features
+    std::vector< std::vector< std::unique_ptr< LabelPosition > > > partCandidates = createCandidates( layer->mFeatureParts );
+
+    if ( isCanceled() )
+      return nullptr;
+
+    std::size_t partIndex = 0;
     for ( FeaturePart *featurePart : qgis::as_const( layer->mFeatureParts ) )
     {
       if ( isCanceled() )
@@ -174,11 +188,8 @@ std::unique_ptr<Problem> Pal::extract( const QgsRectangle &extent, const QgsGeom
         }
       }
 
-      // generate candidates for the feature part
-      std::vector< std::unique_ptr< LabelPosition > > candidates = featurePart->createCandidates( this );
-
-      if ( isCanceled() )
-        break;
+      // candidates of the feature part
+      std::vector< std::unique_ptr< LabelPosition > > candidates = std::move( partCandidates[ partIndex++ ] );
 
       // purge candidates that are outside the bbox
       candidates.erase( std::remove_if( candidates.begin(), candidates.end(), [&mapBoundaryPrepared, this]( std::unique_ptr< LabelPosition > &candidate )
@@ -266,6 +277,9 @@ std::unique_ptr<Problem> Pal::extract( const QgsRectangle &extent, const QgsGeom
   }
   palLocker.unlock();
 
+  if ( mCandidateCache )
+    mCandidateCache->endRun();
+
   if ( isCanceled() )
     return nullptr;
 
@@ -472,6 +486,90 @@ std::unique_ptr<Problem> Pal::extract( const QgsRectangle &extent, const QgsGeom
   return prob;
 }
 
+std::vector< std::vector< std::unique_ptr< LabelPosition > > > Pal::createCandidates( const QLinkedList< FeaturePart * > &parts )
+{
+  std::vector< std::vector< std::unique_ptr< LabelPosition > > > candidates( static_cast< std::size_t >( parts.size() ) );
+
+  // keys of the parts whose candidates have to be generated and added to the cache
+  std::vector< quint64 > cacheKeys;
+  if ( mCandidateCache )
+    cacheKeys.resize( candidates.size(), 0 );
+
+  // the parts of a label feature share its state (prepared geometries, curved label metrics...),
+  // so they are handled by the same task. Each part writes to its own entry in the candidates
+  // and the candidates of a part do not depend on the other parts, so the result is the same
+  // as when generating them sequentially.
+  std::vector< std::vector< std::pair< std::size_t, FeaturePart * > > > tasks;
+  QHash< QgsLabelFeature *, std::size_t > featureTasks;
+  std::size_t index = 0;
+  for ( FeaturePart *part : parts )
+  {
+    if ( mCandidateCache )
+    {
+      const quint64 key = part->candidatesCacheKey();
+      if ( key && mCandidateCache->candidates( key, part, candidates[ index ] ) )
+      {
+        index++;
+        continue;
+      }
+      cacheKeys[ index ] = key;
+    }
+
+    auto it = featureTasks.constFind( part->feature() );
+    if ( it == featureTasks.constEnd() )
+    {
+      it = featureTasks.insert( part->feature(), tasks.size() );
+      tasks.emplace_back();
+    }
+    tasks[ it.value() ].emplace_back( index++, part );
+  }
+
+  auto createTaskCandidates = [this, &candidates]( const std::vector< std::pair< std::size_t, FeaturePart * > > &task )
+  {
+    for ( const std::pair< std::size_t, FeaturePart * > &part : task )
+    {
+      if ( isCanceled() )
+        return;
+
+      candidates[ part.first ] = part.second->createCandidates( this );
+    }
+  };
+
+  if ( tasks.size() > 1 && QThreadPool::globalInstance()->maxThreadCount() > 1 )
+    QtConcurrent::blockingMap( tasks, createTaskCandidates );
+  else
+    std::for_each( tasks.begin(), tasks.end(), createTaskCandidates );
+
+  // the candidates of a canceled run may be incomplete, they must not be cached
+  if ( mCandidateCache && !isCanceled() )
+  {
+    for ( const std::vector< std::pair< std::size_t, FeaturePart * > > &task : tasks )
+    {
+      for ( const std::pair< std::size_t, FeaturePart * > &part : task )
+      {
+        if ( cacheKeys[ part.first ] )
+          mCandidateCache->insertCandidates( cacheKeys[ part.first ], part.second, candidates[ part.first ] );
+      }
+    }
+  }
+
+  return candidates;
+}
+
+quint64 Pal::candidateCacheContextKey() const
+{
+  // the scale dependent candidate densities, the other settings are part of the key of each feature part
+  const double values[] = { mMaxLineCandidatesPerMapUnit, mMaxPolygonCandidatesPerMapUnitSquared };
+  quint64 key = static_cast< quint64 >( mPlacementVersion );
+  for ( double value : values )
+  {
+    quint64 bits;
+    std::memcpy( &bits, &value, sizeof( bits ) );
+    key ^= bits + 0x9e3779b97f4a7c15ULL + ( key << 6 ) + ( key >> 2 );
+  }
+  return key;
+}
+
 void Pal::registerCancellationCallback( Pal::FnIsCanceled fnCanceled, void *context )
 {
   fnIsCanceled = fnCanceled;
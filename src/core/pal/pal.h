@@ -39,19 +39,24 @@
 #include "qgspallabeling.h"
 #include "qgslabelingenginesettings.h"
 #include <QList>
+#include <QLinkedList>
 #include <iostream>
 #include <ctime>
 #include <QMutex>
 #include <QStringList>
 #include <unordered_map>
+#include <memory>
+#include <vector>
 
 // TODO ${MAJOR} ${MINOR} etc instead of 0.2
 
 class QgsAbstractLabelProvider;
+class QgsLabelCandidateCache;
 
 namespace pal
 {
   class Layer;
+  class FeaturePart;
   class LabelPosition;
   class PalStat;
   class Problem;
@@ -205,6 +210,42 @@ namespace pal
        */
       void setPlacementVersion( QgsLabelingEngineSettings::PlacementEngineVersion placementVersion );
 
+      /**
+       * Returns TRUE if independent groups of conflicting labels are solved concurrently.
+       *
+       * \see setSolveConflictsInParallel()
+       * \since QGIS 3.18
+       */
+      bool solveConflictsInParallel() const { return mSolveConflictsInParallel; }
+
+      /**
+       * Sets whether independent groups of conflicting labels are solved concurrently.
+       *
+       * The solution is deterministic, but it can differ from the one found when all the
+       * labels are solved together.
+       *
+       * \see solveConflictsInParallel()
+       * \since QGIS 3.18
+       */
+      void setSolveConflictsInParallel( bool parallel ) { mSolveConflictsInParallel = parallel; }
+
+      /**
+       * Returns the cache used to reuse label candidates between labeling runs, or NULLPTR if candidates are not cached.
+       *
+       * \see setCandidateCache()
+       * \since QGIS 3.18
+       */
+      QgsLabelCandidateCache *candidateCache() const { return mCandidateCache; }
+
+      /**
+       * Sets the \a cache used to reuse label candidates between labeling runs. Ownership
+       * is not transferred, and the cache must exist until the problem has been extracted.
+       *
+       * \see candidateCache()
+       * \since QGIS 3.18
+       */
+      void setCandidateCache( QgsLabelCandidateCache *cache ) { mCandidateCache = cache; }
+
       /**
        * Returns the global candidates limit for point features, or 0 if no global limit is in effect.
        *
@@ -273,6 +314,10 @@ namespace pal
 
       QgsLabelingEngineSettings::PlacementEngineVersion mPlacementVersion = QgsLabelingEngineSettings::PlacementEngineVersion2;
 
+      bool mSolveConflictsInParallel = false;
+
+      QgsLabelCandidateCache *mCandidateCache = nullptr;
+
       //! Callback that may be called from PAL to check whether the job has not been canceled in meanwhile
       FnIsCanceled fnIsCanceled = nullptr;
       //! Application-specific context for the cancellation check function
@@ -285,6 +330,21 @@ namespace pal
        */
       std::unique_ptr< Problem > extract( const QgsRectangle &extent, const QgsGeometry &mapBoundary );
 
+      /**
+       * Generates the candidates of all the feature \a parts, in parallel. The candidates of
+       * each part are returned at the same position as the part in the list.
+       *
+       * If a candidate cache is set, the candidates of the parts found in the cache are copied
+       * from it, and the newly generated candidates are added to it.
+       */
+      std::vector< std::vector< std::unique_ptr< LabelPosition > > > createCandidates( const QLinkedList< FeaturePart * > &parts );
+
+      /**
+       * Returns a key identifying the engine parameters which affect the generated candidates,
+       * for the candidate cache.
+       */
+      quint64 candidateCacheContextKey() const;
+
       /**
        * \brief Choose the size of popmusic subpart's
        * \param r subpart size
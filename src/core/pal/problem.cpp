@@ -39,6 +39,9 @@
 #include "internalexception.h"
 #include <cfloat>
 #include <limits> //for std::numeric_limits<int>::max()
+#include <numeric>
+#include <unordered_map>
+#include <QtConcurrentMap>
 
 #include "qgslabelingengine.h"
 
@@ -57,6 +60,7 @@ inline void delete_chain( Chain *chain )
 Problem::Problem( const QgsRectangle &extent )
   : mAllCandidatesIndex( extent )
   , mActiveCandidatesIndex( extent )
+  , mExtent( extent )
 {
 
 }
@@ -137,55 +141,198 @@ void Problem::reduce()
   delete[] ok;
 }
 
-void ignoreLabel( const LabelPosition *lp, PriorityQueue &list, PalRtree< LabelPosition > &candidatesIndex )
+std::vector< Problem::FeatureGroup > Problem::singleFeatureGroup()
 {
-  if ( list.isIn( lp->getId() ) )
+  std::vector< FeatureGroup > groups( 1 );
+  groups[0].features.resize( mFeatureCount );
+  std::iota( groups[0].features.begin(), groups[0].features.end(), 0 );
+  groups[0].activeCandidatesIndex = &mActiveCandidatesIndex;
+  return groups;
+}
+
+std::vector< Problem::FeatureGroup > Problem::conflictFeatureGroups()
+{
+  // minimum number of candidates in a group, small components are merged together
+  const int MIN_GROUP_CANDIDATES = 512;
+
+  // union-find of the features having candidates with overlapping bounding boxes. This is
+  // more than the actual conflicts, but it is cheap and components stay independent.
+  std::vector< int > parent( mFeatureCount );
+  std::iota( parent.begin(), parent.end(), 0 );
+  auto findRoot = [&parent]( int feature )
   {
-    list.remove( lp->getId() );
+    while ( parent[feature] != feature )
+    {
+      parent[feature] = parent[parent[feature]];
+      feature = parent[feature];
+    }
+    return feature;
+  };
 
-    double amin[2];
-    double amax[2];
-    lp->getBoundingBox( amin, amax );
-    candidatesIndex.intersects( QgsRectangle( amin[0], amin[1], amax[0], amax[1] ), [lp, &list]( const LabelPosition * lp2 )->bool
+  double amin[2];
+  double amax[2];
+  for ( int i = 0; i < static_cast< int >( mFeatureCount ); i++ )
+  {
+    for ( int j = 0; j < mFeatNbLp[i]; j++ )
     {
-      if ( lp2->getId() != lp->getId() && list.isIn( lp2->getId() ) && lp2->isInConflict( lp ) )
+      mLabelPositions[ mFeatStartId[i] + j ]->getBoundingBox( amin, amax );
+      mAllCandidatesIndex.intersects( QgsRectangle( amin[0], amin[1], amax[0], amax[1] ), [i, &parent, &findRoot]( const LabelPosition * lp ) -> bool
       {
-        list.decreaseKey( lp2->getId() );
-      }
-      return true;
-    } );
+        const int root1 = findRoot( i );
+        const int root2 = findRoot( lp->getProblemFeatureId() );
+        if ( root1 != root2 )
+          parent[ std::max( root1, root2 ) ] = std::min( root1, root2 );
+        return true;
+      } );
+    }
+  }
+
+  // components, in order of their first feature
+  std::vector< std::vector< int > > components;
+  std::vector< int > rootComponent( mFeatureCount, -1 );
+  for ( int i = 0; i < static_cast< int >( mFeatureCount ); i++ )
+  {
+    const int root = findRoot( i );
+    if ( rootComponent[root] < 0 )
+    {
+      rootComponent[root] = static_cast< int >( components.size() );
+      components.emplace_back();
+    }
+    components[ rootComponent[root] ].push_back( i );
   }
+
+  std::vector< FeatureGroup > groups;
+  int groupCandidates = 0;
+  for ( const std::vector< int > &component : components )
+  {
+    if ( groups.empty() || groupCandidates >= MIN_GROUP_CANDIDATES )
+    {
+      groups.emplace_back();
+      groupCandidates = 0;
+    }
+
+    FeatureGroup &group = groups.back();
+    group.features.insert( group.features.end(), component.begin(), component.end() );
+    for ( int feature : component )
+      groupCandidates += mFeatNbLp[feature];
+  }
+
+  for ( FeatureGroup &group : groups )
+  {
+    std::sort( group.features.begin(), group.features.end() );
+    if ( groups.size() == 1 )
+    {
+      group.activeCandidatesIndex = &mActiveCandidatesIndex;
+    }
+    else
+    {
+      group.ownedActiveCandidatesIndex = qgis::make_unique< PalRtree< LabelPosition > >( mExtent );
+      group.activeCandidatesIndex = group.ownedActiveCandidatesIndex.get();
+    }
+  }
+
+  return groups;
+}
+
+void Problem::prepareFeatureGroups( std::vector< FeatureGroup > &groups )
+{
+  mFeatureGroup.assign( mFeatureCount, -1 );
+  mFeaturePositionInGroup.assign( mFeatureCount, -1 );
+  mFeatureCandidatesStartInGroup.assign( mFeatureCount, -1 );
+
+  for ( std::size_t groupIndex = 0; groupIndex < groups.size(); ++groupIndex )
+  {
+    FeatureGroup &group = groups[groupIndex];
+    group.index = static_cast< int >( groupIndex );
+    group.candidates.clear();
+    group.totalCost = 0;
+    for ( std::size_t position = 0; position < group.features.size(); ++position )
+    {
+      const int feature = group.features[position];
+      mFeatureGroup[feature] = group.index;
+      mFeaturePositionInGroup[feature] = static_cast< int >( position );
+      mFeatureCandidatesStartInGroup[feature] = static_cast< int >( group.candidates.size() );
+      for ( int j = 0; j < mFeatNbLp[feature]; j++ )
+        group.candidates.push_back( mFeatStartId[feature] + j );
+    }
+  }
+}
+
+int Problem::groupCandidateKey( const FeatureGroup &group, const LabelPosition *lp ) const
+{
+  const int feature = lp->getProblemFeatureId();
+  if ( mFeatureGroup[feature] != group.index )
+    return -1;
+
+  const int offset = lp->getId() - mFeatStartId[feature];
+  if ( offset < 0 || offset >= mFeatNbLp[feature] )
+    return -1;
+
+  return mFeatureCandidatesStartInGroup[feature] + offset;
+}
+
+bool Problem::isInGroup( const FeatureGroup &group, const LabelPosition *lp ) const
+{
+  return mFeatureGroup[ lp->getProblemFeatureId() ] == group.index;
+}
+
+void Problem::init_sol_falp()
+{
+  mSol.init( mFeatureCount );
+
+  std::vector< FeatureGroup > groups = singleFeatureGroup();
+  prepareFeatureGroups( groups );
+  init_sol_falp( groups.front() );
 }
 
 /* Better initial solution
  * Step one FALP (Yamamoto, Camara, Lorena 2005)
  */
-void Problem::init_sol_falp()
+void Problem::init_sol_falp( FeatureGroup &group )
 {
   int label;
 
-  mSol.init( mFeatureCount );
-
-  PriorityQueue list( mTotalCandidates, mAllNblp, true );
+  const int candidateCount = static_cast< int >( group.candidates.size() );
+  PriorityQueue list( candidateCount, std::max( 0, candidateCount - 1 ), true );
 
   double amin[2];
   double amax[2];
 
   LabelPosition *lp = nullptr;
 
-  for ( int i = 0; i < static_cast< int >( mFeatureCount ); i++ )
-    for ( int j = 0; j < mFeatNbLp[i]; j++ )
+  auto ignoreLabel = [this, &group, &list]( const LabelPosition * position )
+  {
+    const int key = groupCandidateKey( group, position );
+    if ( key >= 0 && list.isIn( key ) )
     {
-      label = mFeatStartId[i] + j;
-      try
-      {
-        list.insert( label, mLabelPositions.at( label )->getNumOverlaps() );
-      }
-      catch ( pal::InternalException::Full & )
+      list.remove( key );
+
+      double amin[2];
+      double amax[2];
+      position->getBoundingBox( amin, amax );
+      mAllCandidatesIndex.intersects( QgsRectangle( amin[0], amin[1], amax[0], amax[1] ), [this, position, key, &group, &list]( const LabelPosition * lp2 )->bool
       {
-        continue;
-      }
+        const int key2 = groupCandidateKey( group, lp2 );
+        if ( key2 >= 0 && key2 != key && list.isIn( key2 ) && lp2->isInConflict( position ) )
+        {
+          list.decreaseKey( key2 );
+        }
+        return true;
+      } );
     }
+  };
+
+  for ( int key = 0; key < candidateCount; key++ )
+  {
+    try
+    {
+      list.insert( key, mLabelPositions.at( group.candidates[key] )->getNumOverlaps() );
+    }
+    catch ( pal::InternalException::Full & )
+    {
+      continue;
+    }
+  }
 
   while ( list.getSize() > 0 ) // O (log size)
   {
@@ -194,7 +341,7 @@ void Problem::init_sol_falp()
       return;
     }
 
-    label = list.getBest();   // O (log size)
+    label = group.candidates[ list.getBest() ];   // O (log size)
 
     lp = mLabelPositions[ label ].get();
 
@@ -208,16 +355,16 @@ void Problem::init_sol_falp()
 
     for ( int i = mFeatStartId[probFeatId]; i < mFeatStartId[probFeatId] + mFeatNbLp[probFeatId]; i++ )
     {
-      ignoreLabel( mLabelPositions[ i ].get(), list, mAllCandidatesIndex );
+      ignoreLabel( mLabelPositions[ i ].get() );
     }
 
 
     lp->getBoundingBox( amin, amax );
 
     std::vector< const LabelPosition * > conflictingPositions;
-    mAllCandidatesIndex.intersects( QgsRectangle( amin[0], amin[1], amax[0], amax[1] ), [lp, &conflictingPositions]( const LabelPosition * lp2 ) ->bool
+    mAllCandidatesIndex.intersects( QgsRectangle( amin[0], amin[1], amax[0], amax[1] ), [this, lp, &group, &conflictingPositions]( const LabelPosition * lp2 ) ->bool
     {
-      if ( lp->isInConflict( lp2 ) )
+      if ( isInGroup( group, lp2 ) && lp->isInConflict( lp2 ) )
       {
         conflictingPositions.emplace_back( lp2 );
       }
@@ -226,10 +373,10 @@ void Problem::init_sol_falp()
 
     for ( const LabelPosition *conflict : conflictingPositions )
     {
-      ignoreLabel( conflict, list, mAllCandidatesIndex );
+      ignoreLabel( conflict );
     }
 
-    mActiveCandidatesIndex.insert( lp, QgsRectangle( amin[0], amin[1], amax[0], amax[1] ) );
+    group.activeCandidatesIndex->insert( lp, QgsRectangle( amin[0], amin[1], amax[0], amax[1] ) );
   }
 
   if ( mDisplayAll )
@@ -239,7 +386,7 @@ void Problem::init_sol_falp()
     LabelPosition *retainedLabel = nullptr;
     int p;
 
-    for ( std::size_t i = 0; i < mFeatureCount; i++ ) // forearch hidden feature
+    for ( int i : group.features ) // forearch hidden feature
     {
       if ( mSol.activeLabelIds[i] == -1 )
       {
@@ -253,7 +400,7 @@ void Problem::init_sol_falp()
           lp->getBoundingBox( amin, amax );
 
 
-          mActiveCandidatesIndex.intersects( QgsRectangle( amin[0], amin[1], amax[0], amax[1] ), [&lp]( const LabelPosition * lp2 )->bool
+          group.activeCandidatesIndex->intersects( QgsRectangle( amin[0], amin[1], amax[0], amax[1] ), [&lp]( const LabelPosition * lp2 )->bool
           {
             if ( lp->isInConflict( lp2 ) )
             {
@@ -270,14 +417,14 @@ void Problem::init_sol_falp()
         }
         mSol.activeLabelIds[i] = retainedLabel->getId();
 
-        retainedLabel->insertIntoIndex( mActiveCandidatesIndex );
+        retainedLabel->insertIntoIndex( *group.activeCandidatesIndex );
 
       }
     }
   }
 }
 
-inline Chain *Problem::chain( int seed )
+inline Chain *Problem::chain( int seed, FeatureGroup &group )
 {
   int lid;
 
@@ -297,7 +444,15 @@ inline Chain *Problem::chain( int seed )
   QLinkedList<ElemTrans *> currentChain;
   QLinkedList<int> conflicts;
 
-  std::vector< int > tmpsol( mSol.activeLabelIds );
+  // labels of the features moved along the chain, the other features keep their label from the solution
+  std::unordered_map< int, int > tmpsol;
+  auto tmpLabel = [this, &tmpsol]( int feat )
+  {
+    const auto it = tmpsol.find( feat );
+    return it != tmpsol.end() ? it->second : mSol.activeLabelIds[feat];
+  };
+
+  PalRtree< LabelPosition > &activeCandidatesIndex = *group.activeCandidatesIndex;
 
   LabelPosition *lp = nullptr;
 
@@ -313,18 +468,20 @@ inline Chain *Problem::chain( int seed )
     next_seed = -1;
     retainedLabel = -2;
 
+    const int seedLabel = tmpLabel( seed );
+
     // sol[seed] is ejected
-    if ( tmpsol[seed] == -1 )
+    if ( seedLabel == -1 )
       delta -= mInactiveCost[seed];
     else
-      delta -= mLabelPositions.at( tmpsol[seed] )->cost();
+      delta -= mLabelPositions.at( seedLabel )->cost();
 
     for ( int i = -1; i < seedNbLp; i++ )
     {
       try
       {
         // Skip active label !
-        if ( !( tmpsol[seed] == -1 && i == -1 ) && i + mFeatStartId[seed] != tmpsol[seed] )
+        if ( !( seedLabel == -1 && i == -1 ) && i + mFeatStartId[seed] != seedLabel )
         {
           if ( i != -1 ) // new_label
           {
@@ -336,7 +493,7 @@ inline Chain *Problem::chain( int seed )
             // evaluate conflicts graph in solution after moving seed's label
 
             lp->getBoundingBox( amin, amax );
-            mActiveCandidatesIndex.intersects( QgsRectangle( amin[0], amin[1], amax[0], amax[1] ), [lp, &delta_tmp, &conflicts, &currentChain, this]( const LabelPosition * lp2 ) -> bool
+            activeCandidatesIndex.intersects( QgsRectangle( amin[0], amin[1], amax[0], amax[1] ), [lp, &delta_tmp, &conflicts, &currentChain, this]( const LabelPosition * lp2 ) -> bool
             {
               if ( lp2->isInConflict( lp ) )
               {
@@ -360,7 +517,6 @@ inline Chain *Problem::chain( int seed )
               }
               return true;
             } );
-
             // no conflict -> end of chain
             if ( conflicts.isEmpty() )
             {
@@ -518,18 +674,18 @@ inline Chain *Problem::chain( int seed )
     {
       ElemTrans *et = new ElemTrans();
       et->feat  = seed;
-      et->old_label = tmpsol[seed];
+      et->old_label = seedLabel;
       et->new_label = retainedLabel;
       currentChain.append( et );
 
       if ( et->old_label != -1 )
       {
-        mLabelPositions.at( et->old_label )->removeFromIndex( mActiveCandidatesIndex );
+        mLabelPositions.at( et->old_label )->removeFromIndex( activeCandidatesIndex );
       }
 
       if ( et->new_label != -1 )
       {
-        mLabelPositions.at( et->new_label )->insertIntoIndex( mActiveCandidatesIndex );
+        mLabelPositions.at( et->new_label )->insertIntoIndex( activeCandidatesIndex );
       }
 
 
@@ -546,12 +702,12 @@ inline Chain *Problem::chain( int seed )
 
     if ( et->new_label != -1 )
     {
-      mLabelPositions.at( et->new_label )->removeFromIndex( mActiveCandidatesIndex );
+      mLabelPositions.at( et->new_label )->removeFromIndex( activeCandidatesIndex );
     }
 
     if ( et->old_label != -1 )
     {
-      mLabelPositions.at( et->old_label )->insertIntoIndex( mActiveCandidatesIndex );
+      mLabelPositions.at( et->old_label )->insertIntoIndex( activeCandidatesIndex );
     }
   }
 
@@ -564,22 +720,56 @@ void Problem::chain_search()
   if ( mFeatureCount == 0 )
     return;
 
+  mSol.init( mFeatureCount );
+
+  std::vector< FeatureGroup > groups = pal->solveConflictsInParallel() ? conflictFeatureGroups() : singleFeatureGroup();
+  prepareFeatureGroups( groups );
+
+  if ( groups.size() > 1 )
+  {
+    // groups are independent, they can be solved concurrently. The solution only depends on
+    // the groups, not on the order in which they are solved.
+    QtConcurrent::blockingMap( groups, [this]( FeatureGroup & group )
+    {
+      try
+      {
+        chain_search( group );
+      }
+      catch ( InternalException::Empty & )
+      {
+      }
+    } );
+  }
+  else
+  {
+    chain_search( groups.front() );
+  }
+
+  mSol.totalCost = 0;
+  for ( const FeatureGroup &group : groups )
+    mSol.totalCost += group.totalCost;
+}
+
+void Problem::chain_search( FeatureGroup &group )
+{
+  const int featureCount = static_cast< int >( group.features.size() );
+  if ( featureCount == 0 )
+    return;
+
   int i;
   int seed;
-  bool *ok = new bool[mFeatureCount];
+  std::vector< bool > ok( featureCount, false );
   int fid;
   int lid;
   int popit = 0;
 
   Chain *retainedChain = nullptr;
 
-  std::fill( ok, ok + mFeatureCount, false );
-
   //initialization();
-  init_sol_falp();
+  init_sol_falp( group );
 
   //check_solution();
-  solution_cost();
+  group.totalCost = solution_cost( group );
 
   int iter = 0;
 
@@ -591,9 +781,9 @@ void Problem::chain_search()
 
     //check_solution();
 
-    for ( seed = ( iter + 1 ) % mFeatureCount;
+    for ( seed = ( iter + 1 ) % featureCount;
           ok[seed] && seed != iter;
-          seed = ( seed + 1 ) % mFeatureCount )
+          seed = ( seed + 1 ) % featureCount )
       ;
 
     // All seeds are OK
@@ -602,8 +792,8 @@ void Problem::chain_search()
       break;
     }
 
-    iter = ( iter + 1 ) % mFeatureCount;
-    retainedChain = chain( seed );
+    iter = ( iter + 1 ) % featureCount;
+    retainedChain = chain( group.features[seed], group );
 
     if ( retainedChain && retainedChain->delta < - EPSILON )
     {
@@ -616,13 +806,13 @@ void Problem::chain_search()
         if ( mSol.activeLabelIds[fid] >= 0 )
         {
           LabelPosition *old = mLabelPositions[ mSol.activeLabelIds[fid] ].get();
-          old->removeFromIndex( mActiveCandidatesIndex );
+          old->removeFromIndex( *group.activeCandidatesIndex );
           old->getBoundingBox( amin, amax );
-          mAllCandidatesIndex.intersects( QgsRectangle( amin[0], amin[1], amax[0], amax[1] ), [&ok, old]( const LabelPosition * lp ) ->bool
+          mAllCandidatesIndex.intersects( QgsRectangle( amin[0], amin[1], amax[0], amax[1] ), [this, &ok, &group, old]( const LabelPosition * lp ) ->bool
           {
-            if ( old->isInConflict( lp ) )
+            if ( isInGroup( group, lp ) && old->isInConflict( lp ) )
             {
-              ok[lp->getProblemFeatureId()] = false;
+              ok[ mFeaturePositionInGroup[ lp->getProblemFeatureId() ] ] = false;
             }
 
             return true;
@@ -633,12 +823,12 @@ void Problem::chain_search()
 
         if ( mSol.activeLabelIds[fid] >= 0 )
         {
-          mLabelPositions.at( lid )->insertIntoIndex( mActiveCandidatesIndex );
+          mLabelPositions.at( lid )->insertIntoIndex( *group.activeCandidatesIndex );
         }
 
-        ok[fid] = false;
+        ok[ mFeaturePositionInGroup[fid] ] = false;
       }
-      mSol.totalCost += retainedChain->delta;
+      group.totalCost += retainedChain->delta;
     }
     else
     {
@@ -650,8 +840,7 @@ void Problem::chain_search()
     popit++;
   }
 
-  solution_cost();
-  delete[] ok;
+  group.totalCost = solution_cost( group );
 }
 
 QList<LabelPosition *> Problem::getSolution( bool returnInactive, QList<LabelPosition *> *unlabeled )
@@ -695,37 +884,38 @@ QList<LabelPosition *> Problem::getSolution( bool returnInactive, QList<LabelPos
   return finalLabelPlacements;
 }
 
-void Problem::solution_cost()
+double Problem::solution_cost( const FeatureGroup &group )
 {
-  mSol.totalCost = 0.0;
+  double totalCost = 0.0;
 
   LabelPosition *lp = nullptr;
 
   double amin[2];
   double amax[2];
 
-  for ( std::size_t i = 0; i < mFeatureCount; i++ )
+  for ( int i : group.features )
   {
     if ( mSol.activeLabelIds[i] == -1 )
     {
-      mSol.totalCost += mInactiveCost[i];
+      totalCost += mInactiveCost[i];
     }
     else
     {
       lp = mLabelPositions[ mSol.activeLabelIds[i] ].get();
 
       lp->getBoundingBox( amin, amax );
-      mActiveCandidatesIndex.intersects( QgsRectangle( amin[0], amin[1], amax[0], amax[1] ), [&lp, this]( const LabelPosition * lp2 )->bool
+      group.activeCandidatesIndex->intersects( QgsRectangle( amin[0], amin[1], amax[0], amax[1] ), [&lp, &totalCost, this]( const LabelPosition * lp2 )->bool
       {
         if ( lp->isInConflict( lp2 ) )
         {
-          mSol.totalCost += mInactiveCost[lp2->getProblemFeatureId()] + lp2->cost();
+          totalCost += mInactiveCost[lp2->getProblemFeatureId()] + lp2->cost();
         }
 
         return true;
       } );
 
-      mSol.totalCost += lp->cost();
+      totalCost += lp->cost();
     }
   }
+  return totalCost;
 }
@@ -37,6 +37,7 @@
 #include <list>
 #include <QList>
 #include "palrtree.h"
+#include "qgsrectangle.h"
 #include <memory>
 #include <vector>
 
@@ -114,6 +115,12 @@ namespace pal
 
       /**
        * \brief Test with very-large scale neighborhood
+       *
+       * If the pal object is set to solve conflicts in parallel, the features are split into
+       * groups which do not have any conflicting candidates between them, and the groups are
+       * solved concurrently.
+       *
+       * \see Pal::setSolveConflictsInParallel()
        */
       void chain_search();
 
@@ -219,11 +226,77 @@ namespace pal
       Sol mSol;
       double mNbOverlap = 0.0;
 
-      Chain *chain( int seed );
+      /**
+       * A group of features which is solved independently of the other groups: none of
+       * its candidates conflicts with the candidates of features from other groups.
+       */
+      struct FeatureGroup
+      {
+        //! Index of the group
+        int index = 0;
+
+        //! Problem ids of the features, in increasing order
+        std::vector< int > features;
+
+        //! Ids of the active candidates of the features, in feature order
+        std::vector< int > candidates;
+
+        //! Index of the active labels of the group
+        PalRtree< LabelPosition > *activeCandidatesIndex = nullptr;
+
+        //! Owned index of the active labels, when the group does not use the problem's index
+        std::unique_ptr< PalRtree< LabelPosition > > ownedActiveCandidatesIndex;
+
+        //! Cost of the solution for the features of the group
+        double totalCost = 0;
+      };
+
+      //! Extent of the problem, used for the indexes of the feature groups
+      QgsRectangle mExtent;
+
+      //! Index of the group of each feature
+      std::vector< int > mFeatureGroup;
+
+      //! Position of each feature within its group
+      std::vector< int > mFeaturePositionInGroup;
+
+      //! Position of the first candidate of each feature within the candidates of its group
+      std::vector< int > mFeatureCandidatesStartInGroup;
+
+      /**
+       * Returns a single group containing all the features of the problem.
+       */
+      std::vector< FeatureGroup > singleFeatureGroup();
+
+      /**
+       * Splits the features into groups of connected components of the graph of overlapping
+       * candidates. Small components are merged together (in feature order, so that the groups
+       * only depend on the problem) to avoid spawning tasks which are not worth it.
+       */
+      std::vector< FeatureGroup > conflictFeatureGroups();
+
+      //! Assigns the features to the \a groups and sets up the candidates of the groups
+      void prepareFeatureGroups( std::vector< FeatureGroup > &groups );
+
+      /**
+       * Returns the position of the candidate \a lp within the candidates of \a group, or -1
+       * if the candidate does not belong to an active candidate of the group.
+       */
+      int groupCandidateKey( const FeatureGroup &group, const LabelPosition *lp ) const;
+
+      //! Returns TRUE if the candidate \a lp belongs to a feature of \a group
+      bool isInGroup( const FeatureGroup &group, const LabelPosition *lp ) const;
+
+      void init_sol_falp( FeatureGroup &group );
+
+      void chain_search( FeatureGroup &group );
+
+      Chain *chain( int seed, FeatureGroup &group );
 
       Pal *pal = nullptr;
 
-      void solution_cost();
+      //! Returns the cost of the current solution for the features of \a group
+      double solution_cost( const FeatureGroup &group );
   };
 
 } // namespace
@@ -18,6 +18,7 @@
 #include "qgsprocessingmodelalgorithm.h"
 #include "qgsprocessingregistry.h"
 #include "qgsprocessingfeedback.h"
+#include "qgsprocessingfeaturepipe.h"
 #include "qgsprocessingutils.h"
 #include "qgis.h"
 #include "qgsxmlutils.h"
@@ -31,6 +32,7 @@
 
 #include <QFile>
 #include <QTextStream>
+#include <QUuid>
 
 ///@cond NOT_STABLE
 
@@ -231,6 +233,64 @@ QVariantMap QgsProcessingModelAlgorithm::parametersForChildAlgorithm( const QgsP
   return childParams;
 }
 
+QString QgsProcessingModelAlgorithm::streamedOutputConsumer( const QString &childId ) const
+{
+  QMap< QString, QgsProcessingModelChildAlgorithm >::const_iterator producerIt = mChildAlgorithms.constFind( childId );
+  if ( producerIt == mChildAlgorithms.constEnd() || !dynamic_cast< const QgsProcessingFeatureBasedAlgorithm * >( producerIt->algorithm() )
+       || !producerIt->modelOutputs().isEmpty() )
+    return QString();
+
+  QString consumerId;
+  QString consumerParameter;
+  QMap< QString, QgsProcessingModelChildAlgorithm >::const_iterator childIt = mChildAlgorithms.constBegin();
+  for ( ; childIt != mChildAlgorithms.constEnd(); ++childIt )
+  {
+    if ( childIt->childId() == childId || !childIt->isActive() )
+      continue;
+
+    const QList< QgsProcessingModelChildDependency > dependencies = childIt->dependencies();
+    for ( const QgsProcessingModelChildDependency &dependency : dependencies )
+    {
+      // algorithms explicitly depending on this one expect it to have completed
+      if ( dependency.childId == childId )
+        return QString();
+    }
+
+    const QMap<QString, QgsProcessingModelChildParameterSources> childParams = childIt->parameterSources();
+    QMap<QString, QgsProcessingModelChildParameterSources>::const_iterator paramIt = childParams.constBegin();
+    for ( ; paramIt != childParams.constEnd(); ++paramIt )
+    {
+      for ( const QgsProcessingModelChildParameterSource &source : paramIt.value() )
+      {
+        if ( source.source() != QgsProcessingModelChildParameterSource::ChildOutput || source.outputChildId() != childId )
+          continue;
+
+        // only a single use of the output, on its own, can be streamed
+        if ( !consumerId.isEmpty() || paramIt.value().size() > 1 )
+          return QString();
+
+        consumerId = childIt->childId();
+        consumerParameter = paramIt.key();
+      }
+    }
+  }
+
+  if ( consumerId.isEmpty() )
+    return QString();
+
+  const QgsProcessingAlgorithm *consumer = mChildAlgorithms.constFind( consumerId )->algorithm();
+  if ( !consumer || !( consumer->flags() & QgsProcessingAlgorithm::FlagSupportsStreamedInput ) )
+    return QString();
+
+  // the consumer only reads its main input once
+  const QgsProcessingFeatureBasedAlgorithm *featureBasedConsumer = dynamic_cast< const QgsProcessingFeatureBasedAlgorithm * >( consumer );
+  const QString inputParameter = featureBasedConsumer ? featureBasedConsumer->inputParameterName() : QStringLiteral( "INPUT" );
+  if ( consumerParameter != inputParameter )
+    return QString();
+
+  return consumerId;
+}
+
 bool QgsProcessingModelAlgorithm::childOutputIsRequired( const QString &childId, const QString &outputName ) const
 {
   // look through all child algs
@@ -260,6 +320,98 @@ bool QgsProcessingModelAlgorithm::childOutputIsRequired( const QString &childId,
   return false;
 }
 
+///@cond PRIVATE
+
+/**
+ * Owns the feature pipes created while running a model, and keeps them
+ * registered in the context until the child algorithms consuming them have run.
+ */
+class QgsProcessingModelFeaturePipes
+{
+  public:
+
+    explicit QgsProcessingModelFeaturePipes( QgsProcessingContext &context )
+      : mContext( context )
+    {}
+
+    ~QgsProcessingModelFeaturePipes()
+    {
+      // pipes are fed by the pipes created before them, so they are destroyed in reverse order
+      while ( !mPipes.empty() )
+      {
+        mContext.removeFeaturePipe( mPipes.back().id );
+        mPipes.pop_back();
+      }
+    }
+
+    /**
+     * Registers a \a pipe streaming the output of the child algorithm \a childId to the
+     * child algorithm \a consumerId, and returns the id the pipe is registered under.
+     */
+    QString add( const QString &childId, const QString &consumerId, std::unique_ptr< QgsProcessingFeaturePipe > pipe )
+    {
+      Pipe entry;
+      entry.id = QStringLiteral( "pipe:%1" ).arg( QUuid::createUuid().toString() );
+      entry.childId = childId;
+      entry.consumerId = consumerId;
+      entry.pipe = std::move( pipe );
+      mContext.addFeaturePipe( entry.id, entry.pipe.get() );
+      mPipes.emplace_back( std::move( entry ) );
+      return mPipes.back().id;
+    }
+
+    /**
+     * Post processes and removes the pipes read by the child algorithm \a consumerId once it
+     * has run, along with the pipes feeding them. Returns the results of the child algorithms
+     * of these pipes, by child ID.
+     */
+    QMap< QString, QVariantMap > finish( const QString &consumerId, QgsProcessingFeedback *feedback )
+    {
+      QMap< QString, QVariantMap > results;
+      QString consumer = consumerId;
+      // each child algorithm reads at most one pipe, which may itself read a pipe created before it
+      for ( int i = static_cast< int >( mPipes.size() ) - 1; i >= 0; --i )
+      {
+        if ( mPipes[i].consumerId != consumer )
+          continue;
+
+        QVariantMap pipeResults = mPipes[i].pipe->postProcess( mContext, feedback );
+        // the streamed features were consumed, there is no layer to refer to
+        pipeResults.remove( QStringLiteral( "OUTPUT" ) );
+        results.insert( mPipes[i].childId, pipeResults );
+
+        consumer = mPipes[i].childId;
+        mContext.removeFeaturePipe( mPipes[i].id );
+        mPipes.erase( mPipes.begin() + i );
+      }
+      return results;
+    }
+
+    //! Returns the IDs of the child algorithms whose pipes were not consumed
+    QStringList childIds() const
+    {
+      QStringList ids;
+      for ( const Pipe &pipe : mPipes )
+        ids << pipe.childId;
+      return ids;
+    }
+
+  private:
+
+    struct Pipe
+    {
+      QString id;
+      QString childId;
+      QString consumerId;
+      std::unique_ptr< QgsProcessingFeaturePipe > pipe;
+    };
+
+    QgsProcessingContext &mContext;
+    std::vector< Pipe > mPipes;
+};
+
+///@endcond
+
 QVariantMap QgsProcessingModelAlgorithm::processAlgorithm( const QVariantMap &parameters, QgsProcessingContext &context, QgsProcessingFeedback *feedback )
 {
   QSet< QString > toExecute;
@@ -290,6 +442,9 @@ QVariantMap QgsProcessingModelAlgorithm::processAlgorithm( const QVariantMap &pa
 
   const bool verboseLog = parameterAsBool( parameters, QStringLiteral( "VERBOSE_LOG" ), context );
 
+  const bool streamOutputs = context.flags() & QgsProcessingContext::StreamModelChildOutputs;
+  QgsProcessingModelFeaturePipes pipes( context );
+
   QVariantMap finalResults;
   QSet< QString > executed;
   bool executedAlg = true;
@@ -354,7 +509,33 @@ QVariantMap QgsProcessingModelAlgorithm::processAlgorithm( const QVariantMap &pa
       childTime.start();
 
       bool ok = false;
-      QVariantMap results = childAlg->run( childParams, context, &modelFeedback, &ok, child.configuration() );
+      QVariantMap results;
+      const QString consumerId = streamOutputs ? streamedOutputConsumer( childId ) : QString();
+      if ( !consumerId.isEmpty() )
+      {
+        // the features of the child algorithm are only processed when the consuming child
+        // algorithm fetches them, so that no intermediate layer is created
+        std::unique_ptr< QgsProcessingFeatureBasedAlgorithm > producer( static_cast< QgsProcessingFeatureBasedAlgorithm * >( childAlg->create( child.configuration() ) ) );
+        if ( producer->prepare( childParams, context, &modelFeedback ) )
+        {
+          try
+          {
+            // the pipe is only referred to by the consumer's parameters, and the results of the
+            // child algorithm are replaced once the consumer has run
+            results.insert( QStringLiteral( "OUTPUT" ), pipes.add( childId, consumerId, qgis::make_unique< QgsProcessingFeaturePipe >( std::move( producer ), childParams, context, &modelFeedback ) ) );
+            ok = true;
+          }
+          catch ( QgsProcessingException &e )
+          {
+            QgsMessageLog::logMessage( e.what(), QObject::tr( "Processing" ), Qgis::Critical );
+            modelFeedback.reportError( e.what() );
+          }
+        }
+      }
+      else
+      {
+        results = childAlg->run( childParams, context, &modelFeedback, &ok, child.configuration() );
+      }
       if ( !ok )
       {
         const QString error = ( childAlg->flags() & QgsProcessingAlgorithm::FlagCustomException ) ? QString() : QObject::tr( "Error encountered while running %1" ).arg( child.description() );
@@ -362,6 +543,15 @@ QVariantMap QgsProcessingModelAlgorithm::processAlgorithm( const QVariantMap &pa
       }
       childResults.insert( childId, results );
 
+      if ( consumerId.isEmpty() )
+      {
+        // the features streamed to this child algorithm have all been processed, so the
+        // streamed child algorithms can be post processed
+        const QMap< QString, QVariantMap > streamedResults = pipes.finish( childId, &modelFeedback );
+        for ( auto streamedIt = streamedResults.constBegin(); streamedIt != streamedResults.constEnd(); ++streamedIt )
+          childResults.insert( streamedIt.key(), streamedIt.value() );
+      }
+
       // look through child alg's outputs to determine whether any of these should be copied
       // to the final model outputs
       QMap<QString, QgsProcessingModelOutput> outputs = child.modelOutputs();
@@ -449,6 +639,15 @@ QVariantMap QgsProcessingModelAlgorithm::processAlgorithm( const QVariantMap &pa
   if ( feedback )
     feedback->pushDebugInfo( QObject::tr( "Model processed OK. Executed %1 algorithms total in %2 s." ).arg( executed.count() ).arg( totalTime.elapsed() / 1000.0 ) );
 
+  // pipes whose consumer never ran are destroyed along with the model run, don't refer to them
+  const QStringList unconsumed = pipes.childIds();
+  for ( const QString &childId : unconsumed )
+  {
+    QVariantMap results = childResults.value( childId ).toMap();
+    results.remove( QStringLiteral( "OUTPUT" ) );
+    childResults.insert( childId, results );
+  }
+
   mResults = finalResults;
   mResults.insert( QStringLiteral( "CHILD_RESULTS" ), childResults );
   mResults.insert( QStringLiteral( "CHILD_INPUTS" ), childInputs );
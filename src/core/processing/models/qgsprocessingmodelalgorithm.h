@@ -547,6 +547,17 @@ class CORE_EXPORT QgsProcessingModelAlgorithm : public QgsProcessingAlgorithm
      */
     bool childOutputIsRequired( const QString &childId, const QString &outputName ) const;
 
+    /**
+     * Returns the ID of the child algorithm which the features output by the child
+     * algorithm with matching \a childId can be streamed to, or an empty string if
+     * the output has to be written to a layer.
+     *
+     * Outputs of feature based algorithms are streamed when they are only used as the
+     * main input of a single child algorithm supporting streamed inputs, and are not
+     * model outputs.
+     */
+    QString streamedOutputConsumer( const QString &childId ) const;
+
     /**
      * Checks whether the output vector type given by \a outputType is compatible
      * with the list of acceptable data types specified by \a acceptableDataTypes.
@@ -30,6 +30,11 @@
 #include "qgsmeshlayer.h"
 #include "qgsexpressioncontextutils.h"
 
+#include <QMutex>
+#include <QSemaphore>
+#include <QThreadPool>
+#include <QtConcurrent>
+
 
 QgsProcessingAlgorithm::~QgsProcessingAlgorithm()
 {
@@ -1002,25 +1007,44 @@ QVariantMap QgsProcessingFeatureBasedAlgorithm::processAlgorithm( const QVariant
 
   long count = mSource->featureCount();
 
-  QgsFeature f;
-  QgsFeatureIterator it = mSource->getFeatures( request(), sourceFlags() );
+  const int threads = ( flags() & QgsProcessingAlgorithm::FlagSupportsParallelFeatureProcessing ) ? context.maximumThreads() : 1;
+
+  // sources which can be read concurrently are split into partitions, each one read by its own
+  // thread. The partitions come in no particular order, so this is only done for unordered output
+  QList< QgsFeatureRequest > partitions;
+  if ( threads > 1 && ( context.flags() & QgsProcessingContext::AllowUnorderedFeatures ) )
+    partitions = mSource->partitionRequest( request(), threads );
 
-  double step = count > 0 ? 100.0 / count : 1;
-  int current = 0;
-  while ( it.nextFeature( f ) )
+  if ( partitions.size() > 1 )
+  {
+    processPartitionsInParallel( partitions, sink.get(), count, context, feedback );
+  }
+  else if ( threads > 1 )
+  {
+    QgsFeatureIterator it = mSource->getFeatures( request(), sourceFlags() );
+    processFeaturesInParallel( it, sink.get(), count, threads, context, feedback );
+  }
+  else
   {
-    if ( feedback->isCanceled() )
+    QgsFeature f;
+    QgsFeatureIterator it = mSource->getFeatures( request(), sourceFlags() );
+    double step = count > 0 ? 100.0 / count : 1;
+    int current = 0;
+    while ( it.nextFeature( f ) )
     {
-      break;
-    }
+      if ( feedback->isCanceled() )
+      {
+        break;
+      }
 
-    context.expressionContext().setFeature( f );
-    const QgsFeatureList transformed = processFeature( f, context, feedback );
-    for ( QgsFeature transformedFeature : transformed )
-      sink->addFeature( transformedFeature, QgsFeatureSink::FastInsert );
+      context.expressionContext().setFeature( f );
+      const QgsFeatureList transformed = processFeature( f, context, feedback );
+      for ( QgsFeature transformedFeature : transformed )
+        sink->addFeature( transformedFeature, QgsFeatureSink::FastInsert );
 
-    feedback->setProgress( current * step );
-    current++;
+      feedback->setProgress( current * step );
+      current++;
+    }
   }
 
   mSource.reset();
@@ -1033,6 +1057,310 @@ QVariantMap QgsProcessingFeatureBasedAlgorithm::processAlgorithm( const QVariant
   return outputs;
 }
 
+///@cond PRIVATE
+
+/**
+ * A batch of consecutive features processed by one worker thread, together
+ * with the context and feedback of the worker. Slots are reused for the
+ * following batches once their results have been written.
+ */
+struct QgsProcessingFeatureBatch
+{
+  std::unique_ptr< QgsProcessingContext > context;
+  QgsProcessingBufferedFeedback feedback;
+  QVector< QgsFeature > features;
+  QVector< QgsFeatureList > results;
+  QString error;
+  long long sequence = 0;
+};
+
+///@endcond
+
+std::vector< std::unique_ptr< QgsProcessingFeatureBatch > > QgsProcessingFeatureBasedAlgorithm::createFeatureBatches( int count, QgsProcessingContext &context, QgsProcessingFeedback *feedback ) const
+{
+  std::vector< std::unique_ptr< QgsProcessingFeatureBatch > > batches;
+  batches.reserve( count );
+  for ( int i = 0; i < count; ++i )
+  {
+    std::unique_ptr< QgsProcessingFeatureBatch > batch = qgis::make_unique< QgsProcessingFeatureBatch >();
+    batch->context = qgis::make_unique< QgsProcessingContext >();
+    batch->context->copyThreadSafeSettings( context );
+    batch->context->setFeedback( &batch->feedback );
+    // processFeature() implementations check the feedback they are given, so it must be canceled with the algorithm
+    if ( feedback )
+    {
+      if ( feedback->isCanceled() )
+        batch->feedback.cancel();
+      QObject::connect( feedback, &QgsFeedback::canceled, &batch->feedback, &QgsFeedback::cancel, Qt::DirectConnection );
+    }
+    batches.emplace_back( std::move( batch ) );
+  }
+  return batches;
+}
+
+void QgsProcessingFeatureBasedAlgorithm::processFeatureBatch( QgsProcessingFeatureBatch *batch, QgsProcessingFeedback *feedback )
+{
+  batch->results.reserve( batch->features.size() );
+  try
+  {
+    for ( const QgsFeature &feature : qgis::as_const( batch->features ) )
+    {
+      if ( feedback->isCanceled() )
+        break;
+
+      batch->context->expressionContext().setFeature( feature );
+      batch->results << processFeature( feature, *batch->context, &batch->feedback );
+    }
+  }
+  catch ( QgsException &e )
+  {
+    batch->error = e.what();
+  }
+  catch ( ... )
+  {
+    batch->error = QObject::tr( "An unexpected error occurred while processing features" );
+  }
+}
+
+void QgsProcessingFeatureBasedAlgorithm::writeFeatureBatch( QgsProcessingFeatureBatch *batch, QgsFeatureSink *sink, QgsProcessingFeedback *feedback, QString &error )
+{
+  batch->feedback.flush( feedback );
+  for ( QgsFeatureList &transformed : batch->results )
+  {
+    for ( QgsFeature &transformedFeature : transformed )
+      sink->addFeature( transformedFeature, QgsFeatureSink::FastInsert );
+  }
+  if ( error.isEmpty() )
+    error = batch->error;
+
+  batch->features.clear();
+  batch->results.clear();
+  batch->error.clear();
+}
+
+void QgsProcessingFeatureBasedAlgorithm::processFeaturesInParallel( QgsFeatureIterator &iterator, QgsFeatureSink *sink, long count, int threads,
+    QgsProcessingContext &context, QgsProcessingFeedback *feedback )
+{
+  // Features are read and written from this thread, while worker threads run
+  // processFeature() on batches of them. A dedicated pool is used, so that
+  // workers cannot be starved by the thread running the algorithm itself.
+  const int batchSize = 100;
+
+  // Having twice as many batches as threads lets the workers go on while
+  // results are written
+  std::vector< std::unique_ptr< QgsProcessingFeatureBatch > > batches = createFeatureBatches( 2 * threads, context, feedback );
+  QList< QgsProcessingFeatureBatch * > freeBatches;
+  for ( const std::unique_ptr< QgsProcessingFeatureBatch > &batch : batches )
+    freeBatches << batch.get();
+
+  QMutex finishedMutex;
+  QList< QgsProcessingFeatureBatch * > finishedBatches;
+  QSemaphore finishedSemaphore;
+
+  const bool ordered = !( context.flags() & QgsProcessingContext::AllowUnorderedFeatures );
+  // Batches finished before earlier ones, kept until their turn comes to be written
+  QMap< long long, QgsProcessingFeatureBatch * > pendingBatches;
+  long long nextSequenceToRead = 0;
+  long long nextSequenceToWrite = 0;
+  int running = 0;
+  bool sourceExhausted = false;
+  QString error;
+
+  const double step = count > 0 ? 100.0 / count : 1;
+  long long current = 0;
+
+  // Declared last, so that it waits for the workers before anything they use is destroyed
+  QThreadPool pool;
+  pool.setMaxThreadCount( threads );
+
+  auto writeBatch = [ & ]( QgsProcessingFeatureBatch * batch )
+  {
+    current += batch->features.size();
+    writeFeatureBatch( batch, sink, feedback, error );
+    feedback->setProgress( current * step );
+    freeBatches << batch;
+  };
+
+  while ( true )
+  {
+    // Start new batches as long as there are features and free slots
+    while ( !sourceExhausted && error.isEmpty() && !feedback->isCanceled() && !freeBatches.isEmpty() )
+    {
+      QgsProcessingFeatureBatch *batch = freeBatches.takeFirst();
+      batch->features.reserve( batchSize );
+      QgsFeature f;
+      while ( batch->features.size() < batchSize && iterator.nextFeature( f ) )
+        batch->features << f;
+      if ( batch->features.size() < batchSize )
+        sourceExhausted = true;
+      if ( batch->features.isEmpty() )
+      {
+        freeBatches << batch;
+        break;
+      }
+
+      batch->sequence = nextSequenceToRead++;
+      running++;
+      QtConcurrent::run( &pool, [ &, batch ]
+      {
+        processFeatureBatch( batch, feedback );
+
+        QMutexLocker locker( &finishedMutex );
+        finishedBatches << batch;
+        finishedSemaphore.release();
+      } );
+    }
+
+    if ( running == 0 )
+      break;
+
+    // Wait for a batch to be finished
+    finishedSemaphore.acquire();
+    QgsProcessingFeatureBatch *batch = nullptr;
+    {
+      QMutexLocker locker( &finishedMutex );
+      batch = finishedBatches.takeFirst();
+    }
+    running--;
+
+    if ( !ordered )
+    {
+      writeBatch( batch );
+      continue;
+    }
+
+    pendingBatches.insert( batch->sequence, batch );
+    while ( !pendingBatches.isEmpty() && pendingBatches.firstKey() == nextSequenceToWrite )
+    {
+      writeBatch( pendingBatches.take( nextSequenceToWrite ) );
+      nextSequenceToWrite++;
+    }
+  }
+
+  if ( !error.isEmpty() )
+    throw QgsProcessingException( error );
+}
+
+void QgsProcessingFeatureBasedAlgorithm::processPartitionsInParallel( const QList< QgsFeatureRequest > &partitions, QgsFeatureSink *sink, long count,
+    QgsProcessingContext &context, QgsProcessingFeedback *feedback )
+{
+  // Each partition is read and processed by its own worker thread, while the results
+  // are written from this thread. Workers take a free batch, fill it from their
+  // iterator, process it and hand it over to be written, until their partition
+  // is exhausted.
+  const int batchSize = 100;
+  const int threads = partitions.size();
+
+  // Iterators are created by the worker reading them, as some providers tie their connections
+  // to the thread which opened them. Creating them is serialized, the source is not thread safe.
+  QMutex sourceMutex;
+
+  // Two batches per worker let the workers go on while results are written
+  std::vector< std::unique_ptr< QgsProcessingFeatureBatch > > batches = createFeatureBatches( 2 * threads, context, feedback );
+
+  QMutex freeMutex;
+  QList< QgsProcessingFeatureBatch * > freeBatches;
+  for ( const std::unique_ptr< QgsProcessingFeatureBatch > &batch : batches )
+    freeBatches << batch.get();
+  QSemaphore freeSemaphore( freeBatches.size() );
+
+  // A null batch marks the end of a partition
+  QMutex finishedMutex;
+  QList< QgsProcessingFeatureBatch * > finishedBatches;
+  QSemaphore finishedSemaphore;
+
+  QAtomicInt stop( 0 );
+  QString error;
+
+  const double step = count > 0 ? 100.0 / count : 1;
+  long long current = 0;
+
+  // Declared last, so that it waits for the workers before anything they use is destroyed
+  QThreadPool pool;
+  pool.setMaxThreadCount( threads );
+
+  for ( int i = 0; i < threads; ++i )
+  {
+    QtConcurrent::run( &pool, [ &, i ]
+    {
+      QgsFeatureIterator iterator;
+      bool iteratorCreated = false;
+      bool exhausted = false;
+      while ( !exhausted && !stop.load() && !feedback->isCanceled() )
+      {
+        freeSemaphore.acquire();
+        QgsProcessingFeatureBatch *batch = nullptr;
+        {
+          QMutexLocker locker( &freeMutex );
+          batch = freeBatches.takeFirst();
+        }
+
+        batch->features.reserve( batchSize );
+        QgsFeature f;
+        try
+        {
+          if ( !iteratorCreated )
+          {
+            QMutexLocker sourceLocker( &sourceMutex );
+            iterator = mSource->getFeatures( partitions.at( i ), sourceFlags() );
+            iteratorCreated = true;
+          }
+          while ( batch->features.size() < batchSize && iterator.nextFeature( f ) )
+            batch->features << f;
+        }
+        catch ( QgsException &e )
+        {
+          batch->error = e.what();
+        }
+        exhausted = batch->features.size() < batchSize || !batch->error.isEmpty();
+
+        if ( batch->error.isEmpty() )
+          processFeatureBatch( batch, feedback );
+
+        QMutexLocker locker( &finishedMutex );
+        finishedBatches << batch;
+        finishedSemaphore.release();
+      }
+      iterator.close();
+
+      QMutexLocker locker( &finishedMutex );
+      finishedBatches << nullptr;
+      finishedSemaphore.release();
+    } );
+  }
+
+  int running = threads;
+  while ( running > 0 )
+  {
+    finishedSemaphore.acquire();
+    QgsProcessingFeatureBatch *batch = nullptr;
+    {
+      QMutexLocker locker( &finishedMutex );
+      batch = finishedBatches.takeFirst();
+    }
+    if ( !batch )
+    {
+      running--;
+      continue;
+    }
+
+    current += batch->features.size();
+    writeFeatureBatch( batch, sink, feedback, error );
+    feedback->setProgress( current * step );
+    if ( !error.isEmpty() )
+      stop.store( 1 );
+
+    {
+      QMutexLocker locker( &freeMutex );
+      freeBatches << batch;
+    }
+    freeSemaphore.release();
+  }
+
+  if ( !error.isEmpty() )
+    throw QgsProcessingException( error );
+}
+
 QgsFeatureRequest QgsProcessingFeatureBasedAlgorithm::request() const
 {
   return QgsFeatureRequest();
@@ -35,6 +35,9 @@ class QgsFeatureSink;
 class QgsProcessingModelAlgorithm;
 class QgsProcessingAlgorithmConfigurationWidget;
 class QgsMeshLayer;
+#ifndef SIP_RUN
+struct QgsProcessingFeatureBatch;
+#endif
 
 #ifdef SIP_RUN
 % ModuleHeaderCode
@@ -81,6 +84,8 @@ class CORE_EXPORT QgsProcessingAlgorithm
       FlagSkipGenericModelLogging = 1 << 12, //!< When running as part of a model, the generic algorithm setup and results logging should be skipped
       FlagNotAvailableInStandaloneTool = 1 << 13, //!< Algorithm should not be available from the standalone "qgis_process" tool. Used to flag algorithms which make no sense outside of the QGIS application, such as "select by..." style algorithms.
       FlagRequiresProject = 1 << 14, //!< The algorithm requires that a valid QgsProject is available from the processing context in order to execute
+      FlagSupportsParallelFeatureProcessing = 1 << 15, //!< QgsProcessingFeatureBasedAlgorithm::processFeature() is thread safe and may be called for several features at the same time, from different threads. Since QGIS 3.18
+      FlagSupportsStreamedInput = 1 << 16, //!< Algorithm fetches the features of its main input (the "INPUT" parameter, or the input of a QgsProcessingFeatureBasedAlgorithm) only once, so that a model may feed it directly with the features of a previous child algorithm instead of a temporary layer. Since QGIS 3.18
       FlagDeprecated = FlagHideFromToolbox | FlagHideFromModeler, //!< Algorithm is deprecated
     };
     Q_DECLARE_FLAGS( Flags, Flag )
@@ -1114,6 +1119,11 @@ class CORE_EXPORT QgsProcessingFeatureBasedAlgorithm : public QgsProcessingAlgor
      * prevent the algorithm execution from continuing. This can be annoying for users though as it
      * can break valid model execution - so use with extreme caution, and consider using
      * \a feedback to instead report non-fatal processing failures for features instead.
+     *
+     * If the algorithm's flags() include QgsProcessingAlgorithm::FlagSupportsParallelFeatureProcessing, this
+     * method may be called concurrently from several threads, each with its own \a context (which holds
+     * its own expression context) and \a feedback object. Implementations must then not modify any
+     * member of the algorithm.
      */
     virtual QgsFeatureList processFeature( const QgsFeature &feature, QgsProcessingContext &context, QgsProcessingFeedback *feedback ) SIP_THROW( QgsProcessingException ) = 0 SIP_VIRTUALERRORHANDLER( processing_exception_handler );
 
@@ -1250,6 +1260,33 @@ class CORE_EXPORT QgsProcessingFeatureBasedAlgorithm : public QgsProcessingAlgor
 
     std::unique_ptr< QgsProcessingFeatureSource > mSource;
 
+    /**
+     * Processes the features returned by \a iterator with several threads, and writes the
+     * resulting features to \a sink.
+     */
+    void processFeaturesInParallel( QgsFeatureIterator &iterator, QgsFeatureSink *sink, long count, int threads,
+                                    QgsProcessingContext &context, QgsProcessingFeedback *feedback );
+
+    /**
+     * Processes the features of the source matching the \a partitions requests, each one read and processed
+     * by its own thread, and writes the resulting features to \a sink in no particular order.
+     */
+    void processPartitionsInParallel( const QList< QgsFeatureRequest > &partitions, QgsFeatureSink *sink, long count,
+                                      QgsProcessingContext &context, QgsProcessingFeedback *feedback );
+
+    //! Creates \a count batches for worker threads, with contexts copied from \a context and feedbacks canceled with \a feedback
+    std::vector< std::unique_ptr< QgsProcessingFeatureBatch > > createFeatureBatches( int count, QgsProcessingContext &context, QgsProcessingFeedback *feedback ) const;
+
+    //! Runs processFeature() on the features of \a batch, stopping early if \a feedback is canceled
+    void processFeatureBatch( QgsProcessingFeatureBatch *batch, QgsProcessingFeedback *feedback );
+
+    //! Writes the results of \a batch to \a sink and clears it, keeping the first \a error
+    static void writeFeatureBatch( QgsProcessingFeatureBatch *batch, QgsFeatureSink *sink, QgsProcessingFeedback *feedback, QString &error );
+
+    friend class QgsProcessingFeaturePipe;
+    friend class QgsProcessingFeaturePipeIterator;
+    friend class QgsProcessingModelAlgorithm;
+
 };
 
 // clazy:excludeall=qstring-allocations
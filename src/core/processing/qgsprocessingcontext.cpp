@@ -20,9 +20,12 @@
 #include "qgsproviderregistry.h"
 #include "qgssettings.h"
 
+#include <QThreadPool>
+
 QgsProcessingContext::QgsProcessingContext()
   : mPreferredVectorFormat( QgsProcessingUtils::defaultVectorExtension() )
   , mPreferredRasterFormat( QgsProcessingUtils::defaultRasterExtension() )
+  , mMaximumThreads( QThreadPool::globalInstance()->maxThreadCount() )
 {
   auto callback = [ = ]( const QgsFeature & feature )
   {
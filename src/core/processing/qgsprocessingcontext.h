@@ -29,6 +29,7 @@
 #include "qgsprocessingutils.h"
 
 class QgsProcessingLayerPostProcessorInterface;
+class QgsFeatureSource;
 
 /**
  * \class QgsProcessingContext
@@ -48,6 +49,8 @@ class CORE_EXPORT QgsProcessingContext
     enum Flag
     {
       // UseSelectionIfPresent = 1 << 0,
+      AllowUnorderedFeatures = 1 << 1, //!< Algorithms which process features in parallel may write them in a different order from the one of their input. Since QGIS 3.18
+      StreamModelChildOutputs = 1 << 2, //!< Models pass the features of feature based child algorithms straight to the single child algorithm consuming them, instead of writing them to temporary layers. Since QGIS 3.18
     };
     Q_DECLARE_FLAGS( Flags, Flag )
 
@@ -84,6 +87,7 @@ class CORE_EXPORT QgsProcessingContext
       mEllipsoid = other.mEllipsoid;
       mDistanceUnit = other.mDistanceUnit;
       mAreaUnit = other.mAreaUnit;
+      mMaximumThreads = other.mMaximumThreads;
     }
 
     /**
@@ -625,6 +629,64 @@ class CORE_EXPORT QgsProcessingContext
      */
     void setPreferredRasterFormat( const QString &format ) { mPreferredRasterFormat = format; }
 
+    /**
+     * Returns the maximum number of threads which algorithms may use to process features.
+     *
+     * Only algorithms with the QgsProcessingAlgorithm::FlagSupportsParallelFeatureProcessing flag
+     * make use of more than one thread. By default, this is the maximum thread count of
+     * the global thread pool (see QgsApplication::maxThreads()).
+     *
+     * \see setMaximumThreads()
+     * \since QGIS 3.18
+     */
+    int maximumThreads() const { return mMaximumThreads; }
+
+    /**
+     * Sets the maximum number of \a threads which algorithms may use to process features.
+     *
+     * A value of 1 disables parallel processing.
+     *
+     * \see maximumThreads()
+     * \since QGIS 3.18
+     */
+    void setMaximumThreads( int threads ) { mMaximumThreads = threads; }
+
+#ifndef SIP_RUN
+
+    /**
+     * Registers a feature \a source under the specified \a id, so that parameters
+     * referring to this \a id are resolved to the \a source.
+     *
+     * This is used by models to stream features between child algorithms (see
+     * StreamModelChildOutputs). Ownership of \a source is not transferred, and it must be
+     * removed with removeFeaturePipe() before being deleted.
+     *
+     * \note Not available in Python bindings
+     * \see featurePipe()
+     * \since QGIS 3.18
+     */
+    void addFeaturePipe( const QString &id, QgsFeatureSource *source ) { mFeaturePipes.insert( id, source ); }
+
+    /**
+     * Removes the feature source registered under the specified \a id.
+     *
+     * \note Not available in Python bindings
+     * \see addFeaturePipe()
+     * \since QGIS 3.18
+     */
+    void removeFeaturePipe( const QString &id ) { mFeaturePipes.remove( id ); }
+
+    /**
+     * Returns the feature source registered under the specified \a id, or NULLPTR if
+     * no source matches the \a id.
+     *
+     * \note Not available in Python bindings
+     * \see addFeaturePipe()
+     * \since QGIS 3.18
+     */
+    QgsFeatureSource *featurePipe( const QString &id ) const { return mFeaturePipes.value( id ); }
+#endif
+
   private:
 
     QgsProcessingContext::Flags mFlags = QgsProcessingContext::Flags();
@@ -654,6 +716,10 @@ class CORE_EXPORT QgsProcessingContext
     QString mPreferredVectorFormat;
     QString mPreferredRasterFormat;
 
+    int mMaximumThreads = 1;
+
+    QMap< QString, QgsFeatureSource * > mFeaturePipes;
+
 #ifdef SIP_RUN
     QgsProcessingContext( const QgsProcessingContext &other );
 #endif
@@ -0,0 +1,234 @@
+/***************************************************************************
+                         qgsprocessingfeaturepipe.cpp
+                         ----------------------------
+    Date                 : October 2026
+    Copyright            : (C) 2026 by QGIS contributors
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qgsprocessingfeaturepipe.h"
+#include "qgsprocessingalgorithm.h"
+#include "qgsprocessingcontext.h"
+#include "qgsprocessingfeedback.h"
+#include "qgsprocessingutils.h"
+#include "qgsfeatureiterator.h"
+#include "qgscoordinatetransform.h"
+#include "qgsexception.h"
+#include "qgsmessagelog.h"
+
+///@cond PRIVATE
+
+/**
+ * Iterator over the features streamed by a QgsProcessingFeaturePipe.
+ *
+ * Features of the algorithm's input are processed one at a time, and the
+ * resulting features are handed out before the next input feature is fetched.
+ */
+class QgsProcessingFeaturePipeIterator : public QgsAbstractFeatureIterator
+{
+  public:
+
+    QgsProcessingFeaturePipeIterator( const QgsProcessingFeaturePipe *pipe, const QgsFeatureRequest &request )
+      : QgsAbstractFeatureIterator( request )
+      , mPipe( pipe )
+    {
+      if ( mRequest.destinationCrs().isValid() && mRequest.destinationCrs() != mPipe->mCrs )
+      {
+        mTransform = QgsCoordinateTransform( mPipe->mCrs, mRequest.destinationCrs(), mRequest.transformContext() );
+      }
+      try
+      {
+        mFilterRect = filterRectToSourceCrs( mTransform );
+      }
+      catch ( QgsCsException & )
+      {
+        // can't reproject mFilterRect
+        close();
+        return;
+      }
+
+      rewind();
+    }
+
+    ~QgsProcessingFeaturePipeIterator() override
+    {
+      close();
+    }
+
+    bool rewind() override
+    {
+      if ( mClosed )
+        return false;
+
+      mInput = mPipe->mInput->getFeatures( mPipe->mAlgorithm->request(), mPipe->mAlgorithm->sourceFlags() );
+      mPending.clear();
+      mPendingIndex = 0;
+      return true;
+    }
+
+    bool close() override
+    {
+      if ( mClosed )
+        return false;
+
+      mInput.close();
+      mPending.clear();
+      mClosed = true;
+      return true;
+    }
+
+  protected:
+
+    bool fetchFeature( QgsFeature &f ) override
+    {
+      f.setValid( false );
+
+      if ( mClosed )
+        return false;
+
+      while ( true )
+      {
+        while ( mPendingIndex < mPending.size() )
+        {
+          QgsFeature candidate = mPending.at( mPendingIndex++ );
+          // features keep the id of the input feature they were produced from, as they
+          // would when the algorithm edits a layer in place
+          candidate.setId( mPendingId );
+
+          if ( !mFilterRect.isNull() )
+          {
+            if ( !candidate.hasGeometry() )
+              continue;
+            if ( mRequest.flags() & QgsFeatureRequest::ExactIntersect ? !candidate.geometry().intersects( mFilterRect )
+                 : !candidate.geometry().boundingBoxIntersects( mFilterRect ) )
+              continue;
+          }
+          if ( mRequest.filterType() == QgsFeatureRequest::FilterFid && candidate.id() != mRequest.filterFid() )
+            continue;
+          if ( mRequest.filterType() == QgsFeatureRequest::FilterFids && !mRequest.filterFids().contains( candidate.id() ) )
+            continue;
+
+          if ( mRequest.flags() & QgsFeatureRequest::NoGeometry )
+            candidate.clearGeometry();
+          else
+            geometryToDestinationCrs( candidate, mTransform );
+
+          candidate.setFields( mPipe->mFields );
+          candidate.setValid( true );
+          f = candidate;
+          return true;
+        }
+
+        if ( mPipe->mFeedback && mPipe->mFeedback->isCanceled() )
+        {
+          close();
+          return false;
+        }
+
+        QgsFeature inputFeature;
+        if ( !mInput.nextFeature( inputFeature ) )
+        {
+          close();
+          return false;
+        }
+
+        mPipe->mContext->expressionContext().setFeature( inputFeature );
+        mPending = mPipe->mAlgorithm->processFeature( inputFeature, *mPipe->mContext, mPipe->mFeedback );
+        mPendingIndex = 0;
+        mPendingId = inputFeature.id();
+      }
+    }
+
+  private:
+
+    const QgsProcessingFeaturePipe *mPipe = nullptr;
+    QgsCoordinateTransform mTransform;
+    QgsRectangle mFilterRect;
+
+    QgsFeatureIterator mInput;
+    QgsFeatureList mPending;
+    int mPendingIndex = 0;
+    QgsFeatureId mPendingId = FID_NULL;
+};
+
+QgsProcessingFeaturePipe::QgsProcessingFeaturePipe( std::unique_ptr<QgsProcessingFeatureBasedAlgorithm> algorithm, const QVariantMap &parameters,
+    QgsProcessingContext &context, QgsProcessingFeedback *feedback )
+  : mAlgorithm( std::move( algorithm ) )
+  , mFeedback( feedback )
+{
+  mAlgorithm->prepareSource( parameters, context );
+  mInput = mAlgorithm->mSource.get();
+
+  mFields = mAlgorithm->outputFields( mInput->fields() );
+  mWkbType = mAlgorithm->outputWkbType( mInput->wkbType() );
+  mCrs = mAlgorithm->outputCrs( mInput->sourceCrs() );
+
+  // features are processed with the expression context the algorithm would have had when run
+  mContext = qgis::make_unique< QgsProcessingContext >();
+  mContext->copyThreadSafeSettings( context );
+  QgsExpressionContext expressionContext = context.expressionContext();
+  expressionContext.appendScopes( mAlgorithm->createExpressionContext( parameters, context, mInput ).takeScopes() );
+  mContext->setExpressionContext( expressionContext );
+}
+
+QgsProcessingFeaturePipe::~QgsProcessingFeaturePipe() = default;
+
+QgsFeatureIterator QgsProcessingFeaturePipe::getFeatures( const QgsFeatureRequest &request ) const
+{
+  return QgsFeatureIterator( new QgsProcessingFeaturePipeIterator( this, request ) );
+}
+
+QString QgsProcessingFeaturePipe::sourceName() const
+{
+  return mAlgorithm->displayName();
+}
+
+QgsCoordinateReferenceSystem QgsProcessingFeaturePipe::sourceCrs() const
+{
+  return mCrs;
+}
+
+QgsFields QgsProcessingFeaturePipe::fields() const
+{
+  return mFields;
+}
+
+QgsWkbTypes::Type QgsProcessingFeaturePipe::wkbType() const
+{
+  return mWkbType;
+}
+
+long QgsProcessingFeaturePipe::featureCount() const
+{
+  return mInput->featureCount();
+}
+
+QgsFeatureSource::SpatialIndexPresence QgsProcessingFeaturePipe::hasSpatialIndex() const
+{
+  return QgsFeatureSource::SpatialIndexNotPresent;
+}
+
+QVariantMap QgsProcessingFeaturePipe::postProcess( QgsProcessingContext &context, QgsProcessingFeedback *feedback )
+{
+  context.takeResultsFrom( *mContext );
+  try
+  {
+    return mAlgorithm->postProcessAlgorithm( context, feedback );
+  }
+  catch ( QgsProcessingException &e )
+  {
+    QgsMessageLog::logMessage( e.what(), QObject::tr( "Processing" ), Qgis::Critical );
+    feedback->reportError( e.what() );
+    return QVariantMap();
+  }
+}
+
+///@endcond
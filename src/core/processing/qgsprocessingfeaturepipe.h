@@ -0,0 +1,112 @@
+/***************************************************************************
+                         qgsprocessingfeaturepipe.h
+                         --------------------------
+    Date                 : October 2026
+    Copyright            : (C) 2026 by QGIS contributors
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef QGSPROCESSINGFEATUREPIPE_H
+#define QGSPROCESSINGFEATUREPIPE_H
+
+#define SIP_NO_FILE
+
+#include "qgis_core.h"
+#include "qgsfeaturesource.h"
+#include "qgsfields.h"
+#include "qgscoordinatereferencesystem.h"
+
+#include <QVariantMap>
+#include <memory>
+
+class QgsProcessingContext;
+class QgsProcessingFeatureBasedAlgorithm;
+class QgsProcessingFeatureSource;
+class QgsProcessingFeedback;
+
+///@cond PRIVATE
+
+/**
+ * \class QgsProcessingFeaturePipe
+ * \ingroup core
+ *
+ * A feature source streaming the output of a feature based algorithm.
+ *
+ * Instead of writing the output of the algorithm to a sink, the features of the
+ * algorithm's input are run through QgsProcessingFeatureBasedAlgorithm::processFeature()
+ * as the pipe's iterators fetch them. Models use pipes to chain feature based child
+ * algorithms without creating the intermediate layers.
+ *
+ * The input is processed again by each iteration over the pipe, so pipes are only
+ * meant to be read once, from the thread the model runs in.
+ *
+ * \note Not available in Python bindings
+ * \since QGIS 3.18
+ */
+class CORE_EXPORT QgsProcessingFeaturePipe : public QgsFeatureSource
+{
+  public:
+
+    /**
+     * Constructor for QgsProcessingFeaturePipe, for a prepared \a algorithm run with the
+     * specified \a parameters. The input source of the algorithm is loaded immediately.
+     *
+     * The \a context must exist for the lifetime of the pipe.
+     *
+     * \throws QgsProcessingException if the input source could not be loaded
+     */
+    QgsProcessingFeaturePipe( std::unique_ptr< QgsProcessingFeatureBasedAlgorithm > algorithm, const QVariantMap &parameters,
+                              QgsProcessingContext &context, QgsProcessingFeedback *feedback );
+
+    ~QgsProcessingFeaturePipe() override;
+
+    QgsFeatureIterator getFeatures( const QgsFeatureRequest &request = QgsFeatureRequest() ) const override;
+    QString sourceName() const override;
+    QgsCoordinateReferenceSystem sourceCrs() const override;
+    QgsFields fields() const override;
+    QgsWkbTypes::Type wkbType() const override;
+
+    /**
+     * Returns the number of features of the algorithm's input, which is only an estimate
+     * of the number of features streamed by the pipe.
+     */
+    long featureCount() const override;
+
+    SpatialIndexPresence hasSpatialIndex() const override;
+
+    /**
+     * Runs the post processing step of the algorithm, once the features of the pipe have
+     * been consumed, and returns the algorithm's results.
+     *
+     * Results of the features processing are moved from the pipe to the \a context first,
+     * as QgsProcessingAlgorithm::postProcess() does for algorithms run in another thread.
+     */
+    QVariantMap postProcess( QgsProcessingContext &context, QgsProcessingFeedback *feedback );
+
+  private:
+
+    std::unique_ptr< QgsProcessingFeatureBasedAlgorithm > mAlgorithm;
+    QgsProcessingFeatureSource *mInput = nullptr;
+
+    //! Context used for processing features, holding the algorithm's expression context
+    std::unique_ptr< QgsProcessingContext > mContext;
+    QgsProcessingFeedback *mFeedback = nullptr;
+
+    QgsFields mFields;
+    QgsWkbTypes::Type mWkbType = QgsWkbTypes::Unknown;
+    QgsCoordinateReferenceSystem mCrs;
+
+    friend class QgsProcessingFeaturePipeIterator;
+};
+
+///@endcond
+
+#endif // QGSPROCESSINGFEATUREPIPE_H
@@ -203,3 +203,70 @@ void QgsProcessingMultiStepFeedback::updateOverallProgress( double progress )
   mFeedback->setProgress( baseProgress + currentAlgorithmProgress );
 }
 
+///@cond PRIVATE
+
+QgsProcessingBufferedFeedback::QgsProcessingBufferedFeedback()
+  : QgsProcessingFeedback( false )
+{
+}
+
+void QgsProcessingBufferedFeedback::reportError( const QString &error, bool fatalError )
+{
+  mMessages << Message( Error, error, fatalError );
+}
+
+void QgsProcessingBufferedFeedback::pushWarning( const QString &warning )
+{
+  mMessages << Message( Warning, warning );
+}
+
+void QgsProcessingBufferedFeedback::pushInfo( const QString &info )
+{
+  mMessages << Message( Info, info );
+}
+
+void QgsProcessingBufferedFeedback::pushCommandInfo( const QString &info )
+{
+  mMessages << Message( CommandInfo, info );
+}
+
+void QgsProcessingBufferedFeedback::pushDebugInfo( const QString &info )
+{
+  mMessages << Message( DebugInfo, info );
+}
+
+void QgsProcessingBufferedFeedback::pushConsoleInfo( const QString &info )
+{
+  mMessages << Message( ConsoleInfo, info );
+}
+
+void QgsProcessingBufferedFeedback::flush( QgsProcessingFeedback *feedback )
+{
+  for ( const Message &message : qgis::as_const( mMessages ) )
+  {
+    switch ( message.type )
+    {
+      case Error:
+        feedback->reportError( message.text, message.fatalError );
+        break;
+      case Warning:
+        feedback->pushWarning( message.text );
+        break;
+      case Info:
+        feedback->pushInfo( message.text );
+        break;
+      case CommandInfo:
+        feedback->pushCommandInfo( message.text );
+        break;
+      case DebugInfo:
+        feedback->pushDebugInfo( message.text );
+        break;
+      case ConsoleInfo:
+        feedback->pushConsoleInfo( message.text );
+        break;
+    }
+  }
+  mMessages.clear();
+}
+
+///@endcond
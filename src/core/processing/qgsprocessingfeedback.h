@@ -198,6 +198,76 @@ class CORE_EXPORT QgsProcessingMultiStepFeedback : public QgsProcessingFeedback
     QgsProcessingFeedback *mFeedback = nullptr;
 };
 
+#ifndef SIP_RUN
+///@cond PRIVATE
+
+/**
+ * \class QgsProcessingBufferedFeedback
+ * \ingroup core
+ *
+ * Processing feedback object for worker threads.
+ *
+ * Messages pushed to this feedback are stored, and later pushed to the
+ * algorithm's feedback from the thread in which the algorithm runs by
+ * calling flush(), as feedback objects are not thread safe.
+ *
+ * \note Not available in Python bindings
+ * \since QGIS 3.18
+ */
+class CORE_EXPORT QgsProcessingBufferedFeedback : public QgsProcessingFeedback
+{
+    Q_OBJECT
+
+  public:
+
+    /**
+     * Constructor for QgsProcessingBufferedFeedback.
+     */
+    QgsProcessingBufferedFeedback();
+
+    void reportError( const QString &error, bool fatalError = false ) override;
+    void pushWarning( const QString &warning ) override;
+    void pushInfo( const QString &info ) override;
+    void pushCommandInfo( const QString &info ) override;
+    void pushDebugInfo( const QString &info ) override;
+    void pushConsoleInfo( const QString &info ) override;
+
+    /**
+     * Pushes the stored messages to \a feedback, and clears them.
+     */
+    void flush( QgsProcessingFeedback *feedback );
+
+  private:
+
+    enum MessageType
+    {
+      Error,
+      Warning,
+      Info,
+      CommandInfo,
+      DebugInfo,
+      ConsoleInfo
+    };
+
+    struct Message
+    {
+      Message( MessageType type, const QString &text, bool fatalError = false )
+        : type( type )
+        , text( text )
+        , fatalError( fatalError )
+      {}
+
+      MessageType type;
+      QString text;
+      bool fatalError;
+    };
+
+    QList< Message > mMessages;
+};
+
+///@endcond
+#endif
+
 #endif // QGSPROCESSINGFEEDBACK_H
 
 
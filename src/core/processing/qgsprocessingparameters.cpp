@@ -5332,6 +5332,10 @@ bool QgsProcessingParameterFeatureSource::checkValueIsAcceptable( const QVariant
     return true;
   }
 
+  // features streamed from a previous model child algorithm
+  if ( context->featurePipe( var.toString() ) )
+    return true;
+
   // try to load as layer
   if ( QgsProcessingUtils::mapLayerFromString( var.toString(), *context, true, QgsProcessingUtils::LayerHint::Vector ) )
     return true;
@@ -406,6 +406,10 @@ QgsProcessingFeatureSource *QgsProcessingUtils::variantToSource( const QVariant
   if ( layerRef.isEmpty() )
     return nullptr;
 
+  // features streamed from a previous model child algorithm
+  if ( QgsFeatureSource *pipe = context.featurePipe( layerRef ) )
+    return new QgsProcessingFeatureSource( pipe, context, false, featureLimit );
+
   QgsVectorLayer *vl = qobject_cast< QgsVectorLayer *>( QgsProcessingUtils::mapLayerFromString( layerRef, context, true, LayerHint::Vector ) );
   if ( !vl )
     return nullptr;
@@ -1353,6 +1357,20 @@ QgsFeatureSource::SpatialIndexPresence QgsProcessingFeatureSource::hasSpatialInd
   return mSource->hasSpatialIndex();
 }
 
+QList<QgsFeatureRequest> QgsProcessingFeatureSource::partitionRequest( const QgsFeatureRequest &request, int count ) const
+{
+  // a feature limit applies to the whole source, it can't be split between the partitions
+  if ( mFeatureLimit != -1 )
+    return QgsFeatureSource::partitionRequest( request, 1 );
+
+  // invalid geometries are reported to the context's feedback, which can't be used from
+  // the threads iterating the partitions
+  if ( mInvalidGeometryCheck != QgsFeatureRequest::GeometryNoCheck )
+    return QgsFeatureSource::partitionRequest( request, 1 );
+
+  return mSource->partitionRequest( request, count );
+}
+
 QgsExpressionContextScope *QgsProcessingFeatureSource::createExpressionContextScope() const
 {
   QgsExpressionContextScope *expressionContextScope = nullptr;
@@ -514,6 +514,7 @@ class CORE_EXPORT QgsProcessingFeatureSource : public QgsFeatureSource
     QgsRectangle sourceExtent() const override;
     QgsFeatureIds allFeatureIds() const override;
     SpatialIndexPresence hasSpatialIndex() const override;
+    QList< QgsFeatureRequest > partitionRequest( const QgsFeatureRequest &request, int count ) const override;
 
     /**
      * Returns an expression context scope suitable for this source.
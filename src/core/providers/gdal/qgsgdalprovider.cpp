@@ -87,6 +87,17 @@ const int MIN_THRESHOLD_FOR_CACHE_CLEANUP = 10;
 // file descriptors.
 const int MAX_CACHE_SIZE = 50;
 
+// The JP2OPENJPEG driver might consume too much memory on large datasets
+// so make sure to really use a single one.
+// The PostGISRaster driver internally uses a per-thread connection cache.
+// This can lead to crashes if two datasets created by the same thread are used at the same time.
+static bool forceUseSameDataset( const QString &driverName )
+{
+  return driverName.toUpper() == QLatin1String( "JP2OPENJPEG" ) ||
+         driverName == QLatin1String( "PostGISRaster" ) ||
+         CSLTestBoolean( CPLGetConfigOption( "QGIS_GDAL_FORCE_USE_SAME_DATASET", "FALSE" ) );
+}
+
 struct QgsGdalProgress
 {
   int type;
@@ -210,15 +221,7 @@ QgsGdalProvider::QgsGdalProvider( const QgsGdalProvider &other )
 {
   mDriverName = other.mDriverName;
 
-  // The JP2OPENJPEG driver might consume too much memory on large datasets
-  // so make sure to really use a single one.
-  // The PostGISRaster driver internally uses a per-thread connection cache.
-  // This can lead to crashes if two datasets created by the same thread are used at the same time.
-  bool forceUseSameDataset = ( mDriverName.toUpper() == QLatin1String( "JP2OPENJPEG" ) ||
-                               mDriverName == QLatin1String( "PostGISRaster" ) ||
-                               CSLTestBoolean( CPLGetConfigOption( "QGIS_GDAL_FORCE_USE_SAME_DATASET", "FALSE" ) ) );
-
-  if ( forceUseSameDataset )
+  if ( forceUseSameDataset( mDriverName ) )
   {
     ++ ( *other.mpRefCounter );
     // cppcheck-suppress copyCtorPointerCopying
@@ -462,6 +465,95 @@ void QgsGdalProvider::closeCachedGdalHandlesFor( QgsGdalProvider *provider )
   }
 }
 
+bool QgsGdalProvider::takeSpareGdalHandles( GDALDatasetH &gdalBaseDataset, GDALDatasetH &gdalDataset )
+{
+  if ( !mSpareReadsAllowed.loadAcquire() )
+    return false;
+
+  {
+    QMutexLocker locker( sGdalProviderMutex() );
+    if ( !*mpParent )
+      return false;
+
+    if ( getCachedGdalHandles( *mpParent, gdalBaseDataset, gdalDataset ) )
+      return true;
+  }
+
+  QgsDebugMsgLevel( QStringLiteral( "opening spare dataset for concurrent read" ), 5 );
+  gdalBaseDataset = gdalOpen( dataSourceUri( true ).toUtf8().constData(), GA_ReadOnly );
+  gdalDataset = gdalBaseDataset;
+  return gdalDataset != nullptr;
+}
+
+void QgsGdalProvider::releaseSpareGdalHandles( GDALDatasetH gdalBaseDataset, GDALDatasetH gdalDataset )
+{
+  {
+    QMutexLocker locker( sGdalProviderMutex() );
+    if ( *mpParent && cacheGdalHandlesForLaterReuse( *mpParent, gdalBaseDataset, gdalDataset ) )
+      return;
+  }
+
+  if ( gdalBaseDataset != gdalDataset )
+  {
+    GDALDereferenceDataset( gdalBaseDataset );
+  }
+  GDALClose( gdalDataset );
+}
+
+/**
+ * Gives access to the dataset of a provider for the duration of a block read.
+ *
+ * The handles of the provider are used under its mutex, unless another thread is
+ * already reading from them: spare handles of the dataset are then used if the
+ * provider allows it, so that both reads run at the same time.
+ */
+class QgsGdalProvider::ReadDatasetLocker
+{
+  public:
+
+    explicit ReadDatasetLocker( QgsGdalProvider *provider )
+      : mProvider( provider )
+    {
+      if ( !provider->mpMutex->tryLock() )
+      {
+        if ( provider->takeSpareGdalHandles( mSpareBaseDataset, mDataset ) )
+          return;
+
+        provider->mpMutex->lock();
+      }
+
+      mLocked = true;
+      if ( provider->initIfNeeded() )
+      {
+        mDataset = provider->mGdalDataset;
+        provider->mSpareReadsAllowed.storeRelease( provider->mpParent && !provider->mUpdate &&
+            provider->mGdalDataset == provider->mGdalBaseDataset &&
+            !forceUseSameDataset( provider->mDriverName ) );
+      }
+    }
+
+    ~ReadDatasetLocker()
+    {
+      if ( mLocked )
+        mProvider->mpMutex->unlock();
+      else
+        mProvider->releaseSpareGdalHandles( mSpareBaseDataset, mDataset );
+    }
+
+    ReadDatasetLocker( const ReadDatasetLocker &other ) = delete;
+    ReadDatasetLocker &operator=( const ReadDatasetLocker &other ) = delete;
+
+    //! Returns the dataset to read from, or nullptr if the provider could not be initialized
+    GDALDatasetH dataset() const { return mDataset; }
+
+  private:
+
+    QgsGdalProvider *mProvider = nullptr;
+    bool mLocked = false;
+    GDALDatasetH mSpareBaseDataset = nullptr;
+    GDALDatasetH mDataset = nullptr;
+};
+
 
 QgsGdalProvider::~QgsGdalProvider()
 {
@@ -532,6 +624,7 @@ void QgsGdalProvider::closeDataset()
   GDALClose( mGdalDataset );
   mGdalDataset = nullptr;
 
+  mSpareReadsAllowed.storeRelease( 0 );
   closeCachedGdalHandlesFor( this );
 }
 
@@ -697,14 +790,14 @@ QgsRasterBlock *QgsGdalProvider::block( int bandNo, const QgsRectangle &extent,
 
 bool QgsGdalProvider::readBlock( int bandNo, int xBlock, int yBlock, void *data )
 {
-  QMutexLocker locker( mpMutex );
-  if ( !initIfNeeded() )
+  ReadDatasetLocker locker( this );
+  if ( !locker.dataset() )
     return false;
 
   // TODO!!!: Check data alignment!!! May it happen that nearest value which
   // is not nearest is assigned to an output cell???
 
-  GDALRasterBandH myGdalBand = getBand( bandNo );
+  GDALRasterBandH myGdalBand = getBand( locker.dataset(), bandNo );
   //GDALReadBlock( myGdalBand, xBlock, yBlock, block );
 
   // We have to read with correct data type consistent with other readBlock functions
@@ -721,16 +814,11 @@ bool QgsGdalProvider::readBlock( int bandNo, int xBlock, int yBlock, void *data
 }
 
 bool QgsGdalProvider::canDoResampling(
-  int bandNo,
+  GDALRasterBandH gdalBand,
   const QgsRectangle &reqExtent,
   int bufferWidthPix,
-  int bufferHeightPix )
+  int bufferHeightPix ) const
 {
-  QMutexLocker locker( mpMutex );
-  if ( !initIfNeeded() )
-    return false;
-
-  GDALRasterBandH gdalBand = getBand( bandNo );
   if ( GDALGetRasterColorTable( gdalBand ) )
     return false;
 
@@ -809,8 +897,9 @@ static GDALRIOResampleAlg getGDALResamplingAlg( QgsGdalProvider::ResamplingMetho
 
 bool QgsGdalProvider::readBlock( int bandNo, QgsRectangle  const &reqExtent, int bufferWidthPix, int bufferHeightPix, void *data, QgsRasterBlockFeedback *feedback )
 {
-  QMutexLocker locker( mpMutex );
-  if ( !initIfNeeded() )
+  ReadDatasetLocker locker( this );
+  GDALDatasetH dataset = locker.dataset();
+  if ( !dataset )
     return false;
 
   QgsDebugMsgLevel( "bufferWidthPix = "  + QString::number( bufferWidthPix ), 5 );
@@ -841,7 +930,7 @@ bool QgsGdalProvider::readBlock( int bandNo, QgsRectangle  const &reqExtent, int
   QgsDebugMsgLevel( QStringLiteral( "reqXRes = %1 reqYRes = %2 srcXRes = %3 srcYRes = %4" ).arg( reqXRes ).arg( reqYRes ).arg( srcXRes ).arg( srcYRes ), 5 );
   const double resamplingFactor = std::max( reqXRes / srcXRes, reqYRes / srcYRes );
 
-  GDALRasterBandH gdalBand = getBand( bandNo );
+  GDALRasterBandH gdalBand = getBand( dataset, bandNo );
   const GDALDataType type = static_cast<GDALDataType>( mGdalDataType.at( bandNo - 1 ) );
 
   // Find top, bottom rows and left, right column the raster extent covers
@@ -885,7 +974,7 @@ bool QgsGdalProvider::readBlock( int bandNo, QgsRectangle  const &reqExtent, int
 
   // Use GDAL resampling if asked and possible
   if ( mProviderResamplingEnabled &&
-       canDoResampling( bandNo, reqExtent, bufferWidthPix, bufferHeightPix ) )
+       canDoResampling( gdalBand, reqExtent, bufferWidthPix, bufferHeightPix ) )
   {
     int tgtTop = tgtTopOri;
     int tgtBottom = tgtBottomOri;
@@ -972,7 +1061,7 @@ bool QgsGdalProvider::readBlock( int bandNo, QgsRectangle  const &reqExtent, int
       sExtraArg.eResampleAlg = getGDALResamplingAlg( method );
 
       if ( mMaskBandExposedAsAlpha &&
-           bandNo == GDALGetRasterCount( mGdalDataset ) + 1 &&
+           bandNo == GDALGetRasterCount( dataset ) + 1 &&
            sExtraArg.eResampleAlg != GRIORA_NearestNeighbour &&
            sExtraArg.eResampleAlg != GRIORA_Bilinear )
       {
@@ -1641,9 +1730,13 @@ QString QgsGdalProvider::description() const
 
 QgsRasterDataProvider::ProviderCapabilities QgsGdalProvider::providerCapabilities() const
 {
-  return ProviderCapability::ProviderHintBenefitsFromResampling |
-         ProviderCapability::ProviderHintCanPerformProviderResampling |
-         ProviderCapability::ReloadData;
+  ProviderCapabilities capabilities = ProviderCapability::ProviderHintBenefitsFromResampling |
+                                      ProviderCapability::ProviderHintCanPerformProviderResampling |
+                                      ProviderCapability::ReloadData;
+  // clones of these drivers share the dataset of the main provider, and their reads are serialized
+  if ( !forceUseSameDataset( mDriverName ) )
+    capabilities |= ProviderCapability::ProviderHintCanReadConcurrently;
+  return capabilities;
 }
 
 // This is used also by global isValidRasterFileName
@@ -3523,10 +3616,15 @@ GDALRasterBandH QgsGdalProvider::getBand( int bandNo ) const
   if ( !const_cast<QgsGdalProvider *>( this )->initIfNeeded() )
     return nullptr;
 
-  if ( mMaskBandExposedAsAlpha && bandNo == GDALGetRasterCount( mGdalDataset ) + 1 )
-    return GDALGetMaskBand( GDALGetRasterBand( mGdalDataset, 1 ) );
+  return getBand( mGdalDataset, bandNo );
+}
+
+GDALRasterBandH QgsGdalProvider::getBand( GDALDatasetH dataset, int bandNo ) const
+{
+  if ( mMaskBandExposedAsAlpha && bandNo == GDALGetRasterCount( dataset ) + 1 )
+    return GDALGetMaskBand( GDALGetRasterBand( dataset, 1 ) );
   else
-    return GDALGetRasterBand( mGdalDataset, bandNo );
+    return GDALGetRasterBand( dataset, bandNo );
 }
 
 // pyramids resampling
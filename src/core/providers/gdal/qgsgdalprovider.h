@@ -311,6 +311,9 @@ class QgsGdalProvider final: public QgsRasterDataProvider, QgsGdalProviderBase
     //! Wrapper for GDALGetRasterBand() that takes into account mMaskBandExposedAsAlpha.
     GDALRasterBandH getBand( int bandNo ) const;
 
+    //! Wrapper for GDALGetRasterBand() on \a dataset that takes into account mMaskBandExposedAsAlpha.
+    GDALRasterBandH getBand( GDALDatasetH dataset, int bandNo ) const;
+
     //! \brief Close data set and release related data
     void closeDataset();
 
@@ -336,6 +339,29 @@ class QgsGdalProvider final: public QgsRasterDataProvider, QgsGdalProviderBase
     //! Close all cached dataset for the specified provider.
     static void closeCachedGdalHandlesFor( QgsGdalProvider *provider );
 
+    /**
+     * Whether block reads may use spare handles of the dataset instead of waiting for
+     * the handles of this provider, when another thread is reading from it.
+     * Only read-only and non warped datasets with their own handles are allowed to.
+     */
+    QAtomicInt mSpareReadsAllowed;
+
+    /**
+     * Takes handles of the dataset which are not used by any provider instance, so that a block
+     * can be read while another thread holds mpMutex. The handles are recycled from the dataset
+     * cache of the parent provider, or opened if the cache is empty. They must be given
+     * back with releaseSpareGdalHandles().
+     *
+     * Returns false if the reads must wait for mpMutex.
+     */
+    bool takeSpareGdalHandles( GDALDatasetH &gdalBaseDataset, GDALDatasetH &gdalDataset );
+
+    //! Puts handles taken with takeSpareGdalHandles() in the dataset cache of the parent provider, or closes them.
+    void releaseSpareGdalHandles( GDALDatasetH gdalBaseDataset, GDALDatasetH gdalDataset );
+
+    //! Locks the dataset handles used to read a block
+    class ReadDatasetLocker;
+
     /**
      * Converts a world (\a x, \a y) coordinate to a pixel \a row and \a col.
      */
@@ -352,10 +378,10 @@ class QgsGdalProvider final: public QgsRasterDataProvider, QgsGdalProviderBase
     void *mGdalTransformerArg = nullptr;
 
     bool canDoResampling(
-      int bandNo,
+      GDALRasterBandH gdalBand,
       const QgsRectangle &reqExtent,
       int bufferWidthPix,
-      int bufferHeightPix );
+      int bufferHeightPix ) const;
 };
 
 /**
@@ -97,131 +97,104 @@ bool QgsMemoryFeatureIterator::fetchFeature( QgsFeature &feature )
   if ( mClosed )
     return false;
 
-  if ( mUsingFeatureIdList )
-    return nextFeatureUsingList( feature );
-  else
-    return nextFeatureTraverseAll( feature );
-}
+  const QgsFeature *candidate = mUsingFeatureIdList ? nextCandidateUsingList() : nextCandidateTraverseAll();
+  if ( !candidate )
+    return false;
 
+  // copy feature
+  feature = *candidate;
+  if ( !mUsingFeatureIdList )
+    feature.setValid( true );
+  feature.setFields( mSource->mFields ); // allow name-based attribute lookups
+  geometryToDestinationCrs( feature, mTransform );
+  return true;
+}
 
-bool QgsMemoryFeatureIterator::nextFeatureUsingList( QgsFeature &feature )
+bool QgsMemoryFeatureIterator::fetchBatch( QgsFeatureBatch &batch, int maxFeatures )
 {
-  bool hasFeature = false;
+  if ( mClosed )
+    return false;
 
-  // option 1: we have a list of features to traverse
-  QgsFeature candidate;
-  while ( mFeatureIdListIterator != mFeatureIdList.constEnd() )
+  // reprojected geometries have to be transformed feature by feature
+  if ( mTransform.isValid() )
+    return QgsAbstractFeatureIterator::fetchBatch( batch, maxFeatures );
+
+  // fill the batch straight from the stored features, without copying them
+  const bool includeGeometry = !( mRequest.flags() & QgsFeatureRequest::NoGeometry );
+  while ( batch.size() < maxFeatures )
+  {
+    const QgsFeature *candidate = mUsingFeatureIdList ? nextCandidateUsingList() : nextCandidateTraverseAll();
+    if ( !candidate )
+      break;
+
+    batch.addFeature( *candidate, includeGeometry );
+  }
+
+  return !batch.isEmpty();
+}
+
+bool QgsMemoryFeatureIterator::acceptFeature( const QgsFeature &candidate, bool boundingBoxChecked ) const
+{
+  if ( !mFilterRect.isNull() )
   {
-    candidate = mSource->mFeatures.value( *mFeatureIdListIterator );
-    if ( !mFilterRect.isNull() )
+    if ( mRequest.flags() & QgsFeatureRequest::ExactIntersect )
     {
-      if ( mRequest.flags() & QgsFeatureRequest::ExactIntersect )
-      {
-        // do exact check in case we're doing intersection
-        if ( candidate.hasGeometry() && mSelectRectEngine->intersects( candidate.geometry().constGet() ) )
-          hasFeature = true;
-      }
-      else if ( mSource->mSpatialIndex )
-      {
-        // using a spatial index - so we already know that the bounding box intersects correctly
-        hasFeature = true;
-      }
-      else
-      {
-        // do bounding box check if we aren't using a spatial index
-        if ( candidate.hasGeometry() && candidate.geometry().boundingBoxIntersects( mFilterRect ) )
-          hasFeature = true;
-      }
+      // do exact check in case we're doing intersection
+      if ( !candidate.hasGeometry() || !mSelectRectEngine->intersects( candidate.geometry().constGet() ) )
+        return false;
     }
-    else
-      hasFeature = true;
-
-    if ( hasFeature && mSubsetExpression )
+    else if ( !boundingBoxChecked )
     {
-      mSource->expressionContext()->setFeature( candidate );
-      if ( !mSubsetExpression->evaluate( mSource->expressionContext() ).toBool() )
-        hasFeature = false;
+      // do bounding box check if we aren't using a spatial index
+      if ( !candidate.hasGeometry() || !candidate.geometry().boundingBoxIntersects( mFilterRect ) )
+        return false;
     }
-
-    if ( hasFeature )
-      break;
-
-    ++mFeatureIdListIterator;
   }
 
-  // copy feature
-  if ( hasFeature )
+  if ( mSubsetExpression )
   {
-    feature = candidate;
-    ++mFeatureIdListIterator;
+    mSource->expressionContext()->setFeature( candidate );
+    if ( !mSubsetExpression->evaluate( mSource->expressionContext() ).toBool() )
+      return false;
   }
-  else
-    close();
 
-  if ( hasFeature )
+  return true;
+}
+
+const QgsFeature *QgsMemoryFeatureIterator::nextCandidateUsingList()
+{
+  // option 1: we have a list of features to traverse
+  // when using a spatial index we already know that the bounding box intersects correctly
+  const bool boundingBoxChecked = static_cast< bool >( mSource->mSpatialIndex );
+  while ( mFeatureIdListIterator != mFeatureIdList.constEnd() )
   {
-    feature.setFields( mSource->mFields ); // allow name-based attribute lookups
-    geometryToDestinationCrs( feature, mTransform );
+    QgsFeatureMap::const_iterator it = mSource->mFeatures.constFind( *mFeatureIdListIterator );
+    ++mFeatureIdListIterator;
+
+    // ids which are not in the layer give an empty feature
+    const QgsFeature &candidate = it != mSource->mFeatures.constEnd() ? it.value() : mMissingFeature;
+    if ( acceptFeature( candidate, boundingBoxChecked ) )
+      return &candidate;
   }
 
-  return hasFeature;
+  close();
+  return nullptr;
 }
 
-
-bool QgsMemoryFeatureIterator::nextFeatureTraverseAll( QgsFeature &feature )
+const QgsFeature *QgsMemoryFeatureIterator::nextCandidateTraverseAll()
 {
-  bool hasFeature = false;
-
   // option 2: traversing the whole layer
   while ( mSelectIterator != mSource->mFeatures.constEnd() )
   {
-    if ( mFilterRect.isNull() )
-    {
-      // selection rect empty => using all features
-      hasFeature = true;
-    }
-    else
-    {
-      if ( mRequest.flags() & QgsFeatureRequest::ExactIntersect )
-      {
-        // using exact test when checking for intersection
-        if ( mSelectIterator->hasGeometry() && mSelectRectEngine->intersects( mSelectIterator->geometry().constGet() ) )
-          hasFeature = true;
-      }
-      else
-      {
-        // check just bounding box against rect when not using intersection
-        if ( mSelectIterator->hasGeometry() && mSelectIterator->geometry().boundingBox().intersects( mFilterRect ) )
-          hasFeature = true;
-      }
-    }
-
-    if ( mSubsetExpression )
-    {
-      mSource->expressionContext()->setFeature( *mSelectIterator );
-      if ( !mSubsetExpression->evaluate( mSource->expressionContext() ).toBool() )
-        hasFeature = false;
-    }
-
-    if ( hasFeature )
-      break;
-
+    const QgsFeature &candidate = mSelectIterator.value();
     ++mSelectIterator;
-  }
 
-  // copy feature
-  if ( hasFeature )
-  {
-    feature = mSelectIterator.value();
-    ++mSelectIterator;
-    feature.setValid( true );
-    feature.setFields( mSource->mFields ); // allow name-based attribute lookups
-    geometryToDestinationCrs( feature, mTransform );
+    if ( acceptFeature( candidate, false ) )
+      return &candidate;
   }
-  else
-    close();
 
-  return hasFeature;
+  close();
+  return nullptr;
 }
 
 bool QgsMemoryFeatureIterator::rewind()
@@ -18,6 +18,7 @@
 #define SIP_NO_FILE
 
 #include "qgsfeatureiterator.h"
+#include "qgsfeaturebatch.h"
 #include "qgsexpressioncontext.h"
 #include "qgsfields.h"
 #include "qgsgeometry.h"
@@ -65,10 +66,18 @@ class QgsMemoryFeatureIterator final: public QgsAbstractFeatureIteratorFromSourc
   protected:
 
     bool fetchFeature( QgsFeature &feature ) override;
+    bool fetchBatch( QgsFeatureBatch &batch, int maxFeatures ) override;
 
   private:
-    bool nextFeatureUsingList( QgsFeature &feature );
-    bool nextFeatureTraverseAll( QgsFeature &feature );
+    //! Returns TRUE if \a candidate matches the filter rectangle and subset string
+    bool acceptFeature( const QgsFeature &candidate, bool boundingBoxChecked ) const;
+
+    //! Returns the next matching stored feature, or NULLPTR (and closes the iterator) when exhausted
+    const QgsFeature *nextCandidateUsingList();
+    const QgsFeature *nextCandidateTraverseAll();
+
+    //! Returned for requested feature ids which are not in the layer
+    QgsFeature mMissingFeature;
 
     QgsGeometry mSelectRectGeom;
     std::unique_ptr< QgsGeometryEngine > mSelectRectEngine;
@@ -28,6 +28,7 @@
 #include "qgsexception.h"
 #include "qgswkbtypes.h"
 #include "qgsogrtransaction.h"
+#include "qgsfeaturebatch.h"
 
 #include <QTextCodec>
 #include <QFile>
@@ -179,6 +180,20 @@ QgsOgrFeatureIterator::QgsOgrFeatureIterator( QgsOgrFeatureSource *source, bool
       QgsOgrProviderUtils::setRelevantFields( mOgrLayerOri, mSource->mFields.count(), mFetchGeometry, attrs, mSource->mFirstFieldIsFid, mSource->mSubsetString );
   }
 
+  // features in the filter rectangle are read by id when the source has a packed spatial index,
+  // as the spatial filter of drivers without a native index tests every feature
+  mUsePackedSpatialIndex = !mFilterRect.isNull()
+                           && mSource->mPackedSpatialIndex.isValid()
+                           && mRequest.filterType() == QgsFeatureRequest::FilterNone
+                           && !( mRequest.flags() & QgsFeatureRequest::ExactIntersect )
+                           && mSource->mOgrGeometryTypeFilter == wkbUnknown;
+  if ( mUsePackedSpatialIndex )
+  {
+    const QList<QgsFeatureId> ids = mSource->mPackedSpatialIndex.intersects( mFilterRect );
+    mFilterFids.insert( ids.constBegin(), ids.constEnd() );
+    mFilterFidsIt = mFilterFids.begin();
+  }
+
   // spatial query to select features
   if ( mAllowResetReading )
   {
@@ -362,7 +377,7 @@ bool QgsOgrFeatureIterator::fetchFeature( QgsFeature &feature )
     close(); // the feature has been read or was not found: we have finished here
     return result;
   }
-  else if ( mRequest.filterType() == QgsFeatureRequest::FilterFids )
+  else if ( mRequest.filterType() == QgsFeatureRequest::FilterFids || mUsePackedSpatialIndex )
   {
     while ( mFilterFidsIt != mFilterFids.end() )
     {
@@ -378,6 +393,26 @@ bool QgsOgrFeatureIterator::fetchFeature( QgsFeature &feature )
 
   gdal::ogr_feature_unique_ptr fet;
 
+#if GDAL_VERSION_NUM >= GDAL_COMPUTE_VERSION(3,6,0)
+  if ( mArrowStream.release )
+  {
+    // keep reading the stream after the features returned in batches, rather than
+    // reading the layer again up to them
+    if ( arrowStreamHasRequestedAttributes() )
+    {
+      mArrowFeatureBatch.clear();
+      if ( !fetchArrowBatch( mArrowFeatureBatch, 1 ) )
+        return false;
+
+      feature = mArrowFeatureBatch.feature( 0 );
+      feature.setValid( true );
+      return true;
+    }
+    closeArrowStream();
+  }
+#endif
+  mArrowStreamAllowed = false;
+
   // OSM layers (especially large ones) need the GDALDataset::GetNextFeature() call rather than OGRLayer::GetNextFeature()
   // see more details here: https://trac.osgeo.org/gdal/wiki/rfc66_randomlayerreadwrite
 
@@ -410,6 +445,529 @@ bool QgsOgrFeatureIterator::fetchFeature( QgsFeature &feature )
   return false;
 }
 
+bool QgsOgrFeatureIterator::fetchBatch( QgsFeatureBatch &batch, int maxFeatures )
+{
+  // features which need reprojection, exact intersection tests or geometry type filtering,
+  // and datasets which must be read through GDALDatasetGetNextFeature() go through the generic path
+  if ( mTransform.isValid()
+       || mUsePackedSpatialIndex
+       || ( !mFilterRect.isNull() && ( mRequest.flags() & QgsFeatureRequest::ExactIntersect ) )
+       || mSource->mOgrGeometryTypeFilter != wkbUnknown
+       || !QgsOgrProviderUtils::canDriverShareSameDatasetAmongLayers( mSource->mDriverName ) )
+  {
+    return QgsAbstractFeatureIterator::fetchBatch( batch, maxFeatures );
+  }
+
+  QMutexLocker locker( mSharedDS ? &mSharedDS->mutex() : nullptr );
+
+  QgsCPLHTTPFetchOverrider oCPLHTTPFetcher( mAuthCfg, mInterruptionChecker );
+  QgsSetCPLHTTPFetchOverriderInitiatorClass( oCPLHTTPFetcher, QStringLiteral( "QgsOgrFeatureIterator" ) );
+
+  if ( mClosed || !mOgrLayer )
+    return false;
+
+#if GDAL_VERSION_NUM >= GDAL_COMPUTE_VERSION(3,6,0)
+  // drivers with a native Arrow implementation return whole columns at once
+  if ( mArrowStream.release || ( mArrowStreamAllowed && openArrowStream( batch ) ) )
+    return fetchArrowBatch( batch, maxFeatures );
+#endif
+  mArrowStreamAllowed = false;
+
+  // decide once how each batch column is read from the OGR fields
+  enum ColumnSource
+  {
+    Fid,
+    Integer,
+    Real,
+    Utf8String,
+    Variant,
+  };
+  const bool utf8 = !mSource->mEncoding || mSource->mEncoding->mibEnum() == 106;
+  OGRFeatureDefnH featureDefn = OGR_L_GetLayerDefn( mOgrLayer );
+  QVector< ColumnSource > columnSources( batch.columnCount(), Variant );
+  QVector< int > ogrIndexes( batch.columnCount(), -1 );
+  for ( int column = 0; column < batch.columnCount(); ++column )
+  {
+    const int attindex = batch.attributeIndex( column );
+    if ( mFirstFieldIsFid && attindex == 0 )
+    {
+      columnSources[ column ] = Fid;
+      continue;
+    }
+
+    const int ogrIndex = mFirstFieldIsFid ? attindex - 1 : attindex;
+    ogrIndexes[ column ] = ogrIndex;
+    OGRFieldDefnH fieldDefn = OGR_FD_GetFieldDefn( featureDefn, ogrIndex );
+    if ( !fieldDefn )
+      continue;
+
+    const OGRFieldType ogrType = OGR_Fld_GetType( fieldDefn );
+    switch ( batch.columnType( column ) )
+    {
+      case QgsFeatureBatch::Int64Column:
+        if ( ogrType == OFTInteger || ogrType == OFTInteger64 )
+          columnSources[ column ] = Integer;
+        break;
+      case QgsFeatureBatch::DoubleColumn:
+        if ( ogrType == OFTReal )
+          columnSources[ column ] = Real;
+        break;
+      case QgsFeatureBatch::StringColumn:
+        if ( ogrType == OFTString && utf8 )
+          columnSources[ column ] = Utf8String;
+        break;
+      case QgsFeatureBatch::VariantColumn:
+        break;
+    }
+  }
+
+  const bool forceMulti = QgsWkbTypes::isMultiType( mSource->mWkbType );
+  QByteArray wkb;
+
+  while ( batch.size() < maxFeatures )
+  {
+    gdal::ogr_feature_unique_ptr fet( OGR_L_GetNextFeature( mOgrLayer ) );
+    if ( !fet )
+    {
+      close();
+      break;
+    }
+
+    OGRGeometryH geom = OGR_F_GetGeometryRef( fet.get() );
+    if ( !mFilterRect.isNull() )
+    {
+      if ( !geom || OGR_G_IsEmpty( geom ) )
+        continue;
+
+      OGREnvelope envelope;
+      OGR_G_GetEnvelope( geom, &envelope );
+      if ( !mFilterRect.intersects( QgsRectangle( envelope.MinX, envelope.MinY, envelope.MaxX, envelope.MaxY ) ) )
+        continue;
+    }
+
+    const QgsFeatureId fid = OGR_F_GetFID( fet.get() );
+    batch.addFeature( fid );
+
+    if ( mFetchGeometry && geom && !( mRequest.flags() & QgsFeatureRequest::NoGeometry ) )
+    {
+      // export straight to WKB, which the batch decodes without creating geometry objects
+      wkb.resize( OGR_G_WkbSize( geom ) );
+      if ( OGR_G_ExportToIsoWkb( geom, wkbNDR, reinterpret_cast< unsigned char * >( wkb.data() ) ) == OGRERR_NONE )
+        batch.setGeometryFromWkb( reinterpret_cast< const unsigned char * >( wkb.constData() ), wkb.size(), forceMulti );
+    }
+
+    for ( int column = 0; column < batch.columnCount(); ++column )
+    {
+      const ColumnSource source = columnSources.at( column );
+      if ( source == Fid )
+      {
+        batch.setValue( column, static_cast< qint64 >( fid ) );
+        continue;
+      }
+
+      const int ogrIndex = ogrIndexes.at( column );
+      if ( !OGR_F_IsFieldSetAndNotNull( fet.get(), ogrIndex ) )
+        continue;
+
+      switch ( source )
+      {
+        case Integer:
+          batch.setInt64( column, OGR_F_GetFieldAsInteger64( fet.get(), ogrIndex ) );
+          break;
+
+        case Real:
+          batch.setDouble( column, OGR_F_GetFieldAsDouble( fet.get(), ogrIndex ) );
+          break;
+
+        case Utf8String:
+        {
+          const char *value = OGR_F_GetFieldAsString( fet.get(), ogrIndex );
+          batch.setString( column, value, static_cast< int >( strlen( value ) ) );
+          break;
+        }
+
+        case Fid:
+        case Variant:
+        {
+          bool ok = false;
+          const QVariant value = QgsOgrUtils::getOgrFeatureAttribute( fet.get(), mFieldsWithoutFid, ogrIndex, mSource->mEncoding, &ok );
+          if ( ok )
+            batch.setValue( column, value );
+          break;
+        }
+      }
+    }
+  }
+
+  return !batch.isEmpty();
+}
+
+#if GDAL_VERSION_NUM >= GDAL_COMPUTE_VERSION(3,6,0)
+
+static QgsOgrFeatureIterator::ArrowValueType arrowValueType( const char *format )
+{
+  if ( !format || !format[0] || format[1] )
+    return QgsOgrFeatureIterator::ArrowUnsupported;
+
+  switch ( format[0] )
+  {
+    case 'c':
+      return QgsOgrFeatureIterator::ArrowInt8;
+    case 's':
+      return QgsOgrFeatureIterator::ArrowInt16;
+    case 'i':
+      return QgsOgrFeatureIterator::ArrowInt32;
+    case 'l':
+      return QgsOgrFeatureIterator::ArrowInt64;
+    case 'b':
+      return QgsOgrFeatureIterator::ArrowBool;
+    case 'f':
+      return QgsOgrFeatureIterator::ArrowFloat32;
+    case 'g':
+      return QgsOgrFeatureIterator::ArrowFloat64;
+    case 'u':
+      return QgsOgrFeatureIterator::ArrowUtf8;
+    case 'U':
+      return QgsOgrFeatureIterator::ArrowLargeUtf8;
+    case 'z':
+      return QgsOgrFeatureIterator::ArrowBinary;
+    case 'Z':
+      return QgsOgrFeatureIterator::ArrowLargeBinary;
+    default:
+      return QgsOgrFeatureIterator::ArrowUnsupported;
+  }
+}
+
+static inline bool arrowBit( const void *bitmap, int64_t index )
+{
+  return ( static_cast< const uint8_t * >( bitmap )[ index / 8 ] >> ( index % 8 ) ) & 1;
+}
+
+static inline bool arrowIsNull( const ArrowArray *array, int64_t row )
+{
+  return array->null_count != 0 && array->buffers[0] && !arrowBit( array->buffers[0], array->offset + row );
+}
+
+static inline qint64 arrowInteger( const ArrowArray *array, QgsOgrFeatureIterator::ArrowValueType type, int64_t row )
+{
+  const int64_t index = array->offset + row;
+  switch ( type )
+  {
+    case QgsOgrFeatureIterator::ArrowInt8:
+      return static_cast< const int8_t * >( array->buffers[1] )[ index ];
+    case QgsOgrFeatureIterator::ArrowInt16:
+      return static_cast< const int16_t * >( array->buffers[1] )[ index ];
+    case QgsOgrFeatureIterator::ArrowInt32:
+      return static_cast< const int32_t * >( array->buffers[1] )[ index ];
+    case QgsOgrFeatureIterator::ArrowInt64:
+      return static_cast< const int64_t * >( array->buffers[1] )[ index ];
+    case QgsOgrFeatureIterator::ArrowBool:
+      return arrowBit( array->buffers[1], index ) ? 1 : 0;
+    default:
+      return 0;
+  }
+}
+
+//! Returns the bytes of a string or binary value
+static inline const char *arrowBytes( const ArrowArray *array, QgsOgrFeatureIterator::ArrowValueType type, int64_t row, int64_t &length )
+{
+  const int64_t index = array->offset + row;
+  int64_t start = 0;
+  if ( type == QgsOgrFeatureIterator::ArrowLargeUtf8 || type == QgsOgrFeatureIterator::ArrowLargeBinary )
+  {
+    const int64_t *offsets = static_cast< const int64_t * >( array->buffers[1] );
+    start = offsets[ index ];
+    length = offsets[ index + 1 ] - start;
+  }
+  else
+  {
+    const int32_t *offsets = static_cast< const int32_t * >( array->buffers[1] );
+    start = offsets[ index ];
+    length = offsets[ index + 1 ] - start;
+  }
+  return static_cast< const char * >( array->buffers[2] ) + start;
+}
+
+bool QgsOgrFeatureIterator::openArrowStream( const QgsFeatureBatch &batch )
+{
+  mArrowStreamAllowed = false;
+
+  // the stream honors the attribute and spatial filters and the ignored fields, but
+  // the layer can't be shared with other readers while it is open
+  if ( mSharedDS || !mAllowResetReading || !OGR_L_TestCapability( mOgrLayer, OLCFastGetArrowStream ) )
+    return false;
+
+  // strings are read as UTF-8 straight from the record batches
+  if ( mSource->mEncoding && mSource->mEncoding->mibEnum() != 106 )
+    return false;
+
+  if ( !OGR_L_GetArrowStream( mOgrLayer, &mArrowStream, nullptr ) )
+  {
+    mArrowStream = ArrowArrayStream();
+    return false;
+  }
+
+  if ( mArrowStream.get_schema( &mArrowStream, &mArrowSchema ) != 0 )
+  {
+    releaseArrowStream();
+    return false;
+  }
+
+  const char *fidColumn = OGR_L_GetFIDColumn( mOgrLayer );
+  const QString fidName = fidColumn && fidColumn[0] ? QString::fromUtf8( fidColumn ) : QStringLiteral( "OGC_FID" );
+  const char *geometryColumn = OGR_L_GetGeometryColumn( mOgrLayer );
+  const QString geometryName = geometryColumn && geometryColumn[0] ? QString::fromUtf8( geometryColumn ) : QStringLiteral( "wkb_geometry" );
+
+  QHash< QString, int > children;
+  for ( int64_t i = 0; i < mArrowSchema.n_children; ++i )
+    children.insert( QString::fromUtf8( mArrowSchema.children[i]->name ), static_cast< int >( i ) );
+
+  auto childType = [this]( int child )
+  {
+    return child >= 0 ? arrowValueType( mArrowSchema.children[ child ]->format ) : ArrowUnsupported;
+  };
+
+  mArrowFidChild = children.value( fidName, -1 );
+  mArrowFidType = childType( mArrowFidChild );
+  if ( mArrowFidType != ArrowInt64 && mArrowFidType != ArrowInt32 )
+  {
+    releaseArrowStream();
+    return false;
+  }
+
+  mArrowGeometryChild = -1;
+  if ( mFetchGeometry && !( mRequest.flags() & QgsFeatureRequest::NoGeometry ) )
+  {
+    mArrowGeometryChild = children.value( geometryName, -1 );
+    mArrowGeometryType = childType( mArrowGeometryChild );
+    if ( mArrowGeometryType != ArrowBinary && mArrowGeometryType != ArrowLargeBinary )
+    {
+      releaseArrowStream();
+      return false;
+    }
+  }
+
+  OGRFeatureDefnH featureDefn = OGR_L_GetLayerDefn( mOgrLayer );
+  mArrowColumns.fill( ArrowColumn(), batch.columnCount() );
+  for ( int column = 0; column < batch.columnCount(); ++column )
+  {
+    const int attindex = batch.attributeIndex( column );
+    if ( mFirstFieldIsFid && attindex == 0 )
+      continue;
+
+    OGRFieldDefnH fieldDefn = OGR_FD_GetFieldDefn( featureDefn, mFirstFieldIsFid ? attindex - 1 : attindex );
+    const int child = fieldDefn ? children.value( QString::fromUtf8( OGR_Fld_GetNameRef( fieldDefn ) ), -1 ) : -1;
+    const ArrowValueType type = childType( child );
+    switch ( type )
+    {
+      case ArrowUnsupported:
+      case ArrowBinary:
+      case ArrowLargeBinary:
+        // dates, lists and binary fields are read through OGR features
+        releaseArrowStream();
+        return false;
+
+      default:
+        break;
+    }
+    mArrowColumns[ column ].child = child;
+    mArrowColumns[ column ].type = type;
+  }
+
+  QgsAttributeList attributes;
+  attributes.reserve( batch.columnCount() );
+  for ( int column = 0; column < batch.columnCount(); ++column )
+    attributes << batch.attributeIndex( column );
+  mArrowFeatureBatch.setFields( batch.fields(), attributes );
+
+  mArrowFeatureCount = 0;
+  return true;
+}
+
+bool QgsOgrFeatureIterator::arrowStreamHasRequestedAttributes() const
+{
+  // an empty attribute list stands for all the attributes, so batches without columns can't be mirrored
+  if ( mArrowFeatureBatch.columnCount() != mArrowColumns.size() )
+    return false;
+
+  const QgsAttributeList attributes = mRequest.flags() & QgsFeatureRequest::SubsetOfAttributes ? mRequest.subsetOfAttributes() : mSource->mFields.allAttributesList();
+  for ( int attributeIndex : attributes )
+  {
+    if ( mArrowFeatureBatch.columnForAttribute( attributeIndex ) < 0 )
+      return false;
+  }
+  return true;
+}
+
+bool QgsOgrFeatureIterator::fetchArrowBatch( QgsFeatureBatch &batch, int maxFeatures )
+{
+  if ( mArrowColumns.size() != batch.columnCount() )
+  {
+    // the batch layout changed since the stream was opened
+    closeArrowStream();
+    return fetchBatch( batch, maxFeatures );
+  }
+
+  const bool forceMulti = QgsWkbTypes::isMultiType( mSource->mWkbType );
+
+  while ( batch.size() < maxFeatures )
+  {
+    if ( !mArrowArray.release || mArrowRow >= mArrowArray.length )
+    {
+      if ( mArrowArray.release )
+        mArrowArray.release( &mArrowArray );
+      mArrowArray = ArrowArray();
+      mArrowRow = 0;
+
+      if ( mArrowStream.get_next( &mArrowStream, &mArrowArray ) != 0 )
+      {
+        const char *error = mArrowStream.get_last_error( &mArrowStream );
+        QgsMessageLog::logMessage( QObject::tr( "Error reading Arrow stream: %1" ).arg( QString::fromUtf8( error ? error : "" ) ), QObject::tr( "OGR" ) );
+        mArrowArray = ArrowArray();
+      }
+      if ( !mArrowArray.release )
+      {
+        // end of the stream
+        close();
+        break;
+      }
+      continue;
+    }
+
+    const int64_t rows = std::min< int64_t >( mArrowArray.length - mArrowRow, maxFeatures - batch.size() );
+    const ArrowArray *fids = mArrowArray.children[ mArrowFidChild ];
+    const ArrowArray *geometries = mArrowGeometryChild >= 0 ? mArrowArray.children[ mArrowGeometryChild ] : nullptr;
+
+    // rows of the child arrays, which are shifted by the offset of the record batch
+    const int64_t firstRow = mArrowArray.offset + mArrowRow;
+    for ( int64_t row = firstRow; row < firstRow + rows; ++row )
+    {
+      const QgsFeatureId fid = arrowInteger( fids, mArrowFidType, row );
+      batch.addFeature( fid );
+
+      if ( geometries && !arrowIsNull( geometries, row ) )
+      {
+        int64_t length = 0;
+        const char *wkb = arrowBytes( geometries, mArrowGeometryType, row, length );
+        if ( length > 0 )
+          batch.setGeometryFromWkb( reinterpret_cast< const unsigned char * >( wkb ), static_cast< int >( length ), forceMulti );
+      }
+
+      for ( int column = 0; column < mArrowColumns.size(); ++column )
+      {
+        const ArrowColumn &arrowColumn = mArrowColumns.at( column );
+        const QgsFeatureBatch::ColumnType columnType = batch.columnType( column );
+        if ( arrowColumn.child < 0 )
+        {
+          batch.setValue( column, static_cast< qint64 >( fid ) );
+          continue;
+        }
+
+        const ArrowArray *values = mArrowArray.children[ arrowColumn.child ];
+        if ( arrowIsNull( values, row ) )
+          continue;
+
+        switch ( arrowColumn.type )
+        {
+          case ArrowInt8:
+          case ArrowInt16:
+          case ArrowInt32:
+          case ArrowInt64:
+          case ArrowBool:
+          {
+            const qint64 value = arrowInteger( values, arrowColumn.type, row );
+            if ( columnType == QgsFeatureBatch::Int64Column )
+              batch.setInt64( column, value );
+            else if ( arrowColumn.type == ArrowBool )
+              batch.setValue( column, QVariant( value != 0 ) );
+            else
+              batch.setValue( column, value );
+            break;
+          }
+
+          case ArrowFloat32:
+          case ArrowFloat64:
+          {
+            const double value = arrowColumn.type == ArrowFloat32
+                                 ? static_cast< const float * >( values->buffers[1] )[ values->offset + row ]
+                                 : static_cast< const double * >( values->buffers[1] )[ values->offset + row ];
+            if ( columnType == QgsFeatureBatch::DoubleColumn )
+              batch.setDouble( column, value );
+            else
+              batch.setValue( column, value );
+            break;
+          }
+
+          case ArrowUtf8:
+          case ArrowLargeUtf8:
+          {
+            int64_t length = 0;
+            const char *value = arrowBytes( values, arrowColumn.type, row, length );
+            if ( columnType == QgsFeatureBatch::StringColumn )
+              batch.setString( column, value, static_cast< int >( length ) );
+            else
+              batch.setValue( column, QString::fromUtf8( value, static_cast< int >( length ) ) );
+            break;
+          }
+
+          case ArrowUnsupported:
+          case ArrowBinary:
+          case ArrowLargeBinary:
+            break;
+        }
+      }
+    }
+
+    mArrowRow += rows;
+    mArrowFeatureCount += rows;
+  }
+
+  return !batch.isEmpty();
+}
+
+void QgsOgrFeatureIterator::closeArrowStream()
+{
+  // the layer can't be read while the Arrow stream is open: restart the regular
+  // reading after the features which were returned in batches
+  const qint64 skip = mArrowFeatureCount;
+  releaseArrowStream();
+  resetReading();
+  if ( skip == 0 )
+    return;
+
+  // drivers which can seek do it without reading the features
+  if ( OGR_L_TestCapability( mOgrLayer, OLCFastSetNextByIndex ) && OGR_L_SetNextByIndex( mOgrLayer, skip ) == OGRERR_NONE )
+    return;
+
+  resetReading();
+  for ( qint64 i = 0; i < skip; ++i )
+  {
+    gdal::ogr_feature_unique_ptr fet( OGR_L_GetNextFeature( mOgrLayer ) );
+    if ( !fet )
+      break;
+  }
+}
+
+void QgsOgrFeatureIterator::releaseArrowStream()
+{
+  if ( mArrowArray.release )
+    mArrowArray.release( &mArrowArray );
+  mArrowArray = ArrowArray();
+  mArrowRow = 0;
+
+  if ( mArrowSchema.release )
+    mArrowSchema.release( &mArrowSchema );
+  mArrowSchema = ArrowSchema();
+
+  if ( mArrowStream.release )
+    mArrowStream.release( &mArrowStream );
+  mArrowStream = ArrowArrayStream();
+
+  mArrowFeatureCount = 0;
+}
+
+#endif
+
 void QgsOgrFeatureIterator::resetReading()
 {
   if ( ! mAllowResetReading )
@@ -436,6 +994,11 @@ bool QgsOgrFeatureIterator::rewind()
   if ( mClosed || !mOgrLayer )
     return false;
 
+#if GDAL_VERSION_NUM >= GDAL_COMPUTE_VERSION(3,6,0)
+  releaseArrowStream();
+#endif
+  mArrowStreamAllowed = true;
+
   resetReading();
 
   mFilterFidsIt = mFilterFids.begin();
@@ -446,6 +1009,11 @@ bool QgsOgrFeatureIterator::rewind()
 
 bool QgsOgrFeatureIterator::close()
 {
+#if GDAL_VERSION_NUM >= GDAL_COMPUTE_VERSION(3,6,0)
+  // the stream must be released before the layer is reset or its connection released
+  releaseArrowStream();
+#endif
+
   if ( mSharedDS )
   {
     iteratorClosed();
@@ -595,6 +1163,10 @@ QgsOgrFeatureSource::QgsOgrFeatureSource( const QgsOgrProvider *p )
   , mWkbType( p->wkbType() )
   , mSharedDS( nullptr )
 {
+  // the index covers all the features of the layer
+  if ( mSubsetString.isEmpty() )
+    mPackedSpatialIndex = p->mPackedSpatialIndex;
+
   if ( p->mTransaction )
   {
     mTransaction = p->mTransaction;
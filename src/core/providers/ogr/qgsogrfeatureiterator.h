@@ -16,8 +16,10 @@
 #define QGSOGRFEATUREITERATOR_H
 
 #include "qgsfeatureiterator.h"
+#include "qgsfeaturebatch.h"
 #include "qgsogrconnpool.h"
 #include "qgsfields.h"
+#include "qgspackedspatialindex.h"
 
 #include <ogr_api.h>
 
@@ -55,6 +57,7 @@ class QgsOgrFeatureSource final: public QgsAbstractFeatureSource
     OGRwkbGeometryType mOgrGeometryTypeFilter;
     QString mDriverName;
     QgsCoordinateReferenceSystem mCrs;
+    QgsPackedSpatialIndex mPackedSpatialIndex;
     QgsWkbTypes::Type mWkbType = QgsWkbTypes::Unknown;
     QgsOgrDatasetSharedPtr mSharedDS = nullptr;
     QgsTransaction *mTransaction = nullptr;
@@ -63,7 +66,7 @@ class QgsOgrFeatureSource final: public QgsAbstractFeatureSource
     friend class QgsOgrExpressionCompiler;
 };
 
-class QgsOgrFeatureIterator final: public QgsAbstractFeatureIteratorFromSource<QgsOgrFeatureSource>
+class CORE_EXPORT QgsOgrFeatureIterator final: public QgsAbstractFeatureIteratorFromSource<QgsOgrFeatureSource>
 {
   public:
     QgsOgrFeatureIterator( QgsOgrFeatureSource *source, bool ownSource, const QgsFeatureRequest &request, QgsTransaction *transaction );
@@ -75,9 +78,32 @@ class QgsOgrFeatureIterator final: public QgsAbstractFeatureIteratorFromSource<Q
 
     void setInterruptionChecker( QgsFeedback *interruptionChecker ) override;
 
+#if GDAL_VERSION_NUM >= GDAL_COMPUTE_VERSION(3,6,0)
+    //! Returns TRUE while the features are read from an Arrow stream of the layer
+    bool isReadingArrowStream() const { return mArrowStream.release != nullptr; }
+
+    //! Value types of the Arrow columns which can be read into a batch
+    enum ArrowValueType
+    {
+      ArrowUnsupported,
+      ArrowInt8,
+      ArrowInt16,
+      ArrowInt32,
+      ArrowInt64,
+      ArrowBool,
+      ArrowFloat32,
+      ArrowFloat64,
+      ArrowUtf8,
+      ArrowLargeUtf8,
+      ArrowBinary,
+      ArrowLargeBinary,
+    };
+#endif
+
   protected:
     bool checkFeature( gdal::ogr_feature_unique_ptr &fet, QgsFeature &feature ) ;
     bool fetchFeature( QgsFeature &feature ) override;
+    bool fetchBatch( QgsFeatureBatch &batch, int maxFeatures ) override;
     bool nextFeatureFilterExpression( QgsFeature &f ) override;
 
   private:
@@ -98,6 +124,8 @@ class QgsOgrFeatureIterator final: public QgsAbstractFeatureIteratorFromSource<Q
     // use std::set to get sorted ids (needed for efficient QgsFeatureRequest::FilterFids requests on OSM datasource)
     std::set<QgsFeatureId> mFilterFids;
     std::set<QgsFeatureId>::iterator mFilterFidsIt;
+    //! TRUE if the features in the filter rectangle are looked up in the packed spatial index of the source, and read by id
+    bool mUsePackedSpatialIndex = false;
 
     QgsRectangle mFilterRect;
     QgsCoordinateTransform mTransform;
@@ -117,6 +145,53 @@ class QgsOgrFeatureIterator final: public QgsAbstractFeatureIteratorFromSource<Q
     bool fetchFeatureWithId( QgsFeatureId id, QgsFeature &feature ) const;
 
     void resetReading();
+
+    //! FALSE once features have been read since the last rewind without the Arrow stream
+    bool mArrowStreamAllowed = true;
+
+#if GDAL_VERSION_NUM >= GDAL_COMPUTE_VERSION(3,6,0)
+    //! Source of a batch column in the Arrow record batches
+    struct ArrowColumn
+    {
+      //! Index of the child array, -1 for the feature id
+      int child = -1;
+      ArrowValueType type = ArrowUnsupported;
+    };
+
+    /**
+     * Opens an Arrow stream on the layer, if the driver supports it natively and all the
+     * columns of \a batch can be read from it.
+     */
+    bool openArrowStream( const QgsFeatureBatch &batch );
+
+    //! Appends up to \a maxFeatures features from the Arrow stream to \a batch
+    bool fetchArrowBatch( QgsFeatureBatch &batch, int maxFeatures );
+
+    //! Releases the Arrow stream, and continues reading the layer after the features already returned in batches
+    void closeArrowStream();
+
+    //! Returns TRUE if the Arrow stream provides all the attributes of the request
+    bool arrowStreamHasRequestedAttributes() const;
+
+    //! Releases the Arrow stream and the current record batch
+    void releaseArrowStream();
+
+    ArrowArrayStream mArrowStream = ArrowArrayStream();
+    ArrowSchema mArrowSchema = ArrowSchema();
+    //! Current record batch
+    ArrowArray mArrowArray = ArrowArray();
+    //! Next row to read in the current record batch
+    int64_t mArrowRow = 0;
+    //! Number of features returned from the Arrow stream since it was opened
+    qint64 mArrowFeatureCount = 0;
+    QVector< ArrowColumn > mArrowColumns;
+    //! Single row batch with the layout of the Arrow stream, used to read features one at a time while it is open
+    QgsFeatureBatch mArrowFeatureBatch;
+    int mArrowFidChild = -1;
+    ArrowValueType mArrowFidType = ArrowUnsupported;
+    int mArrowGeometryChild = -1;
+    ArrowValueType mArrowGeometryType = ArrowUnsupported;
+#endif
 };
 
 ///@endcond
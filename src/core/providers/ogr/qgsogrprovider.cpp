@@ -1893,6 +1893,9 @@ bool QgsOgrProvider::addFeatures( QgsFeatureList &flist, Flags flags )
   if ( !doInitialActionsForEdition() )
     return false;
 
+  // the stored packed spatial index is outdated once the dataset is written
+  mPackedSpatialIndex = QgsPackedSpatialIndex();
+
   setRelevantFields( true, attributeIndexes() );
 
   const bool inTransaction = startTransaction();
@@ -2574,6 +2577,9 @@ bool QgsOgrProvider::changeGeometryValues( const QgsGeometryMap &geometry_map )
   if ( !doInitialActionsForEdition() )
     return false;
 
+  // the stored packed spatial index is outdated once the dataset is written
+  mPackedSpatialIndex = QgsPackedSpatialIndex();
+
   setRelevantFields( true, attributeIndexes() );
 
   const bool inTransaction = startTransaction();
@@ -2683,6 +2689,25 @@ bool QgsOgrProvider::createSpatialIndex()
 
   if ( !mOgrOrigLayer )
     return false;
+
+  const QString packedIndexPath = packedSpatialIndexPath();
+  if ( !packedIndexPath.isEmpty() )
+  {
+    // the dataset has no native spatial index, a packed index of all the features is stored next to it
+    if ( !mSubsetString.isEmpty() )
+      return false;
+
+    if ( !mPackedSpatialIndex.isValid() )
+    {
+      QgsFeatureIterator it = getFeatures( QgsFeatureRequest().setNoAttributes() );
+      mPackedSpatialIndex = QgsPackedSpatialIndex( it );
+      QString error;
+      if ( !mPackedSpatialIndex.writeToFile( packedIndexPath, &error ) )
+        QgsDebugMsg( QStringLiteral( "Cannot store spatial index: %1" ).arg( error ) );
+    }
+    return mPackedSpatialIndex.isValid();
+  }
+
   if ( !doInitialActionsForEdition() )
     return false;
 
@@ -2713,6 +2738,34 @@ bool QgsOgrProvider::createSpatialIndex()
   return false;
 }
 
+QString QgsOgrProvider::packedSpatialIndexPath() const
+{
+  // GeoJSON datasets are read in memory by GDAL, but their spatial filter tests every feature
+  if ( mGDALDriverName != QLatin1String( "GeoJSON" ) || !QFileInfo( mFilePath ).isFile() )
+    return QString();
+
+  return mFilePath + QStringLiteral( ".spatialindex" );
+}
+
+void QgsOgrProvider::openPackedSpatialIndex()
+{
+  mPackedSpatialIndex = QgsPackedSpatialIndex();
+
+  const QString path = packedSpatialIndexPath();
+  if ( path.isEmpty() )
+    return;
+
+  // an index older than the dataset is outdated
+  const QFileInfo indexInfo( path );
+  if ( !indexInfo.exists() || indexInfo.lastModified() < QFileInfo( mFilePath ).lastModified() )
+    return;
+
+  QString error;
+  mPackedSpatialIndex = QgsPackedSpatialIndex::open( path, &error );
+  if ( !mPackedSpatialIndex.isValid() )
+    QgsDebugMsg( QStringLiteral( "Cannot open spatial index: %1" ).arg( error ) );
+}
+
 QString QgsOgrProvider::createIndexName( QString tableName, QString field )
 {
   QRegularExpression safeExp( QStringLiteral( "[^a-zA-Z0-9]" ) );
@@ -2770,6 +2823,9 @@ bool QgsOgrProvider::deleteFeatures( const QgsFeatureIds &id )
   if ( !doInitialActionsForEdition() )
     return false;
 
+  // the stored packed spatial index is outdated once the dataset is written
+  mPackedSpatialIndex = QgsPackedSpatialIndex();
+
   const bool inTransaction = startTransaction();
 
   bool returnvalue = true;
@@ -4179,6 +4235,8 @@ QgsFeatureSource::SpatialIndexPresence QgsOgrProvider::hasSpatialIndex() const
 
   if ( mOgrLayer && mOgrLayer->TestCapability( OLCFastSpatialFilter ) )
     return QgsFeatureSource::SpatialIndexPresent;
+  else if ( mOgrLayer && mPackedSpatialIndex.isValid() && mSubsetString.isEmpty() )
+    return QgsFeatureSource::SpatialIndexPresent;
   else if ( mOgrLayer )
     return QgsFeatureSource::SpatialIndexNotPresent;
   else
@@ -5009,6 +5067,9 @@ void QgsOgrProvider::open( OpenMode mode )
     }
   }
 
+  if ( mValid )
+    openPackedSpatialIndex();
+
   // For debug/testing purposes
   if ( !mValid )
     setProperty( "_debug_open_mode", "invalid" );
@@ -5027,6 +5088,7 @@ void QgsOgrProvider::close()
   mOgrLayer = nullptr;
   mValid = false;
   setProperty( "_debug_open_mode", "invalid" );
+  mPackedSpatialIndex = QgsPackedSpatialIndex();
 
   invalidateCachedExtent( false );
 }
@@ -25,6 +25,7 @@ email                : sherman at mrcc.com
 #include "qgsvectorfilewriter.h"
 #include "qgsvectorlayerexporter.h"
 #include "qgsprovidermetadata.h"
+#include "qgspackedspatialindex.h"
 #include "qgis_sip.h"
 
 ///@cond PRIVATE
@@ -216,6 +217,15 @@ class QgsOgrProvider final: public QgsVectorDataProvider
     //! Rolls back a transaction
     bool rollbackTransaction();
 
+    /**
+     * Returns the path of the file storing the packed spatial index of a dataset without native
+     * spatial index (GeoJSON), or an empty string if the driver has no stored packed index.
+     */
+    QString packedSpatialIndexPath() const;
+
+    //! Opens the stored packed spatial index, if it is more recent than the dataset
+    void openPackedSpatialIndex();
+
     //! Does the real job of settings the subset string and adds an argument to disable update capabilities
     bool _setSubsetString( const QString &theSQL, bool updateFeatureCount = true, bool updateCapabilities = true, bool hasExistingRef = true );
 
@@ -232,6 +242,9 @@ class QgsOgrProvider final: public QgsVectorDataProvider
     mutable std::unique_ptr< OGREnvelope > mExtent;
     bool mForceRecomputeExtent = false;
 
+    //! Packed spatial index of all the features of a dataset without native spatial index, see packedSpatialIndexPath()
+    QgsPackedSpatialIndex mPackedSpatialIndex;
+
     QList<int> mPrimaryKeyAttrs;
 
     /**
@@ -20,6 +20,7 @@
 #include "qgsgeometry.h"
 #include "qgscurve.h"
 #include "qgslogger.h"
+#include "qgssimdkernels_p.h"
 
 // Where has all the code gone?
 
@@ -38,6 +39,49 @@ const double QgsClipper::MIN_Y = -16000;
 
 const double QgsClipper::SMALL_NUM = 1e-12;
 
+// Returns the boundaries of the clip rectangle which are crossed by some points of the polygon
+static int boundariesCrossed( const QPolygonF &pts, const QgsRectangle &clipRect )
+{
+#ifndef QT_COORD_TYPE
+  return QgsSimdKernels::boundariesCrossed( reinterpret_cast< const double * >( pts.constData() ), static_cast< std::size_t >( pts.size() ),
+         clipRect.xMinimum(), clipRect.yMinimum(), clipRect.xMaximum(), clipRect.yMaximum() );
+#else
+  Q_UNUSED( pts )
+  Q_UNUSED( clipRect )
+  return QgsSimdKernels::XMax | QgsSimdKernels::YMax | QgsSimdKernels::XMin | QgsSimdKernels::YMin;
+#endif
+}
+
+void QgsClipper::trimPolygon( QPolygonF &pts, const QgsRectangle &clipRect )
+{
+  // trimming a polygon to a boundary which none of its points crosses leaves it unchanged,
+  // so only the crossed boundaries are processed. Most polygons of a rendered layer
+  // cross at most one or two boundaries of the extent.
+  int crossed = boundariesCrossed( pts, clipRect );
+  if ( !crossed )
+    return;
+
+  QPolygonF tmpPts;
+  tmpPts.reserve( pts.size() );
+
+  const Boundary boundaries[] = { XMax, YMax, XMin, YMin };
+  const int flags[] = { QgsSimdKernels::XMax, QgsSimdKernels::YMax, QgsSimdKernels::XMin, QgsSimdKernels::YMin };
+  const double values[] = { clipRect.xMaximum(), clipRect.yMaximum(), clipRect.xMinimum(), clipRect.yMinimum() };
+  for ( int i = 0; i < 4; ++i )
+  {
+    if ( !( crossed & flags[i] ) )
+      continue;
+
+    tmpPts.resize( 0 );
+    trimPolygonToBoundary( pts, tmpPts, clipRect, boundaries[i], values[i] );
+    pts.swap( tmpPts );
+
+    // the points created on the trimmed boundary may cross the remaining ones
+    if ( i < 3 )
+      crossed = boundariesCrossed( pts, clipRect );
+  }
+}
+
 QPolygonF QgsClipper::clippedLine( const QgsCurve &curve, const QgsRectangle &clipExtent )
 {
   return clippedLine( curve.asQPolygonF(), clipExtent );
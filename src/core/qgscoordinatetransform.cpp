@@ -380,9 +380,20 @@ void QgsCoordinateTransform::transformPolygon( QPolygonF &poly, TransformDirecti
   QVector<double> x( nVertices );
   QVector<double> y( nVertices );
   QVector<double> z( nVertices );
-  double *destX = x.data();
-  double *destY = y.data();
-  double *destZ = z.data();
+  transformPolygon( poly, x.data(), y.data(), z.data(), direction );
+}
+
+void QgsCoordinateTransform::transformPolygon( QPolygonF &poly, double *x, double *y, double *z, TransformDirection direction ) const
+{
+  if ( !d->mIsValid || d->mShortCircuit )
+  {
+    return;
+  }
+
+  int nVertices = poly.size();
+  double *destX = x;
+  double *destY = y;
+  double *destZ = z;
 
   const QPointF *polyData = poly.constData();
   for ( int i = 0; i < nVertices; ++i )
@@ -396,7 +407,7 @@ void QgsCoordinateTransform::transformPolygon( QPolygonF &poly, TransformDirecti
   QString err;
   try
   {
-    transformCoords( nVertices, x.data(), y.data(), z.data(), direction );
+    transformCoords( nVertices, x, y, z, direction );
   }
   catch ( const QgsCsException &e )
   {
@@ -405,8 +416,8 @@ void QgsCoordinateTransform::transformPolygon( QPolygonF &poly, TransformDirecti
   }
 
   QPointF *destPoint = poly.data();
-  const double *srcX = x.constData();
-  const double *srcY = y.constData();
+  const double *srcX = x;
+  const double *srcY = y;
   for ( int i = 0; i < nVertices; ++i )
   {
     destPoint->rx() = *srcX++;
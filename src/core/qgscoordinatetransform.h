@@ -305,6 +305,19 @@ class CORE_EXPORT QgsCoordinateTransform
      */
     void transformPolygon( QPolygonF &polygon, TransformDirection direction = ForwardTransform ) const SIP_THROW( QgsCsException );
 
+    /**
+     * Transforms a polygon to the destination coordinate system, using caller provided
+     * buffers for the temporary coordinate arrays instead of allocating them.
+     * \param polygon polygon to transform (occurs in place)
+     * \param x buffer of at least polygon.size() elements, used for the x coordinates
+     * \param y buffer of at least polygon.size() elements, used for the y coordinates
+     * \param z buffer of at least polygon.size() elements, used for the z coordinates
+     * \param direction transform direction (defaults to forward transformation)
+     * \note not available in Python bindings
+     * \since QGIS 3.18
+     */
+    void transformPolygon( QPolygonF &polygon, double *x, double *y, double *z, TransformDirection direction = ForwardTransform ) const SIP_SKIP;
+
     /**
      * Transforms a rectangle to the destination CRS.
      * If the direction is ForwardTransform then coordinates are transformed from source to destination,
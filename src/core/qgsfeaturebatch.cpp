@@ -0,0 +1,751 @@
+/***************************************************************************
+    qgsfeaturebatch.cpp
+    ---------------------
+    begin                : October 2026
+    copyright            : (C) 2026 by QGIS contributors
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qgsfeaturebatch.h"
+#include "qgsfeature.h"
+#include "qgsgeometrycollection.h"
+#include "qgsgeometryfactory.h"
+#include "qgscurvepolygon.h"
+#include "qgspolygon.h"
+#include "qgslinestring.h"
+#include "qgspoint.h"
+
+#include <QtEndian>
+#include <limits>
+#include <cmath>
+
+///@cond PRIVATE
+
+// EWKB flags, as used by PostGIS
+static const quint32 EWKB_Z_FLAG = 0x80000000;
+static const quint32 EWKB_M_FLAG = 0x40000000;
+static const quint32 EWKB_SRID_FLAG = 0x20000000;
+
+static bool readUInt32( const unsigned char *&p, const unsigned char *end, bool littleEndian, quint32 &value )
+{
+  if ( end - p < 4 )
+    return false;
+  value = littleEndian ? qFromLittleEndian<quint32>( p ) : qFromBigEndian<quint32>( p );
+  p += 4;
+  return true;
+}
+
+static double readDouble( const unsigned char *&p, bool littleEndian )
+{
+  const quint64 bits = littleEndian ? qFromLittleEndian<quint64>( p ) : qFromBigEndian<quint64>( p );
+  p += 8;
+  double value;
+  memcpy( &value, &bits, sizeof( double ) );
+  return value;
+}
+
+///@endcond
+
+QgsFeatureBatch::QgsFeatureBatch( const QgsFields &fields, const QgsAttributeList &attributes )
+{
+  setFields( fields, attributes );
+}
+
+void QgsFeatureBatch::setFields( const QgsFields &fields, const QgsAttributeList &attributes )
+{
+  mFields = fields;
+  mColumns.clear();
+  mAttributeToColumn = QVector< int >( fields.count(), -1 );
+
+  QgsAttributeList columnAttributes = attributes;
+  if ( columnAttributes.isEmpty() )
+    columnAttributes = fields.allAttributesList();
+
+  for ( int attributeIndex : qgis::as_const( columnAttributes ) )
+  {
+    if ( attributeIndex < 0 || attributeIndex >= fields.count() || mAttributeToColumn.at( attributeIndex ) >= 0 )
+      continue;
+
+    Column column;
+    column.type = columnTypeForField( fields.at( attributeIndex ) );
+    column.attributeIndex = attributeIndex;
+    if ( column.type == StringColumn )
+      column.stringOffsets << 0;
+    mAttributeToColumn[ attributeIndex ] = mColumns.size();
+    mColumns << column;
+  }
+
+  clear();
+}
+
+void QgsFeatureBatch::clear()
+{
+  for ( Column &column : mColumns )
+  {
+    column.nulls.clear();
+    column.ints.clear();
+    column.doubles.clear();
+    column.stringData.clear();
+    column.variants.clear();
+    if ( column.type == StringColumn )
+    {
+      column.stringOffsets.clear();
+      column.stringOffsets << 0;
+    }
+  }
+
+  mIds.clear();
+  mGeometryTypes.clear();
+  mPartOffsets.clear();
+  mPartOffsets << 0;
+  mPartTypes.clear();
+  mRingOffsets.clear();
+  mRingOffsets << 0;
+  mVertexOffsets.clear();
+  mVertexOffsets << 0;
+  mXY.clear();
+  mZ.clear();
+  mM.clear();
+}
+
+int QgsFeatureBatch::columnForAttribute( int attributeIndex ) const
+{
+  if ( attributeIndex < 0 || attributeIndex >= mAttributeToColumn.size() )
+    return -1;
+  return mAttributeToColumn.at( attributeIndex );
+}
+
+void QgsFeatureBatch::reserve( int rows )
+{
+  mIds.reserve( rows );
+  mGeometryTypes.reserve( rows );
+  mPartOffsets.reserve( rows + 1 );
+  for ( Column &column : mColumns )
+  {
+    column.nulls.reserve( rows );
+    switch ( column.type )
+    {
+      case Int64Column:
+        column.ints.reserve( rows );
+        break;
+      case DoubleColumn:
+        column.doubles.reserve( rows );
+        break;
+      case StringColumn:
+        column.stringOffsets.reserve( rows + 1 );
+        break;
+      case VariantColumn:
+        column.variants.reserve( rows );
+        break;
+    }
+  }
+}
+
+int QgsFeatureBatch::addFeature( QgsFeatureId id )
+{
+  mIds << id;
+  mGeometryTypes << QgsWkbTypes::NoGeometry;
+  mPartOffsets << mPartOffsets.last();
+
+  for ( Column &column : mColumns )
+  {
+    column.nulls << true;
+    switch ( column.type )
+    {
+      case Int64Column:
+        column.ints << 0;
+        break;
+      case DoubleColumn:
+        column.doubles << 0;
+        break;
+      case StringColumn:
+        column.stringOffsets << column.stringOffsets.last();
+        break;
+      case VariantColumn:
+        column.variants << QVariant();
+        break;
+    }
+  }
+
+  return mIds.size() - 1;
+}
+
+int QgsFeatureBatch::addFeature( const QgsFeature &feature, bool includeGeometry )
+{
+  const int row = addFeature( feature.id() );
+
+  const QgsAttributes attributes = feature.attributes();
+  for ( int column = 0; column < mColumns.size(); ++column )
+  {
+    const int attributeIndex = mColumns.at( column ).attributeIndex;
+    if ( attributeIndex < attributes.size() )
+      setValue( column, attributes.at( attributeIndex ) );
+  }
+
+  if ( includeGeometry && feature.hasGeometry() )
+    setGeometry( feature.geometry().constGet() );
+
+  return row;
+}
+
+void QgsFeatureBatch::setNull( int column )
+{
+  Column &c = mColumns[ column ];
+  c.nulls.last() = true;
+  switch ( c.type )
+  {
+    case Int64Column:
+    case DoubleColumn:
+      break;
+    case StringColumn:
+    {
+      const int start = c.stringOffsets.at( c.stringOffsets.size() - 2 );
+      c.stringData.truncate( start );
+      c.stringOffsets.last() = start;
+      break;
+    }
+    case VariantColumn:
+      c.variants.last() = QVariant();
+      break;
+  }
+}
+
+void QgsFeatureBatch::setInt64( int column, qint64 value )
+{
+  Column &c = mColumns[ column ];
+  Q_ASSERT( c.type == Int64Column );
+  c.ints.last() = value;
+  c.nulls.last() = false;
+}
+
+void QgsFeatureBatch::setDouble( int column, double value )
+{
+  Column &c = mColumns[ column ];
+  Q_ASSERT( c.type == DoubleColumn );
+  c.doubles.last() = value;
+  c.nulls.last() = false;
+}
+
+void QgsFeatureBatch::setString( int column, const char *utf8, int length )
+{
+  Column &c = mColumns[ column ];
+  Q_ASSERT( c.type == StringColumn );
+  const int start = c.stringOffsets.at( c.stringOffsets.size() - 2 );
+  c.stringData.truncate( start );
+  c.stringData.append( utf8, length );
+  c.stringOffsets.last() = c.stringData.size();
+  c.nulls.last() = false;
+}
+
+void QgsFeatureBatch::setString( int column, const QString &value )
+{
+  const QByteArray utf8 = value.toUtf8();
+  setString( column, utf8.constData(), utf8.size() );
+}
+
+void QgsFeatureBatch::setValue( int column, const QVariant &value )
+{
+  if ( value.isNull() )
+  {
+    setNull( column );
+    return;
+  }
+
+  Column &c = mColumns[ column ];
+  switch ( c.type )
+  {
+    case Int64Column:
+    {
+      bool ok = false;
+      const qint64 v = value.toLongLong( &ok );
+      if ( ok )
+        setInt64( column, v );
+      else
+        setNull( column );
+      break;
+    }
+    case DoubleColumn:
+    {
+      bool ok = false;
+      const double v = value.toDouble( &ok );
+      if ( ok )
+        setDouble( column, v );
+      else
+        setNull( column );
+      break;
+    }
+    case StringColumn:
+      setString( column, value.toString() );
+      break;
+    case VariantColumn:
+      c.variants.last() = value;
+      c.nulls.last() = false;
+      break;
+  }
+}
+
+const char *QgsFeatureBatch::stringView( int column, int row, int &length ) const
+{
+  const Column &c = mColumns.at( column );
+  Q_ASSERT( c.type == StringColumn );
+  const int start = c.stringOffsets.at( row );
+  length = c.stringOffsets.at( row + 1 ) - start;
+  return c.stringData.constData() + start;
+}
+
+QVariant QgsFeatureBatch::value( int column, int row ) const
+{
+  const Column &c = mColumns.at( column );
+  const QVariant::Type fieldType = mFields.at( c.attributeIndex ).type();
+  if ( c.nulls.at( row ) )
+    return QVariant( fieldType );
+
+  switch ( c.type )
+  {
+    case Int64Column:
+    {
+      const qint64 v = c.ints.at( row );
+      switch ( fieldType )
+      {
+        case QVariant::Int:
+          return static_cast< int >( v );
+        case QVariant::UInt:
+          return static_cast< uint >( v );
+        case QVariant::Bool:
+          return v != 0;
+        case QVariant::ULongLong:
+          return static_cast< qulonglong >( v );
+        default:
+          return v;
+      }
+    }
+    case DoubleColumn:
+      return c.doubles.at( row );
+    case StringColumn:
+    {
+      int length = 0;
+      const char *data = stringView( column, row, length );
+      return QString::fromUtf8( data, length );
+    }
+    case VariantColumn:
+      return c.variants.at( row );
+  }
+  return QVariant();
+}
+
+QgsFeatureBatch::ColumnType QgsFeatureBatch::columnTypeForField( const QgsField &field )
+{
+  switch ( field.type() )
+  {
+    case QVariant::Int:
+    case QVariant::UInt:
+    case QVariant::LongLong:
+    case QVariant::ULongLong:
+    case QVariant::Bool:
+      return Int64Column;
+    case QVariant::Double:
+      return DoubleColumn;
+    case QVariant::String:
+      return StringColumn;
+    default:
+      return VariantColumn;
+  }
+}
+
+//
+// Geometry storage
+//
+
+void QgsFeatureBatch::addPart( QgsWkbTypes::Type type )
+{
+  mPartTypes << type;
+  mRingOffsets << mRingOffsets.last();
+  mPartOffsets.last() = mPartTypes.size();
+}
+
+void QgsFeatureBatch::addRing()
+{
+  mVertexOffsets << mVertexOffsets.last();
+  mRingOffsets.last() = mVertexOffsets.size() - 1;
+}
+
+void QgsFeatureBatch::addVertex( double x, double y, double z, double m )
+{
+  const int index = vertexCount();
+  mXY << x << y;
+
+  // z and m buffers are only allocated once a vertex has such a value, and are then kept in sync
+  if ( !mZ.isEmpty() || !std::isnan( z ) )
+  {
+    if ( mZ.size() < index )
+      mZ.insert( mZ.size(), index - mZ.size(), std::numeric_limits< double >::quiet_NaN() );
+    mZ << z;
+  }
+  if ( !mM.isEmpty() || !std::isnan( m ) )
+  {
+    if ( mM.size() < index )
+      mM.insert( mM.size(), index - mM.size(), std::numeric_limits< double >::quiet_NaN() );
+    mM << m;
+  }
+
+  mVertexOffsets.last() = index + 1;
+}
+
+void QgsFeatureBatch::rollbackGeometry()
+{
+  Q_ASSERT( !mIds.isEmpty() );
+  const int row = mIds.size() - 1;
+  const int partStart = mPartOffsets.at( row );
+  const int ringStart = mRingOffsets.at( partStart );
+  const int vertexStart = mVertexOffsets.at( ringStart );
+
+  mGeometryTypes.last() = QgsWkbTypes::NoGeometry;
+  mPartOffsets.last() = partStart;
+  mPartTypes.resize( partStart );
+  mRingOffsets.resize( partStart + 1 );
+  mVertexOffsets.resize( ringStart + 1 );
+  mXY.resize( vertexStart * 2 );
+  if ( mZ.size() > vertexStart )
+    mZ.resize( vertexStart );
+  if ( mM.size() > vertexStart )
+    mM.resize( vertexStart );
+}
+
+void QgsFeatureBatch::setGeometry( const QgsAbstractGeometry *geometry )
+{
+  rollbackGeometry();
+  if ( !geometry )
+    return;
+
+  if ( const QgsGeometryCollection *collection = qgsgeometry_cast< const QgsGeometryCollection * >( geometry ) )
+  {
+    for ( int i = 0; i < collection->numGeometries(); ++i )
+      addGeometryPart( collection->geometryN( i ) );
+  }
+  else
+  {
+    addGeometryPart( geometry );
+  }
+  mGeometryTypes.last() = QgsWkbTypes::linearType( geometry->wkbType() );
+}
+
+void QgsFeatureBatch::addGeometryPart( const QgsAbstractGeometry *part )
+{
+  if ( const QgsPoint *point = qgsgeometry_cast< const QgsPoint * >( part ) )
+  {
+    addPart( point->wkbType() );
+    addRing();
+    addVertex( point->x(), point->y(), point->is3D() ? point->z() : std::numeric_limits< double >::quiet_NaN(),
+               point->isMeasure() ? point->m() : std::numeric_limits< double >::quiet_NaN() );
+  }
+  else if ( const QgsCurve *curve = qgsgeometry_cast< const QgsCurve * >( part ) )
+  {
+    addPart( QgsWkbTypes::linearType( curve->wkbType() ) );
+    addRingFromCurve( curve );
+  }
+  else if ( const QgsCurvePolygon *polygon = qgsgeometry_cast< const QgsCurvePolygon * >( part ) )
+  {
+    addPart( QgsWkbTypes::linearType( polygon->wkbType() ) );
+    if ( polygon->exteriorRing() )
+      addRingFromCurve( polygon->exteriorRing() );
+    for ( int i = 0; i < polygon->numInteriorRings(); ++i )
+      addRingFromCurve( polygon->interiorRing( i ) );
+  }
+  else if ( const QgsGeometryCollection *collection = qgsgeometry_cast< const QgsGeometryCollection * >( part ) )
+  {
+    for ( int i = 0; i < collection->numGeometries(); ++i )
+      addGeometryPart( collection->geometryN( i ) );
+  }
+}
+
+void QgsFeatureBatch::addRingFromCurve( const QgsCurve *curve )
+{
+  std::unique_ptr< QgsLineString > segmentized;
+  const QgsLineString *line = qgsgeometry_cast< const QgsLineString * >( curve );
+  if ( !line )
+  {
+    segmentized.reset( curve->curveToLine() );
+    line = segmentized.get();
+  }
+
+  addRing();
+  const int count = line->numPoints();
+  const double *x = line->xData();
+  const double *y = line->yData();
+  const double *z = line->is3D() ? line->zData() : nullptr;
+  const double *m = line->isMeasure() ? line->mData() : nullptr;
+  const double nan = std::numeric_limits< double >::quiet_NaN();
+  for ( int i = 0; i < count; ++i )
+  {
+    addVertex( x[i], y[i], z ? z[i] : nan, m ? m[i] : nan );
+  }
+}
+
+bool QgsFeatureBatch::setGeometryFromWkb( const unsigned char *wkb, int size, bool forceMulti )
+{
+  rollbackGeometry();
+  if ( !wkb || size <= 0 )
+    return false;
+
+  const unsigned char *p = wkb;
+  QgsWkbTypes::Type type = QgsWkbTypes::Unknown;
+  if ( !parseWkb( p, wkb + size, type ) )
+  {
+    rollbackGeometry();
+
+    // not a linear geometry -- let the geometry classes handle it, and segmentize the result
+    QgsGeometry geometry;
+    geometry.fromWkb( QByteArray( reinterpret_cast< const char * >( wkb ), size ) );
+    if ( geometry.isNull() )
+      return false;
+    setGeometry( geometry.constGet() );
+    type = mGeometryTypes.last();
+  }
+
+  mGeometryTypes.last() = forceMulti ? QgsWkbTypes::multiType( type ) : type;
+  return true;
+}
+
+bool QgsFeatureBatch::parseWkb( const unsigned char *&p, const unsigned char *end, QgsWkbTypes::Type &type )
+{
+  if ( end - p < 5 )
+    return false;
+
+  const bool littleEndian = *p++ == 1;
+  quint32 rawType = 0;
+  if ( !readUInt32( p, end, littleEndian, rawType ) )
+    return false;
+
+  bool hasZ = rawType & EWKB_Z_FLAG;
+  bool hasM = rawType & EWKB_M_FLAG;
+  if ( rawType & EWKB_SRID_FLAG )
+  {
+    quint32 srid;
+    if ( !readUInt32( p, end, littleEndian, srid ) )
+      return false;
+  }
+  rawType &= 0x0FFFFFFF;
+
+  // ISO WKB encodes dimensions in the thousands
+  switch ( rawType / 1000 )
+  {
+    case 1:
+      hasZ = true;
+      break;
+    case 2:
+      hasM = true;
+      break;
+    case 3:
+      hasZ = true;
+      hasM = true;
+      break;
+    default:
+      break;
+  }
+  const quint32 baseType = rawType % 1000;
+  const int dimensions = 2 + ( hasZ ? 1 : 0 ) + ( hasM ? 1 : 0 );
+
+  auto withDimensions = [hasZ, hasM]( QgsWkbTypes::Type t )
+  {
+    if ( hasZ )
+      t = QgsWkbTypes::addZ( t );
+    if ( hasM )
+      t = QgsWkbTypes::addM( t );
+    return t;
+  };
+
+  auto readPoints = [&]() -> bool
+  {
+    quint32 count = 0;
+    if ( !readUInt32( p, end, littleEndian, count ) )
+      return false;
+    if ( static_cast< quint64 >( end - p ) < static_cast< quint64 >( count ) * dimensions * sizeof( double ) )
+      return false;
+
+    addRing();
+    const double nan = std::numeric_limits< double >::quiet_NaN();
+    for ( quint32 i = 0; i < count; ++i )
+    {
+      const double x = readDouble( p, littleEndian );
+      const double y = readDouble( p, littleEndian );
+      const double z = hasZ ? readDouble( p, littleEndian ) : nan;
+      const double m = hasM ? readDouble( p, littleEndian ) : nan;
+      addVertex( x, y, z, m );
+    }
+    return true;
+  };
+
+  switch ( baseType )
+  {
+    case QgsWkbTypes::Point:
+    {
+      if ( static_cast< quint64 >( end - p ) < dimensions * sizeof( double ) )
+        return false;
+      type = withDimensions( QgsWkbTypes::Point );
+      addPart( type );
+      addRing();
+      const double nan = std::numeric_limits< double >::quiet_NaN();
+      const double x = readDouble( p, littleEndian );
+      const double y = readDouble( p, littleEndian );
+      const double z = hasZ ? readDouble( p, littleEndian ) : nan;
+      const double m = hasM ? readDouble( p, littleEndian ) : nan;
+      addVertex( x, y, z, m );
+      return true;
+    }
+
+    case QgsWkbTypes::LineString:
+      type = withDimensions( QgsWkbTypes::LineString );
+      addPart( type );
+      return readPoints();
+
+    case QgsWkbTypes::Polygon:
+    case QgsWkbTypes::Triangle:
+    {
+      type = withDimensions( QgsWkbTypes::Polygon );
+      addPart( type );
+      quint32 ringCount = 0;
+      if ( !readUInt32( p, end, littleEndian, ringCount ) )
+        return false;
+      for ( quint32 i = 0; i < ringCount; ++i )
+      {
+        if ( !readPoints() )
+          return false;
+      }
+      return true;
+    }
+
+    case QgsWkbTypes::MultiPoint:
+    case QgsWkbTypes::MultiLineString:
+    case QgsWkbTypes::MultiPolygon:
+    case QgsWkbTypes::GeometryCollection:
+    case 15: // PolyhedralSurface
+    case 16: // TIN
+    {
+      type = withDimensions( baseType == QgsWkbTypes::MultiPoint || baseType == QgsWkbTypes::MultiLineString || baseType == QgsWkbTypes::GeometryCollection
+                             ? static_cast< QgsWkbTypes::Type >( baseType ) : QgsWkbTypes::MultiPolygon );
+      quint32 partCount = 0;
+      if ( !readUInt32( p, end, littleEndian, partCount ) )
+        return false;
+      for ( quint32 i = 0; i < partCount; ++i )
+      {
+        QgsWkbTypes::Type partType;
+        if ( !parseWkb( p, end, partType ) )
+          return false;
+      }
+      return true;
+    }
+
+    default:
+      // curved geometries are handled by the caller
+      return false;
+  }
+}
+
+std::unique_ptr< QgsLineString > QgsFeatureBatch::buildRing( int ring, bool hasZ, bool hasM ) const
+{
+  const int start = mVertexOffsets.at( ring );
+  const int end = mVertexOffsets.at( ring + 1 );
+  const int count = end - start;
+
+  QVector< double > x( count );
+  QVector< double > y( count );
+  QVector< double > z;
+  QVector< double > m;
+  double *xOut = x.data();
+  double *yOut = y.data();
+  const double *xy = mXY.constData() + 2 * start;
+  for ( int i = 0; i < count; ++i )
+  {
+    *xOut++ = *xy++;
+    *yOut++ = *xy++;
+  }
+  if ( hasZ && !mZ.isEmpty() )
+    z = mZ.mid( start, count );
+  if ( hasM && !mM.isEmpty() )
+    m = mM.mid( start, count );
+
+  return qgis::make_unique< QgsLineString >( x, y, z, m );
+}
+
+std::unique_ptr< QgsAbstractGeometry > QgsFeatureBatch::buildPart( int part ) const
+{
+  const QgsWkbTypes::Type type = mPartTypes.at( part );
+  const bool hasZ = QgsWkbTypes::hasZ( type );
+  const bool hasM = QgsWkbTypes::hasM( type );
+  const int ringStart = mRingOffsets.at( part );
+  const int ringEnd = mRingOffsets.at( part + 1 );
+
+  switch ( QgsWkbTypes::flatType( type ) )
+  {
+    case QgsWkbTypes::Point:
+    {
+      const int vertex = mVertexOffsets.at( ringStart );
+      const double nan = std::numeric_limits< double >::quiet_NaN();
+      return qgis::make_unique< QgsPoint >( type, mXY.at( 2 * vertex ), mXY.at( 2 * vertex + 1 ),
+                                            hasZ && !mZ.isEmpty() ? mZ.at( vertex ) : nan,
+                                            hasM && !mM.isEmpty() ? mM.at( vertex ) : nan );
+    }
+
+    case QgsWkbTypes::LineString:
+      return buildRing( ringStart, hasZ, hasM );
+
+    case QgsWkbTypes::Polygon:
+    {
+      std::unique_ptr< QgsPolygon > polygon = qgis::make_unique< QgsPolygon >();
+      if ( ringStart < ringEnd )
+        polygon->setExteriorRing( buildRing( ringStart, hasZ, hasM ).release() );
+      for ( int ring = ringStart + 1; ring < ringEnd; ++ring )
+        polygon->addInteriorRing( buildRing( ring, hasZ, hasM ).release() );
+      return std::move( polygon );
+    }
+
+    default:
+      return nullptr;
+  }
+}
+
+QgsGeometry QgsFeatureBatch::geometry( int row ) const
+{
+  const QgsWkbTypes::Type type = mGeometryTypes.at( row );
+  if ( type == QgsWkbTypes::NoGeometry || type == QgsWkbTypes::Unknown )
+    return QgsGeometry();
+
+  const int partStart = mPartOffsets.at( row );
+  const int partEnd = mPartOffsets.at( row + 1 );
+
+  if ( QgsWkbTypes::isMultiType( type ) )
+  {
+    std::unique_ptr< QgsAbstractGeometry > geometry = QgsGeometryFactory::geomFromWkbType( type );
+    QgsGeometryCollection *collection = qgsgeometry_cast< QgsGeometryCollection * >( geometry.get() );
+    if ( !collection )
+      return QgsGeometry();
+    for ( int part = partStart; part < partEnd; ++part )
+    {
+      if ( std::unique_ptr< QgsAbstractGeometry > partGeometry = buildPart( part ) )
+        collection->addGeometry( partGeometry.release() );
+    }
+    return QgsGeometry( std::move( geometry ) );
+  }
+
+  if ( partStart == partEnd )
+    return QgsGeometry( QgsGeometryFactory::geomFromWkbType( type ) );
+
+  return QgsGeometry( buildPart( partStart ) );
+}
+
+QgsFeature QgsFeatureBatch::feature( int row ) const
+{
+  QgsFeature feature( mFields, mIds.at( row ) );
+  for ( int column = 0; column < mColumns.size(); ++column )
+  {
+    feature.setAttribute( mColumns.at( column ).attributeIndex, value( column, row ) );
+  }
+  feature.setGeometry( geometry( row ) );
+  return feature;
+}
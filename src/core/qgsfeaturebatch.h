@@ -0,0 +1,306 @@
+/***************************************************************************
+    qgsfeaturebatch.h
+    ---------------------
+    begin                : October 2026
+    copyright            : (C) 2026 by QGIS contributors
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef QGSFEATUREBATCH_H
+#define QGSFEATUREBATCH_H
+
+#include "qgis_core.h"
+#include "qgsfields.h"
+#include "qgsfeatureid.h"
+#include "qgswkbtypes.h"
+#include "qgsgeometry.h"
+
+#include <QVector>
+#include <QByteArray>
+#include <memory>
+
+#define SIP_NO_FILE
+
+class QgsFeature;
+class QgsAbstractGeometry;
+class QgsCurve;
+class QgsLineString;
+
+/**
+ * \ingroup core
+ * \class QgsFeatureBatch
+ *
+ * A batch of features stored column by column ("structure of arrays").
+ *
+ * Instead of one QgsFeature (with a QVariant per attribute and a heap allocated
+ * geometry) per row, a batch stores its attribute values in typed column arrays and
+ * all feature geometries in a single flat coordinate buffer. Batches are filled by
+ * QgsFeatureIterator::nextBatch(), and can be reused between calls to avoid reallocating
+ * their buffers.
+ *
+ * Attribute columns are stored depending on their field type:
+ *
+ * - integer and boolean fields are stored as 64 bit integers, see int64Data()
+ * - double fields are stored as doubles, see doubleData()
+ * - string fields are stored as UTF-8 bytes in a single buffer, with one offset per row, see stringView()
+ * - all other field types are stored as QVariant values, see value()
+ *
+ * Geometries are stored with nested offsets: each feature has a range of parts, each part a range
+ * of rings and each ring a range of vertices. Points and linestrings have a single ring per part,
+ * polygons have one ring per exterior/interior ring. Curved geometries are segmentized when they
+ * are added to a batch.
+ *
+ * Values are always appended to the last row of the batch, which is created by calling addFeature().
+ *
+ * \note Not available in Python bindings.
+ * \since QGIS 3.18
+ */
+class CORE_EXPORT QgsFeatureBatch
+{
+  public:
+
+    //! Storage type of an attribute column
+    enum ColumnType
+    {
+      Int64Column, //!< 64 bit integer values
+      DoubleColumn, //!< Double values
+      StringColumn, //!< UTF-8 string values
+      VariantColumn, //!< Values of any other type, stored as QVariant
+    };
+
+    /**
+     * Constructor for an empty QgsFeatureBatch, without any attribute columns.
+     */
+    QgsFeatureBatch() = default;
+
+    /**
+     * Constructor for QgsFeatureBatch with a column for each of the specified \a attributes
+     * from \a fields.
+     *
+     * If \a attributes is empty, a column is created for every field.
+     */
+    explicit QgsFeatureBatch( const QgsFields &fields, const QgsAttributeList &attributes = QgsAttributeList() );
+
+    /**
+     * Resets the column layout of the batch to the specified \a attributes from \a fields.
+     *
+     * If \a attributes is empty, a column is created for every field. All rows are removed.
+     */
+    void setFields( const QgsFields &fields, const QgsAttributeList &attributes = QgsAttributeList() );
+
+    /**
+     * Returns the fields the batch columns refer to.
+     */
+    QgsFields fields() const { return mFields; }
+
+    /**
+     * Removes all rows from the batch, but keeps the allocated buffers and column layout so
+     * that the batch can be refilled cheaply.
+     */
+    void clear();
+
+    //! Returns the number of features in the batch.
+    int size() const { return mIds.size(); }
+
+    //! Returns TRUE if the batch does not contain any features.
+    bool isEmpty() const { return mIds.isEmpty(); }
+
+    //! Returns the number of attribute columns in the batch.
+    int columnCount() const { return mColumns.size(); }
+
+    //! Returns the storage type of the specified \a column.
+    ColumnType columnType( int column ) const { return mColumns.at( column ).type; }
+
+    //! Returns the field index the specified \a column contains.
+    int attributeIndex( int column ) const { return mColumns.at( column ).attributeIndex; }
+
+    //! Returns the column containing the field with index \a attributeIndex, or -1 if the field is not part of the batch.
+    int columnForAttribute( int attributeIndex ) const;
+
+    /**
+     * Reserves space for \a rows features.
+     */
+    void reserve( int rows );
+
+    /**
+     * Appends a new feature with the specified \a id and returns its row number.
+     *
+     * All attributes of the new row are NULL and its geometry is empty until set by the
+     * setter methods, which always operate on the last row.
+     */
+    int addFeature( QgsFeatureId id );
+
+    /**
+     * Appends the attributes and geometry of a \a feature to the batch, and returns its row number.
+     *
+     * If \a includeGeometry is FALSE the geometry of the row is left empty.
+     *
+     * This is the (slower) fallback used for providers which do not fill batches natively.
+     */
+    int addFeature( const QgsFeature &feature, bool includeGeometry = true );
+
+    //! Sets the value of \a column in the last row to NULL.
+    void setNull( int column );
+
+    //! Sets the value of \a column in the last row to the integer \a value.
+    void setInt64( int column, qint64 value );
+
+    //! Sets the value of \a column in the last row to the double \a value.
+    void setDouble( int column, double value );
+
+    //! Sets the value of \a column in the last row to the UTF-8 string of \a length bytes starting at \a utf8.
+    void setString( int column, const char *utf8, int length );
+
+    //! Sets the value of \a column in the last row to the string \a value.
+    void setString( int column, const QString &value );
+
+    /**
+     * Sets the value of \a column in the last row to \a value, converting it to
+     * the column's storage type.
+     */
+    void setValue( int column, const QVariant &value );
+
+    /**
+     * Sets the geometry of the last row from a WKB (or PostGIS EWKB) blob of \a size bytes.
+     *
+     * Linear geometries are decoded straight into the coordinate buffer. If \a forceMulti is TRUE
+     * single part geometries are flagged as their multipart type.
+     *
+     * Returns FALSE if the blob could not be parsed, in which case the row's geometry is left empty.
+     */
+    bool setGeometryFromWkb( const unsigned char *wkb, int size, bool forceMulti = false );
+
+    /**
+     * Sets the geometry of the last row from an abstract \a geometry.
+     */
+    void setGeometry( const QgsAbstractGeometry *geometry );
+
+    //! Returns the feature id of the specified \a row.
+    QgsFeatureId id( int row ) const { return mIds.at( row ); }
+
+    //! Returns all feature ids in the batch.
+    const QVector< QgsFeatureId > &ids() const { return mIds; }
+
+    //! Returns TRUE if the value of \a column is NULL for the specified \a row.
+    bool isNull( int column, int row ) const { return mColumns.at( column ).nulls.at( row ); }
+
+    /**
+     * Returns the integer values of an Int64Column.
+     *
+     * The values of NULL rows are undefined.
+     */
+    const qint64 *int64Data( int column ) const { return mColumns.at( column ).ints.constData(); }
+
+    /**
+     * Returns the double values of a DoubleColumn.
+     *
+     * The values of NULL rows are undefined.
+     */
+    const double *doubleData( int column ) const { return mColumns.at( column ).doubles.constData(); }
+
+    /**
+     * Returns a pointer to the UTF-8 bytes of a StringColumn \a row and sets \a length to the number of bytes.
+     *
+     * The returned data is not null terminated.
+     */
+    const char *stringView( int column, int row, int &length ) const;
+
+    /**
+     * Returns the value of \a column for \a row as a QVariant, regardless of the column type.
+     */
+    QVariant value( int column, int row ) const;
+
+    //! Returns the WKB type of the geometry of \a row, or QgsWkbTypes::NoGeometry if it has no geometry.
+    QgsWkbTypes::Type geometryType( int row ) const { return mGeometryTypes.at( row ); }
+
+    /**
+     * Returns the part offsets of all rows. The parts of row \a i are in the range
+     * partOffsets()[i] to partOffsets()[i + 1]. Contains size() + 1 elements.
+     */
+    const QVector< int > &partOffsets() const { return mPartOffsets; }
+
+    //! Returns the flat single WKB type of each part.
+    const QVector< QgsWkbTypes::Type > &partTypes() const { return mPartTypes; }
+
+    /**
+     * Returns the ring offsets of all parts. The rings of part \a i are in the range
+     * ringOffsets()[i] to ringOffsets()[i + 1].
+     */
+    const QVector< int > &ringOffsets() const { return mRingOffsets; }
+
+    /**
+     * Returns the vertex offsets of all rings. The vertices of ring \a i are in the range
+     * vertexOffsets()[i] to vertexOffsets()[i + 1].
+     */
+    const QVector< int > &vertexOffsets() const { return mVertexOffsets; }
+
+    //! Returns the interleaved x/y coordinates of all vertices.
+    const QVector< double > &xy() const { return mXY; }
+
+    //! Returns the z values of all vertices. This is empty if no geometry in the batch has z values.
+    const QVector< double > &z() const { return mZ; }
+
+    //! Returns the m values of all vertices. This is empty if no geometry in the batch has m values.
+    const QVector< double > &m() const { return mM; }
+
+    //! Returns the number of vertices stored in the batch.
+    int vertexCount() const { return mXY.size() / 2; }
+
+    /**
+     * Builds a geometry for the specified \a row.
+     */
+    QgsGeometry geometry( int row ) const;
+
+    /**
+     * Builds a feature for the specified \a row. Attributes which are not part of the batch are NULL.
+     */
+    QgsFeature feature( int row ) const;
+
+  private:
+
+    struct Column
+    {
+      ColumnType type = VariantColumn;
+      int attributeIndex = -1;
+      QVector< bool > nulls;
+      QVector< qint64 > ints;
+      QVector< double > doubles;
+      QByteArray stringData;
+      QVector< int > stringOffsets;
+      QVector< QVariant > variants;
+    };
+
+    static ColumnType columnTypeForField( const QgsField &field );
+
+    void addPart( QgsWkbTypes::Type type );
+    void addRing();
+    void addVertex( double x, double y, double z, double m );
+    void addGeometryPart( const QgsAbstractGeometry *part );
+    void addRingFromCurve( const QgsCurve *curve );
+    bool parseWkb( const unsigned char *&wkb, const unsigned char *end, QgsWkbTypes::Type &type );
+    void rollbackGeometry();
+    std::unique_ptr< QgsAbstractGeometry > buildPart( int part ) const;
+    std::unique_ptr< QgsLineString > buildRing( int ring, bool hasZ, bool hasM ) const;
+
+    QgsFields mFields;
+    QVector< Column > mColumns;
+    QVector< int > mAttributeToColumn;
+
+    QVector< QgsFeatureId > mIds;
+    QVector< QgsWkbTypes::Type > mGeometryTypes;
+    QVector< int > mPartOffsets = QVector< int >() << 0;
+    QVector< QgsWkbTypes::Type > mPartTypes;
+    QVector< int > mRingOffsets = QVector< int >() << 0;
+    QVector< int > mVertexOffsets = QVector< int >() << 0;
+    QVector< double > mXY;
+    QVector< double > mZ;
+    QVector< double > mM;
+};
+
+#endif // QGSFEATUREBATCH_H
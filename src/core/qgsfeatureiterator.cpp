@@ -18,6 +18,7 @@
 #include "qgssimplifymethod.h"
 #include "qgsexception.h"
 #include "qgsexpressionsorter.h"
+#include "qgsfeaturebatch.h"
 
 QgsAbstractFeatureIterator::QgsAbstractFeatureIterator( const QgsFeatureRequest &request )
   : mRequest( request )
@@ -71,6 +72,38 @@ bool QgsAbstractFeatureIterator::nextFeature( QgsFeature &f )
   return dataOk;
 }
 
+bool QgsAbstractFeatureIterator::nextBatch( QgsFeatureBatch &batch, int maxFeatures )
+{
+  batch.clear();
+
+  if ( mRequest.limit() >= 0 )
+    maxFeatures = static_cast< int >( std::min( static_cast< long >( maxFeatures ), mRequest.limit() - mFetchedCount ) );
+  if ( maxFeatures <= 0 )
+    return false;
+
+  if ( mUseCachedFeatures || mRequest.filterType() != QgsFeatureRequest::FilterNone )
+  {
+    // ordered features and filtered requests go through the regular feature path
+    QgsFeature f;
+    while ( batch.size() < maxFeatures && nextFeature( f ) )
+      batch.addFeature( f );
+    return !batch.isEmpty();
+  }
+
+  batch.reserve( maxFeatures );
+  fetchBatch( batch, maxFeatures );
+  mFetchedCount += batch.size();
+  return !batch.isEmpty();
+}
+
+bool QgsAbstractFeatureIterator::fetchBatch( QgsFeatureBatch &batch, int maxFeatures )
+{
+  QgsFeature f;
+  while ( batch.size() < maxFeatures && fetchFeature( f ) )
+    batch.addFeature( f );
+  return !batch.isEmpty();
+}
+
 bool QgsAbstractFeatureIterator::nextFeatureFilterExpression( QgsFeature &f )
 {
   while ( fetchFeature( f ) )
@@ -20,6 +20,7 @@
 #include "qgsindexedfeature.h"
 
 class QgsFeedback;
+class QgsFeatureBatch;
 
 /**
  * \ingroup core
@@ -46,6 +47,23 @@ class CORE_EXPORT QgsAbstractFeatureIterator
     //! fetch next feature, return TRUE on success
     virtual bool nextFeature( QgsFeature &f );
 
+    /**
+     * Fetches up to \a maxFeatures of the next features into a columnar \a batch.
+     *
+     * The batch is cleared first. Its column layout is left untouched, so the caller is
+     * responsible for setting it up for the fields (and attribute subset) of the request.
+     *
+     * Requests without a filter (other than a filter rectangle) are passed on to fetchBatch(),
+     * which providers can implement to fill the batch without creating intermediate QgsFeature
+     * objects. All other requests are served through nextFeature().
+     *
+     * Returns TRUE if at least one feature was fetched.
+     *
+     * \note not available in Python bindings
+     * \since QGIS 3.18
+     */
+    virtual bool nextBatch( QgsFeatureBatch &batch, int maxFeatures ) SIP_SKIP;
+
     //! reset the iterator to the starting position
     virtual bool rewind() = 0;
     //! end of iterating: free the resources / lock
@@ -102,6 +120,19 @@ class CORE_EXPORT QgsAbstractFeatureIterator
      */
     virtual bool fetchFeature( QgsFeature &f ) = 0;
 
+    /**
+     * Appends up to \a maxFeatures features to \a batch.
+     *
+     * The default implementation calls fetchFeature() for each feature. Providers which can
+     * fill the batch columns directly from their native representation should override
+     * this method.
+     *
+     * \returns TRUE if at least one feature was appended
+     * \note not available in Python bindings
+     * \since QGIS 3.18
+     */
+    virtual bool fetchBatch( QgsFeatureBatch &batch, int maxFeatures ) SIP_SKIP;
+
     /**
      * By default, the iterator will fetch all features and check if the feature
      * matches the expression.
@@ -299,6 +330,17 @@ class CORE_EXPORT QgsFeatureIterator
     QgsFeatureIterator &operator=( const QgsFeatureIterator &other );
 
     bool nextFeature( QgsFeature &f );
+
+    /**
+     * Fetches up to \a maxFeatures of the next features into a columnar \a batch.
+     * Returns TRUE if at least one feature was fetched.
+     *
+     * \see QgsAbstractFeatureIterator::nextBatch()
+     * \note not available in Python bindings
+     * \since QGIS 3.18
+     */
+    bool nextBatch( QgsFeatureBatch &batch, int maxFeatures ) SIP_SKIP;
+
     bool rewind();
     bool close();
 
@@ -376,6 +418,11 @@ inline bool QgsFeatureIterator::nextFeature( QgsFeature &f )
   return mIter ? mIter->nextFeature( f ) : false;
 }
 
+inline bool QgsFeatureIterator::nextBatch( QgsFeatureBatch &batch, int maxFeatures )
+{
+  return mIter ? mIter->nextBatch( batch, maxFeatures ) : false;
+}
+
 inline bool QgsFeatureIterator::rewind()
 {
   if ( mIter )
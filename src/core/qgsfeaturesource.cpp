@@ -23,6 +23,8 @@
 #include "qgsvectorlayer.h"
 #include "qgsvectordataprovider.h"
 
+#include <algorithm>
+
 QgsFeatureSource::FeatureAvailability QgsFeatureSource::hasFeatures() const
 {
   return FeaturesMaybeAvailable;
@@ -192,3 +194,46 @@ QgsFeatureSource::SpatialIndexPresence QgsFeatureSource::hasSpatialIndex() const
   return SpatialIndexUnknown;
 }
 
+
+QList<QgsFeatureRequest> QgsFeatureSource::partitionRequest( const QgsFeatureRequest &request, int count ) const
+{
+  if ( count <= 1 || request.limit() >= 0 || !request.orderBy().isEmpty() )
+    return QList< QgsFeatureRequest >() << request;
+
+  QList< QgsFeatureId > ids;
+  switch ( request.filterType() )
+  {
+    case QgsFeatureRequest::FilterFid:
+    case QgsFeatureRequest::FilterNone:
+    case QgsFeatureRequest::FilterExpression:
+      return QList< QgsFeatureRequest >() << request;
+
+    case QgsFeatureRequest::FilterFids:
+      ids = qgis::setToList( request.filterFids() );
+      break;
+  }
+
+  if ( ids.size() <= 1 )
+    return QList< QgsFeatureRequest >() << request;
+
+  // contiguous chunks of sorted ids, as providers usually fetch neighboring ids faster
+  std::sort( ids.begin(), ids.end() );
+  const int partitions = std::min( count, ids.size() );
+  QList< QgsFeatureRequest > requests;
+  requests.reserve( partitions );
+  int start = 0;
+  for ( int i = 0; i < partitions; ++i )
+  {
+    const int end = static_cast< int >( static_cast< qint64 >( ids.size() ) * ( i + 1 ) / partitions );
+    QgsFeatureIds partitionIds;
+    partitionIds.reserve( end - start );
+    for ( int j = start; j < end; ++j )
+      partitionIds.insert( ids.at( j ) );
+
+    QgsFeatureRequest partition( request );
+    partition.setFilterFids( partitionIds );
+    requests << partition;
+    start = end;
+  }
+  return requests;
+}
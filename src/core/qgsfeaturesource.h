@@ -201,6 +201,22 @@ class CORE_EXPORT QgsFeatureSource
      * \since QGIS 3.10.1
      */
     virtual SpatialIndexPresence hasSpatialIndex() const;
+
+    /**
+     * Splits a feature \a request into at most \a count requests which return disjoint sets of
+     * features, and which can be iterated concurrently (e.g. from separate threads).
+     *
+     * Iterating all the returned requests gives the same features as iterating the original
+     * \a request, in no particular order.
+     *
+     * Sources which can split a request efficiently (e.g. database providers, by ranges of
+     * their primary key) override this method. The default implementation only splits requests
+     * filtered by feature IDs. A list containing only the original \a request is returned when
+     * the request cannot be split, including requests with an order by clause or a limit.
+     *
+     * \since QGIS 3.18
+     */
+    virtual QList< QgsFeatureRequest > partitionRequest( const QgsFeatureRequest &request, int count ) const;
 };
 
 Q_DECLARE_METATYPE( QgsFeatureSource * )
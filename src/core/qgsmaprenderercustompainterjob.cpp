@@ -101,6 +101,7 @@ void QgsMapRendererCustomPainterJob::start()
   {
     mLabelingEngineV2.reset( new QgsDefaultLabelingEngine() );
     mLabelingEngineV2->setMapSettings( mSettings );
+    mLabelingEngineV2->setCandidateCache( mLabelCandidateCache );
   }
 
   bool canUseLabelCache = prepareLabelCache();
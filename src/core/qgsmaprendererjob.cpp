@@ -71,6 +71,11 @@ void QgsMapRendererJob::setCache( QgsMapRendererCache *cache )
   mCache = cache;
 }
 
+void QgsMapRendererJob::setLabelCandidateCache( QgsLabelCandidateCache *cache )
+{
+  mLabelCandidateCache = cache;
+}
+
 QHash<QgsMapLayer *, int> QgsMapRendererJob::perLayerRenderingTime() const
 {
   QHash<QgsMapLayer *, int> result;
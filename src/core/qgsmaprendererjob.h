@@ -34,6 +34,7 @@ class QgsLabelingEngine;
 class QgsLabelingResults;
 class QgsMapLayerRenderer;
 class QgsMapRendererCache;
+class QgsLabelCandidateCache;
 class QgsFeatureFilterProvider;
 
 #ifndef SIP_RUN
@@ -270,6 +271,15 @@ class CORE_EXPORT QgsMapRendererJob : public QObject
      */
     void setCache( QgsMapRendererCache *cache );
 
+    /**
+     * Assign a cache to be used for reusing the label candidates generated by previous jobs
+     * (e.g. when the map is panned at the same scale). Does not take ownership of the object.
+     *
+     * \note Not available in Python bindings.
+     * \since QGIS 3.18
+     */
+    void setLabelCandidateCache( QgsLabelCandidateCache *cache ) SIP_SKIP;
+
     /**
      * Returns the total time it took to finish the job (in milliseconds).
      * \see perLayerRenderingTime()
@@ -318,6 +328,9 @@ class CORE_EXPORT QgsMapRendererJob : public QObject
 
     QgsMapRendererCache *mCache = nullptr;
 
+    //! Cache of label candidates, not owned
+    QgsLabelCandidateCache *mLabelCandidateCache = nullptr;
+
     int mRenderingTime = 0;
 
     //! Render time (in ms) per layer, by layer ID
@@ -402,8 +415,6 @@ class CORE_EXPORT QgsMapRendererJob : public QObject
     //! \note not available in Python bindings
     static void drawLabeling( QgsRenderContext &renderContext, QgsLabelingEngine *labelingEngine2, QPainter *painter ) SIP_SKIP;
 
-  private:
-
     /**
      * Convenience function to project an extent into the layer source
      * CRS, but also split it into two extents if it crosses
@@ -414,8 +425,12 @@ class CORE_EXPORT QgsMapRendererJob : public QObject
      * If FALSE is returned then the extent could not be accurately
      * transformed to the layer's CRS, and a "full globe" extent
      * was used instead.
+     *
+     * \note not available in Python bindings
      */
-    static bool reprojectToLayerExtent( const QgsMapLayer *ml, const QgsCoordinateTransform &ct, QgsRectangle &extent, QgsRectangle &r2 );
+    static bool reprojectToLayerExtent( const QgsMapLayer *ml, const QgsCoordinateTransform &ct, QgsRectangle &extent, QgsRectangle &r2 ) SIP_SKIP;
+
+  private:
 
     const QgsFeatureFilterProvider *mFeatureFilterProvider = nullptr;
 
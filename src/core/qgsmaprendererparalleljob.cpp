@@ -15,17 +15,127 @@
 
 #include "qgsmaprendererparalleljob.h"
 
+#include "qgsarrowsymbollayer.h"
 #include "qgsfeedback.h"
+#include "qgsfillsymbollayer.h"
 #include "qgslabelingengine.h"
+#include "qgslinesymbollayer.h"
 #include "qgslogger.h"
 #include "qgsmaplayerrenderer.h"
 #include "qgsproject.h"
 #include "qgsmaplayer.h"
 #include "qgsmaplayerlistutils.h"
+#include "qgsmaplayerstylemanager.h"
+#include "qgspallabeling.h"
+#include "qgspainteffect.h"
+#include "qgsrenderer.h"
+#include "qgssymbol.h"
+#include "qgssymbollayer.h"
+#include "qgsvectorlayer.h"
 
 #include <QtConcurrentMap>
 #include <QtConcurrentRun>
 
+///@cond PRIVATE
+
+//! Tiles smaller than this size (in pixels) are not worth the overhead of an extra layer renderer
+static const int MINIMUM_TILE_SIZE = 128;
+
+//! Margin (in pixels) added to the symbol extents, covering antialiasing
+static const int TILE_BUFFER_MARGIN = 2;
+
+/**
+ * Returns TRUE if the rendering of a symbol \a layer depends on the whole geometry of the features.
+ *
+ * Geometries are clipped to the extent of each tile, so centroid fills would draw one marker per tile,
+ * and dash patterns, markers placed along lines and arrows would restart at the tile edges.
+ */
+static bool symbolLayerNeedsWholeGeometry( const QgsSymbolLayer *layer )
+{
+  if ( layer->dataDefinedProperties().isActive( QgsSymbolLayer::PropertyStrokeStyle )
+       || layer->dataDefinedProperties().isActive( QgsSymbolLayer::PropertyCustomDash ) )
+    return true;
+
+  if ( dynamic_cast< const QgsCentroidFillSymbolLayer * >( layer )
+       || dynamic_cast< const QgsTemplatedLineSymbolLayerBase * >( layer )
+       || dynamic_cast< const QgsArrowSymbolLayer * >( layer ) )
+    return true;
+
+  if ( const QgsSimpleLineSymbolLayer *lineLayer = dynamic_cast< const QgsSimpleLineSymbolLayer * >( layer ) )
+    return lineLayer->useCustomDashPattern() || ( lineLayer->penStyle() != Qt::SolidLine && lineLayer->penStyle() != Qt::NoPen );
+
+  if ( const QgsSimpleFillSymbolLayer *fillLayer = dynamic_cast< const QgsSimpleFillSymbolLayer * >( layer ) )
+    return fillLayer->strokeStyle() != Qt::SolidLine && fillLayer->strokeStyle() != Qt::NoPen;
+
+  return false;
+}
+
+/**
+ * Computes the distance (in pixels) by which a \a symbol may extend beyond the geometry it renders,
+ * and stores it in \a bleed.
+ *
+ * Returns FALSE if the extent of the symbol can't be bounded: data defined sizes or offsets, paint
+ * effects and geometry generators may draw anywhere on the map. Also returns FALSE if the symbol
+ * can't be rendered from clipped geometries, see symbolLayerNeedsWholeGeometry().
+ */
+static bool estimateSymbolTileBleed( QgsSymbol *symbol, const QgsRenderContext &context, double &bleed )
+{
+  static const QList< QgsSymbolLayer::Property > SIZE_PROPERTIES
+  {
+    QgsSymbolLayer::PropertySize,
+    QgsSymbolLayer::PropertyStrokeWidth,
+    QgsSymbolLayer::PropertyOffset,
+    QgsSymbolLayer::PropertyWidth,
+    QgsSymbolLayer::PropertyHeight,
+    QgsSymbolLayer::PropertyLineDistance,
+    QgsSymbolLayer::PropertyArrowWidth,
+    QgsSymbolLayer::PropertyArrowStartWidth,
+    QgsSymbolLayer::PropertyArrowHeadLength,
+    QgsSymbolLayer::PropertyArrowHeadThickness,
+    QgsSymbolLayer::PropertyOffsetX,
+    QgsSymbolLayer::PropertyOffsetY,
+  };
+
+  bleed = 0;
+  if ( !symbol )
+    return true;
+
+  for ( int i = 0; i < symbol->symbolLayerCount(); ++i )
+  {
+    QgsSymbolLayer *layer = symbol->symbolLayer( i );
+    if ( layer->paintEffect() && layer->paintEffect()->enabled() )
+      return false;
+    if ( layer->layerType() == QLatin1String( "GeometryGenerator" ) )
+      return false;
+    if ( symbolLayerNeedsWholeGeometry( layer ) )
+      return false;
+    for ( QgsSymbolLayer::Property property : SIZE_PROPERTIES )
+    {
+      if ( layer->dataDefinedProperties().isActive( property ) )
+        return false;
+    }
+
+    double layerBleed = layer->estimateMaxBleed( context );
+    if ( layer->type() == QgsSymbol::Marker )
+    {
+      // markers may be rotated and are not always square, so use their full size
+      const QgsMarkerSymbolLayer *markerLayer = static_cast< const QgsMarkerSymbolLayer * >( layer );
+      const QPointF offset = markerLayer->offset();
+      layerBleed = std::max( layerBleed, context.convertToPainterUnits( markerLayer->size(), markerLayer->sizeUnit(), markerLayer->sizeMapUnitScale() )
+                             + context.convertToPainterUnits( std::max( std::fabs( offset.x() ), std::fabs( offset.y() ) ), markerLayer->offsetUnit(), markerLayer->offsetMapUnitScale() ) );
+    }
+
+    double subSymbolBleed = 0;
+    if ( !estimateSymbolTileBleed( layer->subSymbol(), context, subSymbolBleed ) )
+      return false;
+
+    bleed = std::max( { bleed, layerBleed, subSymbolBleed } );
+  }
+  return true;
+}
+
+///@endcond
+
 QgsMapRendererParallelJob::QgsMapRendererParallelJob( const QgsMapSettings &settings )
   : QgsMapRendererQImageJob( settings )
   , mStatus( Idle )
@@ -55,12 +165,14 @@ void QgsMapRendererParallelJob::start()
   {
     mLabelingEngineV2.reset( new QgsDefaultLabelingEngine() );
     mLabelingEngineV2->setMapSettings( mSettings );
+    mLabelingEngineV2->setCandidateCache( mLabelCandidateCache );
   }
 
   bool canUseLabelCache = prepareLabelCache();
   mLayerJobs = prepareJobs( nullptr, mLabelingEngineV2.get() );
   mLabelJob = prepareLabelingJob( nullptr, mLabelingEngineV2.get(), canUseLabelCache );
   mSecondPassLayerJobs = prepareSecondPassJobs( mLayerJobs, mLabelJob );
+  prepareTileJobs();
 
   QgsDebugMsgLevel( QStringLiteral( "QThreadPool max thread count is %1" ).arg( QThreadPool::globalInstance()->maxThreadCount() ), 2 );
 
@@ -68,7 +180,7 @@ void QgsMapRendererParallelJob::start()
 
   connect( &mFutureWatcher, &QFutureWatcher<void>::finished, this, &QgsMapRendererParallelJob::renderLayersFinished );
 
-  mFuture = QtConcurrent::map( mLayerJobs, renderLayerStatic );
+  mFuture = QtConcurrent::map( mRenderQueue, renderQueuedJobStatic );
   mFutureWatcher.setFuture( mFuture );
 }
 
@@ -86,6 +198,12 @@ void QgsMapRendererParallelJob::cancel()
     if ( it->renderer && it->renderer->feedback() )
       it->renderer->feedback()->cancel();
   }
+  for ( LayerRenderJobs::iterator it = mTileJobs.begin(); it != mTileJobs.end(); ++it )
+  {
+    it->context.setRenderingStopped( true );
+    if ( it->renderer && it->renderer->feedback() )
+      it->renderer->feedback()->cancel();
+  }
 
   if ( mStatus == RenderingLayers )
   {
@@ -131,6 +249,12 @@ void QgsMapRendererParallelJob::cancelWithoutBlocking()
     if ( it->renderer && it->renderer->feedback() )
       it->renderer->feedback()->cancel();
   }
+  for ( LayerRenderJobs::iterator it = mTileJobs.begin(); it != mTileJobs.end(); ++it )
+  {
+    it->context.setRenderingStopped( true );
+    if ( it->renderer && it->renderer->feedback() )
+      it->renderer->feedback()->cancel();
+  }
 
   if ( mStatus == RenderingLayers )
   {
@@ -219,6 +343,8 @@ void QgsMapRendererParallelJob::renderLayersFinished()
 {
   Q_ASSERT( mStatus == RenderingLayers );
 
+  composeTileJobs();
+
   LayerRenderJobs::const_iterator it = mLayerJobs.constBegin();
   for ( ; it != mLayerJobs.constEnd(); ++it )
   {
@@ -294,6 +420,8 @@ void QgsMapRendererParallelJob::renderingFinished()
 
     logRenderingTime( mLayerJobs, mSecondPassLayerJobs, mLabelJob );
 
+    cleanupTileJobs();
+
     cleanupJobs( mLayerJobs );
 
     cleanupLabelJob( mLabelJob );
@@ -318,6 +446,8 @@ void QgsMapRendererParallelJob::renderLayersSecondPassFinished()
 
   logRenderingTime( mLayerJobs, mSecondPassLayerJobs, mLabelJob );
 
+  cleanupTileJobs();
+
   cleanupJobs( mLayerJobs );
 
   cleanupSecondPassJobs( mSecondPassLayerJobs );
@@ -372,6 +502,251 @@ void QgsMapRendererParallelJob::renderLayerStatic( LayerRenderJob &job )
   QgsDebugMsgLevel( QStringLiteral( "job %1 end [%2 ms] (layer %3)" ).arg( reinterpret_cast< quint64 >( &job ), 0, 16 ).arg( job.renderingTime ).arg( job.layerId ), 2 );
 }
 
+void QgsMapRendererParallelJob::renderQueuedJobStatic( LayerRenderJob *job )
+{
+  renderLayerStatic( *job );
+}
+
+bool QgsMapRendererParallelJob::canRenderInTiles( const LayerRenderJob &job, double &buffer ) const
+{
+  if ( job.cached || !job.renderer || !job.img || job.maskImage )
+    return false;
+
+  // only vector layers can safely be rendered as several independent parts
+  QgsVectorLayer *vl = qobject_cast< QgsVectorLayer * >( job.layer );
+  if ( !vl )
+    return false;
+
+  // labels and diagrams are registered by the layer renderer, so they must come from a single renderer
+  if ( mLabelingEngineV2 && QgsPalLabeling::staticWillUseLayer( vl ) )
+    return false;
+
+  if ( job.context.flags() & QgsRenderContext::ApplyClipAfterReprojection )
+    return false;
+
+  // masked layers are rendered again in the second pass, which expects a single first pass job
+  for ( const LayerRenderJob &secondPassJob : mSecondPassLayerJobs )
+  {
+    if ( secondPassJob.firstPassJob == &job )
+      return false;
+  }
+
+  // the renderer must be inspected with the style used for rendering
+  QgsMapLayerStyleOverride styleOverride( vl );
+  if ( mSettings.layerStyleOverrides().contains( vl->id() ) )
+    styleOverride.setOverrideStyle( mSettings.layerStyleOverrides().value( vl->id() ) );
+
+  QgsFeatureRenderer *renderer = vl->renderer();
+  if ( !renderer )
+    return false;
+
+  // these renderers depend on all the features of the rendered extent, so their output would change with tiling
+  const QString rendererType = renderer->type();
+  if ( rendererType == QLatin1String( "heatmapRenderer" ) || rendererType == QLatin1String( "pointCluster" )
+       || rendererType == QLatin1String( "pointDisplacement" ) || rendererType == QLatin1String( "invertedPolygonRenderer" ) )
+    return false;
+
+  // paint effects such as blur or shadows bleed across tile edges
+  if ( renderer->paintEffect() && renderer->paintEffect()->enabled() )
+    return false;
+
+  QgsRenderContext context = job.context;
+  double maxBleed = 0;
+  const QgsSymbolList symbols = renderer->symbols( context );
+  for ( QgsSymbol *symbol : symbols )
+  {
+    double bleed = 0;
+    if ( !estimateSymbolTileBleed( symbol, context, bleed ) )
+      return false;
+    maxBleed = std::max( maxBleed, bleed );
+  }
+
+  buffer = maxBleed + TILE_BUFFER_MARGIN;
+  return true;
+}
+
+void QgsMapRendererParallelJob::prepareTileJobs()
+{
+  mRenderQueue.clear();
+  mTileJobs.clear();
+  mTileJobInfo.clear();
+
+  QList< LayerRenderJob * > tileableJobs;
+  QVector< double > tileBuffers;
+  for ( LayerRenderJob &job : mLayerJobs )
+  {
+    // rendered feature handlers would see features once per tile
+    double buffer = 0;
+    if ( mTiledLayerRendering && mSettings.renderedFeatureHandlers().isEmpty() && canRenderInTiles( job, buffer ) )
+    {
+      tileableJobs << &job;
+      tileBuffers << buffer;
+    }
+    else
+    {
+      mRenderQueue << &job;
+    }
+  }
+
+  if ( tileableJobs.isEmpty() )
+    return;
+
+  // the jobs which are not split occupy a thread each, the remaining threads are shared between tiled layers
+  const int threadCount = QThreadPool::globalInstance()->maxThreadCount();
+  const int tilesPerLayer = ( threadCount - mRenderQueue.count() ) / tileableJobs.count();
+
+  // choose a grid of roughly square tiles
+  const QSize size = mSettings.outputSize();
+  int columns = static_cast< int >( std::round( std::sqrt( tilesPerLayer * static_cast< double >( size.width() ) / size.height() ) ) );
+  columns = std::max( 1, std::min( { columns, tilesPerLayer, size.width() / MINIMUM_TILE_SIZE } ) );
+  const int rows = std::max( 1, std::min( tilesPerLayer / columns, size.height() / MINIMUM_TILE_SIZE ) );
+
+  if ( columns * rows < 2 )
+  {
+    mRenderQueue << tileableJobs;
+    return;
+  }
+
+  QVector< QRect > tileRects;
+  QVector< QgsRectangle > tileExtents;
+  const QgsMapToPixel &mtp = mSettings.mapToPixel();
+  for ( int row = 0; row < rows; ++row )
+  {
+    for ( int column = 0; column < columns; ++column )
+    {
+      const int x0 = column * size.width() / columns;
+      const int x1 = ( column + 1 ) * size.width() / columns;
+      const int y0 = row * size.height() / rows;
+      const int y1 = ( row + 1 ) * size.height() / rows;
+      tileRects << QRect( x0, y0, x1 - x0, y1 - y0 );
+
+      // the bounding box of the tile corners also covers rotated maps
+      QgsRectangle extent;
+      extent.setMinimal();
+      extent.combineExtentWith( mtp.toMapCoordinates( x0, y0 ) );
+      extent.combineExtentWith( mtp.toMapCoordinates( x1, y0 ) );
+      extent.combineExtentWith( mtp.toMapCoordinates( x0, y1 ) );
+      extent.combineExtentWith( mtp.toMapCoordinates( x1, y1 ) );
+      tileExtents << extent;
+    }
+  }
+
+  const float devicePixelRatio = mSettings.devicePixelRatio();
+  for ( int jobIndex = 0; jobIndex < tileableJobs.size(); ++jobIndex )
+  {
+    LayerRenderJob *job = tileableJobs.at( jobIndex );
+    QgsMapLayer *ml = job->layer;
+
+    // tiles are grown so that symbols of features located just outside of them are still drawn
+    const double buffer = std::max( mSettings.extentBuffer(), tileBuffers.at( jobIndex ) * mSettings.mapUnitsPerPixel() );
+
+    // all tile extents must be transformable to the layer CRS, otherwise render the layer as a whole
+    QVector< QgsRectangle > layerExtents;
+    const QgsCoordinateTransform ct = job->context.coordinateTransform();
+    for ( const QgsRectangle &tileExtent : qgis::as_const( tileExtents ) )
+    {
+      QgsRectangle layerExtent = tileExtent;
+      layerExtent.grow( buffer );
+      QgsRectangle r2;
+      if ( ct.isValid() && !reprojectToLayerExtent( ml, ct, layerExtent, r2 ) )
+        break;
+      layerExtents << layerExtent;
+    }
+    if ( layerExtents.size() != tileExtents.size() )
+    {
+      mRenderQueue << job;
+      continue;
+    }
+
+    QgsMapLayerStyleOverride styleOverride( ml );
+    if ( mSettings.layerStyleOverrides().contains( ml->id() ) )
+      styleOverride.setOverrideStyle( mSettings.layerStyleOverrides().value( ml->id() ) );
+
+    for ( int i = 0; i < tileRects.size(); ++i )
+    {
+      const QRect &rect = tileRects.at( i );
+
+      QImage *tileImage = new QImage( rect.size() * devicePixelRatio, mSettings.outputImageFormat() );
+      if ( tileImage->isNull() )
+      {
+        mErrors.append( Error( job->layerId, tr( "Insufficient memory for image %1x%2" ).arg( rect.width() ).arg( rect.height() ) ) );
+        delete tileImage;
+        continue;
+      }
+      tileImage->setDevicePixelRatio( static_cast<qreal>( devicePixelRatio ) );
+
+      QPainter *painter = new QPainter( tileImage );
+      painter->setRenderHints( job->context.painter()->renderHints() );
+      painter->translate( -rect.topLeft() );
+
+      mTileJobs.append( LayerRenderJob() );
+      LayerRenderJob &tileJob = mTileJobs.last();
+      tileJob.context = job->context;
+      tileJob.context.setPainter( painter );
+      tileJob.context.setExtent( layerExtents.at( i ) );
+      tileJob.img = tileImage;
+      tileJob.cached = false;
+      tileJob.layer = job->layer;
+      tileJob.layerId = job->layerId;
+      tileJob.blendMode = job->blendMode;
+      tileJob.opacity = job->opacity;
+      tileJob.renderingTime = 0;
+      tileJob.renderer = ml->createMapRenderer( tileJob.context );
+
+      TileJobInfo info;
+      info.parentJob = job;
+      info.rect = rect;
+      mTileJobInfo << info;
+    }
+
+    // the tiles replace the renderer created for the whole layer
+    delete job->renderer;
+    job->renderer = nullptr;
+    job->img->fill( 0 );
+  }
+
+  for ( LayerRenderJob &tileJob : mTileJobs )
+    mRenderQueue << &tileJob;
+}
+
+void QgsMapRendererParallelJob::composeTileJobs()
+{
+  for ( int i = 0; i < mTileJobs.size(); ++i )
+  {
+    const LayerRenderJob &tileJob = mTileJobs.at( i );
+    const TileJobInfo &info = mTileJobInfo.at( i );
+    LayerRenderJob *job = info.parentJob;
+
+    if ( tileJob.imageInitialized )
+    {
+      job->context.painter()->drawImage( info.rect.topLeft(), *tileJob.img );
+      job->imageInitialized = true;
+    }
+
+    job->errors << tileJob.errors;
+    // tiles are rendered concurrently, so the slowest tile determines the layer's rendering time
+    job->renderingTime = std::max( job->renderingTime, tileJob.renderingTime );
+  }
+
+  cleanupTileJobs();
+}
+
+void QgsMapRendererParallelJob::cleanupTileJobs()
+{
+  for ( LayerRenderJob &job : mTileJobs )
+  {
+    delete job.context.painter();
+    job.context.setPainter( nullptr );
+    delete job.img;
+    job.img = nullptr;
+    delete job.renderer;
+    job.renderer = nullptr;
+  }
+
+  mTileJobs.clear();
+  mTileJobInfo.clear();
+  mRenderQueue.clear();
+}
 
 void QgsMapRendererParallelJob::renderLabelsStatic( QgsMapRendererParallelJob *self )
 {
@@ -48,6 +48,38 @@ class CORE_EXPORT QgsMapRendererParallelJob : public QgsMapRendererQImageJob
     // from QgsMapRendererJobWithPreview
     QImage renderedImage() override;
 
+    /**
+     * Sets whether tiled layer rendering is \a enabled.
+     *
+     * When enabled, vector layers are split into screen tiles which are rendered
+     * concurrently, each with its own render context and layer renderer, and the tiles
+     * are then composited back into the layer's image. This allows a map consisting of
+     * only a few heavy layers to make use of all available threads.
+     *
+     * The number of tiles per layer is chosen so that the total number of render tasks
+     * matches the global thread pool size.
+     *
+     * Layers which take part in labeling, diagrams or selective masking and layers using
+     * a cached image are always rendered as a whole. So are layers whose output depends on
+     * the whole rendered extent (heatmap, point cluster, point displacement and inverted
+     * polygon renderers), and layers whose symbols can't be bounded, e.g. because they use
+     * paint effects, geometry generators or data defined sizes.
+     *
+     * Tiled rendering is disabled by default.
+     *
+     * \see isTiledLayerRenderingEnabled()
+     * \since QGIS 3.18
+     */
+    void setTiledLayerRenderingEnabled( bool enabled ) { mTiledLayerRendering = enabled; }
+
+    /**
+     * Returns TRUE if tiled layer rendering is enabled.
+     *
+     * \see setTiledLayerRenderingEnabled()
+     * \since QGIS 3.18
+     */
+    bool isTiledLayerRenderingEnabled() const { return mTiledLayerRendering; }
+
   private slots:
     //! layers are rendered, labeling is still pending
     void renderLayersFinished();
@@ -63,6 +95,34 @@ class CORE_EXPORT QgsMapRendererParallelJob : public QgsMapRendererQImageJob
     //! \note not available in Python bindings
     static void renderLabelsStatic( QgsMapRendererParallelJob *self ) SIP_SKIP;
 
+    //! \note not available in Python bindings
+    static void renderQueuedJobStatic( LayerRenderJob *job ) SIP_SKIP;
+
+    /**
+     * Splits the eligible jobs from mLayerJobs into tile jobs and fills the render queue.
+     * \note not available in Python bindings
+     */
+    void prepareTileJobs() SIP_SKIP;
+
+    /**
+     * Composites finished tile jobs back into the images of their parent layer jobs.
+     * \note not available in Python bindings
+     */
+    void composeTileJobs() SIP_SKIP;
+
+    //! \note not available in Python bindings
+    void cleanupTileJobs() SIP_SKIP;
+
+    /**
+     * Returns TRUE if the specified layer \a job can be split into tiles.
+     *
+     * The \a buffer (in pixels) needed around tiles so that symbols of features located
+     * outside of a tile are still drawn in it is set when the job can be split.
+     *
+     * \note not available in Python bindings
+     */
+    bool canRenderInTiles( const LayerRenderJob &job, double &buffer ) const SIP_SKIP;
+
     QImage mFinalImage;
 
     //! \note not available in Python bindings
@@ -74,6 +134,22 @@ class CORE_EXPORT QgsMapRendererParallelJob : public QgsMapRendererQImageJob
     LayerRenderJobs mLayerJobs;
     LabelRenderJob mLabelJob;
 
+    bool mTiledLayerRendering = false;
+
+    //! Links a tile job to the layer job it is composited into
+    struct TileJobInfo
+    {
+      LayerRenderJob *parentJob = nullptr;
+      QRect rect;
+    };
+
+    //! Tile jobs for layers which are split into tiles, see TileJobInfo
+    LayerRenderJobs mTileJobs;
+    QVector< TileJobInfo > mTileJobInfo;
+
+    //! Jobs which are actually rendered by the first pass (whole layer jobs and tile jobs)
+    QList< LayerRenderJob * > mRenderQueue;
+
     LayerRenderJobs mSecondPassLayerJobs;
     QFuture<void> mSecondPassFuture;
     QFutureWatcher<void> mSecondPassFutureWatcher;
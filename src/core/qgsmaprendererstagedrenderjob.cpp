@@ -54,6 +54,7 @@ void QgsMapRendererStagedRenderJob::start()
     else
       mLabelingEngineV2.reset( new QgsDefaultLabelingEngine() );
     mLabelingEngineV2->setMapSettings( mSettings );
+    mLabelingEngineV2->setCandidateCache( mLabelCandidateCache );
   }
 
   mLayerJobs = prepareJobs( nullptr, mLabelingEngineV2.get(), true );
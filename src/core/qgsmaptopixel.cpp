@@ -23,6 +23,7 @@
 
 #include "qgslogger.h"
 #include "qgspointxy.h"
+#include "qgssimdkernels_p.h"
 
 
 QgsMapToPixel::QgsMapToPixel( double mapUnitsPerPixel,
@@ -249,6 +250,28 @@ void QgsMapToPixel::transformInPlace( float &x, float &y ) const
   y = my;
 }
 
+void QgsMapToPixel::transformInPlace( QPointF *points, int count ) const
+{
+#ifndef QT_COORD_TYPE
+  // QPointF stores its coordinates as two consecutive doubles, so they can be transformed in batch
+  if ( mMatrix.type() < QTransform::TxProject )
+  {
+    QgsSimdKernels::affineTransform( reinterpret_cast< double * >( points ), static_cast< std::size_t >( count ),
+                                     mMatrix.m11(), mMatrix.m12(), mMatrix.m21(), mMatrix.m22(), mMatrix.dx(), mMatrix.dy() );
+    return;
+  }
+#endif
+
+  for ( int i = 0; i < count; ++i )
+  {
+    qreal x = points[i].x();
+    qreal y = points[i].y();
+    transformInPlace( x, y );
+    points[i].setX( x );
+    points[i].setY( y );
+  }
+}
+
 QTransform QgsMapToPixel::transform() const
 {
   // NOTE: operations are done in the reverse order in which
@@ -101,6 +101,15 @@ class CORE_EXPORT QgsMapToPixel
     //! \note not available in Python bindings
     void transformInPlace( float &x, float &y ) const SIP_SKIP;
 
+    /**
+     * Transforms an array of \a count \a points from map coordinates to device coordinates.
+     * Modifies the points in place. This is much faster than transforming the points one
+     * at a time, as SIMD instructions are used when they are available.
+     * \note not available in Python bindings
+     * \since QGIS 3.18
+     */
+    void transformInPlace( QPointF *points, int count ) const SIP_SKIP;
+
 #ifndef SIP_RUN
 
     /**
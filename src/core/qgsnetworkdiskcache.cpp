@@ -17,6 +17,7 @@
 
 
 #include "qgsnetworkdiskcache.h"
+#include "qgstilecache.h"
 
 ///@cond PRIVATE
 ExpirableNetworkDiskCache QgsNetworkDiskCache::sDiskCache;
@@ -108,6 +109,9 @@ qint64 QgsNetworkDiskCache::expire()
 
 void QgsNetworkDiskCache::clear()
 {
+  // the decoded tiles are read before the network cache, they must not outlive it
+  QgsTileCache::clearDiskCache();
+
   QMutexLocker lock( &sDiskCacheMutex );
   return sDiskCache.clear();
 }
@@ -0,0 +1,597 @@
+/***************************************************************************
+                             qgspackedspatialindex.cpp
+                             -------------------------
+    begin                : October 2026
+    copyright            : (C) 2026 by QGIS contributors
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qgspackedspatialindex.h"
+#include "qgsfeatureiterator.h"
+#include "qgsfeedback.h"
+#include "qgsfeaturesource.h"
+#include "qgsgeometry.h"
+#include "qgspointxy.h"
+
+#include <QAtomicInt>
+#include <QFile>
+#include <QObject>
+#include <QSaveFile>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <queue>
+#include <vector>
+
+///@cond PRIVATE
+
+//! A node of the packed tree. For leaf nodes, offset is the feature ID, otherwise the index of the first child node.
+struct QgsPackedSpatialIndexNode
+{
+  double minX;
+  double minY;
+  double maxX;
+  double maxY;
+  quint64 offset;
+};
+
+//! Header of the index files, followed by the nodes
+struct QgsPackedSpatialIndexHeader
+{
+  char magic[8];
+  quint32 version;
+  quint32 nodeSize;
+  quint64 featureCount;
+  quint64 nodeCount;
+};
+
+static_assert( sizeof( QgsPackedSpatialIndexNode ) == 40, "Unexpected padding in QgsPackedSpatialIndexNode" );
+static_assert( sizeof( QgsPackedSpatialIndexHeader ) == 32, "Unexpected padding in QgsPackedSpatialIndexHeader" );
+
+static const char PACKED_INDEX_MAGIC[8] = { 'Q', 'G', 'S', 'P', 'H', 'R', 'T', '\0' };
+static const quint32 PACKED_INDEX_VERSION = 1;
+
+/**
+ * Returns the position of a point along a Hilbert curve of order 16, from the
+ * bit manipulation algorithm of http://threadlocalmutex.com/?p=126
+ */
+static quint32 hilbert( quint32 x, quint32 y )
+{
+  quint32 a = x ^ y;
+  quint32 b = 0xFFFF ^ a;
+  quint32 c = 0xFFFF ^ ( x | y );
+  quint32 d = x & ( y ^ 0xFFFF );
+
+  quint32 A = a | ( b >> 1 );
+  quint32 B = ( a >> 1 ) ^ a;
+  quint32 C = ( ( c >> 1 ) ^ ( b & ( d >> 1 ) ) ) ^ c;
+  quint32 D = ( ( a & ( c >> 1 ) ) ^ ( d >> 1 ) ) ^ d;
+
+  a = A;
+  b = B;
+  c = C;
+  d = D;
+  A = ( ( a & ( a >> 2 ) ) ^ ( b & ( b >> 2 ) ) );
+  B = ( ( a & ( b >> 2 ) ) ^ ( b & ( ( a ^ b ) >> 2 ) ) );
+  C ^= ( ( a & ( c >> 2 ) ) ^ ( b & ( d >> 2 ) ) );
+  D ^= ( ( b & ( c >> 2 ) ) ^ ( ( a ^ b ) & ( d >> 2 ) ) );
+
+  a = A;
+  b = B;
+  c = C;
+  d = D;
+  A = ( ( a & ( a >> 4 ) ) ^ ( b & ( b >> 4 ) ) );
+  B = ( ( a & ( b >> 4 ) ) ^ ( b & ( ( a ^ b ) >> 4 ) ) );
+  C ^= ( ( a & ( c >> 4 ) ) ^ ( b & ( d >> 4 ) ) );
+  D ^= ( ( b & ( c >> 4 ) ) ^ ( ( a ^ b ) & ( d >> 4 ) ) );
+
+  a = A;
+  b = B;
+  c = C;
+  d = D;
+  C ^= ( ( a & ( c >> 8 ) ) ^ ( b & ( d >> 8 ) ) );
+  D ^= ( ( b & ( c >> 8 ) ) ^ ( ( a ^ b ) & ( d >> 8 ) ) );
+
+  a = C ^ ( C >> 1 );
+  b = D ^ ( D >> 1 );
+
+  quint32 i0 = x ^ y;
+  quint32 i1 = b | ( 0xFFFF ^ ( i0 | a ) );
+
+  i0 = ( i0 | ( i0 << 8 ) ) & 0x00FF00FF;
+  i0 = ( i0 | ( i0 << 4 ) ) & 0x0F0F0F0F;
+  i0 = ( i0 | ( i0 << 2 ) ) & 0x33333333;
+  i0 = ( i0 | ( i0 << 1 ) ) & 0x55555555;
+
+  i1 = ( i1 | ( i1 << 8 ) ) & 0x00FF00FF;
+  i1 = ( i1 | ( i1 << 4 ) ) & 0x0F0F0F0F;
+  i1 = ( i1 | ( i1 << 2 ) ) & 0x33333333;
+  i1 = ( i1 | ( i1 << 1 ) ) & 0x55555555;
+
+  return ( i1 << 1 ) | i0;
+}
+
+class QgsPackedSpatialIndexPrivate
+{
+  public:
+
+    QgsPackedSpatialIndexPrivate() = default;
+
+    QgsPackedSpatialIndexPrivate( QgsFeatureIterator &fi, QgsFeedback *feedback, int nodeSize, qgssize expectedCount = 0 )
+      : nodeSize( std::min( std::max( 2, nodeSize ), 65535 ) )
+    {
+      build( fi, feedback, expectedCount );
+    }
+
+    QgsPackedSpatialIndexPrivate( const QVector< QPair< QgsFeatureId, QgsRectangle > > &entries, int nodeSize )
+      : nodeSize( std::min( std::max( 2, nodeSize ), 65535 ) )
+    {
+      std::vector< QgsPackedSpatialIndexNode > items;
+      items.reserve( entries.size() );
+      for ( const QPair< QgsFeatureId, QgsRectangle > &entry : entries )
+        items.emplace_back( QgsPackedSpatialIndexNode{ entry.second.xMinimum(), entry.second.yMinimum(), entry.second.xMaximum(), entry.second.yMaximum(), static_cast< quint64 >( entry.first ) } );
+      pack( items );
+    }
+
+    QgsPackedSpatialIndexPrivate( const QgsPackedSpatialIndexPrivate &other ) = delete;
+    QgsPackedSpatialIndexPrivate &operator=( const QgsPackedSpatialIndexPrivate &other ) = delete;
+
+    /**
+     * Computes the bounds of the levels of a tree, from the leaves (level 0) to the root.
+     * The root is stored first, the leaves last. Returns the total number of nodes.
+     */
+    static quint64 computeLevelBounds( quint64 featureCount, int nodeSize, std::vector< std::pair< quint64, quint64 > > &bounds )
+    {
+      bounds.clear();
+      if ( featureCount == 0 )
+        return 0;
+
+      std::vector< quint64 > levelNodeCounts;
+      quint64 count = featureCount;
+      quint64 nodeCount = count;
+      levelNodeCounts.push_back( count );
+      while ( count > 1 )
+      {
+        count = ( count + nodeSize - 1 ) / nodeSize;
+        levelNodeCounts.push_back( count );
+        nodeCount += count;
+      }
+
+      quint64 end = nodeCount;
+      for ( quint64 levelCount : levelNodeCounts )
+      {
+        bounds.emplace_back( end - levelCount, end );
+        end -= levelCount;
+      }
+      return nodeCount;
+    }
+
+    void build( QgsFeatureIterator &fi, QgsFeedback *feedback, qgssize expectedCount )
+    {
+      std::vector< QgsPackedSpatialIndexNode > items;
+      items.reserve( expectedCount );
+
+      QgsFeature f;
+      while ( fi.nextFeature( f ) )
+      {
+        if ( feedback && feedback->isCanceled() )
+          return;
+
+        if ( !f.hasGeometry() || f.geometry().isEmpty() )
+          continue;
+
+        const QgsRectangle bbox = f.geometry().boundingBox();
+
+        items.emplace_back( QgsPackedSpatialIndexNode{ bbox.xMinimum(), bbox.yMinimum(), bbox.xMaximum(), bbox.yMaximum(), static_cast< quint64 >( f.id() ) } );
+      }
+
+      pack( items );
+    }
+
+    //! Sorts the leaf \a items along the Hilbert curve and packs the tree, \a items is emptied
+    void pack( std::vector< QgsPackedSpatialIndexNode > &items )
+    {
+      featureCount = items.size();
+      nodeCount = computeLevelBounds( featureCount, nodeSize, levelBounds );
+      valid = true;
+      if ( featureCount == 0 )
+        return;
+
+      double minX = std::numeric_limits< double >::max();
+      double minY = std::numeric_limits< double >::max();
+      double maxX = std::numeric_limits< double >::lowest();
+      double maxY = std::numeric_limits< double >::lowest();
+      for ( const QgsPackedSpatialIndexNode &item : items )
+      {
+        minX = std::min( minX, item.minX );
+        minY = std::min( minY, item.minY );
+        maxX = std::max( maxX, item.maxX );
+        maxY = std::max( maxY, item.maxY );
+      }
+
+      // sort the items along the Hilbert curve, ties are kept in iteration order so that
+      // the same features always result in the same index
+      const QgsRectangle extent( minX, minY, maxX, maxY, false );
+      std::vector< std::pair< quint32, quint64 > > order;
+      order.reserve( featureCount );
+      for ( quint64 i = 0; i < featureCount; ++i )
+      {
+        const QgsPackedSpatialIndexNode &item = items[i];
+        order.emplace_back( QgsPackedSpatialIndex::hilbertIndex( ( item.minX + item.maxX ) / 2, ( item.minY + item.maxY ) / 2, extent ), i );
+      }
+      std::sort( order.begin(), order.end() );
+
+      ownedNodes.resize( nodeCount );
+      const quint64 leavesStart = levelBounds.front().first;
+      for ( quint64 i = 0; i < featureCount; ++i )
+        ownedNodes[ leavesStart + i ] = items[ order[i].second ];
+
+      std::vector< QgsPackedSpatialIndexNode >().swap( items );
+      std::vector< std::pair< quint32, quint64 > >().swap( order );
+
+      // pack the parent levels, each parent covers nodeSize consecutive children
+      for ( std::size_t level = 0; level + 1 < levelBounds.size(); ++level )
+      {
+        const quint64 childrenEnd = levelBounds[level].second;
+        quint64 parent = levelBounds[level + 1].first;
+        for ( quint64 child = levelBounds[level].first; child < childrenEnd; child += nodeSize, ++parent )
+        {
+          QgsPackedSpatialIndexNode node = ownedNodes[ child ];
+          const quint64 end = std::min< quint64 >( child + nodeSize, childrenEnd );
+          for ( quint64 i = child + 1; i < end; ++i )
+          {
+            const QgsPackedSpatialIndexNode &c = ownedNodes[ i ];
+            node.minX = std::min( node.minX, c.minX );
+            node.minY = std::min( node.minY, c.minY );
+            node.maxX = std::max( node.maxX, c.maxX );
+            node.maxY = std::max( node.maxY, c.maxY );
+          }
+          node.offset = child;
+          ownedNodes[ parent ] = node;
+        }
+      }
+
+      nodes = ownedNodes.data();
+    }
+
+    bool open( const QString &path, QString &error )
+    {
+      file = qgis::make_unique< QFile >( path );
+      if ( !file->open( QIODevice::ReadOnly ) )
+      {
+        error = QObject::tr( "Could not open %1: %2" ).arg( path, file->errorString() );
+        return false;
+      }
+
+      const qint64 fileSize = file->size();
+      if ( fileSize < static_cast< qint64 >( sizeof( QgsPackedSpatialIndexHeader ) ) )
+      {
+        error = QObject::tr( "%1 is not a spatial index file" ).arg( path );
+        return false;
+      }
+
+      const uchar *data = file->map( 0, fileSize );
+      if ( !data )
+      {
+        error = QObject::tr( "Could not map %1: %2" ).arg( path, file->errorString() );
+        return false;
+      }
+
+      QgsPackedSpatialIndexHeader header;
+      std::memcpy( &header, data, sizeof( header ) );
+      if ( std::memcmp( header.magic, PACKED_INDEX_MAGIC, sizeof( PACKED_INDEX_MAGIC ) ) != 0 )
+      {
+        error = QObject::tr( "%1 is not a spatial index file" ).arg( path );
+        return false;
+      }
+      // a different byte order also ends up here
+      if ( header.version != PACKED_INDEX_VERSION )
+      {
+        error = QObject::tr( "Unsupported spatial index version in %1" ).arg( path );
+        return false;
+      }
+      if ( header.nodeSize < 2 || header.nodeSize > 65535 )
+      {
+        error = QObject::tr( "Invalid node size in %1" ).arg( path );
+        return false;
+      }
+
+      nodeSize = static_cast< int >( header.nodeSize );
+      featureCount = header.featureCount;
+      nodeCount = computeLevelBounds( featureCount, nodeSize, levelBounds );
+      if ( nodeCount != header.nodeCount
+           || static_cast< quint64 >( fileSize ) != sizeof( QgsPackedSpatialIndexHeader ) + nodeCount * sizeof( QgsPackedSpatialIndexNode ) )
+      {
+        error = QObject::tr( "Spatial index file %1 is truncated or corrupted" ).arg( path );
+        return false;
+      }
+
+      nodes = reinterpret_cast< const QgsPackedSpatialIndexNode * >( data + sizeof( QgsPackedSpatialIndexHeader ) );
+      valid = true;
+      return true;
+    }
+
+    bool write( const QString &path, QString &error ) const
+    {
+      // the file is replaced atomically, as the previous index may be memory mapped by other layers or processes
+      QSaveFile out( path );
+      if ( !out.open( QIODevice::WriteOnly ) )
+      {
+        error = QObject::tr( "Could not open %1 for writing: %2" ).arg( path, out.errorString() );
+        return false;
+      }
+
+      QgsPackedSpatialIndexHeader header;
+      std::memcpy( header.magic, PACKED_INDEX_MAGIC, sizeof( PACKED_INDEX_MAGIC ) );
+      header.version = PACKED_INDEX_VERSION;
+      header.nodeSize = static_cast< quint32 >( nodeSize );
+      header.featureCount = featureCount;
+      header.nodeCount = nodeCount;
+
+      const qint64 nodesSize = static_cast< qint64 >( nodeCount * sizeof( QgsPackedSpatialIndexNode ) );
+      if ( out.write( reinterpret_cast< const char * >( &header ), sizeof( header ) ) != sizeof( header )
+           || ( nodesSize > 0 && out.write( reinterpret_cast< const char * >( nodes ), nodesSize ) != nodesSize )
+           || !out.commit() )
+      {
+        error = QObject::tr( "Could not write %1: %2" ).arg( path, out.errorString() );
+        return false;
+      }
+      return true;
+    }
+
+    void search( double minX, double minY, double maxX, double maxY, const std::function<bool( QgsFeatureId )> &visitor ) const
+    {
+      if ( !nodes || nodeCount == 0 )
+        return;
+
+      // pairs of first node index and level of the nodes to visit
+      std::vector< std::pair< quint64, std::size_t > > stack;
+      stack.emplace_back( 0, levelBounds.size() - 1 );
+      while ( !stack.empty() )
+      {
+        const std::pair< quint64, std::size_t > entry = stack.back();
+        stack.pop_back();
+
+        const std::size_t level = entry.second;
+        const quint64 end = std::min< quint64 >( entry.first + nodeSize, levelBounds[level].second );
+        for ( quint64 i = entry.first; i < end; ++i )
+        {
+          const QgsPackedSpatialIndexNode &node = nodes[i];
+          if ( maxX < node.minX || maxY < node.minY || minX > node.maxX || minY > node.maxY )
+            continue;
+
+          if ( level == 0 )
+          {
+            if ( !visitor( static_cast< QgsFeatureId >( node.offset ) ) )
+              return;
+          }
+          else
+          {
+            stack.emplace_back( node.offset, level - 1 );
+          }
+        }
+      }
+    }
+
+    QList<QgsFeatureId> nearest( double x, double y, int neighbors, double maxDistance ) const
+    {
+      QList<QgsFeatureId> result;
+      if ( !nodes || nodeCount == 0 || neighbors <= 0 )
+        return result;
+
+      struct Candidate
+      {
+        double distance;
+        quint64 index;
+        std::size_t level;
+
+        bool operator>( const Candidate &other ) const
+        {
+          return distance > other.distance || ( distance == other.distance && index > other.index );
+        }
+      };
+
+      auto squaredDistance = [x, y]( const QgsPackedSpatialIndexNode & node )
+      {
+        const double dx = x < node.minX ? node.minX - x : ( x > node.maxX ? x - node.maxX : 0 );
+        const double dy = y < node.minY ? node.minY - y : ( y > node.maxY ? y - node.maxY : 0 );
+        return dx * dx + dy * dy;
+      };
+
+      const double maxSquaredDistance = maxDistance > 0 ? maxDistance * maxDistance : std::numeric_limits< double >::max();
+
+      // best first search, nodes are expanded in order of distance to the point
+      std::priority_queue< Candidate, std::vector< Candidate >, std::greater< Candidate > > queue;
+      queue.push( Candidate{ squaredDistance( nodes[0] ), 0, levelBounds.size() - 1 } );
+      while ( !queue.empty() && result.size() < neighbors )
+      {
+        const Candidate candidate = queue.top();
+        queue.pop();
+        if ( candidate.distance > maxSquaredDistance )
+          break;
+
+        const QgsPackedSpatialIndexNode &node = nodes[ candidate.index ];
+        if ( candidate.level == 0 )
+        {
+          result << static_cast< QgsFeatureId >( node.offset );
+          continue;
+        }
+
+        const std::size_t childLevel = candidate.level - 1;
+        const quint64 end = std::min< quint64 >( node.offset + nodeSize, levelBounds[childLevel].second );
+        for ( quint64 i = node.offset; i < end; ++i )
+        {
+          const double distance = squaredDistance( nodes[i] );
+          if ( distance <= maxSquaredDistance )
+            queue.push( Candidate{ distance, i, childLevel } );
+        }
+      }
+      return result;
+    }
+
+    QAtomicInt ref = 1;
+    bool valid = false;
+    int nodeSize = QgsPackedSpatialIndex::DEFAULT_NODE_SIZE;
+    quint64 featureCount = 0;
+    quint64 nodeCount = 0;
+    //! Bounds of the levels, from the leaves to the root
+    std::vector< std::pair< quint64, quint64 > > levelBounds;
+    //! Nodes of built indexes
+    std::vector< QgsPackedSpatialIndexNode > ownedNodes;
+    //! File of opened indexes, kept open for the lifetime of the mapping
+    std::unique_ptr< QFile > file;
+    const QgsPackedSpatialIndexNode *nodes = nullptr;
+};
+
+///@endcond
+
+QgsPackedSpatialIndex::QgsPackedSpatialIndex()
+  : d( new QgsPackedSpatialIndexPrivate() )
+{
+}
+
+QgsPackedSpatialIndex::QgsPackedSpatialIndex( QgsFeatureIterator &fi, QgsFeedback *feedback, int nodeSize )
+  : d( new QgsPackedSpatialIndexPrivate( fi, feedback, nodeSize ) )
+{
+}
+
+QgsPackedSpatialIndex::QgsPackedSpatialIndex( const QgsFeatureSource &source, QgsFeedback *feedback, int nodeSize )
+{
+  QgsFeatureIterator it = source.getFeatures( QgsFeatureRequest().setNoAttributes() );
+  const long count = source.featureCount();
+  d = new QgsPackedSpatialIndexPrivate( it, feedback, nodeSize, count > 0 ? static_cast< qgssize >( count ) : 0 );
+}
+
+QgsPackedSpatialIndex::QgsPackedSpatialIndex( const QVector< QPair< QgsFeatureId, QgsRectangle > > &entries, int nodeSize )
+  : d( new QgsPackedSpatialIndexPrivate( entries, nodeSize ) )
+{
+}
+
+QgsPackedSpatialIndex::QgsPackedSpatialIndex( const QgsPackedSpatialIndex &other )
+  : d( other.d )
+{
+  d->ref.ref();
+}
+
+QgsPackedSpatialIndex &QgsPackedSpatialIndex::operator=( const QgsPackedSpatialIndex &other )
+{
+  if ( this != &other )
+  {
+    if ( !d->ref.deref() )
+    {
+      delete d;
+    }
+
+    d = other.d;
+    d->ref.ref();
+  }
+  return *this;
+}
+
+QgsPackedSpatialIndex::~QgsPackedSpatialIndex()
+{
+  if ( !d->ref.deref() )
+    delete d;
+}
+
+QgsPackedSpatialIndex QgsPackedSpatialIndex::open( const QString &path, QString *error )
+{
+  QgsPackedSpatialIndex index;
+  QString openError;
+  if ( !index.d->open( path, openError ) )
+  {
+    if ( error )
+      *error = openError;
+    return QgsPackedSpatialIndex();
+  }
+  return index;
+}
+
+bool QgsPackedSpatialIndex::writeToFile( const QString &path, QString *error ) const
+{
+  if ( !d->valid )
+  {
+    if ( error )
+      *error = QObject::tr( "Cannot write an invalid spatial index" );
+    return false;
+  }
+
+  QString writeError;
+  if ( !d->write( path, writeError ) )
+  {
+    if ( error )
+      *error = writeError;
+    return false;
+  }
+  return true;
+}
+
+bool QgsPackedSpatialIndex::isValid() const
+{
+  return d->valid;
+}
+
+bool QgsPackedSpatialIndex::isMapped() const
+{
+  return d->valid && d->file;
+}
+
+qgssize QgsPackedSpatialIndex::size() const
+{
+  return d->featureCount;
+}
+
+int QgsPackedSpatialIndex::nodeSize() const
+{
+  return d->nodeSize;
+}
+
+QgsRectangle QgsPackedSpatialIndex::extent() const
+{
+  if ( !d->nodes || d->nodeCount == 0 )
+    return QgsRectangle();
+
+  // the root node covers all the features
+  const QgsPackedSpatialIndexNode &root = d->nodes[0];
+  return QgsRectangle( root.minX, root.minY, root.maxX, root.maxY, false );
+}
+
+QList<QgsFeatureId> QgsPackedSpatialIndex::intersects( const QgsRectangle &rectangle ) const
+{
+  QList<QgsFeatureId> result;
+  d->search( rectangle.xMinimum(), rectangle.yMinimum(), rectangle.xMaximum(), rectangle.yMaximum(), [&result]( QgsFeatureId id )
+  {
+    result << id;
+    return true;
+  } );
+  return result;
+}
+
+void QgsPackedSpatialIndex::intersects( const QgsRectangle &rectangle, const std::function<bool( QgsFeatureId )> &visitor ) const
+{
+  d->search( rectangle.xMinimum(), rectangle.yMinimum(), rectangle.xMaximum(), rectangle.yMaximum(), visitor );
+}
+
+QList<QgsFeatureId> QgsPackedSpatialIndex::nearestNeighbor( const QgsPointXY &point, int neighbors, double maxDistance ) const
+{
+  return d->nearest( point.x(), point.y(), neighbors, maxDistance );
+}
+
+quint32 QgsPackedSpatialIndex::hilbertIndex( double x, double y, const QgsRectangle &extent )
+{
+  const double width = extent.width();
+  const double height = extent.height();
+  const quint32 cellX = width > 0 ? static_cast< quint32 >( 0xFFFF * std::min( std::max( ( x - extent.xMinimum() ) / width, 0.0 ), 1.0 ) ) : 0;
+  const quint32 cellY = height > 0 ? static_cast< quint32 >( 0xFFFF * std::min( std::max( ( y - extent.yMinimum() ) / height, 0.0 ), 1.0 ) ) : 0;
+  return hilbert( cellX, cellY );
+}
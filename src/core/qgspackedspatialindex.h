@@ -0,0 +1,201 @@
+/***************************************************************************
+                             qgspackedspatialindex.h
+                             -----------------------
+    begin                : October 2026
+    copyright            : (C) 2026 by QGIS contributors
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef QGSPACKEDSPATIALINDEX_H
+#define QGSPACKEDSPATIALINDEX_H
+
+class QgsFeatureIterator;
+class QgsFeedback;
+class QgsFeatureSource;
+class QgsPackedSpatialIndexPrivate;
+class QgsPointXY;
+
+#include "qgis_core.h"
+#include "qgis_sip.h"
+#include "qgsfeatureid.h"
+#include "qgsrectangle.h"
+#include <QList>
+#include <QPair>
+#include <QVector>
+#include <functional>
+
+/**
+ * \class QgsPackedSpatialIndex
+ * \ingroup core
+ *
+ * A static, packed Hilbert R-tree index of feature bounding boxes.
+ *
+ * The index is bulk loaded once: the feature bounding boxes are sorted along a Hilbert
+ * curve and packed into a flat array of nodes, with the root node first and the leaf nodes
+ * last (the same layout as the index of the FlatGeobuf format).
+ *
+ * The index can be written to a file with writeToFile() and opened again with open(),
+ * which memory maps the file instead of reading it: opening an index is immediate and
+ * its pages are shared between all the processes using the same file.
+ *
+ * Compared to QgsSpatialIndex, this index:
+ *
+ * - is static (features cannot be added or removed from the index after construction)
+ * - is faster to build and uses much less memory
+ * - can be persisted and reused without rebuilding it
+ * - is read only, so a single object can be used from multiple threads without any locking
+ *
+ * QgsPackedSpatialIndex objects are implicitly shared and can be inexpensively copied.
+ *
+ * \see QgsSpatialIndex, which is a general, mutable index for geometry bounding boxes.
+ * \see QgsSpatialIndexKDBush, which is an optimised non-mutable index for point geometries only.
+ * \since QGIS 3.18
+*/
+class CORE_EXPORT QgsPackedSpatialIndex
+{
+  public:
+
+    //! Default number of children of each node
+    static const int DEFAULT_NODE_SIZE = 16;
+
+    /**
+     * Constructor for an empty, invalid index.
+     */
+    QgsPackedSpatialIndex();
+
+    /**
+     * Constructor - creates the index and bulk loads it with features from the iterator.
+     *
+     * The optional \a feedback object can be used to allow cancellation of bulk feature loading. Ownership
+     * of \a feedback is not transferred, and callers must take care that the lifetime of feedback exceeds
+     * that of the spatial index construction.
+     *
+     * Features without geometry are ignored. \a nodeSize sets the number of children of each node of the tree.
+     */
+    explicit QgsPackedSpatialIndex( QgsFeatureIterator &fi, QgsFeedback *feedback = nullptr, int nodeSize = DEFAULT_NODE_SIZE );
+
+    /**
+     * Constructor - creates the index and bulk loads it with features from the source.
+     *
+     * The optional \a feedback object can be used to allow cancellation of bulk feature loading. Ownership
+     * of \a feedback is not transferred, and callers must take care that the lifetime of feedback exceeds
+     * that of the spatial index construction.
+     *
+     * Features without geometry are ignored. \a nodeSize sets the number of children of each node of the tree.
+     */
+    explicit QgsPackedSpatialIndex( const QgsFeatureSource &source, QgsFeedback *feedback = nullptr, int nodeSize = DEFAULT_NODE_SIZE );
+
+    /**
+     * Constructor - creates the index from a list of feature IDs and their bounding boxes.
+     *
+     * \a nodeSize sets the number of children of each node of the tree.
+     *
+     * \note Not available in Python bindings
+     */
+    explicit QgsPackedSpatialIndex( const QVector< QPair< QgsFeatureId, QgsRectangle > > &entries, int nodeSize = DEFAULT_NODE_SIZE ) SIP_SKIP;
+
+    //! Copy constructor
+    QgsPackedSpatialIndex( const QgsPackedSpatialIndex &other );
+
+    //! Assignment operator
+    QgsPackedSpatialIndex &operator=( const QgsPackedSpatialIndex &other );
+
+    ~QgsPackedSpatialIndex();
+
+    /**
+     * Opens the index stored in the file at \a path, which is memory mapped.
+     *
+     * If the file cannot be opened or is not a valid index, an invalid index is returned
+     * and \a error is set to a description of the problem.
+     *
+     * \see writeToFile()
+     */
+    static QgsPackedSpatialIndex open( const QString &path, QString *error SIP_OUT = nullptr );
+
+    /**
+     * Writes the index to the file at \a path. Returns FALSE if the file cannot be written,
+     * in which case \a error is set to a description of the problem.
+     *
+     * Indexes are written in the byte order of the machine, they can only be opened on machines
+     * with the same byte order.
+     *
+     * \see open()
+     */
+    bool writeToFile( const QString &path, QString *error SIP_OUT = nullptr ) const;
+
+    /**
+     * Returns TRUE if the index was built or opened successfully.
+     */
+    bool isValid() const;
+
+    /**
+     * Returns TRUE if the index data is memory mapped from a file.
+     */
+    bool isMapped() const;
+
+    /**
+     * Returns the number of features in the index.
+     */
+    qgssize size() const;
+
+    /**
+     * Returns the number of children of each node of the tree.
+     */
+    int nodeSize() const;
+
+    /**
+     * Returns the bounding box of all the features in the index.
+     */
+    QgsRectangle extent() const;
+
+    /**
+     * Returns the IDs of the features with a bounding box which intersects the specified \a rectangle.
+     *
+     * The IDs are returned in no particular order.
+     */
+    QList<QgsFeatureId> intersects( const QgsRectangle &rectangle ) const;
+
+    /**
+     * Calls a \a visitor function for each feature with a bounding box which intersects the
+     * specified \a rectangle. The search stops as soon as the visitor returns FALSE.
+     *
+     * \note Not available in Python bindings
+     */
+    void intersects( const QgsRectangle &rectangle, const std::function<bool( QgsFeatureId )> &visitor ) const SIP_SKIP;
+
+    /**
+     * Returns the IDs of the \a neighbors features with the nearest bounding box to the specified \a point,
+     * ordered by distance.
+     *
+     * If \a maxDistance is specified, then only features with a bounding box within this distance
+     * of \a point are returned.
+     */
+    QList<QgsFeatureId> nearestNeighbor( const QgsPointXY &point, int neighbors = 1, double maxDistance = 0 ) const;
+
+    /**
+     * Returns the position of the point ( \a x, \a y ) along a Hilbert curve of order 16
+     * filling \a extent.
+     *
+     * This is the order in which the index packs the feature bounding boxes, by the
+     * position of their center. Sorting items by this value keeps neighbouring items
+     * close to each other.
+     */
+    static quint32 hilbertIndex( double x, double y, const QgsRectangle &extent );
+
+  private:
+
+    //! Implicitly shared data pointer
+    QgsPackedSpatialIndexPrivate *d = nullptr;
+
+    friend class TestQgsPackedSpatialIndex;
+};
+
+#endif // QGSPACKEDSPATIALINDEX_H
@@ -84,6 +84,9 @@
 // canonical project instance
 QgsProject *QgsProject::sProject = nullptr;
 
+// the project set for the current thread with setThreadInstance(), which takes precedence over sProject
+static thread_local QgsProject *sThreadProject = nullptr;
+
 ///@cond PRIVATE
 class ScopedIntIncrementor
 {
@@ -490,6 +493,10 @@ QgsProject::~QgsProject()
   {
     sProject = nullptr;
   }
+  if ( this == sThreadProject )
+  {
+    sThreadProject = nullptr;
+  }
 }
 
 void QgsProject::setInstance( QgsProject *project )
@@ -497,9 +504,16 @@ void QgsProject::setInstance( QgsProject *project )
   sProject = project;
 }
 
+void QgsProject::setThreadInstance( QgsProject *project )
+{
+  sThreadProject = project;
+}
 
 QgsProject *QgsProject::instance()
 {
+  if ( sThreadProject )
+    return sThreadProject;
+
   if ( !sProject )
   {
     sProject = new QgsProject;
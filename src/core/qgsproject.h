@@ -177,6 +177,20 @@ class CORE_EXPORT QgsProject : public QObject, public QgsExpressionContextGenera
      */
     static void setInstance( QgsProject *project ) ;
 
+    /**
+     * Sets the project returned by instance() in the calling thread only to \a project.
+     * Setting it to NULLPTR makes instance() return the singleton instance again.
+     *
+     * This is used by the worker threads of QGIS server, which handle concurrent requests
+     * with their own copies of the projects.
+     *
+     * \note the caller keeps the ownership of \a project and must reset the thread instance before deleting it.
+     * \see instance()
+     * \see setInstance()
+     * \since QGIS 3.18
+     */
+    static void setThreadInstance( QgsProject *project ) SIP_SKIP;
+
 
     /**
      * Create a new QgsProject.
@@ -0,0 +1,114 @@
+/***************************************************************************
+  qgsrenderarena.cpp
+  ------------------
+  Date                 : October 2026
+  Copyright            : (C) 2026 by QGIS contributors
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qgsrenderarena.h"
+
+#include <algorithm>
+#include <cstdint>
+
+QgsRenderArena::QgsRenderArena( std::size_t blockSize )
+  : mBlockSize( std::max< std::size_t >( blockSize, 1 ) )
+{
+}
+
+QgsRenderArena::~QgsRenderArena() = default;
+
+void *QgsRenderArena::allocate( std::size_t size, std::size_t alignment )
+{
+  while ( mCurrentBlock < mBlocks.size() )
+  {
+    Block &block = mBlocks[ mCurrentBlock ];
+    if ( unsigned char *address = alignedAddress( block, mOffset, size, alignment ) )
+    {
+      mOffset = static_cast< std::size_t >( address - block.data.get() ) + size;
+      return address;
+    }
+
+    if ( mCurrentBlock + 1 == mBlocks.size() )
+      break;
+
+    // blocks kept from a previous use of the arena
+    block.used = mOffset;
+    mCurrentBlock++;
+    mOffset = 0;
+  }
+
+  Block block;
+  block.size = std::max( mBlockSize, size + alignment );
+  block.data.reset( new unsigned char[ block.size ] );
+  if ( !mBlocks.empty() )
+  {
+    mBlocks[ mCurrentBlock ].used = mOffset;
+    mCurrentBlock = mBlocks.size();
+  }
+  mBlocks.emplace_back( std::move( block ) );
+
+  unsigned char *address = alignedAddress( mBlocks.back(), 0, size, alignment );
+  mOffset = static_cast< std::size_t >( address - mBlocks.back().data.get() ) + size;
+  return address;
+}
+
+QgsRenderArena::Marker QgsRenderArena::marker() const
+{
+  Marker marker;
+  marker.block = mCurrentBlock;
+  marker.offset = mOffset;
+  return marker;
+}
+
+void QgsRenderArena::rewind( const Marker &marker )
+{
+  mCurrentBlock = marker.block;
+  mOffset = marker.offset;
+}
+
+void QgsRenderArena::reset()
+{
+  if ( mBlocks.size() > 1 )
+  {
+    // merge the blocks, so that the same allocations fit in a single block next time
+    Block block;
+    block.size = capacity();
+    block.data.reset( new unsigned char[ block.size ] );
+    mBlocks.clear();
+    mBlocks.emplace_back( std::move( block ) );
+  }
+  mCurrentBlock = 0;
+  mOffset = 0;
+}
+
+std::size_t QgsRenderArena::bytesUsed() const
+{
+  std::size_t used = mOffset;
+  for ( std::size_t i = 0; i < mCurrentBlock && i < mBlocks.size(); ++i )
+    used += mBlocks[i].used;
+  return used;
+}
+
+std::size_t QgsRenderArena::capacity() const
+{
+  std::size_t capacity = 0;
+  for ( const Block &block : mBlocks )
+    capacity += block.size;
+  return capacity;
+}
+
+unsigned char *QgsRenderArena::alignedAddress( const Block &block, std::size_t offset, std::size_t size, std::size_t alignment )
+{
+  const std::uintptr_t start = reinterpret_cast< std::uintptr_t >( block.data.get() );
+  const std::uintptr_t aligned = ( start + offset + alignment - 1 ) & ~static_cast< std::uintptr_t >( alignment - 1 );
+  if ( aligned + size > start + block.size )
+    return nullptr;
+  return reinterpret_cast< unsigned char * >( aligned );
+}
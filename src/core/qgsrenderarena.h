@@ -0,0 +1,185 @@
+/***************************************************************************
+  qgsrenderarena.h
+  ----------------
+  Date                 : October 2026
+  Copyright            : (C) 2026 by QGIS contributors
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef QGSRENDERARENA_H
+#define QGSRENDERARENA_H
+
+#define SIP_NO_FILE
+
+#include "qgis_core.h"
+
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+/**
+ * \ingroup core
+ * \brief A monotonic memory arena for the temporary buffers of a rendering operation.
+ *
+ * Allocating from the arena only bumps an offset inside a block of memory, and the
+ * memory is never freed individually: it is reclaimed all at once by reset(), or back to a
+ * marker() by rewind(). The blocks are kept between resets, so once an arena has grown
+ * to the needs of a render, temporary buffers do not hit the heap allocator anymore.
+ * This avoids the contention on the allocator between concurrent render threads.
+ *
+ * Only trivially destructible objects can be stored in the arena, as no destructor is ever called.
+ *
+ * An arena is not thread safe. Each QgsRenderContext owns its own arena, see QgsRenderContext::renderArena().
+ *
+ * \see QgsRenderArenaScope
+ * \note not available in Python bindings
+ * \since QGIS 3.18
+ */
+class CORE_EXPORT QgsRenderArena
+{
+  public:
+
+    //! Default size of the blocks allocated by the arena, in bytes
+    static const std::size_t DEFAULT_BLOCK_SIZE = 64 * 1024;
+
+    /**
+     * Position of the arena, which can be restored with rewind().
+     */
+    struct Marker
+    {
+      //! Index of the current block
+      std::size_t block = 0;
+      //! Offset in the current block
+      std::size_t offset = 0;
+    };
+
+    /**
+     * Constructor for QgsRenderArena, which allocates memory in blocks of at least \a blockSize bytes.
+     *
+     * No memory is allocated until the first allocation.
+     */
+    explicit QgsRenderArena( std::size_t blockSize = DEFAULT_BLOCK_SIZE );
+    ~QgsRenderArena();
+
+    //! QgsRenderArena cannot be copied
+    QgsRenderArena( const QgsRenderArena &other ) = delete;
+    //! QgsRenderArena cannot be copied
+    QgsRenderArena &operator=( const QgsRenderArena &other ) = delete;
+
+    /**
+     * Allocates \a size bytes aligned to \a alignment, which must be a power of two.
+     *
+     * The memory is uninitialized, and stays valid until the arena is reset or rewound
+     * to a marker taken before the allocation.
+     */
+    void *allocate( std::size_t size, std::size_t alignment = alignof( std::max_align_t ) );
+
+    /**
+     * Allocates an uninitialized array of \a count objects of type T.
+     */
+    template <typename T>
+    T *allocateArray( std::size_t count )
+    {
+      static_assert( std::is_trivially_destructible< T >::value, "only trivially destructible types can be allocated in a QgsRenderArena" );
+      return static_cast< T * >( allocate( count * sizeof( T ), alignof( T ) ) );
+    }
+
+    /**
+     * Returns the current position of the arena.
+     * \see rewind()
+     */
+    Marker marker() const;
+
+    /**
+     * Releases all the allocations made since \a marker was taken.
+     * \see marker()
+     */
+    void rewind( const Marker &marker );
+
+    /**
+     * Releases all the allocations. The memory blocks are kept for the next allocations.
+     *
+     * If the previous allocations needed several blocks, they are merged into a single block
+     * large enough for all of them.
+     */
+    void reset();
+
+    /**
+     * Returns the number of bytes currently allocated from the arena, including the alignment padding.
+     */
+    std::size_t bytesUsed() const;
+
+    /**
+     * Returns the total size of the memory blocks owned by the arena, in bytes.
+     */
+    std::size_t capacity() const;
+
+  private:
+
+    struct Block
+    {
+      std::unique_ptr< unsigned char[] > data;
+      std::size_t size = 0;
+      //! Bytes used in the block when the next block became the current one
+      std::size_t used = 0;
+    };
+
+    //! Returns the address in \a block at \a offset aligned to \a alignment, or nullptr if \a size bytes do not fit
+    static unsigned char *alignedAddress( const Block &block, std::size_t offset, std::size_t size, std::size_t alignment );
+
+    std::size_t mBlockSize = DEFAULT_BLOCK_SIZE;
+    std::vector< Block > mBlocks;
+    std::size_t mCurrentBlock = 0;
+    std::size_t mOffset = 0;
+};
+
+/**
+ * \ingroup core
+ * \brief Scoped object which releases all the allocations made from a QgsRenderArena
+ * during its lifetime.
+ *
+ * Nested scopes can be used, e.g. by functions which use temporary buffers while a caller
+ * holds its own buffers from the same arena.
+ *
+ * \note not available in Python bindings
+ * \since QGIS 3.18
+ */
+class QgsRenderArenaScope
+{
+  public:
+
+    /**
+     * Constructor for QgsRenderArenaScope, which records the current position of \a arena.
+     */
+    explicit QgsRenderArenaScope( QgsRenderArena &arena )
+      : mArena( arena )
+      , mMarker( arena.marker() )
+    {}
+
+    /**
+     * Releases the allocations made from the arena since the scope was created.
+     */
+    ~QgsRenderArenaScope()
+    {
+      mArena.rewind( mMarker );
+    }
+
+    //! QgsRenderArenaScope cannot be copied
+    QgsRenderArenaScope( const QgsRenderArenaScope &other ) = delete;
+    //! QgsRenderArenaScope cannot be copied
+    QgsRenderArenaScope &operator=( const QgsRenderArenaScope &other ) = delete;
+
+  private:
+
+    QgsRenderArena &mArena;
+    QgsRenderArena::Marker mMarker;
+};
+
+#endif // QGSRENDERARENA_H
@@ -24,6 +24,7 @@
 #include "qgsfeaturefilterprovider.h"
 #include "qgslogger.h"
 #include "qgspoint.h"
+#include "qgsrenderarena.h"
 
 #define POINTS_TO_MM 2.83464567
 #define INCH_TO_MM 25.4
@@ -561,4 +562,11 @@ void QgsRenderContext::setZRange( const QgsDoubleRange &range )
   mZRange = range;
 }
 
+QgsRenderArena &QgsRenderContext::renderArena()
+{
+  if ( !mRenderArena )
+    mRenderArena = qgis::make_unique< QgsRenderArena >();
+  return *mRenderArena;
+}
+
 
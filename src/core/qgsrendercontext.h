@@ -45,6 +45,7 @@ class QgsRenderedFeatureHandlerInterface;
 class QgsSymbolLayer;
 class QgsMaskIdProvider;
 class QgsMapClippingRegion;
+class QgsRenderArena;
 
 
 /**
@@ -872,6 +873,18 @@ class CORE_EXPORT QgsRenderContext : public QgsTemporalRangeObject
      */
     void setZRange( const QgsDoubleRange &range );
 
+    /**
+     * Returns the memory arena for the temporary buffers of the rendering operation.
+     *
+     * Each render context has its own arena, which is not shared with its copies, so that
+     * concurrent rendering operations do not contend on the heap allocator. Allocations
+     * should be released as soon as they are no longer needed, using a QgsRenderArenaScope.
+     *
+     * \note not available in Python bindings
+     * \since QGIS 3.18
+     */
+    QgsRenderArena &renderArena() SIP_SKIP;
+
   private:
 
     Flags mFlags;
@@ -970,6 +983,8 @@ class CORE_EXPORT QgsRenderContext : public QgsTemporalRangeObject
 
     QgsDoubleRange mZRange;
 
+    std::unique_ptr< QgsRenderArena > mRenderArena;
+
 #ifdef QGISDEBUG
     bool mHasTransformContext = false;
 #endif
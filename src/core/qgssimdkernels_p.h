@@ -0,0 +1,449 @@
+/***************************************************************************
+                      qgssimdkernels_p.h
+                     --------------------
+Date                 : October 2026
+Copyright            : (C) 2026 by QGIS contributors
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef QGSSIMDKERNELS_PRIVATE_H
+#define QGSSIMDKERNELS_PRIVATE_H
+
+/// @cond PRIVATE
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the QGIS API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+
+#include <cmath>
+#include <cstddef>
+#include <limits>
+
+// SSE2 is always available on x86-64, NEON is used on 64 bit ARM. AVX is used when the build
+// targets it (e.g. -mavx2 or /arch:AVX2). Otherwise GCC and clang builds for x86 also compile
+// the AVX kernels for this instruction set only, and use them when the CPU supports it.
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+#include <emmintrin.h>
+#define QGS_SIMD_SSE2
+#elif defined( __ARM_NEON ) && defined( __aarch64__ )
+#include <arm_neon.h>
+#define QGS_SIMD_NEON
+#endif
+
+#if defined( __AVX__ )
+#include <immintrin.h>
+#define QGS_SIMD_AVX
+#define QGS_SIMD_AVX_TARGET
+#elif defined( QGS_SIMD_SSE2 ) && defined( __GNUC__ ) && ( defined( __x86_64__ ) || defined( __i386__ ) )
+#include <immintrin.h>
+#define QGS_SIMD_AVX
+#define QGS_SIMD_AVX_DISPATCH
+#define QGS_SIMD_AVX_TARGET __attribute__( ( target( "avx" ) ) )
+#endif
+
+/**
+ * \ingroup core
+ * Batch kernels for the coordinate and pixel loops of the rendering hot paths.
+ *
+ * The coordinate kernels work on arrays of interleaved x, y coordinates (e.g. the data of a QPolygonF).
+ * All the kernels give exactly the same results as their scalar equivalents.
+ */
+class QgsSimdKernels
+{
+  public:
+
+    //! Flags of QgsSimdKernels::boundariesCrossed()
+    enum Boundary
+    {
+      XMax = 1, //!< Some points have x >= xMax
+      YMax = 2, //!< Some points have y >= yMax
+      XMin = 4, //!< Some points have x <= xMin
+      YMin = 8, //!< Some points have y <= yMin
+    };
+
+    /**
+     * Returns TRUE if the AVX kernels are used, i.e. if the build targets AVX or if they
+     * are compiled separately and the CPU supports AVX.
+     */
+    static bool useAvx()
+    {
+#if defined( QGS_SIMD_AVX_DISPATCH )
+      static const bool sUseAvx = __builtin_cpu_supports( "avx" );
+      return sUseAvx;
+#elif defined( QGS_SIMD_AVX )
+      return true;
+#else
+      return false;
+#endif
+    }
+
+    /**
+     * Applies an affine transform to the \a count points stored in \a xy:
+     * x' = m11 * x + m21 * y + dx and y' = m12 * x + m22 * y + dy,
+     * computed in the same order as QTransform::map().
+     */
+    static void affineTransform( double *xy, std::size_t count, double m11, double m12, double m21, double m22, double dx, double dy )
+    {
+      if ( m12 == 0 && m21 == 0 )
+      {
+        scaleTranslate( xy, count, m11, m22, dx, dy );
+        return;
+      }
+
+      std::size_t i = 0;
+#if defined( QGS_SIMD_AVX )
+      if ( useAvx() )
+        i = affineTransformAvx( xy, count, m11, m12, m21, m22, dx, dy );
+      else
+#endif
+        i = affineTransformVector( xy, count, m11, m12, m21, m22, dx, dy );
+
+      for ( ; i < count; ++i )
+      {
+        const double x = xy[2 * i];
+        const double y = xy[2 * i + 1];
+        xy[2 * i] = m11 * x + m21 * y + dx;
+        xy[2 * i + 1] = m12 * x + m22 * y + dy;
+      }
+    }
+
+    /**
+     * Scales and translates the \a count points stored in \a xy:
+     * x' = sx * x + dx and y' = sy * y + dy.
+     */
+    static void scaleTranslate( double *xy, std::size_t count, double sx, double sy, double dx, double dy )
+    {
+      std::size_t i = 0;
+#if defined( QGS_SIMD_AVX )
+      if ( useAvx() )
+        i = scaleTranslateAvx( xy, count, sx, sy, dx, dy );
+      else
+#endif
+        i = scaleTranslateVector( xy, count, sx, sy, dx, dy );
+
+      for ( ; i < count; ++i )
+      {
+        xy[2 * i] = sx * xy[2 * i] + dx;
+        xy[2 * i + 1] = sy * xy[2 * i + 1] + dy;
+      }
+    }
+
+    /**
+     * Returns the boundaries of the rectangle (\a xMin, \a yMin, \a xMax, \a yMax) for which at least one
+     * of the \a count points stored in \a xy is not strictly inside, as a combination of Boundary flags.
+     *
+     * Points with NaN coordinates are not inside any boundary.
+     */
+    static int boundariesCrossed( const double *xy, std::size_t count, double xMin, double yMin, double xMax, double yMax )
+    {
+      // bit 0: all x are inside, bit 1: all y are inside
+      int insideMax = 3;
+      int insideMin = 3;
+
+      std::size_t i = 0;
+#if defined( QGS_SIMD_AVX )
+      if ( useAvx() )
+        i = boundariesCrossedAvx( xy, count, xMin, yMin, xMax, yMax, insideMax, insideMin );
+      else
+#endif
+        i = boundariesCrossedVector( xy, count, xMin, yMin, xMax, yMax, insideMax, insideMin );
+
+      for ( ; i < count; ++i )
+      {
+        const double x = xy[2 * i];
+        const double y = xy[2 * i + 1];
+        if ( !( x < xMax ) )
+          insideMax &= ~1;
+        if ( !( y < yMax ) )
+          insideMax &= ~2;
+        if ( !( x > xMin ) )
+          insideMin &= ~1;
+        if ( !( y > yMin ) )
+          insideMin &= ~2;
+      }
+
+      int crossed = 0;
+      if ( !( insideMax & 1 ) )
+        crossed |= XMax;
+      if ( !( insideMax & 2 ) )
+        crossed |= YMax;
+      if ( !( insideMin & 1 ) )
+        crossed |= XMin;
+      if ( !( insideMin & 2 ) )
+        crossed |= YMin;
+      return crossed;
+    }
+
+    /**
+     * Sets \a isNoData for each of the \a count \a values which is NaN or equal to \a noDataValue,
+     * with the same tolerance as qgsDoubleNear().
+     */
+    static void noDataMask( const double *values, std::size_t count, double noDataValue, bool *isNoData )
+    {
+      const double epsilon = 4 * std::numeric_limits<double>::epsilon();
+
+      std::size_t i = 0;
+#if defined( QGS_SIMD_AVX )
+      if ( useAvx() )
+        i = noDataMaskAvx( values, count, noDataValue, epsilon, isNoData );
+      else
+#endif
+        i = noDataMaskVector( values, count, noDataValue, epsilon, isNoData );
+
+      for ( ; i < count; ++i )
+      {
+        const double diff = values[i] - noDataValue;
+        isNoData[i] = std::isnan( values[i] ) || ( diff > -epsilon && diff <= epsilon );
+      }
+    }
+
+  private:
+
+    // The kernels below process the start of the arrays and return the number of items processed,
+    // the remaining ones are processed by the scalar loops of the public kernels.
+
+#if defined( QGS_SIMD_AVX )
+    QGS_SIMD_AVX_TARGET static std::size_t affineTransformAvx( double *xy, std::size_t count, double m11, double m12, double m21, double m22, double dx, double dy )
+    {
+      std::size_t i = 0;
+      const __m256d diagonal = _mm256_setr_pd( m11, m22, m11, m22 );
+      const __m256d antiDiagonal = _mm256_setr_pd( m21, m12, m21, m12 );
+      const __m256d translation = _mm256_setr_pd( dx, dy, dx, dy );
+      for ( ; i + 2 <= count; i += 2 )
+      {
+        const __m256d p = _mm256_loadu_pd( xy + 2 * i );
+        // y, x of both points
+        const __m256d swapped = _mm256_permute_pd( p, 0x5 );
+        const __m256d r = _mm256_add_pd( _mm256_add_pd( _mm256_mul_pd( p, diagonal ), _mm256_mul_pd( swapped, antiDiagonal ) ), translation );
+        _mm256_storeu_pd( xy + 2 * i, r );
+      }
+      return i;
+    }
+
+    QGS_SIMD_AVX_TARGET static std::size_t scaleTranslateAvx( double *xy, std::size_t count, double sx, double sy, double dx, double dy )
+    {
+      std::size_t i = 0;
+      const __m256d scale = _mm256_setr_pd( sx, sy, sx, sy );
+      const __m256d translation = _mm256_setr_pd( dx, dy, dx, dy );
+      for ( ; i + 2 <= count; i += 2 )
+      {
+        const __m256d p = _mm256_loadu_pd( xy + 2 * i );
+        _mm256_storeu_pd( xy + 2 * i, _mm256_add_pd( _mm256_mul_pd( p, scale ), translation ) );
+      }
+      return i;
+    }
+
+    QGS_SIMD_AVX_TARGET static std::size_t boundariesCrossedAvx( const double *xy, std::size_t count, double xMin, double yMin, double xMax, double yMax, int &insideMax, int &insideMin )
+    {
+      std::size_t i = 0;
+      const __m256d maximum = _mm256_setr_pd( xMax, yMax, xMax, yMax );
+      const __m256d minimum = _mm256_setr_pd( xMin, yMin, xMin, yMin );
+      __m256d accMax = _mm256_castsi256_pd( _mm256_set1_epi64x( -1 ) );
+      __m256d accMin = accMax;
+      for ( ; i + 2 <= count; i += 2 )
+      {
+        const __m256d p = _mm256_loadu_pd( xy + 2 * i );
+        accMax = _mm256_and_pd( accMax, _mm256_cmp_pd( p, maximum, _CMP_LT_OQ ) );
+        accMin = _mm256_and_pd( accMin, _mm256_cmp_pd( p, minimum, _CMP_GT_OQ ) );
+      }
+      const int maskMax = _mm256_movemask_pd( accMax );
+      const int maskMin = _mm256_movemask_pd( accMin );
+      insideMax = maskMax & ( maskMax >> 2 ) & 3;
+      insideMin = maskMin & ( maskMin >> 2 ) & 3;
+      return i;
+    }
+
+    QGS_SIMD_AVX_TARGET static std::size_t noDataMaskAvx( const double *values, std::size_t count, double noDataValue, double epsilon, bool *isNoData )
+    {
+      std::size_t i = 0;
+      const __m256d noData = _mm256_set1_pd( noDataValue );
+      const __m256d lower = _mm256_set1_pd( -epsilon );
+      const __m256d upper = _mm256_set1_pd( epsilon );
+      for ( ; i + 4 <= count; i += 4 )
+      {
+        const __m256d v = _mm256_loadu_pd( values + i );
+        const __m256d diff = _mm256_sub_pd( v, noData );
+        const __m256d near = _mm256_and_pd( _mm256_cmp_pd( diff, lower, _CMP_GT_OQ ), _mm256_cmp_pd( diff, upper, _CMP_LE_OQ ) );
+        const int mask = _mm256_movemask_pd( _mm256_or_pd( _mm256_cmp_pd( v, v, _CMP_UNORD_Q ), near ) );
+        isNoData[i] = mask & 1;
+        isNoData[i + 1] = mask & 2;
+        isNoData[i + 2] = mask & 4;
+        isNoData[i + 3] = mask & 8;
+      }
+      return i;
+    }
+#endif
+
+    static std::size_t affineTransformVector( double *xy, std::size_t count, double m11, double m12, double m21, double m22, double dx, double dy )
+    {
+      std::size_t i = 0;
+#if defined( QGS_SIMD_SSE2 )
+      const __m128d diagonal = _mm_setr_pd( m11, m22 );
+      const __m128d antiDiagonal = _mm_setr_pd( m21, m12 );
+      const __m128d translation = _mm_setr_pd( dx, dy );
+      for ( ; i < count; ++i )
+      {
+        const __m128d p = _mm_loadu_pd( xy + 2 * i );
+        const __m128d swapped = _mm_shuffle_pd( p, p, 0x1 );
+        const __m128d r = _mm_add_pd( _mm_add_pd( _mm_mul_pd( p, diagonal ), _mm_mul_pd( swapped, antiDiagonal ) ), translation );
+        _mm_storeu_pd( xy + 2 * i, r );
+      }
+#elif defined( QGS_SIMD_NEON )
+      const double diagonalValues[2] = { m11, m22 };
+      const double antiDiagonalValues[2] = { m21, m12 };
+      const double translationValues[2] = { dx, dy };
+      const float64x2_t diagonal = vld1q_f64( diagonalValues );
+      const float64x2_t antiDiagonal = vld1q_f64( antiDiagonalValues );
+      const float64x2_t translation = vld1q_f64( translationValues );
+      for ( ; i < count; ++i )
+      {
+        const float64x2_t p = vld1q_f64( xy + 2 * i );
+        const float64x2_t swapped = vextq_f64( p, p, 1 );
+        const float64x2_t r = vaddq_f64( vaddq_f64( vmulq_f64( p, diagonal ), vmulq_f64( swapped, antiDiagonal ) ), translation );
+        vst1q_f64( xy + 2 * i, r );
+      }
+#else
+      ( void )xy;
+      ( void )count;
+      ( void )m11;
+      ( void )m12;
+      ( void )m21;
+      ( void )m22;
+      ( void )dx;
+      ( void )dy;
+#endif
+      return i;
+    }
+
+    static std::size_t scaleTranslateVector( double *xy, std::size_t count, double sx, double sy, double dx, double dy )
+    {
+      std::size_t i = 0;
+#if defined( QGS_SIMD_SSE2 )
+      const __m128d scale = _mm_setr_pd( sx, sy );
+      const __m128d translation = _mm_setr_pd( dx, dy );
+      for ( ; i < count; ++i )
+      {
+        const __m128d p = _mm_loadu_pd( xy + 2 * i );
+        _mm_storeu_pd( xy + 2 * i, _mm_add_pd( _mm_mul_pd( p, scale ), translation ) );
+      }
+#elif defined( QGS_SIMD_NEON )
+      const double scaleValues[2] = { sx, sy };
+      const double translationValues[2] = { dx, dy };
+      const float64x2_t scale = vld1q_f64( scaleValues );
+      const float64x2_t translation = vld1q_f64( translationValues );
+      for ( ; i < count; ++i )
+      {
+        const float64x2_t p = vld1q_f64( xy + 2 * i );
+        vst1q_f64( xy + 2 * i, vaddq_f64( vmulq_f64( p, scale ), translation ) );
+      }
+#else
+      ( void )xy;
+      ( void )count;
+      ( void )sx;
+      ( void )sy;
+      ( void )dx;
+      ( void )dy;
+#endif
+      return i;
+    }
+
+    static std::size_t boundariesCrossedVector( const double *xy, std::size_t count, double xMin, double yMin, double xMax, double yMax, int &insideMax, int &insideMin )
+    {
+      std::size_t i = 0;
+#if defined( QGS_SIMD_SSE2 )
+      const __m128d maximum = _mm_setr_pd( xMax, yMax );
+      const __m128d minimum = _mm_setr_pd( xMin, yMin );
+      __m128d accMax = _mm_cmpeq_pd( maximum, maximum );
+      __m128d accMin = _mm_cmpeq_pd( minimum, minimum );
+      for ( ; i < count; ++i )
+      {
+        const __m128d p = _mm_loadu_pd( xy + 2 * i );
+        accMax = _mm_and_pd( accMax, _mm_cmplt_pd( p, maximum ) );
+        accMin = _mm_and_pd( accMin, _mm_cmpgt_pd( p, minimum ) );
+      }
+      insideMax = _mm_movemask_pd( accMax );
+      insideMin = _mm_movemask_pd( accMin );
+#elif defined( QGS_SIMD_NEON )
+      const double maximumValues[2] = { xMax, yMax };
+      const double minimumValues[2] = { xMin, yMin };
+      const float64x2_t maximum = vld1q_f64( maximumValues );
+      const float64x2_t minimum = vld1q_f64( minimumValues );
+      uint64x2_t accMax = vdupq_n_u64( ~0ULL );
+      uint64x2_t accMin = accMax;
+      for ( ; i < count; ++i )
+      {
+        const float64x2_t p = vld1q_f64( xy + 2 * i );
+        accMax = vandq_u64( accMax, vcltq_f64( p, maximum ) );
+        accMin = vandq_u64( accMin, vcgtq_f64( p, minimum ) );
+      }
+      insideMax = ( vgetq_lane_u64( accMax, 0 ) ? 1 : 0 ) | ( vgetq_lane_u64( accMax, 1 ) ? 2 : 0 );
+      insideMin = ( vgetq_lane_u64( accMin, 0 ) ? 1 : 0 ) | ( vgetq_lane_u64( accMin, 1 ) ? 2 : 0 );
+#else
+      ( void )xy;
+      ( void )count;
+      ( void )xMin;
+      ( void )yMin;
+      ( void )xMax;
+      ( void )yMax;
+      ( void )insideMax;
+      ( void )insideMin;
+#endif
+      return i;
+    }
+
+    static std::size_t noDataMaskVector( const double *values, std::size_t count, double noDataValue, double epsilon, bool *isNoData )
+    {
+      std::size_t i = 0;
+#if defined( QGS_SIMD_SSE2 )
+      const __m128d noData = _mm_set1_pd( noDataValue );
+      const __m128d lower = _mm_set1_pd( -epsilon );
+      const __m128d upper = _mm_set1_pd( epsilon );
+      for ( ; i + 2 <= count; i += 2 )
+      {
+        const __m128d v = _mm_loadu_pd( values + i );
+        const __m128d diff = _mm_sub_pd( v, noData );
+        const __m128d near = _mm_and_pd( _mm_cmpgt_pd( diff, lower ), _mm_cmple_pd( diff, upper ) );
+        const int mask = _mm_movemask_pd( _mm_or_pd( _mm_cmpunord_pd( v, v ), near ) );
+        isNoData[i] = mask & 1;
+        isNoData[i + 1] = mask & 2;
+      }
+#elif defined( QGS_SIMD_NEON )
+      const float64x2_t noData = vdupq_n_f64( noDataValue );
+      const float64x2_t lower = vdupq_n_f64( -epsilon );
+      const float64x2_t upper = vdupq_n_f64( epsilon );
+      for ( ; i + 2 <= count; i += 2 )
+      {
+        const float64x2_t v = vld1q_f64( values + i );
+        const float64x2_t diff = vsubq_f64( v, noData );
+        const uint64x2_t near = vandq_u64( vcgtq_f64( diff, lower ), vcleq_f64( diff, upper ) );
+        // NaN values are the ones which are not equal to themselves
+        const uint64x2_t nan = veorq_u64( vceqq_f64( v, v ), vdupq_n_u64( ~0ULL ) );
+        const uint64x2_t mask = vorrq_u64( nan, near );
+        isNoData[i] = vgetq_lane_u64( mask, 0 ) != 0;
+        isNoData[i + 1] = vgetq_lane_u64( mask, 1 ) != 0;
+      }
+#else
+      ( void )values;
+      ( void )count;
+      ( void )noDataValue;
+      ( void )epsilon;
+      ( void )isNoData;
+#endif
+      return i;
+    }
+};
+
+/// @endcond
+
+#endif // QGSSIMDKERNELS_PRIVATE_H
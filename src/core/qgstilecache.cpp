@@ -17,45 +17,560 @@
 
 #include "qgsnetworkaccessmanager.h"
 #include "qgsapplication.h"
+#include "qgis.h"
+#include "qgslogger.h"
+#include "qgssettings.h"
 #include <QAbstractNetworkCache>
+#include <QCache>
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
 #include <QImage>
+#include <QMutex>
+#include <QReadWriteLock>
+#include <QSaveFile>
+#include <QStandardPaths>
 
-QCache<QUrl, QImage> QgsTileCache::sTileCache( 256 );
-QMutex QgsTileCache::sTileCacheMutex;
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+///@cond PRIVATE
+
+//! Number of independently locked parts of the in-memory cache and of the disk store index
+static const int TILE_CACHE_STRIPES = 16;
+//! Number of tiles which can be stored in the in-memory cache
+static const int TILE_CACHE_MAX_COST = 256;
+
+/**
+ * Part of the in-memory cache, with its own lock.
+ */
+struct QgsTileCacheStripe
+{
+  QgsTileCacheStripe()
+    : cache( TILE_CACHE_MAX_COST / TILE_CACHE_STRIPES )
+  {}
+
+  QMutex mutex;
+  QCache<QUrl, QImage> cache;
+};
+
+/**
+ * In-memory cache of the decoded tiles, split in stripes according to the hash of the tile URLs.
+ */
+struct QgsTileMemoryCache
+{
+  QgsTileCacheStripe &stripe( const QUrl &url )
+  {
+    return stripes[ qHash( url ) % TILE_CACHE_STRIPES ];
+  }
+
+  QgsTileCacheStripe stripes[TILE_CACHE_STRIPES];
+};
+
+/**
+ * Header of the files of the decoded tile disk store, which is followed by the raw pixel data.
+ * Its size keeps the pixel data aligned when the file is memory mapped.
+ */
+struct QgsTileFileHeader
+{
+  char magic[4];
+  quint32 version;
+  qint32 width;
+  qint32 height;
+  qint32 format;
+  qint32 bytesPerLine;
+  //! Expiration date of the tile in ms since epoch
+  qint64 expiration;
+};
+
+static_assert( sizeof( QgsTileFileHeader ) == 32, "the pixel data of the tile files must stay aligned" );
+
+static const char TILE_FILE_MAGIC[4] = { 'Q', 'G', 'T', 'L' };
+static const quint32 TILE_FILE_VERSION = 2;
+//! Lifetime of the tiles whose network cache entry has no expiration date, in ms
+static const qint64 TILE_FILE_DEFAULT_LIFETIME = 24 * 60 * 60 * 1000;
+
+/**
+ * Content addressed store of decoded tiles on the disk.
+ *
+ * Each tile is saved uncompressed in a file named after the hash of its URL, and is memory
+ * mapped when it is read back. The store keeps an index of its files, built from the content
+ * of the directory when the store is first used, to remove the least recently used tiles when
+ * the store grows over its maximum size. The index is split in stripes with their own lock.
+ */
+class QgsTileDiskStore
+{
+  public:
+
+    QgsTileDiskStore()
+    {
+      QgsSettings settings;
+      QString networkCacheDirectory = settings.value( QStringLiteral( "cache/directory" ) ).toString();
+      if ( networkCacheDirectory.isEmpty() )
+        networkCacheDirectory = QStandardPaths::writableLocation( QStandardPaths::CacheLocation );
+      const QString defaultDirectory = networkCacheDirectory.isEmpty() ? QString() : QDir( networkCacheDirectory ).filePath( QStringLiteral( "decoded_tiles" ) );
+
+      mDirectory = settings.value( QStringLiteral( "cache/decodedTilesDirectory" ), defaultDirectory ).toString();
+      mMaximumSize = settings.value( QStringLiteral( "cache/decodedTilesSize" ), 256 * 1024 * 1024 ).toLongLong();
+    }
+
+    QString directory() const
+    {
+      QReadLocker locker( &mLock );
+      return mDirectory;
+    }
+
+    void setDirectory( const QString &directory )
+    {
+      QWriteLocker locker( &mLock );
+      if ( directory == mDirectory )
+        return;
+
+      mDirectory = directory;
+      mIndexed = false;
+      for ( Stripe &stripe : mStripes )
+        stripe.entries.clear();
+      mSize = 0;
+    }
+
+    qint64 maximumSize() const
+    {
+      return mMaximumSize;
+    }
+
+    void setMaximumSize( qint64 size )
+    {
+      mMaximumSize = size;
+      if ( !lockForRead() )
+        return;
+
+      if ( mSize > mMaximumSize )
+        trim();
+      mLock.unlock();
+    }
+
+    qint64 size()
+    {
+      if ( !lockForRead() )
+        return 0;
+
+      const qint64 size = mSize;
+      mLock.unlock();
+      return size;
+    }
+
+    bool tile( const QUrl &url, QImage &image )
+    {
+      if ( !lockForRead() )
+        return false;
+
+      const bool success = readTile( url, image );
+      mLock.unlock();
+      return success;
+    }
+
+    void insertTile( const QUrl &url, const QImage &image, const QDateTime &expiration )
+    {
+      if ( image.isNull() || !lockForRead() )
+        return;
+
+      writeTile( url, image, expiration );
+      if ( mSize > mMaximumSize )
+        trim();
+      mLock.unlock();
+    }
+
+    //! Removes all the tiles of the store
+    void clear()
+    {
+      QWriteLocker locker( &mLock );
+      if ( mDirectory.isEmpty() )
+        return;
+
+      QDirIterator it( mDirectory, QStringList() << QStringLiteral( "*.tile" ), QDir::Files, QDirIterator::Subdirectories );
+      while ( it.hasNext() )
+        QFile::remove( it.next() );
+
+      // the store is known to be empty now, no need to index it again
+      for ( Stripe &stripe : mStripes )
+        stripe.entries.clear();
+      mSize = 0;
+      mIndexed = true;
+    }
+
+  private:
+
+    struct Entry
+    {
+      qint64 size = 0;
+      quint64 lastAccess = 0;
+    };
+
+    struct Stripe
+    {
+      QMutex mutex;
+      QHash< QByteArray, Entry > entries;
+    };
+
+    //! Returns the key of the tile with given \a url, i.e. the hex encoded hash of the URL
+    static QByteArray key( const QUrl &url )
+    {
+      return QCryptographicHash::hash( url.toEncoded(), QCryptographicHash::Sha1 ).toHex();
+    }
+
+    Stripe &stripe( const QByteArray &key )
+    {
+      return mStripes[ qHash( key ) % TILE_CACHE_STRIPES ];
+    }
+
+    //! Returns the path of the file of the tile with given \a key. The files are spread in sub directories named after the first characters of the key
+    QString filePath( const QByteArray &key ) const
+    {
+      return QStringLiteral( "%1/%2/%3.tile" ).arg( mDirectory, QString::fromLatin1( key.left( 2 ) ), QString::fromLatin1( key.mid( 2 ) ) );
+    }
+
+    /**
+     * Locks the store for reading, building the index of the store first if needed.
+     * Returns FALSE, without keeping the lock, if the store is disabled.
+     */
+    bool lockForRead()
+    {
+      mLock.lockForRead();
+      while ( !mIndexed && !mDirectory.isEmpty() )
+      {
+        mLock.unlock();
+        {
+          QWriteLocker locker( &mLock );
+          if ( !mIndexed && !mDirectory.isEmpty() )
+            buildIndex();
+        }
+        mLock.lockForRead();
+      }
+
+      if ( mDirectory.isEmpty() )
+      {
+        mLock.unlock();
+        return false;
+      }
+      return true;
+    }
+
+    //! Builds the index from the files of the store directory, must be called with the lock held for writing
+    void buildIndex()
+    {
+      mIndexed = true;
+
+      struct IndexedFile
+      {
+        QDateTime lastModified;
+        QByteArray key;
+        qint64 size;
+      };
+      std::vector< IndexedFile > files;
+
+      QDirIterator it( mDirectory, QStringList() << QStringLiteral( "*.tile" ), QDir::Files, QDirIterator::Subdirectories );
+      while ( it.hasNext() )
+      {
+        it.next();
+        const QFileInfo info = it.fileInfo();
+        const QByteArray key = ( info.dir().dirName() + info.completeBaseName() ).toLatin1();
+        if ( key.size() != 40 )
+          continue;
+
+        files.push_back( { info.lastModified(), key, info.size() } );
+      }
+
+      // the modification dates give the order of use of the tiles from the previous sessions
+      std::sort( files.begin(), files.end(), []( const IndexedFile & a, const IndexedFile & b ) { return a.lastModified < b.lastModified; } );
+      for ( const IndexedFile &file : files )
+      {
+        Entry &entry = stripe( file.key ).entries[ file.key ];
+        entry.size = file.size;
+        entry.lastAccess = ++mAccessCounter;
+        mSize += file.size;
+      }
+
+      QgsDebugMsgLevel( QStringLiteral( "Indexed %1 decoded tiles (%2 bytes) in %3" ).arg( files.size() ).arg( static_cast< qint64 >( mSize ) ).arg( mDirectory ), 2 );
+
+      if ( mSize > mMaximumSize )
+        trim();
+    }
+
+    bool readTile( const QUrl &url, QImage &image )
+    {
+      const QByteArray tileKey = key( url );
+      {
+        Stripe &s = stripe( tileKey );
+        QMutexLocker locker( &s.mutex );
+        auto it = s.entries.find( tileKey );
+        if ( it == s.entries.end() )
+          return false;
+        it->lastAccess = ++mAccessCounter;
+      }
+
+      std::unique_ptr< QFile > file = qgis::make_unique< QFile >( filePath( tileKey ) );
+      if ( !file->open( QIODevice::ReadOnly ) )
+      {
+        removeTile( tileKey );
+        return false;
+      }
+
+      const qint64 fileSize = file->size();
+      uchar *data = fileSize > static_cast< qint64 >( sizeof( QgsTileFileHeader ) ) ? file->map( 0, fileSize ) : nullptr;
+      if ( !data )
+      {
+        file.reset();
+        removeTile( tileKey );
+        return false;
+      }
+
+      QgsTileFileHeader header;
+      std::memcpy( &header, data, sizeof( QgsTileFileHeader ) );
+      const bool valid = std::memcmp( header.magic, TILE_FILE_MAGIC, sizeof( TILE_FILE_MAGIC ) ) == 0
+                         && header.version == TILE_FILE_VERSION
+                         && header.width > 0 && header.height > 0
+                         && header.format > QImage::Format_MonoLSB && header.format < QImage::NImageFormats
+                         && header.format != QImage::Format_Indexed8
+                         && header.bytesPerLine > 0
+                         && fileSize == static_cast< qint64 >( sizeof( QgsTileFileHeader ) ) + static_cast< qint64 >( header.bytesPerLine ) * header.height;
+      const bool expired = header.expiration < QDateTime::currentMSecsSinceEpoch();
+      if ( !valid || expired )
+      {
+        file.reset();
+        removeTile( tileKey );
+        return false;
+      }
+
+      // the image keeps the file mapped, and the file is closed when the image data is released
+      image = QImage( static_cast< const uchar * >( data + sizeof( QgsTileFileHeader ) ), header.width, header.height, header.bytesPerLine,
+                      static_cast< QImage::Format >( header.format ),
+                      []( void *info ) { delete static_cast< QFile * >( info ); }, file.release() );
+      return true;
+    }
+
+    void writeTile( const QUrl &url, const QImage &image, const QDateTime &expiration )
+    {
+      QImage tileImage = image;
+      // images with a color table cannot be mapped back from the raw pixel data
+      if ( tileImage.colorCount() > 0 || tileImage.format() <= QImage::Format_Indexed8 )
+        tileImage = tileImage.convertToFormat( tileImage.hasAlphaChannel() ? QImage::Format_ARGB32_Premultiplied : QImage::Format_RGB32 );
+
+      QgsTileFileHeader header;
+      std::memcpy( header.magic, TILE_FILE_MAGIC, sizeof( TILE_FILE_MAGIC ) );
+      header.version = TILE_FILE_VERSION;
+      header.width = tileImage.width();
+      header.height = tileImage.height();
+      header.format = static_cast< qint32 >( tileImage.format() );
+      header.bytesPerLine = tileImage.bytesPerLine();
+      // tiles without an expiration date are kept for a bounded time, as the server may update them
+      header.expiration = expiration.isValid() ? expiration.toMSecsSinceEpoch() : QDateTime::currentMSecsSinceEpoch() + TILE_FILE_DEFAULT_LIFETIME;
+      const qint64 pixelSize = static_cast< qint64 >( header.bytesPerLine ) * header.height;
+
+      const QByteArray tileKey = key( url );
+      const QString path = filePath( tileKey );
+      if ( !QDir().mkpath( QFileInfo( path ).path() ) )
+      {
+        QgsDebugMsg( QStringLiteral( "Could not create the directory of decoded tile %1" ).arg( path ) );
+        return;
+      }
+
+      QSaveFile file( path );
+      if ( !file.open( QIODevice::WriteOnly )
+           || file.write( reinterpret_cast< const char * >( &header ), sizeof( QgsTileFileHeader ) ) != static_cast< qint64 >( sizeof( QgsTileFileHeader ) )
+           || file.write( reinterpret_cast< const char * >( tileImage.constBits() ), pixelSize ) != pixelSize
+           || !file.commit() )
+      {
+        QgsDebugMsg( QStringLiteral( "Could not write decoded tile %1: %2" ).arg( path, file.errorString() ) );
+        return;
+      }
+
+      Stripe &s = stripe( tileKey );
+      QMutexLocker locker( &s.mutex );
+      Entry &entry = s.entries[ tileKey ];
+      const qint64 fileSize = static_cast< qint64 >( sizeof( QgsTileFileHeader ) ) + pixelSize;
+      mSize += fileSize - entry.size;
+      entry.size = fileSize;
+      entry.lastAccess = ++mAccessCounter;
+    }
+
+    void removeTile( const QByteArray &tileKey )
+    {
+      Stripe &s = stripe( tileKey );
+      QMutexLocker locker( &s.mutex );
+      auto it = s.entries.find( tileKey );
+      if ( it == s.entries.end() )
+        return;
+
+      mSize -= it->size;
+      s.entries.erase( it );
+      QFile::remove( filePath( tileKey ) );
+    }
+
+    //! Removes the least recently used tiles until the store is back to 90% of its maximum size
+    void trim()
+    {
+      // a single thread trims the store at a time, the others keep going
+      if ( !mTrimMutex.tryLock() )
+        return;
+
+      struct Candidate
+      {
+        quint64 lastAccess;
+        QByteArray key;
+      };
+      std::vector< Candidate > candidates;
+      for ( Stripe &s : mStripes )
+      {
+        QMutexLocker locker( &s.mutex );
+        for ( auto it = s.entries.constBegin(); it != s.entries.constEnd(); ++it )
+          candidates.push_back( { it->lastAccess, it.key() } );
+      }
+      std::sort( candidates.begin(), candidates.end(), []( const Candidate & a, const Candidate & b ) { return a.lastAccess < b.lastAccess; } );
+
+      const qint64 targetSize = mMaximumSize / 10 * 9;
+      for ( const Candidate &candidate : candidates )
+      {
+        if ( mSize <= targetSize )
+          break;
+        removeTile( candidate.key );
+      }
+
+      mTrimMutex.unlock();
+    }
+
+    //! Protects the directory of the store. It is held for reading by all the tile operations
+    mutable QReadWriteLock mLock;
+    QString mDirectory;
+    bool mIndexed = false;
+
+    std::atomic< qint64 > mMaximumSize{ 0 };
+    std::atomic< qint64 > mSize{ 0 };
+    std::atomic< quint64 > mAccessCounter{ 0 };
+    QMutex mTrimMutex;
+    Stripe mStripes[TILE_CACHE_STRIPES];
+};
+
+Q_GLOBAL_STATIC( QgsTileMemoryCache, sTileMemoryCache )
+Q_GLOBAL_STATIC( QgsTileDiskStore, sTileDiskStore )
+
+///@endcond
 
 
 void QgsTileCache::insertTile( const QUrl &url, const QImage &image )
 {
-  QMutexLocker locker( &sTileCacheMutex );
-  sTileCache.insert( url, new QImage( image ) );
+  {
+    QgsTileCacheStripe &stripe = sTileMemoryCache()->stripe( url );
+    QMutexLocker locker( &stripe.mutex );
+    stripe.cache.insert( url, new QImage( image ) );
+  }
+
+  // only the tiles stored in the network disk cache are kept in the disk store, where they expire with their network cache entry
+  if ( sTileDiskStore()->directory().isEmpty() )
+    return;
+
+  const QNetworkCacheMetaData metaData = QgsNetworkAccessManager::instance()->cache()->metaData( url );
+  if ( metaData.isValid() && metaData.saveToDisk() )
+    sTileDiskStore()->insertTile( url, image, metaData.expirationDate() );
 }
 
 bool QgsTileCache::tile( const QUrl &url, QImage &image )
 {
-  QMutexLocker locker( &sTileCacheMutex );
-  bool success = false;
-  if ( QImage *i = sTileCache.object( url ) )
+  QgsTileCacheStripe &stripe = sTileMemoryCache()->stripe( url );
   {
-    image = *i;
-    success = true;
+    QMutexLocker locker( &stripe.mutex );
+    if ( QImage *i = stripe.cache.object( url ) )
+    {
+      image = *i;
+      return true;
+    }
   }
-  else if ( QgsNetworkAccessManager::instance()->cache()->metaData( url ).isValid() )
+
+  // the tiles are read and decoded without holding the lock, so that other tiles can be fetched meanwhile
+  bool success = sTileDiskStore()->tile( url, image );
+  if ( !success )
   {
-    if ( QIODevice *data = QgsNetworkAccessManager::instance()->cache()->data( url ) )
+    const QNetworkCacheMetaData metaData = QgsNetworkAccessManager::instance()->cache()->metaData( url );
+    if ( metaData.isValid() )
     {
-      QByteArray imageData = data->readAll();
-      delete data;
+      if ( QIODevice *data = QgsNetworkAccessManager::instance()->cache()->data( url ) )
+      {
+        QByteArray imageData = data->readAll();
+        delete data;
 
-      image = QImage::fromData( imageData );
+        image = QImage::fromData( imageData );
 
-      // cache it as well (mutex is already locked)
-      // Check for null because it could be a redirect (see: https://github.com/qgis/QGIS/issues/24336 )
-      if ( ! image.isNull( ) )
-      {
-        sTileCache.insert( url, new QImage( image ) );
-        success = true;
+        // Check for null because it could be a redirect (see: https://github.com/qgis/QGIS/issues/24336 )
+        if ( ! image.isNull( ) )
+        {
+          success = true;
+          if ( metaData.saveToDisk() )
+            sTileDiskStore()->insertTile( url, image, metaData.expirationDate() );
+        }
       }
     }
   }
+
+  if ( success )
+  {
+    QMutexLocker locker( &stripe.mutex );
+    stripe.cache.insert( url, new QImage( image ) );
+  }
   return success;
 }
+
+int QgsTileCache::totalCost()
+{
+  int cost = 0;
+  for ( QgsTileCacheStripe &stripe : sTileMemoryCache()->stripes )
+  {
+    QMutexLocker locker( &stripe.mutex );
+    cost += stripe.cache.totalCost();
+  }
+  return cost;
+}
+
+int QgsTileCache::maxCost()
+{
+  int cost = 0;
+  for ( QgsTileCacheStripe &stripe : sTileMemoryCache()->stripes )
+  {
+    QMutexLocker locker( &stripe.mutex );
+    cost += stripe.cache.maxCost();
+  }
+  return cost;
+}
+
+QString QgsTileCache::diskCacheDirectory()
+{
+  return sTileDiskStore()->directory();
+}
+
+void QgsTileCache::setDiskCacheDirectory( const QString &directory )
+{
+  sTileDiskStore()->setDirectory( directory );
+}
+
+qint64 QgsTileCache::maximumDiskCacheSize()
+{
+  return sTileDiskStore()->maximumSize();
+}
+
+void QgsTileCache::setMaximumDiskCacheSize( qint64 size )
+{
+  sTileDiskStore()->setMaximumSize( size );
+}
+
+qint64 QgsTileCache::diskCacheSize()
+{
+  return sTileDiskStore()->size();
+}
+
+void QgsTileCache::clearDiskCache()
+{
+  sTileDiskStore()->clear();
+}
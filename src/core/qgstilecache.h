@@ -17,10 +17,10 @@
 #define QGSTILECACHE_H
 
 #include "qgis_core.h"
-#include <QCache>
-#include <QMutex>
+#include <QtGlobal>
 
 class QImage;
+class QString;
 class QUrl;
 
 #define SIP_NO_FILE
@@ -31,6 +31,17 @@ class QUrl;
  * The in-memory cache is there to save CPU time otherwise wasted to read and
  * uncompress data saved on the disk.
  *
+ * Since QGIS 3.18, the decoded tiles are also kept on the disk in a store of
+ * their own, next to the network disk cache. The tiles of this store are saved
+ * uncompressed and are memory mapped when read back, so tiles which were evicted
+ * from the in-memory cache (e.g. during long atlas exports) do not need to be
+ * decoded again. Only tiles which were stored in the network disk cache are
+ * saved, and they expire at the same date as their network cache entry, or
+ * after a day if the entry has no expiration date. The store is cleared
+ * together with the network disk cache.
+ * The in-memory cache is split in several independently locked parts, so that
+ * concurrent renders do not wait on each other.
+ *
  * The class is thread safe (its methods can be called from any thread).
  *
  * \note Not available in Python bindings
@@ -51,15 +62,65 @@ class CORE_EXPORT QgsTileCache
     static bool tile( const QUrl &url, QImage &image );
 
     //! how many tiles are stored in the in-memory cache
-    static int totalCost() { QMutexLocker locker( &sTileCacheMutex ); return sTileCache.totalCost(); }
+    static int totalCost();
     //! how many tiles can be stored in the in-memory cache
-    static int maxCost() { QMutexLocker locker( &sTileCacheMutex ); return sTileCache.maxCost(); }
+    static int maxCost();
+
+    /**
+     * Returns the directory of the decoded tile disk store, or an empty string if the store is disabled.
+     *
+     * The default directory is the "decoded_tiles" sub directory of the network disk cache
+     * directory, and can be changed with the "cache/decodedTilesDirectory" setting.
+     *
+     * \see setDiskCacheDirectory()
+     * \since QGIS 3.18
+     */
+    static QString diskCacheDirectory();
+
+    /**
+     * Sets the \a directory of the decoded tile disk store. An empty \a directory disables the store.
+     *
+     * Tiles saved in the previous directory are left on the disk.
+     *
+     * \see diskCacheDirectory()
+     * \since QGIS 3.18
+     */
+    static void setDiskCacheDirectory( const QString &directory );
+
+    /**
+     * Returns the maximum size of the decoded tile disk store, in bytes.
+     *
+     * The default size can be changed with the "cache/decodedTilesSize" setting.
+     *
+     * \see setMaximumDiskCacheSize()
+     * \since QGIS 3.18
+     */
+    static qint64 maximumDiskCacheSize();
 
-  private:
-    //! in-memory cache
-    static QCache<QUrl, QImage> sTileCache;
-    //! mutex to protect the in-memory cache
-    static QMutex sTileCacheMutex;
+    /**
+     * Sets the maximum \a size of the decoded tile disk store, in bytes. When the
+     * store grows over this size, the least recently used tiles are removed.
+     *
+     * \see maximumDiskCacheSize()
+     * \since QGIS 3.18
+     */
+    static void setMaximumDiskCacheSize( qint64 size );
+
+    /**
+     * Returns the current size of the decoded tile disk store, in bytes.
+     *
+     * \since QGIS 3.18
+     */
+    static qint64 diskCacheSize();
+
+    /**
+     * Removes all the tiles of the decoded tile disk store.
+     *
+     * This is called when the network disk cache is cleared, as the store is read before it.
+     *
+     * \since QGIS 3.18
+     */
+    static void clearDiskCache();
 };
 
 #endif // QGSTILECACHE_H
@@ -23,6 +23,7 @@
 #include "qgscircularstring.h"
 #include "qgscompoundcurve.h"
 #include "qgsfeature.h"
+#include "qgsfeaturebatch.h"
 #include "qgsfeatureiterator.h"
 #include "qgsfeaturerequest.h"
 #include "qgsfeedback.h"
@@ -504,6 +505,9 @@ void QgsVectorDataProvider::clearMinMaxCache()
   mCacheMaxValues.clear();
 }
 
+//! Number of features read at once when filling the minimum and maximum values cache
+static const int MIN_MAX_BATCH_SIZE = 1000;
+
 void QgsVectorDataProvider::fillMinMaxCache() const
 {
   if ( !mCacheMinMaxDirty )
@@ -535,87 +539,119 @@ void QgsVectorDataProvider::fillMinMaxCache() const
     }
   }
 
-  QgsFeature f;
+  // numeric values are read straight from the typed columns of feature batches
   const QgsAttributeList keys = mCacheMinValues.keys();
+  QgsFeatureBatch batch( flds, keys );
   QgsFeatureIterator fi = getFeatures( QgsFeatureRequest().setSubsetOfAttributes( keys )
                                        .setFlags( QgsFeatureRequest::NoGeometry ) );
 
-  while ( fi.nextFeature( f ) )
+  while ( fi.nextBatch( batch, MIN_MAX_BATCH_SIZE ) )
   {
-    QgsAttributes attrs = f.attributes();
-    for ( int attributeIndex : keys )
+    for ( int column = 0; column < batch.columnCount(); ++column )
     {
-      const QVariant &varValue = attrs.at( attributeIndex );
-
-      if ( varValue.isNull() )
-        continue;
-
+      const int attributeIndex = batch.attributeIndex( column );
       switch ( flds.at( attributeIndex ).type() )
       {
         case QVariant::Int:
         {
-          int value = varValue.toInt();
-          if ( value < mCacheMinValues[ attributeIndex ].toInt() )
-            mCacheMinValues[ attributeIndex ] = value;
-          if ( value > mCacheMaxValues[ attributeIndex ].toInt() )
-            mCacheMaxValues[ attributeIndex ] = value;
+          const qint64 *values = batch.int64Data( column );
+          int minimum = mCacheMinValues[ attributeIndex ].toInt();
+          int maximum = mCacheMaxValues[ attributeIndex ].toInt();
+          for ( int row = 0; row < batch.size(); ++row )
+          {
+            if ( batch.isNull( column, row ) )
+              continue;
+            const int value = static_cast< int >( values[row] );
+            minimum = std::min( minimum, value );
+            maximum = std::max( maximum, value );
+          }
+          mCacheMinValues[ attributeIndex ] = minimum;
+          mCacheMaxValues[ attributeIndex ] = maximum;
           break;
         }
         case QVariant::LongLong:
         {
-          qlonglong value = varValue.toLongLong();
-          if ( value < mCacheMinValues[ attributeIndex ].toLongLong() )
-            mCacheMinValues[ attributeIndex ] = value;
-          if ( value > mCacheMaxValues[ attributeIndex ].toLongLong() )
-            mCacheMaxValues[ attributeIndex ] = value;
+          const qint64 *values = batch.int64Data( column );
+          qlonglong minimum = mCacheMinValues[ attributeIndex ].toLongLong();
+          qlonglong maximum = mCacheMaxValues[ attributeIndex ].toLongLong();
+          for ( int row = 0; row < batch.size(); ++row )
+          {
+            if ( batch.isNull( column, row ) )
+              continue;
+            minimum = std::min( minimum, static_cast< qlonglong >( values[row] ) );
+            maximum = std::max( maximum, static_cast< qlonglong >( values[row] ) );
+          }
+          mCacheMinValues[ attributeIndex ] = minimum;
+          mCacheMaxValues[ attributeIndex ] = maximum;
           break;
         }
         case QVariant::Double:
         {
-          double value = varValue.toDouble();
-          if ( value < mCacheMinValues[ attributeIndex ].toDouble() )
-            mCacheMinValues[attributeIndex ] = value;
-          if ( value > mCacheMaxValues[ attributeIndex ].toDouble() )
-            mCacheMaxValues[ attributeIndex ] = value;
-          break;
-        }
-        case QVariant::DateTime:
-        {
-          QDateTime value = varValue.toDateTime();
-          if ( value < mCacheMinValues[ attributeIndex ].toDateTime() || !mCacheMinValues[ attributeIndex ].isValid() )
-            mCacheMinValues[attributeIndex ] = value;
-          if ( value > mCacheMaxValues[ attributeIndex ].toDateTime() || !mCacheMaxValues[ attributeIndex ].isValid() )
-            mCacheMaxValues[ attributeIndex ] = value;
-          break;
-        }
-        case QVariant::Date:
-        {
-          QDate value = varValue.toDate();
-          if ( value < mCacheMinValues[ attributeIndex ].toDate() || !mCacheMinValues[ attributeIndex ].isValid() )
-            mCacheMinValues[attributeIndex ] = value;
-          if ( value > mCacheMaxValues[ attributeIndex ].toDate() || !mCacheMaxValues[ attributeIndex ].isValid() )
-            mCacheMaxValues[ attributeIndex ] = value;
-          break;
-        }
-        case QVariant::Time:
-        {
-          QTime value = varValue.toTime();
-          if ( value < mCacheMinValues[ attributeIndex ].toTime() || !mCacheMinValues[ attributeIndex ].isValid() )
-            mCacheMinValues[attributeIndex ] = value;
-          if ( value > mCacheMaxValues[ attributeIndex ].toTime() || !mCacheMaxValues[ attributeIndex ].isValid() )
-            mCacheMaxValues[ attributeIndex ] = value;
+          const double *values = batch.doubleData( column );
+          double minimum = mCacheMinValues[ attributeIndex ].toDouble();
+          double maximum = mCacheMaxValues[ attributeIndex ].toDouble();
+          for ( int row = 0; row < batch.size(); ++row )
+          {
+            if ( batch.isNull( column, row ) )
+              continue;
+            minimum = std::min( minimum, values[row] );
+            maximum = std::max( maximum, values[row] );
+          }
+          mCacheMinValues[ attributeIndex ] = minimum;
+          mCacheMaxValues[ attributeIndex ] = maximum;
           break;
         }
         default:
         {
-          QString value = varValue.toString();
-          if ( mCacheMinValues[ attributeIndex ].isNull() || value < mCacheMinValues[attributeIndex ].toString() )
-          {
-            mCacheMinValues[attributeIndex] = value;
-          }
-          if ( mCacheMaxValues[attributeIndex].isNull() || value > mCacheMaxValues[attributeIndex].toString() )
+          for ( int row = 0; row < batch.size(); ++row )
           {
-            mCacheMaxValues[attributeIndex] = value;
+            const QVariant varValue = batch.value( column, row );
+            if ( varValue.isNull() )
+              continue;
+
+            switch ( flds.at( attributeIndex ).type() )
+            {
+              case QVariant::DateTime:
+              {
+                QDateTime value = varValue.toDateTime();
+                if ( value < mCacheMinValues[ attributeIndex ].toDateTime() || !mCacheMinValues[ attributeIndex ].isValid() )
+                  mCacheMinValues[attributeIndex ] = value;
+                if ( value > mCacheMaxValues[ attributeIndex ].toDateTime() || !mCacheMaxValues[ attributeIndex ].isValid() )
+                  mCacheMaxValues[ attributeIndex ] = value;
+                break;
+              }
+              case QVariant::Date:
+              {
+                QDate value = varValue.toDate();
+                if ( value < mCacheMinValues[ attributeIndex ].toDate() || !mCacheMinValues[ attributeIndex ].isValid() )
+                  mCacheMinValues[attributeIndex ] = value;
+                if ( value > mCacheMaxValues[ attributeIndex ].toDate() || !mCacheMaxValues[ attributeIndex ].isValid() )
+                  mCacheMaxValues[ attributeIndex ] = value;
+                break;
+              }
+              case QVariant::Time:
+              {
+                QTime value = varValue.toTime();
+                if ( value < mCacheMinValues[ attributeIndex ].toTime() || !mCacheMinValues[ attributeIndex ].isValid() )
+                  mCacheMinValues[attributeIndex ] = value;
+                if ( value > mCacheMaxValues[ attributeIndex ].toTime() || !mCacheMaxValues[ attributeIndex ].isValid() )
+                  mCacheMaxValues[ attributeIndex ] = value;
+                break;
+              }
+              default:
+              {
+                QString value = varValue.toString();
+                if ( mCacheMinValues[ attributeIndex ].isNull() || value < mCacheMinValues[attributeIndex ].toString() )
+                {
+                  mCacheMinValues[attributeIndex] = value;
+                }
+                if ( mCacheMaxValues[attributeIndex].isNull() || value > mCacheMaxValues[attributeIndex].toString() )
+                {
+                  mCacheMaxValues[attributeIndex] = value;
+                }
+                break;
+              }
+            }
           }
           break;
         }
@@ -1497,6 +1497,15 @@ QgsFeatureSource::SpatialIndexPresence QgsVectorLayer::hasSpatialIndex() const
   return mDataProvider ? mDataProvider->hasSpatialIndex() : QgsFeatureSource::SpatialIndexUnknown;
 }
 
+QList<QgsFeatureRequest> QgsVectorLayer::partitionRequest( const QgsFeatureRequest &request, int count ) const
+{
+  // the provider doesn't know about the edit buffer
+  if ( !mDataProvider || mEditBuffer )
+    return QgsFeatureSource::partitionRequest( request, count );
+
+  return mDataProvider->partitionRequest( request, count );
+}
+
 bool QgsVectorLayer::accept( QgsStyleEntityVisitorInterface *visitor ) const
 {
   if ( mRenderer )
@@ -2470,6 +2470,15 @@ class CORE_EXPORT QgsVectorLayer : public QgsMapLayer, public QgsExpressionConte
 
     SpatialIndexPresence hasSpatialIndex() const override;
 
+    /**
+     * Splits a feature \a request into at most \a count requests which return disjoint sets of features.
+     *
+     * The request is split by the data provider, unless the layer is in edit mode.
+     *
+     * \since QGIS 3.18
+     */
+    QList< QgsFeatureRequest > partitionRequest( const QgsFeatureRequest &request, int count ) const override;
+
     bool accept( QgsStyleEntityVisitorInterface *visitor ) const override;
 
   signals:
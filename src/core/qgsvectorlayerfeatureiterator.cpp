@@ -14,6 +14,7 @@
  ***************************************************************************/
 #include "qgsvectorlayerfeatureiterator.h"
 
+#include "qgsfeaturebatch.h"
 #include "qgsexpressionfieldbuffer.h"
 #include "qgsgeometrysimplifier.h"
 #include "qgssimplifymethod.h"
@@ -483,6 +484,31 @@ bool QgsVectorLayerFeatureIterator::fetchFeature( QgsFeature &f )
 
 
 
+bool QgsVectorLayerFeatureIterator::fetchBatch( QgsFeatureBatch &batch, int maxFeatures )
+{
+  if ( mClosed )
+    return false;
+
+  // the provider iterator clears the batch, so it can only be used to fill a new batch
+  if ( !batch.isEmpty() || mSource->mHasEditBuffer || mHasVirtualAttributes || mTransform.isValid()
+       || mRequest.invalidGeometryCheck() != QgsFeatureRequest::GeometryNoCheck )
+    return QgsAbstractFeatureIterator::fetchBatch( batch, maxFeatures );
+
+  if ( mProviderIterator.isClosed() )
+  {
+    mChangedFeaturesIterator.close();
+    mProviderIterator = mSource->mProviderFeatureSource->getFeatures( mProviderRequest );
+    mProviderIterator.setInterruptionChecker( mInterruptionChecker );
+  }
+
+  if ( !mProviderIterator.nextBatch( batch, maxFeatures ) )
+  {
+    close();
+    return false;
+  }
+  return true;
+}
+
 bool QgsVectorLayerFeatureIterator::rewind()
 {
   if ( mClosed )
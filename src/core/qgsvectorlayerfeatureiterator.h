@@ -156,6 +156,13 @@ class CORE_EXPORT QgsVectorLayerFeatureIterator : public QgsAbstractFeatureItera
     //! fetch next feature, return TRUE on success
     bool fetchFeature( QgsFeature &feature ) override;
 
+    /**
+     * Passes the batch request on to the provider iterator when the provider features are
+     * returned unchanged, i.e. without edit buffer, joined or virtual fields, reprojection
+     * or geometry validity checks.
+     */
+    bool fetchBatch( QgsFeatureBatch &batch, int maxFeatures ) override SIP_SKIP;
+
     /**
      * Overrides default method as we only need to filter features in the edit buffer
      * while for others filtering is left to the provider implementation.
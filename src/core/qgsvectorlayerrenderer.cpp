@@ -40,6 +40,7 @@
 #include "qgsrenderedfeaturehandlerinterface.h"
 #include "qgsvectorlayertemporalproperties.h"
 #include "qgsmapclippingutils.h"
+#include "qgsrenderarena.h"
 
 #include <QPicture>
 
@@ -343,6 +344,9 @@ bool QgsVectorLayerRenderer::render()
     mRenderer->paintEffect()->end( context );
   }
 
+  // release the temporary buffers of the frame
+  context.renderArena().reset();
+
   mInterruptionChecker.reset();
   return true;
 }
@@ -26,6 +26,8 @@
 #include <QImage>
 #include <QSet>
 
+#include <algorithm>
+
 QgsMultiBandColorRenderer::QgsMultiBandColorRenderer( QgsRasterInterface *input, int redBand, int greenBand, int blueBand,
     QgsContrastEnhancement *redEnhancement,
     QgsContrastEnhancement *greenEnhancement,
@@ -262,118 +264,103 @@ QgsRasterBlock *QgsMultiBandColorRenderer::block( int bandNo, QgsRectangle  cons
       fastDraw = false;
   }
 
-  qgssize count = ( qgssize )width * height;
-  for ( qgssize i = 0; i < count; i++ )
+  // values are read a row at a time, to resolve the data types once per row
+  QVector< double > redValues( width );
+  QVector< double > greenValues( width );
+  QVector< double > blueValues( width );
+  QVector< bool > redIsNoData( width, false );
+  QVector< bool > greenIsNoData( width, false );
+  QVector< bool > blueIsNoData( width, false );
+
+  // 8-bit bands without no data are drawn straight from their data
+  const bool byteRgbWithoutNoData = fastDraw && hasByteRgb && !redBlock->hasNoData() && !greenBlock->hasNoData() && !blueBlock->hasNoData();
+
+  qgssize i = 0;
+  for ( int row = 0; row < height; ++row )
   {
-    if ( fastDraw ) //fast rendering if no transparency, stretching, color inversion, etc.
+    const qgssize rowStart = static_cast< qgssize >( row ) * width;
+    if ( byteRgbWithoutNoData )
     {
-      if ( hasByteRgb )
+      for ( int column = 0; column < width; ++column, ++i )
       {
-        if ( redBlock->isNoData( i ) ||
-             greenBlock->isNoData( i ) ||
-             blueBlock->isNoData( i ) )
-        {
-          outputBlock->setColor( i, myDefaultColor );
-        }
-        else
-        {
-          outputBlockColorData[i] = qRgb( redData[i], greenData[i], blueData[i] );
-        }
-      }
-      else
-      {
-        bool redIsNoData = false;
-        bool greenIsNoData = false;
-        bool blueIsNoData = false;
-        int redVal = 0;
-        int greenVal = 0;
-        int blueVal = 0;
-
-        redVal = redBlock->valueAndNoData( i, redIsNoData );
-        // as soon as any channel has a no data value, don't do any more work -- the result will
-        // always be the nodata color!
-        if ( !redIsNoData )
-          greenVal = greenBlock->valueAndNoData( i, greenIsNoData );
-        if ( !redIsNoData && !greenIsNoData )
-          blueVal = blueBlock->valueAndNoData( i, blueIsNoData );
-
-        if ( redIsNoData ||
-             greenIsNoData ||
-             blueIsNoData )
-        {
-          outputBlock->setColor( i, myDefaultColor );
-        }
-        else
-        {
-          outputBlockColorData[i] = qRgb( redVal, greenVal, blueVal );
-        }
+        outputBlockColorData[i] = qRgb( redData[i], greenData[i], blueData[i] );
       }
       continue;
     }
 
-    bool isNoData = false;
-    double redVal = 0;
-    double greenVal = 0;
-    double blueVal = 0;
-    if ( mRedBand > 0 )
+    const bool rowRead = ( !redBlock || redBlock->readValues( rowStart, width, redValues.data(), redIsNoData.data() ) )
+                         && ( !greenBlock || greenBlock->readValues( rowStart, width, greenValues.data(), greenIsNoData.data() ) )
+                         && ( !blueBlock || blueBlock->readValues( rowStart, width, blueValues.data(), blueIsNoData.data() ) );
+    if ( !rowRead )
     {
-      redVal = redBlock->valueAndNoData( i, isNoData );
-    }
-    if ( !isNoData && mGreenBand > 0 )
-    {
-      greenVal = greenBlock->valueAndNoData( i, isNoData );
-    }
-    if ( !isNoData && mBlueBand > 0 )
-    {
-      blueVal = blueBlock->valueAndNoData( i, isNoData );
-    }
-    if ( isNoData )
-    {
-      outputBlock->setColor( i, myDefaultColor );
+      std::fill( outputBlockColorData + rowStart, outputBlockColorData + rowStart + width, myDefaultColor );
+      i += width;
       continue;
     }
 
-    //apply default color if red, green or blue not in displayable range
-    if ( ( mRedContrastEnhancement && !mRedContrastEnhancement->isValueInDisplayableRange( redVal ) )
-         || ( mGreenContrastEnhancement && !mGreenContrastEnhancement->isValueInDisplayableRange( redVal ) )
-         || ( mBlueContrastEnhancement && !mBlueContrastEnhancement->isValueInDisplayableRange( redVal ) ) )
+    for ( int column = 0; column < width; ++column, ++i )
     {
-      outputBlock->setColor( i, myDefaultColor );
-      continue;
-    }
+      if ( redIsNoData.at( column ) || greenIsNoData.at( column ) || blueIsNoData.at( column ) )
+      {
+        outputBlockColorData[i] = myDefaultColor;
+        continue;
+      }
 
-    //stretch color values
-    if ( mRedContrastEnhancement )
-    {
-      redVal = mRedContrastEnhancement->enhanceContrast( redVal );
-    }
-    if ( mGreenContrastEnhancement )
-    {
-      greenVal = mGreenContrastEnhancement->enhanceContrast( greenVal );
-    }
-    if ( mBlueContrastEnhancement )
-    {
-      blueVal = mBlueContrastEnhancement->enhanceContrast( blueVal );
-    }
+      if ( fastDraw ) //fast rendering if no transparency, stretching, color inversion, etc.
+      {
+        outputBlockColorData[i] = qRgb( static_cast< int >( redValues.at( column ) ),
+                                        static_cast< int >( greenValues.at( column ) ),
+                                        static_cast< int >( blueValues.at( column ) ) );
+        continue;
+      }
 
-    //opacity
-    double currentOpacity = mOpacity;
-    if ( mRasterTransparency )
-    {
-      currentOpacity = mRasterTransparency->alphaValue( redVal, greenVal, blueVal, mOpacity * 255 ) / 255.0;
-    }
-    if ( mAlphaBand > 0 )
-    {
-      currentOpacity *= alphaBlock->value( i ) / 255.0;
-    }
+      // bands which are not set have a 0 value
+      double redVal = redValues.at( column );
+      double greenVal = greenValues.at( column );
+      double blueVal = blueValues.at( column );
 
-    if ( qgsDoubleNear( currentOpacity, 1.0 ) )
-    {
-      outputBlock->setColor( i, qRgba( redVal, greenVal, blueVal, 255 ) );
-    }
-    else
-    {
-      outputBlock->setColor( i, qRgba( currentOpacity * redVal, currentOpacity * greenVal, currentOpacity * blueVal, currentOpacity * 255 ) );
+      //apply default color if red, green or blue not in displayable range
+      if ( ( mRedContrastEnhancement && !mRedContrastEnhancement->isValueInDisplayableRange( redVal ) )
+           || ( mGreenContrastEnhancement && !mGreenContrastEnhancement->isValueInDisplayableRange( redVal ) )
+           || ( mBlueContrastEnhancement && !mBlueContrastEnhancement->isValueInDisplayableRange( redVal ) ) )
+      {
+        outputBlockColorData[i] = myDefaultColor;
+        continue;
+      }
+
+      //stretch color values
+      if ( mRedContrastEnhancement )
+      {
+        redVal = mRedContrastEnhancement->enhanceContrast( redVal );
+      }
+      if ( mGreenContrastEnhancement )
+      {
+        greenVal = mGreenContrastEnhancement->enhanceContrast( greenVal );
+      }
+      if ( mBlueContrastEnhancement )
+      {
+        blueVal = mBlueContrastEnhancement->enhanceContrast( blueVal );
+      }
+
+      //opacity
+      double currentOpacity = mOpacity;
+      if ( mRasterTransparency )
+      {
+        currentOpacity = mRasterTransparency->alphaValue( redVal, greenVal, blueVal, mOpacity * 255 ) / 255.0;
+      }
+      if ( mAlphaBand > 0 )
+      {
+        currentOpacity *= alphaBlock->value( i ) / 255.0;
+      }
+
+      if ( qgsDoubleNear( currentOpacity, 1.0 ) )
+      {
+        outputBlockColorData[i] = qRgba( redVal, greenVal, blueVal, 255 );
+      }
+      else
+      {
+        outputBlockColorData[i] = qRgba( currentOpacity * redVal, currentOpacity * greenVal, currentOpacity * blueVal, currentOpacity * 255 );
+      }
     }
   }
 
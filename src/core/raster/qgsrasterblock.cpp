@@ -23,6 +23,9 @@
 #include "qgslogger.h"
 #include "qgsrasterblock.h"
 #include "qgsrectangle.h"
+#include "qgssimdkernels_p.h"
+
+#include <algorithm>
 
 // See #9101 before any change of NODATA_COLOR!
 const QRgb QgsRasterBlock::NO_DATA_COLOR = qRgba( 0, 0, 0, 0 );
@@ -231,6 +234,59 @@ void QgsRasterBlock::resetNoDataValue()
   mNoDataValue = std::numeric_limits<double>::quiet_NaN();
 }
 
+///@cond PRIVATE
+struct QgsRasterBlockToDouble
+{
+  template <typename T> void operator()( const T *data, qgssize )
+  {
+    const T *source = data + index;
+    for ( qgssize i = 0; i < count; ++i )
+      values[i] = static_cast< double >( source[i] );
+  }
+
+  qgssize index;
+  qgssize count;
+  double *values;
+};
+///@endcond
+
+bool QgsRasterBlock::readValues( qgssize index, qgssize count, double *values, bool *isNoData ) const
+{
+  if ( !mData || index + count > static_cast< qgssize >( mWidth ) * mHeight )
+    return false;
+
+  QgsRasterBlockToDouble toDouble { index, count, values };
+  if ( !visitData( toDouble ) )
+    return false;
+
+  if ( !isNoData )
+    return true;
+
+  if ( mHasNoDataValue )
+  {
+    QgsSimdKernels::noDataMask( values, count, mNoDataValue, isNoData );
+  }
+  else if ( mNoDataBitmap )
+  {
+    int row = static_cast< int >( index / mWidth );
+    int column = static_cast< int >( index % mWidth );
+    for ( qgssize i = 0; i < count; ++i )
+    {
+      isNoData[i] = mNoDataBitmap[ static_cast< qgssize >( row ) * mNoDataBitmapWidth + column / 8 ] & ( 0x80 >> ( column % 8 ) );
+      if ( ++column == mWidth )
+      {
+        column = 0;
+        row++;
+      }
+    }
+  }
+  else
+  {
+    std::fill( isNoData, isNoData + count, false );
+  }
+  return true;
+}
+
 bool QgsRasterBlock::setIsNoData()
 {
   QgsDebugMsgLevel( QStringLiteral( "Entered" ), 4 );
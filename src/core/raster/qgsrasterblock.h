@@ -237,6 +237,64 @@ class CORE_EXPORT QgsRasterBlock
      */
     inline double valueAndNoData( qgssize index, bool &isNoData ) const SIP_SKIP;
 
+    /**
+     * Reads the values of \a count consecutive pixels starting at the specified \a index into \a values,
+     * and sets the matching entries of \a isNoData to TRUE for the pixels which represent no data.
+     *
+     * This gives the same results as calling valueAndNoData() for each pixel, but the data type of the
+     * block is only resolved once for all the pixels, which is much faster for whole rows or blocks.
+     *
+     * \a isNoData may be NULLPTR if the no data state of the pixels is not needed.
+     *
+     * \returns FALSE if the block data is not allocated, its data type is not numeric,
+     * or the pixels are outside of the block
+     *
+     * \see visitData()
+     * \note not available in Python bindings
+     * \since QGIS 3.18
+     */
+    bool readValues( qgssize index, qgssize count, double *values, bool *isNoData = nullptr ) const SIP_SKIP;
+
+#ifndef SIP_RUN
+
+    /**
+     * Calls \a visitor with the block data, as a pointer to the C++ type matching the data type of the block,
+     * and the number of pixels in the block.
+     *
+     * The visitor must have a call operator template, which is instantiated for each numeric data type:
+     *
+     * \code{.cpp}
+     * struct SumVisitor
+     * {
+     *   template <typename T> void operator()( const T *data, qgssize count )
+     *   {
+     *     for ( qgssize i = 0; i < count; ++i )
+     *       sum += data[i];
+     *   }
+     *   double sum = 0;
+     * };
+     * \endcode
+     *
+     * The per pixel loops of the visitor are compiled for each data type, which avoids the
+     * data type switch of value() for every pixel.
+     *
+     * \returns FALSE if the block data is not allocated or its data type is not numeric
+     * \note not available in Python bindings
+     * \since QGIS 3.18
+     */
+    template <typename Visitor> bool visitData( Visitor &visitor ) const;
+
+    /**
+     * Calls \a visitor with a writable pointer to the block data, of the C++ type matching the data type of the block,
+     * and the number of pixels in the block.
+     *
+     * \see visitData()
+     * \note not available in Python bindings
+     * \since QGIS 3.18
+     */
+    template <typename Visitor> bool visitData( Visitor &visitor );
+#endif
+
     /**
      * Gives direct access to the raster block data.
      * The data type of the block must be Qgis::Byte otherwise it returns NULLPTR.
@@ -857,6 +915,78 @@ inline bool QgsRasterBlock::isNoDataValue( double value ) const SIP_SKIP
   return std::isnan( value ) || qgsDoubleNear( value, mNoDataValue );
 }
 
+#ifndef SIP_RUN
+template <typename Visitor>
+bool QgsRasterBlock::visitData( Visitor &visitor ) const
+{
+  if ( !mData )
+    return false;
+
+  const qgssize count = static_cast< qgssize >( mWidth ) * mHeight;
+  switch ( mDataType )
+  {
+    case Qgis::Byte:
+      visitor( static_cast< const quint8 * >( mData ), count );
+      return true;
+    case Qgis::UInt16:
+      visitor( static_cast< const quint16 * >( mData ), count );
+      return true;
+    case Qgis::Int16:
+      visitor( static_cast< const qint16 * >( mData ), count );
+      return true;
+    case Qgis::UInt32:
+      visitor( static_cast< const quint32 * >( mData ), count );
+      return true;
+    case Qgis::Int32:
+      visitor( static_cast< const qint32 * >( mData ), count );
+      return true;
+    case Qgis::Float32:
+      visitor( static_cast< const float * >( mData ), count );
+      return true;
+    case Qgis::Float64:
+      visitor( static_cast< const double * >( mData ), count );
+      return true;
+    default:
+      return false;
+  }
+}
+
+template <typename Visitor>
+bool QgsRasterBlock::visitData( Visitor &visitor )
+{
+  if ( !mData )
+    return false;
+
+  const qgssize count = static_cast< qgssize >( mWidth ) * mHeight;
+  switch ( mDataType )
+  {
+    case Qgis::Byte:
+      visitor( static_cast< quint8 * >( mData ), count );
+      return true;
+    case Qgis::UInt16:
+      visitor( static_cast< quint16 * >( mData ), count );
+      return true;
+    case Qgis::Int16:
+      visitor( static_cast< qint16 * >( mData ), count );
+      return true;
+    case Qgis::UInt32:
+      visitor( static_cast< quint32 * >( mData ), count );
+      return true;
+    case Qgis::Int32:
+      visitor( static_cast< qint32 * >( mData ), count );
+      return true;
+    case Qgis::Float32:
+      visitor( static_cast< float * >( mData ), count );
+      return true;
+    case Qgis::Float64:
+      visitor( static_cast< double * >( mData ), count );
+      return true;
+    default:
+      return false;
+  }
+}
+#endif
+
 #endif
 
 
@@ -25,6 +25,7 @@
 #include "qgsrendercontext.h"
 #include <QImage>
 #include <QPainter>
+#include <QtConcurrentMap>
 #ifndef QT_NO_PRINTER
 #include <QPrinter>
 #endif
@@ -33,6 +34,25 @@ QgsRasterDrawer::QgsRasterDrawer( QgsRasterIterator *iterator ): mIterator( iter
 {
 }
 
+// Because of bug in Acrobat Reader we must use "white" transparent color instead
+// of "black" for PDF. See #9101.
+static void replaceTransparentBlackForPdf( QImage &img )
+{
+  img = img.convertToFormat( QImage::Format_ARGB32 );
+  QRgb transparentBlack = qRgba( 0, 0, 0, 0 );
+  QRgb transparentWhite = qRgba( 255, 255, 255, 0 );
+  for ( int x = 0; x < img.width(); x++ )
+  {
+    for ( int y = 0; y < img.height(); y++ )
+    {
+      if ( img.pixel( x, y ) == transparentBlack )
+      {
+        img.setPixel( x, y, transparentWhite );
+      }
+    }
+  }
+}
+
 void QgsRasterDrawer::draw( QPainter *p, QgsRasterViewPort *viewPort, const QgsMapToPixel *qgsMapToPixel, QgsRasterBlockFeedback *feedback )
 {
   QgsDebugMsgLevel( QStringLiteral( "Entered" ), 4 );
@@ -45,6 +65,18 @@ void QgsRasterDrawer::draw( QPainter *p, QgsRasterViewPort *viewPort, const QgsM
   int bandNumber = 1;
   mIterator->startRasterRead( bandNumber, viewPort->mWidth, viewPort->mHeight, viewPort->mDrawnExtent, feedback );
 
+  bool pdfOutput = false;
+#ifndef QT_NO_PRINTER
+  QPrinter *printer = dynamic_cast<QPrinter *>( p->device() );
+  pdfOutput = printer && printer->outputFormat() == QPrinter::PdfFormat;
+#endif
+
+  if ( mMaximumThreadCount > 1 && !( feedback && feedback->renderPartialOutput() ) )
+  {
+    drawParallel( p, viewPort, qgsMapToPixel, feedback, pdfOutput );
+    return;
+  }
+
   //number of cols/rows in output pixels
   int nCols = 0;
   int nRows = 0;
@@ -68,29 +100,11 @@ void QgsRasterDrawer::draw( QPainter *p, QgsRasterViewPort *viewPort, const QgsM
 
     QImage img = block->image();
 
-#ifndef QT_NO_PRINTER
-    // Because of bug in Acrobat Reader we must use "white" transparent color instead
-    // of "black" for PDF. See #9101.
-    QPrinter *printer = dynamic_cast<QPrinter *>( p->device() );
-    if ( printer && printer->outputFormat() == QPrinter::PdfFormat )
+    if ( pdfOutput )
     {
       QgsDebugMsgLevel( QStringLiteral( "PdfFormat" ), 4 );
-
-      img = img.convertToFormat( QImage::Format_ARGB32 );
-      QRgb transparentBlack = qRgba( 0, 0, 0, 0 );
-      QRgb transparentWhite = qRgba( 255, 255, 255, 0 );
-      for ( int x = 0; x < img.width(); x++ )
-      {
-        for ( int y = 0; y < img.height(); y++ )
-        {
-          if ( img.pixel( x, y ) == transparentBlack )
-          {
-            img.setPixel( x, y, transparentWhite );
-          }
-        }
-      }
+      replaceTransparentBlackForPdf( img );
     }
-#endif
 
     if ( feedback && feedback->renderPartialOutput() )
     {
@@ -115,6 +129,117 @@ void QgsRasterDrawer::draw( QPainter *p, QgsRasterViewPort *viewPort, const QgsM
   }
 }
 
+///@cond PRIVATE
+struct QgsRasterDrawerPart
+{
+  int nCols = 0;
+  int nRows = 0;
+  int topLeftCol = 0;
+  int topLeftRow = 0;
+  QgsRectangle extent;
+  QImage image;
+};
+
+/**
+ * Renders parts of the raster through its own copy of the interfaces of the pipe.
+ */
+struct QgsRasterDrawerWorker
+{
+  //! Copies of the interfaces, from the first one to the last one
+  std::vector< std::unique_ptr< QgsRasterInterface > > interfaces;
+  //! Per worker feedback, as errors cannot be appended concurrently to the drawer feedback
+  std::unique_ptr< QgsRasterBlockFeedback > feedback;
+};
+///@endcond
+
+void QgsRasterDrawer::drawParallel( QPainter *p, QgsRasterViewPort *viewPort, const QgsMapToPixel *qgsMapToPixel, QgsRasterBlockFeedback *feedback, bool pdfOutput )
+{
+  int bandNumber = 1;
+
+  std::vector< QgsRasterDrawerPart > parts;
+  QgsRasterDrawerPart nextRasterPart;
+  while ( mIterator->next( bandNumber, nextRasterPart.nCols, nextRasterPart.nRows, nextRasterPart.topLeftCol, nextRasterPart.topLeftRow, nextRasterPart.extent ) )
+    parts.emplace_back( nextRasterPart );
+
+  if ( parts.empty() )
+    return;
+
+  // each worker gets a copy of the chain of interfaces feeding the iterator (the interfaces
+  // switched off in the pipe are not part of this chain), linked from the first one like
+  // in the QgsRasterPipe copy constructor
+  std::vector< const QgsRasterInterface * > chain;
+  for ( const QgsRasterInterface *interface = mIterator->input(); interface; interface = interface->input() )
+    chain.insert( chain.begin(), interface );
+
+  const int workerCount = std::min( mMaximumThreadCount, static_cast< int >( parts.size() ) );
+  std::vector< std::unique_ptr< QgsRasterDrawerWorker > > workers;
+  for ( int i = 0; i < workerCount; ++i )
+  {
+    std::unique_ptr< QgsRasterDrawerWorker > worker = qgis::make_unique< QgsRasterDrawerWorker >();
+    for ( const QgsRasterInterface *interface : chain )
+    {
+      QgsRasterInterface *clone = interface->clone();
+      if ( !worker->interfaces.empty() )
+        clone->setInput( worker->interfaces.back().get() );
+      worker->interfaces.emplace_back( clone );
+    }
+
+    worker->feedback = qgis::make_unique< QgsRasterBlockFeedback >();
+    if ( feedback )
+    {
+      worker->feedback->setPreviewOnly( feedback->isPreviewOnly() );
+      if ( feedback->isCanceled() )
+        worker->feedback->cancel();
+      else
+        QObject::connect( feedback, &QgsFeedback::canceled, worker->feedback.get(), &QgsFeedback::cancel, Qt::DirectConnection );
+    }
+    workers.emplace_back( std::move( worker ) );
+  }
+
+  QAtomicInt nextPart;
+  auto renderParts = [ &parts, &nextPart, bandNumber, pdfOutput ]( std::unique_ptr< QgsRasterDrawerWorker > &worker )
+  {
+    QgsRasterInterface *input = worker->interfaces.back().get();
+    for ( int i = nextPart.fetchAndAddOrdered( 1 ); i < static_cast< int >( parts.size() ); i = nextPart.fetchAndAddOrdered( 1 ) )
+    {
+      if ( worker->feedback->isCanceled() )
+        return;
+
+      QgsRasterDrawerPart &part = parts[ i ];
+      std::unique_ptr< QgsRasterBlock > block( input->block( bandNumber, part.extent, part.nCols, part.nRows, worker->feedback.get() ) );
+      if ( !block )
+      {
+        QgsDebugMsg( QStringLiteral( "Cannot get block" ) );
+        continue;
+      }
+
+      part.image = block->image();
+      if ( pdfOutput )
+        replaceTransparentBlackForPdf( part.image );
+    }
+  };
+  QtConcurrent::blockingMap( workers, renderParts );
+
+  for ( const std::unique_ptr< QgsRasterDrawerWorker > &worker : workers )
+  {
+    if ( feedback )
+    {
+      const QStringList errors = worker->feedback->errors();
+      for ( const QString &error : errors )
+        feedback->appendError( error );
+    }
+  }
+
+  if ( feedback && feedback->isCanceled() )
+    return;
+
+  for ( const QgsRasterDrawerPart &part : parts )
+  {
+    if ( !part.image.isNull() )
+      drawImage( p, viewPort, part.image, part.topLeftCol, part.topLeftRow, qgsMapToPixel );
+  }
+}
+
 void QgsRasterDrawer::drawImage( QPainter *p, QgsRasterViewPort *viewPort, const QImage &img, int topLeftCol, int topLeftRow, const QgsMapToPixel *qgsMapToPixel ) const
 {
   if ( !p || !viewPort )
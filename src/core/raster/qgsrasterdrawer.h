@@ -48,6 +48,31 @@ class CORE_EXPORT QgsRasterDrawer
      */
     void draw( QPainter *p, QgsRasterViewPort *viewPort, const QgsMapToPixel *qgsMapToPixel, QgsRasterBlockFeedback *feedback = nullptr );
 
+    /**
+     * Sets the maximum number of threads used to render the parts of the raster.
+     *
+     * With more than one thread, the parts returned by the iterator are rendered concurrently
+     * in the global thread pool, each thread going through its own copy of the interfaces
+     * feeding the iterator. The rendered parts are then drawn by the calling thread.
+     *
+     * The parts are always rendered sequentially when the feedback asks for partial output,
+     * as previews are drawn by the interfaces while the parts are being rendered.
+     *
+     * The default is 1.
+     *
+     * \see maximumThreadCount()
+     * \since QGIS 3.18
+     */
+    void setMaximumThreadCount( int count ) { mMaximumThreadCount = count; }
+
+    /**
+     * Returns the maximum number of threads used to render the parts of the raster.
+     *
+     * \see setMaximumThreadCount()
+     * \since QGIS 3.18
+     */
+    int maximumThreadCount() const { return mMaximumThreadCount; }
+
   protected:
 
     /**
@@ -64,6 +89,10 @@ class CORE_EXPORT QgsRasterDrawer
 
   private:
     QgsRasterIterator *mIterator = nullptr;
+    int mMaximumThreadCount = 1;
+
+    //! Renders the parts of the raster concurrently and draws them
+    void drawParallel( QPainter *p, QgsRasterViewPort *viewPort, const QgsMapToPixel *qgsMapToPixel, QgsRasterBlockFeedback *feedback, bool pdfOutput );
 };
 
 #endif // QGSRASTERDRAWER_H
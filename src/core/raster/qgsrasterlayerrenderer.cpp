@@ -27,6 +27,11 @@
 #include "qgsrasterlayertemporalproperties.h"
 #include "qgsmapclippingutils.h"
 
+#include <QThreadPool>
+
+// Minimum height of the parts of the view port rendered in parallel, in pixels
+const int MINIMUM_PARALLEL_PART_HEIGHT = 256;
+
 ///@cond PRIVATE
 
 QgsRasterLayerRendererFeedback::QgsRasterLayerRendererFeedback( QgsRasterLayerRenderer *r )
@@ -316,6 +321,19 @@ bool QgsRasterLayerRenderer::render()
   // Drawer to pipe?
   QgsRasterIterator iterator( mPipe->last() );
   QgsRasterDrawer drawer( &iterator );
+  if ( ( mPipe->provider()->providerCapabilities() & QgsRasterDataProvider::ProviderHintCanReadConcurrently ) &&
+       !renderContext()->testFlag( QgsRenderContext::RenderPartialOutput ) )
+  {
+    const int threadCount = QThreadPool::globalInstance()->maxThreadCount();
+    if ( threadCount > 1 )
+    {
+      drawer.setMaximumThreadCount( threadCount );
+      // split the view port in enough parts to keep all the threads busy, but not in parts
+      // so small that the per part overhead of the pipe would dominate
+      const int partHeight = std::max( MINIMUM_PARALLEL_PART_HEIGHT, static_cast< int >( std::ceil( mRasterViewPort->mHeight / static_cast< double >( threadCount ) ) ) );
+      iterator.setMaximumTileHeight( std::min( iterator.maximumTileHeight(), partHeight ) );
+    }
+  }
   drawer.draw( renderContext()->painter(), mRasterViewPort, &renderContext()->mapToPixel(), mFeedback );
 
   if ( restoreOldResamplingStage )
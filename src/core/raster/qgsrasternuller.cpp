@@ -18,6 +18,9 @@
 #include "qgsrasterdataprovider.h"
 #include "qgsrasternuller.h"
 
+#include <algorithm>
+#include <cstring>
+
 QgsRasterNuller::QgsRasterNuller( QgsRasterInterface *input )
   : QgsRasterInterface( input )
 {
@@ -100,25 +103,33 @@ QgsRasterBlock *QgsRasterNuller::block( int bandNo, QgsRectangle  const &extent,
     outputBlock->setNoDataValue( noDataValue );
   }
 
-  bool isNoData = false;
+  // the values are copied as a whole, only the no data pixels are then set one by one
+  const qgssize count = std::min( static_cast< qgssize >( width ) * height, static_cast< qgssize >( inputBlock->width() ) * inputBlock->height() );
+  if ( inputBlock->isEmpty() || !outputBlock->bits() )
+  {
+    outputBlock->setIsNoData();
+    return outputBlock.release();
+  }
+  memcpy( outputBlock->bits(), inputBlock->bits(), count * QgsRasterBlock::typeSize( inputBlock->dataType() ) );
+
+  const QgsRasterRangeList noDataRanges = mNoData.value( bandNo - 1 );
+  QVector< double > rowValues( width );
+  QVector< bool > rowIsNoData( width );
   for ( int i = 0; i < height; i++ )
   {
-    for ( int j = 0; j < width; j++ )
+    const qgssize rowStart = static_cast< qgssize >( i ) * width;
+    if ( rowStart + width > count || !inputBlock->readValues( rowStart, width, rowValues.data(), rowIsNoData.data() ) )
     {
-      double value = inputBlock->valueAndNoData( i, j, isNoData );
-
-      if ( QgsRasterRange::contains( value, mNoData.value( bandNo - 1 ) ) )
-      {
-        isNoData = true;
-      }
-      outputBlock->setValue( i, j, inputBlock->value( i, j ) );
-      if ( isNoData )
-      {
+      for ( int j = 0; j < width; j++ )
         outputBlock->setIsNoData( i, j );
-      }
-      else
+      continue;
+    }
+
+    for ( int j = 0; j < width; j++ )
+    {
+      if ( rowIsNoData.at( j ) || QgsRasterRange::contains( rowValues.at( j ), noDataRanges ) )
       {
-        outputBlock->setValue( i, j, value );
+        outputBlock->setIsNoData( rowStart + j );
       }
     }
   }
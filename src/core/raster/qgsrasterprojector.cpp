@@ -22,6 +22,10 @@
 #include "qgscoordinatetransform.h"
 #include "qgsexception.h"
 
+#include <QMutex>
+#include <list>
+#include <memory>
+
 Q_NOWARN_DEPRECATED_PUSH // because of deprecated members
 QgsRasterProjector::QgsRasterProjector()
   : QgsRasterInterface( nullptr )
@@ -114,28 +118,7 @@ ProjectorData::ProjectorData( const QgsRectangle &extent, int width, int height,
   QgsDebugMsgLevel( QStringLiteral( "Entered" ), 4 );
 
   // Get max source resolution and extent if possible
-  if ( input )
-  {
-    QgsRasterDataProvider *provider = dynamic_cast<QgsRasterDataProvider *>( input->sourceInput() );
-    if ( provider )
-    {
-      // If provider-side resampling is possible, we will get a much better looking
-      // result by not requesting at the maximum resolution and then doing nearest
-      // resampling here. A real fix would be to do resampling during reprojection
-      // however.
-      if ( !( provider->providerCapabilities() & QgsRasterDataProvider::ProviderHintCanPerformProviderResampling ) &&
-           ( provider->capabilities() & QgsRasterDataProvider::Size ) )
-      {
-        mMaxSrcXRes = provider->extent().width() / provider->xSize();
-        mMaxSrcYRes = provider->extent().height() / provider->ySize();
-      }
-      // Get source extent
-      if ( mExtent.isEmpty() )
-      {
-        mExtent = provider->extent();
-      }
-    }
-  }
+  sourceLimits( input, mExtent, mMaxSrcXRes, mMaxSrcYRes );
 
   mDestXRes = mDestExtent.width() / ( mDestCols );
   mDestYRes = mDestExtent.height() / ( mDestRows );
@@ -238,6 +221,29 @@ ProjectorData::~ProjectorData()
   delete[] pHelperBottom;
 }
 
+void ProjectorData::sourceLimits( QgsRasterInterface *input, QgsRectangle &extent, double &maxSrcXRes, double &maxSrcYRes )
+{
+  QgsRasterDataProvider *provider = input ? dynamic_cast<QgsRasterDataProvider *>( input->sourceInput() ) : nullptr;
+  if ( !provider )
+    return;
+
+  // If provider-side resampling is possible, we will get a much better looking
+  // result by not requesting at the maximum resolution and then doing nearest
+  // resampling here. A real fix would be to do resampling during reprojection
+  // however.
+  if ( !( provider->providerCapabilities() & QgsRasterDataProvider::ProviderHintCanPerformProviderResampling ) &&
+       ( provider->capabilities() & QgsRasterDataProvider::Size ) )
+  {
+    maxSrcXRes = provider->extent().width() / provider->xSize();
+    maxSrcYRes = provider->extent().height() / provider->ySize();
+  }
+  // Get source extent
+  if ( extent.isEmpty() )
+  {
+    extent = provider->extent();
+  }
+}
+
 
 void ProjectorData::calcSrcExtent()
 {
@@ -579,6 +585,88 @@ bool ProjectorData::approximateSrcRowCol( int destRow, int destCol, int *srcRow,
   return true;
 }
 
+inline qint32 ProjectorData::srcIndex( double x, double y ) const
+{
+  // written to give the same results as approximateSrcRowCol() / preciseSrcRowCol(),
+  // a NaN coordinate fails the comparisons and ends outside too
+  if ( !( mExtent.xMinimum() <= x && x <= mExtent.xMaximum() &&
+          mExtent.yMinimum() <= y && y <= mExtent.yMaximum() ) )
+    return -1;
+
+  const int srcRow = static_cast< int >( std::floor( ( mSrcExtent.yMaximum() - y ) / mSrcYRes ) );
+  const int srcCol = static_cast< int >( std::floor( ( x - mSrcExtent.xMinimum() ) / mSrcXRes ) );
+  if ( srcRow < 0 || srcRow >= mSrcRows || srcCol < 0 || srcCol >= mSrcCols )
+    return -1;
+
+  return srcRow * mSrcCols + srcCol;
+}
+
+void ProjectorData::srcIndexes( int destRow, qint32 *indexes )
+{
+  std::vector< double > x( static_cast< std::size_t >( mDestCols ) );
+  std::vector< double > y( static_cast< std::size_t >( mDestCols ) );
+  const double destY = mDestExtent.yMaximum() - ( destRow + 0.5 ) * mDestYRes;
+
+  if ( mApproximate )
+  {
+    if ( matrixRow( destRow ) > mHelperTopRow )
+    {
+      nextHelper();
+    }
+
+    // same interpolation as approximateSrcRowCol(), the factor only depends on the row
+    const int myMatrixRow = matrixRow( destRow );
+    double myDestX, myDestYMin, myDestYMax;
+    destPointOnCPMatrix( myMatrixRow + 1, 0, &myDestX, &myDestYMin );
+    destPointOnCPMatrix( myMatrixRow, 0, &myDestX, &myDestYMax );
+    const double yfrac = ( destY - myDestYMin ) / ( myDestYMax - myDestYMin );
+
+    const QgsPointXY *top = pHelperTop;
+    const QgsPointXY *bottom = pHelperBottom;
+    for ( int col = 0; col < mDestCols; ++col )
+    {
+      const double bx = bottom[col].x();
+      const double by = bottom[col].y();
+      x[col] = bx + ( top[col].x() - bx ) * yfrac;
+      y[col] = by + ( top[col].y() - by ) * yfrac;
+    }
+  }
+  else
+  {
+    for ( int col = 0; col < mDestCols; ++col )
+    {
+      x[col] = mDestExtent.xMinimum() + ( col + 0.5 ) * mDestXRes;
+      y[col] = destY;
+    }
+
+    if ( mInverseCt.isValid() )
+    {
+      std::vector< double > z( static_cast< std::size_t >( mDestCols ), 0.0 );
+      try
+      {
+        // transform the whole row at once, rather than pixel by pixel
+        mInverseCt.transformCoords( mDestCols, x.data(), y.data(), z.data() );
+      }
+      catch ( QgsCsException & )
+      {
+        // some of the points cannot be transformed, find out which ones
+        int srcRow = 0;
+        int srcCol = 0;
+        for ( int col = 0; col < mDestCols; ++col )
+        {
+          indexes[col] = preciseSrcRowCol( destRow, col, &srcRow, &srcCol ) ? srcRow * mSrcCols + srcCol : -1;
+        }
+        return;
+      }
+    }
+  }
+
+  for ( int col = 0; col < mDestCols; ++col )
+  {
+    indexes[col] = srcIndex( x[col], y[col] );
+  }
+}
+
 void ProjectorData::insertRows( const QgsCoordinateTransform &ct )
 {
   for ( int r = 0; r < mCPRows - 1; r++ )
@@ -758,6 +846,124 @@ bool ProjectorData::checkRows( const QgsCoordinateTransform &ct )
   return true;
 }
 
+/**
+ * Source pixel lookup grid of a reprojected block.
+ */
+struct QgsRasterProjectorGrid
+{
+  QgsRectangle srcExtent;
+  int srcRows = 0;
+  int srcCols = 0;
+
+  //! Source pixel index for each destination pixel, row by row, or -1 if outside of the source
+  std::vector< qint32 > srcIndexes;
+};
+
+/**
+ * Identifies the reprojection of a destination extent and size, i.e. all that a
+ * ProjectorData depends on.
+ */
+struct QgsRasterProjectorGridKey
+{
+  QgsCoordinateReferenceSystem srcCrs;
+  QgsCoordinateReferenceSystem destCrs;
+  QString coordinateOperation;
+  int srcDatumTransform = -1;
+  int destDatumTransform = -1;
+  QgsRasterProjector::Precision precision = QgsRasterProjector::Approximate;
+  QgsRectangle destExtent;
+  int destWidth = 0;
+  int destHeight = 0;
+  QgsRectangle sourceExtent;
+  double maxSrcXRes = 0;
+  double maxSrcYRes = 0;
+
+  bool operator==( const QgsRasterProjectorGridKey &other ) const
+  {
+    // cheapest comparisons first
+    return destWidth == other.destWidth && destHeight == other.destHeight &&
+           destExtent.xMinimum() == other.destExtent.xMinimum() && destExtent.xMaximum() == other.destExtent.xMaximum() &&
+           destExtent.yMinimum() == other.destExtent.yMinimum() && destExtent.yMaximum() == other.destExtent.yMaximum() &&
+           precision == other.precision &&
+           maxSrcXRes == other.maxSrcXRes && maxSrcYRes == other.maxSrcYRes &&
+           sourceExtent == other.sourceExtent &&
+           srcDatumTransform == other.srcDatumTransform && destDatumTransform == other.destDatumTransform &&
+           coordinateOperation == other.coordinateOperation &&
+           srcCrs == other.srcCrs && destCrs == other.destCrs;
+  }
+};
+
+/**
+ * Least recently used cache of the lookup grids, shared by all the projectors.
+ *
+ * Computing a grid transforms many points, while the same reprojections come back
+ * again and again when rendering tiles on a fixed grid or refreshing a map.
+ */
+class QgsRasterProjectorGridCache
+{
+  public:
+
+    //! Maximum memory used by the cached grids, in bytes
+    static const std::size_t MAXIMUM_SIZE = 64 * 1024 * 1024;
+
+    std::shared_ptr< const QgsRasterProjectorGrid > grid( const QgsRasterProjectorGridKey &key )
+    {
+      QMutexLocker locker( &mMutex );
+      for ( auto it = mEntries.begin(); it != mEntries.end(); ++it )
+      {
+        if ( it->first == key )
+        {
+          // move to the front of the list, the least recently used grids are at the end
+          mEntries.splice( mEntries.begin(), mEntries, it );
+          return mEntries.front().second;
+        }
+      }
+      return nullptr;
+    }
+
+    void insert( const QgsRasterProjectorGridKey &key, const std::shared_ptr< const QgsRasterProjectorGrid > &grid )
+    {
+      const std::size_t size = gridSize( *grid );
+      if ( size > MAXIMUM_SIZE )
+        return;
+
+      QMutexLocker locker( &mMutex );
+      mEntries.emplace_front( key, grid );
+      mSize += size;
+      while ( mSize > MAXIMUM_SIZE )
+      {
+        mSize -= gridSize( *mEntries.back().second );
+        mEntries.pop_back();
+      }
+    }
+
+  private:
+
+    static std::size_t gridSize( const QgsRasterProjectorGrid &grid )
+    {
+      return grid.srcIndexes.size() * sizeof( qint32 );
+    }
+
+    QMutex mMutex;
+    std::list< std::pair< QgsRasterProjectorGridKey, std::shared_ptr< const QgsRasterProjectorGrid > > > mEntries;
+    std::size_t mSize = 0;
+};
+
+Q_GLOBAL_STATIC( QgsRasterProjectorGridCache, sGridCache )
+
+//! Copies the source pixels of a destination row, for data types of \a T size
+template <typename T>
+static void copyPixels( const char *src, char *dest, const qint32 *srcIndexes, int count )
+{
+  const T *srcValues = reinterpret_cast< const T * >( src );
+  T *destValues = reinterpret_cast< T * >( dest );
+  for ( int i = 0; i < count; ++i )
+  {
+    if ( srcIndexes[i] >= 0 )
+      destValues[i] = srcValues[ srcIndexes[i] ];
+  }
+}
+
 /// @endcond
 
 
@@ -797,22 +1003,62 @@ QgsRasterBlock *QgsRasterProjector::block( int bandNo, QgsRectangle  const &exte
       QgsCoordinateTransform( mDestCRS, mSrcCRS, mDestDatumTransform, mSrcDatumTransform ) : QgsCoordinateTransform( mDestCRS, mSrcCRS, mTransformContext ) ;
   Q_NOWARN_DEPRECATED_POP
 
-  ProjectorData pd( extent, width, height, mInput, inverseCt, mPrecision, feedback );
+  QgsRasterProjectorGridKey key;
+  key.srcCrs = mSrcCRS;
+  key.destCrs = mDestCRS;
+  key.coordinateOperation = inverseCt.coordinateOperation();
+  Q_NOWARN_DEPRECATED_PUSH
+  key.srcDatumTransform = mSrcDatumTransform;
+  key.destDatumTransform = mDestDatumTransform;
+  Q_NOWARN_DEPRECATED_POP
+  key.precision = mPrecision;
+  key.destExtent = extent;
+  key.destWidth = width;
+  key.destHeight = height;
+  ProjectorData::sourceLimits( mInput, key.sourceExtent, key.maxSrcXRes, key.maxSrcYRes );
+
+  std::shared_ptr< const QgsRasterProjectorGrid > grid = sGridCache()->grid( key );
+  if ( !grid )
+  {
+    ProjectorData pd( extent, width, height, mInput, inverseCt, mPrecision, feedback );
 
-  if ( feedback && feedback->isCanceled() )
-    return new QgsRasterBlock();
+    if ( feedback && feedback->isCanceled() )
+      return new QgsRasterBlock();
 
-  QgsDebugMsgLevel( QStringLiteral( "srcExtent:\n%1" ).arg( pd.srcExtent().toString() ), 4 );
-  QgsDebugMsgLevel( QStringLiteral( "srcCols = %1 srcRows = %2" ).arg( pd.srcCols() ).arg( pd.srcRows() ), 4 );
+    QgsDebugMsgLevel( QStringLiteral( "srcExtent:\n%1" ).arg( pd.srcExtent().toString() ), 4 );
+    QgsDebugMsgLevel( QStringLiteral( "srcCols = %1 srcRows = %2" ).arg( pd.srcCols() ).arg( pd.srcRows() ), 4 );
 
-  // If we zoom out too much, projector srcRows / srcCols maybe 0, which can cause problems in providers
-  if ( pd.srcRows() <= 0 || pd.srcCols() <= 0 )
-  {
-    QgsDebugMsgLevel( QStringLiteral( "Zero srcRows or srcCols" ), 4 );
-    return new QgsRasterBlock();
+    // If we zoom out too much, projector srcRows / srcCols maybe 0, which can cause problems in providers
+    if ( pd.srcRows() <= 0 || pd.srcCols() <= 0 )
+    {
+      QgsDebugMsgLevel( QStringLiteral( "Zero srcRows or srcCols" ), 4 );
+      return new QgsRasterBlock();
+    }
+
+    // source indexes are stored on 32 bits, a larger source block could not be allocated anyway
+    if ( static_cast< qgssize >( pd.srcRows() ) * static_cast< qgssize >( pd.srcCols() ) > static_cast< qgssize >( std::numeric_limits< qint32 >::max() ) )
+    {
+      QgsDebugMsg( QStringLiteral( "Too large source block" ) );
+      return new QgsRasterBlock();
+    }
+
+    std::shared_ptr< QgsRasterProjectorGrid > newGrid = std::make_shared< QgsRasterProjectorGrid >();
+    newGrid->srcExtent = pd.srcExtent();
+    newGrid->srcRows = pd.srcRows();
+    newGrid->srcCols = pd.srcCols();
+    newGrid->srcIndexes.resize( static_cast< std::size_t >( width ) * static_cast< std::size_t >( height ) );
+    for ( int i = 0; i < height; ++i )
+    {
+      if ( feedback && feedback->isCanceled() )
+        return new QgsRasterBlock();
+      pd.srcIndexes( i, newGrid->srcIndexes.data() + static_cast< std::size_t >( i ) * width );
+    }
+
+    sGridCache()->insert( key, newGrid );
+    grid = newGrid;
   }
 
-  std::unique_ptr< QgsRasterBlock > inputBlock( mInput->block( bandNo, pd.srcExtent(), pd.srcCols(), pd.srcRows(), feedback ) );
+  std::unique_ptr< QgsRasterBlock > inputBlock( mInput->block( bandNo, grid->srcExtent, grid->srcCols, grid->srcRows, feedback ) );
   if ( !inputBlock || inputBlock->isEmpty() )
   {
     QgsDebugMsg( QStringLiteral( "No raster data!" ) );
@@ -847,28 +1093,59 @@ QgsRasterBlock *QgsRasterProjector::block( int bandNo, QgsRectangle  const &exte
   // we cannot fill output block with no data because we use memcpy for data, not setValue().
   bool doNoData = !QgsRasterBlock::typeIsNumeric( inputBlock->dataType() ) && inputBlock->hasNoData() && !inputBlock->hasNoDataValue();
 
-  outputBlock->setIsNoData();
+  // Without no data bitmaps to maintain, copy whole rows of pixels at once
+  const bool copyRows = !doNoData && outputBlock->hasNoDataValue() &&
+                        inputBlock->width() == grid->srcCols && inputBlock->height() == grid->srcRows &&
+                        ( pixelSize == 1 || pixelSize == 2 || pixelSize == 4 || pixelSize == 8 );
+  if ( copyRows )
+  {
+    const char *srcBits = inputBlock->bits();
+    char *destBits = outputBlock->bits();
+    for ( int i = 0; i < height; ++i )
+    {
+      if ( feedback && feedback->isCanceled() )
+        break;
+
+      const qint32 *srcIndexes = grid->srcIndexes.data() + static_cast< std::size_t >( i ) * width;
+      char *destRowBits = destBits + static_cast< qgssize >( i ) * width * pixelSize;
+      switch ( pixelSize )
+      {
+        case 1:
+          copyPixels< quint8 >( srcBits, destRowBits, srcIndexes, width );
+          break;
+        case 2:
+          copyPixels< quint16 >( srcBits, destRowBits, srcIndexes, width );
+          break;
+        case 4:
+          copyPixels< quint32 >( srcBits, destRowBits, srcIndexes, width );
+          break;
+        case 8:
+          copyPixels< quint64 >( srcBits, destRowBits, srcIndexes, width );
+          break;
+      }
+    }
+    return outputBlock.release();
+  }
 
-  int srcRow, srcCol;
   for ( int i = 0; i < height; ++i )
   {
     if ( feedback && feedback->isCanceled() )
       break;
+    const qint32 *srcIndexes = grid->srcIndexes.data() + static_cast< std::size_t >( i ) * width;
     for ( int j = 0; j < width; ++j )
     {
-      bool inside = pd.srcRowCol( i, j, &srcRow, &srcCol );
-      if ( !inside ) continue; // we have everything set to no data
+      if ( srcIndexes[j] < 0 ) continue; // we have everything set to no data
 
-      qgssize srcIndex = static_cast< qgssize >( srcRow * pd.srcCols() + srcCol );
+      qgssize srcIndex = static_cast< qgssize >( srcIndexes[j] );
 
       // isNoData() may be slow so we check doNoData first
-      if ( doNoData && inputBlock->isNoData( srcRow, srcCol ) )
+      if ( doNoData && inputBlock->isNoData( srcIndex ) )
       {
         outputBlock->setIsNoData( i, j );
         continue;
       }
 
-      qgssize destIndex = static_cast< qgssize >( i * width + j );
+      qgssize destIndex = static_cast< qgssize >( i ) * width + j;
       char *srcBits = inputBlock->bits( srcIndex );
       char *destBits = outputBlock->bits( destIndex );
       if ( !srcBits )
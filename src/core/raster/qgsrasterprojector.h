@@ -152,10 +152,23 @@ class ProjectorData
      */
     bool srcRowCol( int destRow, int destCol, int *srcRow, int *srcCol );
 
+    /**
+     * Computes the source pixel indexes (srcRow * srcCols() + srcCol) for all the columns of
+     * the destination row \a destRow, or -1 for the pixels outside of the source.
+     * Like with srcRowCol(), the rows must be requested in sequence.
+     */
+    void srcIndexes( int destRow, qint32 *indexes );
+
     QgsRectangle srcExtent() const { return mSrcExtent; }
     int srcRows() const { return mSrcRows; }
     int srcCols() const { return mSrcCols; }
 
+    /**
+     * Gets the \a extent of the source raster of \a input, and its resolution if the
+     * source cannot be read at any resolution (0 otherwise).
+     */
+    static void sourceLimits( QgsRasterInterface *input, QgsRectangle &extent, double &maxSrcXRes, double &maxSrcYRes );
+
   private:
 
     //! Returns the destination point for _current_ destination position.
@@ -173,6 +186,9 @@ class ProjectorData
     //! Returns approximate source row and column indexes for current source extent and resolution.
     inline bool approximateSrcRowCol( int destRow, int destCol, int *srcRow, int *srcCol );
 
+    //! Returns the source pixel index of source point (\a x, \a y), or -1 if it is outside of the source.
+    inline qint32 srcIndex( double x, double y ) const;
+
     //! \brief insert rows to matrix
     void insertRows( const QgsCoordinateTransform &ct );
 
@@ -24,6 +24,7 @@
 #include <QImage>
 #include <QColor>
 #include <memory>
+#include <algorithm>
 
 QgsSingleBandGrayRenderer::QgsSingleBandGrayRenderer( QgsRasterInterface *input, int grayBand )
   : QgsRasterRenderer( input, QStringLiteral( "singlebandgray" ) )
@@ -118,49 +119,63 @@ QgsRasterBlock *QgsSingleBandGrayRenderer::block( int bandNo, const QgsRectangle
   }
 
   const QRgb myDefaultColor = renderColorForNodataPixel();
-  bool isNoData = false;
-  for ( qgssize i = 0; i < ( qgssize )width * height; i++ )
-  {
-    double grayVal = inputBlock->valueAndNoData( i, isNoData );
+  QRgb *outputBlockData = outputBlock->colorData();
 
-    if ( isNoData )
+  // values are read a row at a time, to resolve the data type once per row
+  QVector< double > rowValues( width );
+  QVector< bool > rowIsNoData( width );
+  qgssize i = 0;
+  for ( int row = 0; row < height; ++row )
+  {
+    if ( !inputBlock->readValues( static_cast< qgssize >( row ) * width, width, rowValues.data(), rowIsNoData.data() ) )
     {
-      outputBlock->setColor( i, myDefaultColor );
+      std::fill( outputBlockData + static_cast< qgssize >( row ) * width, outputBlockData + static_cast< qgssize >( row + 1 ) * width, myDefaultColor );
+      i += width;
       continue;
     }
 
-    double currentAlpha = mOpacity;
-    if ( mRasterTransparency )
-    {
-      currentAlpha = mRasterTransparency->alphaValue( grayVal, mOpacity * 255 ) / 255.0;
-    }
-    if ( mAlphaBand > 0 )
-    {
-      currentAlpha *= alphaBlock->value( i ) / 255.0;
-    }
-
-    if ( mContrastEnhancement )
+    for ( int column = 0; column < width; ++column, ++i )
     {
-      if ( !mContrastEnhancement->isValueInDisplayableRange( grayVal ) )
+      if ( rowIsNoData.at( column ) )
       {
-        outputBlock->setColor( i, myDefaultColor );
+        outputBlockData[i] = myDefaultColor;
         continue;
       }
-      grayVal = mContrastEnhancement->enhanceContrast( grayVal );
-    }
+      double grayVal = rowValues.at( column );
 
-    if ( mGradient == WhiteToBlack )
-    {
-      grayVal = 255 - grayVal;
-    }
+      double currentAlpha = mOpacity;
+      if ( mRasterTransparency )
+      {
+        currentAlpha = mRasterTransparency->alphaValue( grayVal, mOpacity * 255 ) / 255.0;
+      }
+      if ( mAlphaBand > 0 )
+      {
+        currentAlpha *= alphaBlock->value( i ) / 255.0;
+      }
 
-    if ( qgsDoubleNear( currentAlpha, 1.0 ) )
-    {
-      outputBlock->setColor( i, qRgba( grayVal, grayVal, grayVal, 255 ) );
-    }
-    else
-    {
-      outputBlock->setColor( i, qRgba( currentAlpha * grayVal, currentAlpha * grayVal, currentAlpha * grayVal, currentAlpha * 255 ) );
+      if ( mContrastEnhancement )
+      {
+        if ( !mContrastEnhancement->isValueInDisplayableRange( grayVal ) )
+        {
+          outputBlockData[i] = myDefaultColor;
+          continue;
+        }
+        grayVal = mContrastEnhancement->enhanceContrast( grayVal );
+      }
+
+      if ( mGradient == WhiteToBlack )
+      {
+        grayVal = 255 - grayVal;
+      }
+
+      if ( qgsDoubleNear( currentAlpha, 1.0 ) )
+      {
+        outputBlockData[i] = qRgba( grayVal, grayVal, grayVal, 255 );
+      }
+      else
+      {
+        outputBlockData[i] = qRgba( currentAlpha * grayVal, currentAlpha * grayVal, currentAlpha * grayVal, currentAlpha * 255 );
+      }
     }
   }
 
@@ -28,6 +28,8 @@
 #include <QDomElement>
 #include <QImage>
 
+#include <algorithm>
+
 QgsSingleBandPseudoColorRenderer::QgsSingleBandPseudoColorRenderer( QgsRasterInterface *input, int band, QgsRasterShader *shader )
   : QgsRasterRenderer( input, QStringLiteral( "singlebandpseudocolor" ) )
   , mShader( shader )
@@ -244,50 +246,62 @@ QgsRasterBlock *QgsSingleBandPseudoColorRenderer::block( int bandNo, QgsRectangl
   QRgb *outputBlockData = outputBlock->colorData();
   const QgsRasterShaderFunction *fcn = mShader->rasterShaderFunction();
 
-  qgssize count = ( qgssize )width * height;
-  bool isNoData = false;
-  for ( qgssize i = 0; i < count; i++ )
+  // values are read a row at a time, to resolve the data type once per row
+  QVector< double > rowValues( width );
+  QVector< bool > rowIsNoData( width );
+  qgssize i = 0;
+  for ( int row = 0; row < height; ++row )
   {
-    double val = inputBlock->valueAndNoData( i, isNoData );
-    if ( isNoData )
-    {
-      outputBlockData[i] = myDefaultColor;
-      continue;
-    }
-
-    int red, green, blue, alpha;
-    if ( !fcn->shade( val, &red, &green, &blue, &alpha ) )
+    if ( !inputBlock->readValues( static_cast< qgssize >( row ) * width, width, rowValues.data(), rowIsNoData.data() ) )
     {
-      outputBlockData[i] = myDefaultColor;
+      std::fill( outputBlockData + static_cast< qgssize >( row ) * width, outputBlockData + static_cast< qgssize >( row + 1 ) * width, myDefaultColor );
+      i += width;
       continue;
     }
 
-    if ( alpha < 255 )
+    for ( int column = 0; column < width; ++column, ++i )
     {
-      // Working with premultiplied colors, so multiply values by alpha
-      red *= ( alpha / 255.0 );
-      blue *= ( alpha / 255.0 );
-      green *= ( alpha / 255.0 );
-    }
+      if ( rowIsNoData.at( column ) )
+      {
+        outputBlockData[i] = myDefaultColor;
+        continue;
+      }
+      const double val = rowValues.at( column );
 
-    if ( !hasTransparency )
-    {
-      outputBlockData[i] = qRgba( red, green, blue, alpha );
-    }
-    else
-    {
-      //opacity
-      double currentOpacity = mOpacity;
-      if ( mRasterTransparency )
+      int red, green, blue, alpha;
+      if ( !fcn->shade( val, &red, &green, &blue, &alpha ) )
       {
-        currentOpacity = mRasterTransparency->alphaValue( val, mOpacity * 255 ) / 255.0;
+        outputBlockData[i] = myDefaultColor;
+        continue;
       }
-      if ( mAlphaBand > 0 )
+
+      if ( alpha < 255 )
       {
-        currentOpacity *= alphaBlock->value( i ) / 255.0;
+        // Working with premultiplied colors, so multiply values by alpha
+        red *= ( alpha / 255.0 );
+        blue *= ( alpha / 255.0 );
+        green *= ( alpha / 255.0 );
       }
 
-      outputBlockData[i] = qRgba( currentOpacity * red, currentOpacity * green, currentOpacity * blue, currentOpacity * alpha );
+      if ( !hasTransparency )
+      {
+        outputBlockData[i] = qRgba( red, green, blue, alpha );
+      }
+      else
+      {
+        //opacity
+        double currentOpacity = mOpacity;
+        if ( mRasterTransparency )
+        {
+          currentOpacity = mRasterTransparency->alphaValue( val, mOpacity * 255 ) / 255.0;
+        }
+        if ( mAlphaBand > 0 )
+        {
+          currentOpacity *= alphaBlock->value( i ) / 255.0;
+        }
+
+        outputBlockData[i] = qRgba( currentOpacity * red, currentOpacity * green, currentOpacity * blue, currentOpacity * alpha );
+      }
     }
   }
 
@@ -51,6 +51,7 @@
 #include "qgsexpressioncontextutils.h"
 #include "qgsrenderedfeaturehandlerinterface.h"
 #include "qgslegendpatchshape.h"
+#include "qgsrenderarena.h"
 
 QgsPropertiesDefinition QgsSymbol::sPropertyDefinitions;
 
@@ -103,6 +104,18 @@ QgsSymbol::QgsSymbol( SymbolType type, const QgsSymbolLayerList &layers )
 }
 Q_NOWARN_DEPRECATED_POP
 
+// Transforms the polygon with temporary coordinate arrays allocated from the render context arena
+static void transformPolygonUsingArena( QgsRenderContext &context, const QgsCoordinateTransform &ct, QPolygonF &poly )
+{
+  if ( ct.isShortCircuited() )
+    return;
+
+  QgsRenderArena &arena = context.renderArena();
+  const QgsRenderArenaScope arenaScope( arena );
+  const int count = poly.size();
+  ct.transformPolygon( poly, arena.allocateArray< double >( count ), arena.allocateArray< double >( count ), arena.allocateArray< double >( count ) );
+}
+
 QPolygonF QgsSymbol::_getLineString( QgsRenderContext &context, const QgsCurve &curve, bool clipToExtent )
 {
   const unsigned int nPoints = curve.numPoints();
@@ -130,7 +143,7 @@ QPolygonF QgsSymbol::_getLineString( QgsRenderContext &context, const QgsCurve &
   {
     try
     {
-      ct.transformPolygon( pts );
+      transformPolygonUsingArena( context, ct, pts );
     }
     catch ( QgsCsException & )
     {
@@ -155,11 +168,7 @@ QPolygonF QgsSymbol::_getLineString( QgsRenderContext &context, const QgsCurve &
     pts = QgsClipper::clippedLine( pts, clipRect );
   }
 
-  QPointF *ptr = pts.data();
-  for ( int i = 0; i < pts.size(); ++i, ++ptr )
-  {
-    mtp.transformInPlace( ptr->rx(), ptr->ry() );
-  }
+  mtp.transformInPlace( pts.data(), pts.size() );
 
   return pts;
 }
@@ -198,7 +207,7 @@ QPolygonF QgsSymbol::_getPolygonRing( QgsRenderContext &context, const QgsCurve
   {
     try
     {
-      ct.transformPolygon( poly );
+      transformPolygonUsingArena( context, ct, poly );
     }
     catch ( QgsCsException & )
     {
@@ -223,11 +232,7 @@ QPolygonF QgsSymbol::_getPolygonRing( QgsRenderContext &context, const QgsCurve
     QgsClipper::trimPolygon( poly, clipRect );
   }
 
-  QPointF *ptr = poly.data();
-  for ( int i = 0; i < poly.size(); ++i, ++ptr )
-  {
-    mtp.transformInPlace( ptr->rx(), ptr->ry() );
-  }
+  mtp.transformInPlace( poly.data(), poly.size() );
 
   if ( !poly.empty() && !poly.isClosed() )
     poly << poly.at( 0 );
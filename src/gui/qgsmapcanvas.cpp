@@ -58,6 +58,7 @@ email                : sherman at mrcc.com
 #include "qgsmaptopixel.h"
 #include "qgsmapoverviewcanvas.h"
 #include "qgsmaprenderercache.h"
+#include "qgslabelcandidatecache.h"
 #include "qgsmaprenderercustompainterjob.h"
 #include "qgsmaprendererparalleljob.h"
 #include "qgsmaprenderersequentialjob.h"
@@ -268,6 +269,7 @@ QgsMapCanvas::~QgsMapCanvas()
   mScene->deleteLater();  // crashes in python tests on windows
 
   delete mCache;
+  delete mLabelCandidateCache;
   delete mLabelingResults;
 }
 
@@ -469,11 +471,14 @@ void QgsMapCanvas::setCachingEnabled( bool enabled )
   if ( enabled )
   {
     mCache = new QgsMapRendererCache;
+    mLabelCandidateCache = new QgsLabelCandidateCache;
   }
   else
   {
     delete mCache;
     mCache = nullptr;
+    delete mLabelCandidateCache;
+    mLabelCandidateCache = nullptr;
   }
 }
 
@@ -486,6 +491,8 @@ void QgsMapCanvas::clearCache()
 {
   if ( mCache )
     mCache->clear();
+  if ( mLabelCandidateCache )
+    mLabelCandidateCache->clear();
 }
 
 void QgsMapCanvas::setParallelRenderingEnabled( bool enabled )
@@ -601,6 +608,7 @@ void QgsMapCanvas::refreshMap()
     mJob = new QgsMapRendererSequentialJob( renderSettings );
   connect( mJob, &QgsMapRendererJob::finished, this, &QgsMapCanvas::rendererJobFinished );
   mJob->setCache( mCache );
+  mJob->setLabelCandidateCache( mLabelCandidateCache );
 
   mJob->start();
 
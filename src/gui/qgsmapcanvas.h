@@ -60,6 +60,7 @@ class QgsVectorLayer;
 
 class QgsLabelingResults;
 class QgsMapRendererCache;
+class QgsLabelCandidateCache;
 class QgsMapRendererQImageJob;
 class QgsMapSettings;
 class QgsMapCanvasMap;
@@ -1234,6 +1235,9 @@ class GUI_EXPORT QgsMapCanvas : public QGraphicsView
     //! Optionally use cache with rendered map layers for the current map settings
     QgsMapRendererCache *mCache = nullptr;
 
+    //! Cache of the label candidates, reused when the map is panned (only when caching is enabled)
+    QgsLabelCandidateCache *mLabelCandidateCache = nullptr;
+
     QTimer *mResizeTimer = nullptr;
     QTimer *mRefreshTimer = nullptr;
 
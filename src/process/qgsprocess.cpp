@@ -298,6 +298,7 @@ int QgsProcessingExec::run( const QStringList &constArgs )
     QgsUnitTypes::DistanceUnit distanceUnit = QgsUnitTypes::DistanceUnknownUnit;
     QgsUnitTypes::AreaUnit areaUnit = QgsUnitTypes::AreaUnknownUnit;
     QString projectPath;
+    bool streamModelOutputs = false;
     QVariantMap params;
     int i = 3;
     for ( ; i < args.count(); i++ )
@@ -333,6 +334,10 @@ int QgsProcessingExec::run( const QStringList &constArgs )
         {
           projectPath = parts.mid( 1 ).join( '=' );
         }
+        else if ( name.compare( QLatin1String( "stream_model_outputs" ), Qt::CaseInsensitive ) == 0 )
+        {
+          streamModelOutputs = QVariant( parts.mid( 1 ).join( '=' ) ).toBool();
+        }
         else
         {
           const QString value = parts.mid( 1 ).join( '=' );
@@ -401,7 +406,7 @@ int QgsProcessingExec::run( const QStringList &constArgs )
       }
     }
 
-    return execute( algId, params, ellipsoid, distanceUnit, areaUnit, useJson, projectPath );
+    return execute( algId, params, ellipsoid, distanceUnit, areaUnit, useJson, projectPath, streamModelOutputs );
   }
   else
   {
@@ -425,7 +430,8 @@ void QgsProcessingExec::showUsage( const QString &appName )
       << "\thelp\tshow help for an algorithm. The algorithm id or a path to a model file must be specified.\n"
       << "\trun\truns an algorithm. The algorithm id or a path to a model file and parameter values must be specified. Parameter values are specified after -- with PARAMETER=VALUE syntax. Ordered list values for a parameter can be created by specifying the parameter multiple times, e.g. --LAYERS=layer1.shp --LAYERS=layer2.shp\n"
       << "\t\tIf required, the ellipsoid to use for distance and area calculations can be specified via the \"--ELLIPSOID=name\" argument.\n"
-      << "\t\tIf required, an existing QGIS project to use during the algorithm execution can be specified via the \"--PROJECT_PATH=path\" argument.\n";
+      << "\t\tIf required, an existing QGIS project to use during the algorithm execution can be specified via the \"--PROJECT_PATH=path\" argument.\n"
+      << "\t\tModels can pass the features of their child algorithms straight to the next child algorithm, without writing intermediate layers, via the \"--STREAM_MODEL_OUTPUTS=true\" argument.\n";
 
   std::cout << msg.join( QString() ).toLocal8Bit().constData();
 }
@@ -742,7 +748,7 @@ int QgsProcessingExec::showAlgorithmHelp( const QString &id, bool useJson )
   return 0;
 }
 
-int QgsProcessingExec::execute( const QString &id, const QVariantMap &params, const QString &ellipsoid, QgsUnitTypes::DistanceUnit distanceUnit, QgsUnitTypes::AreaUnit areaUnit, bool useJson, const QString &projectPath )
+int QgsProcessingExec::execute( const QString &id, const QVariantMap &params, const QString &ellipsoid, QgsUnitTypes::DistanceUnit distanceUnit, QgsUnitTypes::AreaUnit areaUnit, bool useJson, const QString &projectPath, bool streamModelOutputs )
 {
   QVariantMap json;
   if ( useJson )
@@ -867,6 +873,8 @@ int QgsProcessingExec::execute( const QString &id, const QVariantMap &params, co
   context.setDistanceUnit( distanceUnit );
   context.setAreaUnit( areaUnit );
   context.setProject( project.get() );
+  if ( streamModelOutputs )
+    context.setFlags( context.flags() | QgsProcessingContext::StreamModelChildOutputs );
 
   const QgsProcessingParameterDefinitions defs = alg->parameterDefinitions();
   QList< const QgsProcessingParameterDefinition * > missingParams;
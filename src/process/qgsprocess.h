@@ -81,7 +81,8 @@ class QgsProcessingExec
                  QgsUnitTypes::DistanceUnit distanceUnit,
                  QgsUnitTypes::AreaUnit areaUnit,
                  bool useJson,
-                 const QString &projectPath = QString() );
+                 const QString &projectPath = QString(),
+                 bool streamModelOutputs = false );
 
     void addVersionInformation( QVariantMap &json );
     void addAlgorithmInformation( QVariantMap &json, const QgsProcessingAlgorithm *algorithm );
@@ -21,7 +21,6 @@
 #include "qgslogger.h"
 #include "qgsmessagelog.h"
 #include "qgsproject.h"
-#include "qgsspatialindex.h"
 #include "qgsexception.h"
 #include "qgsexpressioncontextutils.h"
 
@@ -84,7 +83,7 @@ QgsDelimitedTextFeatureIterator::QgsDelimitedTextFeatureIterator( QgsDelimitedTe
 
     else if ( mSource->mUseSpatialIndex )
     {
-      mFeatureIds = mSource->mSpatialIndex->intersects( mFilterRect );
+      mFeatureIds = mSource->mSpatialIndex.intersects( mFilterRect );
       // Sort for efficient sequential retrieval
       std::sort( mFeatureIds.begin(), mFeatureIds.end() );
       QgsDebugMsgLevel( QStringLiteral( "Layer has spatial index - selected %1 features from index" ).arg( mFeatureIds.size() ), 4 );
@@ -530,7 +529,7 @@ QgsDelimitedTextFeatureSource::QgsDelimitedTextFeatureSource( const QgsDelimited
   , mSubsetExpression( p->mSubsetExpression ? new QgsExpression( *p->mSubsetExpression ) : nullptr )
   , mExtent( p->mExtent )
   , mUseSpatialIndex( p->mUseSpatialIndex )
-  , mSpatialIndex( p->mSpatialIndex ? new QgsSpatialIndex( *p->mSpatialIndex ) : nullptr )
+  , mSpatialIndex( p->mSpatialIndex )
   , mUseSubsetIndex( p->mUseSubsetIndex )
   , mSubsetIndex( p->mSubsetIndex )
   , mFile( nullptr )
@@ -560,6 +559,8 @@ QgsDelimitedTextFeatureSource::QgsDelimitedTextFeatureSource( const QgsDelimited
 
   mFile.reset( new QgsDelimitedTextFile() );
   mFile->setFromUrl( url );
+  // reuse the positions of lines found while scanning the file, to seek to the requested features
+  mFile->setLineOffsets( p->mFile->lineOffsets(), p->mFile->eolChar() );
 
   mExpressionContext << QgsExpressionContextUtils::globalScope()
                      << QgsExpressionContextUtils::projectScope( QgsProject::instance() );
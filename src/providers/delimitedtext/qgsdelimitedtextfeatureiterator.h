@@ -35,7 +35,7 @@ class QgsDelimitedTextFeatureSource final: public QgsAbstractFeatureSource
     QgsExpressionContext mExpressionContext;
     QgsRectangle mExtent;
     bool mUseSpatialIndex;
-    std::unique_ptr< QgsSpatialIndex > mSpatialIndex;
+    QgsPackedSpatialIndex mSpatialIndex;
     bool mUseSubsetIndex;
     QList<quintptr> mSubsetIndex;
     std::unique_ptr< QgsDelimitedTextFile > mFile;
@@ -17,6 +17,7 @@
 
 #include "qgsdelimitedtextfile.h"
 #include "qgslogger.h"
+#include "qgis.h"
 
 #include <QtGlobal>
 #include <QFile>
@@ -30,6 +31,9 @@
 #include <QUrl>
 #include <QUrlQuery>
 
+#include <algorithm>
+#include <cstring>
+
 QgsDelimitedTextFile::QgsDelimitedTextFile( const QString &url )
   : mFileName( QString() )
   , mEncoding( QStringLiteral( "UTF-8" ) )
@@ -49,6 +53,7 @@ QgsDelimitedTextFile::QgsDelimitedTextFile( const QString &url )
 QgsDelimitedTextFile::~QgsDelimitedTextFile()
 {
   close();
+  unmapFile();
 }
 
 void QgsDelimitedTextFile::close()
@@ -109,6 +114,8 @@ bool QgsDelimitedTextFile::open()
 void QgsDelimitedTextFile::updateFile()
 {
   close();
+  unmapFile();
+  mLineOffsets.clear();
   emit fileUpdated();
 }
 
@@ -116,6 +123,8 @@ void QgsDelimitedTextFile::updateFile()
 void QgsDelimitedTextFile::resetDefinition()
 {
   close();
+  unmapFile();
+  mLineOffsets.clear();
   mFieldNames.clear();
   mMaxFieldCount = 0;
 }
@@ -675,6 +684,27 @@ QgsDelimitedTextFile::Status QgsDelimitedTextFile::nextLine( QString &buffer, bo
 bool QgsDelimitedTextFile::setNextLineNumber( long nextLineNumber )
 {
   if ( ! mStream ) return false;
+
+  // If the position of a line between the current one and the requested one is known,
+  // (or before the requested one if we need to go back), then jump to it
+  if ( ! mLineOffsets.isEmpty() )
+  {
+    auto it = std::upper_bound( mLineOffsets.constBegin(), mLineOffsets.constEnd(), nextLineNumber - 1,
+                                []( long lineNumber, const QPair< long, qint64 > &offset ) { return lineNumber < offset.first; } );
+    if ( it != mLineOffsets.constBegin() )
+    {
+      --it;
+      if ( it->first > mLineNumber || mLineNumber > nextLineNumber - 1 )
+      {
+        mRecordNumber = -1;
+        mStream->seek( it->second );
+        mLineNumber = it->first;
+        mBuffer = mStream->read( mMaxBufferSize );
+        mPosInBuffer = 0;
+      }
+    }
+  }
+
   if ( mLineNumber > nextLineNumber - 1 )
   {
     mRecordNumber = -1;
@@ -916,3 +946,431 @@ bool QgsDelimitedTextFile::isValid()
   return mDefinitionValid && QFile::exists( mFileName ) && QFileInfo( mFileName ).size() > 0;
 }
 
+
+//! Returns the length of the UTF-8 encoded character at \a p, or 1 for an invalid sequence
+static int utf8CharLength( const char *p, const char *end )
+{
+  const unsigned char lead = static_cast< unsigned char >( *p );
+  const int length = lead < 0xC0 ? 1 : lead < 0xE0 ? 2 : lead < 0xF0 ? 3 : 4;
+  for ( int i = 1; i < length; ++i )
+  {
+    if ( p + i >= end || ( static_cast< unsigned char >( p[i] ) & 0xC0 ) != 0x80 )
+      return 1;
+  }
+  return length;
+}
+
+//! Returns TRUE if the UTF-8 encoded character at \a p of \a length bytes is a whitespace, as defined by QChar::isSpace()
+static bool utf8CharIsSpace( const char *p, int length )
+{
+  const unsigned char lead = static_cast< unsigned char >( *p );
+  if ( length == 1 )
+    return lead == ' ' || ( lead >= '\t' && lead <= '\r' );
+
+  uint ucs4 = lead & ( 0x3F >> ( length - 1 ) );
+  for ( int i = 1; i < length; ++i )
+    ucs4 = ( ucs4 << 6 ) | ( static_cast< unsigned char >( p[i] ) & 0x3F );
+  return QChar::isSpace( ucs4 );
+}
+
+//! Removes the leading and trailing whitespaces of a field, as QString::trimmed() does
+static void trimMappedField( const std::string &buffer, QgsDelimitedTextFile::MappedRecord::Field &field )
+{
+  const char *begin = buffer.data() + field.offset;
+  const char *end = begin + field.size;
+  while ( begin < end )
+  {
+    const int length = utf8CharLength( begin, end );
+    if ( !utf8CharIsSpace( begin, length ) )
+      break;
+    begin += length;
+  }
+  while ( end > begin )
+  {
+    const char *last = end - 1;
+    while ( last > begin && ( static_cast< unsigned char >( *last ) & 0xC0 ) == 0x80 )
+      --last;
+    const int length = utf8CharLength( last, end );
+    if ( last + length != end || !utf8CharIsSpace( last, length ) )
+      break;
+    end = last;
+  }
+  field.offset = static_cast< int >( begin - buffer.data() );
+  field.size = static_cast< int >( end - begin );
+}
+
+bool QgsDelimitedTextFile::mapFile()
+{
+  unmapFile();
+
+  if ( ! mDefinitionValid || mType != DelimTypeCSV )
+    return false;
+  if ( mEncoding.compare( QLatin1String( "UTF-8" ), Qt::CaseInsensitive ) != 0 && mEncoding.compare( QLatin1String( "UTF8" ), Qt::CaseInsensitive ) != 0 )
+    return false;
+
+  // The records are tokenized byte by byte, so the special characters must be ASCII characters
+  std::fill( std::begin( mMappedCharClass ), std::end( mMappedCharClass ), 0 );
+  const QList< QPair< QString, MappedCharClass > > specialChars
+  {
+    qMakePair( mDelimChars, MappedDelimiter ),
+    qMakePair( mQuoteChar, MappedQuote ),
+    qMakePair( mEscapeChar, MappedEscape )
+  };
+  for ( const QPair< QString, MappedCharClass > &chars : specialChars )
+  {
+    for ( const QChar &c : chars.first )
+    {
+      if ( c.unicode() >= 0x80 || c == '\r' || c == '\n' )
+        return false;
+      mMappedCharClass[c.unicode()] |= chars.second;
+    }
+  }
+
+  std::unique_ptr< QFile > file = qgis::make_unique< QFile >( mFileName );
+  if ( ! file->open( QIODevice::ReadOnly ) || file->size() <= 0 )
+    return false;
+
+  const qint64 size = file->size();
+  uchar *data = file->map( 0, size );
+  if ( ! data )
+  {
+    QgsDebugMsgLevel( "Data file " + mFileName + " could not be mapped", 2 );
+    return false;
+  }
+
+  mMappedFile = std::move( file );
+  mMappedData = reinterpret_cast< const char * >( data );
+  mMappedSize = size;
+
+  // UTF-16 and UTF-32 byte order marks are detected by QTextStream, and cannot be read from the mapping
+  const unsigned char *bytes = data;
+  if ( ( size >= 2 && ( ( bytes[0] == 0xFF && bytes[1] == 0xFE ) || ( bytes[0] == 0xFE && bytes[1] == 0xFF ) ) )
+       || ( size >= 4 && bytes[0] == 0 && bytes[1] == 0 && bytes[2] == 0xFE && bytes[3] == 0xFF ) )
+  {
+    unmapFile();
+    return false;
+  }
+  const char *start = mMappedData;
+  if ( size >= 3 && bytes[0] == 0xEF && bytes[1] == 0xBB && bytes[2] == 0xBF )
+    start += 3;
+
+  // As in nextLine(), the end of line character is the first one found in the file
+  const char *end = mMappedData + size;
+  const char *eol = std::find_if( start, end, []( char c ) { return c == '\r' || c == '\n'; } );
+  mMappedEolChar = eol != end ? *eol : '\n';
+  mFirstEOLChar = mMappedEolChar;
+
+  // Skip the lines before the records, as reset() does
+  qint64 offset = start - mMappedData;
+  long lineNumber = 0;
+  for ( int i = mSkipLines; i-- > 0 && offset < size; )
+  {
+    const char *lineEnd = mappedLineEnd( mMappedData + offset );
+    if ( lineEnd - ( mMappedData + offset ) >= mMaxBufferSize - 1 )
+    {
+      unmapFile();
+      return false;
+    }
+    offset = mappedNextLineStart( lineEnd ) - mMappedData;
+    lineNumber++;
+  }
+  if ( mUseHeader )
+  {
+    MappedRecord header;
+    int maxFieldCount = 0;
+    if ( nextMappedRecord( offset, size, lineNumber, header, maxFieldCount ) == InvalidDefinition )
+    {
+      unmapFile();
+      return false;
+    }
+  }
+  mMappedRecordsOffset = offset;
+  mMappedRecordsLineNumber = lineNumber;
+  return true;
+}
+
+void QgsDelimitedTextFile::unmapFile()
+{
+  // The mapping is released with the file
+  mMappedFile.reset();
+  mMappedData = nullptr;
+  mMappedSize = 0;
+  mMappedRecordsOffset = 0;
+  mMappedRecordsLineNumber = 0;
+}
+
+const char *QgsDelimitedTextFile::mappedLineEnd( const char *line ) const
+{
+  const char *end = mMappedData + mMappedSize;
+  const void *eol = line < end ? std::memchr( line, mMappedEolChar, end - line ) : nullptr;
+  return eol ? static_cast< const char * >( eol ) : end;
+}
+
+const char *QgsDelimitedTextFile::mappedNextLineStart( const char *lineEnd ) const
+{
+  const char *end = mMappedData + mMappedSize;
+  if ( lineEnd >= end )
+    return end;
+  const char *next = lineEnd + 1;
+  if ( mMappedEolChar == '\r' && next < end && *next == '\n' )
+    ++next;
+  return next;
+}
+
+qint64 QgsDelimitedTextFile::nextMappedLine( qint64 offset ) const
+{
+  if ( offset <= mMappedRecordsOffset )
+    return mMappedRecordsOffset;
+  if ( offset >= mMappedSize )
+    return mMappedSize;
+  return mappedNextLineStart( mappedLineEnd( mMappedData + offset - 1 ) ) - mMappedData;
+}
+
+QgsDelimitedTextFile::Status QgsDelimitedTextFile::nextMappedRecord( qint64 &offset, qint64 boundary, long &lineNumber, MappedRecord &record, int &maxFieldCount ) const
+{
+  record.lineNumber = -1;
+  record.fields.clear();
+  record.buffer.clear();
+  if ( ! mMappedData )
+    return InvalidDefinition;
+
+  const char *data = mMappedData;
+  const char *end = data + mMappedSize;
+  // Lines which are split by nextLine() cannot be read the same way from the mapping
+  const qint64 maxLineLength = mMaxBufferSize - 1;
+
+  // Find the first non-blank line to read
+  const char *line = data + offset;
+  const char *lineEnd = nullptr;
+  while ( true )
+  {
+    if ( line >= end || line >= data + boundary )
+    {
+      offset = line - data;
+      return RecordEOF;
+    }
+    lineEnd = mappedLineEnd( line );
+    if ( lineEnd - line >= maxLineLength )
+      return InvalidDefinition;
+    if ( lineEnd != line )
+      break;
+    lineNumber++;
+    line = mappedNextLineStart( lineEnd );
+  }
+  record.lineNumber = ++lineNumber;
+
+  // The following is the same parser as parseQuoted(), except that the fields are
+  // accumulated in the buffer of the record
+  std::string &buffer = record.buffer;
+  std::vector< MappedRecord::Field > &fields = record.fields;
+  std::size_t fieldStart = 0;
+
+  auto appendField = [this, &buffer, &fields, &fieldStart, &maxFieldCount]( bool quoted )
+  {
+    if ( mMaxFields > 0 && static_cast< int >( fields.size() ) >= mMaxFields )
+    {
+      buffer.resize( fieldStart );
+      return;
+    }
+    MappedRecord::Field field { static_cast< int >( fieldStart ), static_cast< int >( buffer.size() - fieldStart ) };
+    if ( quoted )
+    {
+      fields.push_back( field );
+    }
+    else
+    {
+      if ( mTrimFields ) trimMappedField( buffer, field );
+      if ( !( mDiscardEmptyFields && field.size == 0 ) ) fields.push_back( field );
+    }
+    // Keep track of maximum number of non-empty fields in a record
+    if ( static_cast< int >( fields.size() ) > maxFieldCount && field.size > 0 )
+    {
+      maxFieldCount = static_cast< int >( fields.size() );
+    }
+  };
+
+  Status status = RecordOk;
+  bool escaped = false; // Next char is escaped
+  bool quoted = false;  // In quotes
+  char quoteChar = 0;   // Actual quote character used to open quotes
+  bool started = false; // Non-blank chars in field or quotes started
+  bool ended = false;   // Quoted field ended
+  const char *cp = line;
+  const char *cpmax = lineEnd;
+
+  while ( true )
+  {
+    // If end of line then if escaped or buffered then try to get more...
+    if ( cp >= cpmax )
+    {
+      if ( quoted || escaped )
+      {
+        line = mappedNextLineStart( cpmax );
+        if ( line >= end )
+        {
+          status = RecordInvalid;
+          break;
+        }
+        cpmax = mappedLineEnd( line );
+        if ( cpmax - line >= maxLineLength )
+          return InvalidDefinition;
+        lineNumber++;
+        buffer.push_back( '\n' );
+        cp = line;
+        escaped = false;
+        continue;
+      }
+      break;
+    }
+
+    const unsigned char c = static_cast< unsigned char >( *cp );
+
+    // If escaped, then just append the character
+    if ( escaped )
+    {
+      const int length = utf8CharLength( cp, cpmax );
+      buffer.append( cp, length );
+      cp += length;
+      escaped = false;
+      continue;
+    }
+
+    // Non ASCII characters are never delimiter, quote or escape characters
+    if ( c >= 0x80 )
+    {
+      const int length = utf8CharLength( cp, cpmax );
+      if ( quoted )
+      {
+        buffer.append( cp, length );
+      }
+      else if ( utf8CharIsSpace( cp, length ) )
+      {
+        if ( ! ended ) buffer.append( cp, length );
+      }
+      else
+      {
+        if ( ended )
+        {
+          fields.clear();
+          offset = mappedNextLineStart( cpmax ) - data;
+          return RecordInvalid;
+        }
+        buffer.append( cp, length );
+        started = true;
+      }
+      cp += length;
+      continue;
+    }
+    cp++;
+
+    bool isQuote = false;
+    bool isEscape = false;
+    const unsigned char charClass = mMappedCharClass[c];
+    bool isDelim = charClass & MappedDelimiter;
+    if ( ! isDelim )
+    {
+      bool isQuoteChar = charClass & MappedQuote;
+      isQuote = quoted ? c == static_cast< unsigned char >( quoteChar ) : isQuoteChar;
+      isEscape = charClass & MappedEscape;
+      if ( isQuoteChar && isEscape ) isEscape = isQuote;
+    }
+
+    // Start or end of quote ...
+    if ( isQuote )
+    {
+      // quote char in quoted field
+      if ( quoted )
+      {
+        // if is also escape and next character is quote, then
+        // escape the quote..
+        if ( isEscape && cp < cpmax && *cp == quoteChar )
+        {
+          buffer.push_back( quoteChar );
+          cp++;
+        }
+        // Otherwise end of quoted field
+        else
+        {
+          quoted = false;
+          ended = true;
+        }
+      }
+      // quote char at start of field .. start of quoted fields
+      else if ( ! started )
+      {
+        buffer.resize( fieldStart );
+        quoteChar = static_cast< char >( c );
+        quoted = true;
+        started = true;
+      }
+      // Cannot have a quote embedded in a field
+      else
+      {
+        fields.clear();
+        offset = mappedNextLineStart( cpmax ) - data;
+        return RecordInvalid;
+      }
+    }
+    // If escape char, then next char is escaped...
+    else if ( isEscape )
+    {
+      escaped = true;
+    }
+    // If within quotes, then append to the string
+    else if ( quoted )
+    {
+      buffer.push_back( static_cast< char >( c ) );
+    }
+    // If it is a delimiter, then end of field...
+    else if ( isDelim )
+    {
+      appendField( ended );
+
+      // Start the next field
+      fieldStart = buffer.size();
+      started = false;
+      ended = false;
+    }
+    // Whitespace is permitted before the start of a field, or
+    // after the end..
+    else if ( c == ' ' || ( c >= '\t' && c <= '\r' ) )
+    {
+      if ( ! ended ) buffer.push_back( static_cast< char >( c ) );
+    }
+    // Other chars permitted if not after quoted field
+    else
+    {
+      if ( ended )
+      {
+        fields.clear();
+        offset = mappedNextLineStart( cpmax ) - data;
+        return RecordInvalid;
+      }
+      buffer.push_back( static_cast< char >( c ) );
+      started = true;
+    }
+  }
+  // If reached the end of the record, then add the last field...
+  if ( started )
+  {
+    appendField( ended );
+  }
+  if ( status != RecordOk )
+  {
+    fields.clear();
+  }
+  offset = mappedNextLineStart( cpmax ) - data;
+  return status;
+}
+
+void QgsDelimitedTextFile::updateMaxFieldCount( int count )
+{
+  mMaxFieldCount = std::max( mMaxFieldCount, count );
+}
+
+void QgsDelimitedTextFile::setLineOffsets( const LineOffsets &offsets, QChar eolChar )
+{
+  mLineOffsets = offsets;
+  if ( ! eolChar.isNull() )
+    mFirstEOLChar = eolChar;
+}
@@ -22,6 +22,12 @@
 #include <QRegExp>
 #include <QUrl>
 #include <QObject>
+#include <QPair>
+#include <QVector>
+
+#include <memory>
+#include <string>
+#include <vector>
 
 class QgsFeature;
 class QgsField;
@@ -96,6 +102,40 @@ class QgsDelimitedTextFile : public QObject
       DelimTypeRegexp
     };
 
+    /**
+     * A record read from the memory mapped file by nextMappedRecord().
+     *
+     * The fields are stored as UTF-8 spans of a single buffer, which is reused
+     * from one record to the next, so that tokenizing a record does not allocate
+     * memory for each field. The fields are only converted to strings on demand.
+     */
+    struct MappedRecord
+    {
+      //! Span of a field in the buffer
+      struct Field
+      {
+        int offset;
+        int size;
+      };
+
+      //! Line number of the start of the record
+      long lineNumber = -1;
+      //! Fields of the record
+      std::vector< Field > fields;
+      //! UTF-8 content of the fields, with quotes and escape characters removed
+      std::string buffer;
+
+      //! Returns the number of fields of the record
+      int size() const { return static_cast< int >( fields.size() ); }
+      //! Returns TRUE if the field at index \a i is empty
+      bool isEmpty( int i ) const { return fields[i].size == 0; }
+      //! Returns the value of the field at index \a i
+      QString value( int i ) const { return QString::fromUtf8( buffer.data() + fields[i].offset, fields[i].size ); }
+    };
+
+    //! Positions of lines in the file, as pairs of a line number and of the offset in bytes of the next line
+    typedef QVector< QPair< long, qint64 > > LineOffsets;
+
     explicit QgsDelimitedTextFile( const QString &url = QString() );
 
     ~QgsDelimitedTextFile() override;
@@ -341,6 +381,86 @@ class QgsDelimitedTextFile : public QObject
 
     void setUseWatcher( bool useWatcher );
 
+    /**
+     * Maps the file in memory, to tokenize its records with nextMappedRecord().
+     *
+     * The mapping is only used for CSV type files encoded in UTF-8 whose delimiter, quote
+     * and escape characters are ASCII characters. Other files must be read with nextRecord().
+     *
+     * \returns TRUE if the file can be read from the mapping
+     */
+    bool mapFile();
+
+    /**
+     * Releases the memory mapping of the file
+     */
+    void unmapFile();
+
+    /**
+     * Returns the size of the memory mapped file in bytes, or 0 if the file is not mapped
+     */
+    qint64 mappedSize() const { return mMappedSize; }
+
+    /**
+     * Returns the offset of the first line after the skipped lines and the header
+     * record in the memory mapped file
+     */
+    qint64 mappedRecordsOffset() const { return mMappedRecordsOffset; }
+
+    /**
+     * Returns the number of lines before mappedRecordsOffset()
+     */
+    long mappedRecordsLineNumber() const { return mMappedRecordsLineNumber; }
+
+    /**
+     * Returns the offset of the start of the first line at or after \a offset in the
+     * memory mapped file. Note that this line can be inside a multiline quoted field.
+     */
+    qint64 nextMappedLine( qint64 offset ) const;
+
+    /**
+     * Tokenizes the next record of the memory mapped file, in the same way as nextRecord().
+     *
+     * This method does not modify the state of the file and can be called from several threads,
+     * e.g. to read the records of different parts of the file in parallel.
+     *
+     *  \param offset  Offset of the start of a line, updated to the offset of the line following the record
+     *  \param boundary Offset before which the record must start, blank lines up to this offset are skipped
+     *  \param lineNumber Number of lines before \a offset, updated with the lines read
+     *  \param record Record receiving the fields
+     *  \param maxFieldCount Updated with the maximum number of non empty fields of the record, see fieldNames()
+     *  \returns status RecordOk if a record was read, RecordEOF if no record starts before the boundary,
+     *                  RecordInvalid if the record is ill-formatted, or InvalidDefinition if the record
+     *                  cannot be read from the mapping in the same way as nextRecord() would, in which case
+     *                  the file must be read with nextRecord() instead.
+     */
+    Status nextMappedRecord( qint64 &offset, qint64 boundary, long &lineNumber, MappedRecord &record, int &maxFieldCount ) const;
+
+    /**
+     * Extends the field names as if a record with \a count non empty fields had been
+     * read, e.g. after reading the records with nextMappedRecord().
+     */
+    void updateMaxFieldCount( int count );
+
+    /**
+     * Sets the offsets of lines of the file, used to move to a record without reading
+     * all the lines before it.
+     *
+     *  \param offsets The line offsets, ordered by line number
+     *  \param eolChar The first end of line character of the file, '\r' if the file lines end with "\r" or "\r\n"
+     */
+    void setLineOffsets( const LineOffsets &offsets, QChar eolChar );
+
+    /**
+     * Returns the line offsets set with setLineOffsets()
+     */
+    LineOffsets lineOffsets() const { return mLineOffsets; }
+
+    /**
+     * Returns the first end of line character of the file, or a null character if it is not known yet
+     */
+    QChar eolChar() const { return mFirstEOLChar; }
+
   signals:
 
     /**
@@ -398,6 +518,19 @@ class QgsDelimitedTextFile : public QObject
      */
     void appendField( QStringList &record, QString field, bool quoted = false );
 
+    //! Returns the end of the line starting at \a line in the memory mapped file
+    const char *mappedLineEnd( const char *line ) const;
+    //! Returns the start of the line following the line ending at \a lineEnd in the memory mapped file
+    const char *mappedNextLineStart( const char *lineEnd ) const;
+
+    //! Classes of the ASCII characters in the memory mapped file
+    enum MappedCharClass
+    {
+      MappedDelimiter = 1,
+      MappedQuote = 2,
+      MappedEscape = 4
+    };
+
     // Pointer to the currently selected parser
     Status( QgsDelimitedTextFile::*mParser )( QString &buffer, QStringList &fields );
 
@@ -442,6 +575,18 @@ class QgsDelimitedTextFile : public QObject
 
     QString mDefaultFieldName;
     QRegExp mDefaultFieldRegexp;
+
+    // Memory mapping of the file
+    std::unique_ptr< QFile > mMappedFile;
+    const char *mMappedData = nullptr;
+    qint64 mMappedSize = 0;
+    char mMappedEolChar = '\n';
+    unsigned char mMappedCharClass[128];
+    qint64 mMappedRecordsOffset = 0;
+    long mMappedRecordsLineNumber = 0;
+
+    // Known positions of lines, used to seek to records
+    LineOffsets mLineOffsets;
 };
 
 #endif
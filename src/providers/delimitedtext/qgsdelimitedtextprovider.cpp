@@ -18,9 +18,13 @@
 #include "qgsdelimitedtextprovider.h"
 
 #include <QtGlobal>
+#include <QtConcurrent>
+#include <QCryptographicHash>
+#include <QDir>
 #include <QFile>
 #include <QFileInfo>
 #include <QDataStream>
+#include <QSaveFile>
 #include <QTextStream>
 #include <QStringList>
 #include <QSettings>
@@ -39,7 +43,6 @@
 #include "qgsmessagelog.h"
 #include "qgsmessageoutput.h"
 #include "qgsrectangle.h"
-#include "qgsspatialindex.h"
 #include "qgis.h"
 #include "qgsexpressioncontextutils.h"
 #include "qgsproviderregistry.h"
@@ -59,6 +62,380 @@ static const int SUBSET_ID_THRESHOLD_FACTOR = 10;
 QRegExp QgsDelimitedTextProvider::sWktPrefixRegexp( "^\\s*(?:\\d+\\s+|SRID\\=\\d+\\;)", Qt::CaseInsensitive );
 QRegExp QgsDelimitedTextProvider::sCrdDmsRegexp( "^\\s*(?:([-+nsew])\\s*)?(\\d{1,3})(?:[^0-9.]+([0-5]?\\d))?[^0-9.]+([0-5]?\\d(?:\\.\\d+)?)[^0-9.]*([-+nsew])?\\s*$", Qt::CaseInsensitive );
 
+// Size of the parts of the file scanned in parallel
+static const qint64 SCAN_PART_SIZE = 8 * 1024 * 1024;
+
+// Distance in bytes between the line positions kept to seek to the features
+static const qint64 LINE_OFFSET_INTERVAL = 64 * 1024;
+
+// The results of the scan of files smaller than this are not stored, as scanning
+// them again is fast enough
+static const qint64 SCAN_INDEX_MINIMUM_SIZE = 16 * 1024 * 1024;
+
+static const quint32 SCAN_INDEX_MAGIC = 0x51445449; // "QDTI"
+static const quint32 SCAN_INDEX_VERSION = 1;
+
+///@cond PRIVATE
+
+/**
+ * Possible types of a column, from the values of a part of the file.
+ *
+ * The types are tested in the same order as if all the values of the file were
+ * read sequentially, so that the types of consecutive parts of the file can be merged.
+ */
+struct QgsDelimitedTextProvider::ColumnTypes
+{
+  enum Flag
+  {
+    NotEmpty = 1,
+    Int = 2,
+    LongLong = 4,
+    Double = 8,
+    DateTime = 16,
+    Date = 32,
+    Time = 64,
+    AllDate = 128,
+    AllTime = 256,
+  };
+
+  bool isEmpty = true;
+  bool couldBeInt = false;
+  bool couldBeLongLong = false;
+  bool couldBeDouble = false;
+  bool couldBeDateTime = false;
+  // Dates and times are tested from the first value which is not a datetime
+  bool couldBeDate = false;
+  bool couldBeTime = false;
+  // Dates and times tested for all the values, used when merging with a previous part whose values are all datetimes
+  bool allDate = false;
+  bool allTime = false;
+
+  static bool isTime( const QString &value );
+
+  //! Returns TRUE if the types still depend on the next values
+  bool needsValue() const
+  {
+    return isEmpty || couldBeInt || couldBeLongLong || couldBeDouble || couldBeDateTime || couldBeDate || couldBeTime || allDate || allTime;
+  }
+
+  void addValue( QString &value, bool detectTypes, const QString &decimalPoint );
+
+  //! Merges the types of the values of the \a next part of the file
+  void merge( const ColumnTypes &next );
+
+  QString typeName() const;
+
+  int flags() const;
+  void setFlags( int flags );
+};
+
+bool QgsDelimitedTextProvider::ColumnTypes::isTime( const QString &value )
+{
+#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
+  QTime t = QTime::fromString( value );
+  return t.isValid();
+#else
+  // Accept 12:34, 12:34:56 or 12:34:56.789
+  // We do not use QTime::fromString() with Qt < 5.14 as it accepts
+  // strings like 01/03/2004 as valid times
+  bool couldBeTime = value.length() >= 5 &&
+                     value[0] >= '0' && value[0] <= '2' &&
+                     value[1] >= '0' && value[1] <= '9' &&
+                     value[2] == ':' &&
+                     value[3] >= '0' && value[3] <= '5' &&
+                     value[4] >= '0' && value[4] <= '9';
+  if ( couldBeTime && value.length() == 5 )
+  {
+    // ok
+  }
+  else if ( couldBeTime && value.length() >= 8 )
+  {
+    couldBeTime = value[5] == ':' &&
+                  value[6] >= '0' && value[6] <= '6' &&
+                  value[7] >= '0' && value[7] <= '9';
+    if ( couldBeTime && value.length() == 8 )
+    {
+      // ok
+    }
+    else if ( couldBeTime && value.length() >= 9 )
+    {
+      couldBeTime = value[8] == '.';
+    }
+    else
+    {
+      couldBeTime = false;
+    }
+  }
+  else
+  {
+    couldBeTime = false;
+  }
+  return couldBeTime;
+#endif
+}
+
+void QgsDelimitedTextProvider::ColumnTypes::addValue( QString &value, bool detectTypes, const QString &decimalPoint )
+{
+  // If this column has been empty so far then initialize it
+  // for possible types
+
+  if ( isEmpty )
+  {
+    isEmpty = false;
+    couldBeInt = true;
+    couldBeLongLong = true;
+    couldBeDouble = true;
+    couldBeDateTime = true;
+    couldBeDate = true;
+    couldBeTime = true;
+    allDate = true;
+    allTime = true;
+  }
+
+  if ( ! detectTypes )
+  {
+    return;
+  }
+
+  // Now test for still valid possible types for the field
+  // Types are possible until first record which cannot be parsed
+
+  if ( couldBeInt )
+  {
+    ( void )value.toInt( &couldBeInt );
+  }
+
+  if ( couldBeLongLong && !couldBeInt )
+  {
+    ( void )value.toLongLong( &couldBeLongLong );
+  }
+
+  if ( couldBeDouble && !couldBeLongLong )
+  {
+    if ( ! decimalPoint.isEmpty() )
+    {
+      value.replace( decimalPoint, QLatin1String( "." ) );
+    }
+    ( void )value.toDouble( &couldBeDouble );
+  }
+
+  if ( couldBeDateTime )
+  {
+    QDateTime dt;
+    if ( value.length() > 10 )
+    {
+      dt = QDateTime::fromString( value, Qt::ISODate );
+    }
+    couldBeDateTime = ( dt.isValid() );
+  }
+
+  if ( ( couldBeDate && !couldBeDateTime ) || allDate )
+  {
+    const bool isDate = QDate::fromString( value, Qt::ISODate ).isValid();
+    allDate = allDate && isDate;
+    if ( !couldBeDateTime )
+      couldBeDate = couldBeDate && isDate;
+  }
+
+  if ( ( couldBeTime && !couldBeDateTime ) || allTime )
+  {
+    const bool isTimeValue = isTime( value );
+    allTime = allTime && isTimeValue;
+    if ( !couldBeDateTime )
+      couldBeTime = couldBeTime && isTimeValue;
+  }
+}
+
+void QgsDelimitedTextProvider::ColumnTypes::merge( const ColumnTypes &next )
+{
+  if ( next.isEmpty )
+    return;
+  if ( isEmpty )
+  {
+    *this = next;
+    return;
+  }
+
+  couldBeInt = couldBeInt && next.couldBeInt;
+  couldBeLongLong = couldBeLongLong && next.couldBeLongLong;
+  couldBeDouble = couldBeDouble && next.couldBeDouble;
+  // If all the previous values are datetimes, the dates and times are tested from the first value of the next part which is not a datetime
+  couldBeDate = couldBeDateTime ? next.couldBeDate : couldBeDate && next.allDate;
+  couldBeTime = couldBeDateTime ? next.couldBeTime : couldBeTime && next.allTime;
+  allDate = allDate && next.allDate;
+  allTime = allTime && next.allTime;
+  couldBeDateTime = couldBeDateTime && next.couldBeDateTime;
+}
+
+QString QgsDelimitedTextProvider::ColumnTypes::typeName() const
+{
+  if ( couldBeInt )
+    return QStringLiteral( "integer" );
+  else if ( couldBeLongLong )
+    return QStringLiteral( "longlong" );
+  else if ( couldBeDouble )
+    return QStringLiteral( "double" );
+  else if ( couldBeDateTime )
+    return QStringLiteral( "datetime" );
+  else if ( couldBeDate )
+    return QStringLiteral( "date" );
+  else if ( couldBeTime )
+    return QStringLiteral( "time" );
+  return QStringLiteral( "text" );
+}
+
+int QgsDelimitedTextProvider::ColumnTypes::flags() const
+{
+  return ( isEmpty ? 0 : NotEmpty ) | ( couldBeInt ? Int : 0 ) | ( couldBeLongLong ? LongLong : 0 ) | ( couldBeDouble ? Double : 0 )
+         | ( couldBeDateTime ? DateTime : 0 ) | ( couldBeDate ? Date : 0 ) | ( couldBeTime ? Time : 0 )
+         | ( allDate ? AllDate : 0 ) | ( allTime ? AllTime : 0 );
+}
+
+void QgsDelimitedTextProvider::ColumnTypes::setFlags( int flags )
+{
+  isEmpty = !( flags & NotEmpty );
+  couldBeInt = flags & Int;
+  couldBeLongLong = flags & LongLong;
+  couldBeDouble = flags & Double;
+  couldBeDateTime = flags & DateTime;
+  couldBeDate = flags & Date;
+  couldBeTime = flags & Time;
+  allDate = flags & AllDate;
+  allTime = flags & AllTime;
+}
+
+/**
+ * Results of the scan of a part of the file.
+ *
+ * The line numbers and record ids of a part are relative to the start of the part, until
+ * the part is merged in the scan of the whole file.
+ */
+struct QgsDelimitedTextProvider::ScanPart
+{
+  // Records starting from offset start, and before offset boundary, of the memory mapped file are scanned
+  qint64 start = 0;
+  qint64 boundary = 0;
+  // Offset of the line following the last record of the part
+  qint64 end = 0;
+  // Number of lines of the part, including blank lines
+  long lineCount = 0;
+  // TRUE if the records cannot be read from the memory mapped file
+  bool unsupported = false;
+
+  long recordCount = 0;
+  int maxFieldCount = 0;
+  long nEmptyRecords = 0;
+  long nBadFormatRecords = 0;
+  long nIncompatibleGeometry = 0;
+  long nInvalidGeometry = 0;
+  long nEmptyGeometry = 0;
+  long numberFeatures = 0;
+
+  bool foundFirstGeometry = false;
+  // TRUE if the extent is built from points rather than from bounding boxes
+  bool pointExtent = false;
+  QgsRectangle extent;
+  QgsWkbTypes::Type firstWkbType = QgsWkbTypes::Unknown;
+  QgsWkbTypes::Type lastMultipartWkbType = QgsWkbTypes::Unknown;
+  QgsWkbTypes::GeometryType geometryType = QgsWkbTypes::UnknownGeometry;
+  bool wktHasPrefix = false;
+
+  QVector< ColumnTypes > columns;
+  QList< quintptr > subsetIndex;
+  QVector< QPair< QgsFeatureId, QgsRectangle > > spatialIndexEntries;
+  // Invalid lines, as the line number and the message with a %1 placeholder for the line number
+  QVector< QPair< long, QString > > invalidLines;
+  long extraInvalidLines = 0;
+
+  QChar eolChar;
+  QgsDelimitedTextFile::LineOffsets lineOffsets;
+
+  void addInvalidLine( long lineNumber, const QString &message, int maxInvalidLines )
+  {
+    if ( invalidLines.size() < maxInvalidLines )
+      invalidLines.append( qMakePair( lineNumber, message ) );
+    else
+      extraInvalidLines++;
+  }
+
+  //! Merges the following \a part of the file, which starts after \a lineBase lines
+  void merge( const ScanPart &part, long lineBase, int maxInvalidLines );
+};
+
+void QgsDelimitedTextProvider::ScanPart::merge( const ScanPart &part, long lineBase, int maxInvalidLines )
+{
+  recordCount += part.recordCount;
+  maxFieldCount = std::max( maxFieldCount, part.maxFieldCount );
+  nEmptyRecords += part.nEmptyRecords;
+  nBadFormatRecords += part.nBadFormatRecords;
+  nIncompatibleGeometry += part.nIncompatibleGeometry;
+  nInvalidGeometry += part.nInvalidGeometry;
+  nEmptyGeometry += part.nEmptyGeometry;
+  numberFeatures += part.numberFeatures;
+
+  if ( part.foundFirstGeometry )
+  {
+    if ( !foundFirstGeometry )
+    {
+      extent = part.extent;
+      firstWkbType = part.firstWkbType;
+      pointExtent = part.pointExtent;
+      foundFirstGeometry = true;
+    }
+    else if ( part.pointExtent )
+    {
+      extent.combineExtentWith( part.extent.xMinimum(), part.extent.yMinimum() );
+      extent.combineExtentWith( part.extent.xMaximum(), part.extent.yMaximum() );
+    }
+    else
+    {
+      extent.combineExtentWith( part.extent );
+    }
+  }
+  if ( part.lastMultipartWkbType != QgsWkbTypes::Unknown )
+    lastMultipartWkbType = part.lastMultipartWkbType;
+  if ( geometryType == QgsWkbTypes::UnknownGeometry )
+    geometryType = part.geometryType;
+  wktHasPrefix = wktHasPrefix || part.wktHasPrefix;
+
+  if ( columns.size() < part.columns.size() )
+    columns.resize( part.columns.size() );
+  for ( int i = 0; i < part.columns.size(); ++i )
+    columns[i].merge( part.columns.at( i ) );
+
+  for ( quintptr id : part.subsetIndex )
+    subsetIndex.append( id + lineBase );
+  for ( const QPair< QgsFeatureId, QgsRectangle > &entry : part.spatialIndexEntries )
+    spatialIndexEntries.append( qMakePair( entry.first + lineBase, entry.second ) );
+  for ( const QPair< long, QString > &invalidLine : part.invalidLines )
+    addInvalidLine( invalidLine.first + lineBase, invalidLine.second, maxInvalidLines );
+  extraInvalidLines += part.extraInvalidLines;
+
+  // The position of the first line cannot be used to seek, as the end of line character is detected on the first line
+  for ( const QPair< long, qint64 > &offset : part.lineOffsets )
+  {
+    if ( offset.first + lineBase > 0 )
+      lineOffsets.append( qMakePair( offset.first + lineBase, offset.second ) );
+  }
+
+  end = part.end;
+  lineCount += part.lineCount;
+}
+
+/**
+ * Adapter of the records read by QgsDelimitedTextFile::nextRecord() for QgsDelimitedTextProvider::scanRecord()
+ */
+struct QgsDelimitedTextStringListRecord
+{
+  const QStringList &fields;
+
+  int size() const { return fields.size(); }
+  bool isEmpty( int i ) const { return fields.at( i ).isEmpty(); }
+  QString value( int i ) const { return fields.at( i ); }
+};
+
+///@endcond
+
 QgsDelimitedTextProvider::QgsDelimitedTextProvider( const QString &uri, const ProviderOptions &options, QgsDataProvider::ReadFlags flags )
   : QgsVectorDataProvider( uri, options, flags )
 {
@@ -268,8 +645,7 @@ void QgsDelimitedTextProvider::resetIndexes() const
   mUseSpatialIndex = false;
 
   mSubsetIndex.clear();
-  if ( mBuildSpatialIndex && mGeomRep != GeomNone )
-    mSpatialIndex = qgis::make_unique< QgsSpatialIndex >();
+  mSpatialIndex = QgsPackedSpatialIndex();
 }
 
 bool QgsDelimitedTextProvider::createSpatialIndex()
@@ -290,7 +666,7 @@ bool QgsDelimitedTextProvider::createSpatialIndex()
 
 QgsFeatureSource::SpatialIndexPresence QgsDelimitedTextProvider::hasSpatialIndex() const
 {
-  return mSpatialIndex ? QgsFeatureSource::SpatialIndexPresent : QgsFeatureSource::SpatialIndexNotPresent;
+  return mBuildSpatialIndex && mGeomRep != GeomNone ? QgsFeatureSource::SpatialIndexPresent : QgsFeatureSource::SpatialIndexNotPresent;
 }
 
 // Really want to merge scanFile and rescan into single code.  Currently the reason
@@ -318,7 +694,7 @@ void QgsDelimitedTextProvider::scanFile( bool buildIndexes )
   // Initiallize indexes
 
   resetIndexes();
-  bool buildSpatialIndex = buildIndexes && nullptr != mSpatialIndex;
+  bool buildSpatialIndex = buildIndexes && mBuildSpatialIndex && mGeomRep != GeomNone;
 
   // No point building a subset index if there is no geometry, as all
   // records will be included.
@@ -391,310 +767,55 @@ void QgsDelimitedTextProvider::scanFile( bool buildIndexes )
   // 4) the type of each field
   //
   // Also build subset and spatial indexes.
+  //
+  // The results are read from a previous scan of the file if it has not been modified
+  // since then, and so is the spatial index, which is memory mapped instead of being built again.
 
-  QStringList parts;
-  long nEmptyRecords = 0;
-  long nBadFormatRecords = 0;
-  long nIncompatibleGeometry = 0;
-  long nInvalidGeometry = 0;
-  long nEmptyGeometry = 0;
-  mNumberFeatures = 0;
-  mExtent = QgsRectangle();
-
-  QList<bool> isEmpty;
-  QList<bool> couldBeInt;
-  QList<bool> couldBeLongLong;
-  QList<bool> couldBeDouble;
-  QList<bool> couldBeDateTime;
-  QList<bool> couldBeDate;
-  QList<bool> couldBeTime;
+  const QgsPackedSpatialIndex storedSpatialIndex = buildSpatialIndex ? readSpatialIndex() : QgsPackedSpatialIndex();
+  const bool scanSpatialIndex = buildSpatialIndex && ! storedSpatialIndex.isValid();
 
-  bool foundFirstGeometry = false;
-
-  while ( true )
+  ScanPart scan;
+  scan.geometryType = mGeometryType;
+  if ( scanSpatialIndex || ! readScanIndex( scan, buildSubsetIndex ) )
   {
-    QgsDelimitedTextFile::Status status = mFile->nextRecord( parts );
-    if ( status == QgsDelimitedTextFile::RecordEOF )
-      break;
-    if ( status != QgsDelimitedTextFile::RecordOk )
-    {
-      nBadFormatRecords++;
-      recordInvalidLine( tr( "Invalid record format at line %1" ) );
-      continue;
-    }
-    // Skip over empty records
-    if ( recordIsEmpty( parts ) )
-    {
-      nEmptyRecords++;
-      continue;
-    }
-
-    // Check geometries are valid
-    bool geomValid = true;
-
-    if ( mGeomRep == GeomAsWkt )
-    {
-      if ( mWktFieldIndex >= parts.size() || parts[mWktFieldIndex].isEmpty() )
-      {
-        nEmptyGeometry++;
-        mNumberFeatures++;
-      }
-      else
-      {
-        // Get the wkt - confirm it is valid, get the type, and
-        // if compatible with the rest of file, add to the extents
-
-        QString sWkt = parts[mWktFieldIndex];
-        QgsGeometry geom;
-        if ( !mWktHasPrefix && sWkt.indexOf( sWktPrefixRegexp ) >= 0 )
-          mWktHasPrefix = true;
-        geom = geomFromWkt( sWkt, mWktHasPrefix );
-
-        if ( !geom.isNull() )
-        {
-          QgsWkbTypes::Type type = geom.wkbType();
-          if ( type != QgsWkbTypes::NoGeometry )
-          {
-            if ( mGeometryType == QgsWkbTypes::UnknownGeometry || geom.type() == mGeometryType )
-            {
-              mGeometryType = geom.type();
-              if ( !foundFirstGeometry )
-              {
-                mNumberFeatures++;
-                mWkbType = type;
-                mExtent = geom.boundingBox();
-                foundFirstGeometry = true;
-              }
-              else
-              {
-                mNumberFeatures++;
-                if ( geom.isMultipart() )
-                  mWkbType = type;
-                QgsRectangle bbox( geom.boundingBox() );
-                mExtent.combineExtentWith( bbox );
-              }
-              if ( buildSpatialIndex )
-              {
-                QgsFeature f;
-                f.setId( mFile->recordId() );
-                f.setGeometry( geom );
-                mSpatialIndex->addFeature( f );
-              }
-            }
-            else
-            {
-              nIncompatibleGeometry++;
-              geomValid = false;
-            }
-          }
-        }
-        else
-        {
-          geomValid = false;
-          nInvalidGeometry++;
-          recordInvalidLine( tr( "Invalid WKT at line %1" ) );
-        }
-      }
-    }
-    else if ( mGeomRep == GeomAsXy )
-    {
-      // Get the x and y values, first checking to make sure they
-      // aren't null.
-
-      QString sX = mXFieldIndex < parts.size() ? parts[mXFieldIndex] : QString();
-      QString sY = mYFieldIndex < parts.size() ? parts[mYFieldIndex] : QString();
-      QString sZ, sM;
-      if ( mZFieldIndex > -1 )
-        sZ = mZFieldIndex < parts.size() ? parts[mZFieldIndex] : QString();
-      if ( mMFieldIndex > -1 )
-        sM = mMFieldIndex < parts.size() ? parts[mMFieldIndex] : QString();
-      if ( sX.isEmpty() && sY.isEmpty() )
-      {
-        nEmptyGeometry++;
-        mNumberFeatures++;
-      }
-      else
-      {
-        QgsPoint pt;
-        bool ok = pointFromXY( sX, sY, pt, mDecimalPoint, mXyDms );
-
-        if ( ok )
-        {
-          if ( !sZ.isEmpty() || sM.isEmpty() )
-            appendZM( sZ, sM, pt, mDecimalPoint );
-
-          if ( foundFirstGeometry )
-          {
-            mExtent.combineExtentWith( pt.x(), pt.y() );
-          }
-          else
-          {
-            // Extent for the first point is just the first point
-            mExtent.set( pt.x(), pt.y(), pt.x(), pt.y() );
-            mWkbType = QgsWkbTypes::Point;
-            if ( mZFieldIndex > -1 )
-              mWkbType = QgsWkbTypes::addZ( mWkbType );
-            if ( mMFieldIndex > -1 )
-              mWkbType = QgsWkbTypes::addM( mWkbType );
-            mGeometryType = QgsWkbTypes::PointGeometry;
-            foundFirstGeometry = true;
-          }
-          mNumberFeatures++;
-          if ( buildSpatialIndex && std::isfinite( pt.x() ) && std::isfinite( pt.y() ) )
-          {
-            QgsFeature f;
-            f.setId( mFile->recordId() );
-            f.setGeometry( QgsGeometry::fromPointXY( pt ) );
-            mSpatialIndex->addFeature( f );
-          }
-        }
-        else
-        {
-          geomValid = false;
-          nInvalidGeometry++;
-          recordInvalidLine( tr( "Invalid X or Y fields at line %1" ) );
-        }
-      }
-    }
-    else
+    if ( ! scanMappedFile( scan, scanSpatialIndex, buildSubsetIndex ) )
     {
-      mWkbType = QgsWkbTypes::NoGeometry;
-      mNumberFeatures++;
+      scan = ScanPart();
+      scan.geometryType = mGeometryType;
+      scanSequentialFile( scan, scanSpatialIndex, buildSubsetIndex );
     }
+    writeScanIndex( scan, buildSubsetIndex );
+  }
 
-    if ( !geomValid )
-      continue;
-
-    if ( buildSubsetIndex )
-      mSubsetIndex.append( mFile->recordId() );
-
-
-    // If we are going to use this record, then assess the potential types of each column
-
-    for ( int i = 0; i < parts.size(); i++ )
-    {
-
-      QString &value = parts[i];
-      // Ignore empty fields - spreadsheet generated CSV files often
-      // have random empty fields at the end of a row
-      if ( value.isEmpty() )
-        continue;
-
-      // Expand the columns to include this non empty field if necessary
-
-      while ( couldBeInt.size() <= i )
-      {
-        isEmpty.append( true );
-        couldBeInt.append( false );
-        couldBeLongLong.append( false );
-        couldBeDouble.append( false );
-        couldBeDateTime.append( false );
-        couldBeDate.append( false );
-        couldBeTime.append( false );
-      }
-
-      // If this column has been empty so far then initiallize it
-      // for possible types
-
-      if ( isEmpty[i] )
-      {
-        isEmpty[i] = false;
-        couldBeInt[i] = true;
-        couldBeLongLong[i] = true;
-        couldBeDouble[i] = true;
-        couldBeDateTime[i] = true;
-        couldBeDate[i] = true;
-        couldBeTime[i] = true;
-      }
-
-      if ( ! mDetectTypes )
-      {
-        continue;
-      }
-
-      // Now test for still valid possible types for the field
-      // Types are possible until first record which cannot be parsed
-
-      if ( couldBeInt[i] )
-      {
-        ( void )value.toInt( &couldBeInt[i] );
-      }
-
-      if ( couldBeLongLong[i] && !couldBeInt[i] )
-      {
-        ( void )value.toLongLong( &couldBeLongLong[i] );
-      }
+  mNumberFeatures = scan.numberFeatures;
+  mExtent = QgsRectangle();
+  if ( scan.foundFirstGeometry )
+  {
+    mExtent = scan.extent;
+    mWkbType = scan.lastMultipartWkbType != QgsWkbTypes::Unknown ? scan.lastMultipartWkbType : scan.firstWkbType;
+  }
+  mGeometryType = scan.geometryType;
+  mWktHasPrefix = scan.wktHasPrefix;
 
-      if ( couldBeDouble[i] && !couldBeLongLong[i] )
-      {
-        if ( ! mDecimalPoint.isEmpty() )
-        {
-          value.replace( mDecimalPoint, QLatin1String( "." ) );
-        }
-        ( void )value.toDouble( &couldBeDouble[i] );
-      }
+  for ( const QPair< long, QString > &invalidLine : qgis::as_const( scan.invalidLines ) )
+    mInvalidLines.append( invalidLine.second.arg( invalidLine.first ) );
+  mNExtraInvalidLines = scan.extraInvalidLines;
 
-      if ( couldBeDateTime[i] )
-      {
-        QDateTime dt;
-        if ( value.length() > 10 )
-        {
-          dt = QDateTime::fromString( value, Qt::ISODate );
-        }
-        couldBeDateTime[i] = ( dt.isValid() );
-      }
+  mFile->updateMaxFieldCount( scan.maxFieldCount );
+  mFile->setLineOffsets( scan.lineOffsets, scan.eolChar );
 
-      if ( couldBeDate[i] && !couldBeDateTime[i] )
-      {
-        QDate d = QDate::fromString( value, Qt::ISODate );
-        couldBeDate[i] = d.isValid();
-      }
-
-      if ( couldBeTime[i] && !couldBeDateTime[i] )
-      {
-#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
-        QTime t = QTime::fromString( value );
-        couldBeTime[i] = t.isValid();
-#else
-        // Accept 12:34, 12:34:56 or 12:34:56.789
-        // We do not use QTime::fromString() with Qt < 5.14 as it accepts
-        // strings like 01/03/2004 as valid times
-        couldBeTime[i] = value.length() >= 5 &&
-                         value[0] >= '0' && value[0] <= '2' &&
-                         value[1] >= '0' && value[1] <= '9' &&
-                         value[2] == ':' &&
-                         value[3] >= '0' && value[3] <= '5' &&
-                         value[4] >= '0' && value[4] <= '9';
-        if ( couldBeTime[i] && value.length() == 5 )
-        {
-          // ok
-        }
-        else if ( couldBeTime[i] && value.length() >= 8 )
-        {
-          couldBeTime[i] = value[5] == ':' &&
-                           value[6] >= '0' && value[6] <= '6' &&
-                           value[7] >= '0' && value[7] <= '9';
-          if ( couldBeTime[i] && value.length() == 8 )
-          {
-            // ok
-          }
-          else if ( couldBeTime[i] && value.length() >= 9 )
-          {
-            couldBeTime[i] = value[8] == '.';
-          }
-          else
-          {
-            couldBeTime[i] = false;
-          }
-        }
-        else
-        {
-          couldBeTime[i] = false;
-        }
-#endif
-      }
-    }
+  if ( scanSpatialIndex )
+  {
+    mSpatialIndex = QgsPackedSpatialIndex( scan.spatialIndexEntries );
+    scan.spatialIndexEntries.clear();
+    writeSpatialIndex( mSpatialIndex );
+  }
+  else if ( buildSpatialIndex )
+  {
+    mSpatialIndex = storedSpatialIndex;
   }
+  if ( buildSubsetIndex )
+    mSubsetIndex = scan.subsetIndex;
 
   // Now create the attribute fields.  Field types are determined by prioritizing
   // integer, failing that double, datetime, date, time, and finally text.
@@ -720,32 +841,9 @@ void QgsDelimitedTextProvider::scanFile( bool buildIndexes )
     {
       typeName = csvtTypes[i];
     }
-    else if ( mDetectTypes && i < couldBeInt.size() )
+    else if ( mDetectTypes && i < scan.columns.size() )
     {
-      if ( couldBeInt[i] )
-      {
-        typeName = QStringLiteral( "integer" );
-      }
-      else if ( couldBeLongLong[i] )
-      {
-        typeName = QStringLiteral( "longlong" );
-      }
-      else if ( couldBeDouble[i] )
-      {
-        typeName = QStringLiteral( "double" );
-      }
-      else if ( couldBeDateTime[i] )
-      {
-        typeName = QStringLiteral( "datetime" );
-      }
-      else if ( couldBeDate[i] )
-      {
-        typeName = QStringLiteral( "date" );
-      }
-      else if ( couldBeTime[i] )
-      {
-        typeName = QStringLiteral( "time" );
-      }
+      typeName = scan.columns.at( i ).typeName();
     }
 
     if ( typeName == QLatin1String( "integer" ) )
@@ -788,14 +886,14 @@ void QgsDelimitedTextProvider::scanFile( bool buildIndexes )
   QStringList warnings;
   if ( ! csvtMessage.isEmpty() )
     warnings.append( csvtMessage );
-  if ( nBadFormatRecords > 0 )
-    warnings.append( tr( "%1 records discarded due to invalid format" ).arg( nBadFormatRecords ) );
-  if ( nEmptyGeometry > 0 )
-    warnings.append( tr( "%1 records have missing geometry definitions" ).arg( nEmptyGeometry ) );
-  if ( nInvalidGeometry > 0 )
-    warnings.append( tr( "%1 records discarded due to invalid geometry definitions" ).arg( nInvalidGeometry ) );
-  if ( nIncompatibleGeometry > 0 )
-    warnings.append( tr( "%1 records discarded due to incompatible geometry types" ).arg( nIncompatibleGeometry ) );
+  if ( scan.nBadFormatRecords > 0 )
+    warnings.append( tr( "%1 records discarded due to invalid format" ).arg( scan.nBadFormatRecords ) );
+  if ( scan.nEmptyGeometry > 0 )
+    warnings.append( tr( "%1 records have missing geometry definitions" ).arg( scan.nEmptyGeometry ) );
+  if ( scan.nInvalidGeometry > 0 )
+    warnings.append( tr( "%1 records discarded due to invalid geometry definitions" ).arg( scan.nInvalidGeometry ) );
+  if ( scan.nIncompatibleGeometry > 0 )
+    warnings.append( tr( "%1 records discarded due to incompatible geometry types" ).arg( scan.nIncompatibleGeometry ) );
 
   reportErrors( warnings );
 
@@ -805,7 +903,7 @@ void QgsDelimitedTextProvider::scanFile( bool buildIndexes )
 
   if ( buildSubsetIndex )
   {
-    long recordCount = mFile->recordCount();
+    long recordCount = scan.recordCount;
     recordCount -= recordCount / SUBSET_ID_THRESHOLD_FACTOR;
     mUseSubsetIndex = mSubsetIndex.size() < recordCount;
     if ( ! mUseSubsetIndex )
@@ -821,6 +919,571 @@ void QgsDelimitedTextProvider::scanFile( bool buildIndexes )
   connect( mFile.get(), &QgsDelimitedTextFile::fileUpdated, this, &QgsDelimitedTextProvider::onFileUpdated );
 }
 
+template <typename Record>
+void QgsDelimitedTextProvider::scanRecord( const Record &record, long recordId, ScanPart &part, bool buildSpatialIndex, bool buildSubsetIndex ) const
+{
+  // Skip over empty records
+  bool emptyRecord = true;
+  for ( int i = 0; i < record.size() && emptyRecord; i++ )
+    emptyRecord = record.isEmpty( i );
+  if ( emptyRecord )
+  {
+    part.nEmptyRecords++;
+    return;
+  }
+
+  // Check geometries are valid
+  bool geomValid = true;
+
+  if ( mGeomRep == GeomAsWkt )
+  {
+    if ( mWktFieldIndex >= record.size() || record.isEmpty( mWktFieldIndex ) )
+    {
+      part.nEmptyGeometry++;
+      part.numberFeatures++;
+    }
+    else
+    {
+      // Get the wkt - confirm it is valid, get the type, and
+      // if compatible with the rest of file, add to the extents
+
+      QString sWkt = record.value( mWktFieldIndex );
+      QgsGeometry geom;
+      if ( !part.wktHasPrefix && sWkt.indexOf( qgis::as_const( sWktPrefixRegexp ) ) >= 0 )
+        part.wktHasPrefix = true;
+      geom = geomFromWkt( sWkt, part.wktHasPrefix );
+
+      if ( !geom.isNull() )
+      {
+        QgsWkbTypes::Type type = geom.wkbType();
+        if ( type != QgsWkbTypes::NoGeometry )
+        {
+          if ( part.geometryType == QgsWkbTypes::UnknownGeometry || geom.type() == part.geometryType )
+          {
+            part.geometryType = geom.type();
+            QgsRectangle bbox( geom.boundingBox() );
+            if ( !part.foundFirstGeometry )
+            {
+              part.firstWkbType = type;
+              part.extent = bbox;
+              part.foundFirstGeometry = true;
+            }
+            else
+            {
+              part.extent.combineExtentWith( bbox );
+            }
+            if ( geom.isMultipart() )
+              part.lastMultipartWkbType = type;
+            part.numberFeatures++;
+            if ( buildSpatialIndex )
+            {
+              part.spatialIndexEntries.append( qMakePair( static_cast< QgsFeatureId >( recordId ), bbox ) );
+            }
+          }
+          else
+          {
+            part.nIncompatibleGeometry++;
+            geomValid = false;
+          }
+        }
+      }
+      else
+      {
+        geomValid = false;
+        part.nInvalidGeometry++;
+        part.addInvalidLine( recordId, tr( "Invalid WKT at line %1" ), mMaxInvalidLines );
+      }
+    }
+  }
+  else if ( mGeomRep == GeomAsXy )
+  {
+    // Get the x and y values, first checking to make sure they
+    // aren't null.
+
+    QString sX = mXFieldIndex < record.size() ? record.value( mXFieldIndex ) : QString();
+    QString sY = mYFieldIndex < record.size() ? record.value( mYFieldIndex ) : QString();
+    QString sZ, sM;
+    if ( mZFieldIndex > -1 )
+      sZ = mZFieldIndex < record.size() ? record.value( mZFieldIndex ) : QString();
+    if ( mMFieldIndex > -1 )
+      sM = mMFieldIndex < record.size() ? record.value( mMFieldIndex ) : QString();
+    if ( sX.isEmpty() && sY.isEmpty() )
+    {
+      part.nEmptyGeometry++;
+      part.numberFeatures++;
+    }
+    else
+    {
+      QgsPoint pt;
+      bool ok = pointFromXY( sX, sY, pt, mDecimalPoint, mXyDms );
+
+      if ( ok )
+      {
+        if ( !sZ.isEmpty() || sM.isEmpty() )
+          appendZM( sZ, sM, pt, mDecimalPoint );
+
+        if ( part.foundFirstGeometry )
+        {
+          part.extent.combineExtentWith( pt.x(), pt.y() );
+        }
+        else
+        {
+          // Extent for the first point is just the first point
+          part.extent.set( pt.x(), pt.y(), pt.x(), pt.y() );
+          part.firstWkbType = QgsWkbTypes::Point;
+          if ( mZFieldIndex > -1 )
+            part.firstWkbType = QgsWkbTypes::addZ( part.firstWkbType );
+          if ( mMFieldIndex > -1 )
+            part.firstWkbType = QgsWkbTypes::addM( part.firstWkbType );
+          part.geometryType = QgsWkbTypes::PointGeometry;
+          part.pointExtent = true;
+          part.foundFirstGeometry = true;
+        }
+        part.numberFeatures++;
+        if ( buildSpatialIndex && std::isfinite( pt.x() ) && std::isfinite( pt.y() ) )
+        {
+          part.spatialIndexEntries.append( qMakePair( static_cast< QgsFeatureId >( recordId ), QgsRectangle( pt.x(), pt.y(), pt.x(), pt.y() ) ) );
+        }
+      }
+      else
+      {
+        geomValid = false;
+        part.nInvalidGeometry++;
+        part.addInvalidLine( recordId, tr( "Invalid X or Y fields at line %1" ), mMaxInvalidLines );
+      }
+    }
+  }
+  else
+  {
+    part.numberFeatures++;
+  }
+
+  if ( !geomValid )
+    return;
+
+  if ( buildSubsetIndex )
+    part.subsetIndex.append( recordId );
+
+  // If we are going to use this record, then assess the potential types of each column.
+  // The values are only converted to strings while they can change the types.
+
+  for ( int i = 0; i < record.size(); i++ )
+  {
+    // Ignore empty fields - spreadsheet generated CSV files often
+    // have random empty fields at the end of a row
+    if ( record.isEmpty( i ) )
+      continue;
+
+    // Expand the columns to include this non empty field if necessary
+    if ( part.columns.size() <= i )
+      part.columns.resize( i + 1 );
+
+    ColumnTypes &column = part.columns[i];
+    if ( column.isEmpty || ( mDetectTypes && column.needsValue() ) )
+    {
+      QString value = record.value( i );
+      column.addValue( value, mDetectTypes, mDecimalPoint );
+    }
+  }
+}
+
+void QgsDelimitedTextProvider::scanSequentialFile( ScanPart &scan, bool buildSpatialIndex, bool buildSubsetIndex ) const
+{
+  QStringList parts;
+  while ( true )
+  {
+    QgsDelimitedTextFile::Status status = mFile->nextRecord( parts );
+    if ( status == QgsDelimitedTextFile::RecordEOF )
+      break;
+    if ( status != QgsDelimitedTextFile::RecordOk )
+    {
+      scan.nBadFormatRecords++;
+      scan.addInvalidLine( mFile->recordId(), tr( "Invalid record format at line %1" ), mMaxInvalidLines );
+      continue;
+    }
+    scanRecord( QgsDelimitedTextStringListRecord { parts }, mFile->recordId(), scan, buildSpatialIndex, buildSubsetIndex );
+  }
+  scan.recordCount = mFile->recordCount();
+}
+
+bool QgsDelimitedTextProvider::scanMappedFile( ScanPart &scan, bool buildSpatialIndex, bool buildSubsetIndex ) const
+{
+  if ( ! mFile->mapFile() )
+    return false;
+
+  // Used for tests
+  const QString partSizeStr( getenv( "QGIS_DELIMITED_TEXT_SCAN_PART_SIZE" ) );
+  const qint64 partSize = std::max< qint64 >( 1, partSizeStr.isEmpty() ? SCAN_PART_SIZE : partSizeStr.toLongLong() );
+
+  // Split the file in parts starting at the start of a line. As a line may be
+  // inside a multiline quoted field, the parts are checked after the scan.
+  std::vector< ScanPart > parts;
+  const qint64 size = mFile->mappedSize();
+  qint64 start = mFile->mappedRecordsOffset();
+  do
+  {
+    ScanPart part;
+    part.start = start;
+    part.boundary = mFile->nextMappedLine( start + partSize );
+    part.geometryType = mGeometryType;
+    parts.push_back( part );
+    start = part.boundary;
+  }
+  while ( start < size );
+
+  // The type of WKT geometries is defined by the first valid geometry, so the first
+  // parts are scanned one after the other until it is known
+  std::size_t firstParallelPart = 0;
+  if ( mGeomRep == GeomAsWkt )
+  {
+    QgsWkbTypes::GeometryType geometryType = mGeometryType;
+    for ( ; firstParallelPart < parts.size() && geometryType == QgsWkbTypes::UnknownGeometry; ++firstParallelPart )
+    {
+      ScanPart &part = parts[firstParallelPart];
+      if ( firstParallelPart > 0 )
+      {
+        part.start = parts[firstParallelPart - 1].end;
+        part.boundary = std::max( part.start, part.boundary );
+      }
+      scanMappedPart( part, buildSpatialIndex, buildSubsetIndex );
+      if ( part.unsupported )
+      {
+        mFile->unmapFile();
+        return false;
+      }
+      geometryType = part.geometryType;
+    }
+    for ( std::size_t i = firstParallelPart; i < parts.size(); ++i )
+      parts[i].geometryType = geometryType;
+  }
+
+  QtConcurrent::blockingMap( parts.begin() + firstParallelPart, parts.end(), [this, buildSpatialIndex, buildSubsetIndex]( ScanPart & part )
+  {
+    scanMappedPart( part, buildSpatialIndex, buildSubsetIndex );
+  } );
+
+  scan.start = mFile->mappedRecordsOffset();
+  scan.end = scan.start;
+  long lineBase = mFile->mappedRecordsLineNumber();
+  for ( ScanPart &part : parts )
+  {
+    // If the previous part ended after the start of this part (i.e. this part started inside
+    // a multiline quoted field), then this part is scanned again from the end of the previous one
+    if ( part.start != scan.end )
+    {
+      ScanPart rescan;
+      rescan.start = scan.end;
+      rescan.boundary = std::max( scan.end, part.boundary );
+      rescan.geometryType = scan.geometryType;
+      scanMappedPart( rescan, buildSpatialIndex, buildSubsetIndex );
+      part = std::move( rescan );
+    }
+    if ( part.unsupported )
+    {
+      mFile->unmapFile();
+      return false;
+    }
+    scan.merge( part, lineBase, mMaxInvalidLines );
+    lineBase += part.lineCount;
+  }
+  scan.eolChar = mFile->eolChar();
+
+  mFile->unmapFile();
+  return true;
+}
+
+void QgsDelimitedTextProvider::scanMappedPart( ScanPart &part, bool buildSpatialIndex, bool buildSubsetIndex ) const
+{
+  QgsDelimitedTextFile::MappedRecord record;
+  qint64 offset = part.start;
+  qint64 nextLineOffset = part.start;
+  long lineNumber = 0;
+  while ( true )
+  {
+    // Keep the position of some records, to seek to the features without reading all the lines before them
+    if ( offset >= nextLineOffset )
+    {
+      part.lineOffsets.append( qMakePair( lineNumber, offset ) );
+      nextLineOffset = offset + LINE_OFFSET_INTERVAL;
+    }
+
+    QgsDelimitedTextFile::Status status = mFile->nextMappedRecord( offset, part.boundary, lineNumber, record, part.maxFieldCount );
+    if ( status == QgsDelimitedTextFile::RecordEOF )
+      break;
+    if ( status == QgsDelimitedTextFile::InvalidDefinition )
+    {
+      part.unsupported = true;
+      return;
+    }
+    part.recordCount++;
+    if ( status != QgsDelimitedTextFile::RecordOk )
+    {
+      part.nBadFormatRecords++;
+      part.addInvalidLine( record.lineNumber, tr( "Invalid record format at line %1" ), mMaxInvalidLines );
+      continue;
+    }
+    scanRecord( record, record.lineNumber, part, buildSpatialIndex, buildSubsetIndex );
+  }
+  part.end = offset;
+  part.lineCount = lineNumber;
+}
+
+QString QgsDelimitedTextProvider::scanIndexPath() const
+{
+  // Used for tests
+  const QString minimumSizeStr( getenv( "QGIS_DELIMITED_TEXT_INDEX_MINIMUM_SIZE" ) );
+  const qint64 minimumSize = minimumSizeStr.isEmpty() ? SCAN_INDEX_MINIMUM_SIZE : minimumSizeStr.toLongLong();
+
+  const QFileInfo fileInfo( mFile->fileName() );
+  if ( ! fileInfo.isFile() || fileInfo.size() < minimumSize )
+    return QString();
+
+  const QByteArray hash = QCryptographicHash::hash( fileInfo.absoluteFilePath().toUtf8(), QCryptographicHash::Sha1 ).toHex();
+  return QDir( QgsApplication::qgisSettingsDirPath() ).filePath( QStringLiteral( "cache/delimitedtext/%1.index" ).arg( QString::fromLatin1( hash ) ) );
+}
+
+QString QgsDelimitedTextProvider::scanIndexKey() const
+{
+  // Parameters which do not change the results of the scan are ignored
+  QUrl url = QUrl::fromEncoded( dataSourceUri().toLatin1() );
+  QUrlQuery query( url );
+  const QStringList ignoredItems
+  {
+    QStringLiteral( "subset" ),
+    QStringLiteral( "subsetIndex" ),
+    QStringLiteral( "spatialIndex" ),
+    QStringLiteral( "watchFile" ),
+    QStringLiteral( "quiet" ),
+  };
+  for ( const QString &item : ignoredItems )
+    query.removeAllQueryItems( item );
+  url.setQuery( query );
+  return QString::fromLatin1( url.toEncoded() );
+}
+
+bool QgsDelimitedTextProvider::readScanIndex( ScanPart &scan, bool buildSubsetIndex ) const
+{
+  const QString path = scanIndexPath();
+  if ( path.isEmpty() )
+    return false;
+
+  QFile file( path );
+  if ( ! file.open( QIODevice::ReadOnly ) )
+    return false;
+
+  QDataStream in( &file );
+  in.setVersion( QDataStream::Qt_5_0 );
+
+  quint32 magic = 0;
+  quint32 version = 0;
+  in >> magic >> version;
+  if ( magic != SCAN_INDEX_MAGIC || version != SCAN_INDEX_VERSION )
+    return false;
+
+  // The index is only valid for the same definition of the layer and an unmodified file
+  const QFileInfo fileInfo( mFile->fileName() );
+  QString filePath;
+  qint64 fileSize = 0;
+  qint64 lastModified = 0;
+  QString key;
+  in >> filePath >> fileSize >> lastModified >> key;
+  if ( filePath != fileInfo.absoluteFilePath() || fileSize != fileInfo.size()
+       || lastModified != fileInfo.lastModified().toMSecsSinceEpoch() || key != scanIndexKey() )
+    return false;
+
+  bool hasSubsetIndex = false;
+  in >> hasSubsetIndex;
+  if ( buildSubsetIndex && ! hasSubsetIndex )
+    return false;
+
+  ScanPart result;
+  qint64 recordCount = 0;
+  qint64 counts[6] = {};
+  qint32 maxFieldCount = 0;
+  qint32 firstWkbType = 0;
+  qint32 lastMultipartWkbType = 0;
+  qint32 geometryType = 0;
+  in >> recordCount >> maxFieldCount;
+  for ( qint64 &count : counts )
+    in >> count;
+  in >> result.foundFirstGeometry >> result.pointExtent >> result.extent >> firstWkbType >> lastMultipartWkbType >> geometryType >> result.wktHasPrefix;
+  result.recordCount = recordCount;
+  result.maxFieldCount = maxFieldCount;
+  result.nEmptyRecords = counts[0];
+  result.nBadFormatRecords = counts[1];
+  result.nIncompatibleGeometry = counts[2];
+  result.nInvalidGeometry = counts[3];
+  result.nEmptyGeometry = counts[4];
+  result.numberFeatures = counts[5];
+  result.firstWkbType = static_cast< QgsWkbTypes::Type >( firstWkbType );
+  result.lastMultipartWkbType = static_cast< QgsWkbTypes::Type >( lastMultipartWkbType );
+  result.geometryType = static_cast< QgsWkbTypes::GeometryType >( geometryType );
+
+  qint32 columnCount = 0;
+  in >> columnCount;
+  if ( in.status() != QDataStream::Ok || columnCount < 0 )
+    return false;
+  result.columns.resize( columnCount );
+  for ( ColumnTypes &column : result.columns )
+  {
+    qint32 flags = 0;
+    in >> flags;
+    column.setFlags( flags );
+  }
+
+  qint64 subsetCount = 0;
+  in >> subsetCount;
+  if ( in.status() != QDataStream::Ok || subsetCount < 0 || subsetCount > recordCount )
+    return false;
+  for ( qint64 i = 0; i < subsetCount; ++i )
+  {
+    quint64 id = 0;
+    in >> id;
+    if ( buildSubsetIndex )
+      result.subsetIndex.append( static_cast< quintptr >( id ) );
+  }
+
+  qint32 invalidLineCount = 0;
+  qint64 extraInvalidLines = 0;
+  in >> invalidLineCount >> extraInvalidLines;
+  if ( in.status() != QDataStream::Ok || invalidLineCount < 0 || invalidLineCount > mMaxInvalidLines )
+    return false;
+  for ( qint32 i = 0; i < invalidLineCount; ++i )
+  {
+    qint64 lineNumber = 0;
+    QString message;
+    in >> lineNumber >> message;
+    result.invalidLines.append( qMakePair( static_cast< long >( lineNumber ), message ) );
+  }
+  result.extraInvalidLines = extraInvalidLines;
+
+  quint16 eolChar = 0;
+  qint32 lineOffsetCount = 0;
+  in >> eolChar >> lineOffsetCount;
+  if ( in.status() != QDataStream::Ok || lineOffsetCount < 0 )
+    return false;
+  result.eolChar = QChar( eolChar );
+  result.lineOffsets.reserve( lineOffsetCount );
+  for ( qint32 i = 0; i < lineOffsetCount; ++i )
+  {
+    qint64 lineNumber = 0;
+    qint64 offset = 0;
+    in >> lineNumber >> offset;
+    result.lineOffsets.append( qMakePair( static_cast< long >( lineNumber ), offset ) );
+  }
+
+  if ( in.status() != QDataStream::Ok )
+    return false;
+
+  QgsDebugMsgLevel( QStringLiteral( "Scan of %1 read from %2" ).arg( mFile->fileName(), path ), 2 );
+  scan = result;
+  return true;
+}
+
+void QgsDelimitedTextProvider::writeScanIndex( const ScanPart &scan, bool hasSubsetIndex ) const
+{
+  const QString path = scanIndexPath();
+  if ( path.isEmpty() )
+    return;
+
+  if ( ! QDir().mkpath( QFileInfo( path ).absolutePath() ) )
+    return;
+
+  QSaveFile file( path );
+  if ( ! file.open( QIODevice::WriteOnly ) )
+  {
+    QgsDebugMsg( QStringLiteral( "Cannot write scan index %1" ).arg( path ) );
+    return;
+  }
+
+  QDataStream out( &file );
+  out.setVersion( QDataStream::Qt_5_0 );
+
+  const QFileInfo fileInfo( mFile->fileName() );
+  out << SCAN_INDEX_MAGIC << SCAN_INDEX_VERSION;
+  out << fileInfo.absoluteFilePath() << fileInfo.size() << fileInfo.lastModified().toMSecsSinceEpoch() << scanIndexKey();
+  out << hasSubsetIndex;
+
+  out << static_cast< qint64 >( scan.recordCount ) << static_cast< qint32 >( scan.maxFieldCount );
+  const long counts[] = { scan.nEmptyRecords, scan.nBadFormatRecords, scan.nIncompatibleGeometry, scan.nInvalidGeometry, scan.nEmptyGeometry, scan.numberFeatures };
+  for ( long count : counts )
+    out << static_cast< qint64 >( count );
+  out << scan.foundFirstGeometry << scan.pointExtent << scan.extent << static_cast< qint32 >( scan.firstWkbType )
+      << static_cast< qint32 >( scan.lastMultipartWkbType ) << static_cast< qint32 >( scan.geometryType ) << scan.wktHasPrefix;
+
+  out << static_cast< qint32 >( scan.columns.size() );
+  for ( const ColumnTypes &column : scan.columns )
+    out << static_cast< qint32 >( column.flags() );
+
+  out << static_cast< qint64 >( hasSubsetIndex ? scan.subsetIndex.size() : 0 );
+  if ( hasSubsetIndex )
+  {
+    for ( quintptr id : scan.subsetIndex )
+      out << static_cast< quint64 >( id );
+  }
+
+  out << static_cast< qint32 >( scan.invalidLines.size() ) << static_cast< qint64 >( scan.extraInvalidLines );
+  for ( const QPair< long, QString > &invalidLine : scan.invalidLines )
+    out << static_cast< qint64 >( invalidLine.first ) << invalidLine.second;
+
+  out << static_cast< quint16 >( scan.eolChar.unicode() ) << static_cast< qint32 >( scan.lineOffsets.size() );
+  for ( const QPair< long, qint64 > &offset : scan.lineOffsets )
+    out << static_cast< qint64 >( offset.first ) << offset.second;
+
+  if ( out.status() != QDataStream::Ok || ! file.commit() )
+    QgsDebugMsg( QStringLiteral( "Cannot write scan index %1" ).arg( path ) );
+}
+
+QString QgsDelimitedTextProvider::spatialIndexPath() const
+{
+  const QString path = scanIndexPath();
+  if ( path.isEmpty() )
+    return QString();
+
+  const QFileInfo fileInfo( mFile->fileName() );
+  const QString version = QStringLiteral( "%1:%2:%3" ).arg( fileInfo.size() ).arg( fileInfo.lastModified().toMSecsSinceEpoch() ).arg( scanIndexKey() );
+  const QByteArray versionHash = QCryptographicHash::hash( version.toUtf8(), QCryptographicHash::Sha1 ).toHex().left( 16 );
+  const QFileInfo pathInfo( path );
+  return pathInfo.dir().filePath( QStringLiteral( "%1.%2.spatialindex" ).arg( pathInfo.completeBaseName(), QString::fromLatin1( versionHash ) ) );
+}
+
+QgsPackedSpatialIndex QgsDelimitedTextProvider::readSpatialIndex() const
+{
+  const QString path = spatialIndexPath();
+  if ( path.isEmpty() || ! QFileInfo::exists( path ) )
+    return QgsPackedSpatialIndex();
+
+  QString error;
+  QgsPackedSpatialIndex index = QgsPackedSpatialIndex::open( path, &error );
+  if ( ! index.isValid() )
+    QgsDebugMsg( QStringLiteral( "Cannot read spatial index: %1" ).arg( error ) );
+  else
+    QgsDebugMsgLevel( QStringLiteral( "Spatial index of %1 mapped from %2" ).arg( mFile->fileName(), path ), 2 );
+  return index;
+}
+
+void QgsDelimitedTextProvider::writeSpatialIndex( const QgsPackedSpatialIndex &index ) const
+{
+  const QString path = spatialIndexPath();
+  if ( path.isEmpty() || ! index.isValid() )
+    return;
+
+  const QFileInfo pathInfo( path );
+  QDir dir( pathInfo.absolutePath() );
+  if ( ! dir.mkpath( QStringLiteral( "." ) ) )
+    return;
+
+  // Indexes of previous versions of the file are never opened again
+  const QString pattern = QStringLiteral( "%1.*.spatialindex" ).arg( pathInfo.completeBaseName().section( '.', 0, 0 ) );
+  const QStringList previousIndexes = dir.entryList( QStringList() << pattern, QDir::Files );
+  for ( const QString &previousIndex : previousIndexes )
+    dir.remove( previousIndex );
+
+  QString error;
+  if ( ! index.writeToFile( path, &error ) )
+    QgsDebugMsg( QStringLiteral( "Cannot write spatial index: %1" ).arg( error ) );
+}
+
 // rescanFile.  Called if something has changed file definition, such as
 // selecting a subset, the file has been changed by another program, etc
 
@@ -829,9 +1492,14 @@ void QgsDelimitedTextProvider::rescanFile() const
   mRescanRequired = false;
   resetIndexes();
 
-  bool buildSpatialIndex = nullptr != mSpatialIndex;
+  bool buildSpatialIndex = mBuildSpatialIndex && mGeomRep != GeomNone;
   bool buildSubsetIndex = mBuildSubsetIndex && ( mSubsetExpression || mGeomRep != GeomNone );
 
+  // Without subset the spatial index covers all the records, so the one stored for the file can be used
+  const QgsPackedSpatialIndex storedSpatialIndex = buildSpatialIndex && ! mSubsetExpression ? readSpatialIndex() : QgsPackedSpatialIndex();
+  const bool scanSpatialIndex = buildSpatialIndex && ! storedSpatialIndex.isValid();
+  QVector< QPair< QgsFeatureId, QgsRectangle > > spatialIndexEntries;
+
   // In case file has been rewritten check that it is still valid
 
   mValid = mLayerValid && mFile->isValid();
@@ -903,8 +1571,8 @@ void QgsDelimitedTextProvider::rescanFile() const
         QgsRectangle bbox( f.geometry().boundingBox() );
         mExtent.combineExtentWith( bbox );
       }
-      if ( buildSpatialIndex )
-        mSpatialIndex->addFeature( f );
+      if ( scanSpatialIndex )
+        spatialIndexEntries.append( qMakePair( f.id(), f.geometry().boundingBox() ) );
     }
     if ( buildSubsetIndex )
       mSubsetIndex.append( ( quintptr ) f.id() );
@@ -919,6 +1587,17 @@ void QgsDelimitedTextProvider::rescanFile() const
       mSubsetIndex.clear();
   }
 
+  if ( scanSpatialIndex )
+  {
+    mSpatialIndex = QgsPackedSpatialIndex( spatialIndexEntries );
+    if ( ! mSubsetExpression )
+      writeSpatialIndex( mSpatialIndex );
+  }
+  else if ( buildSpatialIndex )
+  {
+    mSpatialIndex = storedSpatialIndex;
+  }
+
   mUseSpatialIndex = buildSpatialIndex;
 }
 
@@ -1028,18 +1707,6 @@ bool QgsDelimitedTextProvider::recordIsEmpty( QStringList &record )
   return true;
 }
 
-void QgsDelimitedTextProvider::recordInvalidLine( const QString &message )
-{
-  if ( mInvalidLines.size() < mMaxInvalidLines )
-  {
-    mInvalidLines.append( message.arg( mFile->recordId() ) );
-  }
-  else
-  {
-    mNExtraInvalidLines++;
-  }
-}
-
 void QgsDelimitedTextProvider::reportErrors( const QStringList &messages, bool showDialog ) const
 {
   if ( !mInvalidLines.isEmpty() || ! messages.isEmpty() )
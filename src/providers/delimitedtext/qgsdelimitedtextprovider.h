@@ -26,6 +26,7 @@
 #include "qgsfields.h"
 
 #include "qgsprovidermetadata.h"
+#include "qgspackedspatialindex.h"
 
 class QgsFeature;
 class QgsField;
@@ -36,7 +37,6 @@ class QTextStream;
 
 class QgsDelimitedTextFeatureIterator;
 class QgsExpression;
-class QgsSpatialIndex;
 
 /**
  * \class QgsDelimitedTextProvider
@@ -140,14 +140,59 @@ class QgsDelimitedTextProvider final: public QgsVectorDataProvider
 
   private:
 
+    struct ColumnTypes;
+    struct ScanPart;
+
     void scanFile( bool buildIndexes );
 
+    /**
+     * Scans the records of the file with nextRecord(), as a single part.
+     */
+    void scanSequentialFile( ScanPart &scan, bool buildSpatialIndex, bool buildSubsetIndex ) const;
+
+    /**
+     * Scans the records of the memory mapped file in parallel, by splitting the file in parts
+     * which are merged in  scan. Returns FALSE if the file cannot be read from a memory mapping.
+     */
+    bool scanMappedFile( ScanPart &scan, bool buildSpatialIndex, bool buildSubsetIndex ) const;
+
+    /**
+     * Scans the records of the memory mapped file which start between the offsets of  part.
+     */
+    void scanMappedPart( ScanPart &part, bool buildSpatialIndex, bool buildSubsetIndex ) const;
+
+    /**
+     * Scans a valid record, to update the geometry, counts, indexes and column types of  part.
+     * The record is either a QStringList or a memory mapped record.
+     */
+    template <typename Record>
+    void scanRecord( const Record &record, long recordId, ScanPart &part, bool buildSpatialIndex, bool buildSubsetIndex ) const;
+
+    //! Returns the path of the file storing the results of the scan of the file, or an empty string if the scan should not be stored
+    QString scanIndexPath() const;
+    //! Returns the definition of the layer which the stored results of the scan of the file depend on
+    QString scanIndexKey() const;
+    //! Reads the results of a previous scan of the file, returns FALSE if there is no valid stored scan
+    bool readScanIndex( ScanPart &scan, bool buildSubsetIndex ) const;
+    //! Stores the results of the scan of the file, to be reused when the file is opened again
+    void writeScanIndex( const ScanPart &scan, bool hasSubsetIndex ) const;
+
+    /**
+     * Returns the path of the file storing the spatial index of all the records of the file, or an
+     * empty string if the spatial index should not be stored. The path depends on the modification time
+     * of the file and on the definition of the layer, so that outdated indexes are never opened.
+     */
+    QString spatialIndexPath() const;
+    //! Opens the spatial index stored for the current version of the file, returns an invalid index if there is none
+    QgsPackedSpatialIndex readSpatialIndex() const;
+    //! Stores the spatial \a index of all the records of the file, and removes the indexes of previous versions of the file
+    void writeSpatialIndex( const QgsPackedSpatialIndex &index ) const;
+
     //some of these methods const, as they need to be called from const methods such as extent()
     void rescanFile() const;
     void resetCachedSubset() const;
     void resetIndexes() const;
     void clearInvalidLines() const;
-    void recordInvalidLine( const QString &message );
     void reportErrors( const QStringList &messages = QStringList(), bool showDialog = false ) const;
     static bool recordIsEmpty( QStringList &record );
     void setUriParameter( const QString &parameter, const QString &value );
@@ -227,7 +272,7 @@ class QgsDelimitedTextProvider final: public QgsVectorDataProvider
     bool mBuildSpatialIndex = false;
     mutable bool mUseSpatialIndex;
     mutable bool mCachedUseSpatialIndex;
-    mutable std::unique_ptr< QgsSpatialIndex > mSpatialIndex;
+    mutable QgsPackedSpatialIndex mSpatialIndex;
 
     friend class QgsDelimitedTextFeatureIterator;
     friend class QgsDelimitedTextFeatureSource;
@@ -23,8 +23,46 @@
 #include "qgssettings.h"
 #include "qgsexception.h"
 
+#include <QDateTime>
 #include <QElapsedTimer>
 #include <QObject>
+#include <QtEndian>
+
+#include <limits>
+
+// Decoding of the values returned by the binary cursor, which are in network byte order
+
+static qint64 binaryInteger( const char *value, int length )
+{
+  const uchar *data = reinterpret_cast< const uchar * >( value );
+  switch ( length )
+  {
+    case 2:
+      return qFromBigEndian< qint16 >( data );
+    case 4:
+      return qFromBigEndian< qint32 >( data );
+    case 8:
+      return qFromBigEndian< qint64 >( data );
+    default:
+      return 0;
+  }
+}
+
+static double binaryDouble( const char *value )
+{
+  const quint64 bits = qFromBigEndian< quint64 >( reinterpret_cast< const uchar * >( value ) );
+  double result;
+  memcpy( &result, &bits, sizeof( result ) );
+  return result;
+}
+
+static QTime binaryTime( qint64 usecsOfDay )
+{
+  // fractional seconds are rounded to milliseconds, like when parsing text values
+  const qint64 seconds = usecsOfDay / 1000000;
+  const int msecs = std::min( qRound( ( usecsOfDay % 1000000 ) / 1000.0 ), 999 );
+  return QTime::fromMSecsSinceStartOfDay( static_cast< int >( seconds * 1000 + msecs ) );
+}
 
 QgsPostgresFeatureIterator::QgsPostgresFeatureIterator( QgsPostgresFeatureSource *source, bool ownSource, const QgsFeatureRequest &request )
   : QgsAbstractFeatureIteratorFromSource<QgsPostgresFeatureSource>( source, ownSource, request )
@@ -55,6 +93,10 @@ QgsPostgresFeatureIterator::QgsPostgresFeatureIterator( QgsPostgresFeatureSource
     return;
   }
 
+  // a pooled connection is used by this iterator only, so the next FETCH can be kept in flight
+  // between calls. Limited requests are likely to stop before the next batch is needed.
+  mPrefetch = !mIsTransactionConnection && mRequest.limit() < 0;
+
   if ( mRequest.destinationCrs().isValid() && mRequest.destinationCrs() != mSource->mCrs )
   {
     mTransform = QgsCoordinateTransform( mSource->mCrs, mRequest.destinationCrs(), mRequest.transformContext() );
@@ -260,41 +302,21 @@ bool QgsPostgresFeatureIterator::fetchFeature( QgsFeature &feature )
     timer.start();
 #endif
 
-    QString fetch = QStringLiteral( "FETCH FORWARD %1 FROM %2" ).arg( mFeatureQueueSize ).arg( mCursorName );
-    QgsDebugMsgLevel( QStringLiteral( "fetching %1 features." ).arg( mFeatureQueueSize ), 4 );
-
+    std::vector< std::unique_ptr< QgsPostgresResult > > results;
     lock();
-    if ( mConn->PQsendQuery( fetch ) == 0 ) // fetch features asynchronously
-    {
-      QgsMessageLog::logMessage( QObject::tr( "Fetching from cursor %1 failed\nDatabase error: %2" ).arg( mCursorName, mConn->PQerrorMessage() ), QObject::tr( "PostGIS" ) );
-    }
+    fetchFromCursor( mFeatureQueueSize, results );
+    unlock();
 
-    QgsPostgresResult queryResult;
-    for ( ;; )
+    // decode the rows while the server prepares the next ones
+    for ( const std::unique_ptr< QgsPostgresResult > &queryResult : results )
     {
-      queryResult = mConn->PQgetResult();
-      if ( !queryResult.result() )
-        break;
-
-      if ( queryResult.PQresultStatus() != PGRES_TUPLES_OK )
-      {
-        QgsMessageLog::logMessage( QObject::tr( "Fetching from cursor %1 failed\nDatabase error: %2" ).arg( mCursorName, mConn->PQerrorMessage() ), QObject::tr( "PostGIS" ) );
-        break;
-      }
-
-      int rows = queryResult.PQntuples();
-      if ( rows == 0 )
-        continue;
-
-      mLastFetch = rows < mFeatureQueueSize;
-
+      const int rows = queryResult->PQntuples();
       for ( int row = 0; row < rows; row++ )
       {
         mFeatureQueue.enqueue( QgsFeature() );
-        getFeature( queryResult, row, mFeatureQueue.back() );
+        getFeature( *queryResult, row, mFeatureQueue.back() );
       } // for each row in queue
     }
-    unlock();
 
 #if 0 //disabled dynamic queue size
     if ( timer.elapsed() > 500 && mFeatureQueueSize > 1 )
@@ -328,6 +350,175 @@ bool QgsPostgresFeatureIterator::fetchFeature( QgsFeature &feature )
   return true;
 }
 
+bool QgsPostgresFeatureIterator::fetchBatch( QgsFeatureBatch &batch, int maxFeatures )
+{
+  if ( mClosed )
+    return false;
+
+  // reprojection and composite/mapped primary keys go through the generic path
+  if ( mTransform.isValid() ||
+       ( mSource->mPrimaryKeyType != PktOid && mSource->mPrimaryKeyType != PktTid && mSource->mPrimaryKeyType != PktInt ) )
+  {
+    return QgsAbstractFeatureIterator::fetchBatch( batch, maxFeatures );
+  }
+
+  // features queued by a previous call to fetchFeature() come first
+  while ( !mFeatureQueue.empty() && batch.size() < maxFeatures )
+  {
+    batch.addFeature( mFeatureQueue.dequeue() );
+    mFetched++;
+  }
+
+  while ( batch.size() < maxFeatures && !mLastFetch )
+  {
+    // only fetch what fits into the batch, so that nothing needs to be queued
+    // (rows of a FETCH which was already in flight may still overflow into the queue)
+    const int count = std::min( mFeatureQueueSize, maxFeatures - batch.size() );
+
+    std::vector< std::unique_ptr< QgsPostgresResult > > results;
+    lock();
+    fetchFromCursor( count, results );
+    unlock();
+
+    for ( const std::unique_ptr< QgsPostgresResult > &queryResult : results )
+    {
+      const int rows = queryResult->PQntuples();
+      for ( int row = 0; row < rows; row++ )
+      {
+        if ( batch.size() < maxFeatures )
+        {
+          getBatchRow( *queryResult, row, batch );
+          mFetched++;
+        }
+        else
+        {
+          mFeatureQueue.enqueue( QgsFeature() );
+          getFeature( *queryResult, row, mFeatureQueue.back() );
+        }
+      }
+    }
+  }
+
+  if ( batch.isEmpty() )
+  {
+    QgsDebugMsg( QStringLiteral( "Finished after %1 features" ).arg( mFetched ) );
+    close();
+
+    mSource->mShared->ensureFeaturesCountedAtLeast( mFetched );
+
+    return false;
+  }
+
+  return true;
+}
+
+void QgsPostgresFeatureIterator::getBatchRow( QgsPostgresResult &queryResult, int row, QgsFeatureBatch &batch )
+{
+  int col = 0;
+  const unsigned char *geometry = nullptr;
+  int geometryLength = 0;
+
+  if ( mFetchGeometry )
+  {
+    geometryLength = ::PQgetlength( queryResult.result(), row, col );
+    if ( geometryLength > 0 )
+      geometry = reinterpret_cast< const unsigned char * >( ::PQgetvalue( queryResult.result(), row, col ) );
+    col++;
+  }
+
+  // only PktOid, PktTid and PktInt keys are handled here
+  QgsFeatureId fid = mConn->getBinaryInt( queryResult, row, col++ );
+  const qint64 primaryKeyValue = fid;
+  if ( mSource->mPrimaryKeyType == PktInt )
+    fid = QgsPostgresUtils::int32pk_to_fid( fid );
+
+  batch.addFeature( fid );
+
+  // the batch decodes PostGIS WKB (including TIN and polyhedral surfaces) itself,
+  // so the value returned by the server can be used without copying it first
+  if ( geometry )
+    batch.setGeometryFromWkb( geometry, geometryLength );
+
+  const bool subsetOfAttributes = mRequest.flags() & QgsFeatureRequest::SubsetOfAttributes;
+  const QgsAttributeList fetchAttributes = subsetOfAttributes ? mRequest.subsetOfAttributes() : mSource->mFields.allAttributesList();
+  for ( int idx : fetchAttributes )
+  {
+    const int column = batch.columnForAttribute( idx );
+
+    if ( mSource->mPrimaryKeyAttrs.contains( idx ) )
+    {
+      if ( column >= 0 && mSource->mPrimaryKeyType == PktInt )
+        batch.setValue( column, primaryKeyValue );
+      continue;
+    }
+
+    const int valueCol = col++;
+    if ( column < 0 || ::PQgetisnull( queryResult.result(), row, valueCol ) )
+      continue;
+
+    const QgsField &fld = mSource->mFields.at( idx );
+    const char *value = ::PQgetvalue( queryResult.result(), row, valueCol );
+    const int length = ::PQgetlength( queryResult.result(), row, valueCol );
+    const BinaryType binaryType = mBinaryTypes.value( idx, NotBinary );
+    bool ok = false;
+
+    switch ( fld.type() )
+    {
+      case QVariant::LongLong:
+      case QVariant::Int:
+      {
+        if ( binaryType == BinaryInt )
+        {
+          batch.setInt64( column, binaryInteger( value, length ) );
+          ok = true;
+          break;
+        }
+
+        const qlonglong intValue = QByteArray::fromRawData( value, length ).toLongLong( &ok );
+        if ( ok )
+          batch.setInt64( column, intValue );
+        break;
+      }
+
+      case QVariant::Double:
+      {
+        if ( binaryType == BinaryFloat8 )
+        {
+          batch.setDouble( column, binaryDouble( value ) );
+          ok = true;
+          break;
+        }
+
+        const double doubleValue = QByteArray::fromRawData( value, length ).toDouble( &ok );
+        if ( ok )
+          batch.setDouble( column, doubleValue );
+        break;
+      }
+
+      case QVariant::String:
+        // the connection always uses UTF-8 as client encoding
+        if ( batch.columnType( column ) == QgsFeatureBatch::StringColumn )
+        {
+          batch.setString( column, value, length );
+          ok = true;
+        }
+        break;
+
+      default:
+        break;
+    }
+
+    if ( !ok )
+    {
+      QgsFeature feature;
+      feature.initAttributes( mSource->mFields.count() );
+      int attributeCol = valueCol;
+      getFeatureAttribute( idx, queryResult, row, attributeCol, feature );
+      batch.setValue( column, feature.attribute( idx ) );
+    }
+  }
+}
+
 bool QgsPostgresFeatureIterator::nextFeatureFilterExpression( QgsFeature &f )
 {
   if ( !mExpressionCompiled )
@@ -381,11 +572,81 @@ void QgsPostgresFeatureIterator::unlock()
     mConn->unlock();
 }
 
+bool QgsPostgresFeatureIterator::sendFetch( int count )
+{
+  const QString fetch = QStringLiteral( "FETCH FORWARD %1 FROM %2" ).arg( count ).arg( mCursorName );
+  QgsDebugMsgLevel( QStringLiteral( "fetching %1 features." ).arg( count ), 4 );
+
+  if ( mConn->PQsendQuery( fetch ) == 0 ) // fetch features asynchronously
+  {
+    QgsMessageLog::logMessage( QObject::tr( "Fetching from cursor %1 failed\nDatabase error: %2" ).arg( mCursorName, mConn->PQerrorMessage() ), QObject::tr( "PostGIS" ) );
+    return false;
+  }
+
+  mPendingFetchCount = count;
+  return true;
+}
+
+int QgsPostgresFeatureIterator::fetchFromCursor( int count, std::vector< std::unique_ptr< QgsPostgresResult > > &results )
+{
+  if ( mPendingFetchCount == 0 && !sendFetch( count ) )
+  {
+    mLastFetch = true;
+    return 0;
+  }
+
+  const int requested = mPendingFetchCount;
+  mPendingFetchCount = 0;
+
+  int fetchedRows = 0;
+  for ( ;; )
+  {
+    std::unique_ptr< QgsPostgresResult > queryResult = qgis::make_unique< QgsPostgresResult >( mConn->PQgetResult() );
+    if ( !queryResult->result() )
+      break;
+
+    if ( queryResult->PQresultStatus() != PGRES_TUPLES_OK )
+    {
+      QgsMessageLog::logMessage( QObject::tr( "Fetching from cursor %1 failed\nDatabase error: %2" ).arg( mCursorName, mConn->PQerrorMessage() ), QObject::tr( "PostGIS" ) );
+      continue;
+    }
+
+    const int rows = queryResult->PQntuples();
+    if ( rows == 0 )
+      continue;
+
+    fetchedRows += rows;
+    results.emplace_back( std::move( queryResult ) );
+  }
+
+  mLastFetch = fetchedRows < requested;
+
+  // keep the next FETCH in flight while the caller decodes these rows
+  if ( mPrefetch && !mLastFetch )
+    sendFetch( mFeatureQueueSize );
+
+  return fetchedRows;
+}
+
+void QgsPostgresFeatureIterator::discardPendingFetch()
+{
+  if ( mPendingFetchCount == 0 )
+    return;
+
+  lock();
+  while ( PGresult *result = mConn->PQgetResult() )
+    ::PQclear( result );
+  unlock();
+  mPendingFetchCount = 0;
+}
+
 bool QgsPostgresFeatureIterator::rewind()
 {
   if ( mClosed )
     return false;
 
+  discardPendingFetch();
+
   // move cursor to first record
 
   mConn->PQexecNR( QStringLiteral( "move absolute 0 in %1" ).arg( mCursorName ) );
@@ -401,6 +662,7 @@ bool QgsPostgresFeatureIterator::close()
   if ( !mConn )
     return false;
 
+  discardPendingFetch();
   mConn->closeCursor( mCursorName );
 
   if ( !mIsTransactionConnection )
@@ -630,6 +892,12 @@ bool QgsPostgresFeatureIterator::declareCursor( const QString &whereClause, long
       return false;
   }
 
+  // the cursor is a binary cursor: the values of the common types are fetched in their binary
+  // representation and decoded directly, the other ones are cast to text
+  const char *integerDatetimes = ::PQparameterStatus( mConn->pgConnection(), "integer_datetimes" );
+  const bool hasIntegerDatetimes = integerDatetimes && qstrcmp( integerDatetimes, "on" ) == 0;
+  mBinaryTypes = QVector< BinaryType >( mSource->mFields.count(), NotBinary );
+
   bool subsetOfAttributes = mRequest.flags() & QgsFeatureRequest::SubsetOfAttributes;
   const auto constAllAttributesList = subsetOfAttributes ? mRequest.subsetOfAttributes() : mSource->mFields.allAttributesList();
   for ( int idx : constAllAttributesList )
@@ -637,7 +905,12 @@ bool QgsPostgresFeatureIterator::declareCursor( const QString &whereClause, long
     if ( mSource->mPrimaryKeyAttrs.contains( idx ) )
       continue;
 
-    query += delim + mConn->fieldExpression( mSource->mFields.at( idx ) );
+    const QgsField &fld = mSource->mFields.at( idx );
+    mBinaryTypes[ idx ] = binaryType( fld, hasIntegerDatetimes );
+    if ( mBinaryTypes.at( idx ) != NotBinary )
+      query += delim + QgsPostgresConn::quotedIdentifier( fld.name() );
+    else
+      query += delim + mConn->fieldExpression( fld );
   }
 
   query += " FROM " + mSource->mQuery;
@@ -664,6 +937,119 @@ bool QgsPostgresFeatureIterator::declareCursor( const QString &whereClause, long
   return true;
 }
 
+QgsPostgresFeatureIterator::BinaryType QgsPostgresFeatureIterator::binaryType( const QgsField &fld, bool integerDatetimes )
+{
+  const QString &type = fld.typeName();
+  switch ( fld.type() )
+  {
+    case QVariant::Int:
+      if ( type == QLatin1String( "int2" ) || type == QLatin1String( "int4" ) )
+        return BinaryInt;
+      break;
+
+    case QVariant::LongLong:
+      if ( type == QLatin1String( "int8" ) )
+        return BinaryInt;
+      break;
+
+    case QVariant::Double:
+      // float4 values are fetched as text, their binary value would not round trip to the same double
+      if ( type == QLatin1String( "float8" ) )
+        return BinaryFloat8;
+      break;
+
+    case QVariant::Bool:
+      if ( type == QLatin1String( "bool" ) )
+        return BinaryBool;
+      break;
+
+    case QVariant::ByteArray:
+      if ( type == QLatin1String( "bytea" ) )
+        return BinaryBytea;
+      break;
+
+    // date and time values are only sent as integers by servers built with integer datetimes,
+    // which is the only option since PostgreSQL 10
+    case QVariant::Date:
+      if ( integerDatetimes && type == QLatin1String( "date" ) )
+        return BinaryDate;
+      break;
+
+    case QVariant::DateTime:
+      if ( integerDatetimes && type == QLatin1String( "timestamp" ) )
+        return BinaryTimestamp;
+      break;
+
+    case QVariant::Time:
+      if ( integerDatetimes && type == QLatin1String( "time" ) )
+        return BinaryTime;
+      break;
+
+    default:
+      break;
+  }
+  return NotBinary;
+}
+
+QVariant QgsPostgresFeatureIterator::binaryValue( int idx, const char *value, int length ) const
+{
+  const QVariant::Type type = mSource->mFields.at( idx ).type();
+  switch ( mBinaryTypes.at( idx ) )
+  {
+    case BinaryInt:
+    {
+      const qint64 intValue = binaryInteger( value, length );
+      return type == QVariant::Int ? QVariant( static_cast< int >( intValue ) ) : QVariant( static_cast< qlonglong >( intValue ) );
+    }
+
+    case BinaryFloat8:
+      return binaryDouble( value );
+
+    case BinaryBool:
+      return QVariant( *value != 0 );
+
+    case BinaryBytea:
+      if ( length == 0 )
+        return QVariant( QVariant::ByteArray );
+      return QByteArray( value, length );
+
+    case BinaryDate:
+    {
+      // days since 2000-01-01
+      const qint32 days = qFromBigEndian< qint32 >( reinterpret_cast< const uchar * >( value ) );
+      if ( days == std::numeric_limits< qint32 >::max() || days == std::numeric_limits< qint32 >::min() )
+        return QVariant( QVariant::Date ); // +/- infinity
+      return QDate( 2000, 1, 1 ).addDays( days );
+    }
+
+    case BinaryTimestamp:
+    {
+      // microseconds since 2000-01-01 00:00:00, without time zone
+      const qint64 usecs = qFromBigEndian< qint64 >( reinterpret_cast< const uchar * >( value ) );
+      if ( usecs == std::numeric_limits< qint64 >::max() || usecs == std::numeric_limits< qint64 >::min() )
+        return QVariant( QVariant::DateTime ); // +/- infinity
+
+      const qint64 usecsPerDay = Q_INT64_C( 86400000000 );
+      qint64 days = usecs / usecsPerDay;
+      qint64 usecsOfDay = usecs % usecsPerDay;
+      if ( usecsOfDay < 0 )
+      {
+        usecsOfDay += usecsPerDay;
+        days--;
+      }
+      return QDateTime( QDate( 2000, 1, 1 ).addDays( days ), binaryTime( usecsOfDay ) );
+    }
+
+    case BinaryTime:
+      // microseconds since midnight
+      return binaryTime( qFromBigEndian< qint64 >( reinterpret_cast< const uchar * >( value ) ) );
+
+    case NotBinary:
+      break;
+  }
+  return QVariant( type );
+}
+
 bool QgsPostgresFeatureIterator::getFeature( QgsPostgresResult &queryResult, int row, QgsFeature &feature )
 {
   feature.initAttributes( mSource->mFields.count() );
@@ -839,6 +1225,18 @@ void QgsPostgresFeatureIterator::getFeatureAttribute( int idx, QgsPostgresResult
 
   QVariant v;
 
+  if ( mBinaryTypes.value( idx, NotBinary ) != NotBinary )
+  {
+    if ( ::PQgetisnull( queryResult.result(), row, col ) )
+      v = QVariant( fld.type() );
+    else
+      v = binaryValue( idx, ::PQgetvalue( queryResult.result(), row, col ), ::PQgetlength( queryResult.result(), row, col ) );
+
+    feature.setAttribute( idx, v );
+    col++;
+    return;
+  }
+
   switch ( fld.type() )
   {
     case QVariant::ByteArray:
@@ -18,6 +18,8 @@
 #include "qgsfeatureiterator.h"
 
 #include <QQueue>
+#include <memory>
+#include <vector>
 
 #include "qgspostgresprovider.h"
 
@@ -81,19 +83,57 @@ class QgsPostgresFeatureIterator final: public QgsAbstractFeatureIteratorFromSou
 
   protected:
     bool fetchFeature( QgsFeature &feature ) override;
+    bool fetchBatch( QgsFeatureBatch &batch, int maxFeatures ) override;
     bool nextFeatureFilterExpression( QgsFeature &f ) override;
     bool prepareSimplification( const QgsSimplifyMethod &simplifyMethod ) override;
 
   private:
 
+    //! Types of the attribute values which are fetched from the cursor in their binary representation
+    enum BinaryType
+    {
+      NotBinary, //!< Value is cast to text
+      BinaryInt, //!< int2, int4 or int8 value
+      BinaryFloat8, //!< float8 value
+      BinaryBool, //!< bool value
+      BinaryBytea, //!< bytea value
+      BinaryDate, //!< date value
+      BinaryTimestamp, //!< timestamp without time zone value
+      BinaryTime, //!< time without time zone value
+    };
+
     QgsPostgresConn *mConn = nullptr;
 
 
     QString whereClauseRect();
     bool getFeature( QgsPostgresResult &queryResult, int row, QgsFeature &feature );
     void getFeatureAttribute( int idx, QgsPostgresResult &queryResult, int row, int &col, QgsFeature &feature );
+    void getBatchRow( QgsPostgresResult &queryResult, int row, QgsFeatureBatch &batch );
     bool declareCursor( const QString &whereClause, long limit = -1, bool closeOnFail = true, const QString &orderBy = QString() );
 
+    //! Returns the binary type used to fetch the values of field \a fld
+    static BinaryType binaryType( const QgsField &fld, bool integerDatetimes );
+
+    //! Decodes the binary \a value of the attribute with index \a idx
+    QVariant binaryValue( int idx, const char *value, int length ) const;
+
+    /**
+     * Sends a FETCH of \a count features from the cursor, without waiting for the results.
+     */
+    bool sendFetch( int count );
+
+    /**
+     * Fetches the next features from the cursor into \a results, and returns the number of fetched rows.
+     *
+     * If a FETCH is already in flight, its results are used, otherwise \a count features are fetched.
+     * Unless the cursor is exhausted, the next FETCH is sent before returning, so that the
+     * server produces the next rows while the caller decodes these ones.
+     */
+    int fetchFromCursor( int count, std::vector< std::unique_ptr< QgsPostgresResult > > &results );
+
+    //! Waits for the FETCH in flight, if any, and discards its results
+    void discardPendingFetch();
+
     QString mCursorName;
 
     /**
@@ -113,6 +153,15 @@ class QgsPostgresFeatureIterator final: public QgsAbstractFeatureIteratorFromSou
 
     bool mIsTransactionConnection = false;
 
+    //! Whether the next FETCH can be sent while the previous results are decoded
+    bool mPrefetch = false;
+
+    //! Number of features requested by the FETCH in flight, or 0 if none is in flight
+    int mPendingFetchCount = 0;
+
+    //! Binary types of the fetched attributes, by attribute index
+    QVector< BinaryType > mBinaryTypes;
+
     bool providerCanSimplify( QgsSimplifyMethod::MethodType methodType ) const override;
 
     bool prepareOrderBy( const QList<QgsFeatureRequest::OrderByClause> &orderBys ) override;
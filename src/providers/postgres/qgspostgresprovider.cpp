@@ -16,6 +16,7 @@
  ***************************************************************************/
 
 #include "qgsapplication.h"
+#include "qgsexpression.h"
 #include "qgsfeature.h"
 #include "qgsfield.h"
 #include "qgsgeometry.h"
@@ -3508,6 +3509,93 @@ QgsFeatureSource::SpatialIndexPresence QgsPostgresProvider::hasSpatialIndex() co
   }
 }
 
+QList<QgsFeatureRequest> QgsPostgresProvider::partitionRequest( const QgsFeatureRequest &request, int count ) const
+{
+  // the partitions must be disjoint and complete, so only requests whose whole filter
+  // can be combined with a key range are split
+  if ( count <= 1 || mTransaction || request.limit() >= 0 || !request.orderBy().isEmpty()
+       || request.filterType() == QgsFeatureRequest::FilterFid || request.filterType() == QgsFeatureRequest::FilterFids )
+    return QgsVectorDataProvider::partitionRequest( request, count );
+
+  // without compiled expressions the key ranges would be evaluated locally, on the whole table
+  if ( !QgsSettings().value( QStringLiteral( "qgis/compileExpressions" ), true ).toBool() )
+    return QList< QgsFeatureRequest >() << request;
+
+  if ( mPrimaryKeyAttrs.size() != 1 )
+    return QList< QgsFeatureRequest >() << request;
+
+  switch ( mPrimaryKeyType )
+  {
+    case PktInt:
+    case PktInt64:
+    case PktUint64:
+      break;
+
+    case PktUnknown:
+    case PktTid:
+    case PktOid:
+    case PktFidMap:
+      return QList< QgsFeatureRequest >() << request;
+  }
+
+  // more partitions than connections would just wait for each other
+  count = std::min( count, QgsApplication::instance()->maxConcurrentConnectionsPerPool() );
+  if ( count <= 1 )
+    return QList< QgsFeatureRequest >() << request;
+
+  const QgsField pkField = field( mPrimaryKeyAttrs.at( 0 ) );
+  QString sql = QStringLiteral( "SELECT min(%1),max(%1) FROM %2" )
+                .arg( quotedIdentifier( pkField.name() ),
+                      mQuery );
+  if ( !mSqlWhereClause.isEmpty() )
+  {
+    sql += QStringLiteral( " WHERE %1" ).arg( mSqlWhereClause );
+  }
+
+  QgsPostgresResult result( connectionRO()->PQexec( sql ) );
+  if ( result.PQresultStatus() != PGRES_TUPLES_OK || result.PQntuples() != 1 || result.PQgetisnull( 0, 0 ) )
+    return QList< QgsFeatureRequest >() << request;
+
+  bool minOk = false;
+  bool maxOk = false;
+  const qint64 minKey = result.PQgetvalue( 0, 0 ).toLongLong( &minOk );
+  const qint64 maxKey = result.PQgetvalue( 0, 1 ).toLongLong( &maxOk );
+  if ( !minOk || !maxOk )
+    return QList< QgsFeatureRequest >() << request;
+
+  // the range is split with doubles, a few keys more or less in a partition don't matter
+  const double step = ( static_cast< double >( maxKey ) - static_cast< double >( minKey ) + 1 ) / count;
+  QList< qint64 > boundaries;
+  for ( int i = 1; i < count; ++i )
+  {
+    const qint64 boundary = minKey + static_cast< qint64 >( step * i );
+    if ( boundary > minKey && ( boundaries.isEmpty() || boundary > boundaries.constLast() ) && boundary <= maxKey )
+      boundaries << boundary;
+  }
+  if ( boundaries.isEmpty() )
+    return QList< QgsFeatureRequest >() << request;
+
+  // open ranges at both ends, so that features added since the min/max query are not missed
+  const QString column = QgsExpression::quotedColumnRef( pkField.name() );
+  QList< QgsFeatureRequest > requests;
+  requests.reserve( boundaries.size() + 1 );
+  for ( int i = 0; i <= boundaries.size(); ++i )
+  {
+    QString range;
+    if ( i == 0 )
+      range = QStringLiteral( "%1 < %2" ).arg( column ).arg( boundaries.at( 0 ) );
+    else if ( i == boundaries.size() )
+      range = QStringLiteral( "%1 >= %2" ).arg( column ).arg( boundaries.at( i - 1 ) );
+    else
+      range = QStringLiteral( "%1 >= %2 AND %1 < %3" ).arg( column ).arg( boundaries.at( i - 1 ) ).arg( boundaries.at( i ) );
+
+    QgsFeatureRequest partition( request );
+    partition.combineFilterExpression( range );
+    requests << partition;
+  }
+  return requests;
+}
+
 bool QgsPostgresProvider::setSubsetString( const QString &theSQL, bool updateFeatureCount )
 {
   if ( theSQL.trimmed() == mSqlWhereClause )
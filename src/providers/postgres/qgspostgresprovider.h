@@ -197,6 +197,12 @@ class QgsPostgresProvider final: public QgsVectorDataProvider
     QgsVectorDataProvider::Capabilities capabilities() const override;
     SpatialIndexPresence hasSpatialIndex() const override;
 
+    /**
+     * Splits the request into ranges of the primary key, when it is a single integer column.
+     * Each partition is iterated with its own pooled connection.
+     */
+    QList< QgsFeatureRequest > partitionRequest( const QgsFeatureRequest &request, int count ) const override;
+
     /**
      * The Postgres provider does its own transforms so we return
      * true for the following three functions to indicate that transforms
@@ -24,6 +24,7 @@
 #include "qgswfsutils.h" // for isCompatibleType()
 
 #include <QCryptographicHash>
+#include <QDateTime>
 #include <QDir>
 #include <QMutex>
 
@@ -54,7 +55,7 @@ QgsBackgroundCachedSharedData::~QgsBackgroundCachedSharedData()
 
 void QgsBackgroundCachedSharedData::cleanup()
 {
-  invalidateCache();
+  closeCache( false );
 
   mCacheIdDb.reset();
   if ( !mCacheIdDbname.isEmpty() )
@@ -77,9 +78,14 @@ void QgsBackgroundCachedSharedData::releaseCacheDirectory()
   mCacheDirectoryManager.releaseCacheDirectory();
 }
 
-// This is called by the destructor or provider's reloadData(). The effect is to invalid
+// This is called by provider's reloadData(). The effect is to invalid
 // all the caching state, so that a new request results in fresh download
 void QgsBackgroundCachedSharedData::invalidateCache()
+{
+  closeCache( true );
+}
+
+void QgsBackgroundCachedSharedData::closeCache( bool discardPersistentCache )
 {
   // Cf explanations in registerToCache() for the locking strategy
   QMutexLocker lockerMyself( &mMutexRegisterToCache );
@@ -101,6 +107,7 @@ void QgsBackgroundCachedSharedData::invalidateCache()
   mFeatureCountExact = false;
   mFeatureCountRequestIssued = false;
   mTotalFeaturesAttemptedToBeCached = 0;
+  mCacheComplete = false;
   if ( !mCacheDbname.isEmpty() && mCacheDataProvider )
   {
     // We need to invalidate connections pointing to the cache, so as to
@@ -111,12 +118,32 @@ void QgsBackgroundCachedSharedData::invalidateCache()
 
   if ( !mCacheDbname.isEmpty() )
   {
-    QFile::remove( mCacheDbname );
-    QFile::remove( mCacheDbname + "-wal" );
-    QFile::remove( mCacheDbname + "-shm" );
+    if ( !mPersistentCacheLock || discardPersistentCache )
+    {
+      QFile::remove( mCacheDbname );
+      QFile::remove( mCacheDbname + "-wal" );
+      QFile::remove( mCacheDbname + "-shm" );
+    }
     mCacheDbname.clear();
   }
 
+  if ( mPersistentCacheLock )
+  {
+    if ( discardPersistentCache )
+    {
+      // Keep the id_cache table so that feature ids remain stable
+      QString errorMsg;
+      if ( mCacheIdDb.exec( QStringLiteral( "DELETE FROM regions; DELETE FROM metadata" ), errorMsg ) != SQLITE_OK )
+        QgsDebugMsg( errorMsg );
+    }
+
+    // The persistent id cache is reopened together with the cache, whose
+    // name depends on the current state of the layer (filter, etc.)
+    mCacheIdDb.reset();
+    mCacheIdDbname.clear();
+    mPersistentCacheLock.reset();
+  }
+
   invalidateCacheBaseUnderLock();
 }
 
@@ -157,9 +184,6 @@ bool QgsBackgroundCachedSharedData::createCache()
 
   static QAtomicInt sTmpCounter = 0;
   int tmpCounter = ++sTmpCounter;
-  QString cacheDirectory( acquireCacheDirectory() );
-  mCacheDbname = QDir( cacheDirectory ).filePath( QStringLiteral( "cache_%1.sqlite" ).arg( tmpCounter ) );
-  Q_ASSERT( !QFile::exists( mCacheDbname ) );
 
   QgsFields cacheFields;
   std::set<QString> setSQLiteColumnNameUpperCase;
@@ -198,6 +222,84 @@ bool QgsBackgroundCachedSharedData::createCache()
   if ( mDistinctSelect )
     cacheFields.append( QgsField( QgsBackgroundCachedFeatureIteratorConstants::FIELD_MD5, QVariant::String, QStringLiteral( "string" ) ) );
 
+  QString cacheDirectory;
+  const QString persistentKey = persistentCacheKey();
+  if ( persistentKey.isEmpty() || !openPersistentCache( persistentKey, cacheFields ) )
+  {
+    cacheDirectory = acquireCacheDirectory();
+    mCacheDbname = QDir( cacheDirectory ).filePath( QStringLiteral( "cache_%1.sqlite" ).arg( tmpCounter ) );
+    Q_ASSERT( !QFile::exists( mCacheDbname ) );
+  }
+  const bool restoreFromPersistentCache = mPersistentCacheLock && QFile::exists( mCacheDbname );
+
+  QString fidName( QStringLiteral( "__ogc_fid" ) );
+  QString geometryFieldname( QStringLiteral( "__spatialite_geometry" ) );
+  mCacheTablename = QStringLiteral( "features" );
+
+  if ( !restoreFromPersistentCache && !createCacheDatabase( cacheFields, fidName, geometryFieldname ) )
+    return false;
+
+  // Some pragmas to speed-up writing. We don't need much integrity guarantee
+  // regarding crashes, since this is a temporary DB. A persistent DB is
+  // opened with synchronous=NORMAL, which in WAL mode is enough to survive a crash
+  QgsDataSourceUri dsURI;
+  dsURI.setDatabase( mCacheDbname );
+  dsURI.setDataSource( QString(), mCacheTablename, geometryFieldname, QString(), fidName );
+  QStringList pragmas;
+  pragmas << ( mPersistentCacheLock ? QStringLiteral( "synchronous=NORMAL" ) : QStringLiteral( "synchronous=OFF" ) );
+  pragmas << QStringLiteral( "journal_mode=WAL" ); // WAL is needed to avoid reader to block writers
+  dsURI.setParam( QStringLiteral( "pragma" ), pragmas );
+
+  QgsDataProvider::ProviderOptions providerOptions;
+  mCacheDataProvider.reset( dynamic_cast<QgsVectorDataProvider *>( QgsProviderRegistry::instance()->createProvider(
+                              QStringLiteral( "spatialite" ), dsURI.uri(), providerOptions ) ) );
+  if ( mCacheDataProvider && !mCacheDataProvider->isValid() )
+  {
+    mCacheDataProvider.reset();
+  }
+  if ( !mCacheDataProvider )
+  {
+    QgsMessageLog::logMessage( QObject::tr( "Cannot connect to temporary SpatiaLite cache" ), mComponentTranslated );
+    return false;
+  }
+
+  // The id_cache should be generated once for the lifetime of QgsBackgroundCachedFeatureIteratorConstants
+  // to ensure consistency of the ids returned to the user.
+  if ( mCacheIdDbname.isEmpty() )
+  {
+    mCacheIdDbname = QDir( cacheDirectory ).filePath( QStringLiteral( "id_cache_%1.sqlite" ).arg( tmpCounter ) );
+    Q_ASSERT( !QFile::exists( mCacheIdDbname ) );
+    if ( mCacheIdDb.open( mCacheIdDbname ) != SQLITE_OK )
+    {
+      QgsMessageLog::logMessage( QObject::tr( "Cannot create temporary id cache" ), mComponentTranslated );
+      return false;
+    }
+    QString errorMsg;
+    bool ok = mCacheIdDb.exec( QStringLiteral( "PRAGMA synchronous=OFF" ), errorMsg ) == SQLITE_OK;
+    // WAL is needed to avoid reader to block writers
+    ok &= mCacheIdDb.exec( QStringLiteral( "PRAGMA journal_mode=WAL" ), errorMsg ) == SQLITE_OK;
+    // uniqueId is the uniqueId or fid attribute coming from the GML GetFeature response
+    // qgisId is the feature id of the features returned to QGIS. That one should remain the same for a given uniqueId even after a layer reload
+    // dbId is the feature id of the Spatialite feature in mCacheDataProvider. It might change for a given uniqueId after a layer reload
+    ok &= mCacheIdDb.exec( QStringLiteral( "CREATE TABLE id_cache(uniqueId TEXT, dbId INTEGER, qgisId INTEGER)" ), errorMsg ) == SQLITE_OK;
+    ok &= mCacheIdDb.exec( QStringLiteral( "CREATE INDEX idx_uniqueId ON id_cache(uniqueId)" ), errorMsg ) == SQLITE_OK;
+    ok &= mCacheIdDb.exec( QStringLiteral( "CREATE INDEX idx_dbId ON id_cache(dbId)" ), errorMsg ) == SQLITE_OK;
+    ok &= mCacheIdDb.exec( QStringLiteral( "CREATE INDEX idx_qgisId ON id_cache(qgisId)" ), errorMsg ) == SQLITE_OK;
+    if ( !ok )
+    {
+      QgsDebugMsg( errorMsg );
+      return false;
+    }
+  }
+
+  if ( restoreFromPersistentCache )
+    restorePersistentCacheState();
+
+  return true;
+}
+
+bool QgsBackgroundCachedSharedData::createCacheDatabase( const QgsFields &cacheFields, const QString &fidName, const QString &geometryFieldname )
+{
   const auto logMessageWithReason = [this]( const QString & reason )
   {
     QgsMessageLog::logMessage( QStringLiteral( "%1: %2" ).arg( QObject::tr( "Cannot create temporary SpatiaLite cache." ) ).arg( reason ), mComponentTranslated );
@@ -213,7 +315,6 @@ bool QgsBackgroundCachedSharedData::createCache()
     return false;
   }
   const QString vsimemFilename = QStringLiteral( "/vsimem/qgis_cache_template_%1/features.sqlite" ).arg( reinterpret_cast< quintptr >( this ), QT_POINTER_SIZE * 2, 16, QLatin1Char( '0' ) );
-  mCacheTablename = CPLGetBasename( vsimemFilename.toStdString().c_str() );
   VSIUnlink( vsimemFilename.toStdString().c_str() );
   const char *apszOptions[] = { "INIT_WITH_EPSG=NO", "SPATIALITE=YES", nullptr };
   GDALDatasetH hDS = GDALCreate( hDrv, vsimemFilename.toUtf8().constData(), 0, 0, 0, GDT_Unknown, const_cast<char **>( apszOptions ) );
@@ -243,9 +344,6 @@ bool QgsBackgroundCachedSharedData::createCache()
   }
 
 
-  QString fidName( QStringLiteral( "__ogc_fid" ) );
-  QString geometryFieldname( QStringLiteral( "__spatialite_geometry" ) );
-
   spatialite_database_unique_ptr database;
   bool ret = true;
   int rc = database.open( mCacheDbname );
@@ -260,7 +358,6 @@ bool QgsBackgroundCachedSharedData::createCache()
 
     ( void )sqlite3_exec( database.get(), "BEGIN", nullptr, nullptr, nullptr );
 
-    mCacheTablename = QStringLiteral( "features" );
     sql = QStringLiteral( "CREATE TABLE %1 (%2 INTEGER PRIMARY KEY" ).arg( mCacheTablename, fidName );
 
     for ( const QgsField &field : qgis::as_const( cacheFields ) )
@@ -340,61 +437,156 @@ bool QgsBackgroundCachedSharedData::createCache()
     return false;
   }
 
-  // Some pragmas to speed-up writing. We don't need much integrity guarantee
-  // regarding crashes, since this is a temporary DB
-  QgsDataSourceUri dsURI;
-  dsURI.setDatabase( mCacheDbname );
-  dsURI.setDataSource( QString(), mCacheTablename, geometryFieldname, QString(), fidName );
-  QStringList pragmas;
-  pragmas << QStringLiteral( "synchronous=OFF" );
-  pragmas << QStringLiteral( "journal_mode=WAL" ); // WAL is needed to avoid reader to block writers
-  dsURI.setParam( QStringLiteral( "pragma" ), pragmas );
+  return true;
+}
 
-  QgsDataProvider::ProviderOptions providerOptions;
-  mCacheDataProvider.reset( dynamic_cast<QgsVectorDataProvider *>( QgsProviderRegistry::instance()->createProvider(
-                              QStringLiteral( "spatialite" ), dsURI.uri(), providerOptions ) ) );
-  if ( mCacheDataProvider && !mCacheDataProvider->isValid() )
+bool QgsBackgroundCachedSharedData::openPersistentCache( const QString &key, const QgsFields &cacheFields )
+{
+  // The name of the files depends on the schema of the cache too, since a
+  // SELECT statement changes the fields of the layer
+  QCryptographicHash hash( QCryptographicHash::Sha1 );
+  hash.addData( key.toUtf8() );
+  for ( const QgsField &field : cacheFields )
   {
-    mCacheDataProvider.reset();
+    hash.addData( QStringLiteral( "\n%1 %2" ).arg( field.name() ).arg( field.type() ).toUtf8() );
   }
-  if ( !mCacheDataProvider )
+  const QString baseName = QDir( mCacheDirectoryManager.persistentCacheDirectory( true ) ).filePath( QString::fromLatin1( hash.result().toHex() ) );
+
+  std::unique_ptr<QLockFile> lock = qgis::make_unique<QLockFile>( baseName + QStringLiteral( ".lock" ) );
+  if ( !lock->tryLock( 0 ) )
   {
-    QgsMessageLog::logMessage( QObject::tr( "Cannot connect to temporary SpatiaLite cache" ), mComponentTranslated );
+    QgsDebugMsg( QStringLiteral( "Persistent cache %1 is used by another layer. Using a temporary cache" ).arg( baseName ) );
     return false;
   }
 
-  // The id_cache should be generated once for the lifetime of QgsBackgroundCachedFeatureIteratorConstants
-  // to ensure consistency of the ids returned to the user.
-  if ( mCacheIdDbname.isEmpty() )
+  // Ids now come from the persistent id cache, so drop a temporary one
+  if ( !mCacheIdDbname.isEmpty() )
   {
-    mCacheIdDbname = QDir( cacheDirectory ).filePath( QStringLiteral( "id_cache_%1.sqlite" ).arg( tmpCounter ) );
-    Q_ASSERT( !QFile::exists( mCacheIdDbname ) );
-    if ( mCacheIdDb.open( mCacheIdDbname ) != SQLITE_OK )
+    mCacheIdDb.reset();
+    QFile::remove( mCacheIdDbname );
+    QFile::remove( mCacheIdDbname + "-wal" );
+    QFile::remove( mCacheIdDbname + "-shm" );
+    releaseCacheDirectory();
+    mCacheIdDbname.clear();
+  }
+
+  const QString idDbname = baseName + QStringLiteral( "_ids.sqlite" );
+  if ( mCacheIdDb.open( idDbname ) != SQLITE_OK )
+  {
+    QgsMessageLog::logMessage( QObject::tr( "Cannot open persistent id cache %1" ).arg( idDbname ), mComponentTranslated );
+    mCacheIdDb.reset();
+    return false;
+  }
+  QString errorMsg;
+  bool ok = mCacheIdDb.exec( QStringLiteral( "PRAGMA synchronous=NORMAL" ), errorMsg ) == SQLITE_OK;
+  ok &= mCacheIdDb.exec( QStringLiteral( "PRAGMA journal_mode=WAL" ), errorMsg ) == SQLITE_OK;
+  ok &= mCacheIdDb.exec( QStringLiteral( "CREATE TABLE IF NOT EXISTS id_cache(uniqueId TEXT, dbId INTEGER, qgisId INTEGER)" ), errorMsg ) == SQLITE_OK;
+  ok &= mCacheIdDb.exec( QStringLiteral( "CREATE INDEX IF NOT EXISTS idx_uniqueId ON id_cache(uniqueId)" ), errorMsg ) == SQLITE_OK;
+  ok &= mCacheIdDb.exec( QStringLiteral( "CREATE INDEX IF NOT EXISTS idx_dbId ON id_cache(dbId)" ), errorMsg ) == SQLITE_OK;
+  ok &= mCacheIdDb.exec( QStringLiteral( "CREATE INDEX IF NOT EXISTS idx_qgisId ON id_cache(qgisId)" ), errorMsg ) == SQLITE_OK;
+  // downloadLimit has the same meaning as the attribute of mRegions
+  ok &= mCacheIdDb.exec( QStringLiteral( "CREATE TABLE IF NOT EXISTS regions(xmin REAL, ymin REAL, xmax REAL, ymax REAL, downloadLimit INTEGER)" ), errorMsg ) == SQLITE_OK;
+  ok &= mCacheIdDb.exec( QStringLiteral( "CREATE TABLE IF NOT EXISTS metadata(key TEXT PRIMARY KEY, value TEXT)" ), errorMsg ) == SQLITE_OK;
+  if ( !ok )
+  {
+    QgsDebugMsg( errorMsg );
+    mCacheIdDb.reset();
+    return false;
+  }
+
+  mPersistentCacheLock = std::move( lock );
+  mCacheIdDbname = idDbname;
+  mCacheDbname = baseName + QStringLiteral( ".sqlite" );
+
+  // Make sure that new ids do not collide with the ones of previous sessions
+  int resultCode;
+  auto stmt = mCacheIdDb.prepare( QStringLiteral( "SELECT MAX(qgisId) FROM id_cache" ), resultCode );
+  if ( resultCode == SQLITE_OK && stmt.step() == SQLITE_ROW )
+  {
+    mNextCachedIdQgisId = std::max( mNextCachedIdQgisId, static_cast<QgsFeatureId>( stmt.columnAsInt64( 0 ) + 1 ) );
+  }
+
+  bool reusable = QFile::exists( mCacheDbname ) && !persistentCacheMetadata( QStringLiteral( "created" ) ).isEmpty();
+  if ( reusable && mPersistentCacheMaxAge > 0 )
+  {
+    const qint64 age = QDateTime::currentDateTimeUtc().toSecsSinceEpoch() - persistentCacheMetadata( QStringLiteral( "created" ) ).toLongLong();
+    if ( age < 0 || age > mPersistentCacheMaxAge )
     {
-      QgsMessageLog::logMessage( QObject::tr( "Cannot create temporary id cache" ), mComponentTranslated );
-      return false;
+      QgsDebugMsgLevel( QStringLiteral( "Persistent cache %1 has expired" ).arg( mCacheDbname ), 4 );
+      reusable = false;
     }
-    QString errorMsg;
-    bool ok = mCacheIdDb.exec( QStringLiteral( "PRAGMA synchronous=OFF" ), errorMsg ) == SQLITE_OK;
-    // WAL is needed to avoid reader to block writers
-    ok &= mCacheIdDb.exec( QStringLiteral( "PRAGMA journal_mode=WAL" ), errorMsg ) == SQLITE_OK;
-    // uniqueId is the uniqueId or fid attribute coming from the GML GetFeature response
-    // qgisId is the feature id of the features returned to QGIS. That one should remain the same for a given uniqueId even after a layer reload
-    // dbId is the feature id of the Spatialite feature in mCacheDataProvider. It might change for a given uniqueId after a layer reload
-    ok &= mCacheIdDb.exec( QStringLiteral( "CREATE TABLE id_cache(uniqueId TEXT, dbId INTEGER, qgisId INTEGER)" ), errorMsg ) == SQLITE_OK;
-    ok &= mCacheIdDb.exec( QStringLiteral( "CREATE INDEX idx_uniqueId ON id_cache(uniqueId)" ), errorMsg ) == SQLITE_OK;
-    ok &= mCacheIdDb.exec( QStringLiteral( "CREATE INDEX idx_dbId ON id_cache(dbId)" ), errorMsg ) == SQLITE_OK;
-    ok &= mCacheIdDb.exec( QStringLiteral( "CREATE INDEX idx_qgisId ON id_cache(qgisId)" ), errorMsg ) == SQLITE_OK;
-    if ( !ok )
-    {
+  }
+
+  if ( !reusable )
+  {
+    QFile::remove( mCacheDbname );
+    QFile::remove( mCacheDbname + "-wal" );
+    QFile::remove( mCacheDbname + "-shm" );
+    if ( mCacheIdDb.exec( QStringLiteral( "DELETE FROM regions; DELETE FROM metadata" ), errorMsg ) != SQLITE_OK )
       QgsDebugMsg( errorMsg );
-      return false;
-    }
+    setPersistentCacheMetadata( QStringLiteral( "created" ), QString::number( QDateTime::currentDateTimeUtc().toSecsSinceEpoch() ) );
   }
 
   return true;
 }
 
+void QgsBackgroundCachedSharedData::restorePersistentCacheState()
+{
+  int resultCode;
+  auto stmt = mCacheIdDb.prepare( QStringLiteral( "SELECT xmin, ymin, xmax, ymax, downloadLimit FROM regions" ), resultCode );
+  if ( resultCode == SQLITE_OK )
+  {
+    while ( stmt.step() == SQLITE_ROW )
+    {
+      QgsFeature f;
+      f.setGeometry( QgsGeometry::fromRect( QgsRectangle( stmt.columnAsDouble( 0 ), stmt.columnAsDouble( 1 ),
+                     stmt.columnAsDouble( 2 ), stmt.columnAsDouble( 3 ) ) ) );
+      f.setId( mRegions.size() );
+      f.initAttributes( 1 );
+      f.setAttribute( 0, QVariant( stmt.columnAsInt64( 4 ) != 0 ) );
+      mRegions.push_back( f );
+      mCachedRegions.addFeature( f );
+    }
+  }
+
+  mCacheComplete = persistentCacheMetadata( QStringLiteral( "complete" ) ) == QLatin1String( "1" );
+  mFeatureCount = static_cast<int>( mCacheDataProvider->featureCount() );
+  mFeatureCountExact = mCacheComplete;
+  mTotalFeaturesAttemptedToBeCached = mFeatureCount;
+  // The geometries of the cache are the bounding boxes of the features
+  mComputedExtent = mCacheDataProvider->extent();
+
+  // Features of the previous sessions must be seen as already cached by the
+  // iterators, so continue their generation counter
+  const int genCounterIdx = mCacheDataProvider->fields().indexFromName( QgsBackgroundCachedFeatureIteratorConstants::FIELD_GEN_COUNTER );
+  const QVariant maxGenCounter = mCacheDataProvider->maximumValue( genCounterIdx );
+  if ( !maxGenCounter.isNull() )
+    mGenCounter = maxGenCounter.toInt() + 1;
+
+  QgsDebugMsgLevel( QStringLiteral( "Restored %1 features and %2 regions from persistent cache %3" ).arg( mFeatureCount ).arg( mRegions.size() ).arg( mCacheDbname ), 4 );
+}
+
+QString QgsBackgroundCachedSharedData::persistentCacheMetadata( const QString &key ) const
+{
+  QString sql = qgs_sqlite3_mprintf( "SELECT value FROM metadata WHERE key = '%q'", key.toUtf8().constData() );
+  int resultCode;
+  auto stmt = mCacheIdDb.prepare( sql, resultCode );
+  if ( resultCode == SQLITE_OK && stmt.step() == SQLITE_ROW )
+    return stmt.columnAsText( 0 );
+  return QString();
+}
+
+void QgsBackgroundCachedSharedData::setPersistentCacheMetadata( const QString &key, const QString &value )
+{
+  QString sql = qgs_sqlite3_mprintf( "INSERT OR REPLACE INTO metadata (key, value) VALUES ('%q', '%q')",
+                                     key.toUtf8().constData(), value.toUtf8().constData() );
+  QString errorMsg;
+  if ( mCacheIdDb.exec( sql, errorMsg ) != SQLITE_OK )
+  {
+    QgsMessageLog::logMessage( QObject::tr( "Problem when updating persistent cache: %1 -> %2" ).arg( sql ).arg( errorMsg ), mComponentTranslated );
+  }
+}
+
 int QgsBackgroundCachedSharedData::registerToCache( QgsBackgroundCachedFeatureIterator *iterator, int limit, const QgsRectangle &rect )
 {
   // This locks prevents 2 readers to register at the same time (and particularly
@@ -422,6 +614,7 @@ int QgsBackgroundCachedSharedData::registerToCache( QgsBackgroundCachedFeatureIt
   // when "Only request features overlapping the view extent" : the offline editor
   // want to request all features whereas the map renderer only the view)
   bool newDownloadNeeded = false;
+  bool cachedRegionsCoverRequest = false;
   if ( !rect.isEmpty() && mRect != rect && !( mDownloader && mRect.isEmpty() ) )
   {
     QList<QgsFeatureId> intersectingRequests = mCachedRegions.intersects( rect );
@@ -439,6 +632,7 @@ int QgsBackgroundCachedSharedData::registerToCache( QgsBackgroundCachedFeatureIt
       {
         QgsDebugMsgLevel( QStringLiteral( "Cached features already cover this area of interest" ), 4 );
         newDownloadNeeded = false;
+        cachedRegionsCoverRequest = true;
         break;
       }
 
@@ -450,6 +644,7 @@ int QgsBackgroundCachedSharedData::registerToCache( QgsBackgroundCachedFeatureIt
       {
         QgsDebugMsgLevel( QStringLiteral( "Current request is larger than a smaller request that hit the download limit, so no server download needed." ), 4 );
         newDownloadNeeded = false;
+        cachedRegionsCoverRequest = true;
         break;
       }
     }
@@ -467,6 +662,15 @@ int QgsBackgroundCachedSharedData::registerToCache( QgsBackgroundCachedFeatureIt
     newDownloadNeeded = true;
   }
 
+  // A cache restored from a previous session has no downloader, but might
+  // already hold the requested features
+  if ( !mDownloader && ( mCacheComplete || cachedRegionsCoverRequest ) )
+  {
+    QgsDebugMsgLevel( QStringLiteral( "Request served from the persistent cache" ), 4 );
+    mDownloadFinished = true;
+    return -1;
+  }
+
   if ( newDownloadNeeded || !mDownloader )
   {
     mRect = rect;
@@ -797,6 +1001,12 @@ void QgsBackgroundCachedSharedData::endOfDownload( bool success, int featureCoun
     {
       mRegions.clear();
       mCachedRegions = QgsSpatialIndex();
+      if ( mPersistentCacheLock )
+      {
+        QString errorMsg;
+        if ( mCacheIdDb.exec( QStringLiteral( "DELETE FROM regions" ), errorMsg ) != SQLITE_OK )
+          QgsDebugMsg( errorMsg );
+      }
     }
 
     if ( mRequestLimit == 0 )
@@ -811,9 +1021,28 @@ void QgsBackgroundCachedSharedData::endOfDownload( bool success, int featureCoun
       f.setAttribute( 0, QVariant( bDownloadLimit ) );
       mRegions.push_back( f );
       mCachedRegions.addFeature( f );
+
+      if ( mPersistentCacheLock )
+      {
+        QString sql = qgs_sqlite3_mprintf( "INSERT INTO regions (xmin, ymin, xmax, ymax, downloadLimit) VALUES (%.17g, %.17g, %.17g, %.17g, %d)",
+                                           mRect.xMinimum(), mRect.yMinimum(), mRect.xMaximum(), mRect.yMaximum(),
+                                           bDownloadLimit ? 1 : 0 );
+        QString errorMsg;
+        if ( mCacheIdDb.exec( sql, errorMsg ) != SQLITE_OK )
+        {
+          QgsMessageLog::logMessage( QObject::tr( "Problem when updating persistent cache: %1 -> %2" ).arg( sql ).arg( errorMsg ), mComponentTranslated );
+        }
+      }
     }
   }
 
+  if ( mRect.isEmpty() && success && !bDownloadLimit && mRequestLimit == 0 && !mCacheComplete )
+  {
+    mCacheComplete = true;
+    if ( mPersistentCacheLock )
+      setPersistentCacheMetadata( QStringLiteral( "complete" ), QStringLiteral( "1" ) );
+  }
+
   if ( mRect.isEmpty() && success && !bDownloadLimit && mRequestLimit == 0 && !mFeatureCountExact )
   {
     mFeatureCountExact = true;
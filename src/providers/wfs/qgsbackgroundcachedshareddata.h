@@ -21,6 +21,7 @@
 #include "qgsspatialiteutils.h"
 #include "qgscachedirectorymanager.h"
 
+#include <QLockFile>
 #include <QSet>
 
 #include <map>
@@ -54,6 +55,14 @@ class QgsThreadedFeatureDownloader;
  *
  *  It contains also methods used in WFS-T context to update the cache content,
  *  from the changes initiated by the user.
+ *
+ *  When the implementation returns a non-empty persistentCacheKey(), the cache
+ *  and the id cache are stored in the persistent cache directory, under a name
+ *  derived from that key, and are kept when the layer is closed. The id cache
+ *  database then also holds a "regions" table with the extents already
+ *  downloaded, and a "metadata" table with the creation time of the cache and
+ *  whether it holds all the features of the layer. A later session
+ *  can thus reuse the features and only download the areas not covered yet.
  */
 class QgsBackgroundCachedSharedData
 {
@@ -78,6 +87,7 @@ class QgsBackgroundCachedSharedData
     /**
      * Used by provider's reloadData(). The effect is to invalid
      * all the caching state, so that a new request results in fresh download.
+     * A persistent cache is discarded too.
     */
     void invalidateCache();
 
@@ -210,6 +220,9 @@ class QgsBackgroundCachedSharedData
     //! Whether progress dialog should be hidden
     bool mHideProgressDialog = false;
 
+    //! Maximum age in seconds of a persistent cache before it is discarded. Valid if > 0
+    int mPersistentCacheMaxAge = 0;
+
     //////////// Methods
 
     //! Should be called in the destructor of the implementation of this class !
@@ -277,6 +290,12 @@ class QgsBackgroundCachedSharedData
     //! Connection to mCacheIdDbname
     sqlite3_database_unique_ptr mCacheIdDb;
 
+    //! Lock on the persistent cache files. Only set when a persistent cache is in use
+    std::unique_ptr<QLockFile> mPersistentCacheLock;
+
+    //! Whether the cache holds all the features of the layer
+    bool mCacheComplete = false;
+
     //! Map each user visible field name to the column name in the spatialite DB cache
     // This is useful when there are user visible fields with same name, but different case
     std::map<QString, QString> mMapUserVisibleFieldNameToSpatialiteColumnName;
@@ -304,6 +323,30 @@ class QgsBackgroundCachedSharedData
     //! Create the on-disk cache and connect to it
     bool createCache();
 
+    //! Create the SpatiaLite database of the on-disk cache, mCacheDbname
+    bool createCacheDatabase( const QgsFields &cacheFields, const QString &fidName, const QString &geometryFieldname );
+
+    /**
+     * Open (or create) the persistent cache matching the key and the cache fields.
+     * On success, mCacheDbname and mCacheIdDbname point to the persistent files,
+     * and mCacheDbname only exists if it holds features that can be reused.
+     * Returns false if the persistent cache cannot be used, for example because
+     * another layer is using it.
+     */
+    bool openPersistentCache( const QString &key, const QgsFields &cacheFields );
+
+    //! Restore the state of a previous session from the persistent cache
+    void restorePersistentCacheState();
+
+    //! Returns a value of the metadata table of the persistent cache
+    QString persistentCacheMetadata( const QString &key ) const;
+
+    //! Sets a value of the metadata table of the persistent cache
+    void setPersistentCacheMetadata( const QString &key, const QString &value );
+
+    //! Implementation of invalidateCache() and cleanup(). The latter keeps the persistent cache on disk
+    void closeCache( bool discardPersistentCache );
+
     /**
      * Returns the set of unique ids that have already been downloaded and
      * cached, so as to avoid to cache duplicates.
@@ -341,6 +384,9 @@ class QgsBackgroundCachedSharedData
 
     //! Launch a synchronous request to count the number of features (return -1 in case of error)
     virtual int getFeatureCountFromServer() const = 0;
+
+    //! Returns the key identifying the persistent cache of the layer, or an empty string to use a temporary cache
+    virtual QString persistentCacheKey() const { return QString(); }
 };
 
 #endif
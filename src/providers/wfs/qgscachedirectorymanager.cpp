@@ -131,6 +131,22 @@ void QgsCacheDirectoryManager::releaseCacheDirectory()
   }
 }
 
+QString QgsCacheDirectoryManager::persistentCacheDirectory( bool createIfNotExisting )
+{
+  QString baseDirectory( getBaseCacheDirectory( createIfNotExisting ) );
+  QString persistentPath( QStringLiteral( "persistent" ) );
+  if ( createIfNotExisting )
+  {
+    QMutexLocker locker( &mMutex );
+    if ( !QDir( baseDirectory ).exists( persistentPath ) )
+    {
+      QgsDebugMsg( QStringLiteral( "Creating persistent cache dir %1/%2" ).arg( baseDirectory, persistentPath ) );
+      QDir( baseDirectory ).mkpath( persistentPath );
+    }
+  }
+  return QDir( baseDirectory ).filePath( persistentPath );
+}
+
 bool QgsCacheDirectoryManager::removeDir( const QString &dirName )
 {
   QDir dir( dirName );
@@ -37,6 +37,13 @@ class QgsCacheDirectoryManager
     //! To be called when a temporary file is removed from the directory
     void releaseCacheDirectory();
 
+    /**
+     * Returns the name of the directory that holds the caches that are kept
+     * between sessions. Unlike the temporary directory, it is not bound to
+     * the lifetime of the current process.
+     */
+    QString persistentCacheDirectory( bool createIfNotExisting );
+
     //! Return the singleton for the given provider.
     static QgsCacheDirectoryManager &singleton( const QString &providerName );
 
@@ -352,6 +352,7 @@ QgsOapifSharedData::QgsOapifSharedData( const QString &uri )
   , mURI( uri )
 {
   mHideProgressDialog = mURI.hideDownloadProgressDialog();
+  mPersistentCacheMaxAge = mURI.persistentCacheMaxAge();
 }
 
 QgsOapifSharedData::~QgsOapifSharedData()
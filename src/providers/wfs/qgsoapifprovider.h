@@ -203,6 +203,8 @@ class QgsOapifSharedData final: public QObject, public QgsBackgroundCachedShared
     QgsRectangle getExtentFromSingleFeatureRequest() const override { return QgsRectangle(); }
 
     int getFeatureCountFromServer() const override { return -1; }
+
+    QString persistentCacheKey() const override { return mURI.persistentCache() ? mURI.uri() : QString(); }
 };
 
 
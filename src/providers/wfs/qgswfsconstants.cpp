@@ -41,6 +41,8 @@ const QString QgsWFSConstants::URI_PARAM_HIDEDOWNLOADPROGRESSDIALOG( QStringLite
 const QString QgsWFSConstants::URI_PARAM_PAGING_ENABLED( "pagingEnabled" );
 const QString QgsWFSConstants::URI_PARAM_PAGE_SIZE( "pageSize" );
 const QString QgsWFSConstants::URI_PARAM_WFST_1_1_PREFER_COORDINATES( "preferCoordinatesForWfsT11" );
+const QString QgsWFSConstants::URI_PARAM_PERSISTENT_CACHE( "persistentCache" );
+const QString QgsWFSConstants::URI_PARAM_PERSISTENT_CACHE_MAX_AGE( "persistentCacheMaxAge" );
 
 const QString QgsWFSConstants::VERSION_AUTO( QStringLiteral( "auto" ) );
 
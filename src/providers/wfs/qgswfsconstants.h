@@ -49,6 +49,8 @@ struct QgsWFSConstants
   static const QString URI_PARAM_PAGING_ENABLED;
   static const QString URI_PARAM_PAGE_SIZE;
   static const QString URI_PARAM_WFST_1_1_PREFER_COORDINATES;
+  static const QString URI_PARAM_PERSISTENT_CACHE;
+  static const QString URI_PARAM_PERSISTENT_CACHE_MAX_AGE;
 
   //
   static const QString VERSION_AUTO;
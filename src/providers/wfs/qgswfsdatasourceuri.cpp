@@ -380,6 +380,20 @@ bool QgsWFSDataSourceURI::preferCoordinatesForWfst11() const
          mURI.param( QgsWFSConstants::URI_PARAM_WFST_1_1_PREFER_COORDINATES ).toUpper() == QLatin1String( "TRUE" );
 }
 
+bool QgsWFSDataSourceURI::persistentCache() const
+{
+  return mURI.hasParam( QgsWFSConstants::URI_PARAM_PERSISTENT_CACHE ) &&
+         mURI.param( QgsWFSConstants::URI_PARAM_PERSISTENT_CACHE ).toUpper() == QLatin1String( "TRUE" );
+}
+
+int QgsWFSDataSourceURI::persistentCacheMaxAge() const
+{
+  // One day by default
+  if ( !mURI.hasParam( QgsWFSConstants::URI_PARAM_PERSISTENT_CACHE_MAX_AGE ) )
+    return 24 * 3600;
+  return mURI.param( QgsWFSConstants::URI_PARAM_PERSISTENT_CACHE_MAX_AGE ).toInt();
+}
+
 QString QgsWFSDataSourceURI::build( const QString &baseUri,
                                     const QString &typeName,
                                     const QString &crsString,
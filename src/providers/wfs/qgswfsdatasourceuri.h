@@ -116,6 +116,12 @@ class QgsWFSDataSourceURI
     //! Whether to use "coordinates" instead of "pos" and "posList" for WFS-T 1.1 transactions (ESRI mapserver)
     bool preferCoordinatesForWfst11() const;
 
+    //! Whether downloaded features should be kept in an on-disk cache that survives the session. Defaults to false
+    bool persistentCache() const;
+
+    //! Returns the maximum age, in seconds, of a persistent cache before it is discarded. 0=no limitation
+    int persistentCacheMaxAge() const;
+
     //! Returns authorization parameters
     const QgsAuthorizationSettings &auth() const { return mAuth; }
 
@@ -27,6 +27,7 @@ QgsWFSSharedData::QgsWFSSharedData( const QString &uri )
   , mURI( uri )
 {
   mHideProgressDialog = mURI.hideDownloadProgressDialog();
+  mPersistentCacheMaxAge = mURI.persistentCacheMaxAge();
   mServerPrefersCoordinatesForTransactions_1_1 = mURI.preferCoordinatesForWfst11();
 }
 
@@ -128,6 +128,8 @@ class QgsWFSSharedData : public QObject, public QgsBackgroundCachedSharedData
     QgsRectangle getExtentFromSingleFeatureRequest() const override;
 
     int getFeatureCountFromServer() const override;
+
+    QString persistentCacheKey() const override { return mURI.persistentCache() ? mURI.uri() : QString(); }
 };
 
 //! Utility class to issue a GetFeature resultType=hits request
@@ -21,13 +21,21 @@
 #include "qgsserver.h"
 #include "qgsfcgiserverresponse.h"
 #include "qgsfcgiserverrequest.h"
+#include "qgsbufferserverrequest.h"
+#include "qgsbufferserverresponse.h"
+#include "qgsserverworkerpool.h"
+#include "qgsserverexception.h"
+#include "qgsconfigcache.h"
+#include "qgsmessagelog.h"
 #include "qgsapplication.h"
 
 #include <fcgi_stdio.h>
 #include <cstdlib>
+#include <algorithm>
 
 #include <QFontDatabase>
 #include <QString>
+#include <QUrl>
 
 int fcgi_accept()
 {
@@ -41,6 +49,203 @@ int fcgi_accept()
 #endif
 }
 
+///@cond PRIVATE
+
+/**
+ * Returns the value of the parameter \a name of a FastCGI request.
+ */
+QString fcgiParam( FCGX_Request *fcgiRequest, const char *name )
+{
+  return QString( FCGX_GetParam( name, fcgiRequest->envp ) );
+}
+
+/**
+ * Builds a buffered server request from a FastCGI request accepted with FCGX_Accept_r(),
+ * the same way QgsFcgiServerRequest does from the process environment with FCGI_Accept().
+ */
+std::unique_ptr<QgsBufferServerRequest> bufferServerRequest( FCGX_Request *fcgiRequest, bool &hasError )
+{
+  hasError = false;
+
+  QString uri = fcgiParam( fcgiRequest, "REQUEST_URI" );
+  if ( uri.isEmpty() )
+  {
+    uri = fcgiParam( fcgiRequest, "SCRIPT_NAME" );
+  }
+
+  QUrl url( uri );
+  if ( url.host().isEmpty() )
+  {
+    url.setHost( fcgiParam( fcgiRequest, "SERVER_NAME" ) );
+  }
+
+  if ( url.port( -1 ) == -1 )
+  {
+    bool portOk;
+    const int portNumber = fcgiParam( fcgiRequest, "SERVER_PORT" ).toInt( &portOk );
+    if ( portOk && portNumber != 80 )
+    {
+      url.setPort( portNumber );
+    }
+  }
+
+  if ( url.scheme().isEmpty() )
+  {
+    url.setScheme( fcgiParam( fcgiRequest, "HTTPS" ).compare( QLatin1String( "on" ), Qt::CaseInsensitive ) == 0
+                   ? QStringLiteral( "https" ) : QStringLiteral( "http" ) );
+  }
+
+  const QUrl originalUrl = url;
+  if ( FCGX_GetParam( "QUERY_STRING", fcgiRequest->envp ) )
+  {
+    url.setQuery( fcgiParam( fcgiRequest, "QUERY_STRING" ) );
+  }
+
+  QgsServerRequest::Method method = QgsServerRequest::GetMethod;
+  const QString methodString = fcgiParam( fcgiRequest, "REQUEST_METHOD" );
+  if ( methodString == QLatin1String( "POST" ) )
+    method = QgsServerRequest::PostMethod;
+  else if ( methodString == QLatin1String( "PUT" ) )
+    method = QgsServerRequest::PutMethod;
+  else if ( methodString == QLatin1String( "DELETE" ) )
+    method = QgsServerRequest::DeleteMethod;
+  else if ( methodString == QLatin1String( "HEAD" ) )
+    method = QgsServerRequest::HeadMethod;
+  else if ( methodString == QLatin1String( "PATCH" ) )
+    method = QgsServerRequest::PatchMethod;
+
+  // Get post/put data
+  QByteArray data;
+  if ( method == QgsServerRequest::PostMethod || method == QgsServerRequest::PutMethod )
+  {
+    const QString lengthString = fcgiParam( fcgiRequest, "CONTENT_LENGTH" );
+    if ( !lengthString.isEmpty() )
+    {
+      bool success = false;
+      const int length = lengthString.toInt( &success );
+      if ( success && length > 0 )
+      {
+        data.resize( length );
+        data.resize( std::max( 0, FCGX_GetStr( data.data(), length, fcgiRequest->in ) ) );
+      }
+      else if ( !success )
+      {
+        QgsMessageLog::logMessage( "fcgi: Failed to parse CONTENT_LENGTH", QStringLiteral( "Server" ), Qgis::Critical );
+        hasError = true;
+      }
+    }
+  }
+
+  QgsServerRequest::Headers headers;
+  // Get accept header for content-type negotiation
+  if ( FCGX_GetParam( "HTTP_ACCEPT", fcgiRequest->envp ) )
+  {
+    headers.insert( QStringLiteral( "Accept" ), fcgiParam( fcgiRequest, "HTTP_ACCEPT" ) );
+  }
+
+  // The request is created with the original url and then gets the rewritten one
+  std::unique_ptr<QgsBufferServerRequest> request = qgis::make_unique<QgsBufferServerRequest>( originalUrl, method, headers, &data );
+  request->setUrl( url );
+  return request;
+}
+
+/**
+ * Sends a response to a FastCGI request and finishes it.
+ */
+void sendFcgiResponse( FCGX_Request *fcgiRequest, int statusCode, const QMap<QString, QString> &headers, const QByteArray &body, bool headOnly )
+{
+  QByteArray header = QStringLiteral( "Status: %1\n" ).arg( statusCode ).toUtf8();
+  for ( auto it = headers.constBegin(); it != headers.constEnd(); ++it )
+  {
+    header.append( QStringLiteral( "%1: %2\n" ).arg( it.key(), it.value() ).toUtf8() );
+  }
+  if ( ! headers.contains( QStringLiteral( "Content-Length" ) ) )
+  {
+    header.append( QStringLiteral( "Content-Length: %1\n" ).arg( body.size() ).toUtf8() );
+  }
+  header.append( '\n' );
+
+  FCGX_PutStr( header.constData(), header.size(), fcgiRequest->out );
+  if ( !headOnly && !body.isEmpty() )
+  {
+    FCGX_PutStr( body.constData(), body.size(), fcgiRequest->out );
+  }
+  FCGX_Finish_r( fcgiRequest );
+}
+
+/**
+ * Accepts FastCGI requests and hands them over to the worker threads of \a pool.
+ *
+ * Requests are rejected with a 503 status code when all the workers are busy
+ * and the queue is full.
+ */
+void fcgiWorkerPoolLoop( QgsServerWorkerPool &pool )
+{
+  FCGX_Init();
+
+  while ( true )
+  {
+    // The request is finished, and its memory freed, by sendFcgiResponse()
+    std::shared_ptr<FCGX_Request> fcgiRequest = std::make_shared<FCGX_Request>();
+    FCGX_InitRequest( fcgiRequest.get(), 0, 0 );
+    if ( FCGX_Accept_r( fcgiRequest.get() ) < 0 )
+      break;
+
+    const bool accepted = pool.submit( [fcgiRequest]( QgsServer & server )
+    {
+      bool hasError = false;
+      std::unique_ptr<QgsBufferServerRequest> request = bufferServerRequest( fcgiRequest.get(), hasError );
+      QgsBufferServerResponse response;
+      if ( hasError )
+      {
+        response.sendError( 400, "Bad request" );
+      }
+      else
+      {
+        // The project file may be set per request by the web server, the process environment
+        // cannot be used as with FCGI_Accept() as it is shared by all the threads
+        const QString projectFile = fcgiParam( fcgiRequest.get(), "QGIS_PROJECT_FILE" );
+        QgsServerSettings *settings = server.serverInterface()->serverSettings();
+        QgsProject *project = nullptr;
+        if ( !projectFile.isEmpty() && settings->projectFile().isEmpty() && request->serverParameters().map().isEmpty() )
+        {
+          try
+          {
+            project = QgsConfigCache::instance()->acquireProject( projectFile, settings );
+          }
+          catch ( QgsServerException &ex )
+          {
+            QgsMessageLog::logMessage( ex.message(), QStringLiteral( "Server" ), Qgis::Critical );
+          }
+        }
+        server.handleRequest( *request, response, project );
+        if ( project )
+        {
+          QgsConfigCache::instance()->releaseProject( project );
+        }
+      }
+      sendFcgiResponse( fcgiRequest.get(), response.statusCode(), response.headers(), response.body(),
+                        request->method() == QgsServerRequest::HeadMethod );
+    } );
+
+    if ( !accepted )
+    {
+      // Backpressure: all the workers are busy and the queue is full
+      const QgsServerWorkerPool::Metrics metrics = pool.metrics();
+      QgsMessageLog::logMessage( QStringLiteral( "Server busy, request rejected: %1 requests queued, %2 rejected so far" )
+                                 .arg( metrics.queuedJobs ).arg( metrics.rejectedJobs ), QStringLiteral( "Server" ), Qgis::Warning );
+      const QMap<QString, QString> headers
+      {
+        { QStringLiteral( "Content-Type" ), QStringLiteral( "text/plain" ) },
+        { QStringLiteral( "Retry-After" ), QStringLiteral( "1" ) }
+      };
+      sendFcgiResponse( fcgiRequest.get(), 503, headers, QByteArrayLiteral( "Server busy" ), false );
+    }
+  }
+}
+
+///@endcond
+
 int main( int argc, char *argv[] )
 {
   // Test if the environ variable DISPLAY is defined
@@ -73,6 +278,18 @@ int main( int argc, char *argv[] )
   QFontDatabase fontDB;
 #endif
 
+  // Handle the requests with a pool of worker threads if configured
+  const int workerCount = QgsServerWorkerPool::configuredWorkerCount( server );
+  if ( workerCount > 1 && !FCGX_IsCGI() )
+  {
+    QgsMessageLog::logMessage( QStringLiteral( "Handling requests with %1 worker threads" ).arg( workerCount ), QStringLiteral( "Server" ), Qgis::Info );
+    QgsServerWorkerPool pool( workerCount, server.serverInterface()->serverSettings()->maxQueuedRequests() );
+    fcgiWorkerPoolLoop( pool );
+    pool.stop();
+    app.exitQgis();
+    return 0;
+  }
+
   // Starts FCGI loop
   while ( fcgi_accept() >= 0 )
   {
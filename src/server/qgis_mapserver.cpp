@@ -33,6 +33,7 @@ while QGIS server internal logging is printed to stderr.
 #include "qgsbufferserverresponse.h"
 #include "qgsapplication.h"
 #include "qgsmessagelog.h"
+#include "qgsserverworkerpool.h"
 
 #include <QFontDatabase>
 #include <QString>
@@ -41,6 +42,8 @@ while QGIS server internal logging is printed to stderr.
 #include <QNetworkInterface>
 #include <QCommandLineParser>
 #include <QObject>
+#include <QMutex>
+#include <QPointer>
 
 
 #ifndef Q_OS_WIN
@@ -194,6 +197,20 @@ int main( int argc, char *argv[] )
   // Disable parallel rendering because if its internal loop
   //qputenv( "QGIS_SERVER_PARALLEL_RENDERING", "0" );
 
+  // Responses of the requests handled by worker threads, they are sent by the main loop
+  struct FinishedRequest
+  {
+    QPointer<QTcpSocket> connection;
+    QString requestLine;
+    int statusCode;
+    QMap<QString, QString> headers;
+    QByteArray body;
+    std::chrono::steady_clock::time_point start;
+  };
+  QMutex finishedRequestsMutex;
+  QList<FinishedRequest> finishedRequests;
+  std::unique_ptr<QgsServerWorkerPool> workerPool;
+
   // Create server
   QTcpServer tcpServer;
 
@@ -239,12 +256,71 @@ int main( int argc, char *argv[] )
     server.initPython();
 #endif
 
+    const int workerCount { QgsServerWorkerPool::configuredWorkerCount( server ) };
+    if ( workerCount > 1 )
+    {
+      workerPool = qgis::make_unique<QgsServerWorkerPool>( workerCount, server.serverInterface()->serverSettings()->maxQueuedRequests() );
+    }
+
     std::cout << QObject::tr( "QGIS Development Server listening on http://%1:%2" )
               .arg( ipAddress ).arg( port ).toStdString() << std::endl;
+    if ( workerPool )
+    {
+      std::cout << QObject::tr( "Handling requests with %1 worker threads" ).arg( workerCount ).toStdString() << std::endl;
+    }
 #ifndef Q_OS_WIN
     std::cout << QObject::tr( "CTRL+C to exit" ).toStdString() << std::endl;
 #endif
 
+    // Output stream: send response
+    auto sendResponse = [ & ]( QTcpSocket * clientConnection, const QString & requestLine, int statusCode,
+                               const QMap<QString, QString> &responseHeaders, const QByteArray & body,
+                               std::chrono::steady_clock::duration elapsedTime )
+    {
+      clientConnection->write( QStringLiteral( "HTTP/1.0 %1 %2\r\n" ).arg( statusCode ).arg( knownStatuses.value( statusCode ) ).toUtf8() );
+      clientConnection->write( QStringLiteral( "Server: QGIS\r\n" ).toUtf8() );
+      for ( auto it = responseHeaders.constBegin(); it != responseHeaders.constEnd(); ++it )
+      {
+        clientConnection->write( QStringLiteral( "%1: %2\r\n" ).arg( it.key(), it.value() ).toUtf8() );
+      }
+      clientConnection->write( "\r\n" );
+      clientConnection->write( body );
+
+      // 10.185.248.71 [09/Jan/2015:19:12:06 +0000] 808840 <time> "GET / HTTP/1.1" 500"
+      std::cout << QStringLiteral( "\033[1;92m%1 [%2] %3 %4ms \"%5\" %6\033[0m" )
+                .arg( clientConnection->peerAddress().toString(),
+                      QDateTime::currentDateTime().toString(),
+                      QString::number( body.size() ),
+                      QString::number( std::chrono::duration_cast<std::chrono::milliseconds>( elapsedTime ).count() ),
+                      requestLine,
+                      QString::number( statusCode ) )
+                .toStdString()
+                << std::endl;
+
+      clientConnection->disconnectFromHost();
+    };
+
+    // Output stream: send error
+    auto sendError = [ & ]( QTcpSocket * clientConnection, int statusCode, const QString & message )
+    {
+      clientConnection->write( QStringLiteral( "HTTP/1.0 %1 %2\r\n" ).arg( statusCode ).arg( knownStatuses.value( statusCode ) ).toUtf8() );
+      clientConnection->write( QStringLiteral( "Server: QGIS\r\n" ).toUtf8() );
+      if ( statusCode == 503 )
+      {
+        clientConnection->write( QStringLiteral( "Retry-After: 1\r\n" ).toUtf8() );
+      }
+      clientConnection->write( "\r\n" );
+      clientConnection->write( message.toUtf8() );
+
+      std::cout << QStringLiteral( "\033[1;31m%1 [%2] \"%3\" - - %4\033[0m" )
+                .arg( clientConnection->peerAddress().toString() )
+                .arg( QDateTime::currentDateTime().toString() )
+                .arg( message )
+                .arg( statusCode ).toStdString() << std::endl;
+
+      clientConnection->disconnectFromHost();
+    };
+
     // Poor man's synchronous HTTP handler
     // The reason why this cannot be implemented using signals is that
     // WMS provider (and probably others) run its own event loop and this
@@ -257,6 +333,8 @@ int main( int argc, char *argv[] )
       //qDebug() << clientConnection << "Active connection" << connCounter;
 
       QString incomingData;
+      // TRUE when the request was handed over to a worker thread
+      bool deferred = false;
 
       // Incoming connection parser
       while ( IS_RUNNING && clientConnection->state() == QAbstractSocket::SocketState::ConnectedState )
@@ -383,7 +461,36 @@ int main( int argc, char *argv[] )
           // Inefficient copy :(
           QByteArray data { incomingData.mid( headersSize ).toUtf8() };
 
-          auto start = std::chrono::steady_clock::now();
+          const auto start = std::chrono::steady_clock::now();
+          const QString requestLine { firstLinePieces.join( ' ' ) };
+
+          if ( workerPool )
+          {
+            // Hand the request over to a worker thread, the response is sent by the main loop
+            const QPointer<QTcpSocket> connection { clientConnection };
+            const bool accepted = workerPool->submit( [ =, &finishedRequestsMutex, &finishedRequests ]( QgsServer & workerServer ) mutable
+            {
+              QgsBufferServerRequest request { url, method, headers, &data };
+              QgsBufferServerResponse response;
+              workerServer.handleRequest( request, response );
+
+              QMutexLocker locker( &finishedRequestsMutex );
+              finishedRequests.append( { connection, requestLine, response.statusCode(), response.headers(), response.body(), start } );
+            } );
+
+            if ( accepted )
+            {
+              deferred = true;
+            }
+            else
+            {
+              // Backpressure: all the workers are busy and the queue is full
+              const QgsServerWorkerPool::Metrics metrics { workerPool->metrics() };
+              sendError( clientConnection, 503, QStringLiteral( "Server busy: %1 requests queued, %2 rejected so far" )
+                         .arg( metrics.queuedJobs ).arg( metrics.rejectedJobs ) );
+            }
+            break;
+          }
 
           QgsBufferServerRequest request { url, method, headers, &data };
           QgsBufferServerResponse response;
@@ -404,30 +511,7 @@ int main( int argc, char *argv[] )
             throw HttpException( QStringLiteral( "HTTP error unsupported status code: %1" ).arg( response.statusCode() ) );
           }
 
-          // Output stream
-          clientConnection->write( QStringLiteral( "HTTP/1.0 %1 %2\r\n" ).arg( response.statusCode() ).arg( knownStatuses.value( response.statusCode() ) ).toUtf8() );
-          clientConnection->write( QStringLiteral( "Server: QGIS\r\n" ).toUtf8() );
-          const auto responseHeaders { response.headers() };
-          for ( auto it = responseHeaders.constBegin(); it != responseHeaders.constEnd(); ++it )
-          {
-            clientConnection->write( QStringLiteral( "%1: %2\r\n" ).arg( it.key(), it.value() ).toUtf8() );
-          }
-          clientConnection->write( "\r\n" );
-          const QByteArray body { response.body() };
-          clientConnection->write( body );
-
-          // 10.185.248.71 [09/Jan/2015:19:12:06 +0000] 808840 <time> "GET / HTTP/1.1" 500"
-          std::cout << QStringLiteral( "\033[1;92m%1 [%2] %3 %4ms \"%5\" %6\033[0m" )
-                    .arg( clientConnection->peerAddress().toString(),
-                          QDateTime::currentDateTime().toString(),
-                          QString::number( body.size() ),
-                          QString::number( std::chrono::duration_cast<std::chrono::milliseconds>( elapsedTime ).count() ),
-                          firstLinePieces.join( ' ' ),
-                          QString::number( response.statusCode() ) )
-                    .toStdString()
-                    << std::endl;
-
-          clientConnection->disconnectFromHost();
+          sendResponse( clientConnection, requestLine, response.statusCode(), response.headers(), response.body(), elapsedTime );
         }
         catch ( HttpException &ex )
         {
@@ -437,23 +521,14 @@ int main( int argc, char *argv[] )
             break;
           }
 
-          // Output stream: send error
-          clientConnection->write( QStringLiteral( "HTTP/1.0 %1 %2\r\n" ).arg( 500 ).arg( knownStatuses.value( 500 ) ).toUtf8() );
-          clientConnection->write( QStringLiteral( "Server: QGIS\r\n" ).toUtf8() );
-          clientConnection->write( "\r\n" );
-          clientConnection->write( ex.message().toUtf8() );
-
-          std::cout << QStringLiteral( "\033[1;31m%1 [%2] \"%3\" - - 500\033[0m" )
-                    .arg( clientConnection->peerAddress().toString() )
-                    .arg( QDateTime::currentDateTime().toString() )
-                    .arg( ex.message() ).toStdString() << std::endl;
-
-          clientConnection->disconnectFromHost();
-
+          sendError( clientConnection, 500, ex.message() );
         }
       };
 
-      clientConnection->deleteLater();
+      if ( ! deferred )
+      {
+        clientConnection->deleteLater();
+      }
       connCounter--;
 
     };
@@ -463,6 +538,39 @@ int main( int argc, char *argv[] )
     {
       while ( IS_RUNNING )
       {
+        // Send the responses of the requests handled by the worker threads
+        if ( workerPool )
+        {
+          QList<FinishedRequest> finished;
+          {
+            QMutexLocker locker( &finishedRequestsMutex );
+            finished.swap( finishedRequests );
+          }
+
+          for ( const FinishedRequest &request : qgis::as_const( finished ) )
+          {
+            // The client might be gone in the meantime
+            if ( ! request.connection )
+            {
+              continue;
+            }
+
+            if ( request.connection->state() == QAbstractSocket::SocketState::ConnectedState )
+            {
+              if ( knownStatuses.contains( request.statusCode ) )
+              {
+                sendResponse( request.connection, request.requestLine, request.statusCode, request.headers, request.body,
+                              std::chrono::steady_clock::now() - request.start );
+              }
+              else
+              {
+                sendError( request.connection, 500, QStringLiteral( "HTTP error unsupported status code: %1" ).arg( request.statusCode ) );
+              }
+            }
+            request.connection->deleteLater();
+          }
+        }
+
         if ( tcpServer.hasPendingConnections() )
         {
           QTcpSocket *clientConnection = tcpServer.nextPendingConnection();
@@ -501,6 +609,16 @@ int main( int argc, char *argv[] )
 #endif
 
   app.exec();
+
+  if ( workerPool )
+  {
+    const QgsServerWorkerPool::Metrics metrics { workerPool->metrics() };
+    std::cout << QObject::tr( "Worker threads: %1 requests handled, %2 rejected, %3 queued at most, %4ms average wait" )
+              .arg( metrics.completedJobs ).arg( metrics.rejectedJobs ).arg( metrics.peakQueuedJobs )
+              .arg( metrics.averageQueueTime, 0, 'f', 1 ).toStdString() << std::endl;
+    workerPool.reset();
+  }
+
   app.exitQgis();
   return 0;
 }
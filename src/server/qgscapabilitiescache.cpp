@@ -19,6 +19,7 @@
 
 #include <QCoreApplication>
 #include <QFileInfo>
+#include <QThread>
 
 #if defined(Q_OS_LINUX)
 #include <sys/vfs.h>
@@ -38,7 +39,17 @@ QgsCapabilitiesCache::QgsCapabilitiesCache()
 
 const QDomDocument *QgsCapabilitiesCache::searchCapabilitiesDocument( const QString &configFilePath, const QString &key )
 {
-  QCoreApplication::processEvents(); //get updates from file system watcher
+  if ( qApp && QThread::currentThread() != qApp->thread() )
+  {
+    // worker threads of a QgsServerWorkerPool don't process events, check the modification time of the file instead
+    auto it = mCachedCapabilitiesTimestamps.constFind( configFilePath );
+    if ( it != mCachedCapabilitiesTimestamps.constEnd() && QFileInfo( configFilePath ).lastModified() != *it )
+      removeCapabilitiesDocument( configFilePath );
+  }
+  else
+  {
+    QCoreApplication::processEvents(); //get updates from file system watcher
+  }
 
   if ( mCachedCapabilities.contains( configFilePath ) && mCachedCapabilities[ configFilePath ].contains( key ) )
   {
@@ -68,6 +79,12 @@ void QgsCapabilitiesCache::insertCapabilitiesDocument( const QString &configFile
 
   mCachedCapabilities[ configFilePath ].insert( key, doc->cloneNode().toDocument() );
 
+  if ( qApp && QThread::currentThread() != qApp->thread() )
+  {
+    mCachedCapabilitiesTimestamps[ configFilePath ] = QFileInfo( configFilePath ).lastModified();
+    return;
+  }
+
 #if defined(Q_OS_LINUX)
   struct statfs sStatFS;
   if ( statfs( configFilePath.toUtf8().constData(), &sStatFS ) == 0 &&
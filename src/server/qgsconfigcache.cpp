@@ -20,8 +20,12 @@
 #include "qgsserverexception.h"
 #include "qgsstorebadlayerinfo.h"
 #include "qgsserverprojectutils.h"
+#include "qgsserverrenderedlayercache.h"
 
 #include <QFile>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QThread>
 
 QgsConfigCache *QgsConfigCache::instance()
 {
@@ -43,81 +47,164 @@ const QgsProject *QgsConfigCache::project( const QString &path, const QgsServerS
 {
   if ( ! mProjectCache[ path ] )
   {
+    std::unique_ptr<QgsProject> prj = readProject( path, settings, true );
+    if ( prj )
+    {
+      // the project may have been evicted and changed in the meantime
+      QgsServerRenderedLayerCache::instance()->invalidate( path );
+      mProjectCache.insert( path, prj.release() );
+      mFileSystemWatcher.addPath( path );
+    }
+  }
+  return mProjectCache[ path ];
+}
+
+QgsProject *QgsConfigCache::acquireProject( const QString &path, const QgsServerSettings *settings )
+{
+  const QDateTime lastModified = QFileInfo( path ).lastModified();
+  {
+    QMutexLocker locker( &mCopiesMutex );
+    auto it = mProjectCopies.find( path );
+    if ( it != mProjectCopies.end() && it->lastModified != lastModified )
+    {
+      // the project file changed, the copies in use are dropped when released
+      qDeleteAll( it->idle );
+      mProjectCopies.erase( it );
+      it = mProjectCopies.end();
+      QgsServerRenderedLayerCache::instance()->invalidate( path );
+    }
+
+    if ( it != mProjectCopies.end() && !it->idle.isEmpty() )
+    {
+      QgsProject *project = it->idle.takeLast();
+      project->moveToThread( QThread::currentThread() );
+      mAcquiredCopies.insert( project, qMakePair( path, lastModified ) );
+      return project;
+    }
+  }
+
+  // all the copies are in use: read a new one, without blocking the other workers
+  std::unique_ptr<QgsProject> project = readProject( path, settings, false );
+  if ( !project )
+    return nullptr;
+
+  QMutexLocker locker( &mCopiesMutex );
+  mAcquiredCopies.insert( project.get(), qMakePair( path, lastModified ) );
+  return project.release();
+}
+
+void QgsConfigCache::releaseProject( QgsProject *project )
+{
+  QMutexLocker locker( &mCopiesMutex );
+  auto acquired = mAcquiredCopies.find( project );
+  if ( acquired == mAcquiredCopies.end() )
+    return;
+
+  const QString path = acquired->first;
+  const QDateTime lastModified = acquired->second;
+  mAcquiredCopies.erase( acquired );
+
+  auto it = mProjectCopies.find( path );
+  if ( it == mProjectCopies.end() && QFileInfo( path ).lastModified() == lastModified )
+  {
+    ProjectCopies copies;
+    copies.lastModified = lastModified;
+    it = mProjectCopies.insert( path, copies );
+  }
+
+  if ( it == mProjectCopies.end() || it->lastModified != lastModified )
+  {
+    // outdated copy
+    delete project;
+    return;
+  }
+
+  // the copy will be pulled by the thread acquiring it next
+  project->moveToThread( nullptr );
+  it->idle << project;
+}
 
-    std::unique_ptr<QgsProject> prj( new QgsProject() );
+std::unique_ptr<QgsProject> QgsConfigCache::readProject( const QString &path, const QgsServerSettings *settings, bool setCurrentProject )
+{
+  std::unique_ptr<QgsProject> prj( new QgsProject() );
 
-    // This is required by virtual layers that call QgsProject::instance() inside the constructor :(
+  // This is required by virtual layers that call QgsProject::instance() inside the constructor :(
+  // Worker threads only set it for themselves, as the other workers are reading or rendering their own projects
+  if ( setCurrentProject )
     QgsProject::setInstance( prj.get() );
+  else
+    QgsProject::setThreadInstance( prj.get() );
 
-    QgsStoreBadLayerInfo *badLayerHandler = new QgsStoreBadLayerInfo();
-    prj->setBadLayerHandler( badLayerHandler );
+  QgsStoreBadLayerInfo *badLayerHandler = new QgsStoreBadLayerInfo();
+  prj->setBadLayerHandler( badLayerHandler );
 
-    // Always skip original styles storage
-    QgsProject::ReadFlags readFlags = QgsProject::ReadFlag() | QgsProject::ReadFlag::FlagDontStoreOriginalStyles ;
-    if ( settings )
+  // Always skip original styles storage
+  QgsProject::ReadFlags readFlags = QgsProject::ReadFlag() | QgsProject::ReadFlag::FlagDontStoreOriginalStyles ;
+  if ( settings )
+  {
+    // Activate trust layer metadata flag
+    if ( settings->trustLayerMetadata() )
     {
-      // Activate trust layer metadata flag
-      if ( settings->trustLayerMetadata() )
-      {
-        readFlags |= QgsProject::ReadFlag::FlagTrustLayerMetadata;
-      }
-      // Activate don't load layouts flag
-      if ( settings->getPrintDisabled() )
-      {
-        readFlags |= QgsProject::ReadFlag::FlagDontLoadLayouts;
-      }
+      readFlags |= QgsProject::ReadFlag::FlagTrustLayerMetadata;
     }
+    // Activate don't load layouts flag
+    if ( settings->getPrintDisabled() )
+    {
+      readFlags |= QgsProject::ReadFlag::FlagDontLoadLayouts;
+    }
+  }
 
-    if ( prj->read( path, readFlags ) )
+  if ( !prj->read( path, readFlags ) )
+  {
+    QgsMessageLog::logMessage(
+      QStringLiteral( "Error when loading project file '%1': %2 " ).arg( path, prj->error() ),
+      QStringLiteral( "Server" ), Qgis::Critical );
+    return nullptr;
+  }
+
+  if ( !badLayerHandler->badLayers().isEmpty() )
+  {
+    // if bad layers are not restricted layers so service failed
+    QStringList unrestrictedBadLayers;
+    // test bad layers through restrictedlayers
+    const QStringList badLayerIds = badLayerHandler->badLayers();
+    const QMap<QString, QString> badLayerNames = badLayerHandler->badLayerNames();
+    const QStringList resctrictedLayers = QgsServerProjectUtils::wmsRestrictedLayers( *prj );
+    for ( const QString &badLayerId : badLayerIds )
     {
-      if ( !badLayerHandler->badLayers().isEmpty() )
+      // if this bad layer is in restricted layers
+      // it doesn't need to be added to unrestricted bad layers
+      if ( badLayerNames.contains( badLayerId ) &&
+           resctrictedLayers.contains( badLayerNames.value( badLayerId ) ) )
       {
-        // if bad layers are not restricted layers so service failed
-        QStringList unrestrictedBadLayers;
-        // test bad layers through restrictedlayers
-        const QStringList badLayerIds = badLayerHandler->badLayers();
-        const QMap<QString, QString> badLayerNames = badLayerHandler->badLayerNames();
-        const QStringList resctrictedLayers = QgsServerProjectUtils::wmsRestrictedLayers( *prj );
-        for ( const QString &badLayerId : badLayerIds )
-        {
-          // if this bad layer is in restricted layers
-          // it doesn't need to be added to unrestricted bad layers
-          if ( badLayerNames.contains( badLayerId ) &&
-               resctrictedLayers.contains( badLayerNames.value( badLayerId ) ) )
-          {
-            continue;
-          }
-          unrestrictedBadLayers.append( badLayerId );
-        }
-        if ( !unrestrictedBadLayers.isEmpty() )
-        {
-          // This is a critical error unless QGIS_SERVER_IGNORE_BAD_LAYERS is set to TRUE
-          if ( ! settings || ! settings->ignoreBadLayers() )
-          {
-            QgsMessageLog::logMessage(
-              QStringLiteral( "Error, Layer(s) %1 not valid in project %2" ).arg( unrestrictedBadLayers.join( QLatin1String( ", " ) ), path ),
-              QStringLiteral( "Server" ), Qgis::Critical );
-            throw QgsServerException( QStringLiteral( "Layer(s) not valid" ) );
-          }
-          else
-          {
-            QgsMessageLog::logMessage(
-              QStringLiteral( "Warning, Layer(s) %1 not valid in project %2" ).arg( unrestrictedBadLayers.join( QLatin1String( ", " ) ), path ),
-              QStringLiteral( "Server" ), Qgis::Warning );
-          }
-        }
+        continue;
       }
-      mProjectCache.insert( path, prj.release() );
-      mFileSystemWatcher.addPath( path );
+      unrestrictedBadLayers.append( badLayerId );
     }
-    else
+    if ( !unrestrictedBadLayers.isEmpty() )
     {
-      QgsMessageLog::logMessage(
-        QStringLiteral( "Error when loading project file '%1': %2 " ).arg( path, prj->error() ),
-        QStringLiteral( "Server" ), Qgis::Critical );
+      // This is a critical error unless QGIS_SERVER_IGNORE_BAD_LAYERS is set to TRUE
+      if ( ! settings || ! settings->ignoreBadLayers() )
+      {
+        QgsMessageLog::logMessage(
+          QStringLiteral( "Error, Layer(s) %1 not valid in project %2" ).arg( unrestrictedBadLayers.join( QLatin1String( ", " ) ), path ),
+          QStringLiteral( "Server" ), Qgis::Critical );
+        throw QgsServerException( QStringLiteral( "Layer(s) not valid" ) );
+      }
+      else
+      {
+        QgsMessageLog::logMessage(
+          QStringLiteral( "Warning, Layer(s) %1 not valid in project %2" ).arg( unrestrictedBadLayers.join( QLatin1String( ", " ) ), path ),
+          QStringLiteral( "Server" ), Qgis::Warning );
+      }
     }
   }
-  return mProjectCache[ path ];
+
+  // the project is set again for the thread handling the request it is used for
+  if ( !setCurrentProject )
+    QgsProject::setThreadInstance( nullptr );
+
+  return prj;
 }
 
 QDomDocument *QgsConfigCache::xmlDocument( const QString &filePath )
@@ -163,6 +250,19 @@ void QgsConfigCache::removeChangedEntry( const QString &path )
 {
   mProjectCache.remove( path );
 
+  {
+    QMutexLocker locker( &mCopiesMutex );
+    auto it = mProjectCopies.find( path );
+    if ( it != mProjectCopies.end() )
+    {
+      qDeleteAll( it->idle );
+      mProjectCopies.erase( it );
+    }
+  }
+
+  // layer images rendered with the previous version of the project are outdated
+  QgsServerRenderedLayerCache::instance()->invalidate( path );
+
   //xml document must be removed last, as other config cache destructors may require it
   mXmlDocumentCache.remove( path );
 
@@ -21,9 +21,13 @@
 #include "qgsconfig.h"
 
 #include <QCache>
+#include <QDateTime>
 #include <QFileSystemWatcher>
+#include <QHash>
+#include <QMutex>
 #include <QObject>
 #include <QDomDocument>
+#include <memory>
 
 #include "qgis_server.h"
 #include "qgis_sip.h"
@@ -65,9 +69,40 @@ class SERVER_EXPORT QgsConfigCache : public QObject
      */
     const QgsProject *project( const QString &path, const QgsServerSettings *settings = nullptr );
 
+    /**
+     * Returns a copy of the project at \a path for the exclusive use of the calling thread,
+     * until it is given back with releaseProject(). Returns NULLPTR if the project can't be read.
+     *
+     * This is used instead of project() by the worker threads of a QgsServerWorkerPool, as
+     * requests modify the layers of the project they handle. The copies are shared by all
+     * the workers and a new copy is only read when all the copies of the project are in use,
+     * so that a project is copied as many times as it is used by concurrent requests.
+     *
+     * Worker threads don't process events, so copies are checked against the modification
+     * time of the project file instead of being removed by the file system watcher.
+     *
+     * \note Projects read by worker threads are never set as the current QgsProject::instance().
+     * \note not available in Python bindings
+     * \since QGIS 3.18
+     */
+    QgsProject *acquireProject( const QString &path, const QgsServerSettings *settings = nullptr ) SIP_SKIP;
+
+    /**
+     * Gives back a \a project acquired with acquireProject(), so that other requests can use it.
+     * \note not available in Python bindings
+     * \since QGIS 3.18
+     */
+    void releaseProject( QgsProject *project ) SIP_SKIP;
+
   private:
     QgsConfigCache() SIP_FORCE;
 
+    /**
+     * Reads the project at \a path, returns NULLPTR in case of errors. Throws QgsServerException if
+     * the project has invalid layers which are not allowed by the \a settings.
+     */
+    std::unique_ptr<QgsProject> readProject( const QString &path, const QgsServerSettings *settings, bool setCurrentProject );
+
     //! Check for configuration file updates (remove entry from cache if file changes)
     QFileSystemWatcher mFileSystemWatcher;
 
@@ -77,6 +112,21 @@ class SERVER_EXPORT QgsConfigCache : public QObject
     QCache<QString, QDomDocument> mXmlDocumentCache;
     QCache<QString, QgsProject> mProjectCache;
 
+    //! Copies of a project shared by the worker threads
+    struct ProjectCopies
+    {
+      //! Modification time of the project file when the copies were read
+      QDateTime lastModified;
+      //! Copies which are not in use, with no thread affinity
+      QList<QgsProject *> idle;
+    };
+
+    //! Protects the project copies, which are used by the worker threads
+    QMutex mCopiesMutex;
+    QHash<QString, ProjectCopies> mProjectCopies;
+    //! Path and modification time of the copies in use
+    QHash<QgsProject *, QPair<QString, QDateTime> > mAcquiredCopies;
+
   private slots:
     //! Removes changed entry from this cache
     void removeChangedEntry( const QString &path );
@@ -31,6 +31,7 @@
 #include "qgsmapserviceexception.h"
 #include "qgsnetworkaccessmanager.h"
 #include "qgsserverlogger.h"
+#include "qgsserverrenderedlayercache.h"
 #include "qgsserverrequest.h"
 #include "qgsfilterresponsedecorator.h"
 #include "qgsservice.h"
@@ -44,10 +45,12 @@
 #include <QNetworkDiskCache>
 #include <QSettings>
 #include <QElapsedTimer>
+#include <QThread>
 
 // TODO: remove, it's only needed by a single debug message
 #include <fcgi_stdio.h>
 #include <cstdlib>
+#include <functional>
 
 
 // Server status static initializers.
@@ -223,6 +226,8 @@ bool QgsServer::init()
   sSettings()->logSummary();
 
   setupNetworkAccessManager();
+  QgsServerRenderedLayerCache::instance()->setMaximumSize( sSettings()->renderedLayerCacheSize() );
+  QgsServerRenderedLayerCache::instance()->setTimeToLive( sSettings()->renderedLayerCacheTimeToLive() );
   QDomImplementation::setInvalidDataPolicy( QDomImplementation::DropInvalidChars );
 
   // Instantiate the plugin directory so that providers are loaded
@@ -301,7 +306,16 @@ void QgsServer::handleRequest( QgsServerRequest &request, QgsServerResponse &res
 
     QgsScopedRuntimeProfile profiler { QStringLiteral( "handleRequest" ), QStringLiteral( "server" ) };
 
-    qApp->processEvents();
+    // Worker threads of a QgsServerWorkerPool don't process events, and use their own copy
+    // of the project instead of setting it as the current project of the whole process
+    const bool workerThread = qApp && QThread::currentThread() != qApp->thread();
+    if ( !workerThread )
+      qApp->processEvents();
+
+    std::unique_ptr< QgsProject, std::function< void( QgsProject * ) > > acquiredProject( nullptr, [this]( QgsProject * acquired )
+    {
+      mConfigCache->releaseProject( acquired );
+    } );
 
     response.clear();
 
@@ -369,12 +383,23 @@ void QgsServer::handleRequest( QgsServerRequest &request, QgsServerResponse &res
           // load the project if needed and not empty
           if ( ! configFilePath.isEmpty() )
           {
-            project = mConfigCache->project( configFilePath, sServerInterface->serverSettings() );
+            if ( workerThread )
+            {
+              acquiredProject.reset( mConfigCache->acquireProject( configFilePath, sServerInterface->serverSettings() ) );
+              project = acquiredProject.get();
+            }
+            else
+            {
+              project = mConfigCache->project( configFilePath, sServerInterface->serverSettings() );
+            }
           }
         }
 
-        // Set the current project instance
-        QgsProject::setInstance( const_cast<QgsProject *>( project ) );
+        // Set the current project instance, only for the current thread in worker threads
+        if ( workerThread )
+          QgsProject::setThreadInstance( const_cast<QgsProject *>( project ) );
+        else
+          QgsProject::setInstance( const_cast<QgsProject *>( project ) );
 
         if ( project )
         {
@@ -455,6 +480,10 @@ void QgsServer::handleRequest( QgsServerRequest &request, QgsServerResponse &res
     // We are done using requestHandler in plugins, make sure we don't access
     // to a deleted request handler from Python bindings
     sServerInterface->clearRequestHandler();
+
+    // the project copy is released and may be used by another worker next
+    if ( workerThread )
+      QgsProject::setThreadInstance( nullptr );
   }
 
   if ( logLevel == Qgis::Info )
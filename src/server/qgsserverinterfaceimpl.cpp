@@ -20,13 +20,15 @@
 #include "qgsserverinterfaceimpl.h"
 #include "qgsconfigcache.h"
 
+#include <QCoreApplication>
+#include <QThread>
+
 //! Constructor
 QgsServerInterfaceImpl::QgsServerInterfaceImpl( QgsCapabilitiesCache *capCache, QgsServiceRegistry *srvRegistry, QgsServerSettings *settings )
   : mCapabilitiesCache( capCache )
   , mServiceRegistry( srvRegistry )
   , mServerSettings( settings )
 {
-  mRequestHandler = nullptr;
 #ifdef HAVE_SERVER_PYTHON_PLUGINS
   mAccessControls = new QgsAccessControl();
   mCacheManager = new QgsServerCacheManager();
@@ -50,17 +52,28 @@ QgsServerInterfaceImpl::~QgsServerInterfaceImpl()
 
 void QgsServerInterfaceImpl::clearRequestHandler()
 {
-  mRequestHandler = nullptr;
+  mRequestState.localData().requestHandler = nullptr;
 }
 
 void QgsServerInterfaceImpl::setRequestHandler( QgsRequestHandler *requestHandler )
 {
-  mRequestHandler = requestHandler;
+  mRequestState.localData().requestHandler = requestHandler;
+}
+
+QgsCapabilitiesCache *QgsServerInterfaceImpl::capabilitiesCache()
+{
+  if ( !qApp || QThread::currentThread() == qApp->thread() )
+    return mCapabilitiesCache;
+
+  RequestState &state = mRequestState.localData();
+  if ( !state.capabilitiesCache )
+    state.capabilitiesCache = std::make_shared<QgsCapabilitiesCache>();
+  return state.capabilitiesCache.get();
 }
 
 void QgsServerInterfaceImpl::setConfigFilePath( const QString &configFilePath )
 {
-  mConfigFilePath = configFilePath;
+  mRequestState.localData().configFilePath = configFilePath;
 }
 
 void QgsServerInterfaceImpl::registerFilter( QgsServerFilter *filter, int priority )
@@ -102,9 +115,9 @@ QgsServerCacheManager *QgsServerInterfaceImpl::cacheManager() const
 
 void QgsServerInterfaceImpl::removeConfigCacheEntry( const QString &path )
 {
-  if ( mCapabilitiesCache )
+  if ( QgsCapabilitiesCache *cache = capabilitiesCache() )
   {
-    mCapabilitiesCache->removeCapabilitiesDocument( path );
+    cache->removeCapabilitiesDocument( path );
   }
   QgsConfigCache::instance()->removeEntry( path );
 }
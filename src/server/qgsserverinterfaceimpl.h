@@ -26,6 +26,9 @@
 #include "qgscapabilitiescache.h"
 #include "qgsservercachemanager.h"
 
+#include <QThreadStorage>
+#include <memory>
+
 /**
  * \ingroup server
  * \class QgsServerInterfaceImpl
@@ -46,9 +49,17 @@ class SERVER_EXPORT QgsServerInterfaceImpl : public QgsServerInterface
 
     void setRequestHandler( QgsRequestHandler *requestHandler ) override;
     void clearRequestHandler() override;
-    QgsCapabilitiesCache *capabilitiesCache() override { return mCapabilitiesCache; }
-    //! Returns the QgsRequestHandler, to be used only in server plugins
-    QgsRequestHandler  *requestHandler() override { return mRequestHandler; }
+
+    /**
+     * Returns the capabilities cache.
+     *
+     * Worker threads of a QgsServerWorkerPool get their own cache, as the cache
+     * is not thread safe.
+     */
+    QgsCapabilitiesCache *capabilitiesCache() override;
+
+    //! Returns the QgsRequestHandler of the request handled by the current thread, to be used only in server plugins
+    QgsRequestHandler  *requestHandler() override { return mRequestState.localData().requestHandler; }
     void registerFilter( QgsServerFilter *filter, int priority = 0 ) override;
     QgsServerFiltersMap filters() override { return mFilters; }
 
@@ -78,7 +89,7 @@ class SERVER_EXPORT QgsServerInterfaceImpl : public QgsServerInterface
     QgsServerCacheManager *cacheManager() const override;
 
     QString getEnv( const QString &name ) const override;
-    QString configFilePath() override { return mConfigFilePath; }
+    QString configFilePath() override { return mRequestState.localData().configFilePath; }
     void setConfigFilePath( const QString &configFilePath ) override;
     void setFilters( QgsServerFiltersMap *filters ) override;
     void removeConfigCacheEntry( const QString &path ) override;
@@ -89,12 +100,20 @@ class SERVER_EXPORT QgsServerInterfaceImpl : public QgsServerInterface
 
   private:
 
-    QString mConfigFilePath;
+    //! State of the request handled by a thread
+    struct RequestState
+    {
+      QString configFilePath;
+      QgsRequestHandler *requestHandler = nullptr;
+      //! Capabilities cache of a worker thread
+      std::shared_ptr<QgsCapabilitiesCache> capabilitiesCache;
+    };
+
+    QThreadStorage<RequestState> mRequestState;
     QgsServerFiltersMap mFilters;
     QgsAccessControl *mAccessControls = nullptr;
     QgsServerCacheManager *mCacheManager = nullptr;
     QgsCapabilitiesCache *mCapabilitiesCache = nullptr;
-    QgsRequestHandler *mRequestHandler = nullptr;
     QgsServiceRegistry *mServiceRegistry = nullptr;
     QgsServerSettings *mServerSettings = nullptr;
 };
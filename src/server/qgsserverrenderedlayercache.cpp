@@ -0,0 +1,413 @@
+/***************************************************************************
+                              qgsserverrenderedlayercache.cpp
+                              -------------------------------
+  begin                : October 2026
+  copyright            : (C) 2026 by QGIS contributors
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qgsserverrenderedlayercache.h"
+#include "qgsmapsettings.h"
+#include "qgsmaplayer.h"
+#include "qgsmaplayerstylemanager.h"
+#include "qgsvectorlayer.h"
+#include "qgsrasterlayer.h"
+#include "qgsrasterrenderer.h"
+#include "qgsfeaturerequest.h"
+#include "qgsfeaturefilterprovider.h"
+#include "qgsproviderregistry.h"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QMutexLocker>
+
+#include <algorithm>
+#include <cmath>
+
+QgsServerRenderedLayerCache *QgsServerRenderedLayerCache::instance()
+{
+  static QgsServerRenderedLayerCache sInstance;
+  return &sInstance;
+}
+
+QgsServerRenderedLayerCache::QgsServerRenderedLayerCache( qint64 maximumSize )
+  : mMaximumSize( std::max< qint64 >( 0, maximumSize ) )
+{
+}
+
+QgsServerRenderedLayerCache::~QgsServerRenderedLayerCache()
+{
+  QMutexLocker locker( &mLayerMutex );
+  for ( const LayerState &state : qgis::as_const( mLayers ) )
+  {
+    for ( const QMetaObject::Connection &connection : state.connections )
+      QObject::disconnect( connection );
+  }
+}
+
+void QgsServerRenderedLayerCache::setMaximumSize( qint64 maximum )
+{
+  QMutexLocker locker( &mMutex );
+  mMaximumSize = std::max< qint64 >( 0, maximum );
+  trim( mMaximumSize );
+}
+
+qint64 QgsServerRenderedLayerCache::maximumSize() const
+{
+  QMutexLocker locker( &mMutex );
+  return mMaximumSize;
+}
+
+void QgsServerRenderedLayerCache::setTimeToLive( int seconds )
+{
+  QMutexLocker locker( &mMutex );
+  mTimeToLive = std::max( 0, seconds );
+}
+
+int QgsServerRenderedLayerCache::timeToLive() const
+{
+  QMutexLocker locker( &mMutex );
+  return mTimeToLive;
+}
+
+bool QgsServerRenderedLayerCache::isEnabled() const
+{
+  QMutexLocker locker( &mMutex );
+  return mMaximumSize > 0;
+}
+
+qint64 QgsServerRenderedLayerCache::size() const
+{
+  QMutexLocker locker( &mMutex );
+  return mSize;
+}
+
+int QgsServerRenderedLayerCache::count() const
+{
+  QMutexLocker locker( &mMutex );
+  return mEntries.count();
+}
+
+QImage QgsServerRenderedLayerCache::image( const QString &projectPath, const QString &key )
+{
+  QMutexLocker locker( &mMutex );
+  auto it = mEntries.find( entryKey( projectPath, key ) );
+  if ( it == mEntries.end() )
+    return QImage();
+
+  mLru.splice( mLru.begin(), mLru, it->lruPosition );
+  return it->image;
+}
+
+bool QgsServerRenderedLayerCache::insert( const QString &projectPath, const QString &key, const QImage &image )
+{
+  if ( image.isNull() )
+    return false;
+
+#if QT_VERSION < QT_VERSION_CHECK(5, 10, 0)
+  const qint64 imageSize = image.byteCount();
+#else
+  const qint64 imageSize = image.sizeInBytes();
+#endif
+
+  QMutexLocker locker( &mMutex );
+  if ( imageSize > mMaximumSize )
+    return false;
+
+  const QString k = entryKey( projectPath, key );
+  auto it = mEntries.find( k );
+  if ( it != mEntries.end() )
+    removeEntry( it );
+
+  trim( mMaximumSize - imageSize );
+
+  mLru.push_front( k );
+  Entry entry;
+  entry.projectPath = projectPath;
+  entry.image = image;
+  entry.size = imageSize;
+  entry.lruPosition = mLru.begin();
+  mEntries.insert( k, entry );
+  mSize += imageSize;
+  return true;
+}
+
+void QgsServerRenderedLayerCache::invalidate( const QString &projectPath )
+{
+  QMutexLocker locker( &mMutex );
+  for ( auto it = mEntries.begin(); it != mEntries.end(); )
+  {
+    if ( it->projectPath == projectPath )
+    {
+      mSize -= it->size;
+      mLru.erase( it->lruPosition );
+      it = mEntries.erase( it );
+    }
+    else
+    {
+      ++it;
+    }
+  }
+}
+
+void QgsServerRenderedLayerCache::clear()
+{
+  {
+    QMutexLocker locker( &mMutex );
+    mEntries.clear();
+    mLru.clear();
+    mSize = 0;
+  }
+
+  QMutexLocker locker( &mFileStampMutex );
+  mFileStamps.clear();
+}
+
+QString QgsServerRenderedLayerCache::layerKey( QgsMapLayer *layer, const QgsMapSettings &settings, const QgsFeatureFilterProvider *filterProvider )
+{
+  if ( !layer )
+    return QString();
+
+  // labels and diagrams are not part of the layer images
+  const QgsVectorLayer *vl = qobject_cast< const QgsVectorLayer * >( layer );
+  if ( vl && settings.testFlag( QgsMapSettings::DrawLabeling ) && ( vl->labelsEnabled() || vl->diagramsEnabled() ) )
+    return QString();
+
+  // SLD styles are set for a single request, always under the same name
+  if ( !layer->customProperty( QStringLiteral( "sldStyleName" ) ).toString().isEmpty() )
+    return QString();
+
+  const QString stamp = dataStamp( layer );
+  if ( stamp.isEmpty() )
+    return QString();
+
+  QByteArray data;
+  QDataStream stream( &data, QIODevice::WriteOnly );
+
+  // layer style, including any override set on the map
+  stream << stamp << layerRevision( layer ) << layer->styleManager()->currentStyle();
+  const QMap<QString, QString> styleOverrides = settings.layerStyleOverrides();
+  if ( styleOverrides.contains( layer->id() ) )
+    stream << styleOverrides.value( layer->id() );
+
+  // the opacity of raster layers is applied by their renderer, not when composing the map
+  if ( const QgsRasterLayer *rl = qobject_cast< const QgsRasterLayer * >( layer ) )
+  {
+    if ( rl->renderer() )
+      stream << rl->renderer()->opacity();
+  }
+
+  // map extent snapped to a hundredth of a pixel, so that the same extent
+  // computed by different clients ends up with the same key
+  const QgsRectangle extent = settings.visibleExtent();
+  const double step = settings.mapUnitsPerPixel() / 100.0;
+  if ( step > 0 )
+  {
+    stream << qRound64( extent.xMinimum() / step ) << qRound64( extent.yMinimum() / step )
+           << qRound64( extent.xMaximum() / step ) << qRound64( extent.yMaximum() / step );
+  }
+
+  // output parameters
+  const QgsCoordinateReferenceSystem crs = settings.destinationCrs();
+  stream << settings.outputSize() << settings.outputDpi() << settings.devicePixelRatio()
+         << settings.rotation() << static_cast< int >( settings.outputImageFormat() )
+         << static_cast< int >( settings.flags() ) << settings.selectionColor()
+         << ( crs.authid().isEmpty() ? crs.toWkt() : crs.authid() );
+
+  if ( settings.isTemporal() )
+    stream << settings.temporalRange().begin() << settings.temporalRange().end();
+
+  // filters
+  if ( vl )
+  {
+    stream << vl->subsetString();
+
+    QList<QgsFeatureId> selectedIds = qgis::setToList( vl->selectedFeatureIds() );
+    std::sort( selectedIds.begin(), selectedIds.end() );
+    stream << selectedIds;
+
+    if ( filterProvider )
+    {
+      QgsFeatureRequest request;
+      filterProvider->filterFeatures( vl, request );
+      stream << static_cast< int >( request.filterType() );
+      if ( request.filterExpression() )
+        stream << request.filterExpression()->expression();
+      QList<QgsFeatureId> filterIds = qgis::setToList( request.filterFids() );
+      std::sort( filterIds.begin(), filterIds.end() );
+      stream << filterIds;
+    }
+  }
+
+  return QStringLiteral( "%1:%2" ).arg( layer->id(), QString::fromLatin1( QCryptographicHash::hash( data, QCryptographicHash::Sha1 ).toHex() ) );
+}
+
+bool QgsServerRenderedLayerCache::metatileSettings( const QgsMapSettings &settings, QgsMapSettings &metatile, QPoint &offset )
+{
+  const QSize size = settings.outputSize();
+  const double mapUnitsPerPixel = settings.mapUnitsPerPixel();
+  const double devicePixelRatio = settings.devicePixelRatio();
+  if ( !qgsDoubleNear( settings.rotation(), 0.0 ) || mapUnitsPerPixel <= 0 || size.isEmpty()
+       || !qgsDoubleNear( devicePixelRatio, std::round( devicePixelRatio ) ) )
+    return false;
+
+  // position of the map in hundredths of pixels from the origin of the CRS, rows going down
+  const QgsRectangle extent = settings.visibleExtent();
+  const double left = extent.xMinimum() / mapUnitsPerPixel * 100.0;
+  const double top = -extent.yMaximum() / mapUnitsPerPixel * 100.0;
+  if ( std::fabs( left ) > 1e15 || std::fabs( top ) > 1e15 )
+    return false;
+
+  // the grid is shifted by the fraction of pixel of the map, and the map starts on a whole pixel of the grid
+  const qint64 column = static_cast< qint64 >( std::floor( std::round( left ) / 100.0 ) );
+  const qint64 row = static_cast< qint64 >( std::floor( std::round( top ) / 100.0 ) );
+  const double shiftX = std::round( left ) - column * 100.0;
+  const double shiftY = std::round( top ) - row * 100.0;
+
+  const auto floorDiv = []( qint64 value, qint64 divisor ) -> qint64
+  {
+    return value >= 0 ? value / divisor : -( ( -value + divisor - 1 ) / divisor );
+  };
+  const qint64 tileColumn = floorDiv( column, METATILE_SIZE );
+  const qint64 tileRow = floorDiv( row, METATILE_SIZE );
+  if ( tileColumn != floorDiv( column + size.width() - 1, METATILE_SIZE )
+       || tileRow != floorDiv( row + size.height() - 1, METATILE_SIZE ) )
+    return false;
+
+  offset = QPoint( static_cast< int >( column - tileColumn * METATILE_SIZE ), static_cast< int >( row - tileRow * METATILE_SIZE ) );
+
+  const double xMinimum = ( tileColumn * METATILE_SIZE * 100.0 + shiftX ) / 100.0 * mapUnitsPerPixel;
+  const double yMaximum = -( tileRow * METATILE_SIZE * 100.0 + shiftY ) / 100.0 * mapUnitsPerPixel;
+  const double tileSize = METATILE_SIZE * mapUnitsPerPixel;
+
+  metatile = settings;
+  metatile.setOutputSize( QSize( METATILE_SIZE, METATILE_SIZE ) );
+  metatile.setExtent( QgsRectangle( xMinimum, yMaximum - tileSize, xMinimum + tileSize, yMaximum ) );
+  return true;
+}
+
+QString QgsServerRenderedLayerCache::entryKey( const QString &projectPath, const QString &key )
+{
+  return projectPath + QChar( '\n' ) + key;
+}
+
+void QgsServerRenderedLayerCache::removeEntry( QHash<QString, Entry>::iterator it )
+{
+  mSize -= it->size;
+  mLru.erase( it->lruPosition );
+  mEntries.erase( it );
+}
+
+void QgsServerRenderedLayerCache::trim( qint64 maximum )
+{
+  while ( mSize > maximum && !mLru.empty() )
+  {
+    removeEntry( mEntries.find( mLru.back() ) );
+  }
+}
+
+quint64 QgsServerRenderedLayerCache::layerRevision( QgsMapLayer *layer )
+{
+  QMutexLocker locker( &mLayerMutex );
+  auto it = mLayers.constFind( layer );
+  if ( it != mLayers.constEnd() )
+    return it->revision;
+
+  LayerState state;
+  state.revision = ++mRevisionCounter;
+  state.currentStyle = layer->styleManager()->currentStyle();
+  // direct connections, as the layer may live in another thread than the cache
+  state.connections << QObject::connect( layer, &QgsMapLayer::rendererChanged, [this, layer] { bumpRevision( layer ); } );
+  state.connections << QObject::connect( layer, &QgsMapLayer::dataSourceChanged, [this, layer] { bumpRevision( layer ); } );
+  state.connections << QObject::connect( layer, &QgsMapLayer::dataChanged, [this, layer] { bumpRevision( layer ); } );
+  state.connections << QObject::connect( layer->styleManager(), &QgsMapLayerStyleManager::currentStyleChanged, [this, layer]( const QString & style ) { currentStyleChanged( layer, style ); } );
+  state.connections << QObject::connect( layer, &QObject::destroyed, [this, layer] { layerDestroyed( layer ); } );
+  mLayers.insert( layer, state );
+  return state.revision;
+}
+
+void QgsServerRenderedLayerCache::bumpRevision( QgsMapLayer *layer )
+{
+  QMutexLocker locker( &mLayerMutex );
+  auto it = mLayers.find( layer );
+  if ( it == mLayers.end() )
+    return;
+
+  // the renderer of the new style is applied before the style manager notifies the
+  // style change: switching between the styles of the layer is not a new revision
+  if ( layer->styleManager()->currentStyle() != it->currentStyle )
+    return;
+
+  it->revision = ++mRevisionCounter;
+}
+
+void QgsServerRenderedLayerCache::currentStyleChanged( QgsMapLayer *layer, const QString &style )
+{
+  QMutexLocker locker( &mLayerMutex );
+  auto it = mLayers.find( layer );
+  if ( it != mLayers.end() )
+    it->currentStyle = style;
+}
+
+void QgsServerRenderedLayerCache::layerDestroyed( QgsMapLayer *layer )
+{
+  QMutexLocker locker( &mLayerMutex );
+  mLayers.remove( layer );
+}
+
+QString QgsServerRenderedLayerCache::dataStamp( const QgsMapLayer *layer )
+{
+  const qint64 now = QDateTime::currentMSecsSinceEpoch();
+  const QString source = layer->providerType() + QChar( '\n' ) + layer->source();
+
+  QString stamp;
+  {
+    QMutexLocker locker( &mFileStampMutex );
+    auto it = mFileStamps.find( source );
+    if ( it == mFileStamps.end() || now - it->checked >= DATA_CHECK_INTERVAL )
+    {
+      // listing the files of the layer for each request would be as slow as reading small layers
+      if ( it == mFileStamps.end() )
+        it = mFileStamps.insert( source, FileStamp() );
+      it->stamp = fileStamp( layer );
+      it->checked = now;
+    }
+    stamp = it->stamp;
+  }
+  if ( !stamp.isEmpty() )
+    return stamp;
+
+  // other layers are reused until the end of the current time to live period
+  const int timeToLive = this->timeToLive();
+  if ( timeToLive <= 0 )
+    return QString();
+  return QStringLiteral( "expires:%1" ).arg( now / ( timeToLive * 1000LL ) + 1 );
+}
+
+QString QgsServerRenderedLayerCache::fileStamp( const QgsMapLayer *layer )
+{
+  const QVariantMap parts = QgsProviderRegistry::instance()->decodeUri( layer->providerType(), layer->source() );
+  const QFileInfo file( parts.value( QStringLiteral( "path" ) ).toString() );
+  if ( !file.isFile() )
+    return QString();
+
+  // sidecar files, e.g. the attributes of a shapefile or the write ahead log of a GeoPackage
+  QString stamp;
+  const QFileInfoList files = file.dir().entryInfoList( QStringList() << file.completeBaseName() + QStringLiteral( ".*" ), QDir::Files, QDir::Name );
+  for ( const QFileInfo &info : files )
+  {
+    stamp += QStringLiteral( "%1:%2:%3;" ).arg( info.fileName() ).arg( info.lastModified().toMSecsSinceEpoch() ).arg( info.size() );
+  }
+  return stamp;
+}
@@ -0,0 +1,248 @@
+/***************************************************************************
+                              qgsserverrenderedlayercache.h
+                              -----------------------------
+  begin                : October 2026
+  copyright            : (C) 2026 by QGIS contributors
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef QGSSERVERRENDEREDLAYERCACHE_H
+#define QGSSERVERRENDEREDLAYERCACHE_H
+
+#include <QHash>
+#include <QImage>
+#include <QList>
+#include <QMetaObject>
+#include <QMutex>
+#include <QPoint>
+#include <QString>
+#include <list>
+
+#include "qgis_server.h"
+#include "qgis_sip.h"
+
+class QgsMapLayer;
+class QgsMapSettings;
+class QgsFeatureFilterProvider;
+
+/**
+ * \ingroup server
+ * \class QgsServerRenderedLayerCache
+ * \brief Thread safe cache of rendered layer images shared between server requests.
+ *
+ * Unlike QgsMapRendererCache, which only lives as long as a single render job, this
+ * cache keeps the images of individual layers across WMS GetMap requests, so that
+ * overlapping requests (e.g. from tiled clients) can reuse them instead of fetching
+ * and rendering the layer data again.
+ *
+ * Layers are rendered and cached by metatiles: blocks of METATILE_SIZE by METATILE_SIZE
+ * pixels on a grid aligned on the pixels of the requested map (see metatileSettings()),
+ * so that all the tiles requested by a tiled client at a given scale are cropped from a
+ * few metatiles. Images are stored under a key built by layerKey() from everything
+ * affecting the rendered image of a layer: its current style and revision, the metatile
+ * extent, the output DPI and CRS and the filters applied to the layer. The least recently
+ * used images are dropped once the total size of the cached images exceeds maximumSize().
+ *
+ * Entries are grouped by project and are removed with invalidate() when QgsConfigCache
+ * reloads a project. For layers read from local files, the modification time and size of
+ * the files are part of the key. They are checked again at most every DATA_CHECK_INTERVAL
+ * milliseconds. Changes to the data of other layers, such as database or memory layers,
+ * can't be detected, so their images are only reused for timeToLive() seconds. Setting a
+ * new renderer or data source on a layer, or editing its data through the layer, bumps its
+ * revision, which is also part of the key.
+ *
+ * \since QGIS 3.18
+ */
+class SERVER_EXPORT QgsServerRenderedLayerCache
+{
+  public:
+
+    //! Width and height in pixels of the metatiles in which layers are rendered and cached
+    static const int METATILE_SIZE = 1024;
+
+    //! Interval in milliseconds between two checks of the data files of a layer
+    static const int DATA_CHECK_INTERVAL = 1000;
+
+    /**
+     * Returns the server-wide instance of the cache.
+     */
+    static QgsServerRenderedLayerCache *instance();
+
+    /**
+     * Constructor for QgsServerRenderedLayerCache, with a maximum size in bytes
+     * of \a maximumSize. A maximum size of 0 disables the cache.
+     */
+    explicit QgsServerRenderedLayerCache( qint64 maximumSize = 0 );
+
+    ~QgsServerRenderedLayerCache();
+
+    //! QgsServerRenderedLayerCache cannot be copied
+    QgsServerRenderedLayerCache( const QgsServerRenderedLayerCache &rh ) = delete;
+    //! QgsServerRenderedLayerCache cannot be copied
+    QgsServerRenderedLayerCache &operator=( const QgsServerRenderedLayerCache &rh ) = delete;
+
+    /**
+     * Sets the \a maximum size in bytes of the cached images, evicting the least
+     * recently used images if required. A maximum size of 0 disables the cache.
+     * \see maximumSize()
+     */
+    void setMaximumSize( qint64 maximum );
+
+    /**
+     * Returns the maximum size in bytes of the cached images.
+     * \see setMaximumSize()
+     */
+    qint64 maximumSize() const;
+
+    /**
+     * Sets the time in \a seconds during which the images of layers whose data changes
+     * can't be detected (e.g. database or memory layers) are reused. A time of 0 disables
+     * the caching of these layers, which is the default.
+     * \see timeToLive()
+     */
+    void setTimeToLive( int seconds );
+
+    /**
+     * Returns the time in seconds during which the images of layers whose data changes
+     * can't be detected are reused.
+     * \see setTimeToLive()
+     */
+    int timeToLive() const;
+
+    /**
+     * Returns TRUE if the cache is enabled, i.e. if its maximum size is not 0.
+     */
+    bool isEnabled() const;
+
+    /**
+     * Returns the current size in bytes of the cached images.
+     */
+    qint64 size() const;
+
+    /**
+     * Returns the number of cached images.
+     */
+    int count() const;
+
+    /**
+     * Returns the cached image for \a key in project \a projectPath, or a null image
+     * if there is none.
+     *
+     * The image is marked as the most recently used one.
+     */
+    QImage image( const QString &projectPath, const QString &key );
+
+    /**
+     * Stores the rendered \a image for \a key in project \a projectPath.
+     *
+     * Returns FALSE if the cache is disabled or the image is larger than maximumSize().
+     */
+    bool insert( const QString &projectPath, const QString &key, const QImage &image );
+
+    /**
+     * Removes all images cached for the project \a projectPath.
+     */
+    void invalidate( const QString &projectPath );
+
+    /**
+     * Removes all cached images.
+     */
+    void clear();
+
+    /**
+     * Returns the cache key of the image of \a layer rendered with the map \a settings, or
+     * an empty string if the image of the layer can't be cached.
+     *
+     * Layers with labels or diagrams and layers styled by a SLD are not cached, nor are
+     * layers whose data changes can't be detected if timeToLive() is 0. If \a filterProvider is set, the filters it applies to
+     * the layer are part of the key.
+     *
+     * The layer is tracked by the cache, so that changes made to its renderer or data through
+     * the layer give new keys.
+     */
+    QString layerKey( QgsMapLayer *layer, const QgsMapSettings &settings, const QgsFeatureFilterProvider *filterProvider = nullptr );
+
+    /**
+     * Sets \a metatile to the settings of the metatile containing the map rendered with
+     * \a settings, and \a offset to the position in pixels of the map within the metatile.
+     *
+     * The metatile grid starts at the origin of the destination CRS and is shifted by the
+     * fraction of pixel of the map extent, so that the tiles of a tiled client all fall on
+     * the same grid.
+     *
+     * Returns FALSE if the map can't be cropped from a metatile, e.g. if it is rotated or
+     * does not fit in a single metatile.
+     */
+    static bool metatileSettings( const QgsMapSettings &settings, QgsMapSettings &metatile SIP_OUT, QPoint &offset SIP_OUT );
+
+  private:
+
+#ifdef SIP_RUN
+    QgsServerRenderedLayerCache( const QgsServerRenderedLayerCache & ) SIP_FORCE;
+#endif
+
+    struct Entry
+    {
+      QString projectPath;
+      QImage image;
+      qint64 size = 0;
+      std::list<QString>::iterator lruPosition;
+    };
+
+    struct LayerState
+    {
+      quint64 revision = 0;
+      QString currentStyle;
+      QList<QMetaObject::Connection> connections;
+    };
+
+    static QString entryKey( const QString &projectPath, const QString &key );
+    void removeEntry( QHash<QString, Entry>::iterator it );
+    void trim( qint64 maximum );
+
+    //! Returns the revision of \a layer, starting to track it if required
+    quint64 layerRevision( QgsMapLayer *layer );
+    void bumpRevision( QgsMapLayer *layer );
+    void currentStyleChanged( QgsMapLayer *layer, const QString &style );
+    void layerDestroyed( QgsMapLayer *layer );
+
+    struct FileStamp
+    {
+      QString stamp;
+      qint64 checked = 0;
+    };
+
+    //! Returns a stamp of the data of \a layer, or an empty string if changes to its data can't be detected
+    QString dataStamp( const QgsMapLayer *layer );
+
+    //! Returns a stamp of the files of the data source of \a layer, or an empty string if it is not file based
+    static QString fileStamp( const QgsMapLayer *layer );
+
+    mutable QMutex mMutex;
+    qint64 mMaximumSize = 0;
+    int mTimeToLive = 0;
+    qint64 mSize = 0;
+    QHash<QString, Entry> mEntries;
+    //! Entry keys, most recently used first
+    std::list<QString> mLru;
+
+    //! Protects the layer states, separately from the images as layer signals may be emitted while rendering
+    mutable QMutex mLayerMutex;
+    QHash<QgsMapLayer *, LayerState> mLayers;
+    quint64 mRevisionCounter = 0;
+
+    //! Protects the file stamps
+    QMutex mFileStampMutex;
+    //! File stamps of the layers, by provider and source
+    QHash<QString, FileStamp> mFileStamps;
+};
+
+#endif // QGSSERVERRENDEREDLAYERCACHE_H
@@ -22,6 +22,8 @@
 #include <QSettings>
 #include <QDir>
 
+#include <algorithm>
+
 QgsServerSettings::QgsServerSettings()
 {
   load();
@@ -278,6 +280,54 @@ void QgsServerSettings::initSettings()
 
   mSettings[ sLogProfile.envVar ] = sLogProfile;
 
+  // rendered layer cache size
+  const Setting sRenderedLayerCacheSize = { QgsServerSettingsEnv::QGIS_SERVER_RENDERED_LAYER_CACHE_SIZE,
+                                            QgsServerSettingsEnv::DEFAULT_VALUE,
+                                            QStringLiteral( "Maximum size in bytes of rendered layer images shared between requests, 0 to disable" ),
+                                            QStringLiteral( "/qgis/server_rendered_layer_cache_size" ),
+                                            QVariant::LongLong,
+                                            QVariant( 0 ),
+                                            QVariant()
+                                          };
+
+  mSettings[ sRenderedLayerCacheSize.envVar ] = sRenderedLayerCacheSize;
+
+  // worker threads
+  const Setting sWorkerThreads = { QgsServerSettingsEnv::QGIS_SERVER_WORKER_THREADS,
+                                   QgsServerSettingsEnv::DEFAULT_VALUE,
+                                   QStringLiteral( "Number of worker threads handling requests concurrently" ),
+                                   QStringLiteral( "/qgis/server_worker_threads" ),
+                                   QVariant::Int,
+                                   QVariant( 1 ),
+                                   QVariant()
+                                 };
+
+  mSettings[ sWorkerThreads.envVar ] = sWorkerThreads;
+
+  // max queued requests
+  const Setting sMaxQueuedRequests = { QgsServerSettingsEnv::QGIS_SERVER_MAX_QUEUED_REQUESTS,
+                                       QgsServerSettingsEnv::DEFAULT_VALUE,
+                                       QStringLiteral( "Maximum number of requests waiting for a worker thread" ),
+                                       QStringLiteral( "/qgis/server_max_queued_requests" ),
+                                       QVariant::Int,
+                                       QVariant( 64 ),
+                                       QVariant()
+                                     };
+
+  mSettings[ sMaxQueuedRequests.envVar ] = sMaxQueuedRequests;
+
+  // rendered layer cache time to live
+  const Setting sRenderedLayerCacheTimeToLive = { QgsServerSettingsEnv::QGIS_SERVER_RENDERED_LAYER_CACHE_TTL,
+                                                  QgsServerSettingsEnv::DEFAULT_VALUE,
+                                                  QStringLiteral( "Time in seconds during which the rendered images of layers whose data changes can't be detected are reused, 0 to not cache them" ),
+                                                  QStringLiteral( "/qgis/server_rendered_layer_cache_ttl" ),
+                                                  QVariant::Int,
+                                                  QVariant( 60 ),
+                                                  QVariant()
+                                                };
+
+  mSettings[ sRenderedLayerCacheTimeToLive.envVar ] = sRenderedLayerCacheTimeToLive;
+
 }
 
 void QgsServerSettings::load()
@@ -527,6 +577,26 @@ bool QgsServerSettings::getPrintDisabled() const
   return value( QgsServerSettingsEnv::QGIS_SERVER_DISABLE_GETPRINT ).toBool();
 }
 
+qint64 QgsServerSettings::renderedLayerCacheSize() const
+{
+  return value( QgsServerSettingsEnv::QGIS_SERVER_RENDERED_LAYER_CACHE_SIZE ).toLongLong();
+}
+
+int QgsServerSettings::renderedLayerCacheTimeToLive() const
+{
+  return std::max( 0, value( QgsServerSettingsEnv::QGIS_SERVER_RENDERED_LAYER_CACHE_TTL ).toInt() );
+}
+
+int QgsServerSettings::workerThreads() const
+{
+  return std::max( 1, value( QgsServerSettingsEnv::QGIS_SERVER_WORKER_THREADS ).toInt() );
+}
+
+int QgsServerSettings::maxQueuedRequests() const
+{
+  return std::max( 0, value( QgsServerSettingsEnv::QGIS_SERVER_MAX_QUEUED_REQUESTS ).toInt() );
+}
+
 bool QgsServerSettings::logProfile()
 {
   return value( QgsServerSettingsEnv::QGIS_SERVER_LOG_PROFILE, false ).toBool();
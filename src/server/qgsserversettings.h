@@ -72,6 +72,10 @@ class SERVER_EXPORT QgsServerSettingsEnv : public QObject
       QGIS_SERVER_LANDING_PAGE_PROJECTS_DIRECTORIES, //!< Directories used by the landing page service to find .qgs and .qgz projects (since QGIS 3.16)
       QGIS_SERVER_LANDING_PAGE_PROJECTS_PG_CONNECTIONS, //!< PostgreSQL connection strings used by the landing page service to find projects (since QGIS 3.16)
       QGIS_SERVER_LOG_PROFILE, //!< When QGIS_SERVER_LOG_LEVEL is 0 this flag adds to the logs detailed information about the time taken by the different processing steps inside the QGIS Server request (since QGIS 3.16)
+      QGIS_SERVER_RENDERED_LAYER_CACHE_SIZE, //!< Maximum size in bytes of the rendered layer images shared between requests, 0 disables the cache (since QGIS 3.18)
+      QGIS_SERVER_WORKER_THREADS, //!< Number of worker threads handling requests concurrently in qgis_mapserver and qgis_mapserv.fcgi, defaults to 1 (since QGIS 3.18)
+      QGIS_SERVER_MAX_QUEUED_REQUESTS, //!< Maximum number of requests waiting for a worker thread before new ones are rejected, defaults to 64 (since QGIS 3.18)
+      QGIS_SERVER_RENDERED_LAYER_CACHE_TTL, //!< Time in seconds during which the cached images of layers whose data changes can't be detected, such as database layers, are reused, defaults to 60 (since QGIS 3.18)
     };
     Q_ENUM( EnvVar )
 };
@@ -283,6 +287,56 @@ class SERVER_EXPORT QgsServerSettings
      */
     bool getPrintDisabled() const;
 
+    /**
+     * Returns the maximum size in bytes of the rendered layer images shared
+     * between WMS requests.
+     *
+     * The default value is 0, which disables the cache. This value can be changed
+     * by setting the environment variable QGIS_SERVER_RENDERED_LAYER_CACHE_SIZE.
+     *
+     * \see QgsServerRenderedLayerCache
+     * \since QGIS 3.18
+     */
+    qint64 renderedLayerCacheSize() const;
+
+    /**
+     * Returns the time in seconds during which the rendered images of layers whose
+     * data changes can't be detected, such as database or memory layers, are reused.
+     *
+     * The default value is 60, 0 disables the caching of these layers. This value can
+     * be changed by setting the environment variable QGIS_SERVER_RENDERED_LAYER_CACHE_TTL.
+     *
+     * \see renderedLayerCacheSize()
+     * \see QgsServerRenderedLayerCache::timeToLive()
+     * \since QGIS 3.18
+     */
+    int renderedLayerCacheTimeToLive() const;
+
+    /**
+     * Returns the number of worker threads handling requests concurrently.
+     *
+     * Each worker thread keeps its own copies of the projects. The default value
+     * is 1, which handles the requests sequentially in the main thread. This value
+     * can be changed by setting the environment variable QGIS_SERVER_WORKER_THREADS.
+     *
+     * \see maxQueuedRequests()
+     * \see QgsServerWorkerPool
+     * \since QGIS 3.18
+     */
+    int workerThreads() const;
+
+    /**
+     * Returns the maximum number of requests waiting for a worker thread. Requests
+     * received while the queue is full are rejected with a 503 status code.
+     *
+     * The default value is 64, this value can be changed by setting the environment
+     * variable QGIS_SERVER_MAX_QUEUED_REQUESTS.
+     *
+     * \see workerThreads()
+     * \since QGIS 3.18
+     */
+    int maxQueuedRequests() const;
+
     /**
      * Returns the string representation of a setting.
      * \since QGIS 3.16
@@ -0,0 +1,173 @@
+/***************************************************************************
+                              qgsserverworkerpool.cpp
+                              -----------------------
+  begin                : October 2026
+  copyright            : (C) 2026 by QGIS contributors
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qgsconfig.h"
+#include "qgsserverworkerpool.h"
+#include "qgsserver.h"
+#include "qgsmessagelog.h"
+#include "qgsserverinterfaceimpl.h"
+#include "qgsserversettings.h"
+#include "qgsserverplugins.h"
+
+#include <QThread>
+
+#include <algorithm>
+
+///@cond PRIVATE
+class QgsServerWorkerPool::Worker : public QThread
+{
+  public:
+    explicit Worker( QgsServerWorkerPool *pool )
+      : mPool( pool )
+    {}
+
+  protected:
+    void run() override
+    {
+      // the server is already initialized, this only creates the per thread caches
+      QgsServer server;
+
+      Job job;
+      while ( mPool->takeJob( job ) )
+      {
+        try
+        {
+          job( server );
+        }
+        catch ( std::exception &e )
+        {
+          QgsMessageLog::logMessage( QStringLiteral( "Unhandled exception in server worker: %1" ).arg( e.what() ), QStringLiteral( "Server" ), Qgis::Critical );
+        }
+        job = nullptr;
+        mPool->jobFinished();
+      }
+    }
+
+  private:
+    QgsServerWorkerPool *mPool = nullptr;
+};
+///@endcond
+
+QgsServerWorkerPool::QgsServerWorkerPool( int workerCount, int maxQueuedJobs )
+  : mMaxQueuedJobs( std::max( 0, maxQueuedJobs ) )
+{
+  workerCount = std::max( 1, workerCount );
+  mMetrics.workerCount = workerCount;
+  mWorkers.reserve( workerCount );
+  for ( int i = 0; i < workerCount; ++i )
+  {
+    std::unique_ptr< Worker > worker = qgis::make_unique< Worker >( this );
+    worker->setObjectName( QStringLiteral( "QGIS server worker %1" ).arg( i ) );
+    worker->start();
+    mWorkers.emplace_back( std::move( worker ) );
+  }
+}
+
+QgsServerWorkerPool::~QgsServerWorkerPool()
+{
+  stop();
+}
+
+bool QgsServerWorkerPool::submit( const Job &job )
+{
+  QMutexLocker locker( &mMutex );
+  // idle workers take the queued jobs right away, they do not count against the queue size
+  const int idleWorkers = mMetrics.workerCount - mMetrics.busyWorkers;
+  if ( mStopping || mQueue.size() >= mMaxQueuedJobs + idleWorkers )
+  {
+    mMetrics.rejectedJobs++;
+    return false;
+  }
+
+  QueuedJob queued;
+  queued.job = job;
+  queued.queueTime.start();
+  mQueue.enqueue( queued );
+
+  mMetrics.acceptedJobs++;
+  mMetrics.peakQueuedJobs = std::max( mMetrics.peakQueuedJobs, mQueue.size() );
+  mJobQueued.wakeOne();
+  return true;
+}
+
+void QgsServerWorkerPool::stop()
+{
+  {
+    QMutexLocker locker( &mMutex );
+    mStopping = true;
+    mJobQueued.wakeAll();
+  }
+
+  for ( const std::unique_ptr< QThread > &worker : mWorkers )
+    worker->wait();
+  mWorkers.clear();
+}
+
+int QgsServerWorkerPool::workerCount() const
+{
+  QMutexLocker locker( &mMutex );
+  return mMetrics.workerCount;
+}
+
+QgsServerWorkerPool::Metrics QgsServerWorkerPool::metrics() const
+{
+  QMutexLocker locker( &mMutex );
+  Metrics metrics = mMetrics;
+  metrics.queuedJobs = mQueue.size();
+  const qint64 started = mMetrics.acceptedJobs - metrics.queuedJobs;
+  metrics.averageQueueTime = started > 0 ? static_cast< double >( mTotalQueueTime ) / started : 0;
+  return metrics;
+}
+
+int QgsServerWorkerPool::configuredWorkerCount( QgsServer &server )
+{
+  const int workerCount = server.serverInterface()->serverSettings()->workerThreads();
+#ifdef HAVE_SERVER_PYTHON_PLUGINS
+  if ( workerCount > 1 && !QgsServerPlugins::serverPlugins().isEmpty() )
+  {
+    QgsMessageLog::logMessage( QStringLiteral( "Server Python plugins are loaded, requests are handled by a single thread" ), QStringLiteral( "Server" ), Qgis::Warning );
+    return 1;
+  }
+#endif
+  return workerCount;
+}
+
+bool QgsServerWorkerPool::takeJob( Job &job )
+{
+  QMutexLocker locker( &mMutex );
+  while ( mQueue.isEmpty() )
+  {
+    if ( mStopping )
+      return false;
+
+    mJobQueued.wait( &mMutex );
+  }
+
+  QueuedJob queued = mQueue.dequeue();
+  const qint64 queueTime = queued.queueTime.elapsed();
+  mTotalQueueTime += queueTime;
+  mMetrics.maximumQueueTime = std::max( mMetrics.maximumQueueTime, queueTime );
+  mMetrics.busyWorkers++;
+  job = queued.job;
+  return true;
+}
+
+void QgsServerWorkerPool::jobFinished()
+{
+  QMutexLocker locker( &mMutex );
+  mMetrics.busyWorkers--;
+  mMetrics.completedJobs++;
+}
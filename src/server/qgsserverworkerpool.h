@@ -0,0 +1,159 @@
+/***************************************************************************
+                              qgsserverworkerpool.h
+                              ---------------------
+  begin                : October 2026
+  copyright            : (C) 2026 by QGIS contributors
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef QGSSERVERWORKERPOOL_H
+#define QGSSERVERWORKERPOOL_H
+
+#define SIP_NO_FILE
+
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QQueue>
+#include <QWaitCondition>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "qgis_server.h"
+
+class QgsServer;
+class QThread;
+
+/**
+ * \ingroup server
+ * \class QgsServerWorkerPool
+ * \brief A pool of worker threads handling server requests concurrently.
+ *
+ * Each worker thread owns a QgsServer instance. Workers don't process events and
+ * don't set the current QgsProject::instance(): each request borrows a copy of its
+ * project from QgsConfigCache::acquireProject(), as requests modify the layers of
+ * the project they handle. Requests are
+ * submitted as jobs to a bounded queue: when all the workers are busy and the
+ * queue is full, submit() returns FALSE and the caller is expected to reject the
+ * request (e.g. with a 503 status code).
+ *
+ * The server must have been initialized by constructing a QgsServer in the main
+ * thread before the pool is created. Server Python plugins are not thread safe,
+ * the pool should not be used when they are enabled.
+ *
+ * \note not available in Python bindings
+ * \see QgsServerSettings::workerThreads()
+ * \since QGIS 3.18
+ */
+class SERVER_EXPORT QgsServerWorkerPool
+{
+  public:
+
+    //! Job run by a worker thread with its own \a server instance
+    typedef std::function< void( QgsServer &server ) > Job;
+
+    //! Load and backpressure metrics of the pool
+    struct Metrics
+    {
+      //! Number of worker threads
+      int workerCount = 0;
+      //! Number of workers currently running a job
+      int busyWorkers = 0;
+      //! Number of jobs currently waiting for a worker
+      int queuedJobs = 0;
+      //! Largest number of jobs which waited for a worker at the same time
+      int peakQueuedJobs = 0;
+      //! Total number of accepted jobs
+      qint64 acceptedJobs = 0;
+      //! Total number of jobs rejected because the queue was full
+      qint64 rejectedJobs = 0;
+      //! Total number of completed jobs
+      qint64 completedJobs = 0;
+      //! Average time in milliseconds jobs waited for a worker
+      double averageQueueTime = 0;
+      //! Longest time in milliseconds a job waited for a worker
+      qint64 maximumQueueTime = 0;
+    };
+
+    /**
+     * Constructor for QgsServerWorkerPool, starting \a workerCount threads.
+     *
+     * At most \a maxQueuedJobs jobs wait for a worker, further jobs are rejected.
+     */
+    QgsServerWorkerPool( int workerCount, int maxQueuedJobs );
+
+    /**
+     * Stops the pool, waiting for the queued jobs to complete.
+     */
+    ~QgsServerWorkerPool();
+
+    //! QgsServerWorkerPool cannot be copied
+    QgsServerWorkerPool( const QgsServerWorkerPool &rh ) = delete;
+    //! QgsServerWorkerPool cannot be copied
+    QgsServerWorkerPool &operator=( const QgsServerWorkerPool &rh ) = delete;
+
+    /**
+     * Queues a \a job to be run by the next available worker.
+     *
+     * Returns FALSE if the job was rejected because all the workers are busy
+     * and the queue is full, or because the pool is stopped.
+     */
+    bool submit( const Job &job );
+
+    /**
+     * Stops the pool: no new job is accepted and the call blocks until the
+     * queued jobs are completed and the worker threads are finished.
+     */
+    void stop();
+
+    //! Returns the number of worker threads
+    int workerCount() const;
+
+    //! Returns the maximum number of jobs waiting for a worker
+    int maxQueuedJobs() const { return mMaxQueuedJobs; }
+
+    //! Returns the current load and backpressure metrics of the pool
+    Metrics metrics() const;
+
+    /**
+     * Returns the number of worker threads configured in the settings of \a server,
+     * or 1 if server Python plugins are loaded as they are not thread safe.
+     * \see QgsServerSettings::workerThreads()
+     */
+    static int configuredWorkerCount( QgsServer &server );
+
+  private:
+
+    class Worker;
+    friend class Worker;
+
+    struct QueuedJob
+    {
+      Job job;
+      QElapsedTimer queueTime;
+    };
+
+    //! Waits for the next job, returns FALSE if the pool is stopped
+    bool takeJob( Job &job );
+    void jobFinished();
+
+    int mMaxQueuedJobs = 0;
+    std::vector< std::unique_ptr< QThread > > mWorkers;
+
+    mutable QMutex mMutex;
+    QWaitCondition mJobQueued;
+    QQueue< QueuedJob > mQueue;
+    bool mStopping = false;
+    Metrics mMetrics;
+    qint64 mTotalQueueTime = 0;
+};
+
+#endif // QGSSERVERWORKERPOOL_H
@@ -31,6 +31,8 @@
 #include <QCryptographicHash>
 #include <QFileSystemWatcher>
 #include <QDomDocument>
+#include <QThread>
+#include <functional>
 
 const QRegularExpression QgsLandingPageUtils::PROJECT_HASH_RE { QStringLiteral( "/(?<projectHash>[a-f0-9]{32})" ) };
 QMap<QString, QString> QgsLandingPageUtils::AVAILABLE_PROJECTS;
@@ -228,7 +230,21 @@ json QgsLandingPageUtils::projectInfo( const QString &projectUri, const QgsServe
   json info = json::object();
   info[ "id" ] = QCryptographicHash::hash( projectUri.toUtf8(), QCryptographicHash::Md5 ).toHex();
 
-  const QgsProject *p { QgsConfigCache::instance()->project( projectUri, serverSettings ) };
+  // worker threads of a QgsServerWorkerPool borrow a copy of the project
+  std::unique_ptr< QgsProject, std::function< void( QgsProject * ) > > acquiredProject( nullptr, []( QgsProject * acquired )
+  {
+    QgsConfigCache::instance()->releaseProject( acquired );
+  } );
+  const QgsProject *p = nullptr;
+  if ( qApp && QThread::currentThread() != qApp->thread() )
+  {
+    acquiredProject.reset( QgsConfigCache::instance()->acquireProject( projectUri, serverSettings ) );
+    p = acquiredProject.get();
+  }
+  else
+  {
+    p = QgsConfigCache::instance()->project( projectUri, serverSettings );
+  }
 
   if ( p )
   {
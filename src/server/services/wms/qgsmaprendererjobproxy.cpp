@@ -21,6 +21,11 @@
 #include "qgsmaprendererparalleljob.h"
 #include "qgsmaprenderercustompainterjob.h"
 #include "qgsapplication.h"
+#include "qgsmaprenderercache.h"
+#include "qgsserverrenderedlayercache.h"
+#include "qgsproject.h"
+
+#include <cmath>
 
 namespace QgsWms
 {
@@ -48,14 +53,25 @@ namespace QgsWms
     }
   }
 
+  void QgsMapRendererJobProxy::setRenderedLayerCache( QgsServerRenderedLayerCache *cache, const QgsProject *project )
+  {
+    mRenderedLayerCache = cache;
+    mProject = project;
+  }
+
   void QgsMapRendererJobProxy::render( const QgsMapSettings &mapSettings, QImage *image )
   {
+    std::unique_ptr<QgsMapRendererCache> cache;
+    if ( mRenderedLayerCache && mProject && mRenderedLayerCache->isEnabled() )
+      cache = prepareCache( mapSettings );
+
     if ( mParallelRendering )
     {
       QgsMapRendererParallelJob renderJob( mapSettings );
 #ifdef HAVE_SERVER_PYTHON_PLUGINS
       renderJob.setFeatureFilterProvider( mFeatureFilterProvider );
 #endif
+      renderJob.setCache( cache.get() );
       renderJob.start();
 
       // Allows the main thread to manage blocking call coming from rendering
@@ -77,11 +93,121 @@ namespace QgsWms
 #ifdef HAVE_SERVER_PYTHON_PLUGINS
       renderJob.setFeatureFilterProvider( mFeatureFilterProvider );
 #endif
+      renderJob.setCache( cache.get() );
       renderJob.renderSynchronously();
       mErrors = renderJob.errors();
     }
   }
 
+  std::unique_ptr<QgsMapRendererCache> QgsMapRendererJobProxy::prepareCache( const QgsMapSettings &mapSettings ) const
+  {
+    QgsMapSettings metatileSettings;
+    QPoint offset;
+    if ( !QgsServerRenderedLayerCache::metatileSettings( mapSettings, metatileSettings, offset ) )
+      return nullptr;
+
+    const QgsFeatureFilterProvider *filterProvider = nullptr;
+#ifdef HAVE_SERVER_PYTHON_PLUGINS
+    filterProvider = mFeatureFilterProvider;
+#endif
+
+    QHash<QString, QImage> images;
+    QHash<QString, QString> missingKeys;
+    QList<QgsMapLayer *> missingLayers;
+    const QList<QgsMapLayer *> layers = mapSettings.layers();
+    for ( QgsMapLayer *layer : layers )
+    {
+      if ( !layer || mProject->mapLayer( layer->id() ) != layer )
+        continue;
+
+      const QString key = mRenderedLayerCache->layerKey( layer, metatileSettings, filterProvider );
+      if ( key.isEmpty() )
+        continue;
+
+      const QImage image = mRenderedLayerCache->image( mProject->fileName(), key );
+      if ( image.isNull() )
+      {
+        missingLayers << layer;
+        missingKeys.insert( layer->id(), key );
+      }
+      else
+      {
+        images.insert( layer->id(), image );
+      }
+    }
+
+    if ( !missingLayers.isEmpty() )
+    {
+      // render the whole metatile of the missing layers, so that the next requests
+      // on the same metatile are cropped from the cache
+      metatileSettings.setLayers( missingLayers );
+      metatileSettings.setFlag( QgsMapSettings::DrawLabeling, false );
+
+      QgsMapRendererCache metatileCache;
+      metatileCache.init( metatileSettings.visibleExtent(), metatileSettings.scale() );
+
+      QSet<QString> failedLayers;
+      const QgsMapRendererJob::Errors errors = renderMetatile( metatileSettings, &metatileCache );
+      for ( const QgsMapRendererJob::Error &error : errors )
+        failedLayers.insert( error.layerID );
+
+      for ( QgsMapLayer *layer : qgis::as_const( missingLayers ) )
+      {
+        if ( failedLayers.contains( layer->id() ) || !metatileCache.hasCacheImage( layer->id() ) )
+          continue;
+
+        const QImage image = metatileCache.cacheImage( layer->id() );
+        mRenderedLayerCache->insert( mProject->fileName(), missingKeys.value( layer->id() ), image );
+        images.insert( layer->id(), image );
+      }
+    }
+
+    if ( images.isEmpty() )
+      return nullptr;
+
+    std::unique_ptr<QgsMapRendererCache> cache = qgis::make_unique<QgsMapRendererCache>();
+    cache->init( mapSettings.visibleExtent(), mapSettings.scale() );
+
+    const int ratio = static_cast< int >( std::round( mapSettings.devicePixelRatio() ) );
+    const QRect rect( offset * ratio, mapSettings.outputSize() * ratio );
+    for ( auto it = images.constBegin(); it != images.constEnd(); ++it )
+      cache->setCacheImage( it.key(), it.value().copy( rect ) );
+
+    return cache;
+  }
+
+  QgsMapRendererJob::Errors QgsMapRendererJobProxy::renderMetatile( const QgsMapSettings &metatileSettings, QgsMapRendererCache *cache ) const
+  {
+    if ( mParallelRendering )
+    {
+      QgsMapRendererParallelJob renderJob( metatileSettings );
+#ifdef HAVE_SERVER_PYTHON_PLUGINS
+      renderJob.setFeatureFilterProvider( mFeatureFilterProvider );
+#endif
+      renderJob.setCache( cache );
+      renderJob.start();
+
+      QEventLoop loop;
+      QObject::connect( &renderJob, &QgsMapRendererParallelJob::finished, &loop, &QEventLoop::quit );
+      loop.exec();
+
+      renderJob.waitForFinished();
+      return renderJob.errors();
+    }
+
+    QImage image( metatileSettings.deviceOutputSize(), metatileSettings.outputImageFormat() );
+    image.setDevicePixelRatio( metatileSettings.devicePixelRatio() );
+    image.fill( Qt::transparent );
+    QPainter painter( &image );
+    QgsMapRendererCustomPainterJob renderJob( metatileSettings, &painter );
+#ifdef HAVE_SERVER_PYTHON_PLUGINS
+    renderJob.setFeatureFilterProvider( mFeatureFilterProvider );
+#endif
+    renderJob.setCache( cache );
+    renderJob.renderSynchronously();
+    return renderJob.errors();
+  }
+
   QPainter *QgsMapRendererJobProxy::takePainter()
   {
     return mPainter.release();
@@ -22,6 +22,9 @@
 #include "qgsmaprendererjob.h"
 
 class QgsFeatureFilterProvider;
+class QgsMapRendererCache;
+class QgsProject;
+class QgsServerRenderedLayerCache;
 
 namespace QgsWms
 {
@@ -56,6 +59,16 @@ namespace QgsWms
        */
       void render( const QgsMapSettings &mapSettings, QImage *image );
 
+      /**
+       * Sets the server-wide \a cache used to reuse the layer images rendered
+       * by previous requests on \a project. Only the layers of the project
+       * are cached, not the temporary layers created for a single request.
+       * Layers are rendered in the cache by metatiles, from which the
+       * requested maps are cropped.
+       * \since QGIS 3.18
+       */
+      void setRenderedLayerCache( QgsServerRenderedLayerCache *cache, const QgsProject *project );
+
       /**
        * Takes ownership of the painter used for rendering.
        * \returns painter
@@ -73,8 +86,21 @@ namespace QgsWms
       QgsFeatureFilterProvider *mFeatureFilterProvider = nullptr;
       std::unique_ptr<QPainter> mPainter;
 
+      QgsServerRenderedLayerCache *mRenderedLayerCache = nullptr;
+      const QgsProject *mProject = nullptr;
+
       void getRenderErrors( const QgsMapRendererJob *job );
 
+      /**
+       * Creates a renderer cache filled with the images of the cached layers, cropped from
+       * their metatile. Missing metatiles are rendered and stored in the rendered layer cache.
+       * Returns NULLPTR if no layer can be reused.
+       */
+      std::unique_ptr<QgsMapRendererCache> prepareCache( const QgsMapSettings &mapSettings ) const;
+
+      //! Renders a metatile in \a cache and returns the rendering errors
+      QgsMapRendererJob::Errors renderMetatile( const QgsMapSettings &metatileSettings, QgsMapRendererCache *cache ) const;
+
       //! Layer id / error message
       QgsMapRendererJob::Errors mErrors;
   };
@@ -64,6 +64,7 @@
 #include "qgsserverexception.h"
 #include "qgsexpressioncontextutils.h"
 #include "qgsfeaturestore.h"
+#include "qgsserverrenderedlayercache.h"
 
 #include <QImage>
 #include <QPainter>
@@ -2587,7 +2588,7 @@ namespace QgsWms
       }
 
       // create vector layer
-      const QgsVectorLayer::LayerOptions options { QgsProject::instance()->transformContext() };
+      const QgsVectorLayer::LayerOptions options { mProject->transformContext() };
       std::unique_ptr<QgsVectorLayer> layer = qgis::make_unique<QgsVectorLayer>( url, param.mName, QLatin1String( "memory" ), options );
       if ( !layer->isValid() )
       {
@@ -2723,6 +2724,7 @@ namespace QgsWms
     filters.addProvider( mContext.accessControl() );
 #endif
     QgsMapRendererJobProxy renderJob( mContext.settings().parallelRendering(), mContext.settings().maxThreads(), &filters );
+    renderJob.setRenderedLayerCache( QgsServerRenderedLayerCache::instance(), mProject );
     renderJob.render( mapSettings, &image );
     painter = renderJob.takePainter();
 
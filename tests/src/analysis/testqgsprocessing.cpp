@@ -54,6 +54,7 @@
 #include "qgsprocessingparameterdxflayers.h"
 #include "qgsprocessingparametermeshdataset.h"
 #include "qgsdxfexport.h"
+#include "qgsprocessingfeaturepipe.h"
 
 class DummyAlgorithm : public QgsProcessingAlgorithm
 {
@@ -506,6 +507,24 @@ class DummyProvider4 : public QgsProcessingProvider // clazy:exclude=missing-qob
 
 };
 
+//! Feature based algorithm counting the features it processes
+class CountingFeatureAlgorithm : public QgsProcessingFeatureBasedAlgorithm
+{
+  public:
+
+    QString name() const override { return QStringLiteral( "counting" ); }
+    QString displayName() const override { return QStringLiteral( "counting" ); }
+    QString outputName() const override { return QStringLiteral( "counted" ); }
+    CountingFeatureAlgorithm *createInstance() const override { return new CountingFeatureAlgorithm(); }
+    QgsFeatureList processFeature( const QgsFeature &feature, QgsProcessingContext &, QgsProcessingFeedback * ) override
+    {
+      processedFeatures++;
+      return QgsFeatureList() << feature;
+    }
+
+    int processedFeatures = 0;
+};
+
 class DummyParameterType : public QgsProcessingParameterType
 {
 
@@ -622,6 +641,7 @@ class TestQgsProcessing: public QObject
     void modelExecution();
     void modelBranchPruning();
     void modelBranchPruningConditional();
+    void modelStreamedExecution();
     void modelWithProviderWithLimitedTypes();
     void modelVectorOutputIsCompatibleType();
     void modelAcceptableValues();
@@ -1129,6 +1149,18 @@ void TestQgsProcessing::feedback()
 
   QCOMPARE( f.htmlLog(), QStringLiteral( "info<br/><span style=\"color:red\">error</span><br/><span style=\"color:#777\">debug</span><br/><code>command</code><br/><code style=\"color:#777\">console</code><br/>" ) );
   QCOMPARE( f.textLog(), QStringLiteral( "info\nerror\ndebug\ncommand\nconsole\n" ) );
+
+  // buffered feedback, as used by worker threads, only reports when flushed
+  QgsProcessingBufferedFeedback buffered;
+  buffered.pushInfo( QStringLiteral( "buffered info" ) );
+  buffered.reportError( QStringLiteral( "buffered error" ), true );
+  buffered.pushWarning( QStringLiteral( "buffered warning" ) );
+  QgsProcessingFeedback target;
+  QVERIFY( target.textLog().isEmpty() );
+  buffered.flush( &target );
+  QCOMPARE( target.textLog(), QStringLiteral( "buffered info\nbuffered error\nbuffered warning\n" ) );
+  buffered.flush( &target );
+  QCOMPARE( target.textLog(), QStringLiteral( "buffered info\nbuffered error\nbuffered warning\n" ) );
 }
 
 void TestQgsProcessing::mapLayers()
@@ -10509,6 +10541,178 @@ void TestQgsProcessing::modelBranchPruningConditional()
   QVERIFY( ok ); // the branch with the exception should NOT be hit
 }
 
+void TestQgsProcessing::modelStreamedExecution()
+{
+  QgsVectorLayer *points = new QgsVectorLayer( QStringLiteral( "Point?crs=epsg:3111&field=id:integer" ), QStringLiteral( "points" ), QStringLiteral( "memory" ) );
+  QVERIFY( points->isValid() );
+  QgsFeatureList pointFeatures;
+  for ( int i = 0; i < 3; ++i )
+  {
+    QgsFeature f( points->fields() );
+    f.setAttributes( QgsAttributes() << i + 1 );
+    f.setGeometry( QgsGeometry::fromPointXY( QgsPointXY( i * i, i * i ) ) );
+    pointFeatures << f;
+  }
+  points->dataProvider()->addFeatures( pointFeatures );
+  QgsVectorLayer *mask = new QgsVectorLayer( QStringLiteral( "Polygon?crs=epsg:3111" ), QStringLiteral( "mask" ), QStringLiteral( "memory" ) );
+  QVERIFY( mask->isValid() );
+  QgsFeature maskFeature;
+  maskFeature.setGeometry( QgsGeometry::fromWkt( QStringLiteral( "Polygon((0.5 0.5, 4 0.5, 4 4, 0.5 4, 0.5 0.5))" ) ) );
+  mask->dataProvider()->addFeature( maskFeature );
+  QgsProject p;
+  p.addMapLayers( QList< QgsMapLayer * >() << points << mask );
+
+  // streamed features keep the ids of the input features
+  {
+    QgsProcessingContext context;
+    context.setProject( &p );
+    QgsProcessingFeedback feedback;
+    QVariantMap moveParams;
+    moveParams.insert( QStringLiteral( "INPUT" ), QStringLiteral( "points" ) );
+    moveParams.insert( QStringLiteral( "DELTA_X" ), 1 );
+    std::unique_ptr< QgsProcessingFeatureBasedAlgorithm > move( static_cast< QgsProcessingFeatureBasedAlgorithm * >( QgsApplication::processingRegistry()->createAlgorithmById( QStringLiteral( "native:translate" ) ) ) );
+    QVERIFY( move->prepare( moveParams, context, &feedback ) );
+    QgsProcessingFeaturePipe pipe( std::move( move ), moveParams, context, &feedback );
+
+    QgsFeatureIds ids;
+    QgsFeatureIterator it = pipe.getFeatures();
+    QgsFeature f;
+    while ( it.nextFeature( f ) )
+    {
+      ids << f.id();
+      QCOMPARE( f.attribute( 0 ), points->getFeature( f.id() ).attribute( 0 ) );
+    }
+    QCOMPARE( ids, points->allFeatureIds() );
+
+    const QgsFeatureId id = *ids.constBegin();
+    it = pipe.getFeatures( QgsFeatureRequest( id ) );
+    QVERIFY( it.nextFeature( f ) );
+    QCOMPARE( f.id(), id );
+    QVERIFY( !it.nextFeature( f ) );
+
+    QVERIFY( pipe.postProcess( context, &feedback ).isEmpty() );
+  }
+
+  // streamed features are processed once only, even by algorithms reading their input by extent
+  {
+    QgsProcessingContext context;
+    context.setProject( &p );
+    QgsProcessingFeedback feedback;
+    QVariantMap countParams;
+    countParams.insert( QStringLiteral( "INPUT" ), QStringLiteral( "points" ) );
+    std::unique_ptr< CountingFeatureAlgorithm > counting = qgis::make_unique< CountingFeatureAlgorithm >();
+    counting->initialize();
+    QVERIFY( counting->prepare( countParams, context, &feedback ) );
+    const CountingFeatureAlgorithm *countingAlg = counting.get();
+    QgsProcessingFeaturePipe pipe( std::move( counting ), countParams, context, &feedback );
+    context.addFeaturePipe( QStringLiteral( "counted" ), &pipe );
+
+    QVariantMap clipParams;
+    clipParams.insert( QStringLiteral( "INPUT" ), QStringLiteral( "counted" ) );
+    clipParams.insert( QStringLiteral( "OVERLAY" ), QStringLiteral( "mask" ) );
+    clipParams.insert( QStringLiteral( "OUTPUT" ), QgsProcessing::TEMPORARY_OUTPUT );
+    std::unique_ptr< QgsProcessingAlgorithm > clip( QgsApplication::processingRegistry()->createAlgorithmById( QStringLiteral( "native:clip" ) ) );
+    bool ok = false;
+    const QVariantMap results = clip->run( clipParams, context, &feedback, &ok );
+    QVERIFY( ok );
+    QCOMPARE( countingAlg->processedFeatures, 3 );
+    QVERIFY( context.getMapLayer( results.value( QStringLiteral( "OUTPUT" ) ).toString() ) );
+    context.removeFeaturePipe( QStringLiteral( "counted" ) );
+  }
+
+  // translate -> translate -> clip
+  QgsProcessingModelAlgorithm model;
+  model.addModelParameter( new QgsProcessingParameterFeatureSource( QStringLiteral( "INPUT" ) ), QgsProcessingModelParameter( QStringLiteral( "INPUT" ) ) );
+  model.addModelParameter( new QgsProcessingParameterFeatureSource( QStringLiteral( "MASK" ) ), QgsProcessingModelParameter( QStringLiteral( "MASK" ) ) );
+
+  QgsProcessingModelChildAlgorithm move1;
+  move1.setChildId( QStringLiteral( "move1" ) );
+  move1.setAlgorithmId( QStringLiteral( "native:translate" ) );
+  move1.addParameterSources( QStringLiteral( "INPUT" ), QList< QgsProcessingModelChildParameterSource >() << QgsProcessingModelChildParameterSource::fromModelParameter( QStringLiteral( "INPUT" ) ) );
+  move1.addParameterSources( QStringLiteral( "DELTA_X" ), QList< QgsProcessingModelChildParameterSource >() << QgsProcessingModelChildParameterSource::fromStaticValue( 1 ) );
+  model.addChildAlgorithm( move1 );
+
+  QgsProcessingModelChildAlgorithm move2;
+  move2.setChildId( QStringLiteral( "move2" ) );
+  move2.setAlgorithmId( QStringLiteral( "native:translate" ) );
+  move2.addParameterSources( QStringLiteral( "INPUT" ), QList< QgsProcessingModelChildParameterSource >() << QgsProcessingModelChildParameterSource::fromChildOutput( QStringLiteral( "move1" ), QStringLiteral( "OUTPUT" ) ) );
+  move2.addParameterSources( QStringLiteral( "DELTA_Y" ), QList< QgsProcessingModelChildParameterSource >() << QgsProcessingModelChildParameterSource::fromStaticValue( 1 ) );
+  model.addChildAlgorithm( move2 );
+
+  QgsProcessingModelChildAlgorithm clip;
+  clip.setChildId( QStringLiteral( "clip" ) );
+  clip.setAlgorithmId( QStringLiteral( "native:clip" ) );
+  clip.addParameterSources( QStringLiteral( "INPUT" ), QList< QgsProcessingModelChildParameterSource >() << QgsProcessingModelChildParameterSource::fromChildOutput( QStringLiteral( "move2" ), QStringLiteral( "OUTPUT" ) ) );
+  clip.addParameterSources( QStringLiteral( "OVERLAY" ), QList< QgsProcessingModelChildParameterSource >() << QgsProcessingModelChildParameterSource::fromModelParameter( QStringLiteral( "MASK" ) ) );
+  QMap<QString, QgsProcessingModelOutput> clipOutputs;
+  QgsProcessingModelOutput clipOutput( QStringLiteral( "CLIPPED" ) );
+  clipOutput.setChildOutputName( QStringLiteral( "OUTPUT" ) );
+  clipOutputs.insert( QStringLiteral( "CLIPPED" ), clipOutput );
+  clip.setModelOutputs( clipOutputs );
+  model.addChildAlgorithm( clip );
+
+  QCOMPARE( model.streamedOutputConsumer( QStringLiteral( "move1" ) ), QStringLiteral( "move2" ) );
+  QCOMPARE( model.streamedOutputConsumer( QStringLiteral( "move2" ) ), QStringLiteral( "clip" ) );
+  // clip is not a feature based algorithm, and its output is a model output
+  QVERIFY( model.streamedOutputConsumer( QStringLiteral( "clip" ) ).isEmpty() );
+
+  QVariantMap params;
+  params.insert( QStringLiteral( "INPUT" ), QStringLiteral( "points" ) );
+  params.insert( QStringLiteral( "MASK" ), QStringLiteral( "mask" ) );
+  params.insert( QStringLiteral( "clip:CLIPPED" ), QgsProcessing::TEMPORARY_OUTPUT );
+
+  for ( bool stream : { false, true } )
+  {
+    QgsProcessingContext context;
+    context.setProject( &p );
+    if ( stream )
+      context.setFlags( QgsProcessingContext::StreamModelChildOutputs );
+    QgsProcessingFeedback feedback;
+    bool ok = false;
+    const QVariantMap results = model.run( params, context, &feedback, &ok );
+    QVERIFY( ok );
+
+    // intermediate outputs are only written without streaming, and streamed outputs aren't reported
+    const QVariantMap childResults = results.value( QStringLiteral( "CHILD_RESULTS" ) ).toMap();
+    QVERIFY( childResults.contains( QStringLiteral( "move1" ) ) );
+    QVERIFY( childResults.contains( QStringLiteral( "move2" ) ) );
+    QCOMPARE( childResults.value( QStringLiteral( "move1" ) ).toMap().contains( QStringLiteral( "OUTPUT" ) ), !stream );
+    QCOMPARE( childResults.value( QStringLiteral( "move2" ) ).toMap().contains( QStringLiteral( "OUTPUT" ) ), !stream );
+
+    QgsVectorLayer *clipped = qobject_cast< QgsVectorLayer * >( context.getMapLayer( results.value( QStringLiteral( "clip:CLIPPED" ) ).toString() ) );
+    QVERIFY( clipped );
+    QCOMPARE( clipped->featureCount(), 2L );
+    QgsFeatureIterator it = clipped->getFeatures( QgsFeatureRequest().addOrderBy( QStringLiteral( "id" ) ) );
+    QgsFeature f;
+    QVERIFY( it.nextFeature( f ) );
+    QCOMPARE( f.attribute( 0 ).toInt(), 1 );
+    QCOMPARE( f.geometry().asWkt(), QStringLiteral( "MultiPoint ((1 1))" ) );
+    QVERIFY( it.nextFeature( f ) );
+    QCOMPARE( f.attribute( 0 ).toInt(), 2 );
+    QCOMPARE( f.geometry().asWkt(), QStringLiteral( "MultiPoint ((2 2))" ) );
+  }
+
+  // outputs used by several child algorithms are not streamed
+  QgsProcessingModelChildAlgorithm move3;
+  move3.setChildId( QStringLiteral( "move3" ) );
+  move3.setAlgorithmId( QStringLiteral( "native:translate" ) );
+  move3.addParameterSources( QStringLiteral( "INPUT" ), QList< QgsProcessingModelChildParameterSource >() << QgsProcessingModelChildParameterSource::fromChildOutput( QStringLiteral( "move1" ), QStringLiteral( "OUTPUT" ) ) );
+  model.addChildAlgorithm( move3 );
+  QVERIFY( model.streamedOutputConsumer( QStringLiteral( "move1" ) ).isEmpty() );
+  QCOMPARE( model.streamedOutputConsumer( QStringLiteral( "move2" ) ), QStringLiteral( "clip" ) );
+  // ...and neither are outputs which are not used at all
+  QVERIFY( model.streamedOutputConsumer( QStringLiteral( "move3" ) ).isEmpty() );
+
+  // algorithms have to opt in to read streamed features
+  QgsProcessingModelChildAlgorithm centroids;
+  centroids.setChildId( QStringLiteral( "centroids" ) );
+  centroids.setAlgorithmId( QStringLiteral( "native:centroids" ) );
+  centroids.addParameterSources( QStringLiteral( "INPUT" ), QList< QgsProcessingModelChildParameterSource >() << QgsProcessingModelChildParameterSource::fromChildOutput( QStringLiteral( "move3" ), QStringLiteral( "OUTPUT" ) ) );
+  model.addChildAlgorithm( centroids );
+  QVERIFY( !( QgsApplication::processingRegistry()->algorithmById( QStringLiteral( "native:centroids" ) )->flags() & QgsProcessingAlgorithm::FlagSupportsStreamedInput ) );
+  QVERIFY( model.streamedOutputConsumer( QStringLiteral( "move3" ) ).isEmpty() );
+}
+
 void TestQgsProcessing::modelWithProviderWithLimitedTypes()
 {
   QgsApplication::processingRegistry()->addProvider( new DummyProvider4() );
@@ -36,6 +36,8 @@
 #include "qgsrasteranalysisutils.h"
 #include "qgsrasterfilewriter.h"
 #include "qgsreclassifyutils.h"
+#include "qgsspatialjoinengine.h"
+#include "qgsgeometryengine.h"
 #include "qgsalgorithmrasterlogicalop.h"
 #include "qgsprintlayout.h"
 #include "qgslayoutmanager.h"
@@ -95,6 +97,11 @@ class TestQgsProcessingAlgs: public QObject
     void polygonsToLines_data();
     void polygonsToLines();
 
+    void parallelFeatureProcessing();
+    void parallelDataDefinedProperties();
+    void parallelDissolve();
+    void spatialJoinEngine();
+
     void createConstantRaster_data();
     void createConstantRaster();
 
@@ -1318,6 +1325,244 @@ void TestQgsProcessingAlgs::polygonsToLines()
   QVERIFY2( result.geometry().equals( expectedGeometry ), QStringLiteral( "Result: %1, Expected: %2" ).arg( result.geometry().asWkt(), expectedGeometry.asWkt() ).toUtf8().constData() );
 }
 
+void TestQgsProcessingAlgs::parallelFeatureProcessing()
+{
+  std::unique_ptr< QgsProcessingFeatureBasedAlgorithm > alg( featureBasedAlg( "native:swapxy" ) );
+  QVERIFY( alg->flags() & QgsProcessingAlgorithm::FlagSupportsParallelFeatureProcessing );
+
+  std::unique_ptr<QgsVectorLayer> inputLayer( qgis::make_unique<QgsVectorLayer>( QStringLiteral( "Point?field=id:integer" ), QStringLiteral( "layer" ), QStringLiteral( "memory" ) ) );
+  QgsFeatureList features;
+  for ( int i = 0; i < 1000; ++i )
+  {
+    QgsFeature feature( inputLayer->fields() );
+    feature.setAttributes( QgsAttributes() << i );
+    feature.setGeometry( QgsGeometry::fromPointXY( QgsPointXY( i, -i ) ) );
+    features << feature;
+  }
+  inputLayer->dataProvider()->addFeatures( features );
+
+  QVariantMap parameters;
+  parameters.insert( QStringLiteral( "INPUT" ), QVariant::fromValue<QgsMapLayer *>( inputLayer.get() ) );
+  parameters.insert( QStringLiteral( "OUTPUT" ), QStringLiteral( "memory:" ) );
+
+  for ( bool ordered : { true, false } )
+  {
+    std::unique_ptr< QgsProcessingContext > context = qgis::make_unique< QgsProcessingContext >();
+    QgsProject p;
+    context->setProject( &p );
+    context->setMaximumThreads( 4 );
+    if ( !ordered )
+      context->setFlags( QgsProcessingContext::AllowUnorderedFeatures );
+    QgsProcessingFeedback feedback;
+
+    bool ok = false;
+    QVariantMap results = alg->run( parameters, *context, &feedback, &ok );
+    QVERIFY( ok );
+
+    QgsVectorLayer *outputLayer = qobject_cast< QgsVectorLayer * >( context->getMapLayer( results.value( QStringLiteral( "OUTPUT" ) ).toString() ) );
+    QVERIFY( outputLayer );
+    QCOMPARE( outputLayer->featureCount(), 1000L );
+
+    QList< int > ids;
+    QgsFeature f;
+    QgsFeatureIterator it = outputLayer->getFeatures();
+    while ( it.nextFeature( f ) )
+    {
+      const int id = f.attribute( 0 ).toInt();
+      QCOMPARE( f.geometry().asPoint(), QgsPointXY( -id, id ) );
+      ids << id;
+    }
+    if ( !ordered )
+      std::sort( ids.begin(), ids.end() );
+    for ( int i = 0; i < 1000; ++i )
+      QCOMPARE( ids.at( i ), i );
+  }
+}
+
+void TestQgsProcessingAlgs::parallelDataDefinedProperties()
+{
+  // the data defined number of vertices is evaluated by each thread with its own copy of the property
+  std::unique_ptr< QgsProcessingFeatureBasedAlgorithm > alg( featureBasedAlg( "native:densifygeometries" ) );
+  QVERIFY( alg->flags() & QgsProcessingAlgorithm::FlagSupportsParallelFeatureProcessing );
+
+  std::unique_ptr<QgsVectorLayer> inputLayer( qgis::make_unique<QgsVectorLayer>( QStringLiteral( "LineString?field=id:integer" ), QStringLiteral( "layer" ), QStringLiteral( "memory" ) ) );
+  QgsFeatureList features;
+  for ( int i = 0; i < 1000; ++i )
+  {
+    QgsFeature feature( inputLayer->fields() );
+    feature.setAttributes( QgsAttributes() << i );
+    feature.setGeometry( QgsGeometry::fromPolylineXY( QgsPolylineXY() << QgsPointXY( i, 0 ) << QgsPointXY( i, 10 ) ) );
+    features << feature;
+  }
+  inputLayer->dataProvider()->addFeatures( features );
+
+  QVariantMap parameters;
+  parameters.insert( QStringLiteral( "INPUT" ), QVariant::fromValue<QgsMapLayer *>( inputLayer.get() ) );
+  parameters.insert( QStringLiteral( "VERTICES" ), QgsProperty::fromExpression( QStringLiteral( "\"id\" % 3" ) ) );
+  parameters.insert( QStringLiteral( "OUTPUT" ), QStringLiteral( "memory:" ) );
+
+  std::unique_ptr< QgsProcessingContext > context = qgis::make_unique< QgsProcessingContext >();
+  QgsProject p;
+  context->setProject( &p );
+  context->setMaximumThreads( 4 );
+  QgsProcessingFeedback feedback;
+
+  bool ok = false;
+  QVariantMap results = alg->run( parameters, *context, &feedback, &ok );
+  QVERIFY( ok );
+
+  QgsVectorLayer *outputLayer = qobject_cast< QgsVectorLayer * >( context->getMapLayer( results.value( QStringLiteral( "OUTPUT" ) ).toString() ) );
+  QVERIFY( outputLayer );
+  QCOMPARE( outputLayer->featureCount(), 1000L );
+
+  QgsFeature f;
+  QgsFeatureIterator it = outputLayer->getFeatures();
+  while ( it.nextFeature( f ) )
+  {
+    const int id = f.attribute( 0 ).toInt();
+    QCOMPARE( f.geometry().constGet()->nCoordinates(), 2 + id % 3 );
+  }
+}
+
+void TestQgsProcessingAlgs::parallelDissolve()
+{
+  std::unique_ptr< QgsProcessingAlgorithm > alg( QgsApplication::processingRegistry()->createAlgorithmById( QStringLiteral( "native:dissolve" ) ) );
+  QVERIFY( alg != nullptr );
+
+  // a grid of adjacent squares, in two halves
+  std::unique_ptr<QgsVectorLayer> inputLayer( qgis::make_unique<QgsVectorLayer>( QStringLiteral( "Polygon?field=half:integer" ), QStringLiteral( "layer" ), QStringLiteral( "memory" ) ) );
+  QgsFeatureList features;
+  for ( int x = 0; x < 40; ++x )
+  {
+    for ( int y = 0; y < 40; ++y )
+    {
+      QgsFeature feature( inputLayer->fields() );
+      feature.setAttributes( QgsAttributes() << ( x < 20 ? 0 : 1 ) );
+      feature.setGeometry( QgsGeometry::fromRect( QgsRectangle( x, y, x + 1, y + 1 ) ) );
+      features << feature;
+    }
+  }
+  inputLayer->dataProvider()->addFeatures( features );
+
+  for ( bool byHalf : { false, true } )
+  {
+    QVariantMap parameters;
+    parameters.insert( QStringLiteral( "INPUT" ), QVariant::fromValue<QgsMapLayer *>( inputLayer.get() ) );
+    if ( byHalf )
+      parameters.insert( QStringLiteral( "FIELD" ), QStringLiteral( "half" ) );
+    parameters.insert( QStringLiteral( "OUTPUT" ), QStringLiteral( "memory:" ) );
+
+    std::unique_ptr< QgsProcessingContext > context = qgis::make_unique< QgsProcessingContext >();
+    QgsProject p;
+    context->setProject( &p );
+    context->setMaximumThreads( 4 );
+    QgsProcessingFeedback feedback;
+
+    bool ok = false;
+    QVariantMap results = alg->run( parameters, *context, &feedback, &ok );
+    QVERIFY( ok );
+
+    QgsVectorLayer *outputLayer = qobject_cast< QgsVectorLayer * >( context->getMapLayer( results.value( QStringLiteral( "OUTPUT" ) ).toString() ) );
+    QVERIFY( outputLayer );
+    QCOMPARE( outputLayer->featureCount(), byHalf ? 2L : 1L );
+
+    QgsFeature f;
+    QgsFeatureIterator it = outputLayer->getFeatures();
+    while ( it.nextFeature( f ) )
+    {
+      QCOMPARE( f.geometry().constGet()->partCount(), 1 );
+      QGSCOMPARENEAR( f.geometry().area(), byHalf ? 800 : 1600, 0.000001 );
+      if ( byHalf )
+      {
+        const double xMinimum = f.attribute( 0 ).toInt() == 0 ? 0 : 20;
+        QCOMPARE( f.geometry().boundingBox(), QgsRectangle( xMinimum, 0, xMinimum + 20, 40 ) );
+      }
+    }
+  }
+}
+
+void TestQgsProcessingAlgs::spatialJoinEngine()
+{
+  // a grid of unit squares, and a large square overlapping many cells of the partitions
+  std::unique_ptr<QgsVectorLayer> squares( qgis::make_unique<QgsVectorLayer>( QStringLiteral( "Polygon?field=id:integer" ), QStringLiteral( "squares" ), QStringLiteral( "memory" ) ) );
+  QgsFeatureList features;
+  for ( int x = 0; x < 30; ++x )
+  {
+    for ( int y = 0; y < 30; ++y )
+    {
+      QgsFeature feature( squares->fields() );
+      feature.setAttributes( QgsAttributes() << x * 30 + y );
+      feature.setGeometry( QgsGeometry::fromRect( QgsRectangle( x, y, x + 1, y + 1 ) ) );
+      features << feature;
+    }
+  }
+  QgsFeature large( squares->fields() );
+  large.setAttributes( QgsAttributes() << 900 );
+  large.setGeometry( QgsGeometry::fromRect( QgsRectangle( 5, 5, 25, 25 ) ) );
+  features << large;
+  squares->dataProvider()->addFeatures( features );
+
+  QgsProcessingContext context;
+  context.setMaximumThreads( 4 );
+  QgsProcessingFeedback feedback;
+  QgsSpatialJoinEngine joinEngine( *squares->dataProvider(), QgsFeatureRequest(), context, &feedback );
+  QCOMPARE( joinEngine.featureCount(), 901 );
+  QCOMPARE( joinEngine.extent(), QgsRectangle( 0, 0, 30, 30 ) );
+
+  // candidates are fetched with their attributes, in the order of their ids
+  const QgsFeatureList candidates = joinEngine.candidates( QgsRectangle( 9.5, 9.5, 20.5, 20.5 ) );
+  QCOMPARE( candidates.size(), 12 * 12 + 1 );
+  for ( int i = 1; i < candidates.size(); ++i )
+    QVERIFY( candidates.at( i - 1 ).attribute( 0 ).toInt() < candidates.at( i ).attribute( 0 ).toInt() );
+  QCOMPARE( candidates.last().attribute( 0 ).toInt(), 900 );
+  QVERIFY( candidates.last().hasGeometry() );
+  QVERIFY( joinEngine.candidates( QgsRectangle( 40, 40, 50, 50 ) ).isEmpty() );
+
+  // points matched against the squares containing them, with results in the order of the points.
+  // They are read in several chunks, which reuse the squares fetched for the previous ones
+  std::unique_ptr<QgsVectorLayer> points( qgis::make_unique<QgsVectorLayer>( QStringLiteral( "Point?field=id:integer" ), QStringLiteral( "points" ), QStringLiteral( "memory" ) ) );
+  features.clear();
+  for ( int i = 0; i < 3000; ++i )
+  {
+    QgsFeature feature( points->fields() );
+    feature.setAttributes( QgsAttributes() << i );
+    feature.setGeometry( QgsGeometry::fromPointXY( QgsPointXY( 0.5 + ( i % 30 ), 0.5 + ( i / 30 ) % 30 ) ) );
+    features << feature;
+  }
+  points->dataProvider()->addFeatures( features );
+
+  QgsFeatureIterator it = points->getFeatures();
+  int next = 0;
+  joinEngine.run( it, []( QgsGeometryEngine * engine, const QgsFeature & square )
+  {
+    return engine->within( square.geometry().constGet() );
+  },
+  []( const QgsFeature & point, const QVector< const QgsFeature * > &squares, QgsGeometryEngine *, QgsProcessingFeedback * ) -> QgsFeatureList
+  {
+    QgsFeatureList results;
+    for ( const QgsFeature *square : squares )
+    {
+      QgsFeature result( point );
+      result.setAttributes( QgsAttributes() << point.attribute( 0 ) << square->attribute( 0 ) );
+      results << result;
+    }
+    return results;
+  },
+  [ &next ]( const QgsFeature & point, QgsFeatureList & results )
+  {
+    const int id = point.attribute( 0 ).toInt();
+    QCOMPARE( id, next++ );
+    const int x = id % 30;
+    const int y = ( id / 30 ) % 30;
+    const bool inLarge = x >= 5 && x < 25 && y >= 5 && y < 25;
+    QCOMPARE( results.size(), inLarge ? 2 : 1 );
+    QCOMPARE( results.at( 0 ).attribute( 1 ).toInt(), x * 30 + y );
+    if ( inLarge )
+      QCOMPARE( results.at( 1 ).attribute( 1 ).toInt(), 900 );
+  } );
+  QCOMPARE( next, 3000 );
+}
+
 Q_DECLARE_METATYPE( Qgis::DataType )
 void TestQgsProcessingAlgs::createConstantRaster_data()
 {
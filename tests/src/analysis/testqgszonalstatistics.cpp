@@ -21,6 +21,7 @@
 #include "qgsvectorlayer.h"
 #include "qgsrasterlayer.h"
 #include "qgszonalstatistics.h"
+#include "qgszonalrasterengine.h"
 #include "qgsproject.h"
 #include "qgsvectorlayerutils.h"
 
@@ -42,6 +43,7 @@ class TestQgsZonalStatistics : public QObject
     void testReprojection();
     void testNoData();
     void testSmallPolygons();
+    void testCoverage();
     void testShortName();
 
   private:
@@ -344,6 +346,50 @@ void TestQgsZonalStatistics::testSmallPolygons()
   QGSCOMPARENEAR( f.attribute( "nmean" ).toDouble(), 864.285638, 0.001 );
 }
 
+void TestQgsZonalStatistics::testCoverage()
+{
+  const QgsRectangle extent = mRasterLayer->extent();
+  const double cellSize = mRasterLayer->rasterUnitsPerPixelX();
+  const QgsZonalRasterEngine engine( mRasterLayer->dataProvider(), 1, cellSize, cellSize );
+
+  // zone covering the two top rows, from the middle of the first column to the middle of the third one
+  const QgsGeometry zone = QgsGeometry::fromRect( QgsRectangle( extent.xMinimum() + 0.5 * cellSize, extent.yMaximum() - 2 * cellSize,
+                           extent.xMinimum() + 2.5 * cellSize, extent.yMaximum() ) );
+  QList< double > values;
+  QList< double > coverages;
+  QList< bool > centers;
+  engine.visitCells( zone, [&values, &coverages, &centers]( double value, double coverage, bool centerInside )
+  {
+    values << value;
+    coverages << coverage;
+    centers << centerInside;
+  } );
+  QCOMPARE( values, QList< double >() << 1 << 1 << 0 << 1 << 1 << 0 );
+  QCOMPARE( coverages.size(), 6 );
+  for ( int i = 0; i < coverages.size(); ++i )
+    QGSCOMPARENEAR( coverages.at( i ), i % 3 == 1 ? 1.0 : 0.5, 0.000001 );
+  // centers lying on the boundary of the zone are outside of it
+  QCOMPARE( centers, QList< bool >() << false << true << false << false << true << false );
+
+  QMap<QgsZonalStatistics::Statistic, QVariant> results = engine.statistics( zone, QgsZonalStatistics::Count | QgsZonalStatistics::Sum );
+  QCOMPARE( results.value( QgsZonalStatistics::Count ).toDouble(), 2.0 );
+  QCOMPARE( results.value( QgsZonalStatistics::Sum ).toDouble(), 2.0 );
+
+  // a triangle covering an eighth of the bottom right cell falls back to the coverage of the cells
+  QgsPolylineXY ring;
+  ring << QgsPointXY( extent.xMaximum() - 0.5 * cellSize, extent.yMinimum() )
+       << QgsPointXY( extent.xMaximum(), extent.yMinimum() )
+       << QgsPointXY( extent.xMaximum(), extent.yMinimum() + 0.5 * cellSize )
+       << QgsPointXY( extent.xMaximum() - 0.5 * cellSize, extent.yMinimum() );
+  results = engine.statistics( QgsGeometry::fromPolygonXY( QgsPolygonXY() << ring ), QgsZonalStatistics::Count | QgsZonalStatistics::Sum );
+  QGSCOMPARENEAR( results.value( QgsZonalStatistics::Count ).toDouble(), 0.125, 0.000001 );
+  QGSCOMPARENEAR( results.value( QgsZonalStatistics::Sum ).toDouble(), 0.125, 0.000001 );
+
+  QHash< double, qgssize > histogram = engine.histogram( zone );
+  QCOMPARE( histogram.value( 1 ), static_cast< qgssize >( 2 ) );
+  QVERIFY( !histogram.contains( 0 ) );
+}
+
 void TestQgsZonalStatistics::testShortName()
 {
   QCOMPARE( QgsZonalStatistics::shortName( QgsZonalStatistics::Count ), QStringLiteral( "count" ) );
@@ -34,6 +34,9 @@ class TestQgsClipper: public QObject
     void init() {} // will be called before each testfunction is executed.
     void cleanup() {} // will be called after every testfunction.
     void basic();
+    void trimPolygonUnchanged();
+    void trimPolygon();
+    void trimPolygonBenchmark();
   private:
     bool checkBoundingBox( const QPolygonF &polygon, const QgsRectangle &clipRect );
 };
@@ -78,6 +81,91 @@ void TestQgsClipper::basic()
   QVERIFY( ! checkBoundingBox( polygon, clipRectInner ) );
 }
 
+void TestQgsClipper::trimPolygonUnchanged()
+{
+  // polygon which does not cross any boundary
+  QPolygonF polygon;
+  polygon << QPointF( 1, 1 ) << QPointF( 9, 1 ) << QPointF( 9, 9 ) << QPointF( 1, 9 ) << QPointF( 1, 1 );
+  const QPolygonF original = polygon;
+  QgsClipper::trimPolygon( polygon, QgsRectangle( 0, 0, 10, 10 ) );
+  QCOMPARE( polygon, original );
+
+  // odd number of points
+  polygon.clear();
+  polygon << QPointF( 1, 1 ) << QPointF( 9, 1 ) << QPointF( 5, 9 );
+  const QPolygonF triangle = polygon;
+  QgsClipper::trimPolygon( polygon, QgsRectangle( 0, 0, 10, 10 ) );
+  QCOMPARE( polygon, triangle );
+
+  polygon.clear();
+  QgsClipper::trimPolygon( polygon, QgsRectangle( 0, 0, 10, 10 ) );
+  QVERIFY( polygon.isEmpty() );
+}
+
+void TestQgsClipper::trimPolygon()
+{
+  // crosses the x and y maximum boundaries only
+  QPolygonF polygon;
+  polygon << QPointF( 1.0, 9.0 ) << QPointF( 11.0, 11.0 ) << QPointF( 9.0, 1.0 );
+  QgsClipper::trimPolygon( polygon, QgsRectangle( 0, 0, 10, 10 ) );
+
+  QCOMPARE( polygon.size(), 5 );
+  const QPolygonF expected = QPolygonF() << QPointF( 1, 9 ) << QPointF( 6, 10 ) << QPointF( 10, 10 ) << QPointF( 10, 6 ) << QPointF( 9, 1 );
+  for ( int i = 0; i < expected.size(); ++i )
+  {
+    QGSCOMPARENEAR( polygon.at( i ).x(), expected.at( i ).x(), 1e-9 );
+    QGSCOMPARENEAR( polygon.at( i ).y(), expected.at( i ).y(), 1e-9 );
+  }
+
+  // crosses all the boundaries
+  polygon.clear();
+  polygon << QPointF( -2, 5 ) << QPointF( 5, 12 ) << QPointF( 12, 5 ) << QPointF( 5, -2 ) << QPointF( -2, 5 );
+  QgsClipper::trimPolygon( polygon, QgsRectangle( 0, 0, 10, 10 ) );
+  QCOMPARE( polygon.size(), 8 );
+  const QPolygonF octagon = QPolygonF() << QPointF( 0, 7 ) << QPointF( 3, 10 ) << QPointF( 7, 10 ) << QPointF( 10, 7 )
+                            << QPointF( 10, 3 ) << QPointF( 7, 0 ) << QPointF( 3, 0 ) << QPointF( 0, 3 );
+  for ( int i = 0; i < octagon.size(); ++i )
+  {
+    QGSCOMPARENEAR( polygon.at( i ).x(), octagon.at( i ).x(), 1e-9 );
+    QGSCOMPARENEAR( polygon.at( i ).y(), octagon.at( i ).y(), 1e-9 );
+  }
+
+  // completely outside
+  polygon.clear();
+  polygon << QPointF( 20, 20 ) << QPointF( 30, 20 ) << QPointF( 30, 30 );
+  QgsClipper::trimPolygon( polygon, QgsRectangle( 0, 0, 10, 10 ) );
+  QVERIFY( polygon.isEmpty() );
+}
+
+void TestQgsClipper::trimPolygonBenchmark()
+{
+  // a grid of rings around the clip rectangle, most of which are inside or cross a single boundary
+  QVector< QPolygonF > rings;
+  for ( int i = 0; i < 100; ++i )
+  {
+    for ( int j = 0; j < 100; ++j )
+    {
+      QPolygonF ring;
+      for ( int k = 0; k < 100; ++k )
+      {
+        const double angle = 2 * M_PI * k / 100;
+        ring << QPointF( i * 10 + 8 * std::cos( angle ), j * 10 + 8 * std::sin( angle ) );
+      }
+      rings << ring;
+    }
+  }
+  const QgsRectangle clipRect( 45, 45, 955, 955 );
+
+  QBENCHMARK
+  {
+    for ( const QPolygonF &ring : qgis::as_const( rings ) )
+    {
+      QPolygonF trimmed = ring;
+      QgsClipper::trimPolygon( trimmed, clipRect );
+    }
+  }
+}
+
 bool TestQgsClipper::checkBoundingBox( const QPolygonF &polygon, const QgsRectangle &clipRect )
 {
   QgsRectangle bBox( polygon.boundingRect() );
@@ -444,6 +444,7 @@ void TestQgsCoordinateTransform::transformLKS()
 
   QPolygonF sPoly = QgsGeometry::fromWkt( QStringLiteral( "Polygon (( 725865.850 198519.947, 363511.181 263208.769, 717694.697 333650.333, 725865.850 198519.947 ))" ) ).asQPolygonF();
 
+  QPolygonF bufferedPoly = sPoly;
   Lks2Balt.transformPolygon( sPoly, QgsCoordinateTransform::ForwardTransform );
 
   QGSCOMPARENEAR( sPoly.at( 0 ).x(), 725865.850, 0.001 );
@@ -452,6 +453,13 @@ void TestQgsCoordinateTransform::transformLKS()
   QGSCOMPARENEAR( sPoly.at( 1 ).y(), 6263208.769, 0.001 );
   QGSCOMPARENEAR( sPoly.at( 2 ).x(), 717694.697, 0.001 );
   QGSCOMPARENEAR( sPoly.at( 2 ).y(), 6333650.333, 0.001 );
+
+  // with caller provided buffers
+  double x[4];
+  double y[4];
+  double z[4];
+  Lks2Balt.transformPolygon( bufferedPoly, x, y, z );
+  QCOMPARE( bufferedPoly, sPoly );
 }
 
 void TestQgsCoordinateTransform::transformContextNormalize()
@@ -21,6 +21,7 @@
 //header for class being tested
 #include "qgsexpression.h"
 #include "qgsfeature.h"
+#include "qgsfeaturebatch.h"
 #include "qgsfeatureiterator.h"
 #include "qgsfeaturerequest.h"
 #include "qgsgeometry.h"
@@ -4014,6 +4015,94 @@ class TestQgsExpression: public QObject
       QCOMPARE( res.toString(), QStringLiteral( "test" ) );
     }
 
+    void bytecode_data()
+    {
+      QTest::addColumn<QString>( "string" );
+      QTest::addColumn<bool>( "compiled" );
+      QTest::addColumn<QVariant>( "result" );
+
+      QTest::newRow( "int field" ) << "int" << true << QVariant( 5 );
+      QTest::newRow( "null field" ) << "nullint" << true << QVariant( QVariant::Int );
+      QTest::newRow( "int arithmetic" ) << "int * 2 + 1" << true << QVariant( 11LL );
+      QTest::newRow( "int division" ) << "int / 2" << true << QVariant( 2.5 );
+      QTest::newRow( "int division by zero" ) << "int / 0" << true << QVariant();
+      QTest::newRow( "int modulo by zero" ) << "int % 0" << true << QVariant();
+      QTest::newRow( "integer division" ) << "dbl // 2" << true << QVariant( 1LL );
+      QTest::newRow( "double arithmetic" ) << "dbl * 2 - int" << true << QVariant( 0.0 );
+      QTest::newRow( "power" ) << "int ^ 2" << true << QVariant( 25.0 );
+      QTest::newRow( "null arithmetic" ) << "nullint + 1" << true << QVariant();
+      QTest::newRow( "negate" ) << "-int" << true << QVariant( -5LL );
+      QTest::newRow( "comparison" ) << "int > 4" << true << QVariant( 1 );
+      QTest::newRow( "comparison mixed" ) << "int = 5.0" << true << QVariant( 1 );
+      QTest::newRow( "comparison null" ) << "nullint = 1" << true << QVariant();
+      QTest::newRow( "string comparison" ) << "name < 'b'" << true << QVariant( 1 );
+      QTest::newRow( "is null" ) << "nullint is null" << true << QVariant( 1 );
+      QTest::newRow( "is not" ) << "int is not 5" << true << QVariant( 0 );
+      QTest::newRow( "and" ) << "int > 1 and nullint = 1" << true << QVariant();
+      QTest::newRow( "or" ) << "int > 1 or nullint = 1" << true << QVariant( 1 );
+      QTest::newRow( "not" ) << "not int = 5" << true << QVariant( 0 );
+      QTest::newRow( "string plus" ) << "name + 'x'" << true << QVariant( "abcx" );
+      QTest::newRow( "concat operator" ) << "name || int" << true << QVariant( "abc5" );
+      QTest::newRow( "concat operator null" ) << "name || nullint" << true << QVariant();
+      QTest::newRow( "upper" ) << "upper(name)" << true << QVariant( "ABC" );
+      QTest::newRow( "length" ) << "length(trim(padded))" << true << QVariant( 3 );
+      QTest::newRow( "abs" ) << "abs(-int)" << true << QVariant( 5.0 );
+      QTest::newRow( "sqrt" ) << "sqrt(abs(int) - 1)" << true << QVariant( 2.0 );
+      QTest::newRow( "floor" ) << "floor(dbl)" << true << QVariant( 2.0 );
+      QTest::newRow( "concat" ) << "concat(name, nullint, int)" << true << QVariant( "abc5" );
+      QTest::newRow( "coalesce" ) << "coalesce(nullint, int)" << true << QVariant( 5 );
+      QTest::newRow( "constant folding" ) << "1 + 2 * 3 + int" << true << QVariant( 12LL );
+      QTest::newRow( "string to number fallback" ) << "'5' + int" << true << QVariant( 10LL );
+      QTest::newRow( "date fallback" ) << "day(dt) + int" << false << QVariant( 12LL );
+      QTest::newRow( "like" ) << "name like 'a%'" << false << QVariant( 1 );
+      QTest::newRow( "case" ) << "case when int > 1 then 'yes' end" << false << QVariant( "yes" );
+    }
+
+    void bytecode()
+    {
+      QFETCH( QString, string );
+      QFETCH( bool, compiled );
+      QFETCH( QVariant, result );
+
+      QgsFields fields;
+      fields.append( QgsField( QStringLiteral( "int" ), QVariant::Int ) );
+      fields.append( QgsField( QStringLiteral( "nullint" ), QVariant::Int ) );
+      fields.append( QgsField( QStringLiteral( "dbl" ), QVariant::Double ) );
+      fields.append( QgsField( QStringLiteral( "name" ), QVariant::String ) );
+      fields.append( QgsField( QStringLiteral( "padded" ), QVariant::String ) );
+      fields.append( QgsField( QStringLiteral( "dt" ), QVariant::Date ) );
+
+      QgsFeature f( fields );
+      f.setAttributes( QgsAttributes() << 5 << QVariant( QVariant::Int ) << 2.5 << QStringLiteral( "abc" ) << QStringLiteral( "  xyz " ) << QDate( 2020, 4, 7 ) );
+
+      QgsExpressionContext context = QgsExpressionContextUtils::createFeatureBasedContext( f, fields );
+      QgsExpression exp( string );
+      QVERIFY( exp.prepare( &context ) );
+      QCOMPARE( exp.hasBytecode(), compiled );
+
+      const QVariant res = exp.evaluate( &context );
+      QVERIFY( !exp.hasEvalError() );
+      QCOMPARE( res.type(), result.type() );
+      QCOMPARE( res, result );
+
+      // batch evaluation must match feature by feature evaluation
+      QgsFeatureBatch batch( fields );
+      batch.addFeature( f );
+      QgsFeature f2( fields );
+      f2.setAttributes( QgsAttributes() << -3 << 7 << 0.0 << QStringLiteral( "bcd" ) << QVariant( QVariant::String ) << QVariant( QVariant::Date ) );
+      batch.addFeature( f2 );
+
+      const QVector< QVariant > results = exp.evaluate( batch, &context );
+      QCOMPARE( results.size(), 2 );
+      QCOMPARE( results.at( 0 ).type(), result.type() );
+      QCOMPARE( results.at( 0 ), result );
+
+      context.setFeature( f2 );
+      const QVariant res2 = exp.evaluate( &context );
+      QCOMPARE( results.at( 1 ).type(), res2.type() );
+      QCOMPARE( results.at( 1 ), res2 );
+    }
+
 };
 
 QGSTEST_MAIN( TestQgsExpression )
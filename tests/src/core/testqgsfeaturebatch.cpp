@@ -0,0 +1,378 @@
+/***************************************************************************
+     testqgsfeaturebatch.cpp
+     -----------------------
+    Date                 : October 2026
+    Copyright            : (C) 2026 by QGIS contributors
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#include "qgstest.h"
+#include <QObject>
+#include <QString>
+
+#include "qgsapplication.h"
+#include "qgsfeature.h"
+#include "qgsfeaturebatch.h"
+#include "qgsfeatureiterator.h"
+#include "qgsgeometry.h"
+#include "qgsogrfeatureiterator.h"
+#include "qgsvectorlayer.h"
+#include "qgsvectordataprovider.h"
+
+#include <gdal.h>
+
+class TestQgsFeatureBatch: public QObject
+{
+    Q_OBJECT
+
+  private slots:
+    void initTestCase();// will be called before the first testfunction is executed.
+    void cleanupTestCase();// will be called after the last testfunction was executed.
+    void columns();
+    void strings();
+    void geometryFromWkb_data();
+    void geometryFromWkb();
+    void ewkb();
+    void curvedGeometry();
+    void clear();
+    void memoryLayerBatches();
+    void ogrLayerBatches();
+
+  private:
+    QgsFields mFields;
+};
+
+void TestQgsFeatureBatch::initTestCase()
+{
+  QgsApplication::init();
+  QgsApplication::initQgis();
+
+  mFields.append( QgsField( QStringLiteral( "int" ), QVariant::Int ) );
+  mFields.append( QgsField( QStringLiteral( "double" ), QVariant::Double ) );
+  mFields.append( QgsField( QStringLiteral( "string" ), QVariant::String ) );
+  mFields.append( QgsField( QStringLiteral( "date" ), QVariant::Date ) );
+}
+
+void TestQgsFeatureBatch::cleanupTestCase()
+{
+  QgsApplication::exitQgis();
+}
+
+void TestQgsFeatureBatch::columns()
+{
+  QgsFeatureBatch batch( mFields );
+  QCOMPARE( batch.columnCount(), 4 );
+  QCOMPARE( batch.columnType( 0 ), QgsFeatureBatch::Int64Column );
+  QCOMPARE( batch.columnType( 1 ), QgsFeatureBatch::DoubleColumn );
+  QCOMPARE( batch.columnType( 2 ), QgsFeatureBatch::StringColumn );
+  QCOMPARE( batch.columnType( 3 ), QgsFeatureBatch::VariantColumn );
+
+  QCOMPARE( batch.addFeature( 5 ), 0 );
+  batch.setInt64( 0, 11 );
+  batch.setDouble( 1, 2.5 );
+  batch.setValue( 3, QDate( 2020, 5, 6 ) );
+  QCOMPARE( batch.addFeature( 7 ), 1 );
+  batch.setValue( 0, QStringLiteral( "12" ) );
+
+  QCOMPARE( batch.size(), 2 );
+  QCOMPARE( batch.id( 0 ), 5LL );
+  QCOMPARE( batch.id( 1 ), 7LL );
+  QVERIFY( !batch.isNull( 0, 0 ) );
+  QCOMPARE( batch.int64Data( 0 )[0], 11LL );
+  QCOMPARE( batch.int64Data( 0 )[1], 12LL );
+  QCOMPARE( batch.doubleData( 1 )[0], 2.5 );
+  QVERIFY( batch.isNull( 1, 1 ) );
+  QVERIFY( batch.isNull( 2, 0 ) );
+  QCOMPARE( batch.value( 3, 0 ), QVariant( QDate( 2020, 5, 6 ) ) );
+  QVERIFY( batch.value( 3, 1 ).isNull() );
+  QCOMPARE( batch.geometryType( 0 ), QgsWkbTypes::NoGeometry );
+
+  // subset of attributes
+  QgsFeatureBatch subset( mFields, QgsAttributeList() << 2 << 0 );
+  QCOMPARE( subset.columnCount(), 2 );
+  QCOMPARE( subset.attributeIndex( 0 ), 2 );
+  QCOMPARE( subset.columnForAttribute( 0 ), 1 );
+  QCOMPARE( subset.columnForAttribute( 1 ), -1 );
+
+  QgsFeature f( mFields, 3 );
+  f.setAttributes( QgsAttributes() << 1 << 2.0 << QStringLiteral( "a" ) << QVariant() );
+  subset.addFeature( f );
+  const QgsFeature out = subset.feature( 0 );
+  QCOMPARE( out.id(), 3LL );
+  QCOMPARE( out.attribute( 0 ), QVariant( 1 ) );
+  QVERIFY( out.attribute( 1 ).isNull() );
+  QCOMPARE( out.attribute( 2 ), QVariant( QStringLiteral( "a" ) ) );
+}
+
+void TestQgsFeatureBatch::strings()
+{
+  QgsFeatureBatch batch( mFields, QgsAttributeList() << 2 );
+  batch.addFeature( 1 );
+  batch.setString( 0, QStringLiteral( "Ärger" ) );
+  batch.addFeature( 2 );
+  batch.addFeature( 3 );
+  const QByteArray raw( "raw bytes" );
+  batch.setString( 0, raw.constData(), 3 );
+
+  int length = 0;
+  const char *data = batch.stringView( 0, 0, length );
+  QCOMPARE( QString::fromUtf8( data, length ), QStringLiteral( "Ärger" ) );
+  QVERIFY( batch.isNull( 0, 1 ) );
+  data = batch.stringView( 0, 1, length );
+  QCOMPARE( length, 0 );
+  QCOMPARE( batch.value( 0, 2 ), QVariant( QStringLiteral( "raw" ) ) );
+}
+
+void TestQgsFeatureBatch::geometryFromWkb_data()
+{
+  QTest::addColumn<QString>( "wkt" );
+  QTest::addColumn<int>( "parts" );
+  QTest::addColumn<int>( "vertices" );
+
+  QTest::newRow( "point" ) << QStringLiteral( "Point (1 2)" ) << 1 << 1;
+  QTest::newRow( "point zm" ) << QStringLiteral( "PointZM (1 2 3 4)" ) << 1 << 1;
+  QTest::newRow( "linestring" ) << QStringLiteral( "LineString (1 2, 3 4, 5 6)" ) << 1 << 3;
+  QTest::newRow( "linestring z" ) << QStringLiteral( "LineStringZ (1 2 3, 3 4 5)" ) << 1 << 2;
+  QTest::newRow( "polygon" ) << QStringLiteral( "Polygon ((0 0, 10 0, 10 10, 0 0),(1 1, 2 1, 2 2, 1 1))" ) << 1 << 8;
+  QTest::newRow( "multipoint" ) << QStringLiteral( "MultiPoint ((1 2),(3 4))" ) << 2 << 2;
+  QTest::newRow( "multilinestring m" ) << QStringLiteral( "MultiLineStringM ((1 2 3, 4 5 6),(7 8 9, 10 11 12))" ) << 2 << 4;
+  QTest::newRow( "multipolygon" ) << QStringLiteral( "MultiPolygon (((0 0, 1 0, 1 1, 0 0)),((5 5, 6 5, 6 6, 5 5)))" ) << 2 << 8;
+  QTest::newRow( "collection" ) << QStringLiteral( "GeometryCollection (Point (1 2),LineString (3 4, 5 6))" ) << 2 << 3;
+}
+
+void TestQgsFeatureBatch::geometryFromWkb()
+{
+  QFETCH( QString, wkt );
+  QFETCH( int, parts );
+  QFETCH( int, vertices );
+
+  const QgsGeometry geometry = QgsGeometry::fromWkt( wkt );
+  const QByteArray wkb = geometry.asWkb();
+
+  QgsFeatureBatch batch;
+  batch.addFeature( 1 );
+  QVERIFY( batch.setGeometryFromWkb( reinterpret_cast< const unsigned char * >( wkb.constData() ), wkb.size() ) );
+  QCOMPARE( batch.geometryType( 0 ), geometry.wkbType() );
+  QCOMPARE( batch.partOffsets().at( 1 ) - batch.partOffsets().at( 0 ), parts );
+  QCOMPARE( batch.vertexCount(), vertices );
+  QCOMPARE( batch.geometry( 0 ).asWkt(), geometry.asWkt() );
+
+  // truncated blobs must be rejected and leave the row without geometry
+  batch.addFeature( 2 );
+  QVERIFY( !batch.setGeometryFromWkb( reinterpret_cast< const unsigned char * >( wkb.constData() ), wkb.size() - 4 ) );
+  QCOMPARE( batch.geometryType( 1 ), QgsWkbTypes::NoGeometry );
+  QVERIFY( batch.geometry( 1 ).isNull() );
+  QCOMPARE( batch.vertexCount(), vertices );
+}
+
+void TestQgsFeatureBatch::ewkb()
+{
+  // PostGIS EWKB: Point with Z flag and SRID 4326, big endian
+  const QByteArray ewkb = QByteArray::fromHex( "00a0000001000010e63ff000000000000040000000000000004008000000000000" );
+  QgsFeatureBatch batch;
+  batch.addFeature( 1 );
+  QVERIFY( batch.setGeometryFromWkb( reinterpret_cast< const unsigned char * >( ewkb.constData() ), ewkb.size() ) );
+  QCOMPARE( batch.geometryType( 0 ), QgsWkbTypes::PointZ );
+  QCOMPARE( batch.geometry( 0 ).asWkt(), QStringLiteral( "PointZ (1 2 3)" ) );
+
+  // forcing multi type
+  const QByteArray wkb = QgsGeometry::fromWkt( QStringLiteral( "Polygon ((0 0, 1 0, 1 1, 0 0))" ) ).asWkb();
+  batch.addFeature( 2 );
+  QVERIFY( batch.setGeometryFromWkb( reinterpret_cast< const unsigned char * >( wkb.constData() ), wkb.size(), true ) );
+  QCOMPARE( batch.geometryType( 1 ), QgsWkbTypes::MultiPolygon );
+  QCOMPARE( batch.geometry( 1 ).asWkt(), QStringLiteral( "MultiPolygon (((0 0, 1 0, 1 1, 0 0)))" ) );
+}
+
+void TestQgsFeatureBatch::curvedGeometry()
+{
+  const QgsGeometry geometry = QgsGeometry::fromWkt( QStringLiteral( "CircularString (0 0, 1 1, 2 0)" ) );
+  const QByteArray wkb = geometry.asWkb();
+
+  QgsFeatureBatch batch;
+  batch.addFeature( 1 );
+  QVERIFY( batch.setGeometryFromWkb( reinterpret_cast< const unsigned char * >( wkb.constData() ), wkb.size() ) );
+  QCOMPARE( batch.geometryType( 0 ), QgsWkbTypes::LineString );
+  QVERIFY( batch.vertexCount() > 3 );
+  QCOMPARE( batch.geometry( 0 ).vertexAt( 0 ), QgsPoint( 0, 0 ) );
+}
+
+void TestQgsFeatureBatch::clear()
+{
+  QgsFeatureBatch batch( mFields );
+  batch.addFeature( 1 );
+  batch.setString( 2, QStringLiteral( "a" ) );
+  batch.setGeometry( QgsGeometry::fromWkt( QStringLiteral( "LineString (1 2, 3 4)" ) ).constGet() );
+  batch.clear();
+
+  QVERIFY( batch.isEmpty() );
+  QCOMPARE( batch.columnCount(), 4 );
+  QCOMPARE( batch.vertexCount(), 0 );
+  QCOMPARE( batch.partOffsets().size(), 1 );
+
+  batch.addFeature( 2 );
+  batch.setString( 2, QStringLiteral( "b" ) );
+  QCOMPARE( batch.value( 2, 0 ), QVariant( QStringLiteral( "b" ) ) );
+  QCOMPARE( batch.geometryType( 0 ), QgsWkbTypes::NoGeometry );
+}
+
+void TestQgsFeatureBatch::memoryLayerBatches()
+{
+  QgsVectorLayer layer( QStringLiteral( "LineString?crs=epsg:4326&field=int:integer&field=name:string(20)&field=value:double" ), QStringLiteral( "l" ), QStringLiteral( "memory" ) );
+  QVERIFY( layer.isValid() );
+
+  QgsFeatureList features;
+  for ( int i = 0; i < 25; ++i )
+  {
+    QgsFeature f( layer.fields() );
+    f.setAttributes( QgsAttributes() << i << QStringLiteral( "name %1" ).arg( i ) << ( i % 3 ? QVariant( i / 2.0 ) : QVariant( QVariant::Double ) ) );
+    f.setGeometry( QgsGeometry::fromWkt( QStringLiteral( "LineString (%1 0, %1 1)" ).arg( i ) ) );
+    features << f;
+  }
+  QVERIFY( layer.dataProvider()->addFeatures( features ) );
+
+  const QList< QgsFeatureRequest > requests = QList< QgsFeatureRequest >()
+      << QgsFeatureRequest()
+      << QgsFeatureRequest().setSubsetOfAttributes( QgsAttributeList() << 1 )
+      << QgsFeatureRequest().setFilterRect( QgsRectangle( 4.5, -1, 10.5, 2 ) )
+      << QgsFeatureRequest().setFilterExpression( QStringLiteral( "int % 2 = 0" ) )
+      << QgsFeatureRequest().setFilterFids( QgsFeatureIds() << 2 << 5 << 6 )
+      << QgsFeatureRequest().setFlags( QgsFeatureRequest::NoGeometry )
+      << QgsFeatureRequest().setLimit( 11 );
+
+  // the provider fills batches natively, and the layer passes its batches on
+  const QList< QgsFeatureSource * > sources = QList< QgsFeatureSource * >() << layer.dataProvider() << &layer;
+  for ( QgsFeatureSource *source : sources )
+  {
+    for ( const QgsFeatureRequest &request : requests )
+    {
+      QgsFeatureList expected;
+      QgsFeatureIterator it = source->getFeatures( request );
+      QgsFeature f;
+      while ( it.nextFeature( f ) )
+        expected << f;
+
+      QgsFeatureBatch batch( layer.fields(), request.flags() & QgsFeatureRequest::SubsetOfAttributes ? request.subsetOfAttributes() : QgsAttributeList() );
+      QgsFeatureList actual;
+      it = source->getFeatures( request );
+      while ( it.nextBatch( batch, 4 ) )
+      {
+        QVERIFY( batch.size() <= 4 );
+        for ( int row = 0; row < batch.size(); ++row )
+          actual << batch.feature( row );
+      }
+
+      QCOMPARE( actual.size(), expected.size() );
+      for ( int i = 0; i < expected.size(); ++i )
+      {
+        QCOMPARE( actual.at( i ).id(), expected.at( i ).id() );
+        if ( request.flags() & QgsFeatureRequest::NoGeometry )
+          QVERIFY( !actual.at( i ).hasGeometry() );
+        else
+          QCOMPARE( actual.at( i ).geometry().asWkt(), expected.at( i ).geometry().asWkt() );
+        for ( int column = 0; column < batch.columnCount(); ++column )
+        {
+          const int idx = batch.attributeIndex( column );
+          QCOMPARE( actual.at( i ).attribute( idx ), expected.at( i ).attribute( idx ) );
+        }
+      }
+    }
+  }
+}
+
+void TestQgsFeatureBatch::ogrLayerBatches()
+{
+  // read through an Arrow stream when GDAL supports it for GeoPackage
+  QgsVectorLayer layer( QStringLiteral( TEST_DATA_DIR ) + QStringLiteral( "/points_gpkg.gpkg|layername=points_gpkg" ), QStringLiteral( "l" ), QStringLiteral( "ogr" ) );
+  QVERIFY( layer.isValid() );
+
+  const QList< QgsFeatureRequest > requests = QList< QgsFeatureRequest >()
+      << QgsFeatureRequest()
+      << QgsFeatureRequest().setSubsetOfAttributes( QgsAttributeList() << 1 ).setFlags( QgsFeatureRequest::NoGeometry )
+      << QgsFeatureRequest().setFilterRect( layer.extent().buffered( -layer.extent().width() / 4 ) );
+
+  for ( const QgsFeatureRequest &request : requests )
+  {
+    QgsFeatureList expected;
+    QgsFeatureIterator it = layer.getFeatures( request );
+    QgsFeature f;
+    while ( it.nextFeature( f ) )
+      expected << f;
+
+    QgsFeatureBatch batch( layer.fields(), request.flags() & QgsFeatureRequest::SubsetOfAttributes ? request.subsetOfAttributes() : QgsAttributeList() );
+    QgsFeatureList actual;
+    it = layer.getFeatures( request );
+    while ( it.nextBatch( batch, 3 ) )
+    {
+      for ( int row = 0; row < batch.size(); ++row )
+        actual << batch.feature( row );
+    }
+
+    QCOMPARE( actual.size(), expected.size() );
+    for ( int i = 0; i < expected.size(); ++i )
+    {
+      QCOMPARE( actual.at( i ).id(), expected.at( i ).id() );
+      QCOMPARE( actual.at( i ).geometry().asWkt(), expected.at( i ).geometry().asWkt() );
+      for ( int column = 0; column < batch.columnCount(); ++column )
+      {
+        const int idx = batch.attributeIndex( column );
+        QCOMPARE( actual.at( i ).attribute( idx ), expected.at( i ).attribute( idx ) );
+      }
+    }
+
+    // features read after a batch continue after the batch
+    if ( expected.size() > 3 )
+    {
+      it = layer.getFeatures( request );
+      QVERIFY( it.nextBatch( batch, 3 ) );
+      QCOMPARE( batch.size(), 3 );
+      QVERIFY( it.nextFeature( f ) );
+      QCOMPARE( f.id(), expected.at( 3 ).id() );
+
+      // and rewinding starts from the first feature again
+      QVERIFY( it.rewind() );
+      QVERIFY( it.nextBatch( batch, 3 ) );
+      QCOMPARE( batch.id( 0 ), expected.at( 0 ).id() );
+    }
+
+#if GDAL_VERSION_NUM >= GDAL_COMPUTE_VERSION(3,6,0)
+    // the provider iterator reads the batches from an Arrow stream, and goes on reading
+    // it for the features read one at a time after them. Depending on the GDAL version,
+    // GeoPackage layers may not provide a fast stream with a spatial filter
+    const bool arrowStream = request.filterRect().isNull();
+    QgsOgrFeatureIterator providerIt( static_cast< QgsOgrFeatureSource * >( layer.dataProvider()->featureSource() ), true, request, nullptr );
+    QVERIFY( providerIt.nextBatch( batch, 3 ) );
+    QCOMPARE( providerIt.isReadingArrowStream(), arrowStream );
+    actual.clear();
+    for ( int row = 0; row < batch.size(); ++row )
+      actual << batch.feature( row );
+    if ( expected.size() > 3 )
+    {
+      QVERIFY( providerIt.nextFeature( f ) );
+      QCOMPARE( providerIt.isReadingArrowStream(), arrowStream );
+      actual << f;
+    }
+    while ( providerIt.nextFeature( f ) )
+      actual << f;
+
+    QCOMPARE( actual.size(), expected.size() );
+    for ( int i = 0; i < expected.size(); ++i )
+    {
+      QCOMPARE( actual.at( i ).id(), expected.at( i ).id() );
+      QCOMPARE( actual.at( i ).geometry().asWkt(), expected.at( i ).geometry().asWkt() );
+      for ( int column = 0; column < batch.columnCount(); ++column )
+      {
+        const int idx = batch.attributeIndex( column );
+        QCOMPARE( actual.at( i ).attribute( idx ), expected.at( i ).attribute( idx ) );
+      }
+    }
+#endif
+  }
+}
+
+QGSTEST_MAIN( TestQgsFeatureBatch )
+#include "testqgsfeaturebatch.moc"
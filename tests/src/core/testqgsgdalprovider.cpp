@@ -22,12 +22,14 @@
 #include <QApplication>
 #include <QFileInfo>
 #include <QDir>
+#include <QtConcurrentMap>
 
 //qgis includes...
 #include <qgis.h>
 #include <qgsapplication.h>
 #include <qgsproviderregistry.h>
 #include <qgsrasterdataprovider.h>
+#include <qgsrasterblock.h>
 #include <qgsrectangle.h>
 
 /**
@@ -59,6 +61,7 @@ class TestQgsGdalProvider : public QObject
     void interactionBetweenRasterChangeAndCache(); // test that updading a raster invalidates the GDAL dataset cache (#20104)
     void scale0(); //test when data has scale 0 (#20493)
     void transformCoordinates();
+    void concurrentReads(); // test that reads from several threads on the same provider return the same data
 
   private:
     QString mTestDataDir;
@@ -399,5 +402,37 @@ void TestQgsGdalProvider::transformCoordinates()
 
 }
 
+void TestQgsGdalProvider::concurrentReads()
+{
+  QString raster = QStringLiteral( TEST_DATA_DIR ) + "/landsat.tif";
+  std::unique_ptr< QgsDataProvider > provider( QgsProviderRegistry::instance()->createProvider( QStringLiteral( "gdal" ), raster, QgsDataProvider::ProviderOptions() ) );
+  QgsRasterDataProvider *rp = dynamic_cast< QgsRasterDataProvider * >( provider.get() );
+  QVERIFY( rp );
+  QVERIFY( rp->isValid() );
+
+  const QgsRectangle extent = rp->extent();
+  const int width = rp->xSize();
+  const int height = rp->ySize();
+  std::unique_ptr< QgsRasterBlock > expected( rp->block( 1, extent, width, height ) );
+  QVERIFY( expected->isValid() );
+
+  QVector< int > jobs;
+  for ( int i = 0; i < 32; ++i )
+    jobs << i;
+
+  const QByteArray expectedData = expected->data();
+  const QList< bool > results = QtConcurrent::blockingMapped< QList< bool > >( jobs, [&]( const int & )
+  {
+    std::unique_ptr< QgsRasterBlock > block( rp->block( 1, extent, width, height ) );
+    return block->isValid() && block->data() == expectedData;
+  } );
+  for ( bool result : results )
+    QVERIFY( result );
+
+  // the provider must still work once the concurrent reads released their handles
+  std::unique_ptr< QgsRasterBlock > block( rp->block( 1, extent, width, height ) );
+  QCOMPARE( block->data(), expectedData );
+}
+
 QGSTEST_MAIN( TestQgsGdalProvider )
 #include "testqgsgdalprovider.moc"
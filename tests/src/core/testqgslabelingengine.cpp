@@ -17,6 +17,7 @@
 
 #include <qgsapplication.h>
 #include <qgslabelingengine.h>
+#include <qgslabelcandidatecache.h>
 #include <qgsproject.h>
 #include <qgsmaprenderersequentialjob.h>
 #include <qgsreadwritecontext.h>
@@ -90,6 +91,8 @@ class TestQgsLabelingEngine : public QObject
     void testLineAnchorHorizontal();
     void testLineAnchorHorizontalConstraints();
     void testShowAllLabelsWhenALabelHasNoCandidates();
+    void testSolveConflictsInParallel();
+    void testCandidateCache();
 
   private:
     QgsVectorLayer *vl = nullptr;
@@ -165,6 +168,10 @@ void TestQgsLabelingEngine::testEngineSettings()
   settings.setUnplacedLabelColor( QColor( 0, 255, 0 ) );
   QCOMPARE( settings.unplacedLabelColor().name(), QStringLiteral( "#00ff00" ) );
 
+  QVERIFY( !settings.testFlag( QgsLabelingEngineSettings::SolveConflictsInParallel ) );
+  settings.setFlag( QgsLabelingEngineSettings::SolveConflictsInParallel, true );
+  QVERIFY( settings.testFlag( QgsLabelingEngineSettings::SolveConflictsInParallel ) );
+
   // reading from project
   QgsProject p;
   settings.setDefaultTextRenderFormat( QgsRenderContext::TextFormatAlwaysText );
@@ -176,14 +183,17 @@ void TestQgsLabelingEngine::testEngineSettings()
   settings2.readSettingsFromProject( &p );
   QCOMPARE( settings2.defaultTextRenderFormat(), QgsRenderContext::TextFormatAlwaysText );
   QVERIFY( settings2.testFlag( QgsLabelingEngineSettings::DrawUnplacedLabels ) );
+  QVERIFY( settings2.testFlag( QgsLabelingEngineSettings::SolveConflictsInParallel ) );
   QCOMPARE( settings2.unplacedLabelColor().name(), QStringLiteral( "#00ff00" ) );
 
   settings.setDefaultTextRenderFormat( QgsRenderContext::TextFormatAlwaysOutlines );
   settings.setFlag( QgsLabelingEngineSettings::DrawUnplacedLabels, false );
+  settings.setFlag( QgsLabelingEngineSettings::SolveConflictsInParallel, false );
   settings.writeSettingsToProject( &p );
   settings2.readSettingsFromProject( &p );
   QCOMPARE( settings2.defaultTextRenderFormat(), QgsRenderContext::TextFormatAlwaysOutlines );
   QVERIFY( !settings2.testFlag( QgsLabelingEngineSettings::DrawUnplacedLabels ) );
+  QVERIFY( !settings2.testFlag( QgsLabelingEngineSettings::SolveConflictsInParallel ) );
   QCOMPARE( settings2.placementVersion(), QgsLabelingEngineSettings::PlacementEngineVersion1 );
 
   // test that older setting is still respected as a fallback
@@ -3317,5 +3327,159 @@ void TestQgsLabelingEngine::testShowAllLabelsWhenALabelHasNoCandidates()
   QVERIFY( imageCheck( QStringLiteral( "show_all_labels_when_no_candidates" ), img, 20 ) );
 }
 
+void TestQgsLabelingEngine::testSolveConflictsInParallel()
+{
+  // clusters of conflicting labels, far enough from each other to be solved independently
+  QgsPalLayerSettings settings;
+  setDefaultLabelParams( settings );
+  settings.fieldName = QStringLiteral( "'label'" );
+  settings.isExpression = true;
+  settings.placement = QgsPalLayerSettings::AroundPoint;
+
+  std::unique_ptr< QgsVectorLayer> vl2( new QgsVectorLayer( QStringLiteral( "Point?crs=epsg:3946&field=id:integer" ), QStringLiteral( "vl" ), QStringLiteral( "memory" ) ) );
+  vl2->setRenderer( new QgsNullSymbolRenderer() );
+
+  QgsFeatureList features;
+  int id = 0;
+  for ( int cluster = 0; cluster < 16; ++cluster )
+  {
+    const double clusterX = 190000 + ( cluster % 4 ) * 2500;
+    const double clusterY = 5000000 + ( cluster / 4 ) * 2500;
+    for ( int i = 0; i < 40; ++i )
+    {
+      QgsFeature f;
+      f.setAttributes( QgsAttributes() << id++ );
+      f.setGeometry( QgsGeometry::fromPointXY( QgsPointXY( clusterX + ( i % 8 ) * 60, clusterY + ( i / 8 ) * 60 ) ) );
+      features << f;
+    }
+  }
+  QVERIFY( vl2->dataProvider()->addFeatures( features ) );
+  vl2->updateExtents();
+
+  vl2->setLabeling( new QgsVectorLayerSimpleLabeling( settings ) );  // TODO: this should not be necessary!
+  vl2->setLabelsEnabled( true );
+
+  QgsMapSettings mapSettings;
+  mapSettings.setDestinationCrs( vl2->crs() );
+  mapSettings.setOutputSize( QSize( 800, 800 ) );
+  mapSettings.setExtent( QgsRectangle( 189500, 4999500, 200500, 5010500 ) );
+  mapSettings.setLayers( QList<QgsMapLayer *>() << vl2.get() );
+  mapSettings.setOutputDpi( 96 );
+
+  auto placedLabels = [&mapSettings]( bool parallel )
+  {
+    QgsLabelingEngineSettings engineSettings = mapSettings.labelingEngineSettings();
+    engineSettings.setFlag( QgsLabelingEngineSettings::SolveConflictsInParallel, parallel );
+    mapSettings.setLabelingEngineSettings( engineSettings );
+
+    QgsMapRendererSequentialJob job( mapSettings );
+    job.start();
+    job.waitForFinished();
+
+    std::unique_ptr< QgsLabelingResults > results( job.takeLabelingResults() );
+    QStringList labels;
+    const QList<QgsLabelPosition> positions = results->labelsWithinRect( mapSettings.extent() );
+    for ( const QgsLabelPosition &position : positions )
+    {
+      if ( !position.isUnplaced )
+        labels << QStringLiteral( "%1:%2,%3" ).arg( position.featureId ).arg( position.labelRect.xMinimum(), 0, 'f', 2 ).arg( position.labelRect.yMinimum(), 0, 'f', 2 );
+    }
+    labels.sort();
+    return labels;
+  };
+
+  const QStringList serial = placedLabels( false );
+  QVERIFY( !serial.isEmpty() );
+
+  // solving the clusters in parallel must not depend on the scheduling of the threads
+  const QStringList parallel = placedLabels( true );
+  QVERIFY( !parallel.isEmpty() );
+  for ( int i = 0; i < 3; ++i )
+    QCOMPARE( placedLabels( true ), parallel );
+
+  // and it should give solutions of the same quality as the serial solver
+  QGSCOMPARENEAR( parallel.size(), serial.size(), serial.size() * 0.05 );
+}
+
+void TestQgsLabelingEngine::testCandidateCache()
+{
+  QgsPalLayerSettings settings;
+  settings.fieldName = QStringLiteral( "Class" );
+  setDefaultLabelParams( settings );
+  settings.placement = QgsPalLayerSettings::AroundPoint;
+
+  vl->setLabeling( new QgsVectorLayerSimpleLabeling( settings ) );  // TODO: this should not be necessary!
+  vl->setLabelsEnabled( true );
+
+  QgsMapSettings mapSettings;
+  mapSettings.setLabelingEngineSettings( createLabelEngineSettings() );
+  mapSettings.setOutputSize( QSize( 640, 480 ) );
+  mapSettings.setExtent( vl->extent() );
+  mapSettings.setLayers( QList<QgsMapLayer *>() << vl );
+  mapSettings.setOutputDpi( 96 );
+
+  auto placedLabels = [&mapSettings]( QgsLabelCandidateCache * cache )
+  {
+    QgsMapRendererSequentialJob job( mapSettings );
+    job.setLabelCandidateCache( cache );
+    job.start();
+    job.waitForFinished();
+
+    std::unique_ptr< QgsLabelingResults > results( job.takeLabelingResults() );
+    QStringList labels;
+    const QList<QgsLabelPosition> positions = results->labelsWithinRect( mapSettings.visibleExtent() );
+    for ( const QgsLabelPosition &position : positions )
+    {
+      labels << QStringLiteral( "%1:%2,%3" ).arg( position.featureId ).arg( position.labelRect.xMinimum(), 0, 'f', 4 ).arg( position.labelRect.yMinimum(), 0, 'f', 4 );
+    }
+    labels.sort();
+    return labels;
+  };
+
+  QgsLabelCandidateCache cache;
+  const QStringList uncached = placedLabels( nullptr );
+  QVERIFY( !uncached.isEmpty() );
+
+  // first run fills the cache
+  QCOMPARE( placedLabels( &cache ), uncached );
+  QCOMPARE( cache.hits(), 0 );
+  QVERIFY( cache.misses() > 0 );
+  QVERIFY( cache.candidateCount() > 0 );
+
+  // the same view only uses cached candidates
+  int misses = cache.misses();
+  QCOMPARE( placedLabels( &cache ), uncached );
+  QCOMPARE( cache.misses(), misses );
+  QVERIFY( cache.hits() > 0 );
+
+  // panning at the same scale reuses the candidates of the features which are still visible
+  const QgsRectangle extent = mapSettings.extent();
+  mapSettings.setExtent( QgsRectangle( extent.xMinimum() + extent.width() / 4, extent.yMinimum(), extent.xMaximum() + extent.width() / 4, extent.yMaximum() ) );
+  int hits = cache.hits();
+  QCOMPARE( placedLabels( &cache ), placedLabels( nullptr ) );
+  QVERIFY( cache.hits() > hits );
+
+  // zooming invalidates all the candidates
+  mapSettings.setExtent( extent.buffered( extent.width() ) );
+  hits = cache.hits();
+  QCOMPARE( placedLabels( &cache ), placedLabels( nullptr ) );
+  QCOMPARE( cache.hits(), hits );
+
+  // changing the label settings gives new candidates
+  settings.dist = 5;
+  vl->setLabeling( new QgsVectorLayerSimpleLabeling( settings ) );
+  hits = cache.hits();
+  QCOMPARE( placedLabels( &cache ), placedLabels( nullptr ) );
+  QCOMPARE( cache.hits(), hits );
+
+  // the cache size is limited
+  cache.setMaximumCandidates( 10 );
+  QVERIFY( cache.candidateCount() <= 10 );
+  cache.clear();
+  QCOMPARE( cache.candidateCount(), 0 );
+  QCOMPARE( cache.hits(), 0 );
+  QCOMPARE( cache.misses(), 0 );
+}
+
 QGSTEST_MAIN( TestQgsLabelingEngine )
 #include "testqgslabelingengine.moc"
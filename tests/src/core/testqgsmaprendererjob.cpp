@@ -20,6 +20,7 @@
 #include <QTime>
 #include <QApplication>
 #include <QDesktopServices>
+#include <QMutex>
 
 #include "qgsvectorlayer.h"
 #include "qgsvectorfilewriter.h"
@@ -31,6 +32,7 @@
 #include "qgsfield.h"
 #include "qgis.h"
 #include "qgsmaprenderersequentialjob.h"
+#include "qgsmaprendererparalleljob.h"
 #include "qgsmaplayer.h"
 #include "qgsreadwritecontext.h"
 #include "qgsproviderregistry.h"
@@ -43,6 +45,8 @@
 #include "qgsfontutils.h"
 #include "qgsrasterlayer.h"
 #include "qgssinglesymbolrenderer.h"
+#include "qgslinesymbollayer.h"
+#include "qgsfillsymbollayer.h"
 #include "qgsrasterlayertemporalproperties.h"
 
 //qgs unit test utility class
@@ -87,6 +91,7 @@ class TestQgsMapRendererJob : public QObject
     void stagedRendererWithStagedLabeling();
 
     void vectorLayerBoundsWithReprojection();
+    void tiledLayerRendering();
 
     void temporalRender();
 
@@ -889,6 +894,142 @@ void TestQgsMapRendererJob::vectorLayerBoundsWithReprojection()
   QVERIFY( imageCheck( QStringLiteral( "vector_layer_bounds_with_reprojection" ), img ) );
 }
 
+/**
+ * Single symbol renderer recording the extents of the render contexts it is started with,
+ * which are the extents of the tiles when a layer is rendered in tiles.
+ */
+class TestTileRecordingRenderer : public QgsSingleSymbolRenderer
+{
+  public:
+
+    TestTileRecordingRenderer( QgsSymbol *symbol, QList< QgsRectangle > *extents, QMutex *mutex )
+      : QgsSingleSymbolRenderer( symbol )
+      , mExtents( extents )
+      , mMutex( mutex )
+    {}
+
+    TestTileRecordingRenderer *clone() const override
+    {
+      return new TestTileRecordingRenderer( symbol()->clone(), mExtents, mMutex );
+    }
+
+    void startRender( QgsRenderContext &context, const QgsFields &fields ) override
+    {
+      {
+        QMutexLocker locker( mMutex );
+        *mExtents << context.extent();
+      }
+      QgsSingleSymbolRenderer::startRender( context, fields );
+    }
+
+  private:
+    QList< QgsRectangle > *mExtents = nullptr;
+    QMutex *mMutex = nullptr;
+};
+
+void TestQgsMapRendererJob::tiledLayerRendering()
+{
+  std::unique_ptr< QgsVectorLayer > gridLayer = qgis::make_unique< QgsVectorLayer >( TEST_DATA_DIR + QStringLiteral( "/grid_4326.geojson" ),
+      QStringLiteral( "grid" ), QStringLiteral( "ogr" ) );
+  QVERIFY( gridLayer->isValid() );
+
+  std::unique_ptr< QgsLineSymbol > symbol = qgis::make_unique< QgsLineSymbol >();
+  symbol->setColor( QColor( 255, 0, 255 ) );
+  symbol->setWidth( 2 );
+  QList< QgsRectangle > renderedExtents;
+  QMutex renderedExtentsMutex;
+  gridLayer->setRenderer( new TestTileRecordingRenderer( symbol.release(), &renderedExtents, &renderedExtentsMutex ) );
+
+  QgsMapSettings mapSettings;
+  mapSettings.setDestinationCrs( QgsCoordinateReferenceSystem( QStringLiteral( "EPSG:3857" ) ) );
+  mapSettings.setExtent( QgsRectangle( -10000000, -8000000, 10000000, 8000000 ) );
+  mapSettings.setOutputSize( QSize( 512, 512 ) );
+  mapSettings.setFlag( QgsMapSettings::DrawLabeling, false );
+  mapSettings.setOutputDpi( 96 );
+  mapSettings.setLayers( QList< QgsMapLayer * >() << gridLayer.get() );
+
+  QgsMapRendererSequentialJob wholeJob( mapSettings );
+  wholeJob.start();
+  wholeJob.waitForFinished();
+  const QImage wholeImage = wholeJob.renderedImage().convertToFormat( QImage::Format_ARGB32 );
+  QCOMPARE( renderedExtents.size(), 1 );
+  const QgsRectangle wholeExtent = renderedExtents.at( 0 );
+  renderedExtents.clear();
+
+  // make sure the layer is split in several tiles, regardless of the number of cores
+  const int maxThreadCount = QThreadPool::globalInstance()->maxThreadCount();
+  QThreadPool::globalInstance()->setMaxThreadCount( 4 );
+
+  QgsMapRendererParallelJob tiledJob( mapSettings );
+  QVERIFY( !tiledJob.isTiledLayerRenderingEnabled() );
+  tiledJob.setTiledLayerRenderingEnabled( true );
+  QVERIFY( tiledJob.isTiledLayerRenderingEnabled() );
+  tiledJob.start();
+  tiledJob.waitForFinished();
+  const QImage tiledImage = tiledJob.renderedImage().convertToFormat( QImage::Format_ARGB32 );
+
+  QThreadPool::globalInstance()->setMaxThreadCount( maxThreadCount );
+
+  QVERIFY( tiledJob.errors().isEmpty() );
+
+  // the layer must have been split in tiles, each covering a part of the map
+  QCOMPARE( renderedExtents.size(), 4 );
+  for ( const QgsRectangle &tileExtent : qgis::as_const( renderedExtents ) )
+  {
+    QVERIFY( tileExtent.width() < wholeExtent.width() || tileExtent.height() < wholeExtent.height() );
+    QVERIFY( wholeExtent.intersects( tileExtent ) );
+  }
+
+  // tiles must compose to the same image as the whole layer render, allowing
+  // for antialiasing differences along clipped line ends
+  QCOMPARE( tiledImage.size(), wholeImage.size() );
+  int mismatches = 0;
+  for ( int y = 0; y < wholeImage.height(); ++y )
+  {
+    for ( int x = 0; x < wholeImage.width(); ++x )
+    {
+      const QRgb expected = wholeImage.pixel( x, y );
+      const QRgb actual = tiledImage.pixel( x, y );
+      if ( std::abs( qRed( expected ) - qRed( actual ) ) > 2 || std::abs( qGreen( expected ) - qGreen( actual ) ) > 2
+           || std::abs( qBlue( expected ) - qBlue( actual ) ) > 2 || std::abs( qAlpha( expected ) - qAlpha( actual ) ) > 2 )
+        mismatches++;
+    }
+  }
+  QVERIFY( mismatches < 10 );
+
+  // symbols depending on the whole geometry of the features are not rendered in tiles
+  QThreadPool::globalInstance()->setMaxThreadCount( 4 );
+
+  // dash patterns would restart at each tile edge
+  std::unique_ptr< QgsLineSymbol > dashedSymbol = qgis::make_unique< QgsLineSymbol >();
+  static_cast< QgsSimpleLineSymbolLayer * >( dashedSymbol->symbolLayer( 0 ) )->setPenStyle( Qt::DashLine );
+  gridLayer->setRenderer( new TestTileRecordingRenderer( dashedSymbol.release(), &renderedExtents, &renderedExtentsMutex ) );
+  renderedExtents.clear();
+  QgsMapRendererParallelJob dashedJob( mapSettings );
+  dashedJob.setTiledLayerRenderingEnabled( true );
+  dashedJob.start();
+  dashedJob.waitForFinished();
+  QCOMPARE( renderedExtents.size(), 1 );
+
+  // centroid fills would draw a marker in each tile
+  std::unique_ptr< QgsVectorLayer > polygonLayer = qgis::make_unique< QgsVectorLayer >( QStringLiteral( "Polygon?crs=epsg:4326" ), QStringLiteral( "polygons" ), QStringLiteral( "memory" ) );
+  QVERIFY( polygonLayer->isValid() );
+  QgsFeature polygon;
+  polygon.setGeometry( QgsGeometry::fromWkt( QStringLiteral( "Polygon((-80 -60, 80 -60, 80 60, -80 60, -80 -60))" ) ) );
+  QVERIFY( polygonLayer->dataProvider()->addFeature( polygon ) );
+  std::unique_ptr< QgsFillSymbol > centroidSymbol = qgis::make_unique< QgsFillSymbol >( QgsSymbolLayerList() << new QgsCentroidFillSymbolLayer() );
+  polygonLayer->setRenderer( new TestTileRecordingRenderer( centroidSymbol.release(), &renderedExtents, &renderedExtentsMutex ) );
+  mapSettings.setLayers( QList< QgsMapLayer * >() << polygonLayer.get() );
+  renderedExtents.clear();
+  QgsMapRendererParallelJob centroidJob( mapSettings );
+  centroidJob.setTiledLayerRenderingEnabled( true );
+  centroidJob.start();
+  centroidJob.waitForFinished();
+  QCOMPARE( renderedExtents.size(), 1 );
+
+  QThreadPool::globalInstance()->setMaxThreadCount( maxThreadCount );
+}
+
 void TestQgsMapRendererJob::temporalRender()
 {
   std::unique_ptr< QgsRasterLayer > rasterLayer = qgis::make_unique< QgsRasterLayer >( TEST_DATA_DIR + QStringLiteral( "/raster_layer.tiff" ),
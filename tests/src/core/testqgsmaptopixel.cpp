@@ -15,6 +15,7 @@
 #include "qgstest.h"
 #include <QObject>
 #include <QString>
+#include <QPolygonF>
 //header for class being tested
 #include <qgsrectangle.h>
 #include <qgsmaptopixel.h>
@@ -29,6 +30,10 @@ class TestQgsMapToPixel: public QObject
     void getters();
     void fromScale();
     void toMapCoordinates();
+    void transformPoints_data();
+    void transformPoints();
+    void transformPointsBenchmark_data();
+    void transformPointsBenchmark();
 };
 
 void TestQgsMapToPixel::rotation()
@@ -119,6 +124,78 @@ void TestQgsMapToPixel::toMapCoordinates()
   QCOMPARE( p, QgsPointXY( 20, 20 ) );
 }
 
+void TestQgsMapToPixel::transformPoints_data()
+{
+  QTest::addColumn<double>( "rotation" );
+  QTest::addColumn<int>( "count" );
+
+  QTest::newRow( "no rotation" ) << 0.0 << 101;
+  QTest::newRow( "no rotation even" ) << 0.0 << 100;
+  QTest::newRow( "rotation" ) << 37.5 << 101;
+  QTest::newRow( "rotation even" ) << -90.0 << 100;
+  QTest::newRow( "single point" ) << 15.0 << 1;
+  QTest::newRow( "empty" ) << 15.0 << 0;
+}
+
+void TestQgsMapToPixel::transformPoints()
+{
+  QFETCH( double, rotation );
+  QFETCH( int, count );
+
+  const QgsMapToPixel m2p( 0.37, 1250.5, -320.25, 800, 600, rotation );
+
+  QPolygonF points;
+  for ( int i = 0; i < count; ++i )
+    points << QPointF( 1000 + i * 7.3, -500 + ( i % 13 ) * 31.7 );
+
+  QPolygonF expected = points;
+  for ( QPointF &point : expected )
+    m2p.transformInPlace( point.rx(), point.ry() );
+
+  // the batch transform must give exactly the same results as the per point transform
+  m2p.transformInPlace( points.data(), points.size() );
+  QCOMPARE( points.size(), expected.size() );
+  for ( int i = 0; i < points.size(); ++i )
+  {
+    QCOMPARE( points.at( i ).x(), expected.at( i ).x() );
+    QCOMPARE( points.at( i ).y(), expected.at( i ).y() );
+  }
+}
+
+void TestQgsMapToPixel::transformPointsBenchmark_data()
+{
+  QTest::addColumn<bool>( "batch" );
+
+  QTest::newRow( "batch" ) << true;
+  QTest::newRow( "per point" ) << false;
+}
+
+void TestQgsMapToPixel::transformPointsBenchmark()
+{
+  QFETCH( bool, batch );
+
+  const QgsMapToPixel m2p( 0.37, 1250.5, -320.25, 800, 600, 0 );
+  QPolygonF points;
+  points.reserve( 1000000 );
+  for ( int i = 0; i < 1000000; ++i )
+    points << QPointF( i % 1000, i / 1000 );
+
+  QBENCHMARK
+  {
+    QPolygonF transformed = points;
+    if ( batch )
+    {
+      m2p.transformInPlace( transformed.data(), transformed.size() );
+    }
+    else
+    {
+      QPointF *ptr = transformed.data();
+      for ( int i = 0; i < transformed.size(); ++i, ++ptr )
+        m2p.transformInPlace( ptr->rx(), ptr->ry() );
+    }
+  }
+}
+
 QGSTEST_MAIN( TestQgsMapToPixel )
 #include "testqgsmaptopixel.moc"
 
@@ -0,0 +1,306 @@
+/***************************************************************************
+     testqgspackedspatialindex.cpp
+     -----------------------------
+    Date                 : October 2026
+    Copyright            : (C) 2026 by QGIS contributors
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qgstest.h"
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QTemporaryDir>
+#include <QtConcurrentMap>
+
+#include <qgsapplication.h>
+#include "qgsfeatureiterator.h"
+#include "qgsgeometry.h"
+#include "qgspackedspatialindex.h"
+#include "qgsvectordataprovider.h"
+#include "qgsvectorlayer.h"
+
+#include <algorithm>
+
+static QgsFeature _rectFeature( QgsFeatureId id, double x, double y, double width, double height )
+{
+  QgsFeature f( id );
+  f.setGeometry( QgsGeometry::fromRect( QgsRectangle( x, y, x + width, y + height ) ) );
+  return f;
+}
+
+static std::unique_ptr< QgsVectorLayer > _gridLayer( int size )
+{
+  // size x size polygons of 0.5 x 0.5 at integer coordinates, plus one feature without geometry
+  std::unique_ptr< QgsVectorLayer > vl = qgis::make_unique< QgsVectorLayer >( "Polygon", QString(), QStringLiteral( "memory" ) );
+  QgsFeatureList features;
+  QgsFeatureId id = 1;
+  for ( int x = 0; x < size; ++x )
+  {
+    for ( int y = 0; y < size; ++y )
+    {
+      features << _rectFeature( id++, x, y, 0.5, 0.5 );
+    }
+  }
+  features << QgsFeature( id );
+  vl->dataProvider()->addFeatures( features );
+  return vl;
+}
+
+static QList<QgsFeatureId> _bruteForce( QgsVectorLayer *vl, const QgsRectangle &rect )
+{
+  QList<QgsFeatureId> ids;
+  QgsFeature f;
+  QgsFeatureIterator it = vl->getFeatures();
+  while ( it.nextFeature( f ) )
+  {
+    if ( f.hasGeometry() && f.geometry().boundingBox().intersects( rect ) )
+      ids << f.id();
+  }
+  std::sort( ids.begin(), ids.end() );
+  return ids;
+}
+
+static QList<QgsFeatureId> _sorted( QList<QgsFeatureId> ids )
+{
+  std::sort( ids.begin(), ids.end() );
+  return ids;
+}
+
+class TestQgsPackedSpatialIndex : public QObject
+{
+    Q_OBJECT
+
+  private slots:
+
+    void initTestCase()
+    {
+      QgsApplication::init();
+      QgsApplication::initQgis();
+    }
+    void cleanupTestCase()
+    {
+      QgsApplication::exitQgis();
+    }
+
+    void testEmpty()
+    {
+      QgsPackedSpatialIndex invalid;
+      QVERIFY( !invalid.isValid() );
+      QCOMPARE( invalid.size(), 0ULL );
+      QVERIFY( invalid.intersects( QgsRectangle( 0, 0, 10, 10 ) ).isEmpty() );
+
+      std::unique_ptr< QgsVectorLayer > vl = qgis::make_unique< QgsVectorLayer >( "Point", QString(), QStringLiteral( "memory" ) );
+      QgsPackedSpatialIndex index( *vl->dataProvider() );
+      QVERIFY( index.isValid() );
+      QCOMPARE( index.size(), 0ULL );
+      QVERIFY( index.extent().isNull() );
+      QVERIFY( index.intersects( QgsRectangle( 0, 0, 10, 10 ) ).isEmpty() );
+      QVERIFY( index.nearestNeighbor( QgsPointXY( 0, 0 ), 3 ).isEmpty() );
+    }
+
+    void testQuery_data()
+    {
+      QTest::addColumn<int>( "nodeSize" );
+      QTest::newRow( "2" ) << 2;
+      QTest::newRow( "3" ) << 3;
+      QTest::newRow( "default" ) << static_cast< int >( QgsPackedSpatialIndex::DEFAULT_NODE_SIZE );
+    }
+
+    void testQuery()
+    {
+      QFETCH( int, nodeSize );
+
+      std::unique_ptr< QgsVectorLayer > vl = _gridLayer( 20 );
+      QgsPackedSpatialIndex index( *vl->dataProvider(), nullptr, nodeSize );
+      QVERIFY( index.isValid() );
+      QVERIFY( !index.isMapped() );
+      QCOMPARE( index.size(), 400ULL );
+      QCOMPARE( index.nodeSize(), nodeSize );
+      QCOMPARE( index.extent(), QgsRectangle( 0, 0, 19.5, 19.5 ) );
+
+      const QList<QgsRectangle> rects = QList<QgsRectangle>()
+                                        << QgsRectangle( 0, 0, 1, 1 )
+                                        << QgsRectangle( 2.6, 2.6, 2.9, 2.9 )
+                                        << QgsRectangle( 3.2, 4.1, 11.7, 8.3 )
+                                        << QgsRectangle( -10, -10, 30, 30 )
+                                        << QgsRectangle( 25, 25, 30, 30 );
+      for ( const QgsRectangle &rect : rects )
+      {
+        QCOMPARE( _sorted( index.intersects( rect ) ), _bruteForce( vl.get(), rect ) );
+      }
+
+      // visitor can stop the search
+      int visited = 0;
+      index.intersects( QgsRectangle( -10, -10, 30, 30 ), [&visited]( QgsFeatureId )
+      {
+        return ++visited < 5;
+      } );
+      QCOMPARE( visited, 5 );
+    }
+
+    void testEntries()
+    {
+      std::unique_ptr< QgsVectorLayer > vl = _gridLayer( 20 );
+      QVector< QPair< QgsFeatureId, QgsRectangle > > entries;
+      QgsFeature f;
+      QgsFeatureIterator it = vl->getFeatures();
+      while ( it.nextFeature( f ) )
+      {
+        if ( f.hasGeometry() )
+          entries << qMakePair( f.id(), f.geometry().boundingBox() );
+      }
+
+      const QgsPackedSpatialIndex index( entries );
+      QVERIFY( index.isValid() );
+      QCOMPARE( index.size(), 400ULL );
+      QCOMPARE( index.extent(), QgsRectangle( 0, 0, 19.5, 19.5 ) );
+      const QgsRectangle rect( 3.2, 4.1, 11.7, 8.3 );
+      QCOMPARE( _sorted( index.intersects( rect ) ), _bruteForce( vl.get(), rect ) );
+      // same tree as when built from the features
+      QCOMPARE( index.intersects( rect ), QgsPackedSpatialIndex( *vl->dataProvider() ).intersects( rect ) );
+    }
+
+    void testNearestNeighbor()
+    {
+      std::unique_ptr< QgsVectorLayer > vl = _gridLayer( 10 );
+      QgsPackedSpatialIndex index( *vl->dataProvider(), nullptr, 4 );
+
+      // feature ids are 1 + x * 10 + y
+      QCOMPARE( index.nearestNeighbor( QgsPointXY( 3.2, 4.3 ) ), QList<QgsFeatureId>() << 35 );
+      QCOMPARE( index.nearestNeighbor( QgsPointXY( -5, -5 ) ), QList<QgsFeatureId>() << 1 );
+      QCOMPARE( index.nearestNeighbor( QgsPointXY( 100, 100 ) ), QList<QgsFeatureId>() << 100 );
+
+      const QList<QgsFeatureId> three = index.nearestNeighbor( QgsPointXY( 5.25, 5.25 ), 3 );
+      QCOMPARE( three.size(), 3 );
+      QCOMPARE( three.at( 0 ), 56LL );
+      // the next ones are at the same distance
+      const QList<QgsFeatureId> sides = QList<QgsFeatureId>() << 46 << 55 << 57 << 66;
+      QVERIFY( sides.contains( three.at( 1 ) ) );
+      QVERIFY( sides.contains( three.at( 2 ) ) );
+
+      QCOMPARE( index.nearestNeighbor( QgsPointXY( 5.25, 5.25 ), 1000 ).size(), 100 );
+      QVERIFY( index.nearestNeighbor( QgsPointXY( -5, -5 ), 1, 1 ).isEmpty() );
+      QCOMPARE( _sorted( index.nearestNeighbor( QgsPointXY( 5.75, 5.25 ), 5, 0.25 ) ), QList<QgsFeatureId>() << 56 << 66 );
+    }
+
+    void testFile()
+    {
+      std::unique_ptr< QgsVectorLayer > vl = _gridLayer( 20 );
+      QgsPackedSpatialIndex index( *vl->dataProvider() );
+
+      QTemporaryDir dir;
+      const QString path = dir.filePath( QStringLiteral( "index.qix" ) );
+      QString error;
+      QVERIFY( index.writeToFile( path, &error ) );
+      QVERIFY( error.isEmpty() );
+
+      QgsPackedSpatialIndex opened = QgsPackedSpatialIndex::open( path, &error );
+      QVERIFY( error.isEmpty() );
+      QVERIFY( opened.isValid() );
+      QVERIFY( opened.isMapped() );
+      QCOMPARE( opened.size(), index.size() );
+      QCOMPARE( opened.nodeSize(), index.nodeSize() );
+      QCOMPARE( opened.extent(), index.extent() );
+      const QgsRectangle rect( 3.2, 4.1, 11.7, 8.3 );
+      QCOMPARE( opened.intersects( rect ), index.intersects( rect ) );
+      QCOMPARE( opened.nearestNeighbor( QgsPointXY( 3.2, 4.3 ), 4 ), index.nearestNeighbor( QgsPointXY( 3.2, 4.3 ), 4 ) );
+
+      // copies share the mapping
+      QgsPackedSpatialIndex copy = opened;
+      opened = QgsPackedSpatialIndex();
+      QVERIFY( copy.isMapped() );
+      QCOMPARE( _sorted( copy.intersects( rect ) ), _bruteForce( vl.get(), rect ) );
+      copy = QgsPackedSpatialIndex();
+
+      // invalid indexes cannot be written
+      QVERIFY( !QgsPackedSpatialIndex().writeToFile( dir.filePath( QStringLiteral( "invalid.qix" ) ), &error ) );
+      QVERIFY( !error.isEmpty() );
+
+      // missing file
+      error.clear();
+      QVERIFY( !QgsPackedSpatialIndex::open( dir.filePath( QStringLiteral( "missing.qix" ) ), &error ).isValid() );
+      QVERIFY( !error.isEmpty() );
+
+      // not an index
+      const QString garbagePath = dir.filePath( QStringLiteral( "garbage.qix" ) );
+      QFile garbage( garbagePath );
+      QVERIFY( garbage.open( QIODevice::WriteOnly ) );
+      garbage.write( QByteArray( 100, 'x' ) );
+      garbage.close();
+      error.clear();
+      QVERIFY( !QgsPackedSpatialIndex::open( garbagePath, &error ).isValid() );
+      QVERIFY( !error.isEmpty() );
+
+      // truncated index
+      QFile truncated( path );
+      QVERIFY( truncated.resize( truncated.size() - 40 ) );
+      error.clear();
+      QVERIFY( !QgsPackedSpatialIndex::open( path, &error ).isValid() );
+      QVERIFY( !error.isEmpty() );
+    }
+
+    void testThreads()
+    {
+      std::unique_ptr< QgsVectorLayer > vl = _gridLayer( 30 );
+      const QgsPackedSpatialIndex index( *vl->dataProvider() );
+
+      QList<QgsRectangle> rects;
+      for ( int i = 0; i < 200; ++i )
+        rects << QgsRectangle( i % 30, ( i * 7 ) % 30, i % 30 + 3.3, ( i * 7 ) % 30 + 2.1 );
+
+      const QList< QList<QgsFeatureId> > results = QtConcurrent::blockingMapped< QList< QList<QgsFeatureId> > >( rects, [&index]( const QgsRectangle & rect )
+      {
+        return _sorted( index.intersects( rect ) );
+      } );
+
+      for ( int i = 0; i < rects.size(); ++i )
+        QCOMPARE( results.at( i ), _bruteForce( vl.get(), rects.at( i ) ) );
+    }
+
+    void testCopy()
+    {
+      std::unique_ptr< QgsVectorLayer > vl = _gridLayer( 5 );
+      std::unique_ptr< QgsPackedSpatialIndex > index = qgis::make_unique< QgsPackedSpatialIndex >( *vl->dataProvider() );
+      std::unique_ptr< QgsPackedSpatialIndex > indexCopy = qgis::make_unique< QgsPackedSpatialIndex >( *index );
+
+      QVERIFY( index->d == indexCopy->d );
+
+      index.reset();
+      QCOMPARE( indexCopy->intersects( QgsRectangle( 0, 0, 0.2, 0.2 ) ), QList<QgsFeatureId>() << 1 );
+
+      QgsPackedSpatialIndex index3;
+      index3 = *indexCopy;
+      QVERIFY( index3.d == indexCopy->d );
+    }
+
+    void testHilbertIndex()
+    {
+      const QgsRectangle extent( 0, 0, 1, 1 );
+      QCOMPARE( QgsPackedSpatialIndex::hilbertIndex( 0, 0, extent ), 0U );
+      // points outside of the extent are on its border
+      QCOMPARE( QgsPackedSpatialIndex::hilbertIndex( -5, -5, extent ), 0U );
+
+      // the curve goes through each quadrant in turn, starting from the bottom left
+      // one and going through the top right one third
+      QCOMPARE( QgsPackedSpatialIndex::hilbertIndex( 0.25, 0.25, extent ) >> 30, 0U );
+      QCOMPARE( QgsPackedSpatialIndex::hilbertIndex( 0.75, 0.75, extent ) >> 30, 2U );
+      QSet< quint32 > quadrants;
+      quadrants << ( QgsPackedSpatialIndex::hilbertIndex( 0.25, 0.25, extent ) >> 30 )
+                << ( QgsPackedSpatialIndex::hilbertIndex( 0.25, 0.75, extent ) >> 30 )
+                << ( QgsPackedSpatialIndex::hilbertIndex( 0.75, 0.75, extent ) >> 30 )
+                << ( QgsPackedSpatialIndex::hilbertIndex( 0.75, 0.25, extent ) >> 30 );
+      QCOMPARE( quadrants.size(), 4 );
+    }
+
+};
+
+QGSTEST_MAIN( TestQgsPackedSpatialIndex )
+
+#include "testqgspackedspatialindex.moc"
@@ -39,6 +39,8 @@ class TestQgsRasterBlock : public QObject
 
     void testBasic();
     void testWrite();
+    void testReadValues();
+    void testVisitData();
 
   private:
 
@@ -242,6 +244,120 @@ void TestQgsRasterBlock::testWrite()
   delete block;
 }
 
+void TestQgsRasterBlock::testReadValues()
+{
+  const QList< Qgis::DataType > types = QList< Qgis::DataType >() << Qgis::Byte << Qgis::UInt16 << Qgis::Int16
+                                        << Qgis::UInt32 << Qgis::Int32 << Qgis::Float32 << Qgis::Float64;
+  for ( Qgis::DataType type : types )
+  {
+    QgsRasterBlock block( type, 7, 3 );
+    block.setNoDataValue( 5 );
+    for ( int i = 0; i < 21; ++i )
+      block.setValue( static_cast< qgssize >( i ), i % 9 );
+
+    // values across rows, compared to valueAndNoData()
+    double values[17];
+    bool isNoData[17];
+    QVERIFY( block.readValues( 2, 17, values, isNoData ) );
+    for ( int i = 0; i < 17; ++i )
+    {
+      bool expectedNoData = false;
+      QCOMPARE( values[i], block.valueAndNoData( static_cast< qgssize >( i + 2 ), expectedNoData ) );
+      QCOMPARE( isNoData[i], expectedNoData );
+    }
+    QVERIFY( !isNoData[0] );
+    QVERIFY( isNoData[3] );
+    QVERIFY( isNoData[12] );
+
+    QVERIFY( block.readValues( 4, 17, values, nullptr ) );
+    QCOMPARE( values[16], 2.0 );
+    QVERIFY( !block.readValues( 15, 7, values, isNoData ) );
+  }
+
+  // NaN values are no data
+  QgsRasterBlock floatBlock( Qgis::Float32, 3, 1 );
+  floatBlock.setNoDataValue( -1 );
+  floatBlock.setValue( 0, 0, 1.5 );
+  floatBlock.setValue( 0, 1, std::numeric_limits<double>::quiet_NaN() );
+  floatBlock.setValue( 0, 2, -1 );
+  double values[3];
+  bool isNoData[3];
+  QVERIFY( floatBlock.readValues( 0, 3, values, isNoData ) );
+  QCOMPARE( values[0], 1.5 );
+  QVERIFY( !isNoData[0] );
+  QVERIFY( isNoData[1] );
+  QVERIFY( isNoData[2] );
+
+  // no data bitmap
+  QgsRasterBlock bitmapBlock( Qgis::Int16, 10, 2 );
+  bitmapBlock.setValue( 0, 0, 3 );
+  bitmapBlock.setIsNoData( 0, 9 );
+  bitmapBlock.setIsNoData( 1, 0 );
+  bitmapBlock.setIsNoData( 1, 8 );
+  double bitmapValues[20];
+  bool bitmapIsNoData[20];
+  QVERIFY( bitmapBlock.readValues( 0, 20, bitmapValues, bitmapIsNoData ) );
+  QCOMPARE( bitmapValues[0], 3.0 );
+  for ( int i = 0; i < 20; ++i )
+    QCOMPARE( bitmapIsNoData[i], bitmapBlock.isNoData( static_cast< qgssize >( i ) ) );
+  QVERIFY( bitmapIsNoData[9] );
+  QVERIFY( bitmapIsNoData[10] );
+  QVERIFY( bitmapIsNoData[18] );
+
+  // no data at all
+  QgsRasterBlock plainBlock( Qgis::UInt16, 4, 1 );
+  plainBlock.setValue( 0, 3, 65535 );
+  double plainValues[4];
+  bool plainIsNoData[4];
+  QVERIFY( plainBlock.readValues( 0, 4, plainValues, plainIsNoData ) );
+  QCOMPARE( plainValues[3], 65535.0 );
+  QVERIFY( !plainIsNoData[0] && !plainIsNoData[1] && !plainIsNoData[2] && !plainIsNoData[3] );
+
+  // color blocks can't be read as values
+  QgsRasterBlock colorBlock( Qgis::ARGB32, 2, 2 );
+  QVERIFY( !colorBlock.readValues( 0, 4, values, nullptr ) );
+}
+
+struct TestSumVisitor
+{
+  template <typename T> void operator()( const T *data, qgssize count )
+  {
+    for ( qgssize i = 0; i < count; ++i )
+      sum += data[i];
+    size = sizeof( T );
+  }
+  double sum = 0;
+  int size = 0;
+};
+
+struct TestScaleVisitor
+{
+  template <typename T> void operator()( T *data, qgssize count )
+  {
+    for ( qgssize i = 0; i < count; ++i )
+      data[i] *= 2;
+  }
+};
+
+void TestQgsRasterBlock::testVisitData()
+{
+  QgsRasterBlock block( Qgis::UInt16, 5, 2 );
+  for ( int i = 0; i < 10; ++i )
+    block.setValue( static_cast< qgssize >( i ), i + 1 );
+
+  TestSumVisitor sum;
+  QVERIFY( qgis::as_const( block ).visitData( sum ) );
+  QCOMPARE( sum.sum, 55.0 );
+  QCOMPARE( sum.size, 2 );
+
+  TestScaleVisitor scale;
+  QVERIFY( block.visitData( scale ) );
+  QCOMPARE( block.value( 9 ), 20.0 );
+
+  QgsRasterBlock empty;
+  QVERIFY( !qgis::as_const( empty ).visitData( sum ) );
+}
+
 QGSTEST_MAIN( TestQgsRasterBlock )
 
 #include "testqgsrasterblock.moc"
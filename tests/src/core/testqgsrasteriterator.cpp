@@ -21,6 +21,12 @@
 #include "qgsrasterlayer.h"
 #include "qgsrasterdataprovider.h"
 #include "qgsrasteriterator.h"
+#include "qgsrasterdrawer.h"
+#include "qgsrasterpipe.h"
+#include "qgsrasterviewport.h"
+#include "qgsmaptopixel.h"
+
+#include <QPainter>
 
 /**
  * \ingroup UnitTests
@@ -40,6 +46,7 @@ class TestQgsRasterIterator : public QObject
 
     void testBasic();
     void testNoBlock();
+    void testParallelDrawer();
 
   private:
 
@@ -354,6 +361,46 @@ void TestQgsRasterIterator::testNoBlock()
 }
 
 
+void TestQgsRasterIterator::testParallelDrawer()
+{
+  QgsRasterPipe pipe( *mpRasterLayer->pipe() );
+  QVERIFY( pipe.provider()->providerCapabilities() & QgsRasterDataProvider::ProviderHintCanReadConcurrently );
+
+  const int width = 500;
+  const int height = 400;
+  const QgsRectangle extent = mpRasterLayer->extent();
+  QgsRasterViewPort viewPort;
+  viewPort.mDrawnExtent = extent;
+  viewPort.mWidth = width;
+  viewPort.mHeight = height;
+  viewPort.mTopLeftPoint = QgsPointXY( 0, 0 );
+  viewPort.mBottomRightPoint = QgsPointXY( width, height );
+  const QgsMapToPixel mapToPixel( extent.width() / width, extent.center().x(), extent.center().y(), width, height, 0 );
+
+  auto render = [&]( int threadCount )
+  {
+    QImage image( width, height, QImage::Format_ARGB32_Premultiplied );
+    image.fill( Qt::transparent );
+    QPainter painter( &image );
+    QgsRasterIterator iterator( pipe.last() );
+    // many small parts, so that they are spread over all the threads
+    iterator.setMaximumTileWidth( 128 );
+    iterator.setMaximumTileHeight( 96 );
+    QgsRasterDrawer drawer( &iterator );
+    drawer.setMaximumThreadCount( threadCount );
+    drawer.draw( &painter, &viewPort, &mapToPixel );
+    painter.end();
+    return image;
+  };
+
+  const QImage sequential = render( 1 );
+  QImage blank( width, height, QImage::Format_ARGB32_Premultiplied );
+  blank.fill( Qt::transparent );
+  QVERIFY( sequential != blank );
+
+  QCOMPARE( render( 4 ), sequential );
+}
+
 QGSTEST_MAIN( TestQgsRasterIterator )
 
 #include "testqgsrasteriterator.moc"
@@ -0,0 +1,147 @@
+/***************************************************************************
+     testqgsrasterprojector.cpp
+     --------------------------
+    Date                 : October 2026
+    Copyright            : (C) 2026 by QGIS contributors
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#include "qgstest.h"
+#include <QObject>
+#include <QString>
+
+#include "qgsapplication.h"
+#include "qgscoordinatetransform.h"
+#include "qgsrasterblock.h"
+#include "qgsrasterlayer.h"
+#include "qgsrasterdataprovider.h"
+#include "qgsrasterprojector.h"
+
+/**
+ * \ingroup UnitTests
+ * This is a unit test for the QgsRasterProjector class.
+ */
+class TestQgsRasterProjector : public QObject
+{
+    Q_OBJECT
+  public:
+    TestQgsRasterProjector() = default;
+
+  private slots:
+    void initTestCase();// will be called before the first testfunction is executed.
+    void cleanupTestCase();// will be called after the last testfunction was executed.
+    void init() {} // will be called before each testfunction is executed.
+    void cleanup() {} // will be called after every testfunction.
+
+    void repeatedBlocks();
+    void exactAndApproximate();
+
+  private:
+
+    //! Returns the number of pixels of \a block which are not no data
+    static int dataPixelCount( const QgsRasterBlock &block );
+
+    QgsRasterLayer *mpRasterLayer = nullptr;
+    QgsRectangle mDestExtent;
+};
+
+void TestQgsRasterProjector::initTestCase()
+{
+  // init QGIS's paths - true means that all path will be inited from prefix
+  QgsApplication::init();
+  QgsApplication::initQgis();
+
+  mpRasterLayer = new QgsRasterLayer( QStringLiteral( TEST_DATA_DIR ) + "/landsat.tif", QStringLiteral( "landsat" ) );
+  QVERIFY( mpRasterLayer->isValid() );
+
+  QgsCoordinateTransform ct( mpRasterLayer->crs(), QgsCoordinateReferenceSystem( QStringLiteral( "EPSG:4326" ) ), QgsCoordinateTransformContext() );
+  mDestExtent = ct.transformBoundingBox( mpRasterLayer->extent() );
+}
+
+void TestQgsRasterProjector::cleanupTestCase()
+{
+  delete mpRasterLayer;
+
+  QgsApplication::exitQgis();
+}
+
+int TestQgsRasterProjector::dataPixelCount( const QgsRasterBlock &block )
+{
+  int count = 0;
+  for ( int row = 0; row < block.height(); ++row )
+  {
+    for ( int col = 0; col < block.width(); ++col )
+    {
+      if ( !block.isNoData( row, col ) )
+        count++;
+    }
+  }
+  return count;
+}
+
+void TestQgsRasterProjector::repeatedBlocks()
+{
+  QgsRasterProjector projector;
+  projector.setInput( mpRasterLayer->dataProvider() );
+  projector.setCrs( mpRasterLayer->crs(), QgsCoordinateReferenceSystem( QStringLiteral( "EPSG:4326" ) ), QgsCoordinateTransformContext() );
+
+  std::unique_ptr< QgsRasterBlock > first( projector.block( 1, mDestExtent, 200, 150 ) );
+  QVERIFY( first->isValid() );
+  QCOMPARE( first->width(), 200 );
+  QCOMPARE( first->height(), 150 );
+  // the reprojected raster is rotated inside the requested extent
+  const int count = dataPixelCount( *first );
+  QVERIFY( count > 0 );
+  QVERIFY( count < 200 * 150 );
+
+  // the lookup grid of the same request is reused, which must give the same result
+  std::unique_ptr< QgsRasterBlock > second( projector.block( 1, mDestExtent, 200, 150 ) );
+  QCOMPARE( second->data(), first->data() );
+  QCOMPARE( dataPixelCount( *second ), count );
+
+  // as well as for another projector with the same settings
+  std::unique_ptr< QgsRasterProjector > clone( projector.clone() );
+  clone->setInput( mpRasterLayer->dataProvider() );
+  std::unique_ptr< QgsRasterBlock > third( clone->block( 1, mDestExtent, 200, 150 ) );
+  QCOMPARE( third->data(), first->data() );
+
+  // but not for another size
+  std::unique_ptr< QgsRasterBlock > other( projector.block( 1, mDestExtent, 100, 75 ) );
+  QCOMPARE( other->width(), 100 );
+  QCOMPARE( other->height(), 75 );
+  QVERIFY( dataPixelCount( *other ) > 0 );
+}
+
+void TestQgsRasterProjector::exactAndApproximate()
+{
+  QgsRasterProjector projector;
+  projector.setInput( mpRasterLayer->dataProvider() );
+  projector.setCrs( mpRasterLayer->crs(), QgsCoordinateReferenceSystem( QStringLiteral( "EPSG:4326" ) ), QgsCoordinateTransformContext() );
+
+  projector.setPrecision( QgsRasterProjector::Approximate );
+  std::unique_ptr< QgsRasterBlock > approximate( projector.block( 1, mDestExtent, 200, 150 ) );
+  projector.setPrecision( QgsRasterProjector::Exact );
+  std::unique_ptr< QgsRasterBlock > exact( projector.block( 1, mDestExtent, 200, 150 ) );
+  QVERIFY( approximate->isValid() );
+  QVERIFY( exact->isValid() );
+
+  // the approximation is within a pixel, so only a few pixels on the edges may differ
+  int different = 0;
+  for ( int row = 0; row < exact->height(); ++row )
+  {
+    for ( int col = 0; col < exact->width(); ++col )
+    {
+      if ( exact->isNoData( row, col ) != approximate->isNoData( row, col ) )
+        different++;
+    }
+  }
+  QVERIFY( different < 200 * 150 / 50 );
+}
+
+QGSTEST_MAIN( TestQgsRasterProjector )
+#include "testqgsrasterprojector.moc"
@@ -0,0 +1,124 @@
+/***************************************************************************
+     testqgsrenderarena.cpp
+     ----------------------
+    Date                 : October 2026
+    Copyright            : (C) 2026 by QGIS contributors
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qgstest.h"
+#include <QObject>
+
+#include "qgsrenderarena.h"
+#include "qgsrendercontext.h"
+
+#include <algorithm>
+#include <cstdint>
+
+class TestQgsRenderArena : public QObject
+{
+    Q_OBJECT
+
+  private slots:
+
+    void allocate()
+    {
+      QgsRenderArena arena( 256 );
+      QCOMPARE( arena.capacity(), static_cast< std::size_t >( 0 ) );
+      QCOMPARE( arena.bytesUsed(), static_cast< std::size_t >( 0 ) );
+
+      double *values = arena.allocateArray< double >( 10 );
+      QVERIFY( values );
+      QCOMPARE( reinterpret_cast< std::uintptr_t >( values ) % alignof( double ), static_cast< std::uintptr_t >( 0 ) );
+      for ( int i = 0; i < 10; ++i )
+        values[i] = i;
+      QCOMPARE( arena.bytesUsed(), static_cast< std::size_t >( 80 ) );
+      QCOMPARE( arena.capacity(), static_cast< std::size_t >( 256 ) );
+
+      // alignment
+      arena.allocate( 3, 1 );
+      void *aligned = arena.allocate( 16, 64 );
+      QCOMPARE( reinterpret_cast< std::uintptr_t >( aligned ) % 64, static_cast< std::uintptr_t >( 0 ) );
+
+      // larger than a block
+      char *large = static_cast< char * >( arena.allocate( 1000, 1 ) );
+      std::fill( large, large + 1000, 'x' );
+      QVERIFY( arena.capacity() >= 1256 );
+
+      // previous allocations are untouched
+      for ( int i = 0; i < 10; ++i )
+        QCOMPARE( values[i], static_cast< double >( i ) );
+    }
+
+    void rewind()
+    {
+      QgsRenderArena arena( 256 );
+      const QgsRenderArena::Marker start = arena.marker();
+      double *first = arena.allocateArray< double >( 10 );
+
+      const QgsRenderArena::Marker marker = arena.marker();
+      arena.allocateArray< double >( 100 );
+      const std::size_t capacity = arena.capacity();
+      arena.rewind( marker );
+      QCOMPARE( arena.bytesUsed(), static_cast< std::size_t >( 80 ) );
+
+      // the memory is reused
+      arena.allocateArray< double >( 100 );
+      QCOMPARE( arena.capacity(), capacity );
+
+      arena.rewind( start );
+      QCOMPARE( arena.bytesUsed(), static_cast< std::size_t >( 0 ) );
+      QCOMPARE( arena.allocateArray< double >( 10 ), first );
+
+      {
+        const QgsRenderArenaScope scope( arena );
+        arena.allocateArray< double >( 50 );
+        QCOMPARE( arena.bytesUsed(), static_cast< std::size_t >( 480 ) );
+      }
+      QCOMPARE( arena.bytesUsed(), static_cast< std::size_t >( 80 ) );
+    }
+
+    void reset()
+    {
+      QgsRenderArena arena( 256 );
+      for ( int i = 0; i < 100; ++i )
+        arena.allocate( 100, 8 );
+      const std::size_t capacity = arena.capacity();
+      QVERIFY( capacity >= 10000 );
+
+      // the blocks are merged, so that the same allocations don't need any new block
+      arena.reset();
+      QCOMPARE( arena.bytesUsed(), static_cast< std::size_t >( 0 ) );
+      QCOMPARE( arena.capacity(), capacity );
+      for ( int i = 0; i < 100; ++i )
+        arena.allocate( 100, 8 );
+      QCOMPARE( arena.capacity(), capacity );
+    }
+
+    void renderContext()
+    {
+      QgsRenderContext context;
+      QgsRenderArena &arena = context.renderArena();
+      QCOMPARE( &context.renderArena(), &arena );
+      arena.allocateArray< double >( 10 );
+
+      // copies have their own arena
+      QgsRenderContext copy( context );
+      QVERIFY( &copy.renderArena() != &arena );
+      QCOMPARE( copy.renderArena().bytesUsed(), static_cast< std::size_t >( 0 ) );
+
+      QgsRenderContext assigned;
+      assigned = context;
+      QVERIFY( &assigned.renderArena() != &arena );
+    }
+
+};
+
+QGSTEST_MAIN( TestQgsRenderArena )
+#include "testqgsrenderarena.moc"
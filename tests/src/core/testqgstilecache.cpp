@@ -0,0 +1,222 @@
+/***************************************************************************
+     testqgstilecache.cpp
+     --------------------
+    Date                 : October 2026
+    Copyright            : (C) 2026 by QGIS contributors
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#include "qgstest.h"
+#include <QObject>
+#include <QString>
+#include <QAbstractNetworkCache>
+#include <QBuffer>
+#include <QImage>
+#include <QNetworkDiskCache>
+#include <QTemporaryDir>
+
+#include "qgsapplication.h"
+#include "qgsnetworkaccessmanager.h"
+#include "qgstilecache.h"
+
+/**
+ * \ingroup UnitTests
+ * This is a unit test for the QgsTileCache class.
+ */
+class TestQgsTileCache : public QObject
+{
+    Q_OBJECT
+  public:
+    TestQgsTileCache() = default;
+
+  private slots:
+    void initTestCase();// will be called before the first testfunction is executed.
+    void cleanupTestCase();// will be called after the last testfunction was executed.
+    void init() {} // will be called before each testfunction is executed.
+    void cleanup() {} // will be called after every testfunction.
+
+    void memoryCache();
+    void diskStore();
+    void diskStoreEviction();
+    void clearDiskStore();
+
+  private:
+
+    //! Stores a PNG encoded tile in the network disk cache
+    void insertNetworkTile( const QUrl &url, const QImage &image, bool expires = true );
+    //! Fills the in-memory cache with other tiles, so that the tiles inserted before are evicted
+    void floodMemoryCache();
+
+    QTemporaryDir mNetworkCacheDir;
+    QTemporaryDir mTileStoreDir;
+};
+
+void TestQgsTileCache::initTestCase()
+{
+  QgsApplication::init();
+  QgsApplication::initQgis();
+
+  QNetworkDiskCache *cache = qobject_cast< QNetworkDiskCache * >( QgsNetworkAccessManager::instance()->cache() );
+  QVERIFY( cache );
+  cache->setCacheDirectory( mNetworkCacheDir.path() );
+  QgsTileCache::setDiskCacheDirectory( mTileStoreDir.path() );
+}
+
+void TestQgsTileCache::cleanupTestCase()
+{
+  QgsApplication::exitQgis();
+}
+
+void TestQgsTileCache::insertNetworkTile( const QUrl &url, const QImage &image, bool expires )
+{
+  QByteArray data;
+  QBuffer buffer( &data );
+  buffer.open( QIODevice::WriteOnly );
+  image.save( &buffer, "PNG" );
+
+  QNetworkCacheMetaData metaData;
+  metaData.setUrl( url );
+  metaData.setSaveToDisk( true );
+  if ( expires )
+    metaData.setExpirationDate( QDateTime::currentDateTime().addDays( 1 ) );
+  QIODevice *device = QgsNetworkAccessManager::instance()->cache()->prepare( metaData );
+  QVERIFY( device );
+  device->write( data );
+  QgsNetworkAccessManager::instance()->cache()->insert( device );
+}
+
+void TestQgsTileCache::floodMemoryCache()
+{
+  QImage other( 1, 1, QImage::Format_ARGB32_Premultiplied );
+  other.fill( Qt::black );
+  for ( int i = 0; i < 4 * QgsTileCache::maxCost(); ++i )
+    QgsTileCache::insertTile( QUrl( QStringLiteral( "http://localhost/flood/%1.png" ).arg( i ) ), other );
+}
+
+void TestQgsTileCache::memoryCache()
+{
+  QCOMPARE( QgsTileCache::maxCost(), 256 );
+
+  const QUrl url( QStringLiteral( "http://localhost/memory/0/0/0.png" ) );
+  QImage image;
+  QVERIFY( !QgsTileCache::tile( url, image ) );
+
+  QImage tile( 16, 16, QImage::Format_ARGB32_Premultiplied );
+  tile.fill( Qt::red );
+  QgsTileCache::insertTile( url, tile );
+  QVERIFY( QgsTileCache::tile( url, image ) );
+  QCOMPARE( image, tile );
+  QVERIFY( QgsTileCache::totalCost() > 0 );
+  QVERIFY( QgsTileCache::totalCost() <= QgsTileCache::maxCost() );
+
+  // the tile is not in the network cache, so it is not kept on the disk
+  floodMemoryCache();
+  QVERIFY( QgsTileCache::totalCost() <= QgsTileCache::maxCost() );
+  QVERIFY( !QgsTileCache::tile( url, image ) );
+}
+
+void TestQgsTileCache::diskStore()
+{
+  const QUrl url( QStringLiteral( "http://localhost/disk/1/0/1.png" ) );
+  QImage tile( 256, 256, QImage::Format_ARGB32 );
+  tile.fill( QColor( 10, 20, 30, 128 ) );
+  tile.setPixel( 5, 7, qRgba( 200, 100, 50, 255 ) );
+  insertNetworkTile( url, tile );
+
+  const qint64 sizeBefore = QgsTileCache::diskCacheSize();
+
+  // decoded from the network cache and saved in the disk store
+  QImage image;
+  QVERIFY( QgsTileCache::tile( url, image ) );
+  QCOMPARE( image.convertToFormat( QImage::Format_ARGB32 ), tile );
+  QVERIFY( QgsTileCache::diskCacheSize() > sizeBefore );
+
+  // without the in-memory cache and the network cache, the tile is mapped back from the disk store
+  floodMemoryCache();
+  QVERIFY( QgsNetworkAccessManager::instance()->cache()->remove( url ) );
+  QImage mapped;
+  QVERIFY( QgsTileCache::tile( url, mapped ) );
+  QCOMPARE( mapped.size(), tile.size() );
+  QCOMPARE( mapped.convertToFormat( QImage::Format_ARGB32 ), tile );
+
+  // the mapped image can be modified without touching the store
+  mapped.fill( Qt::blue );
+  floodMemoryCache();
+  QVERIFY( QgsTileCache::tile( url, image ) );
+  QCOMPARE( image.convertToFormat( QImage::Format_ARGB32 ), tile );
+
+  // a disabled store is not used anymore
+  QgsTileCache::setDiskCacheDirectory( QString() );
+  QCOMPARE( QgsTileCache::diskCacheSize(), 0LL );
+  floodMemoryCache();
+  QVERIFY( !QgsTileCache::tile( url, image ) );
+
+  // the index is rebuilt from the files when the store is enabled again
+  QgsTileCache::setDiskCacheDirectory( mTileStoreDir.path() );
+  QVERIFY( QgsTileCache::diskCacheSize() > 0 );
+  QVERIFY( QgsTileCache::tile( url, image ) );
+  QCOMPARE( image.convertToFormat( QImage::Format_ARGB32 ), tile );
+}
+
+void TestQgsTileCache::diskStoreEviction()
+{
+  const qint64 maximumSize = QgsTileCache::maximumDiskCacheSize();
+
+  // room for a few 64x64 tiles only
+  QgsTileCache::setMaximumDiskCacheSize( 5 * 64 * 64 * 4 );
+  QCOMPARE( QgsTileCache::maximumDiskCacheSize(), 5LL * 64 * 64 * 4 );
+  QVERIFY( QgsTileCache::diskCacheSize() <= QgsTileCache::maximumDiskCacheSize() );
+
+  QImage tile( 64, 64, QImage::Format_ARGB32_Premultiplied );
+  QList< QUrl > urls;
+  for ( int i = 0; i < 20; ++i )
+  {
+    const QUrl url( QStringLiteral( "http://localhost/eviction/2/%1/0.png" ).arg( i ) );
+    tile.fill( QColor( i, 0, 0 ) );
+    insertNetworkTile( url, tile );
+    QgsTileCache::insertTile( url, tile );
+    QVERIFY( QgsTileCache::diskCacheSize() <= QgsTileCache::maximumDiskCacheSize() );
+    urls << url;
+  }
+
+  // the most recent tile is still there, the oldest ones were removed
+  floodMemoryCache();
+  for ( const QUrl &url : qgis::as_const( urls ) )
+    QgsNetworkAccessManager::instance()->cache()->remove( url );
+  QImage image;
+  QVERIFY( QgsTileCache::tile( urls.last(), image ) );
+  QCOMPARE( image.pixelColor( 0, 0 ), QColor( 19, 0, 0 ) );
+  QVERIFY( !QgsTileCache::tile( urls.first(), image ) );
+
+  QgsTileCache::setMaximumDiskCacheSize( maximumSize );
+}
+
+void TestQgsTileCache::clearDiskStore()
+{
+  // a tile without an expiration date is kept in the store too, for a bounded time
+  const QUrl url( QStringLiteral( "http://localhost/clear/3/0/0.png" ) );
+  QImage tile( 32, 32, QImage::Format_ARGB32_Premultiplied );
+  tile.fill( Qt::green );
+  insertNetworkTile( url, tile, false );
+
+  QImage image;
+  QVERIFY( QgsTileCache::tile( url, image ) );
+  QVERIFY( QgsTileCache::diskCacheSize() > 0 );
+  floodMemoryCache();
+  QVERIFY( QgsTileCache::tile( url, image ) );
+  QCOMPARE( image.convertToFormat( QImage::Format_ARGB32_Premultiplied ), tile );
+
+  // clearing the network cache clears the store, which is read before it
+  QgsNetworkAccessManager::instance()->cache()->clear();
+  QCOMPARE( QgsTileCache::diskCacheSize(), 0LL );
+  floodMemoryCache();
+  QVERIFY( !QgsTileCache::tile( url, image ) );
+}
+
+QGSTEST_MAIN( TestQgsTileCache )
+#include "testqgstilecache.moc"
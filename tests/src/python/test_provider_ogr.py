@@ -27,10 +27,13 @@ from qgis.core import (
     QgsProject,
     QgsField,
     QgsFields,
+    QgsGeometry,
+    QgsPointXY,
     QgsRectangle,
     QgsProviderRegistry,
     QgsFeature,
     QgsFeatureRequest,
+    QgsFeatureSource,
     QgsSettings,
     QgsDataProvider,
     QgsVectorDataProvider,
@@ -382,6 +385,45 @@ class PyQgsOGRProvider(unittest.TestCase):
         self.assertEqual(f['z'], 3)
         self.assertEqual(f['w'], 4)
 
+    def testGeoJsonPackedSpatialIndex(self):
+        """ Test the spatial index stored next to GeoJSON files """
+
+        datasource = os.path.join(self.basetestpath, 'testGeoJsonPackedSpatialIndex.json')
+        with open(datasource, 'wt') as f:
+            features = ['{{ "type": "Feature", "properties": {{ "num": {} }}, "geometry": {{ "type": "Point", "coordinates": [ {}, {} ] }} }}'.format(i, i % 10, i // 10) for i in range(100)]
+            f.write('{ "type": "FeatureCollection", "features": [ ' + ', '.join(features) + ' ] }')
+
+        def selectedIds(vl):
+            request = QgsFeatureRequest().setFilterRect(QgsRectangle(2.5, 1.5, 5.5, 3.5))
+            return sorted(f['num'] for f in vl.getFeatures(request))
+
+        expected = [23, 24, 25, 33, 34, 35]
+
+        vl = QgsVectorLayer(datasource, 'test', 'ogr')
+        self.assertTrue(vl.isValid())
+        self.assertEqual(vl.hasSpatialIndex(), QgsFeatureSource.SpatialIndexNotPresent)
+        self.assertEqual(selectedIds(vl), expected)
+
+        self.assertTrue(vl.dataProvider().createSpatialIndex())
+        self.assertTrue(os.path.exists(datasource + '.spatialindex'))
+        self.assertEqual(vl.hasSpatialIndex(), QgsFeatureSource.SpatialIndexPresent)
+        self.assertEqual(selectedIds(vl), expected)
+
+        # the stored index is opened with the layer
+        vl = QgsVectorLayer(datasource, 'test', 'ogr')
+        self.assertEqual(vl.hasSpatialIndex(), QgsFeatureSource.SpatialIndexPresent)
+        self.assertEqual(selectedIds(vl), expected)
+
+        # and dropped when the features are edited
+        self.assertTrue(vl.startEditing())
+        f = QgsFeature(vl.fields())
+        f['num'] = 100
+        f.setGeometry(QgsGeometry.fromPointXY(QgsPointXY(4, 3)))
+        self.assertTrue(vl.addFeature(f))
+        self.assertTrue(vl.commitChanges())
+        self.assertEqual(vl.hasSpatialIndex(), QgsFeatureSource.SpatialIndexNotPresent)
+        self.assertEqual(selectedIds(vl), sorted(expected + [100]))
+
     def testEditGeoJsonAddField(self):
         """ Test bugfix of https://github.com/qgis/QGIS/issues/26484 (adding a new field)"""
 
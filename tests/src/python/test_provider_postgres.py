@@ -49,7 +49,11 @@ from qgis.core import (
     QgsVectorDataProvider,
     QgsDataSourceUri,
     QgsProviderConnectionException,
+    QgsApplication,
+    QgsProcessingContext,
+    QgsProcessingFeedback,
 )
+from qgis.analysis import QgsNativeAlgorithms
 from qgis.gui import QgsGui, QgsAttributeForm
 from qgis.PyQt.QtCore import QDate, QTime, QDateTime, QVariant, QDir, QObject, QByteArray, QTemporaryDir
 from qgis.PyQt.QtWidgets import QLabel
@@ -198,6 +202,134 @@ class TestPyQgsPostgresProvider(unittest.TestCase, ProviderTestCase):
         self.assertEqual(f.attributes()[datetime_idx], QDateTime(
             QDate(2004, 3, 4), QTime(13, 41, 52)))
 
+    def testBinaryCursorValues(self):
+        """
+        Test the values which are fetched in their binary representation
+        """
+        self.execSQLCommand(
+            'DROP TABLE IF EXISTS qgis_test."binary_values" CASCADE')
+        self.execSQLCommand(
+            'CREATE TABLE qgis_test."binary_values" ( pk SERIAL NOT NULL PRIMARY KEY, i2 int2, i4 int4, i8 int8, f8 float8, b bool, d date, t time, ts timestamp without time zone)')
+        self.execSQLCommand("INSERT INTO qgis_test.\"binary_values\" (i2, i4, i8, f8, b, d, t, ts) VALUES "
+                            "(-3, -70000, -5000000000, 0.1, true, '1969-07-20', '23:59:59.123', '1969-07-20 20:17:40.5'),"
+                            "(NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL),"
+                            "(3, 70000, 5000000000, -1.5e300, false, 'infinity', '00:00:00', '-infinity')")
+        vl = QgsVectorLayer(
+            self.dbconn + ' sslmode=disable table="qgis_test"."binary_values" sql=',
+            'test', 'postgres')
+        self.assertTrue(vl.isValid())
+
+        values = {feat['pk']: feat.attributes()[1:] for feat in vl.getFeatures()}
+        self.assertEqual(values[1], [-3, -70000, -5000000000, 0.1, True, QDate(1969, 7, 20), QTime(23, 59, 59, 123),
+                                     QDateTime(QDate(1969, 7, 20), QTime(20, 17, 40, 500))])
+        self.assertEqual(values[2], [NULL] * 8)
+        self.assertEqual(values[3], [3, 70000, 5000000000, -1.5e300, False, NULL, QTime(0, 0, 0), NULL])
+
+    def testFetchManyBatches(self):
+        """
+        Test iterating over more features than a single FETCH returns
+        """
+        self.execSQLCommand(
+            'DROP TABLE IF EXISTS qgis_test."many_rows" CASCADE')
+        self.execSQLCommand(
+            'CREATE TABLE qgis_test."many_rows" AS SELECT i AS pk, i * 2 AS val FROM generate_series(1, 10005) AS i')
+        self.execSQLCommand(
+            'ALTER TABLE qgis_test."many_rows" ADD PRIMARY KEY (pk)')
+        vl = QgsVectorLayer(
+            self.dbconn + ' sslmode=disable key=\'pk\' table="qgis_test"."many_rows" sql=',
+            'test', 'postgres')
+        self.assertTrue(vl.isValid())
+
+        values = [feat['val'] for feat in vl.getFeatures()]
+        self.assertEqual(len(values), 10005)
+        self.assertEqual(sum(values), 10005 * 10006)
+
+        # stop iterating while the next rows are being fetched, then iterate again
+        it = vl.getFeatures()
+        for i in range(2500):
+            f = QgsFeature()
+            self.assertTrue(it.nextFeature(f))
+        it.rewind()
+        self.assertEqual(len([f for f in it]), 10005)
+        it = vl.getFeatures()
+        self.assertTrue(it.nextFeature(f))
+        it.close()
+        self.assertEqual(len([f for f in vl.getFeatures()]), 10005)
+
+    def testPartitionRequest(self):
+        """
+        Test splitting a request into primary key ranges
+        """
+        self.execSQLCommand(
+            'DROP TABLE IF EXISTS qgis_test."partitioned_rows" CASCADE')
+        self.execSQLCommand(
+            'CREATE TABLE qgis_test."partitioned_rows" AS SELECT i AS pk, i % 7 AS val FROM generate_series(1, 1000) AS i')
+        self.execSQLCommand(
+            'ALTER TABLE qgis_test."partitioned_rows" ADD PRIMARY KEY (pk)')
+        vl = QgsVectorLayer(
+            self.dbconn + ' sslmode=disable key=\'pk\' table="qgis_test"."partitioned_rows" sql=',
+            'test', 'postgres')
+        self.assertTrue(vl.isValid())
+
+        partitions = vl.partitionRequest(QgsFeatureRequest(), 4)
+        self.assertEqual(len(partitions), 4)
+        ids = []
+        for partition in partitions:
+            ids.extend([f['pk'] for f in vl.getFeatures(partition)])
+        self.assertEqual(sorted(ids), list(range(1, 1001)))
+
+        # the partitions are combined with the request filter
+        request = QgsFeatureRequest().setFilterExpression('"val" = 3')
+        partitions = vl.partitionRequest(request, 4)
+        self.assertEqual(len(partitions), 4)
+        ids = []
+        for partition in partitions:
+            ids.extend([f['pk'] for f in vl.getFeatures(partition)])
+        self.assertEqual(sorted(ids), sorted([f['pk'] for f in vl.getFeatures(request)]))
+
+        # requests with a limit are not split
+        self.assertEqual(len(vl.partitionRequest(QgsFeatureRequest().setLimit(10), 4)), 1)
+
+        # nor are layers in edit mode
+        vl.startEditing()
+        self.assertEqual(len(vl.partitionRequest(QgsFeatureRequest(), 4)), 1)
+        vl.rollBack()
+
+    def testParallelProcessingOfPartitions(self):
+        """
+        Test that processing algorithms read the partitions of a request from several threads
+        """
+        self.execSQLCommand(
+            'DROP TABLE IF EXISTS qgis_test."partitioned_points" CASCADE')
+        self.execSQLCommand(
+            'CREATE TABLE qgis_test."partitioned_points" AS SELECT i AS pk, ST_SetSRID(ST_MakePoint(i, -i), 4326)::geometry(Point, 4326) AS geom FROM generate_series(1, 1000) AS i')
+        self.execSQLCommand(
+            'ALTER TABLE qgis_test."partitioned_points" ADD PRIMARY KEY (pk)')
+        vl = QgsVectorLayer(
+            self.dbconn + ' sslmode=disable key=\'pk\' srid=4326 type=POINT table="qgis_test"."partitioned_points" (geom) sql=',
+            'test', 'postgres')
+        self.assertTrue(vl.isValid())
+
+        if not QgsApplication.processingRegistry().providerById('native'):
+            QgsApplication.processingRegistry().addProvider(QgsNativeAlgorithms())
+        alg = QgsApplication.processingRegistry().createAlgorithmById('native:swapxy')
+
+        context = QgsProcessingContext()
+        context.setProject(QgsProject.instance())
+        context.setMaximumThreads(4)
+        context.setFlags(QgsProcessingContext.AllowUnorderedFeatures)
+        feedback = QgsProcessingFeedback()
+        results, ok = alg.run({'INPUT': vl, 'OUTPUT': 'memory:'}, context, feedback)
+        self.assertTrue(ok)
+
+        output = context.getMapLayer(results['OUTPUT'])
+        ids = []
+        for f in output.getFeatures():
+            self.assertEqual(f.geometry().asPoint().x(), -f['pk'])
+            self.assertEqual(f.geometry().asPoint().y(), f['pk'])
+            ids.append(f['pk'])
+        self.assertEqual(sorted(ids), list(range(1, 1001)))
+
     def testBooleanType(self):
         vl = QgsVectorLayer('{} table="qgis_test"."boolean_table" sql='.format(
             self.dbconn), "testbool", "postgres")
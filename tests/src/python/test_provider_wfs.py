@@ -4573,6 +4573,90 @@ java.io.IOExceptionCannot do natural order without a primary key, please add it
         errors = vl.dataProvider().errors()
         self.assertEqual(len(errors), 0, errors)
 
+    def testPersistentCache(self):
+        """Test that features are reused from the persistent cache of a previous layer"""
+
+        cache_dir = tempfile.mkdtemp()
+        QgsSettings().setValue("cache/directory", cache_dir)
+
+        endpoint = self.__class__.basetestpath + '/fake_qgis_http_endpoint_persistent_cache'
+
+        with open(sanitize(endpoint, '?SERVICE=WFS?REQUEST=GetCapabilities?VERSION=1.0.0'), 'wb') as f:
+            f.write("""
+<WFS_Capabilities version="1.0.0" xmlns="http://www.opengis.net/wfs" xmlns:ogc="http://www.opengis.net/ogc">
+  <FeatureTypeList>
+    <FeatureType>
+      <Name>my:typename</Name>
+      <Title>Title</Title>
+      <Abstract>Abstract</Abstract>
+      <SRS>EPSG:4326</SRS>
+    </FeatureType>
+  </FeatureTypeList>
+</WFS_Capabilities>""".encode('UTF-8'))
+
+        with open(sanitize(endpoint, '?SERVICE=WFS&REQUEST=DescribeFeatureType&VERSION=1.0.0&TYPENAME=my:typename'),
+                  'wb') as f:
+            f.write("""
+<xsd:schema xmlns:my="http://my" xmlns:gml="http://www.opengis.net/gml" xmlns:xsd="http://www.w3.org/2001/XMLSchema" elementFormDefault="qualified" targetNamespace="http://my">
+  <xsd:import namespace="http://www.opengis.net/gml"/>
+  <xsd:complexType name="typenameType">
+    <xsd:complexContent>
+      <xsd:extension base="gml:AbstractFeatureType">
+        <xsd:sequence>
+          <xsd:element maxOccurs="1" minOccurs="0" name="INTFIELD" nillable="true" type="xsd:int"/>
+        </xsd:sequence>
+      </xsd:extension>
+    </xsd:complexContent>
+  </xsd:complexType>
+  <xsd:element name="typename" substitutionGroup="gml:_Feature" type="my:typenameType"/>
+</xsd:schema>
+""".encode('UTF-8'))
+
+        get_feature = sanitize(endpoint, '?SERVICE=WFS&REQUEST=GetFeature&VERSION=1.0.0&TYPENAME=my:typename')
+        with open(get_feature, 'wb') as f:
+            f.write("""
+<wfs:FeatureCollection
+                       xmlns:wfs="http://www.opengis.net/wfs"
+                       xmlns:gml="http://www.opengis.net/gml"
+                       xmlns:my="http://my">
+  <gml:featureMember>
+    <my:typename fid="typename.0">
+      <my:INTFIELD>1</my:INTFIELD>
+    </my:typename>
+  </gml:featureMember>
+  <gml:featureMember>
+    <my:typename fid="typename.1">
+      <my:INTFIELD>2</my:INTFIELD>
+    </my:typename>
+  </gml:featureMember>
+</wfs:FeatureCollection>""".encode('UTF-8'))
+
+        uri = "url='http://" + endpoint + "' typename='my:typename' version='1.0.0' persistentCache='true'"
+        vl = QgsVectorLayer(uri, 'test', 'WFS')
+        self.assertTrue(vl.isValid())
+        ids = {f.id(): f['INTFIELD'] for f in vl.getFeatures()}
+        self.assertEqual(sorted(ids.values()), [1, 2])
+        del vl
+
+        # The server is no longer queried: features and ids come from the cache
+        os.unlink(get_feature)
+        vl = QgsVectorLayer(uri, 'test', 'WFS')
+        self.assertTrue(vl.isValid())
+        self.assertEqual({f.id(): f['INTFIELD'] for f in vl.getFeatures()}, ids)
+        self.assertEqual(vl.featureCount(), 2)
+
+        # Reloading discards the persistent cache
+        vl.reload()
+        self.assertEqual([f['INTFIELD'] for f in vl.getFeatures()], [])
+        del vl
+
+        vl = QgsVectorLayer(uri, 'test', 'WFS')
+        self.assertEqual([f['INTFIELD'] for f in vl.getFeatures()], [])
+        del vl
+
+        QgsSettings().remove("cache/directory")
+        shutil.rmtree(cache_dir, True)
+
     def testWFS20CaseInsensitiveKVP(self):
         """Test an URL with non standard query string arguments where the server exposes
         the same parameters with different case: see https://github.com/qgis/QGIS/issues/34148
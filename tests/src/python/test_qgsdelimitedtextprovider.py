@@ -24,6 +24,8 @@ __copyright__ = 'Copyright 2013, The QGIS Project'
 import qgis  # NOQA
 
 import os
+import glob
+import hashlib
 import re
 import tempfile
 import inspect
@@ -1015,6 +1017,124 @@ class TestQgsDelimitedTextProviderOther(unittest.TestCase):
         finally:
             del os.environ['QGIS_DELIMITED_TEXT_FILE_BUFFER_SIZE']
 
+    def testMappedFileScan(self):
+        # The file is scanned in parallel parts when it can be memory mapped, and the results
+        # are stored to be reused when the file is opened again: both must give the same
+        # layer as the sequential scan of the file
+        tmpdir = tempfile.mkdtemp()
+        filename = os.path.join(tmpdir, 'mapped.csv')
+        with open(filename, 'w', newline='') as f:
+            f.write('id,wkt,value,big,when,text\r\n')
+            for i in range(200):
+                if i % 17 == 0:
+                    f.write('\r\n')
+                if i % 23 == 0:
+                    f.write('{},"POINT(bad)",{},1,,invalid\r\n'.format(i, i))
+                    continue
+                if i % 31 == 0:
+                    f.write('{},"LINESTRING(0 0,1 1)",,,,incompatible\r\n'.format(i))
+                    continue
+                text = '"multi\r\nline, ""quoted"""' if i % 7 == 0 else 'text {}'.format(i)
+                when = '2020-01-{:02d}T10:00:00'.format(i % 28 + 1) if i < 150 else '2020-02-{:02d}'.format(i % 28 + 1)
+                f.write('{},"POINT({} {})",{}.5,{},{},{}\r\n'.format(i, i, -i, i, i * 10000000000, when, text))
+
+        def load():
+            url = MyUrl.fromLocalFile(filename)
+            url.addQueryItem("type", "csv")
+            url.addQueryItem("wktField", "wkt")
+            url.addQueryItem("watchFile", "no")
+            return QgsVectorLayer(url.toString(), 'test', 'delimitedtext')
+
+        def layerContent(vl):
+            self.assertTrue(vl.isValid())
+            fields = [(f.name(), f.type()) for f in vl.fields()]
+            features = [(f.id(), f.geometry().asWkt(), f.attributes()) for f in vl.getFeatures()]
+            byId = [(fid, vl.getFeature(fid).attributes()) for fid in (161, 5, 120, 98)]
+            return (fields, vl.featureCount(), vl.wkbType(), vl.extent().toString(), features, byId)
+
+        # Files of another encoding are read sequentially
+        url = MyUrl.fromLocalFile(filename)
+        url.addQueryItem("type", "csv")
+        url.addQueryItem("wktField", "wkt")
+        url.addQueryItem("watchFile", "no")
+        url.addQueryItem("encoding", "System")
+        sequential = layerContent(QgsVectorLayer(url.toString(), 'test', 'delimitedtext'))
+        self.assertEqual(sequential[1], 200 - 9 - 6)
+        self.assertEqual(sequential[4][6][2][5], 'multi\nline, "quoted"')
+
+        self.assertEqual(layerContent(load()), sequential)
+
+        os.environ['QGIS_DELIMITED_TEXT_SCAN_PART_SIZE'] = '100'
+        os.environ['QGIS_DELIMITED_TEXT_INDEX_MINIMUM_SIZE'] = '0'
+        try:
+            self.assertEqual(layerContent(load()), sequential)
+            # read from the stored scan
+            self.assertEqual(layerContent(load()), sequential)
+        finally:
+            del os.environ['QGIS_DELIMITED_TEXT_SCAN_PART_SIZE']
+            del os.environ['QGIS_DELIMITED_TEXT_INDEX_MINIMUM_SIZE']
+
+    def testStoredSpatialIndex(self):
+        # The spatial index is stored the first time it is built, and memory mapped
+        # when the layer is opened again
+        tmpdir = tempfile.mkdtemp()
+        filename = os.path.join(tmpdir, 'indexed.csv')
+
+        def writeFile(count):
+            with open(filename, 'w') as f:
+                f.write('id,x,y\n')
+                for i in range(count):
+                    f.write('{},{},{}\n'.format(i, i % 20, i // 20))
+
+        def load(spatialIndex):
+            url = MyUrl.fromLocalFile(filename)
+            url.addQueryItem("type", "csv")
+            url.addQueryItem("xField", "x")
+            url.addQueryItem("yField", "y")
+            url.addQueryItem("watchFile", "no")
+            url.addQueryItem("spatialIndex", "yes" if spatialIndex else "no")
+            vl = QgsVectorLayer(url.toString(), 'test', 'delimitedtext')
+            self.assertTrue(vl.isValid())
+            return vl
+
+        def storedIndexes():
+            name = hashlib.sha1(os.path.abspath(filename).encode('utf-8')).hexdigest()
+            return glob.glob(os.path.join(QgsApplication.qgisSettingsDirPath(), 'cache', 'delimitedtext', name + '.*.spatialindex'))
+
+        def selectedIds(vl):
+            request = QgsFeatureRequest().setFilterRect(QgsRectangle(2.5, 1.5, 5.5, 3.5))
+            return sorted(f['id'] for f in vl.getFeatures(request))
+
+        expected = sorted(x + 20 * y for x in range(3, 6) for y in range(2, 4))
+
+        writeFile(100)
+        os.environ['QGIS_DELIMITED_TEXT_INDEX_MINIMUM_SIZE'] = '0'
+        try:
+            vl = load(False)
+            self.assertEqual(vl.hasSpatialIndex(), QgsFeatureSource.SpatialIndexNotPresent)
+            self.assertEqual(storedIndexes(), [])
+            self.assertTrue(vl.dataProvider().createSpatialIndex())
+            self.assertEqual(vl.hasSpatialIndex(), QgsFeatureSource.SpatialIndexPresent)
+            self.assertEqual(selectedIds(vl), expected)
+            self.assertEqual(len(storedIndexes()), 1)
+            stored = storedIndexes()[0]
+
+            # the stored index is reused
+            vl = load(True)
+            self.assertEqual(vl.hasSpatialIndex(), QgsFeatureSource.SpatialIndexPresent)
+            self.assertEqual(selectedIds(vl), expected)
+            self.assertEqual(storedIndexes(), [stored])
+
+            # the index of a modified file is built again, and replaces the outdated one
+            time.sleep(1)
+            writeFile(60)
+            vl = load(True)
+            self.assertEqual(selectedIds(vl), expected[:3])
+            self.assertEqual(len(storedIndexes()), 1)
+            self.assertNotEqual(storedIndexes()[0], stored)
+        finally:
+            del os.environ['QGIS_DELIMITED_TEXT_INDEX_MINIMUM_SIZE']
+
 
 if __name__ == '__main__':
     unittest.main()
@@ -170,6 +170,37 @@ class TestQgsFeatureSource(unittest.TestCase):
         for id, f in original_features.items():
             self.assertEqual(new_features[id].attributes()[0], f.attributes()[0])
 
+    def testPartitionRequest(self):
+        """
+        Test splitting requests using base class method
+        """
+        layer = createLayerWithFivePoints()
+        all_ids = set(f.id() for f in layer.getFeatures())
+
+        # requests without a feature ids filter are not split
+        request = QgsFeatureRequest()
+        self.assertEqual(len(layer.partitionRequest(request, 3)), 1)
+        request = QgsFeatureRequest().setFilterExpression('"fldint" = 3')
+        self.assertEqual(len(layer.partitionRequest(request, 3)), 1)
+
+        request = QgsFeatureRequest().setFilterFids(list(all_ids))
+        partitions = layer.partitionRequest(request, 3)
+        self.assertEqual(len(partitions), 3)
+        ids = []
+        for partition in partitions:
+            ids.extend([f.id() for f in layer.getFeatures(partition)])
+        self.assertEqual(sorted(ids), sorted(all_ids))
+
+        # never more partitions than features
+        self.assertEqual(len(layer.partitionRequest(request, 10)), 5)
+        self.assertEqual(len(layer.partitionRequest(request, 1)), 1)
+
+        # order by and limit need the whole request
+        request = QgsFeatureRequest().setFilterFids(list(all_ids)).setLimit(2)
+        self.assertEqual(len(layer.partitionRequest(request, 3)), 1)
+        request = QgsFeatureRequest().setFilterFids(list(all_ids)).addOrderBy('fldint')
+        self.assertEqual(len(layer.partitionRequest(request, 3)), 1)
+
 
 if __name__ == '__main__':
     unittest.main()
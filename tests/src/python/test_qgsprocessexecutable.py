@@ -249,6 +249,16 @@ class TestQgsProcessExecutable(unittest.TestCase):
         self.assertIn('results', output.lower())
         self.assertTrue(os.path.exists(output_file))
 
+    def testModelRunStreamed(self):
+        output_file = self.TMP_DIR + '/model_output_streamed.shp'
+        rc, output, err = self.run_process(['run', TEST_DATA_DIR + '/test_model.model3', '--STREAM_MODEL_OUTPUTS=true', '--', 'FEATS={}'.format(TEST_DATA_DIR + '/polys.shp'), 'native:centroids_1:CENTROIDS={}'.format(output_file)])
+        if os.environ.get('TRAVIS', '') != 'true':
+            # Travis DOES have errors, due to QStandardPaths: XDG_RUNTIME_DIR not set warnings raised by Qt
+            self.assertFalse(err)
+        self.assertEqual(rc, 0)
+        self.assertIn('results', output.lower())
+        self.assertTrue(os.path.exists(output_file))
+
 
 if __name__ == '__main__':
     # look for qgis bin path
@@ -123,6 +123,42 @@ class TestQgsServerSettings(unittest.TestCase):
         self.assertEqual(self.settings.cacheSize(), 1024)
         os.environ.pop(env)
 
+    def test_env_worker_threads(self):
+        env = "QGIS_SERVER_WORKER_THREADS"
+
+        self.assertEqual(self.settings.workerThreads(), 1)
+
+        os.environ[env] = "4"
+        self.settings.load()
+        self.assertEqual(self.settings.workerThreads(), 4)
+        os.environ.pop(env)
+
+        # at least one worker
+        os.environ[env] = "0"
+        self.settings.load()
+        self.assertEqual(self.settings.workerThreads(), 1)
+        os.environ.pop(env)
+
+    def test_env_max_queued_requests(self):
+        env = "QGIS_SERVER_MAX_QUEUED_REQUESTS"
+
+        self.assertEqual(self.settings.maxQueuedRequests(), 64)
+
+        os.environ[env] = "8"
+        self.settings.load()
+        self.assertEqual(self.settings.maxQueuedRequests(), 8)
+        os.environ.pop(env)
+
+    def test_env_rendered_layer_cache_ttl(self):
+        env = "QGIS_SERVER_RENDERED_LAYER_CACHE_TTL"
+
+        self.assertEqual(self.settings.renderedLayerCacheTimeToLive(), 60)
+
+        os.environ[env] = "5"
+        self.settings.load()
+        self.assertEqual(self.settings.renderedLayerCacheTimeToLive(), 5)
+        os.environ.pop(env)
+
     def test_env_cache_directory(self):
         env = "QGIS_SERVER_CACHE_DIRECTORY"
 
@@ -0,0 +1,314 @@
+/***************************************************************************
+     testqgsserverrenderedlayercache.cpp
+     -----------------------------------
+    Date                 : October 2026
+    Copyright            : (C) 2026 by QGIS contributors
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#include "qgstest.h"
+#include <QObject>
+#include <QImage>
+#include <QTemporaryDir>
+
+//qgis includes...
+#include "qgsserverrenderedlayercache.h"
+#include "qgsmapsettings.h"
+#include "qgsvectorlayer.h"
+#include "qgssinglesymbolrenderer.h"
+#include "qgsmarkersymbollayer.h"
+#include "qgssymbol.h"
+#include "qgsmaplayerstylemanager.h"
+#include "qgsvectorlayerlabeling.h"
+#include "qgspallabeling.h"
+
+/**
+ * \ingroup UnitTests
+ * Unit tests for the server rendered layer cache
+ */
+class TestQgsServerRenderedLayerCache : public QObject
+{
+    Q_OBJECT
+
+  public:
+    TestQgsServerRenderedLayerCache() = default;
+
+  private slots:
+    // will be called before the first testfunction is executed.
+    void initTestCase();
+
+    // will be called after the last testfunction was executed.
+    void cleanupTestCase();
+
+    // Insertion, lookup and LRU eviction
+    void testLru();
+
+    // Invalidation by project
+    void testInvalidate();
+
+    // Cache keys
+    void testLayerKey();
+
+    // Layers whose data changes can't be detected
+    void testNotCacheable();
+
+    // Metatile grid
+    void testMetatile();
+};
+
+
+void TestQgsServerRenderedLayerCache::initTestCase()
+{
+  QgsApplication::init();
+  QgsApplication::initQgis();
+}
+
+void TestQgsServerRenderedLayerCache::cleanupTestCase()
+{
+  QgsApplication::exitQgis();
+}
+
+void TestQgsServerRenderedLayerCache::testLru()
+{
+  QImage image( 10, 10, QImage::Format_ARGB32_Premultiplied );
+  image.fill( Qt::red );
+  const qint64 imageSize = 10 * 10 * 4;
+
+  QgsServerRenderedLayerCache disabled;
+  QVERIFY( !disabled.isEnabled() );
+  QVERIFY( !disabled.insert( QStringLiteral( "p" ), QStringLiteral( "a" ), image ) );
+  QCOMPARE( disabled.count(), 0 );
+
+  QgsServerRenderedLayerCache cache( 2 * imageSize );
+  QVERIFY( cache.isEnabled() );
+  QVERIFY( cache.image( QStringLiteral( "p" ), QStringLiteral( "a" ) ).isNull() );
+
+  QVERIFY( cache.insert( QStringLiteral( "p" ), QStringLiteral( "a" ), image ) );
+  QVERIFY( cache.insert( QStringLiteral( "p" ), QStringLiteral( "b" ), image ) );
+  QCOMPARE( cache.count(), 2 );
+  QCOMPARE( cache.size(), 2 * imageSize );
+  QCOMPARE( cache.image( QStringLiteral( "p" ), QStringLiteral( "a" ) ).pixel( 0, 0 ), image.pixel( 0, 0 ) );
+  // same key in another project
+  QVERIFY( cache.image( QStringLiteral( "q" ), QStringLiteral( "a" ) ).isNull() );
+
+  // "b" is now the least recently used image
+  QVERIFY( cache.insert( QStringLiteral( "p" ), QStringLiteral( "c" ), image ) );
+  QCOMPARE( cache.count(), 2 );
+  QCOMPARE( cache.size(), 2 * imageSize );
+  QVERIFY( !cache.image( QStringLiteral( "p" ), QStringLiteral( "a" ) ).isNull() );
+  QVERIFY( cache.image( QStringLiteral( "p" ), QStringLiteral( "b" ) ).isNull() );
+  QVERIFY( !cache.image( QStringLiteral( "p" ), QStringLiteral( "c" ) ).isNull() );
+
+  // replacing an image does not grow the cache
+  QVERIFY( cache.insert( QStringLiteral( "p" ), QStringLiteral( "c" ), image ) );
+  QCOMPARE( cache.count(), 2 );
+
+  // too large
+  QImage large( 100, 100, QImage::Format_ARGB32_Premultiplied );
+  QVERIFY( !cache.insert( QStringLiteral( "p" ), QStringLiteral( "d" ), large ) );
+  QCOMPARE( cache.count(), 2 );
+
+  cache.setMaximumSize( imageSize );
+  QCOMPARE( cache.count(), 1 );
+  QCOMPARE( cache.size(), imageSize );
+  QVERIFY( !cache.image( QStringLiteral( "p" ), QStringLiteral( "c" ) ).isNull() );
+
+  cache.clear();
+  QCOMPARE( cache.count(), 0 );
+  QCOMPARE( cache.size(), 0LL );
+}
+
+void TestQgsServerRenderedLayerCache::testInvalidate()
+{
+  QImage image( 10, 10, QImage::Format_ARGB32_Premultiplied );
+  image.fill( Qt::blue );
+
+  QgsServerRenderedLayerCache cache( 1024 * 1024 );
+  QVERIFY( cache.insert( QStringLiteral( "p" ), QStringLiteral( "a" ), image ) );
+  QVERIFY( cache.insert( QStringLiteral( "p" ), QStringLiteral( "b" ), image ) );
+  QVERIFY( cache.insert( QStringLiteral( "q" ), QStringLiteral( "a" ), image ) );
+
+  cache.invalidate( QStringLiteral( "p" ) );
+  QCOMPARE( cache.count(), 1 );
+  QVERIFY( cache.image( QStringLiteral( "p" ), QStringLiteral( "a" ) ).isNull() );
+  QVERIFY( !cache.image( QStringLiteral( "q" ), QStringLiteral( "a" ) ).isNull() );
+}
+
+void TestQgsServerRenderedLayerCache::testLayerKey()
+{
+  QTemporaryDir dir;
+  const QStringList files = QStringList() << QStringLiteral( "points.shp" ) << QStringLiteral( "points.shx" )
+                            << QStringLiteral( "points.dbf" ) << QStringLiteral( "points.prj" );
+  for ( const QString &file : files )
+    QVERIFY( QFile::copy( QStringLiteral( TEST_DATA_DIR ) + '/' + file, dir.filePath( file ) ) );
+
+  QgsVectorLayer layer( dir.filePath( QStringLiteral( "points.shp" ) ), QStringLiteral( "points" ), QStringLiteral( "ogr" ) );
+  QVERIFY( layer.isValid() );
+
+  QgsMapSettings settings;
+  settings.setDestinationCrs( QgsCoordinateReferenceSystem( QStringLiteral( "EPSG:4326" ) ) );
+  settings.setOutputSize( QSize( 256, 256 ) );
+  settings.setExtent( QgsRectangle( 0, 0, 10, 10 ) );
+  settings.setLayers( QList<QgsMapLayer *>() << &layer );
+
+  QgsServerRenderedLayerCache cache;
+  const QString key = cache.layerKey( &layer, settings );
+  QVERIFY( key.startsWith( layer.id() ) );
+  QCOMPARE( cache.layerKey( &layer, settings ), key );
+
+  // sub pixel differences in the extent are snapped away
+  QgsMapSettings jitter = settings;
+  jitter.setExtent( QgsRectangle( 1e-9, 0, 10, 10 + 1e-9 ) );
+  QCOMPARE( cache.layerKey( &layer, jitter ), key );
+
+  QgsMapSettings moved = settings;
+  moved.setExtent( QgsRectangle( 5, 0, 15, 10 ) );
+  QVERIFY( cache.layerKey( &layer, moved ) != key );
+
+  QgsMapSettings size = settings;
+  size.setOutputSize( QSize( 512, 512 ) );
+  QVERIFY( cache.layerKey( &layer, size ) != key );
+
+  QgsMapSettings dpi = settings;
+  dpi.setOutputDpi( 192 );
+  QVERIFY( cache.layerKey( &layer, dpi ) != key );
+
+  // filters
+  layer.setSubsetString( QStringLiteral( "\"Class\" = 'Jet'" ) );
+  const QString filteredKey = cache.layerKey( &layer, settings );
+  QVERIFY( filteredKey != key );
+  layer.setSubsetString( QString() );
+  QCOMPARE( cache.layerKey( &layer, settings ), key );
+
+  // switching between the styles of the layer does not change their keys
+  const QString defaultStyle = layer.styleManager()->currentStyle();
+  QVERIFY( layer.styleManager()->addStyleFromLayer( QStringLiteral( "other" ) ) );
+  QVERIFY( layer.styleManager()->setCurrentStyle( QStringLiteral( "other" ) ) );
+  const QString otherStyleKey = cache.layerKey( &layer, settings );
+  QVERIFY( otherStyleKey != key );
+  QVERIFY( layer.styleManager()->setCurrentStyle( defaultStyle ) );
+  QCOMPARE( cache.layerKey( &layer, settings ), key );
+  QVERIFY( layer.styleManager()->setCurrentStyle( QStringLiteral( "other" ) ) );
+  QCOMPARE( cache.layerKey( &layer, settings ), otherStyleKey );
+
+  // a new renderer is a new revision of the style
+  QgsSimpleMarkerSymbolLayer *marker = new QgsSimpleMarkerSymbolLayer();
+  marker->setColor( Qt::green );
+  layer.setRenderer( new QgsSingleSymbolRenderer( new QgsMarkerSymbol( QgsSymbolLayerList() << marker ) ) );
+  const QString newRendererKey = cache.layerKey( &layer, settings );
+  QVERIFY( newRendererKey != otherStyleKey );
+  QVERIFY( newRendererKey != key );
+
+  // changes to the data files are detected once the files are checked again
+  QFile dbf( dir.filePath( QStringLiteral( "points.dbf" ) ) );
+  QVERIFY( dbf.open( QIODevice::Append ) );
+  dbf.write( "\x1a" );
+  dbf.close();
+  QTest::qSleep( QgsServerRenderedLayerCache::DATA_CHECK_INTERVAL + 100 );
+  QVERIFY( cache.layerKey( &layer, settings ) != newRendererKey );
+}
+
+void TestQgsServerRenderedLayerCache::testNotCacheable()
+{
+  QgsServerRenderedLayerCache cache;
+
+  QgsMapSettings settings;
+  settings.setDestinationCrs( QgsCoordinateReferenceSystem( QStringLiteral( "EPSG:4326" ) ) );
+  settings.setOutputSize( QSize( 256, 256 ) );
+  settings.setExtent( QgsRectangle( 0, 0, 10, 10 ) );
+
+  // changes to the features of a memory layer are not detected, so they are only
+  // cached for a limited time
+  QgsVectorLayer memoryLayer( QStringLiteral( "Point?crs=epsg:4326&field=name:string" ), QStringLiteral( "points" ), QStringLiteral( "memory" ) );
+  QVERIFY( memoryLayer.isValid() );
+  QVERIFY( cache.layerKey( &memoryLayer, settings ).isEmpty() );
+  cache.setTimeToLive( 1 );
+  const QString memoryKey = cache.layerKey( &memoryLayer, settings );
+  QVERIFY( !memoryKey.isEmpty() );
+  QTest::qSleep( 1100 );
+  QVERIFY( cache.layerKey( &memoryLayer, settings ) != memoryKey );
+  cache.setTimeToLive( 0 );
+
+  // labels are not part of the layer images
+  QgsVectorLayer layer( QStringLiteral( TEST_DATA_DIR ) + QStringLiteral( "/points.shp" ), QStringLiteral( "points" ), QStringLiteral( "ogr" ) );
+  QVERIFY( layer.isValid() );
+  QVERIFY( !cache.layerKey( &layer, settings ).isEmpty() );
+  layer.setLabeling( new QgsVectorLayerSimpleLabeling( QgsPalLayerSettings() ) );
+  layer.setLabelsEnabled( true );
+  QVERIFY( cache.layerKey( &layer, settings ).isEmpty() );
+  settings.setFlag( QgsMapSettings::DrawLabeling, false );
+  QVERIFY( !cache.layerKey( &layer, settings ).isEmpty() );
+}
+
+void TestQgsServerRenderedLayerCache::testMetatile()
+{
+  QgsMapSettings settings;
+  settings.setDestinationCrs( QgsCoordinateReferenceSystem( QStringLiteral( "EPSG:3857" ) ) );
+  settings.setOutputSize( QSize( 256, 256 ) );
+
+  // tiles of a grid whose origin is not on a pixel of the CRS origin
+  const double resolution = 2.5;
+  const double originX = 0.3;
+  const double originY = 1000.7;
+  const double tileSize = 256 * resolution;
+  auto tileSettings = [ = ]( int column, int row ) -> QgsMapSettings
+  {
+    QgsMapSettings tile = settings;
+    tile.setExtent( QgsRectangle( originX + column * tileSize, originY - ( row + 1 ) * tileSize,
+                                  originX + ( column + 1 ) * tileSize, originY - row * tileSize ) );
+    return tile;
+  };
+
+  QgsMapSettings metatile;
+  QPoint offset;
+  QVERIFY( QgsServerRenderedLayerCache::metatileSettings( tileSettings( 0, 0 ), metatile, offset ) );
+  QCOMPARE( metatile.outputSize(), QSize( QgsServerRenderedLayerCache::METATILE_SIZE, QgsServerRenderedLayerCache::METATILE_SIZE ) );
+  QGSCOMPARENEAR( metatile.mapUnitsPerPixel(), resolution, 1e-9 );
+  const QgsRectangle metatileExtent = metatile.visibleExtent();
+
+  // the tile is at its offset in the metatile
+  const QgsRectangle tileExtent = tileSettings( 0, 0 ).visibleExtent();
+  QGSCOMPARENEAR( metatileExtent.xMinimum() + offset.x() * resolution, tileExtent.xMinimum(), 1e-6 );
+  QGSCOMPARENEAR( metatileExtent.yMaximum() - offset.y() * resolution, tileExtent.yMaximum(), 1e-6 );
+
+  // all the tiles of the metatile share its extent
+  const int tilesPerMetatile = QgsServerRenderedLayerCache::METATILE_SIZE / 256;
+  const int firstColumn = -offset.x() / 256;
+  const int firstRow = -offset.y() / 256;
+  for ( int row = firstRow; row < firstRow + tilesPerMetatile; ++row )
+  {
+    for ( int column = firstColumn; column < firstColumn + tilesPerMetatile; ++column )
+    {
+      QgsMapSettings other;
+      QPoint otherOffset;
+      QVERIFY( QgsServerRenderedLayerCache::metatileSettings( tileSettings( column, row ), other, otherOffset ) );
+      QGSCOMPARENEAR( other.visibleExtent().xMinimum(), metatileExtent.xMinimum(), 1e-6 );
+      QGSCOMPARENEAR( other.visibleExtent().yMaximum(), metatileExtent.yMaximum(), 1e-6 );
+      QCOMPARE( otherOffset, QPoint( ( column - firstColumn ) * 256, ( row - firstRow ) * 256 ) );
+    }
+  }
+
+  // the next tile is in the next metatile
+  QgsMapSettings next;
+  QVERIFY( QgsServerRenderedLayerCache::metatileSettings( tileSettings( firstColumn + tilesPerMetatile, firstRow ), next, offset ) );
+  QGSCOMPARENEAR( next.visibleExtent().xMinimum(), metatileExtent.xMaximum(), 1e-6 );
+  QCOMPARE( offset, QPoint( 0, 0 ) );
+
+  // maps across metatiles and rotated maps are not cropped from metatiles
+  QgsMapSettings across = tileSettings( firstColumn, firstRow );
+  across.setExtent( across.extent().buffered( tileSize / 2 ) );
+  across.setOutputSize( QSize( 512, 512 ) );
+  QVERIFY( !QgsServerRenderedLayerCache::metatileSettings( across, metatile, offset ) );
+
+  QgsMapSettings rotated = tileSettings( 0, 0 );
+  rotated.setRotation( 45 );
+  QVERIFY( !QgsServerRenderedLayerCache::metatileSettings( rotated, metatile, offset ) );
+}
+
+QGSTEST_MAIN( TestQgsServerRenderedLayerCache )
+#include "testqgsserverrenderedlayercache.moc"
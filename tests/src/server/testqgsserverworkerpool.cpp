@@ -0,0 +1,208 @@
+/***************************************************************************
+     testqgsserverworkerpool.cpp
+     ---------------------------
+    Date                 : October 2026
+    Copyright            : (C) 2026 by QGIS contributors
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#include "qgstest.h"
+#include <QObject>
+#include <QSemaphore>
+#include <QTemporaryDir>
+#include <QThread>
+
+//qgis includes...
+#include "qgsserver.h"
+#include "qgsserverworkerpool.h"
+#include "qgsbufferserverrequest.h"
+#include "qgsbufferserverresponse.h"
+#include "qgsproject.h"
+#include "qgsvectorlayer.h"
+#include "qgsvirtuallayerdefinition.h"
+
+/**
+ * \ingroup UnitTests
+ * Unit tests for the server worker pool
+ */
+class TestQgsServerWorkerPool : public QObject
+{
+    Q_OBJECT
+
+  public:
+    TestQgsServerWorkerPool() = default;
+
+  private slots:
+    // will be called before the first testfunction is executed.
+    void initTestCase();
+
+    // will be called after the last testfunction was executed.
+    void cleanupTestCase();
+
+    // Jobs run on worker threads with their own server
+    void testJobs();
+
+    // Jobs are rejected when the queue is full
+    void testBackpressure();
+
+    // Workers resolve the current project to their own project copy
+    void testVirtualLayerProject();
+
+  private:
+    std::unique_ptr<QgsServer> mServer;
+};
+
+
+void TestQgsServerWorkerPool::initTestCase()
+{
+  QgsApplication::init();
+  QgsApplication::initQgis();
+  // the server must be initialized from the main thread
+  mServer = qgis::make_unique<QgsServer>();
+}
+
+void TestQgsServerWorkerPool::cleanupTestCase()
+{
+  mServer.reset();
+  QgsApplication::exitQgis();
+}
+
+void TestQgsServerWorkerPool::testJobs()
+{
+  QgsServerWorkerPool pool( 3, 10 );
+  QCOMPARE( pool.workerCount(), 3 );
+
+  QMutex mutex;
+  QSet<QThread *> threads;
+  QList<int> statusCodes;
+  for ( int i = 0; i < 10; ++i )
+  {
+    QVERIFY( pool.submit( [&]( QgsServer & server )
+    {
+      // no project, the request fails but it is handled by the worker
+      QgsBufferServerRequest request( QStringLiteral( "http://localhost/?SERVICE=WMS&REQUEST=GetCapabilities" ) );
+      QgsBufferServerResponse response;
+      server.handleRequest( request, response );
+
+      QMutexLocker locker( &mutex );
+      threads.insert( QThread::currentThread() );
+      statusCodes << response.statusCode();
+    } ) );
+  }
+  pool.stop();
+
+  QCOMPARE( statusCodes.size(), 10 );
+  QVERIFY( !threads.contains( QThread::currentThread() ) );
+  QVERIFY( threads.size() <= 3 );
+
+  const QgsServerWorkerPool::Metrics metrics = pool.metrics();
+  QCOMPARE( metrics.acceptedJobs, 10LL );
+  QCOMPARE( metrics.completedJobs, 10LL );
+  QCOMPARE( metrics.rejectedJobs, 0LL );
+  QCOMPARE( metrics.queuedJobs, 0 );
+  QCOMPARE( metrics.busyWorkers, 0 );
+
+  // a stopped pool does not accept jobs
+  QVERIFY( !pool.submit( []( QgsServer & ) {} ) );
+}
+
+void TestQgsServerWorkerPool::testBackpressure()
+{
+  QgsServerWorkerPool pool( 1, 1 );
+
+  QSemaphore started;
+  QSemaphore release;
+  const QgsServerWorkerPool::Job blockingJob = [&]( QgsServer & )
+  {
+    started.release();
+    release.acquire();
+  };
+
+  // the first job keeps the worker busy
+  QVERIFY( pool.submit( blockingJob ) );
+  started.acquire();
+  // the second one waits in the queue
+  QVERIFY( pool.submit( blockingJob ) );
+  // and the third one is rejected
+  QVERIFY( !pool.submit( blockingJob ) );
+
+  QgsServerWorkerPool::Metrics metrics = pool.metrics();
+  QCOMPARE( metrics.busyWorkers, 1 );
+  QCOMPARE( metrics.queuedJobs, 1 );
+  QCOMPARE( metrics.peakQueuedJobs, 1 );
+  QCOMPARE( metrics.rejectedJobs, 1LL );
+
+  release.release( 2 );
+  pool.stop();
+
+  metrics = pool.metrics();
+  QCOMPARE( metrics.acceptedJobs, 2LL );
+  QCOMPARE( metrics.completedJobs, 2LL );
+  QCOMPARE( metrics.rejectedJobs, 1LL );
+}
+
+void TestQgsServerWorkerPool::testVirtualLayerProject()
+{
+  // a project with a virtual layer referencing another project layer, which is looked up
+  // through QgsProject::instance() when the project is read
+  QTemporaryDir dir;
+  const QString projectPath = dir.filePath( QStringLiteral( "virtual.qgs" ) );
+  {
+    QgsProject project;
+    QgsProject::setThreadInstance( &project );
+    QgsVectorLayer *points = new QgsVectorLayer( QStringLiteral( TEST_DATA_DIR ) + QStringLiteral( "/points.shp" ), QStringLiteral( "points" ), QStringLiteral( "ogr" ) );
+    QVERIFY( points->isValid() );
+    project.addMapLayer( points );
+
+    QgsVirtualLayerDefinition definition;
+    definition.addSource( QStringLiteral( "points" ), points->id() );
+    definition.setQuery( QStringLiteral( "SELECT * FROM points" ) );
+    QgsVectorLayer *virtualLayer = new QgsVectorLayer( definition.toString(), QStringLiteral( "virtual_points" ), QStringLiteral( "virtual" ) );
+    QVERIFY( virtualLayer->isValid() );
+    project.addMapLayer( virtualLayer );
+    QgsProject::setThreadInstance( nullptr );
+    QVERIFY( project.write( projectPath ) );
+  }
+
+  QgsServerWorkerPool pool( 3, 20 );
+
+  QMutex mutex;
+  QList<int> statusCodes;
+  QList<QByteArray> contentTypes;
+  int leakedInstances = 0;
+  for ( int i = 0; i < 12; ++i )
+  {
+    QVERIFY( pool.submit( [&]( QgsServer & server )
+    {
+      QgsBufferServerRequest request( QStringLiteral( "http://localhost/?MAP=%1&SERVICE=WMS&VERSION=1.3.0&REQUEST=GetMap&LAYERS=virtual_points&STYLES=&CRS=EPSG:4326&BBOX=-180,-90,180,90&WIDTH=64&HEIGHT=64&FORMAT=image/png" ).arg( projectPath ) );
+      QgsBufferServerResponse response;
+      server.handleRequest( request, response );
+
+      QMutexLocker locker( &mutex );
+      statusCodes << response.statusCode();
+      contentTypes << response.header( QStringLiteral( "Content-Type" ) ).toUtf8();
+      // the project copy is not left as the current project of the worker
+      if ( QgsProject::instance()->fileName() == projectPath )
+        ++leakedInstances;
+    } ) );
+  }
+  pool.stop();
+
+  QCOMPARE( statusCodes.size(), 12 );
+  for ( int i = 0; i < statusCodes.size(); ++i )
+  {
+    QCOMPARE( statusCodes.at( i ), 200 );
+    QCOMPARE( contentTypes.at( i ), QByteArray( "image/png" ) );
+  }
+  QCOMPARE( leakedInstances, 0 );
+  // the project of the main thread is left alone
+  QVERIFY( QgsProject::instance()->fileName() != projectPath );
+}
+
+QGSTEST_MAIN( TestQgsServerWorkerPool )
+#include "testqgsserverworkerpool.moc"